@@ -0,0 +1,55 @@
+# Static memory footprint checks for LD2420 libraries.
+#
+# Adds a `<target>_footprint` custom target that runs the toolchain's `size`
+# utility on the built library, writes a per-object report next to it, and
+# fails the build when static RAM (data + bss) or flash (text + data) exceed
+# the configured budgets. A budget of 0 disables the corresponding check.
+#
+# Usage:
+#   include(/path/to/hlkld2420/cmake/LD2420Footprint.cmake)
+#   ld2420_add_footprint_check(ld2420_core RAM_BUDGET 64 FLASH_BUDGET 4096)
+
+set(LD2420_FOOTPRINT_CHECK_SCRIPT ${CMAKE_CURRENT_LIST_DIR}/ld2420_footprint_check.cmake)
+
+# Derive the `size` tool from the C compiler so cross toolchains such as
+# arm-none-eabi-gcc pick up arm-none-eabi-size instead of the host binary.
+if(NOT LD2420_SIZE_TOOL)
+    get_filename_component(_ld2420_cc_name "${CMAKE_C_COMPILER}" NAME_WE)
+    get_filename_component(_ld2420_cc_dir "${CMAKE_C_COMPILER}" DIRECTORY)
+    string(REGEX REPLACE "(gcc|clang|cc)$" "" _ld2420_cc_prefix "${_ld2420_cc_name}")
+    find_program(LD2420_SIZE_TOOL
+        NAMES ${_ld2420_cc_prefix}size size
+        HINTS ${_ld2420_cc_dir}
+    )
+endif()
+
+function(ld2420_add_footprint_check target)
+    cmake_parse_arguments(ARG "" "RAM_BUDGET;FLASH_BUDGET" "" ${ARGN})
+    if(NOT DEFINED ARG_RAM_BUDGET)
+        set(ARG_RAM_BUDGET 0)
+    endif()
+    if(NOT DEFINED ARG_FLASH_BUDGET)
+        set(ARG_FLASH_BUDGET 0)
+    endif()
+
+    if(NOT LD2420_SIZE_TOOL)
+        message(STATUS "LD2420: 'size' tool not found, skipping footprint target for ${target}")
+        return()
+    endif()
+
+    add_custom_target(${target}_footprint
+        COMMAND ${CMAKE_COMMAND}
+            -DSIZE_TOOL=${LD2420_SIZE_TOOL}
+            -DINPUT=$<TARGET_FILE:${target}>
+            -DLABEL=${target}
+            -DCONFIG=$<CONFIG>
+            -DDEFINES=$<TARGET_PROPERTY:${target},COMPILE_DEFINITIONS>
+            -DRAM_BUDGET=${ARG_RAM_BUDGET}
+            -DFLASH_BUDGET=${ARG_FLASH_BUDGET}
+            -DREPORT=${CMAKE_CURRENT_BINARY_DIR}/${target}_footprint.txt
+            -P ${LD2420_FOOTPRINT_CHECK_SCRIPT}
+        DEPENDS ${target}
+        COMMENT "Measuring static footprint of ${target}"
+        VERBATIM
+    )
+endfunction()
@@ -0,0 +1,75 @@
+# Script-mode helper for ld2420_add_footprint_check().
+#
+# Expects: SIZE_TOOL, INPUT, LABEL, CONFIG, DEFINES, RAM_BUDGET, FLASH_BUDGET, REPORT
+#
+# Runs `size -B -t` (Berkeley format with totals) on INPUT and accounts
+#   flash = text + data   (code, constants and initializers live in flash)
+#   ram   = data + bss    (initialized and zeroed statics live in RAM)
+# per object file and for the whole archive.
+
+execute_process(
+    COMMAND ${SIZE_TOOL} -B -t ${INPUT}
+    OUTPUT_VARIABLE size_output
+    RESULT_VARIABLE size_result
+)
+if(NOT size_result EQUAL 0)
+    message(FATAL_ERROR "LD2420: '${SIZE_TOOL}' failed on ${INPUT}")
+endif()
+
+if(NOT CONFIG)
+    set(CONFIG "default")
+endif()
+if(NOT DEFINES)
+    set(DEFINES "none")
+endif()
+
+set(report "${LABEL} static footprint (configuration: ${CONFIG}, definitions: ${DEFINES})\n")
+string(APPEND report "  flash     ram  object\n")
+
+set(total_ram 0)
+set(total_flash 0)
+string(REPLACE "\n" ";" size_lines "${size_output}")
+foreach(line IN LISTS size_lines)
+    if(NOT line MATCHES "^[ \t]*([0-9]+)[ \t]+([0-9]+)[ \t]+([0-9]+)[ \t]+[0-9]+[ \t]+[0-9a-fA-F]+[ \t]+(.*)$")
+        continue()
+    endif()
+    set(text ${CMAKE_MATCH_1})
+    set(data ${CMAKE_MATCH_2})
+    set(bss ${CMAKE_MATCH_3})
+    set(name ${CMAKE_MATCH_4})
+    math(EXPR flash "${text} + ${data}")
+    math(EXPR ram "${data} + ${bss}")
+
+    # Strip the "(ex libfoo.a)" suffix GNU size appends for archive members.
+    string(REGEX REPLACE " \\(ex .*\\)$" "" name "${name}")
+    if(name STREQUAL "(TOTALS)")
+        set(total_flash ${flash})
+        set(total_ram ${ram})
+        set(name "total")
+    endif()
+
+    string(LENGTH "${flash}" flash_len)
+    string(LENGTH "${ram}" ram_len)
+    math(EXPR flash_pad "7 - ${flash_len}")
+    math(EXPR ram_pad "7 - ${ram_len}")
+    string(REPEAT " " ${flash_pad} flash_spaces)
+    string(REPEAT " " ${ram_pad} ram_spaces)
+    string(APPEND report "${flash_spaces}${flash} ${ram_spaces}${ram}  ${name}\n")
+endforeach()
+
+string(APPEND report "  budget: flash ${FLASH_BUDGET}, ram ${RAM_BUDGET} (0 = unchecked)\n")
+file(WRITE ${REPORT} "${report}")
+message("${report}")
+
+set(failed FALSE)
+if(RAM_BUDGET GREATER 0 AND total_ram GREATER RAM_BUDGET)
+    message(SEND_ERROR "LD2420: ${LABEL} uses ${total_ram} bytes of static RAM, budget is ${RAM_BUDGET}")
+    set(failed TRUE)
+endif()
+if(FLASH_BUDGET GREATER 0 AND total_flash GREATER FLASH_BUDGET)
+    message(SEND_ERROR "LD2420: ${LABEL} uses ${total_flash} bytes of flash, budget is ${FLASH_BUDGET}")
+    set(failed TRUE)
+endif()
+if(failed)
+    message(FATAL_ERROR "LD2420: ${LABEL} exceeds its footprint budget (see ${REPORT})")
+endif()
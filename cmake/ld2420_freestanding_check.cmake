@@ -0,0 +1,53 @@
+# Script-mode check that a static library needs nothing from outside itself.
+#
+# Expects: NM_TOOL, INPUT
+#
+# Lists the symbols INPUT defines and the ones its objects reference with
+# `nm`, and fails if any reference is not satisfied by the archive itself,
+# e.g. memcpy() or memset() from the C library. References added by
+# sanitizer and coverage instrumentation are ignored.
+
+execute_process(
+    COMMAND ${NM_TOOL} --defined-only ${INPUT}
+    OUTPUT_VARIABLE defined_output
+    RESULT_VARIABLE defined_result
+)
+execute_process(
+    COMMAND ${NM_TOOL} --undefined-only ${INPUT}
+    OUTPUT_VARIABLE undefined_output
+    RESULT_VARIABLE undefined_result
+)
+if(NOT defined_result EQUAL 0 OR NOT undefined_result EQUAL 0)
+    message(FATAL_ERROR "LD2420: '${NM_TOOL}' failed on ${INPUT}")
+endif()
+
+set(defined "")
+string(REPLACE "\n" ";" defined_lines "${defined_output}")
+foreach(line IN LISTS defined_lines)
+    if(line MATCHES "^[0-9a-fA-F]+ [A-Za-z] (.+)$")
+        list(APPEND defined ${CMAKE_MATCH_1})
+    endif()
+endforeach()
+
+set(missing "")
+string(REPLACE "\n" ";" undefined_lines "${undefined_output}")
+foreach(line IN LISTS undefined_lines)
+    if(NOT line MATCHES "^[ \t]+U (.+)$")
+        continue()
+    endif()
+    set(symbol ${CMAKE_MATCH_1})
+    if(symbol MATCHES "^__(asan|ubsan|sanitizer|tsan|msan|gcov|llvm_gcov|llvm_profile)")
+        continue()
+    endif()
+    list(FIND defined ${symbol} found)
+    if(found EQUAL -1)
+        list(APPEND missing ${symbol})
+    endif()
+endforeach()
+
+if(missing)
+    list(REMOVE_DUPLICATES missing)
+    list(JOIN missing ", " missing_text)
+    message(FATAL_ERROR "LD2420: ${INPUT} references symbols it does not define: ${missing_text}")
+endif()
+message(STATUS "LD2420: ${INPUT} is self-contained")
@@ -0,0 +1,438 @@
+# Script-mode generator for the LD2420 protocol header.
+#
+# Expects: TABLE, TEMPLATE, OUTPUT
+#
+# Reads the protocol table (see src/protocol/ld2420_protocol.table), computes
+# every field offset and frame size, and substitutes the resulting constants,
+# structures, encoders, decoders and static checks into TEMPLATE at
+# @LD2420_PROTOCOL_BODY@. OUTPUT is only rewritten when its content changes.
+
+cmake_minimum_required(VERSION 3.16)
+
+foreach(var TABLE TEMPLATE OUTPUT)
+    if(NOT ${var})
+        message(FATAL_ERROR "LD2420: ld2420_protocol_gen.cmake needs -D${var}=...")
+    endif()
+endforeach()
+
+set(ELEM_SIZE_u8 1)
+set(ELEM_SIZE_u16 2)
+set(ELEM_SIZE_u32 4)
+set(ELEM_SIZE_kv 6)
+set(C_TYPE_u8 uint8_t)
+set(C_TYPE_u16 uint16_t)
+set(C_TYPE_u32 uint32_t)
+set(C_TYPE_kv ld2420_protocol_param_t)
+set(PREFIX_SIZE_command 2)
+set(PREFIX_SIZE_ack 4)
+set(PREFIX_SIZE_report 0)
+set(FAMILY_command command)
+set(FAMILY_ack command)
+set(FAMILY_report report)
+# Hand-written limits in ld2420.h the table has to stay within
+set(LIMIT_MIN_command LD2420_MIN_TX_PACKET_SIZE)
+set(LIMIT_MAX_command LD2420_MAX_TX_PACKET_SIZE)
+set(LIMIT_MIN_ack LD2420_MIN_RX_PACKET_SIZE)
+set(LIMIT_MAX_ack LD2420_MAX_RX_PACKET_SIZE)
+
+# Table errors name the line they were found on
+function(table_error message)
+    message(FATAL_ERROR "LD2420: ${TABLE}:${line_number}: ${message}")
+endfunction()
+
+# Statements reading one element of <type> at <ptr> into the lvalue <dst>
+function(elem_decode type dst ptr out)
+    if(type STREQUAL "u8")
+        set(code "        ${dst} = *(${ptr});\n")
+    elseif(type STREQUAL "u16")
+        set(code "        ${dst} = ld2420_protocol_read_le16(${ptr});\n")
+    elseif(type STREQUAL "u32")
+        set(code "        ${dst} = ld2420_protocol_read_le32(${ptr});\n")
+    else()
+        set(code "        ${dst}.parameter = ld2420_protocol_read_le16(${ptr});\n")
+        string(APPEND code "        ${dst}.value = ld2420_protocol_read_le32(${ptr} + 2);\n")
+    endif()
+    set(${out} "${code}" PARENT_SCOPE)
+endfunction()
+
+# Statements writing the element <src> of <type> to <ptr>
+function(elem_encode type src ptr out)
+    if(type STREQUAL "u8")
+        set(code "        *(${ptr}) = ${src};\n")
+    elseif(type STREQUAL "u16")
+        set(code "        ld2420_protocol_write_le16(${ptr}, ${src});\n")
+    elseif(type STREQUAL "u32")
+        set(code "        ld2420_protocol_write_le32(${ptr}, ${src});\n")
+    else()
+        set(code "        ld2420_protocol_write_le16(${ptr}, ${src}.parameter);\n")
+        string(APPEND code "        ld2420_protocol_write_le32(${ptr} + 2, ${src}.value);\n")
+    endif()
+    set(${out} "${code}" PARENT_SCOPE)
+endfunction()
+
+# Little-endian u32 literal of four hex bytes, e.g. "FD;FC;FB;FA" -> 0xFAFBFCFDu
+function(bytes_to_le32 bytes out)
+    list(REVERSE bytes)
+    string(REPLACE ";" "" hex "${bytes}")
+    set(${out} "0x${hex}u" PARENT_SCOPE)
+endfunction()
+
+file(STRINGS "${TABLE}" table_lines)
+set(line_number 0)
+set(families "")
+set(messages "")
+foreach(line IN LISTS table_lines)
+    math(EXPR line_number "${line_number} + 1")
+    string(REGEX REPLACE "#.*$" "" line "${line}")
+    string(STRIP "${line}" line)
+    if(line STREQUAL "")
+        continue()
+    endif()
+    string(REGEX REPLACE "[ \t]+" ";" tokens "${line}")
+    list(GET tokens 0 kind)
+
+    if(kind STREQUAL "family")
+        list(LENGTH tokens count)
+        if(NOT count EQUAL 10)
+            table_error("family needs a name, 4 header bytes and 4 footer bytes")
+        endif()
+        list(GET tokens 1 family)
+        list(SUBLIST tokens 2 4 header)
+        list(SUBLIST tokens 6 4 footer)
+        foreach(byte IN LISTS header footer)
+            if(NOT byte MATCHES "^[0-9A-F][0-9A-F]$")
+                table_error("'${byte}' is not an upper-case hex byte")
+            endif()
+        endforeach()
+        bytes_to_le32("${header}" FAMILY_HEADER_${family})
+        bytes_to_le32("${footer}" FAMILY_FOOTER_${family})
+        string(REPLACE ";" " " FAMILY_BYTES_${family} "${header} .. ${footer}")
+        list(APPEND families ${family})
+        continue()
+    endif()
+
+    if(NOT kind MATCHES "^(command|ack|report)$")
+        table_error("unknown entry '${kind}'")
+    endif()
+    list(LENGTH tokens count)
+    if(count LESS 3)
+        table_error("${kind} needs a name and an id")
+    endif()
+    list(GET tokens 1 name)
+    list(GET tokens 2 id)
+    set(fields "")
+    if(count GREATER 3)
+        list(SUBLIST tokens 3 -1 fields)
+    endif()
+    if(NOT name MATCHES "^[a-z][a-z0-9_]*$")
+        table_error("'${name}' is not a lower-case identifier")
+    endif()
+    if(kind STREQUAL "report")
+        if(NOT id STREQUAL "-")
+            table_error("reports have no id, use '-'")
+        endif()
+    elseif(NOT id MATCHES "^0x[0-9A-Fa-f][0-9A-Fa-f][0-9A-Fa-f][0-9A-Fa-f]$")
+        table_error("'${id}' is not a 16-bit hex id")
+    endif()
+    if(NOT FAMILY_HEADER_${FAMILY_${kind}})
+        table_error("family '${FAMILY_${kind}}' must be declared before its messages")
+    endif()
+
+    set(msg "${kind}_${name}")
+    if(DEFINED MSG_KIND_${msg})
+        table_error("${kind} '${name}' is declared twice")
+    endif()
+    set(MSG_KIND_${msg} ${kind})
+    set(MSG_NAME_${msg} ${name})
+    set(MSG_ID_${msg} ${id})
+    set(MSG_FIELDS_${msg} "${fields}")
+    set(MSG_LINE_${msg} ${line_number})
+    list(APPEND messages ${msg})
+endforeach()
+
+set(defines "")
+set(code "")
+set(checks "")
+foreach(kind command ack report)
+    set(KIND_MIN_${kind} "")
+    set(KIND_MAX_${kind} "")
+    set(KIND_LENGTH_CASES_${kind} "")
+    set(KIND_LOW_IDS_${kind} "")
+endforeach()
+
+foreach(msg IN LISTS messages)
+    set(kind ${MSG_KIND_${msg}})
+    set(name ${MSG_NAME_${msg}})
+    set(id ${MSG_ID_${msg}})
+    set(line_number ${MSG_LINE_${msg}})
+    set(family ${FAMILY_${kind}})
+    string(TOUPPER "${family}" FAMILY)
+    string(TOUPPER "${msg}" MSG)
+    string(TOUPPER "${name}" NAME)
+    set(fn "ld2420_${msg}")
+    set(type "ld2420_${msg}_t")
+
+    # Layout: fixed fields at constant offsets, at most one trailing variable array
+    math(EXPR offset "6 + ${PREFIX_SIZE_${kind}}")
+    set(struct_members "")
+    set(decode_fields "")
+    set(encode_fields "")
+    set(var_field "")
+    set(msg_defines "")
+    if(kind STREQUAL "ack")
+        string(APPEND struct_members "        uint16_t status; // Status word, 0 on success\n")
+        string(APPEND decode_fields "        msg->status = ld2420_protocol_read_le16(frame + LD2420_ACK_STATUS_OFFSET);\n")
+        string(APPEND encode_fields "        ld2420_protocol_write_le16(out + LD2420_ACK_STATUS_OFFSET, msg->status);\n")
+    endif()
+    foreach(field IN LISTS MSG_FIELDS_${msg})
+        if(var_field)
+            table_error("only the last field of ${kind} '${name}' may be a variable array")
+        endif()
+        if(NOT field MATCHES "^(u8|u16|u32|kv)(\\[([0-9]+)(\\.\\.([0-9]+))?\\])?:([a-z][a-z0-9_]*)$")
+            table_error("bad field '${field}'")
+        endif()
+        set(ftype "${CMAKE_MATCH_1}")
+        set(fcount "${CMAKE_MATCH_3}")
+        set(fmax "${CMAKE_MATCH_5}")
+        set(fname "${CMAKE_MATCH_6}")
+        string(TOUPPER "${fname}" FNAME)
+        set(esize ${ELEM_SIZE_${ftype}})
+        set(ctype ${C_TYPE_${ftype}})
+        string(APPEND msg_defines "#define LD2420_${MSG}_${FNAME}_OFFSET ${offset}u\n")
+
+        if(fmax)
+            # Variable array: count follows from the length field
+            if(fmax LESS fcount OR fmax EQUAL 0)
+                table_error("bad range in '${field}'")
+            endif()
+            set(var_field ${fname})
+            set(var_type ${ftype})
+            set(var_min ${fcount})
+            set(var_max ${fmax})
+            set(var_offset ${offset})
+            set(var_esize ${esize})
+            string(APPEND msg_defines "#define LD2420_${MSG}_${FNAME}_MAX_COUNT ${fmax}u\n")
+            if(ftype STREQUAL "u8")
+                # Bytes are passed through without a copy
+                string(APPEND struct_members "        const uint8_t *${fname}; // Points into the frame when decoded\n")
+            else()
+                string(APPEND struct_members "        ${ctype} ${fname}[${fmax}];\n")
+            endif()
+            string(APPEND struct_members "        uint16_t ${fname}_count;\n")
+        elseif(NOT "${fcount}" STREQUAL "")
+            # Fixed array, unrolled at constant offsets
+            if(fcount EQUAL 0)
+                table_error("empty array '${field}'")
+            endif()
+            string(APPEND struct_members "        ${ctype} ${fname}[${fcount}];\n")
+            math(EXPR last "${fcount} - 1")
+            foreach(i RANGE ${last})
+                math(EXPR at "${offset} + ${i} * ${esize}")
+                elem_decode(${ftype} "msg->${fname}[${i}]" "frame + ${at}" stmt)
+                string(APPEND decode_fields "${stmt}")
+                elem_encode(${ftype} "msg->${fname}[${i}]" "out + ${at}" stmt)
+                string(APPEND encode_fields "${stmt}")
+            endforeach()
+            math(EXPR offset "${offset} + ${fcount} * ${esize}")
+        else()
+            string(APPEND struct_members "        ${ctype} ${fname};\n")
+            elem_decode(${ftype} "msg->${fname}" "frame + ${offset}" stmt)
+            string(APPEND decode_fields "${stmt}")
+            elem_encode(${ftype} "msg->${fname}" "out + ${offset}" stmt)
+            string(APPEND encode_fields "${stmt}")
+            math(EXPR offset "${offset} + ${esize}")
+        endif()
+    endforeach()
+
+    # Sizes
+    math(EXPR fixed_size "${offset} + 4")
+    if(var_field)
+        math(EXPR min_size "${fixed_size} + ${var_min} * ${var_esize}")
+        math(EXPR max_size "${fixed_size} + ${var_max} * ${var_esize}")
+        string(APPEND msg_defines "#define LD2420_${MSG}_MIN_SIZE ${min_size}u\n")
+        string(APPEND msg_defines "#define LD2420_${MSG}_MAX_SIZE ${max_size}u\n")
+        set(size_macro LD2420_${MSG}_MAX_SIZE)
+    else()
+        set(min_size ${fixed_size})
+        set(max_size ${fixed_size})
+        string(APPEND msg_defines "#define LD2420_${MSG}_SIZE ${fixed_size}u\n")
+        set(size_macro LD2420_${MSG}_SIZE)
+    endif()
+    if(NOT KIND_MIN_${kind} OR min_size LESS KIND_MIN_${kind})
+        set(KIND_MIN_${kind} ${min_size})
+    endif()
+    if(NOT KIND_MAX_${kind} OR max_size GREATER KIND_MAX_${kind})
+        set(KIND_MAX_${kind} ${max_size})
+    endif()
+    if(max_size GREATER 65535)
+        table_error("${kind} '${name}' exceeds the u16 length field")
+    endif()
+
+    # Ids: the low byte is what the one-shot and streaming parsers report as cmd_echo
+    if(NOT kind STREQUAL "report")
+        string(SUBSTRING "${id}" 4 2 low_id)
+        string(TOUPPER "${low_id}" low_id)
+        set(low_id "0x${low_id}")
+        if(low_id IN_LIST KIND_LOW_IDS_${kind})
+            table_error("${kind} '${name}' shares the low id byte ${low_id} with another ${kind}")
+        endif()
+        list(APPEND KIND_LOW_IDS_${kind} ${low_id})
+        set(msg_defines "#define LD2420_${MSG}_ID ${id}u\n${msg_defines}")
+        string(APPEND checks "LD2420_PROTOCOL_STATIC_CHECK(${msg}_id, LD2420_${MSG}_ID == LD2420_CMD_${NAME});\n")
+        math(EXPR min_length "${min_size} - 10")
+        math(EXPR max_length "${max_size} - 10")
+        if(NOT var_field)
+            set(length_check "length == ${min_length}u")
+        elseif(var_esize EQUAL 1)
+            set(length_check "length >= ${min_length}u && length <= ${max_length}u")
+        else()
+            math(EXPR var_base "${fixed_size} - 10")
+            set(length_check "length >= ${min_length}u && length <= ${max_length}u && (length - ${var_base}u) % ${var_esize}u == 0")
+        endif()
+        string(APPEND KIND_LENGTH_CASES_${kind} "        case ${low_id}: // ${name}\n            return ${length_check};\n")
+    endif()
+    string(REPLACE ";" " " field_list "${MSG_FIELDS_${msg}}")
+    if(field_list STREQUAL "")
+        set(field_list "no fields")
+    endif()
+    string(APPEND defines "/* ${kind} ${name}: ${field_list} */\n${msg_defines}\n")
+
+    # Combined validity check: one branch on the success path
+    set(match "(ld2420_protocol_read_le32(frame) ^ LD2420_PROTOCOL_${FAMILY}_HEADER) |\n")
+    string(APPEND match "            (ld2420_protocol_read_le32(frame + size - 4) ^ LD2420_PROTOCOL_${FAMILY}_FOOTER) |\n")
+    string(APPEND match "            (uint32_t)(ld2420_protocol_read_le16(frame + LD2420_PROTOCOL_LENGTH_OFFSET) ^ (size - LD2420_PROTOCOL_FRAME_OVERHEAD))")
+    if(kind STREQUAL "command")
+        string(APPEND match " |\n            (uint32_t)(ld2420_protocol_read_le16(frame + LD2420_COMMAND_ID_OFFSET) ^ LD2420_${MSG}_ID)")
+    elseif(kind STREQUAL "ack")
+        string(APPEND match " |\n            (uint32_t)(ld2420_protocol_read_le16(frame + LD2420_ACK_CMD_ECHO_OFFSET) ^\n")
+        string(APPEND match "                       (LD2420_${MSG}_ID | LD2420_PROTOCOL_ACK_ECHO_FLAG))")
+    endif()
+
+    set(has_struct FALSE)
+    if(NOT struct_members STREQUAL "")
+        set(has_struct TRUE)
+        string(APPEND code "    /** Fields of the ${kind} ${name}. */\n    typedef struct\n    {\n${struct_members}    } ${type};\n\n")
+    endif()
+
+    # Encoder
+    if(var_field)
+        string(APPEND code "    /** Encode ${kind} ${name} into out (at least ${size_macro} bytes); 0 if ${var_field}_count is out of range. */\n")
+    else()
+        string(APPEND code "    /** Encode ${kind} ${name} into out (${size_macro} bytes). */\n")
+    endif()
+    if(has_struct)
+        string(APPEND code "    static inline uint16_t ${fn}_encode(uint8_t *out, const ${type} *msg)\n    {\n")
+    else()
+        string(APPEND code "    static inline uint16_t ${fn}_encode(uint8_t *out)\n    {\n")
+    endif()
+    if(var_field)
+        if(var_min EQUAL 0)
+            string(APPEND code "        if (msg->${var_field}_count > ${var_max}u)\n            return 0;\n")
+        else()
+            string(APPEND code "        if (msg->${var_field}_count < ${var_min}u || msg->${var_field}_count > ${var_max}u)\n            return 0;\n")
+        endif()
+        string(APPEND code "        const uint16_t size = (uint16_t)(${fixed_size}u + msg->${var_field}_count * ${var_esize}u);\n")
+    else()
+        string(APPEND code "        const uint16_t size = ${size_macro};\n")
+    endif()
+    string(APPEND code "        ld2420_protocol_write_le32(out, LD2420_PROTOCOL_${FAMILY}_HEADER);\n")
+    string(APPEND code "        ld2420_protocol_write_le16(out + LD2420_PROTOCOL_LENGTH_OFFSET, (uint16_t)(size - LD2420_PROTOCOL_FRAME_OVERHEAD));\n")
+    if(kind STREQUAL "command")
+        string(APPEND code "        ld2420_protocol_write_le16(out + LD2420_COMMAND_ID_OFFSET, LD2420_${MSG}_ID);\n")
+    elseif(kind STREQUAL "ack")
+        string(APPEND code "        ld2420_protocol_write_le16(out + LD2420_ACK_CMD_ECHO_OFFSET, LD2420_${MSG}_ID | LD2420_PROTOCOL_ACK_ECHO_FLAG);\n")
+    endif()
+    string(APPEND code "${encode_fields}")
+    if(var_field)
+        elem_encode(${var_type} "msg->${var_field}[i]" "out + ${var_offset} + ${var_esize} * i" stmt)
+        string(REPLACE "        " "            " stmt "${stmt}")
+        string(APPEND code "        for (uint16_t i = 0; i < msg->${var_field}_count; i++)\n        {\n${stmt}        }\n")
+    endif()
+    string(APPEND code "        ld2420_protocol_write_le32(out + size - 4, LD2420_PROTOCOL_${FAMILY}_FOOTER);\n")
+    string(APPEND code "        return size;\n    }\n\n")
+
+    # Decoder
+    string(APPEND code "    /** Decode and validate a complete ${kind} ${name} frame of size bytes. */\n")
+    if(has_struct)
+        string(APPEND code "    static inline ld2420_status_t ${fn}_decode(const uint8_t *frame, uint16_t size, ${type} *msg)\n    {\n")
+        string(APPEND code "        if (frame == NULL || msg == NULL)\n            return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;\n")
+    else()
+        string(APPEND code "    static inline ld2420_status_t ${fn}_decode(const uint8_t *frame, uint16_t size)\n    {\n")
+        string(APPEND code "        if (frame == NULL)\n            return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;\n")
+    endif()
+    if(var_field)
+        set(size_check "size < LD2420_${MSG}_MIN_SIZE || size > LD2420_${MSG}_MAX_SIZE")
+        if(NOT var_esize EQUAL 1)
+            string(APPEND size_check " || (size - ${fixed_size}u) % ${var_esize}u != 0")
+        endif()
+    else()
+        set(size_check "size != LD2420_${MSG}_SIZE")
+    endif()
+    string(APPEND code "        if (${size_check})\n            return LD2420_STATUS_ERROR_INVALID_BUFFER_SIZE;\n")
+    string(APPEND code "        if ((${match}) != 0)\n")
+    string(APPEND code "            return ld2420_protocol_diagnose(frame, size, LD2420_PROTOCOL_${FAMILY}_HEADER, LD2420_PROTOCOL_${FAMILY}_FOOTER);\n")
+    string(APPEND code "${decode_fields}")
+    if(var_field)
+        if(var_esize EQUAL 1)
+            string(APPEND code "        msg->${var_field}_count = (uint16_t)(size - ${fixed_size}u);\n")
+        else()
+            string(APPEND code "        msg->${var_field}_count = (uint16_t)((size - ${fixed_size}u) / ${var_esize}u);\n")
+        endif()
+        if(var_type STREQUAL "u8")
+            string(APPEND code "        msg->${var_field} = frame + ${var_offset};\n")
+        else()
+            elem_decode(${var_type} "msg->${var_field}[i]" "frame + ${var_offset} + ${var_esize} * i" stmt)
+            string(REPLACE "        " "            " stmt "${stmt}")
+            string(APPEND code "        for (uint16_t i = 0; i < msg->${var_field}_count; i++)\n        {\n${stmt}        }\n")
+        endif()
+    endif()
+    string(APPEND code "        return LD2420_STATUS_OK;\n    }\n\n")
+endforeach()
+
+# Family markers
+set(family_defines "")
+foreach(family IN LISTS families)
+    string(TOUPPER "${family}" FAMILY)
+    string(APPEND family_defines "/** ${family} frames: ${FAMILY_BYTES_${family}}, as little-endian words. */\n")
+    string(APPEND family_defines "#define LD2420_PROTOCOL_${FAMILY}_HEADER ${FAMILY_HEADER_${family}}\n")
+    string(APPEND family_defines "#define LD2420_PROTOCOL_${FAMILY}_FOOTER ${FAMILY_FOOTER_${family}}\n\n")
+endforeach()
+
+# Size range per kind, checked against ld2420.h
+set(kind_defines "")
+foreach(kind command ack report)
+    if(NOT KIND_MIN_${kind})
+        continue()
+    endif()
+    string(TOUPPER "${kind}" KIND)
+    string(APPEND kind_defines "/** Smallest and largest ${kind} frame in the table. */\n")
+    string(APPEND kind_defines "#define LD2420_PROTOCOL_${KIND}_MIN_SIZE ${KIND_MIN_${kind}}u\n")
+    string(APPEND kind_defines "#define LD2420_PROTOCOL_${KIND}_MAX_SIZE ${KIND_MAX_${kind}}u\n\n")
+    if(LIMIT_MIN_${kind})
+        string(APPEND checks "LD2420_PROTOCOL_STATIC_CHECK(${kind}_min_size, LD2420_PROTOCOL_${KIND}_MIN_SIZE >= ${LIMIT_MIN_${kind}});\n")
+        string(APPEND checks "LD2420_PROTOCOL_STATIC_CHECK(${kind}_max_size, LD2420_PROTOCOL_${KIND}_MAX_SIZE <= ${LIMIT_MAX_${kind}});\n")
+    endif()
+endforeach()
+
+# Length plausibility per command id (low byte, as reported in cmd_echo)
+set(lookup "")
+set(KIND_LABEL_command "command")
+set(KIND_LABEL_ack "ACK")
+foreach(kind command ack)
+    string(TOUPPER "${kind}" KIND)
+    string(APPEND lookup "    /**\n")
+    string(APPEND lookup "     * Whether a ${KIND_LABEL_${kind}} frame for the command with this low id byte may carry\n")
+    string(APPEND lookup "     * this length field. Commands missing from the table are held to the ${KIND_LABEL_${kind}} size range.\n")
+    string(APPEND lookup "     */\n")
+    string(APPEND lookup "    static inline bool ld2420_protocol_${kind}_length_valid(uint8_t command, uint16_t length)\n    {\n")
+    string(APPEND lookup "        switch (command)\n        {\n${KIND_LENGTH_CASES_${kind}}")
+    string(APPEND lookup "        default:\n")
+    string(APPEND lookup "            return length >= LD2420_PROTOCOL_${KIND}_MIN_SIZE - LD2420_PROTOCOL_FRAME_OVERHEAD &&\n")
+    string(APPEND lookup "                   length <= LD2420_PROTOCOL_${KIND}_MAX_SIZE - LD2420_PROTOCOL_FRAME_OVERHEAD;\n")
+    string(APPEND lookup "        }\n    }\n\n")
+endforeach()
+
+set(LD2420_PROTOCOL_BODY "${family_defines}${kind_defines}${defines}${checks}\n${lookup}${code}")
+configure_file("${TEMPLATE}" "${OUTPUT}.tmp" @ONLY)
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUTPUT}.tmp" "${OUTPUT}")
+file(REMOVE "${OUTPUT}.tmp")
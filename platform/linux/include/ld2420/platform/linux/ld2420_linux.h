@@ -0,0 +1,277 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420/ld2420.h"
+#include "ld2420/ld2420_stream.h"
+
+/**
+ * Maximum number of serial ports one ingest context can watch. The port table
+ * is part of ld2420_linux_ingest_t, so this bounds its size. Override through
+ * the LD2420_LINUX_MAX_PORTS CMake cache variable so the library and its users
+ * agree on the layout.
+ */
+#ifndef LD2420_LINUX_MAX_PORTS
+#define LD2420_LINUX_MAX_PORTS 256
+#endif
+
+/**
+ * Number of bytes requested from a port per readiness event. One read() is
+ * issued per event; anything left in the kernel buffer re-arms the
+ * (level-triggered) readiness for the next poll.
+ */
+#define LD2420_LINUX_READ_CHUNK 256u
+
+/** Maximum number of readiness events handled per ld2420_linux_ingest_poll() call. */
+#define LD2420_LINUX_MAX_EVENTS 64
+
+/** Longest directory and device name prefix ld2420_linux_ingest_watch_devices() accepts. */
+#define LD2420_LINUX_DEVICE_DIR_MAX 64u
+#define LD2420_LINUX_DEVICE_PREFIX_MAX 16u
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    /**
+     * @brief Callback type for frames received on any attached port.
+     *
+     * @param user User pointer given to ld2420_linux_ingest_init()
+     * @param port_index Index of the port the frame arrived on
+     * @param frame Pointer to the complete frame (starts at header)
+     * @param frame_size_bytes Total frame length in bytes
+     * @param cmd_echo Parsed command echo
+     * @param status Parsed status word
+     *
+     * @note Invoked on the thread calling ld2420_linux_ingest_poll(). The frame
+     *       pointer is only valid for the duration of the call.
+     */
+    typedef void (*ld2420_linux_rx_callback_t)(
+        void *user,
+        uint16_t port_index,
+        const uint8_t *frame,
+        uint16_t frame_size_bytes,
+        uint16_t cmd_echo,
+        uint16_t status);
+
+    /**
+     * @brief Callback type for ports the ingest attaches or releases on its own.
+     *
+     * @param user User pointer given to ld2420_linux_ingest_init()
+     * @param port_index Index of the port
+     * @param path Device path for ports attached by the device watch, NULL on release
+     * @param attached true when the port was attached, false when it was released
+     *
+     * @note Invoked on the thread calling ld2420_linux_ingest_poll() for ports the
+     *       device watch attaches and for ports released because they hung up. Not
+     *       invoked for ld2420_linux_ingest_add()/_remove() calls of the application.
+     */
+    typedef void (*ld2420_linux_port_callback_t)(
+        void *user,
+        uint16_t port_index,
+        const char *path,
+        bool attached);
+
+    /**
+     * @brief Per-port state: the file descriptor, its stream parser and counters.
+     */
+    typedef struct
+    {
+        int fd;                 // -1 when the slot is unused
+        uint32_t generation;    // Bumped on every attach; epoll events of an earlier user of the slot are ignored
+        ld2420_stream_t stream; // Streaming parser for this port
+        uint32_t frames;        // Frames delivered
+        uint32_t errors;        // Reads in which the parser reported an error
+        uint64_t bytes;         // Bytes read from the port
+    } ld2420_linux_port_t;
+
+    /**
+     * @brief Multi-port ingest context.
+     *
+     * All ports share one epoll instance and are serviced by whichever thread
+     * calls ld2420_linux_ingest_poll(). Not thread-safe; use one context per
+     * thread. The structure contains the whole port table, so allocate it
+     * statically or on the heap rather than on a small stack.
+     *
+     * The port table is also the pool that ports are attached from at run time:
+     * attaching or releasing a port initializes or drops one slot and its epoll
+     * registration, and never touches the other ports' parsers.
+     */
+    typedef struct
+    {
+        int epoll_fd;
+        uint16_t port_count; // High-water mark of used slots in `ports`
+        ld2420_linux_rx_callback_t rx_callback;
+        void *user;
+        int device_watch_fd; // inotify descriptor of the device watch, -1 without one
+        ld2420_linux_port_callback_t port_callback;
+        char device_dir[LD2420_LINUX_DEVICE_DIR_MAX];
+        char device_prefix[LD2420_LINUX_DEVICE_PREFIX_MAX];
+        ld2420_linux_port_t ports[LD2420_LINUX_MAX_PORTS];
+    } ld2420_linux_ingest_t;
+
+    /**
+     * @brief Open a serial device configured for the LD2420.
+     *
+     * Opens the device non-blocking and puts it in raw 8N1 mode at
+     * LD2420_BAUD_RATE without flow control. Works for USB-serial adapters,
+     * on-board UARTs and pseudo-terminals.
+     *
+     * @param path Device path, e.g. "/dev/ttyUSB0"
+     * @param out_fd Receives the opened file descriptor
+     *
+     * @return LD2420_STATUS_OK on success, LD2420_STATUS_ERROR_INVALID_ARGUMENTS
+     *         on NULL arguments, LD2420_STATUS_ERROR_UNKNOWN if the device
+     *         cannot be opened or configured (errno is preserved)
+     */
+    ld2420_status_t ld2420_linux_open_serial(const char *path, int *out_fd);
+
+    /**
+     * @brief Initialize an ingest context.
+     *
+     * @param ingest Context to initialize
+     * @param rx_callback Function invoked for every complete frame
+     * @param user Opaque pointer passed back to rx_callback
+     *
+     * @return LD2420_STATUS_OK on success, error code otherwise
+     */
+    ld2420_status_t ld2420_linux_ingest_init(
+        ld2420_linux_ingest_t *ingest,
+        ld2420_linux_rx_callback_t rx_callback,
+        void *user);
+
+    /**
+     * @brief Attach an already opened, non-blocking file descriptor.
+     *
+     * The ingest context takes ownership of the descriptor and closes it on
+     * deinit or when the port hangs up.
+     *
+     * @param ingest Initialized context
+     * @param fd File descriptor to watch
+     * @param out_port_index Optional; receives the assigned port index
+     *
+     * @return LD2420_STATUS_OK on success, LD2420_STATUS_ERROR_BUFFER_TOO_SMALL
+     *         when the port table is full, error code otherwise
+     */
+    ld2420_status_t ld2420_linux_ingest_add(
+        ld2420_linux_ingest_t *ingest,
+        int fd,
+        uint16_t *out_port_index);
+
+    /**
+     * @brief Release a port: stop watching it and close its descriptor.
+     *
+     * May be called from the rx callback, including for the port whose frame is
+     * being delivered; the rest of that read is then discarded. The slot is free
+     * for the next attach right away.
+     *
+     * @param ingest Initialized context
+     * @param port_index Index of an attached port
+     *
+     * @return LD2420_STATUS_OK on success, LD2420_STATUS_ERROR_INVALID_ARGUMENTS
+     *         if no port is attached at port_index
+     */
+    ld2420_status_t ld2420_linux_ingest_remove(ld2420_linux_ingest_t *ingest, uint16_t port_index);
+
+    /**
+     * @brief Attach serial devices as they appear.
+     *
+     * Watches `dir` (normally "/dev") with inotify from within the ingest's own
+     * epoll set. Every character device whose name starts with `prefix` (e.g.
+     * "ttyUSB") is opened with ld2420_linux_open_serial() and attached: those
+     * present now, and new ones as soon as they are created or, if opening
+     * fails at first (udev may still be setting permissions), once their
+     * attributes change. A device that is already attached is not attached
+     * twice. Devices that go away hang up their descriptor and are released by
+     * ld2420_linux_ingest_poll().
+     *
+     * @param ingest Initialized context without a device watch
+     * @param dir Directory to watch
+     * @param prefix Device name prefix
+     * @param port_callback Optional; told about ports the ingest attaches and releases
+     *
+     * @return LD2420_STATUS_OK on success,
+     *         LD2420_STATUS_ERROR_ALREADY_INITIALIZED if a watch is active,
+     *         LD2420_STATUS_ERROR_INVALID_ARGUMENTS on NULL or too long arguments,
+     *         LD2420_STATUS_ERROR_UNKNOWN if inotify or epoll fail (errno is preserved)
+     */
+    ld2420_status_t ld2420_linux_ingest_watch_devices(
+        ld2420_linux_ingest_t *ingest,
+        const char *dir,
+        const char *prefix,
+        ld2420_linux_port_callback_t port_callback);
+
+    /**
+     * @brief Wait for data on the attached ports and deliver complete frames.
+     *
+     * Issues a single epoll_wait() and one read() per ready port, feeds the
+     * bytes to that port's streaming parser and invokes the callback for each
+     * complete frame. Ports that hang up are closed and their slots released.
+     * With a device watch, new devices are attached in the same call.
+     *
+     * @param ingest Initialized context
+     * @param timeout_ms epoll timeout (-1 blocks, 0 returns immediately)
+     *
+     * @return Number of frames delivered (≥0), or -1 on error
+     */
+    int ld2420_linux_ingest_poll(ld2420_linux_ingest_t *ingest, int timeout_ms);
+
+    /**
+     * @brief Close all ports, the device watch and the epoll instance.
+     *
+     * @param ingest Context to tear down
+     * @return LD2420_STATUS_OK on success, error code otherwise
+     */
+    ld2420_status_t ld2420_linux_ingest_deinit(ld2420_linux_ingest_t *ingest);
+
+    /**
+     * @brief Hand every port over to another process without losing data.
+     *
+     * Sends each port's descriptor (SCM_RIGHTS), parser snapshot and counters
+     * over a connected AF_UNIX SOCK_SEQPACKET socket, one message per port,
+     * followed by an end marker. The receiving process resumes with
+     * ld2420_linux_ingest_handover_receive(); bytes that arrive in between stay
+     * in the kernel buffers of the shared descriptors, and a partially received
+     * frame continues in the new process.
+     *
+     * After the end marker this blocks until the receiver confirms that it
+     * attached every port. Only then are the ports released here (removed
+     * from epoll and the local descriptors closed). If the receiver declines,
+     * hangs up or a send fails, the ports stay attached and the caller can
+     * keep polling; descriptors the receiver hands back are closed.
+     *
+     * @param ingest Context whose ports are handed over; must not be polled concurrently
+     * @param sock Connected SOCK_SEQPACKET socket to the receiving process
+     *
+     * @return LD2420_STATUS_OK on success, LD2420_STATUS_ERROR_UNKNOWN if a
+     *         send or receive failed (errno is preserved), the receiver hung
+     *         up (ECONNABORTED) or declined the ports (ECONNREFUSED), error
+     *         code otherwise
+     */
+    ld2420_status_t ld2420_linux_ingest_handover_send(ld2420_linux_ingest_t *ingest, int sock);
+
+    /**
+     * @brief Take over the ports of another process.
+     *
+     * Counterpart of ld2420_linux_ingest_handover_send(). Blocks until the end
+     * marker arrives, then confirms the handover to the sender. Each port
+     * keeps its index, parser state and counters.
+     *
+     * @param ingest Initialized context without attached ports
+     * @param sock Connected SOCK_SEQPACKET socket to the sending process
+     *
+     * @return LD2420_STATUS_OK on success,
+     *         LD2420_STATUS_ERROR_ALREADY_INITIALIZED if ports are attached,
+     *         LD2420_STATUS_ERROR_INVALID_PACKET on a malformed or truncated
+     *         handover, LD2420_STATUS_ERROR_UNKNOWN if a receive or the
+     *         confirmation failed. On failure every port received so far is
+     *         detached and its descriptor handed back over the socket, and
+     *         the sender, which still owns the ports, is told to keep them.
+     */
+    ld2420_status_t ld2420_linux_ingest_handover_receive(ld2420_linux_ingest_t *ingest, int sock);
+
+#ifdef __cplusplus
+}
+#endif
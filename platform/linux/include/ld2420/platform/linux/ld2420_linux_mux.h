@@ -0,0 +1,168 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420/ld2420.h"
+#include "ld2420/ld2420_cmdstats.h"
+#include "ld2420/ld2420_framer.h"
+
+/** Clients one multiplexer serves at a time; further connections are refused. */
+#define LD2420_LINUX_MUX_MAX_CLIENTS 16u
+
+/** Commands a client can have waiting; its socket is not read while they are full. */
+#define LD2420_LINUX_MUX_QUEUE 4u
+
+/** Time the sensor has to acknowledge a command. */
+#define LD2420_LINUX_MUX_ACK_TIMEOUT_MS 1000u
+
+/**
+ * Time a client may hold a config-mode session without sending a command.
+ * After that the multiplexer closes the session on the client's behalf.
+ */
+#define LD2420_LINUX_MUX_SESSION_IDLE_MS 5000u
+
+/** Client index of a command the multiplexer issued itself. */
+#define LD2420_LINUX_MUX_SELF 0xFEu
+
+/** No client. */
+#define LD2420_LINUX_MUX_NONE 0xFFu
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    /**
+     * @brief State of one connected client.
+     */
+    typedef struct
+    {
+        int fd;                    // -1 when the slot is unused
+        uint32_t generation;       // Bumped on every accept; stale epoll events are ignored
+        uint8_t queue[LD2420_LINUX_MUX_QUEUE][LD2420_MAX_TX_PACKET_SIZE];
+        uint16_t sizes[LD2420_LINUX_MUX_QUEUE];
+        uint8_t head;              // Oldest queued command
+        uint8_t count;             // Queued commands
+        bool reading;              // EPOLLIN is armed (the queue has room)
+        bool closing;              // Hung up with commands queued; no longer polled, gone once they went out
+        uint32_t last_command_ms;  // When the client's last command went to the sensor
+        uint32_t commands;         // Commands sent to the sensor
+        uint32_t acks;             // ACKs delivered
+        uint32_t rejected;         // Messages that were not one valid command frame
+        uint64_t frames;           // Report and other unsolicited frames delivered
+        uint64_t dropped_frames;   // Frames not delivered because the socket was full
+    } ld2420_linux_mux_client_t;
+
+    /**
+     * @brief Session multiplexer: several clients sharing one sensor.
+     *
+     * The multiplexer owns the sensor's serial port and listens on a
+     * SOCK_SEQPACKET socket (see ld2420_linux_mux_listen()). Each client
+     * message is one complete command frame; the multiplexer sends each client
+     * the ACKs of its own commands and every frame that is not an ACK, one
+     * frame per message.
+     *
+     * Commands are serialised into transactions. One command is in flight at a
+     * time, and an OPEN_CONFIG_MODE that the sensor acknowledges with status 0
+     * gives its client the config-mode session: until CLOSE_CONFIG_MODE, only
+     * that client's commands go to the sensor, and the others' wait in their
+     * queues. A client that disconnects or stays idle for
+     * LD2420_LINUX_MUX_SESSION_IDLE_MS while holding the session has it closed
+     * on its behalf, so the sensor goes back to reporting. Without a session,
+     * clients take turns command by command.
+     *
+     * The serial side is framed by ld2420_framer_t rather than by
+     * ld2420_stream_t, which only knows ACK frames: report frames (F4 F3 F2
+     * F1 ... F8 F7 F6 F5) are assembled too. Frames are sent to the clients
+     * from the framer's slot with one non-blocking send() each; a client that does not keep
+     * up loses frames, never the others. Not thread-safe; the structure is
+     * about 16 KiB.
+     *
+     * Every command is timed from the moment its last byte was written to
+     * the moment its ACK was framed, per command id (cmdstats, see
+     * ld2420_cmdstats.h); a command the multiplexer gives up on counts as a
+     * timeout there too.
+     */
+    typedef struct
+    {
+        int epoll_fd;
+        int serial_fd;
+        int listen_fd;
+        ld2420_framer_t framer;    // Frames of both families from the serial port
+        ld2420_linux_mux_client_t clients[LD2420_LINUX_MUX_MAX_CLIENTS];
+        uint8_t owner;             // Client holding the config-mode session, LD2420_LINUX_MUX_NONE
+        uint8_t in_flight;         // Client whose command awaits its ACK, _SELF or _NONE
+        uint8_t next_client;       // Where the round-robin search starts
+        uint16_t in_flight_cmd;    // Command id of the command in flight
+        uint32_t deadline_ms;      // When the command in flight times out
+        uint8_t tx[LD2420_MAX_TX_PACKET_SIZE];
+        uint16_t tx_size;          // Bytes of the command being written to the serial port
+        uint16_t tx_sent;
+        uint32_t transactions;     // Commands acknowledged
+        uint32_t sessions;         // Config-mode sessions granted
+        uint32_t forced_closes;    // Sessions closed on behalf of a client
+        uint32_t ack_timeouts;
+        uint32_t stray_acks;       // ACKs that matched no command in flight
+        uint32_t refused_clients;  // Connections refused because all slots were taken
+        uint64_t frames;           // Frames fanned out
+        uint32_t serial_errors;    // Frames dropped for a bad length or footer, and lost writes
+        ld2420_cmdstats_t cmdstats; // Round trips and outcomes per command id
+    } ld2420_linux_mux_t;
+
+    /**
+     * @brief Create a listening SOCK_SEQPACKET socket at path.
+     *
+     * An existing socket file at path is replaced.
+     *
+     * @return LD2420_STATUS_OK on success, LD2420_STATUS_ERROR_INVALID_ARGUMENTS
+     *         on NULL arguments or a path too long for sockaddr_un,
+     *         LD2420_STATUS_ERROR_UNKNOWN if the socket cannot be created
+     *         (errno is preserved)
+     */
+    ld2420_status_t ld2420_linux_mux_listen(const char *path, int *out_fd);
+
+    /**
+     * @brief Initialize a multiplexer.
+     *
+     * Both descriptors are owned by the multiplexer from here on and closed
+     * by ld2420_linux_mux_deinit().
+     *
+     * @param mux Multiplexer to initialize
+     * @param serial_fd Sensor port, e.g. from ld2420_linux_open_serial()
+     * @param listen_fd Listening socket, e.g. from ld2420_linux_mux_listen()
+     *
+     * @return LD2420_STATUS_OK on success, LD2420_STATUS_ERROR_INVALID_ARGUMENTS
+     *         on a NULL mux or negative descriptor, LD2420_STATUS_ERROR_UNKNOWN
+     *         if epoll cannot be set up
+     */
+    ld2420_status_t ld2420_linux_mux_init(ld2420_linux_mux_t *mux, int serial_fd, int listen_fd);
+
+    /**
+     * @brief Wait for and handle sensor data, client commands and timeouts.
+     *
+     * The wait is shortened to the next ACK or session deadline.
+     *
+     * @param mux Multiplexer
+     * @param timeout_ms Longest wait in milliseconds, -1 for no limit
+     *
+     * @return Number of frames received from the sensor (≥0), or -1 on error
+     *         (including a sensor port that hung up)
+     */
+    int ld2420_linux_mux_poll(ld2420_linux_mux_t *mux, int timeout_ms);
+
+    /**
+     * @brief Number of connected clients.
+     */
+    uint16_t ld2420_linux_mux_client_count(const ld2420_linux_mux_t *mux);
+
+    /**
+     * @brief Disconnect all clients and close the sensor port and the
+     *        listening socket. A session still open is closed on the sensor
+     *        first, without waiting for its ACK.
+     */
+    ld2420_status_t ld2420_linux_mux_deinit(ld2420_linux_mux_t *mux);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420/ld2420.h"
+#include "ld2420/ld2420_replay.h"
+#include "ld2420/platform/linux/ld2420_linux.h"
+
+/** Identifies a frame ring ("LDSH") and its layout version. */
+#define LD2420_LINUX_SHM_MAGIC 0x4853444Cu
+#define LD2420_LINUX_SHM_VERSION 1u
+
+/** Smallest ring capacity; capacities are powers of two. */
+#define LD2420_LINUX_SHM_MIN_CAPACITY 4096u
+
+/** Largest frame a record carries. */
+#define LD2420_LINUX_SHM_MAX_FRAME 256u
+
+/** Bytes before each frame in the ring; records start on 8-byte boundaries. */
+#define LD2420_LINUX_SHM_RECORD_HEADER_SIZE 16u
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    /**
+     * @brief Header at the start of a shared-memory frame ring.
+     *
+     * Lives in the shared mapping, followed by `capacity` bytes of records. The
+     * producer's cursors and the consumers' wake-up words sit on separate cache
+     * lines, so idle consumers do not slow the producer down.
+     *
+     * Records are laid out back to back, each aligned to 8 bytes:
+     *
+     *   offset  size  field
+     *   0       8     sequence number, counting records from 0
+     *   8       2     port index (0xFFFF marks padding up to the end of the ring)
+     *   10      2     frame size N
+     *   12      2     cmd_echo
+     *   14      2     status
+     *   16      N     frame, as delivered by the ingest
+     *
+     * When fewer than LD2420_LINUX_SHM_RECORD_HEADER_SIZE bytes are left before
+     * the end of the ring, both sides skip them without a padding record.
+     *
+     * A ring opened with ld2420_linux_shm_publisher_open_replay() is followed by
+     * `replay_ports` ld2420_replay_sensor_t, the last frames of each port. Rings
+     * of producers without replay have zeros in the replay fields.
+     */
+    typedef struct
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t capacity; // Bytes of record space, a power of two
+        uint32_t replay_ports;       // Ports with a replay ring after the records, or 0
+        uint32_t replay_depth;       // LD2420_REPLAY_DEPTH of the producer
+        uint32_t replay_sensor_size; // sizeof(ld2420_replay_sensor_t) of the producer
+        uint32_t replay_max_age_ms;  // Oldest frame to replay, or 0 for no limit
+        uint8_t pad0[36];
+
+        uint64_t head;    // Bytes published; always at a record boundary
+        uint64_t reserve; // Bytes the producer may have started writing
+        uint64_t head_sequence; // Sequence number of the record that will start at head
+        uint32_t head_lock;     // Odd while head and head_sequence are being updated
+        uint8_t pad1[36];
+
+        uint32_t futex;   // Bumped whenever sleeping consumers are woken
+        uint32_t waiters; // Set by consumers going to sleep, cleared on wake-up
+        uint8_t pad2[56];
+    } ld2420_linux_shm_header_t;
+
+    /**
+     * @brief Producer side of a frame ring.
+     *
+     * The producer never waits for consumers: it overwrites the oldest records,
+     * and consumers that fall a whole ring behind notice it. Publishing costs a
+     * copy of the frame into the ring and, for the first record after some
+     * consumer went to sleep, one futex wake-up.
+     */
+    typedef struct
+    {
+        ld2420_linux_shm_header_t *ring;
+        uint8_t *data;
+        size_t map_size;
+        uint32_t mask;
+        uint64_t next_sequence;
+        uint64_t wakeups; // futex wake-ups issued
+        ld2420_replay_t replay; // sensors is NULL without replay
+    } ld2420_linux_shm_publisher_t;
+
+    /**
+     * @brief Consumer side of a frame ring.
+     *
+     * Each consumer keeps its own cursor in its own process; the producer does
+     * not know how many consumers there are.
+     */
+    typedef struct
+    {
+        ld2420_linux_shm_header_t *ring;
+        const uint8_t *data;
+        size_t map_size;
+        uint32_t mask;
+        uint64_t cursor;        // Byte position of the next record
+        uint64_t next_sequence; // Sequence number expected next
+        bool have_sequence;     // False until the first record after open
+        uint64_t records;       // Records delivered
+        uint64_t lost_records;  // Records overwritten before this consumer read them
+        uint64_t overruns;      // Times the consumer fell a whole ring behind
+        uint64_t torn;          // Records overwritten while their callback ran
+        uint64_t start_sequence; // Sequence number of the first record after open
+        ld2420_replay_t replay;  // Producer's replay; sensors is NULL without replay
+        uint64_t replayed;       // Frames delivered by ld2420_linux_shm_replay()
+        uint64_t replay_torn;    // Replay frames skipped or overwritten while read
+    } ld2420_linux_shm_consumer_t;
+
+    /**
+     * @brief Create a frame ring and map it for publishing.
+     *
+     * @param pub Publisher to initialize
+     * @param name POSIX shared memory name, e.g. "/ld2420-frames"; an existing
+     *        object of that name is replaced
+     * @param capacity Bytes of record space: a power of two, at least
+     *        LD2420_LINUX_SHM_MIN_CAPACITY
+     *
+     * @return LD2420_STATUS_OK on success,
+     *         LD2420_STATUS_ERROR_INVALID_ARGUMENTS on a bad name or capacity,
+     *         LD2420_STATUS_ERROR_UNKNOWN if a system call failed (errno is set)
+     */
+    ld2420_status_t ld2420_linux_shm_publisher_open(
+        ld2420_linux_shm_publisher_t *pub,
+        const char *name,
+        uint32_t capacity);
+
+    /**
+     * @brief Create a frame ring that also keeps the last frames of every port.
+     *
+     * Like ld2420_linux_shm_publisher_open(), plus one ld2420_replay_sensor_t per
+     * port in the same object (about LD2420_REPLAY_DEPTH * 176 bytes each), so
+     * that consumers opened later can be primed with ld2420_linux_shm_replay().
+     *
+     * @param replay_ports Ports to keep frames of (port indices 0..replay_ports-1);
+     *        0 for none
+     * @param max_age_ms Frames older than this are not replayed; 0 for no limit
+     *
+     * @return As ld2420_linux_shm_publisher_open(); also
+     *         LD2420_STATUS_ERROR_INVALID_ARGUMENTS for max_age_ms >= 2^31
+     */
+    ld2420_status_t ld2420_linux_shm_publisher_open_replay(
+        ld2420_linux_shm_publisher_t *pub,
+        const char *name,
+        uint32_t capacity,
+        uint32_t replay_ports,
+        uint32_t max_age_ms);
+
+    /**
+     * @brief Publish one frame.
+     *
+     * @return LD2420_STATUS_OK, or LD2420_STATUS_ERROR_INVALID_ARGUMENTS for a
+     *         NULL pointer or a frame larger than LD2420_LINUX_SHM_MAX_FRAME
+     */
+    ld2420_status_t ld2420_linux_shm_publish(
+        ld2420_linux_shm_publisher_t *pub,
+        uint16_t port_index,
+        const uint8_t *frame,
+        uint16_t frame_size_bytes,
+        uint16_t cmd_echo,
+        uint16_t status);
+
+    /**
+     * @brief Ingest callback that publishes every frame.
+     *
+     * Matches ld2420_linux_rx_callback_t; pass it to ld2420_linux_ingest_init()
+     * with the publisher as user pointer to mirror all ports into the ring.
+     */
+    void ld2420_linux_shm_publish_callback(
+        void *user,
+        uint16_t port_index,
+        const uint8_t *frame,
+        uint16_t frame_size_bytes,
+        uint16_t cmd_echo,
+        uint16_t status);
+
+    /**
+     * @brief Unmap the ring and optionally remove its name.
+     *
+     * Consumers that still have it mapped keep working; they simply see no new
+     * records.
+     */
+    void ld2420_linux_shm_publisher_close(ld2420_linux_shm_publisher_t *pub, const char *unlink_name);
+
+    /**
+     * @brief Map an existing frame ring for consuming.
+     *
+     * The consumer starts at the current head, i.e. with the next record
+     * published, whose sequence number is kept in start_sequence.
+     *
+     * @return LD2420_STATUS_OK on success,
+     *         LD2420_STATUS_ERROR_INVALID_ARGUMENTS on a NULL pointer,
+     *         LD2420_STATUS_ERROR_INVALID_HEADER if the object is not a frame ring
+     *         of this version or its replay was built with another
+     *         LD2420_REPLAY_DEPTH, LD2420_STATUS_ERROR_UNKNOWN if a system call failed
+     */
+    ld2420_status_t ld2420_linux_shm_consumer_open(ld2420_linux_shm_consumer_t *c, const char *name);
+
+    /**
+     * @brief Prime a new consumer with the last frames of every port.
+     *
+     * Call it once, right after ld2420_linux_shm_consumer_open() and before the
+     * first ld2420_linux_shm_consume(). It delivers, port by port and oldest first,
+     * the kept frames published before start_sequence, and ld2420_linux_shm_consume()
+     * continues with the record at start_sequence: every port's frames arrive in
+     * order, without a gap or duplicate between replay and live frames.
+     *
+     * Frames are delivered in place, like records. Frames the producer replaced
+     * before or while they were read are counted in replay_torn.
+     *
+     * @return Number of frames delivered (0 if the producer keeps none), or -1 on
+     *         invalid arguments
+     */
+    int ld2420_linux_shm_replay(ld2420_linux_shm_consumer_t *c, ld2420_linux_rx_callback_t callback, void *user);
+
+    /**
+     * @brief Deliver up to max_records published records, in order.
+     *
+     * Frames are delivered in place: the pointer refers to the shared ring and is
+     * only valid during the callback. The port index is the one the producer
+     * published. A consumer that fell a whole ring behind skips to the newest
+     * record; the records it missed are added to lost_records once the next one
+     * is read.
+     *
+     * A record is checked before its callback runs, so an overwritten record is
+     * never delivered. If the producer overwrites a record while its callback is
+     * still running, it is counted in `torn`; copy the frame first if that
+     * matters.
+     *
+     * @return Number of records delivered (≥0), or -1 on invalid arguments
+     */
+    int ld2420_linux_shm_consume(
+        ld2420_linux_shm_consumer_t *c,
+        ld2420_linux_rx_callback_t callback,
+        void *user,
+        uint32_t max_records);
+
+    /**
+     * @brief Sleep until a record is published after the consumer's cursor.
+     *
+     * Returns at once if one already is. The producer wakes all sleeping
+     * consumers with the first record published after they went to sleep.
+     *
+     * @param timeout_ms Longest wait, or -1 to wait indefinitely
+     *
+     * @return 1 when records are available, 0 on timeout or a signal, -1 on
+     *         invalid arguments
+     */
+    int ld2420_linux_shm_wait(ld2420_linux_shm_consumer_t *c, int timeout_ms);
+
+    /**
+     * @brief Unmap the ring.
+     */
+    void ld2420_linux_shm_consumer_close(ld2420_linux_shm_consumer_t *c);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420/ld2420.h"
+#include "ld2420/ld2420_telemetry.h"
+#include "ld2420/platform/linux/ld2420_linux.h"
+
+/** Largest datagram; fits a 1500-byte MTU with IP and UDP headers. */
+#define LD2420_LINUX_TELEMETRY_DATAGRAM_SIZE 1400u
+
+/** Datagrams collected before they must be handed to sendmmsg(). */
+#define LD2420_LINUX_TELEMETRY_BATCH 32u
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    /**
+     * @brief Telemetry publisher: decoded frames as compact binary datagrams.
+     *
+     * Events are packed into telemetry messages (see ld2420/ld2420_telemetry.h),
+     * one message per datagram, and the datagrams are sent with one sendmmsg()
+     * per ld2420_linux_telemetry_flush(). Works on any connected datagram
+     * socket: UDP to a collector, or an AF_UNIX SOCK_DGRAM/SOCK_SEQPACKET socket
+     * to a local process.
+     *
+     * Sends never block. Datagrams the socket does not take (EAGAIN) wait for
+     * the next flush; once the batch is full, new events are dropped and
+     * counted.
+     */
+    typedef struct
+    {
+        ld2420_telemetry_encoder_t encoder;
+        ld2420_telemetry_sensor_t sensors[LD2420_LINUX_MAX_PORTS];
+        int fd;
+        uint8_t datagrams[LD2420_LINUX_TELEMETRY_BATCH][LD2420_LINUX_TELEMETRY_DATAGRAM_SIZE];
+        uint16_t sizes[LD2420_LINUX_TELEMETRY_BATCH];
+        uint16_t first;        // First finished datagram not yet sent
+        uint16_t count;        // Finished datagrams, from index 0, including sent ones before first
+        bool open;             // A message is being built in datagrams[count]
+        uint64_t events;       // Events encoded
+        uint64_t datagrams_sent;
+        uint64_t bytes_sent;
+        uint64_t send_calls;   // sendmmsg() calls
+        uint64_t dropped_events;
+        int last_errno;        // errno of the last failed send, other than EAGAIN
+    } ld2420_linux_telemetry_t;
+
+    /**
+     * @brief Initialize a publisher on a connected datagram socket.
+     *
+     * The socket stays owned by the caller.
+     *
+     * @return LD2420_STATUS_OK, or LD2420_STATUS_ERROR_INVALID_ARGUMENTS on a
+     *         NULL publisher or negative fd
+     */
+    ld2420_status_t ld2420_linux_telemetry_init(ld2420_linux_telemetry_t *pub, int fd);
+
+    /**
+     * @brief Open a non-blocking UDP socket connected to host:port.
+     *
+     * @param host Numeric IPv4 or IPv6 address or host name
+     * @param port Destination port
+     * @param out_fd Receives the socket
+     *
+     * @return LD2420_STATUS_OK on success, LD2420_STATUS_ERROR_INVALID_ARGUMENTS
+     *         on NULL arguments, LD2420_STATUS_ERROR_UNKNOWN if the address does
+     *         not resolve or the socket cannot be connected
+     */
+    ld2420_status_t ld2420_linux_telemetry_connect_udp(const char *host, uint16_t port, int *out_fd);
+
+    /**
+     * @brief Open a non-blocking AF_UNIX datagram socket connected to path.
+     *
+     * @return LD2420_STATUS_OK on success, LD2420_STATUS_ERROR_INVALID_ARGUMENTS
+     *         on NULL arguments or a path too long for sockaddr_un,
+     *         LD2420_STATUS_ERROR_UNKNOWN if the socket cannot be connected
+     *         (errno is preserved)
+     */
+    ld2420_status_t ld2420_linux_telemetry_connect_unix(const char *path, int *out_fd);
+
+    /**
+     * @brief Queue one event.
+     *
+     * @return LD2420_STATUS_OK when the event was queued,
+     *         LD2420_STATUS_ERROR_BUFFER_TOO_SMALL when it was dropped because
+     *         the socket did not keep up,
+     *         LD2420_STATUS_ERROR_INVALID_ARGUMENTS for an event the encoder
+     *         rejects
+     */
+    ld2420_status_t ld2420_linux_telemetry_publish(ld2420_linux_telemetry_t *pub, const ld2420_telemetry_event_t *event);
+
+    /**
+     * @brief Queue a complete frame as an event, with the port index as sensor id.
+     *
+     * Frames that are neither report frames nor ACKs return
+     * LD2420_STATUS_ERROR_INVALID_FRAME and are not published.
+     */
+    ld2420_status_t ld2420_linux_telemetry_publish_frame(
+        ld2420_linux_telemetry_t *pub,
+        uint16_t port_index,
+        const uint8_t *frame,
+        uint16_t frame_size_bytes,
+        uint32_t timestamp_ms);
+
+    /**
+     * @brief Ingest callback that publishes every frame.
+     *
+     * Matches ld2420_linux_rx_callback_t; pass it to ld2420_linux_ingest_init()
+     * with the publisher as user pointer. Events are stamped with
+     * CLOCK_MONOTONIC in milliseconds. Call ld2420_linux_telemetry_flush() after
+     * each ld2420_linux_ingest_poll().
+     */
+    void ld2420_linux_telemetry_frame_callback(
+        void *user,
+        uint16_t port_index,
+        const uint8_t *frame,
+        uint16_t frame_size_bytes,
+        uint16_t cmd_echo,
+        uint16_t status);
+
+    /**
+     * @brief Finish the current message and send all queued datagrams.
+     *
+     * @return Number of datagrams sent (≥0), or -1 on a send error other than
+     *         EAGAIN (errno is set; the unsent datagrams stay queued)
+     */
+    int ld2420_linux_telemetry_flush(ld2420_linux_telemetry_t *pub);
+
+    /**
+     * @brief Number of finished datagrams waiting to be sent.
+     */
+    uint16_t ld2420_linux_telemetry_pending(const ld2420_linux_telemetry_t *pub);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420/ld2420.h"
+#include "ld2420/ld2420_stream.h"
+#include "ld2420/ld2420_framer.h"
+#include "ld2420/ld2420_uplink.h"
+#include "ld2420/platform/linux/ld2420_linux.h"
+
+/** One slot per possible uplink sensor id. */
+#define LD2420_LINUX_UPLINK_MAX_SENSORS 256
+
+/**
+ * Number of bytes requested per ld2420_linux_uplink_read(). A USB CDC link
+ * carries several sensors, so this is larger than LD2420_LINUX_READ_CHUNK.
+ */
+#define LD2420_LINUX_UPLINK_READ_CHUNK 1024u
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    /**
+     * @brief Per-sensor state behind an uplink: its parsers and counters.
+     */
+    typedef struct
+    {
+        ld2420_stream_t stream;  // Streaming parser for this sensor's ACKs
+        ld2420_framer_t framer;  // Report frames in BYTES records
+        uint32_t frames;         // Frames delivered
+        uint32_t errors;         // Records in which a parser reported an error, and bad report frames
+        uint32_t overflow_bytes; // Sensor bytes the gateway reported as dropped
+        uint32_t summaries;      // PRESENCE records: report frames the gateway sent without gate energies
+        uint16_t distance_cm;    // Distance of the last PRESENCE record
+        uint8_t presence;        // Presence of the last PRESENCE record
+    } ld2420_linux_uplink_sensor_t;
+
+    /**
+     * @brief Callback type for presence summaries.
+     *
+     * An overloaded gateway forwards report frames as PRESENCE records: the
+     * presence flag and distance without the gate energies (see
+     * ld2420/ld2420_shed.h). Presence changes always arrive; unchanged reports may
+     * have been dropped.
+     *
+     * @param user Pointer given to ld2420_linux_uplink_init()
+     * @param sensor_id Sensor the report came from
+     * @param presence Presence flag of the report
+     * @param distance_cm Distance of the report
+     */
+    typedef void (*ld2420_linux_summary_callback_t)(
+        void *user,
+        uint16_t sensor_id,
+        uint8_t presence,
+        uint16_t distance_cm);
+
+    /**
+     * @brief Host side of a binary uplink from a gateway (e.g. the Pico over USB CDC).
+     *
+     * Decodes uplink records and feeds FRAME and BYTES payloads into the stream
+     * parser of the sensor they came from, so frames reach the same callback type
+     * as with ld2420_linux_ingest_t, with the sensor id as port index. Report
+     * frames (F4 F3 F2 F1), which the stream parser does not know, are checked
+     * with ld2420_report_energy_decode() and delivered with cmd_echo and status
+     * 0; in BYTES records they are found by a per-sensor ld2420_framer_t. Not
+     * thread-safe; use one context per link. The structure contains parsers per
+     * sensor id (about 135 KiB), so allocate it statically or on the heap.
+     *
+     * PRESENCE records update the sensor's presence and distance and go to
+     * summary_callback, which ld2420_linux_uplink_init() leaves NULL; set it after
+     * init to receive them.
+     */
+    typedef struct
+    {
+        ld2420_uplink_decoder_t decoder;
+        ld2420_linux_rx_callback_t rx_callback;
+        ld2420_linux_summary_callback_t summary_callback;
+        void *user;
+        uint32_t timestamp_us; // Gateway timestamp of the record being delivered
+        ld2420_linux_uplink_sensor_t sensors[LD2420_LINUX_UPLINK_MAX_SENSORS];
+    } ld2420_linux_uplink_t;
+
+    /**
+     * @brief Initialize an uplink context.
+     *
+     * @param uplink Context to initialize
+     * @param rx_callback Function invoked for every complete frame
+     * @param user Opaque pointer passed back to rx_callback
+     *
+     * @return LD2420_STATUS_OK on success, error code otherwise
+     */
+    ld2420_status_t ld2420_linux_uplink_init(
+        ld2420_linux_uplink_t *uplink,
+        ld2420_linux_rx_callback_t rx_callback,
+        void *user);
+
+    /**
+     * @brief Decode a chunk of link bytes and deliver the frames it completes.
+     *
+     * During the callback, uplink->timestamp_us holds the gateway timestamp of the
+     * record that completed the frame.
+     *
+     * @param uplink Initialized context
+     * @param data Link bytes
+     * @param len Number of bytes
+     *
+     * @return Number of frames delivered (≥0), or -1 on invalid arguments.
+     *         Corrupt records and sequence gaps are counted in uplink->decoder.
+     */
+    int ld2420_linux_uplink_feed(ld2420_linux_uplink_t *uplink, const uint8_t *data, size_t len);
+
+    /**
+     * @brief Read once from a link descriptor and feed what arrived.
+     *
+     * Issues a single read() of up to LD2420_LINUX_UPLINK_READ_CHUNK bytes. A
+     * non-blocking descriptor without data yields 0.
+     *
+     * @param uplink Initialized context
+     * @param fd Link descriptor, e.g. from ld2420_linux_open_serial("/dev/ttyACM0")
+     *
+     * @return Number of frames delivered (≥0), or -1 on a read error or end of
+     *         file (errno is preserved; 0 for end of file)
+     */
+    int ld2420_linux_uplink_read(ld2420_linux_uplink_t *uplink, int fd);
+
+#ifdef __cplusplus
+}
+#endif
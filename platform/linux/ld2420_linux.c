@@ -0,0 +1,654 @@
+/*
+ * LD2420 Linux host platform
+ * --------------------------
+ * Serial port setup and a single-threaded, epoll-driven ingest loop that feeds
+ * any number of LD2420 ports through their own streaming parser contexts.
+ *
+ * Memory & Threading
+ * ------------------
+ * - The port table is embedded in ld2420_linux_ingest_t; no dynamic allocation
+ * - One read() per readiness event into a stack buffer
+ * - Not thread-safe; use one ingest context per thread
+ *
+ * Hot Plug
+ * --------
+ * Ports are attached and released between (or during) polls on the polling
+ * thread, so no other port is paused or locked. Epoll events carry the slot
+ * index and the slot's generation; an event queued for a port that was
+ * released, and whose slot was reused within the same poll, is dropped. The
+ * device watch is an inotify descriptor in the same epoll set.
+ *
+ * Handover
+ * --------
+ * Ports move to another process as one SOCK_SEQPACKET message each: the
+ * descriptor as SCM_RIGHTS plus a fixed header and the parser snapshot,
+ * followed by an end marker carrying the number of ports sent.
+ */
+
+#include <ld2420/platform/linux/ld2420_linux.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+/** Slot value in the epoll data of the device watch. */
+#define EVENT_DEVICE_WATCH UINT32_MAX
+
+/**
+ * The stream parser callback carries no user pointer, so the port being fed is
+ * published here for the duration of the feed. Thread-local so independent
+ * ingest contexts can run on separate threads.
+ */
+static __thread ld2420_linux_ingest_t *feeding_ingest;
+static __thread uint16_t feeding_port;
+static __thread uint32_t feeding_generation;
+static __thread int feeding_frames;
+
+static bool on_stream_frame(
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    ld2420_linux_ingest_t *ingest = feeding_ingest;
+    ingest->ports[feeding_port].frames++;
+    feeding_frames++;
+    ingest->rx_callback(ingest->user, feeding_port, frame, frame_size_bytes, cmd_echo, status);
+    // The callback may have removed the port, and even attached another device
+    // in its slot; drop the rest of the read then
+    const ld2420_linux_port_t *port = &ingest->ports[feeding_port];
+    return port->fd >= 0 && port->generation == feeding_generation;
+}
+
+/** Stop polling a port and return its descriptor without closing it, or -1. */
+static int detach_port(ld2420_linux_ingest_t *ingest, uint16_t port_index)
+{
+    ld2420_linux_port_t *port = &ingest->ports[port_index];
+    const int fd = port->fd;
+    if (fd < 0)
+        return -1;
+
+    epoll_ctl(ingest->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+    port->fd = -1;
+
+    // Shrink the high-water mark so polling loops stay tight after removals.
+    while (ingest->port_count > 0 && ingest->ports[ingest->port_count - 1].fd < 0)
+        ingest->port_count--;
+    return fd;
+}
+
+static void release_port(ld2420_linux_ingest_t *ingest, uint16_t port_index)
+{
+    const int fd = detach_port(ingest, port_index);
+    if (fd >= 0)
+        close(fd);
+}
+
+ld2420_status_t ld2420_linux_open_serial(const char *path, int *out_fd)
+{
+    if (path == NULL || out_fd == NULL)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return LD2420_STATUS_ERROR_UNKNOWN;
+
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0)
+    {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return LD2420_STATUS_ERROR_UNKNOWN;
+    }
+
+    // Raw 8N1 without flow control, matching the sensor's fixed UART settings.
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, B115200);
+    cfsetospeed(&tio, B115200);
+
+    if (tcsetattr(fd, TCSANOW, &tio) != 0)
+    {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return LD2420_STATUS_ERROR_UNKNOWN;
+    }
+
+    *out_fd = fd;
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_linux_ingest_init(
+    ld2420_linux_ingest_t *ingest,
+    ld2420_linux_rx_callback_t rx_callback,
+    void *user)
+{
+    if (ingest == NULL || rx_callback == NULL)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    ingest->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (ingest->epoll_fd < 0)
+        return LD2420_STATUS_ERROR_UNKNOWN;
+
+    ingest->port_count = 0;
+    ingest->rx_callback = rx_callback;
+    ingest->user = user;
+    ingest->device_watch_fd = -1;
+    ingest->port_callback = NULL;
+    ingest->device_dir[0] = '\0';
+    ingest->device_prefix[0] = '\0';
+    for (uint16_t i = 0; i < LD2420_LINUX_MAX_PORTS; i++)
+    {
+        ingest->ports[i].fd = -1;
+        ingest->ports[i].generation = 0;
+    }
+
+    return LD2420_STATUS_OK;
+}
+
+/** Register fd with epoll and set up the (free) slot idx for it. */
+static ld2420_status_t attach_port(ld2420_linux_ingest_t *ingest, uint16_t idx, int fd)
+{
+    ld2420_linux_port_t *port = &ingest->ports[idx];
+    struct epoll_event ev = {0};
+    ev.events = EPOLLIN;
+    ev.data.u64 = (uint64_t)(port->generation + 1u) << 32 | idx;
+    if (epoll_ctl(ingest->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0)
+        return LD2420_STATUS_ERROR_UNKNOWN;
+
+    port->generation++;
+    port->fd = fd;
+    port->frames = 0;
+    port->errors = 0;
+    port->bytes = 0;
+    ld2420_stream_init(&port->stream);
+
+    if (idx >= ingest->port_count)
+        ingest->port_count = idx + 1;
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_linux_ingest_add(
+    ld2420_linux_ingest_t *ingest,
+    int fd,
+    uint16_t *out_port_index)
+{
+    if (ingest == NULL || fd < 0)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    // Reuse the first free slot below the high-water mark, else extend it.
+    uint16_t idx = 0;
+    while (idx < ingest->port_count && ingest->ports[idx].fd >= 0)
+        idx++;
+    if (idx >= LD2420_LINUX_MAX_PORTS)
+        return LD2420_STATUS_ERROR_BUFFER_TOO_SMALL;
+
+    ld2420_status_t status = attach_port(ingest, idx, fd);
+    if (status != LD2420_STATUS_OK)
+        return status;
+
+    if (out_port_index != NULL)
+        *out_port_index = idx;
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_linux_ingest_remove(ld2420_linux_ingest_t *ingest, uint16_t port_index)
+{
+    if (ingest == NULL || port_index >= ingest->port_count || ingest->ports[port_index].fd < 0)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    release_port(ingest, port_index);
+    return LD2420_STATUS_OK;
+}
+
+/** True if a port already reads the character device rdev. */
+static bool device_attached(const ld2420_linux_ingest_t *ingest, dev_t rdev)
+{
+    for (uint16_t i = 0; i < ingest->port_count; i++)
+    {
+        struct stat st;
+        if (ingest->ports[i].fd >= 0 && fstat(ingest->ports[i].fd, &st) == 0 && S_ISCHR(st.st_mode) &&
+            st.st_rdev == rdev)
+            return true;
+    }
+    return false;
+}
+
+/** Open and attach device `name` of the watched directory if it is a new serial device. */
+static void attach_device(ld2420_linux_ingest_t *ingest, const char *name)
+{
+    if (strncmp(name, ingest->device_prefix, strlen(ingest->device_prefix)) != 0)
+        return;
+
+    char path[LD2420_LINUX_DEVICE_DIR_MAX + NAME_MAX + 2];
+    snprintf(path, sizeof(path), "%s/%s", ingest->device_dir, name);
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISCHR(st.st_mode) || device_attached(ingest, st.st_rdev))
+        return;
+
+    // Failures are expected while udev is still setting up the node; the
+    // attribute change that follows brings us back here
+    int fd;
+    uint16_t idx;
+    if (ld2420_linux_open_serial(path, &fd) != LD2420_STATUS_OK)
+        return;
+    if (ld2420_linux_ingest_add(ingest, fd, &idx) != LD2420_STATUS_OK)
+    {
+        close(fd);
+        return;
+    }
+    if (ingest->port_callback != NULL)
+        ingest->port_callback(ingest->user, idx, path, true);
+}
+
+/** Attach every matching device currently in the watched directory. */
+static void scan_devices(ld2420_linux_ingest_t *ingest)
+{
+    DIR *d = opendir(ingest->device_dir);
+    if (d == NULL)
+        return;
+    for (struct dirent *e = readdir(d); e != NULL; e = readdir(d))
+        attach_device(ingest, e->d_name);
+    closedir(d);
+}
+
+static void handle_device_events(ld2420_linux_ingest_t *ingest)
+{
+    union
+    {
+        char buf[4096];
+        struct inotify_event align;
+    } events;
+
+    for (;;)
+    {
+        ssize_t n = read(ingest->device_watch_fd, events.buf, sizeof(events.buf));
+        if (n <= 0)
+            return;
+
+        for (ssize_t off = 0; off < n;)
+        {
+            const struct inotify_event *ev = (const struct inotify_event *)&events.buf[off];
+            if (ev->mask & IN_Q_OVERFLOW)
+                scan_devices(ingest);
+            else if (ev->len > 0)
+                attach_device(ingest, ev->name);
+            off += (ssize_t)(sizeof(*ev) + ev->len);
+        }
+    }
+}
+
+ld2420_status_t ld2420_linux_ingest_watch_devices(
+    ld2420_linux_ingest_t *ingest,
+    const char *dir,
+    const char *prefix,
+    ld2420_linux_port_callback_t port_callback)
+{
+    if (ingest == NULL || ingest->epoll_fd < 0 || dir == NULL || prefix == NULL ||
+        strlen(dir) >= sizeof(ingest->device_dir) || strlen(prefix) >= sizeof(ingest->device_prefix))
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    if (ingest->device_watch_fd >= 0)
+        return LD2420_STATUS_ERROR_ALREADY_INITIALIZED;
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+        return LD2420_STATUS_ERROR_UNKNOWN;
+    struct epoll_event ev = {0};
+    ev.events = EPOLLIN;
+    ev.data.u64 = EVENT_DEVICE_WATCH;
+    if (inotify_add_watch(fd, dir, IN_CREATE | IN_ATTRIB | IN_MOVED_TO) < 0 ||
+        epoll_ctl(ingest->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0)
+    {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return LD2420_STATUS_ERROR_UNKNOWN;
+    }
+
+    strcpy(ingest->device_dir, dir);
+    strcpy(ingest->device_prefix, prefix);
+    ingest->device_watch_fd = fd;
+    ingest->port_callback = port_callback;
+
+    // Devices created from here on are reported by inotify; attaching one twice is avoided
+    scan_devices(ingest);
+    return LD2420_STATUS_OK;
+}
+
+int ld2420_linux_ingest_poll(ld2420_linux_ingest_t *ingest, int timeout_ms)
+{
+    if (ingest == NULL || ingest->epoll_fd < 0)
+        return -1;
+
+    struct epoll_event events[LD2420_LINUX_MAX_EVENTS];
+    int ready = epoll_wait(ingest->epoll_fd, events, LD2420_LINUX_MAX_EVENTS, timeout_ms);
+    if (ready < 0)
+        return errno == EINTR ? 0 : -1;
+
+    feeding_ingest = ingest;
+    feeding_frames = 0;
+
+    for (int e = 0; e < ready; e++)
+    {
+        const uint32_t slot = (uint32_t)events[e].data.u64;
+        if (slot == EVENT_DEVICE_WATCH)
+        {
+            handle_device_events(ingest);
+            continue;
+        }
+
+        // Skip events of ports released earlier in this batch, even if the slot was reused
+        uint16_t idx = (uint16_t)slot;
+        ld2420_linux_port_t *port = &ingest->ports[idx];
+        if (port->fd < 0 || port->generation != (uint32_t)(events[e].data.u64 >> 32))
+            continue;
+
+        uint8_t chunk[LD2420_LINUX_READ_CHUNK];
+        ssize_t n = read(port->fd, chunk, sizeof(chunk));
+        if (n > 0)
+        {
+            port->bytes += (uint64_t)n;
+            feeding_port = idx;
+            feeding_generation = port->generation;
+            if (ld2420_stream_feed_bytes(&port->stream, chunk, (size_t)n, on_stream_frame, NULL) != LD2420_STATUS_OK &&
+                port->generation == feeding_generation)
+                port->errors++;
+            continue;
+        }
+
+        // Spurious wakeups are harmless; anything else means the port is gone.
+        if (n < 0 && (errno == EAGAIN || errno == EINTR))
+            continue;
+        release_port(ingest, idx);
+        if (ingest->port_callback != NULL)
+            ingest->port_callback(ingest->user, idx, NULL, false);
+    }
+
+    feeding_ingest = NULL;
+    return feeding_frames;
+}
+
+ld2420_status_t ld2420_linux_ingest_deinit(ld2420_linux_ingest_t *ingest)
+{
+    if (ingest == NULL)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    for (uint16_t i = ingest->port_count; i-- > 0;)
+        release_port(ingest, i);
+    ingest->port_count = 0;
+
+    if (ingest->device_watch_fd >= 0)
+        close(ingest->device_watch_fd);
+    ingest->device_watch_fd = -1;
+    if (ingest->epoll_fd >= 0)
+        close(ingest->epoll_fd);
+    ingest->epoll_fd = -1;
+    return LD2420_STATUS_OK;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Handover                                                                  */
+/* ------------------------------------------------------------------------- */
+
+#define HANDOVER_VERSION 2u
+#define HANDOVER_TYPE_PORT 1u
+#define HANDOVER_TYPE_END 2u
+#define HANDOVER_TYPE_ACK 3u
+#define HANDOVER_TYPE_RETURN 4u
+#define HANDOVER_TYPE_DECLINE 5u
+
+/**
+ * Message header: magic 'L' 'H', version, type, port index (or port count for
+ * the end marker and the replies), reserved, frames, errors, bytes; all
+ * little-endian. Port messages continue with the parser snapshot.
+ *
+ * Sender: PORT (with fd) per port, then END. Receiver: ACK once every port is
+ * attached; otherwise RETURN (with fd) per port it had attached, then DECLINE.
+ */
+#define HANDOVER_HEADER_SIZE 24u
+#define HANDOVER_MAX_MESSAGE (HANDOVER_HEADER_SIZE + LD2420_STREAM_SNAPSHOT_MAX_SIZE)
+
+static void put_le(uint8_t *b, uint64_t v, unsigned size)
+{
+    for (unsigned i = 0; i < size; i++)
+        b[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint64_t get_le(const uint8_t *b, unsigned size)
+{
+    uint64_t v = 0;
+    for (unsigned i = 0; i < size; i++)
+        v |= (uint64_t)b[i] << (8 * i);
+    return v;
+}
+
+static void put_handover_header(uint8_t *msg, uint8_t type, uint16_t index, const ld2420_linux_port_t *port)
+{
+    msg[0] = 'L';
+    msg[1] = 'H';
+    msg[2] = HANDOVER_VERSION;
+    msg[3] = type;
+    put_le(&msg[4], index, 2);
+    put_le(&msg[6], 0, 2);
+    put_le(&msg[8], port ? port->frames : 0, 4);
+    put_le(&msg[12], port ? port->errors : 0, 4);
+    put_le(&msg[16], port ? port->bytes : 0, 8);
+}
+
+/** Send one message, with fd attached when fd >= 0. */
+static bool send_handover_message(int sock, const uint8_t *msg, size_t size, int fd)
+{
+    struct iovec iov = {.iov_base = (void *)msg, .iov_len = size};
+    union
+    {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    struct msghdr mh = {0};
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+    if (fd >= 0)
+    {
+        memset(&control, 0, sizeof(control));
+        mh.msg_control = control.buf;
+        mh.msg_controllen = sizeof(control.buf);
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(&mh);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+    }
+
+    ssize_t n;
+    do
+        n = sendmsg(sock, &mh, MSG_NOSIGNAL);
+    while (n < 0 && errno == EINTR);
+    return n == (ssize_t)size;
+}
+
+/**
+ * Receive one message. Returns its size, 0 on end of stream or a malformed
+ * message, -1 on a receive error. *out_fd is the attached descriptor or -1.
+ */
+static ssize_t receive_handover_message(int sock, uint8_t *msg, size_t size, int *out_fd)
+{
+    struct iovec iov = {.iov_base = msg, .iov_len = size};
+    union
+    {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    struct msghdr mh = {0};
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+    mh.msg_control = control.buf;
+    mh.msg_controllen = sizeof(control.buf);
+
+    *out_fd = -1;
+    ssize_t n;
+    do
+        n = recvmsg(sock, &mh, MSG_CMSG_CLOEXEC);
+    while (n < 0 && errno == EINTR);
+    if (n < 0)
+        return -1;
+
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&mh); cmsg != NULL; cmsg = CMSG_NXTHDR(&mh, cmsg))
+    {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+            cmsg->cmsg_len == CMSG_LEN(sizeof(int)))
+            memcpy(out_fd, CMSG_DATA(cmsg), sizeof(int));
+    }
+
+    if ((mh.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0 || (size_t)n < HANDOVER_HEADER_SIZE ||
+        msg[0] != 'L' || msg[1] != 'H' || msg[2] != HANDOVER_VERSION)
+        return 0;
+    return n;
+}
+
+ld2420_status_t ld2420_linux_ingest_handover_send(ld2420_linux_ingest_t *ingest, int sock)
+{
+    if (ingest == NULL || sock < 0)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    uint8_t msg[HANDOVER_MAX_MESSAGE];
+    uint16_t sent = 0;
+    for (uint16_t idx = 0; idx < ingest->port_count; idx++)
+    {
+        ld2420_linux_port_t *port = &ingest->ports[idx];
+        if (port->fd < 0)
+            continue;
+
+        size_t snapshot_size = 0;
+        put_handover_header(msg, HANDOVER_TYPE_PORT, idx, port);
+        ld2420_status_t status = ld2420_stream_snapshot(&port->stream, &msg[HANDOVER_HEADER_SIZE],
+                                                        sizeof(msg) - HANDOVER_HEADER_SIZE, &snapshot_size);
+        if (status != LD2420_STATUS_OK)
+            return status;
+        if (!send_handover_message(sock, msg, HANDOVER_HEADER_SIZE + snapshot_size, port->fd))
+            return LD2420_STATUS_ERROR_UNKNOWN;
+        sent++;
+    }
+
+    put_handover_header(msg, HANDOVER_TYPE_END, sent, NULL);
+    if (!send_handover_message(sock, msg, HANDOVER_HEADER_SIZE, -1))
+        return LD2420_STATUS_ERROR_UNKNOWN;
+
+    // Keep the ports until the receiver confirms. Descriptors it hands back
+    // are duplicates of ours, so they are simply closed.
+    for (;;)
+    {
+        int fd = -1;
+        ssize_t n = receive_handover_message(sock, msg, sizeof(msg), &fd);
+        if (fd >= 0)
+            close(fd);
+        if (n <= 0)
+        {
+            if (n == 0)
+                errno = ECONNABORTED;
+            return LD2420_STATUS_ERROR_UNKNOWN;
+        }
+        if (msg[3] == HANDOVER_TYPE_RETURN)
+            continue;
+        if (msg[3] == HANDOVER_TYPE_ACK && get_le(&msg[4], 2) == sent)
+            break;
+        errno = ECONNREFUSED;
+        return LD2420_STATUS_ERROR_UNKNOWN;
+    }
+
+    // The receiver owns the ports now; drop our references without reading again
+    for (uint16_t i = ingest->port_count; i-- > 0;)
+        release_port(ingest, i);
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_linux_ingest_handover_receive(ld2420_linux_ingest_t *ingest, int sock)
+{
+    if (ingest == NULL || ingest->epoll_fd < 0 || sock < 0)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    if (ingest->port_count > 0)
+        return LD2420_STATUS_ERROR_ALREADY_INITIALIZED;
+
+    uint8_t msg[HANDOVER_MAX_MESSAGE];
+    uint16_t received = 0;
+    ld2420_status_t status = LD2420_STATUS_ERROR_INVALID_PACKET;
+    int fd = -1;
+
+    for (;;)
+    {
+        ssize_t n = receive_handover_message(sock, msg, sizeof(msg), &fd);
+        if (n < 0)
+        {
+            status = LD2420_STATUS_ERROR_UNKNOWN;
+            break;
+        }
+        if (n == 0)
+            break;
+
+        const uint16_t idx = (uint16_t)get_le(&msg[4], 2);
+        if (msg[3] == HANDOVER_TYPE_END)
+        {
+            if (fd >= 0 || idx != received)
+                break;
+            put_handover_header(msg, HANDOVER_TYPE_ACK, received, NULL);
+            if (send_handover_message(sock, msg, HANDOVER_HEADER_SIZE, -1))
+                return LD2420_STATUS_OK;
+            // Unconfirmed, so the sender keeps the ports
+            status = LD2420_STATUS_ERROR_UNKNOWN;
+            break;
+        }
+        if (msg[3] != HANDOVER_TYPE_PORT || fd < 0 || idx >= LD2420_LINUX_MAX_PORTS ||
+            (idx < ingest->port_count && ingest->ports[idx].fd >= 0))
+            break;
+
+        status = attach_port(ingest, idx, fd);
+        if (status != LD2420_STATUS_OK)
+            break;
+        fd = -1; // owned by the port now
+
+        ld2420_linux_port_t *port = &ingest->ports[idx];
+        status = ld2420_stream_restore(&port->stream, &msg[HANDOVER_HEADER_SIZE], (size_t)n - HANDOVER_HEADER_SIZE);
+        if (status != LD2420_STATUS_OK)
+        {
+            status = LD2420_STATUS_ERROR_INVALID_PACKET;
+            break;
+        }
+        port->frames = (uint32_t)get_le(&msg[8], 4);
+        port->errors = (uint32_t)get_le(&msg[12], 4);
+        port->bytes = get_le(&msg[16], 8);
+        received++;
+        status = LD2420_STATUS_ERROR_INVALID_PACKET;
+    }
+
+    // Incomplete handover: the sender still owns the ports, so hand every
+    // descriptor back instead of reading from it, then decline
+    int saved = errno;
+    if (fd >= 0)
+        close(fd);
+    for (uint16_t i = ingest->port_count; i-- > 0;)
+    {
+        const int port_fd = detach_port(ingest, i);
+        if (port_fd < 0)
+            continue;
+        put_handover_header(msg, HANDOVER_TYPE_RETURN, i, NULL);
+        send_handover_message(sock, msg, HANDOVER_HEADER_SIZE, port_fd);
+        close(port_fd);
+    }
+    put_handover_header(msg, HANDOVER_TYPE_DECLINE, received, NULL);
+    send_handover_message(sock, msg, HANDOVER_HEADER_SIZE, -1);
+    errno = saved;
+    return status;
+}
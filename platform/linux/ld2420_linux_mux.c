@@ -0,0 +1,575 @@
+/*
+ * LD2420 Linux session multiplexer
+ * --------------------------------
+ * Lets several clients (calibration tools, monitoring daemons, a technician's
+ * laptop) share one sensor through a local SOCK_SEQPACKET socket.
+ *
+ * Design Principles
+ * -----------------
+ * 1. One command in flight. The next one goes to the sensor when the ACK of
+ *    the previous one arrived or timed out, so every ACK belongs to exactly
+ *    one client and is sent to that client only
+ * 2. A successful OPEN_CONFIG_MODE is a session: until CLOSE_CONFIG_MODE (or
+ *    REBOOT) only the session's client is served. A session whose client is
+ *    gone or idle is closed by the multiplexer, so a crashed tool cannot leave
+ *    the sensor in config mode
+ * 3. Frames go from the framer's slot straight to every client's socket.
+ *    Sends never block; a slow client loses frames, counted per client
+ * 4. A client with LD2420_LINUX_MUX_QUEUE commands waiting is not read from
+ *    until one went out, so its socket buffer holds the back pressure. A
+ *    client that hangs up with commands waiting leaves the epoll set at once
+ *    (a hang-up is reported on every wait) and is disconnected when the last
+ *    of them went out
+ *
+ * Memory & Threading
+ * ------------------
+ * - Client table, queues and framer are embedded in the context; no dynamic
+ *   allocation
+ * - Not thread-safe; one multiplexer per sensor, each with its own epoll set
+ *   (which can itself be polled from an outer loop)
+ */
+
+#define _GNU_SOURCE
+
+#include <ld2420/platform/linux/ld2420_linux_mux.h>
+#include <ld2420/ld2420_protocol.h>
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/** Slot values in the epoll data of the serial port and the listening socket. */
+#define EVENT_SERIAL UINT32_MAX
+#define EVENT_LISTEN (UINT32_MAX - 1u)
+
+/** Bytes read from the serial port per wakeup. */
+#define LD2420_MUX_READ_CHUNK 512u
+
+LD2420_PROTOCOL_STATIC_CHECK(mux_frame_buffer, LD2420_PROTOCOL_REPORT_MAX_SIZE <= LD2420_MAX_RX_PACKET_SIZE &&
+                                                   LD2420_PROTOCOL_ACK_MAX_SIZE <= LD2420_MAX_RX_PACKET_SIZE);
+LD2420_PROTOCOL_STATIC_CHECK(mux_client_index, LD2420_LINUX_MUX_MAX_CLIENTS < LD2420_LINUX_MUX_SELF);
+
+static uint32_t monotonic_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u);
+}
+
+static uint32_t monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u);
+}
+
+/** True once `now` has reached `t`, across clock wraps. */
+static inline bool time_reached(uint32_t now, uint32_t t)
+{
+    return (int32_t)(now - t) >= 0;
+}
+
+static bool is_real_client(uint8_t idx)
+{
+    return idx < LD2420_LINUX_MUX_MAX_CLIENTS;
+}
+
+static void set_client_events(ld2420_linux_mux_t *mux, uint8_t idx, bool reading)
+{
+    ld2420_linux_mux_client_t *c = &mux->clients[idx];
+    struct epoll_event ev = {0};
+    ev.events = EPOLLRDHUP | (reading ? EPOLLIN : 0u);
+    ev.data.u64 = (uint64_t)c->generation << 32 | idx;
+    epoll_ctl(mux->epoll_fd, EPOLL_CTL_MOD, c->fd, &ev);
+    c->reading = reading;
+}
+
+static void set_serial_events(ld2420_linux_mux_t *mux, bool writing)
+{
+    struct epoll_event ev = {0};
+    ev.events = EPOLLIN | (writing ? EPOLLOUT : 0u);
+    ev.data.u64 = EVENT_SERIAL;
+    epoll_ctl(mux->epoll_fd, EPOLL_CTL_MOD, mux->serial_fd, &ev);
+}
+
+static void disconnect_client(ld2420_linux_mux_t *mux, uint8_t idx)
+{
+    ld2420_linux_mux_client_t *c = &mux->clients[idx];
+    epoll_ctl(mux->epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->fd = -1;
+    c->count = 0;
+
+    // An ACK still on its way is swallowed; an open session is closed
+    if (mux->in_flight == idx)
+        mux->in_flight = LD2420_LINUX_MUX_SELF;
+    if (mux->owner == idx)
+    {
+        mux->owner = LD2420_LINUX_MUX_SELF;
+        mux->forced_closes++;
+    }
+}
+
+ld2420_status_t ld2420_linux_mux_listen(const char *path, int *out_fd)
+{
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (path == NULL || out_fd == NULL || strlen(path) >= sizeof(addr.sun_path))
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return LD2420_STATUS_ERROR_UNKNOWN;
+    unlink(path);
+    if (bind(fd, (const struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 16) != 0)
+    {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return LD2420_STATUS_ERROR_UNKNOWN;
+    }
+    *out_fd = fd;
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_linux_mux_init(ld2420_linux_mux_t *mux, int serial_fd, int listen_fd)
+{
+    if (mux == NULL || serial_fd < 0 || listen_fd < 0)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    memset(mux, 0, sizeof(*mux));
+    mux->serial_fd = serial_fd;
+    mux->listen_fd = listen_fd;
+    mux->owner = LD2420_LINUX_MUX_NONE;
+    mux->in_flight = LD2420_LINUX_MUX_NONE;
+    for (uint8_t i = 0; i < LD2420_LINUX_MUX_MAX_CLIENTS; i++)
+        mux->clients[i].fd = -1;
+    ld2420_framer_init(&mux->framer);
+    ld2420_cmdstats_init(&mux->cmdstats, LD2420_LINUX_MUX_ACK_TIMEOUT_MS * 1000u);
+
+    mux->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (mux->epoll_fd < 0)
+        return LD2420_STATUS_ERROR_UNKNOWN;
+    struct epoll_event ev = {0};
+    ev.events = EPOLLIN;
+    ev.data.u64 = EVENT_SERIAL;
+    if (epoll_ctl(mux->epoll_fd, EPOLL_CTL_ADD, serial_fd, &ev) != 0)
+        goto fail;
+    ev.data.u64 = EVENT_LISTEN;
+    if (epoll_ctl(mux->epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev) != 0)
+        goto fail;
+    return LD2420_STATUS_OK;
+
+fail:
+    close(mux->epoll_fd);
+    mux->epoll_fd = -1;
+    return LD2420_STATUS_ERROR_UNKNOWN;
+}
+
+uint16_t ld2420_linux_mux_client_count(const ld2420_linux_mux_t *mux)
+{
+    uint16_t n = 0;
+    if (mux == NULL)
+        return 0;
+    for (uint8_t i = 0; i < LD2420_LINUX_MUX_MAX_CLIENTS; i++)
+        n += mux->clients[i].fd >= 0 ? 1u : 0u;
+    return n;
+}
+
+/* ---- Serial side ---- */
+
+/** Write as much of the pending command as the port takes; time it once it is out. */
+static void write_tx(ld2420_linux_mux_t *mux)
+{
+    while (mux->tx_sent < mux->tx_size)
+    {
+        const ssize_t n = write(mux->serial_fd, mux->tx + mux->tx_sent, mux->tx_size - mux->tx_sent);
+        if (n > 0)
+        {
+            mux->tx_sent = (uint16_t)(mux->tx_sent + n);
+            if (mux->tx_sent == mux->tx_size)
+                ld2420_cmdstats_sent(&mux->cmdstats, mux->in_flight_cmd, monotonic_us());
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && errno == EAGAIN)
+        {
+            set_serial_events(mux, true);
+            return;
+        }
+        // The rest is lost; the command times out
+        mux->serial_errors++;
+        break;
+    }
+    if (mux->tx_size > 0)
+        set_serial_events(mux, false);
+    mux->tx_size = 0;
+    mux->tx_sent = 0;
+}
+
+/** Put a command in flight for a client (or for the multiplexer itself). */
+static void start_command(ld2420_linux_mux_t *mux, uint8_t idx, const uint8_t *frame, uint16_t size)
+{
+    const uint32_t now = monotonic_ms();
+    memcpy(mux->tx, frame, size);
+    mux->tx_size = size;
+    mux->tx_sent = 0;
+    mux->in_flight = idx;
+    mux->in_flight_cmd = ld2420_protocol_read_le16(frame + LD2420_COMMAND_ID_OFFSET);
+    mux->deadline_ms = now + LD2420_LINUX_MUX_ACK_TIMEOUT_MS;
+    if (is_real_client(idx))
+    {
+        mux->clients[idx].last_command_ms = now;
+        mux->clients[idx].commands++;
+    }
+    write_tx(mux);
+}
+
+/** Send the next command, if nothing is in flight and someone may send one. */
+static void schedule(ld2420_linux_mux_t *mux)
+{
+    if (mux->in_flight != LD2420_LINUX_MUX_NONE)
+        return;
+
+    if (mux->owner == LD2420_LINUX_MUX_SELF)
+    {
+        uint8_t close_cmd[LD2420_COMMAND_CLOSE_CONFIG_MODE_SIZE];
+        ld2420_command_close_config_mode_encode(close_cmd);
+        start_command(mux, LD2420_LINUX_MUX_SELF, close_cmd, sizeof(close_cmd));
+        return;
+    }
+
+    uint8_t idx = LD2420_LINUX_MUX_NONE;
+    if (mux->owner != LD2420_LINUX_MUX_NONE)
+    {
+        if (mux->clients[mux->owner].count > 0)
+            idx = mux->owner;
+    }
+    else
+    {
+        for (uint8_t k = 0; k < LD2420_LINUX_MUX_MAX_CLIENTS && idx == LD2420_LINUX_MUX_NONE; k++)
+        {
+            const uint8_t i = (uint8_t)((mux->next_client + k) % LD2420_LINUX_MUX_MAX_CLIENTS);
+            if (mux->clients[i].fd >= 0 && mux->clients[i].count > 0)
+                idx = i;
+        }
+        if (idx != LD2420_LINUX_MUX_NONE)
+            mux->next_client = (uint8_t)((idx + 1u) % LD2420_LINUX_MUX_MAX_CLIENTS);
+    }
+    if (idx == LD2420_LINUX_MUX_NONE)
+        return;
+
+    ld2420_linux_mux_client_t *c = &mux->clients[idx];
+    start_command(mux, idx, c->queue[c->head], c->sizes[c->head]);
+    c->head = (uint8_t)((c->head + 1u) % LD2420_LINUX_MUX_QUEUE);
+    c->count--;
+    if (c->closing)
+    {
+        if (c->count == 0)
+            disconnect_client(mux, idx);
+    }
+    else if (!c->reading)
+        set_client_events(mux, idx, true);
+}
+
+/** The ACK of the command in flight arrived: update the session and route it. */
+static void complete_command(ld2420_linux_mux_t *mux, const uint8_t *frame, uint16_t size)
+{
+    const uint8_t idx = mux->in_flight;
+    const uint16_t status = ld2420_protocol_read_le16(frame + LD2420_ACK_STATUS_OFFSET);
+    mux->in_flight = LD2420_LINUX_MUX_NONE;
+    mux->transactions++;
+
+    switch (mux->in_flight_cmd)
+    {
+    case LD2420_CMD_OPEN_CONFIG_MODE:
+        if (status == 0)
+        {
+            // A session whose client left while it was being opened is closed again
+            mux->owner = is_real_client(idx) ? idx : LD2420_LINUX_MUX_SELF;
+            mux->sessions += is_real_client(idx) ? 1u : 0u;
+        }
+        break;
+    case LD2420_CMD_CLOSE_CONFIG_MODE:
+    case LD2420_CMD_REBOOT:
+        mux->owner = LD2420_LINUX_MUX_NONE;
+        break;
+    default:
+        break;
+    }
+
+    if (!is_real_client(idx))
+        return;
+    ld2420_linux_mux_client_t *c = &mux->clients[idx];
+    if (send(c->fd, frame, size, MSG_DONTWAIT | MSG_NOSIGNAL) == (ssize_t)size)
+        c->acks++;
+    else
+        c->dropped_frames++;
+}
+
+static void fan_out(ld2420_linux_mux_t *mux, const uint8_t *frame, uint16_t size)
+{
+    mux->frames++;
+    for (uint8_t i = 0; i < LD2420_LINUX_MUX_MAX_CLIENTS; i++)
+    {
+        ld2420_linux_mux_client_t *c = &mux->clients[i];
+        if (c->fd < 0)
+            continue;
+        if (send(c->fd, frame, size, MSG_DONTWAIT | MSG_NOSIGNAL) == (ssize_t)size)
+            c->frames++;
+        else
+            c->dropped_frames++;
+    }
+}
+
+static void deliver_frame(ld2420_linux_mux_t *mux, const uint8_t *frame, uint16_t size)
+{
+    if (ld2420_protocol_read_le32(frame) == LD2420_PROTOCOL_REPORT_HEADER)
+    {
+        fan_out(mux, frame, size);
+        return;
+    }
+
+    const uint16_t echo = ld2420_protocol_read_le16(frame + LD2420_ACK_CMD_ECHO_OFFSET);
+    if (size < LD2420_PROTOCOL_ACK_MIN_SIZE ||
+        !ld2420_protocol_ack_length_valid((uint8_t)echo, (uint16_t)(size - LD2420_PROTOCOL_FRAME_OVERHEAD)))
+    {
+        mux->serial_errors++;
+        return;
+    }
+    ld2420_cmdstats_ack(&mux->cmdstats, echo, ld2420_protocol_read_le16(frame + LD2420_ACK_STATUS_OFFSET),
+                        monotonic_us());
+    if (mux->in_flight != LD2420_LINUX_MUX_NONE && echo == (mux->in_flight_cmd | LD2420_PROTOCOL_ACK_ECHO_FLAG))
+        complete_command(mux, frame, size);
+    else
+        mux->stray_acks++;
+}
+
+/** Frame serial bytes of both families with the framer the Pico platform uses too. */
+static int feed_serial(ld2420_linux_mux_t *mux, const uint8_t *data, size_t len)
+{
+    int frames = 0;
+    const uint32_t errors = mux->framer.errors;
+    for (size_t i = 0; i < len; i++)
+    {
+        uint16_t size;
+        const uint8_t *frame = ld2420_framer_push(&mux->framer, data[i], &size);
+        if (frame == NULL)
+            continue;
+        deliver_frame(mux, frame, size);
+        frames++;
+    }
+    mux->serial_errors += mux->framer.errors - errors;
+    return frames;
+}
+
+/* ---- Client side ---- */
+
+static void accept_clients(ld2420_linux_mux_t *mux)
+{
+    for (;;)
+    {
+        const int fd = accept4(mux->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return;
+        uint8_t idx = 0;
+        while (idx < LD2420_LINUX_MUX_MAX_CLIENTS && mux->clients[idx].fd >= 0)
+            idx++;
+        if (idx == LD2420_LINUX_MUX_MAX_CLIENTS)
+        {
+            mux->refused_clients++;
+            close(fd);
+            continue;
+        }
+
+        ld2420_linux_mux_client_t *c = &mux->clients[idx];
+        const uint32_t generation = c->generation + 1u;
+        memset(c, 0, sizeof(*c));
+        c->generation = generation;
+        struct epoll_event ev = {0};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.u64 = (uint64_t)generation << 32 | idx;
+        if (epoll_ctl(mux->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0)
+        {
+            close(fd);
+            c->fd = -1;
+            continue;
+        }
+        c->fd = fd;
+        c->reading = true;
+    }
+}
+
+/** One complete command frame that the sensor may accept by its length. */
+static bool valid_command(const uint8_t *frame, ssize_t size)
+{
+    if (size < (ssize_t)LD2420_PROTOCOL_COMMAND_MIN_SIZE || size > (ssize_t)LD2420_PROTOCOL_COMMAND_MAX_SIZE)
+        return false;
+    const uint16_t length = ld2420_protocol_read_le16(frame + LD2420_PROTOCOL_LENGTH_OFFSET);
+    return ld2420_protocol_read_le32(frame) == LD2420_PROTOCOL_COMMAND_HEADER &&
+           ld2420_protocol_read_le32(frame + size - 4) == LD2420_PROTOCOL_COMMAND_FOOTER &&
+           length == (uint16_t)(size - LD2420_PROTOCOL_FRAME_OVERHEAD) && frame[LD2420_COMMAND_ID_OFFSET + 1u] == 0 &&
+           ld2420_protocol_command_length_valid(frame[LD2420_COMMAND_ID_OFFSET], length);
+}
+
+/** Read queued commands; false if the client went away. */
+static bool read_client(ld2420_linux_mux_t *mux, uint8_t idx)
+{
+    ld2420_linux_mux_client_t *c = &mux->clients[idx];
+    while (c->count < LD2420_LINUX_MUX_QUEUE)
+    {
+        const uint8_t slot = (uint8_t)((c->head + c->count) % LD2420_LINUX_MUX_QUEUE);
+        // One byte more than a command may have, so an oversized message is noticed
+        uint8_t msg[LD2420_MAX_TX_PACKET_SIZE + 1u];
+        const ssize_t n = recv(c->fd, msg, sizeof(msg), MSG_DONTWAIT);
+        if (n == 0)
+            return false;
+        if (n < 0)
+            return errno == EAGAIN || errno == EINTR;
+        if (!valid_command(msg, n))
+        {
+            c->rejected++;
+            continue;
+        }
+        memcpy(c->queue[slot], msg, (size_t)n);
+        c->sizes[slot] = (uint16_t)n;
+        c->count++;
+    }
+    if (c->reading)
+        set_client_events(mux, idx, false);
+    return true;
+}
+
+/* ---- Timers ---- */
+
+static void check_timers(ld2420_linux_mux_t *mux, uint32_t now)
+{
+    if (mux->in_flight != LD2420_LINUX_MUX_NONE && time_reached(now, mux->deadline_ms))
+    {
+        mux->ack_timeouts++;
+        ld2420_cmdstats_expire(&mux->cmdstats);
+        // A close of our own that goes unanswered is not retried forever
+        if (mux->in_flight == LD2420_LINUX_MUX_SELF && mux->owner == LD2420_LINUX_MUX_SELF)
+            mux->owner = LD2420_LINUX_MUX_NONE;
+        mux->in_flight = LD2420_LINUX_MUX_NONE;
+        if (mux->tx_size > 0)
+            set_serial_events(mux, false);
+        mux->tx_size = 0;
+        mux->tx_sent = 0;
+    }
+    if (is_real_client(mux->owner) && mux->in_flight == LD2420_LINUX_MUX_NONE &&
+        mux->clients[mux->owner].count == 0 &&
+        time_reached(now, mux->clients[mux->owner].last_command_ms + LD2420_LINUX_MUX_SESSION_IDLE_MS))
+    {
+        mux->owner = LD2420_LINUX_MUX_SELF;
+        mux->forced_closes++;
+    }
+}
+
+/** Milliseconds until the next timer, at most timeout_ms (-1: none). */
+static int next_timeout(const ld2420_linux_mux_t *mux, uint32_t now, int timeout_ms)
+{
+    uint32_t due;
+    if (mux->in_flight != LD2420_LINUX_MUX_NONE)
+        due = mux->deadline_ms;
+    else if (is_real_client(mux->owner))
+        due = mux->clients[mux->owner].last_command_ms + LD2420_LINUX_MUX_SESSION_IDLE_MS;
+    else
+        return timeout_ms;
+    const int left = time_reached(now, due) ? 0 : (int)(due - now);
+    return timeout_ms < 0 || left < timeout_ms ? left : timeout_ms;
+}
+
+int ld2420_linux_mux_poll(ld2420_linux_mux_t *mux, int timeout_ms)
+{
+    if (mux == NULL || mux->epoll_fd < 0)
+        return -1;
+
+    struct epoll_event events[LD2420_LINUX_MUX_MAX_CLIENTS + 2u];
+    const int ready = epoll_wait(mux->epoll_fd, events, (int)(sizeof(events) / sizeof(events[0])),
+                                 next_timeout(mux, monotonic_ms(), timeout_ms));
+    if (ready < 0)
+        return errno == EINTR ? 0 : -1;
+
+    int frames = 0;
+    bool hung_up = false;
+    for (int e = 0; e < ready; e++)
+    {
+        const uint32_t slot = (uint32_t)events[e].data.u64;
+        if (slot == EVENT_LISTEN)
+        {
+            accept_clients(mux);
+            continue;
+        }
+        if (slot == EVENT_SERIAL)
+        {
+            if (events[e].events & EPOLLOUT)
+                write_tx(mux);
+            if (events[e].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+            {
+                uint8_t chunk[LD2420_MUX_READ_CHUNK];
+                const ssize_t n = read(mux->serial_fd, chunk, sizeof(chunk));
+                if (n > 0)
+                    frames += feed_serial(mux, chunk, (size_t)n);
+                else if (n == 0 || (errno != EAGAIN && errno != EINTR))
+                    hung_up = true;
+            }
+            continue;
+        }
+
+        const uint8_t idx = (uint8_t)slot;
+        ld2420_linux_mux_client_t *c = &mux->clients[idx];
+        if (c->fd < 0 || c->generation != (uint32_t)(events[e].data.u64 >> 32))
+            continue;
+        if (!read_client(mux, idx))
+            disconnect_client(mux, idx);
+        else if (events[e].events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+        {
+            if (c->count == 0)
+                disconnect_client(mux, idx);
+            else if (!c->closing)
+            {
+                // Still reported while the queue is full; send what is queued, then drop the client
+                epoll_ctl(mux->epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+                c->closing = true;
+            }
+        }
+    }
+
+    check_timers(mux, monotonic_ms());
+    schedule(mux);
+    return hung_up ? -1 : frames;
+}
+
+ld2420_status_t ld2420_linux_mux_deinit(ld2420_linux_mux_t *mux)
+{
+    if (mux == NULL)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    if (mux->owner != LD2420_LINUX_MUX_NONE && mux->serial_fd >= 0)
+    {
+        uint8_t close_cmd[LD2420_COMMAND_CLOSE_CONFIG_MODE_SIZE];
+        ld2420_command_close_config_mode_encode(close_cmd);
+        (void)!write(mux->serial_fd, close_cmd, sizeof(close_cmd));
+    }
+    for (uint8_t i = 0; i < LD2420_LINUX_MUX_MAX_CLIENTS; i++)
+        if (mux->clients[i].fd >= 0)
+        {
+            close(mux->clients[i].fd);
+            mux->clients[i].fd = -1;
+        }
+    if (mux->serial_fd >= 0)
+        close(mux->serial_fd);
+    if (mux->listen_fd >= 0)
+        close(mux->listen_fd);
+    if (mux->epoll_fd >= 0)
+        close(mux->epoll_fd);
+    mux->serial_fd = mux->listen_fd = mux->epoll_fd = -1;
+    mux->owner = LD2420_LINUX_MUX_NONE;
+    return LD2420_STATUS_OK;
+}
@@ -0,0 +1,442 @@
+/*
+ * LD2420 Linux shared-memory frame ring
+ * -------------------------------------
+ * Single producer, any number of consumers, each in its own process. The
+ * producer copies every frame into a POSIX shared memory ring; consumers read
+ * the records in place.
+ *
+ * Design Principles
+ * -----------------
+ * 1. The producer never waits. It overwrites the oldest records, and every
+ *    consumer keeps its own cursor, so a slow or stuck consumer costs nobody
+ *    else anything
+ * 2. Overwrites are detected seqlock-style: before writing a record the
+ *    producer advances `reserve` past it. A consumer reads a record and then
+ *    checks that `reserve` has not come within a ring of it
+ * 3. Records carry a sequence number, so a consumer that was overrun knows
+ *    exactly how many records it lost once it reads the next one
+ * 4. Consumers announce that they are going to sleep in `waiters`; the
+ *    producer only issues a futex wake-up when that flag is set, and clears
+ *    it, so consumers that are busy cost it nothing
+ * 5. With replay, the producer keeps each frame in its port's replay ring
+ *    before it moves the head, and moves head and head_sequence together
+ *    under `head_lock`. A consumer reads both at open, so it knows exactly
+ *    which frames are history (replay) and which it will read live
+ *
+ * Memory & Threading
+ * ------------------
+ * - One mapping per side; nothing is allocated per record
+ * - One producer per ring. A consumer context belongs to one thread
+ */
+
+#define _GNU_SOURCE
+
+#include <ld2420/platform/linux/ld2420_linux_shm.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+/** Port index of a padding record. */
+#define SHM_PAD_PORT 0xFFFFu
+
+static inline uint32_t record_size(uint16_t frame_size_bytes)
+{
+    return (LD2420_LINUX_SHM_RECORD_HEADER_SIZE + frame_size_bytes + 7u) & ~7u;
+}
+
+static inline uint16_t read_u16(const uint8_t *p)
+{
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u);
+}
+
+static long futex(uint32_t *word, int op, uint32_t value, const struct timespec *timeout)
+{
+    return syscall(SYS_futex, word, op, value, timeout, NULL, 0);
+}
+
+ld2420_status_t ld2420_linux_shm_publisher_open(
+    ld2420_linux_shm_publisher_t *pub,
+    const char *name,
+    uint32_t capacity)
+{
+    return ld2420_linux_shm_publisher_open_replay(pub, name, capacity, 0, 0);
+}
+
+ld2420_status_t ld2420_linux_shm_publisher_open_replay(
+    ld2420_linux_shm_publisher_t *pub,
+    const char *name,
+    uint32_t capacity,
+    uint32_t replay_ports,
+    uint32_t max_age_ms)
+{
+    if (pub == NULL || name == NULL || name[0] != '/' || capacity < LD2420_LINUX_SHM_MIN_CAPACITY ||
+        (capacity & (capacity - 1u)) != 0 || replay_ports > UINT16_MAX + 1u || max_age_ms > (uint32_t)INT32_MAX)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    // Replace any stale ring: consumers of the old one keep their mapping
+    shm_unlink(name);
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0)
+        return LD2420_STATUS_ERROR_UNKNOWN;
+
+    const size_t map_size =
+        sizeof(ld2420_linux_shm_header_t) + capacity + (size_t)replay_ports * sizeof(ld2420_replay_sensor_t);
+    void *map = MAP_FAILED;
+    if (ftruncate(fd, (off_t)map_size) == 0)
+        map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int saved = errno;
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        shm_unlink(name);
+        errno = saved;
+        return LD2420_STATUS_ERROR_UNKNOWN;
+    }
+
+    // The object is zero-filled; publish the magic last so that consumers
+    // never see a half-initialized header
+    pub->ring = (ld2420_linux_shm_header_t *)map;
+    pub->data = (uint8_t *)map + sizeof(ld2420_linux_shm_header_t);
+    pub->map_size = map_size;
+    pub->mask = capacity - 1u;
+    pub->next_sequence = 0;
+    pub->wakeups = 0;
+    memset(&pub->replay, 0, sizeof(pub->replay));
+    if (replay_ports > 0)
+    {
+        ld2420_replay_init(&pub->replay, (ld2420_replay_sensor_t *)(pub->data + capacity), replay_ports, max_age_ms);
+        pub->ring->replay_ports = replay_ports;
+        pub->ring->replay_depth = LD2420_REPLAY_DEPTH;
+        pub->ring->replay_sensor_size = sizeof(ld2420_replay_sensor_t);
+        pub->ring->replay_max_age_ms = max_age_ms;
+    }
+    pub->ring->version = LD2420_LINUX_SHM_VERSION;
+    pub->ring->capacity = capacity;
+    __atomic_store_n(&pub->ring->magic, LD2420_LINUX_SHM_MAGIC, __ATOMIC_RELEASE);
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_linux_shm_publish(
+    ld2420_linux_shm_publisher_t *pub,
+    uint16_t port_index,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    if (pub == NULL || pub->ring == NULL || (frame == NULL && frame_size_bytes > 0) ||
+        frame_size_bytes > LD2420_LINUX_SHM_MAX_FRAME)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    ld2420_linux_shm_header_t *ring = pub->ring;
+    const uint32_t capacity = pub->mask + 1u;
+    const uint32_t size = record_size(frame_size_bytes);
+    uint64_t head = ring->head; // Only this producer writes it
+    uint32_t off = (uint32_t)head & pub->mask;
+
+    // A record never wraps: pad the rest of the ring and start over at 0
+    if (capacity - off < size)
+    {
+        const uint32_t rest = capacity - off;
+        __atomic_store_n(&ring->reserve, head + rest, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        if (rest >= LD2420_LINUX_SHM_RECORD_HEADER_SIZE)
+        {
+            uint8_t *pad = &pub->data[off];
+            const uint16_t port = SHM_PAD_PORT;
+            memcpy(pad, &pub->next_sequence, 8);
+            memcpy(pad + 8, &port, 2);
+        }
+        head += rest;
+        off = 0;
+    }
+
+    // Claim the bytes before touching them; see ld2420_linux_shm_consume()
+    __atomic_store_n(&ring->reserve, head + size, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    uint8_t *rec = &pub->data[off];
+    memcpy(rec, &pub->next_sequence, 8);
+    memcpy(rec + 8, &port_index, 2);
+    memcpy(rec + 10, &frame_size_bytes, 2);
+    memcpy(rec + 12, &cmd_echo, 2);
+    memcpy(rec + 14, &status, 2);
+    if (frame_size_bytes > 0)
+        memcpy(rec + LD2420_LINUX_SHM_RECORD_HEADER_SIZE, frame, frame_size_bytes);
+
+    // History before head: a consumer opened after the head moves finds the
+    // frame in the replay if it does not read it live
+    if (pub->replay.sensors != NULL)
+        (void)ld2420_replay_add(&pub->replay, port_index, pub->next_sequence, now_ms(), frame, frame_size_bytes,
+                                cmd_echo, status);
+    pub->next_sequence++;
+
+    // Sequentially consistent with the exchange below, which pairs with the
+    // store-then-check in ld2420_linux_shm_wait(). Clearing the flag means a
+    // burst of records costs one wake-up, however many consumers sleep
+    const uint32_t lock = ring->head_lock;
+    __atomic_store_n(&ring->head_lock, lock + 1u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&ring->head_sequence, pub->next_sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->head, head + size, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&ring->head_lock, lock + 2u, __ATOMIC_RELEASE);
+    if (__atomic_load_n(&ring->waiters, __ATOMIC_RELAXED) != 0 &&
+        __atomic_exchange_n(&ring->waiters, 0u, __ATOMIC_SEQ_CST) != 0)
+    {
+        __atomic_add_fetch(&ring->futex, 1u, __ATOMIC_SEQ_CST);
+        futex(&ring->futex, FUTEX_WAKE, INT_MAX, NULL);
+        pub->wakeups++;
+    }
+    return LD2420_STATUS_OK;
+}
+
+void ld2420_linux_shm_publish_callback(
+    void *user,
+    uint16_t port_index,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    (void)ld2420_linux_shm_publish((ld2420_linux_shm_publisher_t *)user, port_index, frame, frame_size_bytes,
+                                   cmd_echo, status);
+}
+
+void ld2420_linux_shm_publisher_close(ld2420_linux_shm_publisher_t *pub, const char *unlink_name)
+{
+    if (pub == NULL)
+        return;
+    if (pub->ring != NULL)
+        munmap(pub->ring, pub->map_size);
+    pub->ring = NULL;
+    pub->data = NULL;
+    pub->replay.sensors = NULL;
+    if (unlink_name != NULL)
+        shm_unlink(unlink_name);
+}
+
+ld2420_status_t ld2420_linux_shm_consumer_open(ld2420_linux_shm_consumer_t *c, const char *name)
+{
+    if (c == NULL || name == NULL)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    int fd = shm_open(name, O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0)
+        return LD2420_STATUS_ERROR_UNKNOWN;
+
+    struct stat st;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(ld2420_linux_shm_header_t))
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int saved = errno;
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        errno = saved;
+        return LD2420_STATUS_ERROR_UNKNOWN;
+    }
+
+    ld2420_linux_shm_header_t *ring = (ld2420_linux_shm_header_t *)map;
+    const uint32_t capacity = ring->capacity;
+    const uint32_t replay_ports = ring->replay_ports;
+    if (__atomic_load_n(&ring->magic, __ATOMIC_ACQUIRE) != LD2420_LINUX_SHM_MAGIC ||
+        ring->version != LD2420_LINUX_SHM_VERSION || capacity < LD2420_LINUX_SHM_MIN_CAPACITY ||
+        (capacity & (capacity - 1u)) != 0 ||
+        (size_t)st.st_size < sizeof(*ring) + capacity + (size_t)replay_ports * sizeof(ld2420_replay_sensor_t) ||
+        (replay_ports > 0 && (ring->replay_depth != LD2420_REPLAY_DEPTH ||
+                              ring->replay_sensor_size != sizeof(ld2420_replay_sensor_t))))
+    {
+        munmap(map, (size_t)st.st_size);
+        return LD2420_STATUS_ERROR_INVALID_HEADER;
+    }
+
+    c->ring = ring;
+    c->data = (const uint8_t *)map + sizeof(*ring);
+    c->map_size = (size_t)st.st_size;
+    c->mask = capacity - 1u;
+    memset(&c->replay, 0, sizeof(c->replay));
+    if (replay_ports > 0)
+        ld2420_replay_attach(&c->replay, (ld2420_replay_sensor_t *)((uint8_t *)map + sizeof(*ring) + capacity),
+                             replay_ports, ring->replay_max_age_ms);
+    c->replayed = 0;
+    c->replay_torn = 0;
+
+    // Head and the sequence number that goes with it, consistently
+    uint32_t lock;
+    do
+    {
+        lock = __atomic_load_n(&ring->head_lock, __ATOMIC_ACQUIRE);
+        c->cursor = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        c->start_sequence = __atomic_load_n(&ring->head_sequence, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((lock & 1u) != 0 || __atomic_load_n(&ring->head_lock, __ATOMIC_RELAXED) != lock);
+    c->next_sequence = 0;
+    c->have_sequence = false;
+    c->records = 0;
+    c->lost_records = 0;
+    c->overruns = 0;
+    c->torn = 0;
+    return LD2420_STATUS_OK;
+}
+
+/** True while the producer has not claimed the bytes at cursor for a newer record. */
+static inline bool still_intact(const ld2420_linux_shm_consumer_t *c, uint64_t cursor)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&c->ring->reserve, __ATOMIC_RELAXED) - cursor <= (uint64_t)c->mask + 1u;
+}
+
+/**
+ * Give up on the records between the cursor and the head. The sequence number
+ * of the next record read tells how many were lost.
+ */
+static void overrun(ld2420_linux_shm_consumer_t *c, uint64_t head)
+{
+    c->overruns++;
+    c->cursor = head;
+}
+
+int ld2420_linux_shm_consume(
+    ld2420_linux_shm_consumer_t *c,
+    ld2420_linux_rx_callback_t callback,
+    void *user,
+    uint32_t max_records)
+{
+    if (c == NULL || c->ring == NULL || callback == NULL)
+        return -1;
+
+    const uint32_t capacity = c->mask + 1u;
+    uint64_t head = __atomic_load_n(&c->ring->head, __ATOMIC_ACQUIRE);
+    int delivered = 0;
+    while (c->cursor != head && (uint32_t)delivered < max_records)
+    {
+        if (head - c->cursor > capacity)
+        {
+            overrun(c, head);
+            break;
+        }
+
+        // Too little room for a header before the end: both sides skip it
+        const uint32_t off = (uint32_t)c->cursor & c->mask;
+        if (capacity - off < LD2420_LINUX_SHM_RECORD_HEADER_SIZE)
+        {
+            c->cursor += capacity - off;
+            continue;
+        }
+
+        const uint8_t *rec = &c->data[off];
+        uint8_t header[LD2420_LINUX_SHM_RECORD_HEADER_SIZE];
+        memcpy(header, rec, sizeof(header));
+        uint64_t sequence;
+        memcpy(&sequence, header, 8);
+        const uint16_t port = read_u16(header + 8);
+        const uint16_t size = read_u16(header + 10);
+        if (!still_intact(c, c->cursor) || (port != SHM_PAD_PORT && size > LD2420_LINUX_SHM_MAX_FRAME))
+        {
+            head = __atomic_load_n(&c->ring->head, __ATOMIC_ACQUIRE);
+            overrun(c, head);
+            continue;
+        }
+        if (port == SHM_PAD_PORT)
+        {
+            c->cursor += capacity - off;
+            continue;
+        }
+
+        if (c->have_sequence && sequence != c->next_sequence)
+            c->lost_records += sequence - c->next_sequence;
+        c->next_sequence = sequence + 1u;
+        c->have_sequence = true;
+
+        callback(user, port, rec + LD2420_LINUX_SHM_RECORD_HEADER_SIZE, size, read_u16(header + 12),
+                 read_u16(header + 14));
+        if (!still_intact(c, c->cursor))
+            c->torn++;
+        c->cursor += record_size(size);
+        c->records++;
+        delivered++;
+    }
+    return delivered;
+}
+
+/** Adapts replay frames to the consumer's record callback. */
+typedef struct
+{
+    ld2420_linux_rx_callback_t callback;
+    void *user;
+} replay_target_t;
+
+static bool deliver_replayed(void *user, uint32_t sensor, const ld2420_replay_entry_t *entry)
+{
+    const replay_target_t *target = (const replay_target_t *)user;
+    target->callback(target->user, (uint16_t)sensor, entry->frame, entry->frame_size_bytes, entry->cmd_echo,
+                     entry->status);
+    return true;
+}
+
+int ld2420_linux_shm_replay(ld2420_linux_shm_consumer_t *c, ld2420_linux_rx_callback_t callback, void *user)
+{
+    if (c == NULL || c->ring == NULL || callback == NULL)
+        return -1;
+    if (c->replay.sensors == NULL)
+        return 0;
+
+    replay_target_t target = {callback, user};
+    const uint32_t now = now_ms();
+    uint32_t delivered = 0;
+    for (uint32_t port = 0; port < c->replay.sensor_count; port++)
+        delivered += ld2420_replay_read(&c->replay, port, now, c->start_sequence, deliver_replayed, &target,
+                                        &c->replay_torn);
+    c->replayed += delivered;
+    return (int)delivered;
+}
+
+int ld2420_linux_shm_wait(ld2420_linux_shm_consumer_t *c, int timeout_ms)
+{
+    if (c == NULL || c->ring == NULL)
+        return -1;
+
+    ld2420_linux_shm_header_t *ring = c->ring;
+    if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) != c->cursor)
+        return 1;
+
+    struct timespec timeout = {timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000L};
+    const uint32_t word = __atomic_load_n(&ring->futex, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&ring->waiters, 1u, __ATOMIC_SEQ_CST);
+    int result = 1;
+    if (__atomic_load_n(&ring->head, __ATOMIC_SEQ_CST) == c->cursor)
+    {
+        // Woken, interrupted or the word moved on: report what the ring says
+        if (futex(&ring->futex, FUTEX_WAIT, word, timeout_ms < 0 ? NULL : &timeout) != 0 && errno == ETIMEDOUT)
+            result = 0;
+        else
+            result = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) != c->cursor;
+    }
+    return result;
+}
+
+void ld2420_linux_shm_consumer_close(ld2420_linux_shm_consumer_t *c)
+{
+    if (c == NULL || c->ring == NULL)
+        return;
+    munmap(c->ring, c->map_size);
+    c->ring = NULL;
+    c->data = NULL;
+}
@@ -0,0 +1,250 @@
+/*
+ * LD2420 Linux telemetry publisher
+ * --------------------------------
+ * Packs decoded frames into binary telemetry messages, one per datagram, and
+ * sends the datagrams in batches with sendmmsg().
+ *
+ * Design Principles
+ * -----------------
+ * 1. Messages are encoded in place in the datagram slots; sending them costs
+ *    no copy in user space
+ * 2. One sendmmsg() per flush, whatever the number of sensors and frames
+ * 3. A socket that does not keep up costs events, never the ingest loop: the
+ *    batch is bounded and sends never block
+ *
+ * Memory & Threading
+ * ------------------
+ * - Datagram slots and per-sensor delta state are embedded in the context;
+ *   no dynamic allocation
+ * - Not thread-safe; use one publisher per ingest thread
+ */
+
+#define _GNU_SOURCE
+
+#include <ld2420/platform/linux/ld2420_linux_telemetry.h>
+
+#include <errno.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+static uint32_t monotonic_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u);
+}
+
+ld2420_status_t ld2420_linux_telemetry_init(ld2420_linux_telemetry_t *pub, int fd)
+{
+    if (pub == NULL || fd < 0)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    memset(pub, 0, sizeof(*pub));
+    pub->fd = fd;
+    return ld2420_telemetry_encoder_init(&pub->encoder, pub->sensors, LD2420_LINUX_MAX_PORTS);
+}
+
+ld2420_status_t ld2420_linux_telemetry_connect_udp(const char *host, uint16_t port, int *out_fd)
+{
+    if (host == NULL || out_fd == NULL)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    const struct addrinfo hints = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_DGRAM};
+    struct addrinfo *res = NULL;
+    if (getaddrinfo(host, service, &hints, &res) != 0)
+        return LD2420_STATUS_ERROR_UNKNOWN;
+
+    int fd = -1;
+    for (const struct addrinfo *ai = res; ai != NULL && fd < 0; ai = ai->ai_next)
+    {
+        fd = socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    if (fd < 0)
+        return LD2420_STATUS_ERROR_UNKNOWN;
+    *out_fd = fd;
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_linux_telemetry_connect_unix(const char *path, int *out_fd)
+{
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (path == NULL || out_fd == NULL || strlen(path) >= sizeof(addr.sun_path))
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return LD2420_STATUS_ERROR_UNKNOWN;
+    if (connect(fd, (const struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return LD2420_STATUS_ERROR_UNKNOWN;
+    }
+    *out_fd = fd;
+    return LD2420_STATUS_OK;
+}
+
+uint16_t ld2420_linux_telemetry_pending(const ld2420_linux_telemetry_t *pub)
+{
+    return pub != NULL ? (uint16_t)(pub->count - pub->first) : 0;
+}
+
+/** Finish the open message, if it holds any event. */
+static void finish_message(ld2420_linux_telemetry_t *pub)
+{
+    if (!pub->open)
+        return;
+    const size_t size = ld2420_telemetry_end(&pub->encoder);
+    pub->open = false;
+    if (size > 0)
+        pub->sizes[pub->count++] = (uint16_t)size;
+}
+
+/** Send finished datagrams; false on an error other than EAGAIN. */
+static bool send_pending(ld2420_linux_telemetry_t *pub)
+{
+    struct mmsghdr msgs[LD2420_LINUX_TELEMETRY_BATCH];
+    struct iovec iov[LD2420_LINUX_TELEMETRY_BATCH];
+    while (pub->first < pub->count)
+    {
+        const unsigned n = pub->count - pub->first;
+        for (unsigned i = 0; i < n; i++)
+        {
+            iov[i].iov_base = pub->datagrams[pub->first + i];
+            iov[i].iov_len = pub->sizes[pub->first + i];
+            memset(&msgs[i], 0, sizeof(msgs[i]));
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        const int sent = sendmmsg(pub->fd, msgs, n, MSG_DONTWAIT | MSG_NOSIGNAL);
+        pub->send_calls++;
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return true;
+            pub->last_errno = errno;
+            return false;
+        }
+        for (int i = 0; i < sent; i++)
+            pub->bytes_sent += pub->sizes[pub->first + i];
+        pub->datagrams_sent += (uint64_t)sent;
+        pub->first = (uint16_t)(pub->first + sent);
+        if (sent == 0)
+            return true;
+    }
+    pub->first = 0;
+    pub->count = 0;
+    return true;
+}
+
+/** Make room for one more datagram; false if the socket did not take any. */
+static bool make_room(ld2420_linux_telemetry_t *pub)
+{
+    if (pub->count < LD2420_LINUX_TELEMETRY_BATCH)
+        return true;
+    send_pending(pub);
+    if (pub->count < LD2420_LINUX_TELEMETRY_BATCH)
+        return true;
+    if (pub->first == 0)
+        return false;
+
+    // Some went out: move the rest to the front
+    const uint16_t left = (uint16_t)(pub->count - pub->first);
+    memmove(pub->datagrams[0], pub->datagrams[pub->first], (size_t)left * LD2420_LINUX_TELEMETRY_DATAGRAM_SIZE);
+    memmove(pub->sizes, &pub->sizes[pub->first], (size_t)left * sizeof(pub->sizes[0]));
+    pub->first = 0;
+    pub->count = left;
+    return true;
+}
+
+ld2420_status_t ld2420_linux_telemetry_publish(ld2420_linux_telemetry_t *pub, const ld2420_telemetry_event_t *event)
+{
+    if (pub == NULL || event == NULL)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        if (!pub->open)
+        {
+            if (!make_room(pub))
+            {
+                pub->dropped_events++;
+                return LD2420_STATUS_ERROR_BUFFER_TOO_SMALL;
+            }
+            ld2420_telemetry_begin(&pub->encoder, pub->datagrams[pub->count], LD2420_LINUX_TELEMETRY_DATAGRAM_SIZE,
+                                   event->timestamp_ms);
+            pub->open = true;
+        }
+
+        const ld2420_status_t status = ld2420_telemetry_append(&pub->encoder, event);
+        if (status == LD2420_STATUS_OK)
+        {
+            pub->events++;
+            return LD2420_STATUS_OK;
+        }
+        if (status != LD2420_STATUS_ERROR_BUFFER_TOO_SMALL)
+            return status;
+        // The datagram is full: finish it and retry in a fresh one
+        finish_message(pub);
+    }
+    return LD2420_STATUS_ERROR_BUFFER_TOO_SMALL;
+}
+
+ld2420_status_t ld2420_linux_telemetry_publish_frame(
+    ld2420_linux_telemetry_t *pub,
+    uint16_t port_index,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint32_t timestamp_ms)
+{
+    ld2420_telemetry_event_t event;
+    const ld2420_status_t status =
+        ld2420_telemetry_event_from_frame(frame, frame_size_bytes, port_index, timestamp_ms, &event);
+    if (status != LD2420_STATUS_OK)
+        return status;
+    return ld2420_linux_telemetry_publish(pub, &event);
+}
+
+void ld2420_linux_telemetry_frame_callback(
+    void *user,
+    uint16_t port_index,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    (void)cmd_echo;
+    (void)status;
+    (void)ld2420_linux_telemetry_publish_frame((ld2420_linux_telemetry_t *)user, port_index, frame, frame_size_bytes,
+                                               monotonic_ms());
+}
+
+int ld2420_linux_telemetry_flush(ld2420_linux_telemetry_t *pub)
+{
+    if (pub == NULL)
+        return -1;
+    finish_message(pub);
+    const uint64_t before = pub->datagrams_sent;
+    if (!send_pending(pub))
+    {
+        errno = pub->last_errno;
+        return -1;
+    }
+    return (int)(pub->datagrams_sent - before);
+}
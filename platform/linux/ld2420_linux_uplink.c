@@ -0,0 +1,176 @@
+/*
+ * LD2420 Linux uplink decoder
+ * ---------------------------
+ * Host side of the binary uplink: unwraps records from a gateway link and
+ * feeds each sensor's bytes through its own streaming parser context.
+ * The stream parser only knows command ACKs, so report frames are taken
+ * apart from them: a FRAME record holding a report is checked with the
+ * report codec and delivered as is, and BYTES records also go through a
+ * per-sensor ld2420_framer_t, of whose output only reports are delivered.
+ *
+ * Memory & Threading
+ * ------------------
+ * - The sensor table is embedded in ld2420_linux_uplink_t; no dynamic allocation
+ * - One read() per ld2420_linux_uplink_read() call into a stack buffer
+ * - Not thread-safe; use one uplink context per thread
+ */
+
+#include <ld2420/platform/linux/ld2420_linux_uplink.h>
+#include <ld2420/ld2420_protocol.h>
+
+#include <errno.h>
+#include <unistd.h>
+
+/**
+ * Neither the record nor the stream parser callback carries the context being
+ * fed for the frame callback, so it is published here for the duration of the
+ * feed, as in ld2420_linux.c.
+ */
+static __thread ld2420_linux_uplink_t *feeding_uplink;
+static __thread uint8_t feeding_sensor;
+static __thread int feeding_frames;
+
+static bool on_stream_frame(
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    ld2420_linux_uplink_t *uplink = feeding_uplink;
+    uplink->sensors[feeding_sensor].frames++;
+    feeding_frames++;
+    uplink->rx_callback(uplink->user, feeding_sensor, frame, frame_size_bytes, cmd_echo, status);
+    return true;
+}
+
+/** Deliver a report frame; report frames carry no command echo or status. */
+static void deliver_report(ld2420_linux_uplink_t *uplink, uint8_t sensor_id, const uint8_t *frame, uint16_t size)
+{
+    ld2420_linux_uplink_sensor_t *sensor = &uplink->sensors[sensor_id];
+    ld2420_report_energy_t report;
+    if (ld2420_report_energy_decode(frame, size, &report) != LD2420_STATUS_OK)
+    {
+        sensor->errors++;
+        return;
+    }
+    sensor->frames++;
+    feeding_frames++;
+    uplink->rx_callback(uplink->user, sensor_id, frame, size, 0, 0);
+}
+
+/** Reports in unaligned sensor bytes; ACKs are left to the stream parser. */
+static void frame_reports(ld2420_linux_uplink_t *uplink, uint8_t sensor_id, const uint8_t *data, uint16_t len)
+{
+    ld2420_framer_t *framer = &uplink->sensors[sensor_id].framer;
+    for (uint16_t i = 0; i < len; i++)
+    {
+        uint16_t size;
+        const uint8_t *frame = ld2420_framer_push(framer, data[i], &size);
+        if (frame != NULL && ld2420_protocol_read_le32(frame) == LD2420_PROTOCOL_REPORT_HEADER)
+            deliver_report(uplink, sensor_id, frame, size);
+    }
+}
+
+static bool on_uplink_record(void *user, const ld2420_uplink_record_t *record)
+{
+    ld2420_linux_uplink_t *uplink = (ld2420_linux_uplink_t *)user;
+    ld2420_linux_uplink_sensor_t *sensor = &uplink->sensors[record->sensor_id];
+
+    switch (record->kind)
+    {
+    case LD2420_UPLINK_KIND_FRAME:
+    case LD2420_UPLINK_KIND_BYTES:
+        uplink->timestamp_us = record->timestamp_us;
+        feeding_sensor = record->sensor_id;
+        if (record->kind == LD2420_UPLINK_KIND_FRAME && record->payload_size >= 4 &&
+            ld2420_protocol_read_le32(record->payload) == LD2420_PROTOCOL_REPORT_HEADER)
+        {
+            deliver_report(uplink, record->sensor_id, record->payload, record->payload_size);
+            break;
+        }
+        if (record->kind == LD2420_UPLINK_KIND_BYTES)
+            frame_reports(uplink, record->sensor_id, record->payload, record->payload_size);
+        if (ld2420_stream_feed_bytes(&sensor->stream, record->payload, record->payload_size, on_stream_frame, NULL) !=
+            LD2420_STATUS_OK)
+            sensor->errors++;
+        break;
+    case LD2420_UPLINK_KIND_OVERFLOW:
+        if (record->payload_size >= 4)
+            sensor->overflow_bytes += (uint32_t)record->payload[0] | ((uint32_t)record->payload[1] << 8) |
+                                      ((uint32_t)record->payload[2] << 16) | ((uint32_t)record->payload[3] << 24);
+        break;
+    case LD2420_UPLINK_KIND_PRESENCE:
+        if (record->payload_size >= 3)
+        {
+            uplink->timestamp_us = record->timestamp_us;
+            sensor->summaries++;
+            sensor->presence = record->payload[0];
+            sensor->distance_cm = (uint16_t)(record->payload[1] | (record->payload[2] << 8));
+            if (uplink->summary_callback != NULL)
+                uplink->summary_callback(uplink->user, record->sensor_id, sensor->presence, sensor->distance_cm);
+        }
+        break;
+    default:
+        // Unknown kinds come from newer gateways; skip them
+        break;
+    }
+    return true;
+}
+
+ld2420_status_t ld2420_linux_uplink_init(
+    ld2420_linux_uplink_t *uplink,
+    ld2420_linux_rx_callback_t rx_callback,
+    void *user)
+{
+    if (uplink == NULL || rx_callback == NULL)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    ld2420_uplink_decoder_init(&uplink->decoder);
+    uplink->rx_callback = rx_callback;
+    uplink->summary_callback = NULL;
+    uplink->user = user;
+    uplink->timestamp_us = 0;
+    for (uint16_t i = 0; i < LD2420_LINUX_UPLINK_MAX_SENSORS; i++)
+    {
+        ld2420_stream_init(&uplink->sensors[i].stream);
+        ld2420_framer_init(&uplink->sensors[i].framer);
+        uplink->sensors[i].frames = 0;
+        uplink->sensors[i].errors = 0;
+        uplink->sensors[i].overflow_bytes = 0;
+        uplink->sensors[i].summaries = 0;
+        uplink->sensors[i].distance_cm = 0;
+        uplink->sensors[i].presence = 0;
+    }
+    return LD2420_STATUS_OK;
+}
+
+int ld2420_linux_uplink_feed(ld2420_linux_uplink_t *uplink, const uint8_t *data, size_t len)
+{
+    if (uplink == NULL || (data == NULL && len > 0))
+        return -1;
+
+    feeding_uplink = uplink;
+    feeding_frames = 0;
+
+    // Corrupt records are counted by the decoder; the link keeps going
+    (void)ld2420_uplink_decode(&uplink->decoder, data, len, on_uplink_record, uplink, NULL);
+
+    feeding_uplink = NULL;
+    return feeding_frames;
+}
+
+int ld2420_linux_uplink_read(ld2420_linux_uplink_t *uplink, int fd)
+{
+    if (uplink == NULL || fd < 0)
+        return -1;
+
+    uint8_t chunk[LD2420_LINUX_UPLINK_READ_CHUNK];
+    ssize_t n = read(fd, chunk, sizeof(chunk));
+    if (n > 0)
+        return ld2420_linux_uplink_feed(uplink, chunk, (size_t)n);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR))
+        return 0;
+    if (n == 0)
+        errno = 0;
+    return -1;
+}
@@ -3,6 +3,8 @@
 #include <hardware/uart.h>
 #include <stdlib.h>
 #include "ld2420/ld2420.h"
+#include "ld2420/ld2420_framer.h"
+#include "ld2420/ld2420_cmdstats.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -12,10 +14,12 @@ extern "C"
      * @brief Callback type for received LD2420 frames.
      *
      * @param uart_index UART instance (0 or 1)
-     * @param packet Pointer to a complete LD2420 frame buffer (starts with SOF 0xF4)
-     * @param packet_len Total frame length in bytes (includes SOF and length field)
+     * @param packet Pointer to a complete LD2420 frame buffer: a command ACK
+     *               (starts with FD FC FB FA) or an energy report (F4 F3 F2 F1)
+     * @param packet_len Total frame length in bytes (header through footer)
      *
-     * @note Packets are always complete, frame-aligned LD2420 protocol messages.
+     * @note Packets are always complete, frame-aligned LD2420 protocol messages
+     *       whose footer has been checked; decode them with ld2420_protocol.h.
      *       The callback is invoked once per complete frame, not per byte.
      */
     typedef void (*ld2420_rx_callback_t)(
@@ -23,6 +27,26 @@ extern "C"
         const uint8_t *packet,
         uint16_t packet_len);
 
+    /**
+     * @brief Callback type for frames completed in the RX interrupt.
+     *
+     * Runs in interrupt context, on the byte that completed the frame. It
+     * must return within a few microseconds: no blocking, no printf, no
+     * ld2420_pico_send_safe(). Typical work is decoding the presence byte
+     * and setting a GPIO or a flag.
+     *
+     * @param uart_index UART instance (0 or 1)
+     * @param packet Complete frame, footer checked; valid during the call only
+     * @param packet_len Total frame length in bytes
+     *
+     * @return true to also deliver the frame through ld2420_pico_process(),
+     *         false if it was handled completely
+     */
+    typedef bool (*ld2420_pico_isr_callback_t)(
+        uint8_t uart_index,
+        const uint8_t *packet,
+        uint16_t packet_len);
+
     /**
      * @brief Initialize UART for LD2420 sensor communication.
      *
@@ -33,7 +57,9 @@ extern "C"
      * @param uart_instance Pointer to uart_inst_t (uart0 or uart1)
      * @param tx_pin TX pin number (must match uart_instance)
      * @param rx_pin RX pin number (must match uart_instance)
-     * @param rx_callback Function to invoke when a complete frame is received
+     * @param rx_callback Function to invoke when a complete frame is received;
+     *                    NULL for a UART that only sends commands (frames are
+     *                    still assembled so its ACKs reach the command statistics)
      *
      * @return LD2420_STATUS_OK on success, error code otherwise
      */
@@ -43,16 +69,81 @@ extern "C"
         const uint8_t rx_pin,
         const ld2420_rx_callback_t rx_callback);
 
+    /**
+     * @brief Assemble frames in the RX interrupt instead of the main loop.
+     *
+     * Opt-in low-latency mode for a UART set up with ld2420_pico_init(). The
+     * RX interrupt feeds every byte to framer (constant work per byte, see
+     * ld2420_framer.h) instead of the ring buffer, and calls isr_callback on
+     * the byte that completes a frame. Frames the callback keeps wait in the
+     * framer's slots for ld2420_pico_process(); when those are taken the
+     * frame is counted in framer->dropped_frames.
+     *
+     * One interrupt drains at most the 32-byte RX FIFO, which completes at
+     * most three frames, so its worst case is 32 framer steps plus three
+     * callbacks.
+     *
+     * @param uart_instance Pointer to uart_inst_t, already initialized
+     * @param framer Framer state owned by the caller for as long as the mode
+     *               is on (LD2420_FRAMER_SLOTS frames of RAM)
+     * @param isr_callback Optional; NULL keeps every frame for ld2420_pico_process()
+     *
+     * @return LD2420_STATUS_OK on success, LD2420_STATUS_ERROR_INVALID_ARGUMENTS
+     *         for an unknown or uninitialized UART or a NULL framer
+     */
+    const ld2420_status_t ld2420_pico_enable_isr_framing(
+        uart_inst_t *uart_instance,
+        ld2420_framer_t *framer,
+        const ld2420_pico_isr_callback_t isr_callback);
+
+    /**
+     * @brief Keep per-command round-trip statistics for a UART.
+     *
+     * ld2420_pico_send_safe() then stamps every command it writes, and
+     * ld2420_pico_process() matches every ACK it frames by its command echo,
+     * with or without an RX callback, and gives up commands unanswered for
+     * longer than the statistics' timeout (see ld2420_cmdstats.h). Round
+     * trips are measured from the end of uart_write_blocking() to the
+     * processing of the ACK, so they include the time the ACK waited for
+     * ld2420_pico_process().
+     *
+     * Both run under a mutex of their own, so commands may be sent from the
+     * other core. Read the statistics with ld2420_pico_cmdstats_snapshot().
+     *
+     * @param uart_instance Pointer to uart_inst_t, already initialized
+     * @param stats Statistics initialized with ld2420_cmdstats_init() and
+     *              owned by the caller while enabled; NULL turns them off
+     *
+     * @return LD2420_STATUS_OK on success, LD2420_STATUS_ERROR_INVALID_ARGUMENTS
+     *         for an unknown or uninitialized UART
+     */
+    const ld2420_status_t ld2420_pico_enable_cmdstats(
+        uart_inst_t *uart_instance,
+        ld2420_cmdstats_t *stats);
+
+    /**
+     * @brief Copy the command statistics of a UART consistently.
+     *
+     * @param uart_index UART instance (0 or 1)
+     * @param out Receives the statistics
+     *
+     * @return LD2420_STATUS_OK on success, LD2420_STATUS_ERROR_INVALID_ARGUMENTS
+     *         for an invalid index, a NULL out or statistics not enabled
+     */
+    const ld2420_status_t ld2420_pico_cmdstats_snapshot(uint8_t uart_index, ld2420_cmdstats_t *out);
+
     /**
      * @brief Process pending incoming data and deliver complete frames.
      *
      * Drains bytes from the RX ring buffer, assembles complete LD2420 frames,
      * and invokes the registered callback for each complete frame received.
-     * Call this function periodically from your main loop.
+     * Call this function periodically from your main loop. With ISR framing
+     * enabled, it delivers the frames the RX interrupt kept instead.
      *
      * @param uart_index UART instance (0 or 1)
      *
-     * @return Number of complete frames delivered (≥0), or -1 on error
+     * @return Number of complete frames delivered (≥0), or -1 for an invalid
+     *         index or a UART not set up with ld2420_pico_init()
      */
     const int16_t ld2420_pico_process(uint8_t uart_index);
 
@@ -80,6 +171,27 @@ extern "C"
      */
     const ld2420_status_t ld2420_pico_send_safe(uart_inst_t *uart_instance, const uint8_t *data, const uint16_t length);
 
+    /**
+     * @brief Number of bytes dropped by the RX ring buffer since init.
+     *
+     * The counter is written by the RX interrupt and wraps at 16 bits; compare
+     * successive readings to get the bytes lost in between.
+     *
+     * @param uart_index UART instance (0 or 1)
+     * @return Dropped byte count, or 0 for an invalid index
+     */
+    uint16_t ld2420_pico_rx_overflow(uint8_t uart_index);
+
+    /**
+     * @brief Fill level of the RX ring buffer.
+     *
+     * A snapshot; the RX interrupt may add bytes right after it was taken.
+     *
+     * @param uart_index UART instance (0 or 1)
+     * @return Bytes waiting, in per mille of the ring capacity, or 0 for an invalid index
+     */
+    uint16_t ld2420_pico_rx_fill_permille(uint8_t uart_index);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include "ld2420/ld2420.h"
+#include "ld2420/ld2420_uplink.h"
+#include "ld2420/ld2420_shed.h"
+
+/**
+ * Main loop iteration time that counts as full CPU pressure for overload
+ * shedding. A 512-byte RX ring fills in about 44 ms at 115200 baud; the default
+ * leaves room for both UARTs and the USB write.
+ */
+#ifndef LD2420_PICO_UPLINK_LOOP_BUDGET_US
+#define LD2420_PICO_UPLINK_LOOP_BUDGET_US 10000u
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    /**
+     * @brief Initialize the binary uplink to the host over USB CDC.
+     *
+     * Frames from every attached UART are wrapped in uplink records (see
+     * ld2420/ld2420_uplink.h) and collected in one batch buffer, which is written
+     * to the USB CDC link by ld2420_pico_uplink_flush(). Requires stdio over USB
+     * (pico_enable_stdio_usb); nothing else should print to stdout while the uplink
+     * is in use, since text would interleave with the records.
+     *
+     * @return LD2420_STATUS_OK on success, error code otherwise
+     */
+    const ld2420_status_t ld2420_pico_uplink_init(void);
+
+    /**
+     * @brief Frame callback that forwards frames over the uplink.
+     *
+     * Matches ld2420_rx_callback_t and can be passed to ld2420_pico_init() for any
+     * UART. Each frame becomes one LD2420_UPLINK_KIND_FRAME record with the UART
+     * index as sensor id and time_us_32() as timestamp.
+     *
+     * Under overload, report frames are shed in tiers (see ld2420/ld2420_shed.h):
+     * first they travel as LD2420_UPLINK_KIND_PRESENCE records without gate
+     * energies, then unchanged ones are dropped except for a keepalive. Command
+     * ACKs and presence changes are always forwarded as FRAME records.
+     */
+    void ld2420_pico_uplink_rx_callback(
+        uint8_t uart_index,
+        const uint8_t *packet,
+        uint16_t packet_len);
+
+    /**
+     * @brief Report ring buffer overflows and write the batch to the host.
+     *
+     * Call once per main loop iteration, after ld2420_pico_process() for every
+     * UART. Bytes dropped by a UART ring buffer since the previous call are
+     * reported as an LD2420_UPLINK_KIND_OVERFLOW record for that UART; in the
+     * THROTTLE shedding tier at most once per second.
+     *
+     * Also samples the load for overload shedding: the time since the previous
+     * call against LD2420_PICO_UPLINK_LOOP_BUDGET_US, the RX ring fill levels and
+     * the batch left unwritten.
+     *
+     * @return LD2420_STATUS_OK when the batch was written completely,
+     *         LD2420_STATUS_ERROR_BUFFER_TOO_SMALL when the host is not keeping up
+     */
+    const ld2420_status_t ld2420_pico_uplink_flush(void);
+
+    /**
+     * @brief Number of records dropped because the USB link did not keep up.
+     */
+    uint32_t ld2420_pico_uplink_dropped_records(void);
+
+    /**
+     * @brief Overload shedding state: the current tier (shed->tier), the smoothed
+     *        pressure and how many report frames were summarized or dropped.
+     */
+    const ld2420_shed_t *ld2420_pico_uplink_shed(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,8 +1,10 @@
 #include <ld2420/platform/pico/ld2420_pico.h>
+#include <ld2420/ld2420_protocol.h>
 #include <hardware/uart.h>
 #include <hardware/gpio.h>
 #include <hardware/irq.h>
 #include <pico/mutex.h>
+#include <pico/time.h>
 #include <stdio.h>
 
 /**
@@ -40,22 +42,6 @@ static inline int8_t decide_uart_instance_number(const uart_inst_t *uart_instanc
 // and ensure that we have enough space to handle incoming data without overflow.
 #define LD2420_UART_RINGBUF_SIZE 512u
 
-// Maximum frame size for LD2420 sensor (header + data + checksum).
-// Typical frames are 9–27 bytes, but we allow up to 256 for safety.
-#define LD2420_MAX_FRAME_SIZE 256u
-
-// LD2420 protocol frame start-of-frame marker
-#define LD2420_SOF 0xF4u
-
-/**
- * @brief Frame assembly state machine states.
- */
-typedef enum
-{
-    LD2420_FRAME_STATE_AWAITING_SOF = 0, // Waiting for start-of-frame marker
-    LD2420_FRAME_STATE_ACCUMULATING = 1  // Accumulating frame bytes after SOF
-} ld2420_frame_state_t;
-
 /**
  * @brief Structure to hold UART RX ring buffer information.
  */
@@ -67,21 +53,6 @@ typedef struct
     volatile uint16_t overflow;
 } ld2420_uart_rx_t;
 
-/**
- * @brief Frame assembly state for incoming LD2420 protocol data.
- *
- * Accumulates bytes from the ring buffer into complete frames before
- * delivering them to the user callback. Frames are identified by the
- * LD2420 SOF marker (0xF4) and contain a length field at byte [1].
- */
-typedef struct
-{
-    uint8_t buf[LD2420_MAX_FRAME_SIZE];
-    uint16_t len;               // Current frame byte count
-    ld2420_frame_state_t state; // Current assembly state
-    uint16_t expected_len;      // Total frame length (including SOF + length byte)
-} ld2420_frame_assembler_t;
-
 /**
  * @brief RX ring buffers for UART0 and UART1
  *
@@ -117,12 +88,14 @@ static ld2420_uart_rx_t uart_rx_buffers[2];
 /**
  * @brief Frame assemblers for UART0 and UART1
  *
- * One assembler per UART instance (index 0 for uart0, index 1 for uart1).
- * Accumulates bytes from the ring buffer into complete LD2420 frames before
- * delivering them to the user callback. This ensures the callback receives
- * complete, frame-aligned packets rather than individual bytes.
+ * One framer per UART instance (index 0 for uart0, index 1 for uart1), the
+ * same `ld2420_framer_t` that ISR framing uses, so both RX paths apply one set
+ * of header, length and footer rules to both frame families. Fed from the
+ * ring buffer by `ld2420_pico_process()`, which hands each frame to the user
+ * callback straight from the slot it was assembled in; frames are never
+ * published.
  */
-static ld2420_frame_assembler_t frame_assemblers[2];
+static ld2420_framer_t frame_assemblers[2];
 
 /**
  * @brief Callback function pointers for UART receive operations
@@ -149,6 +122,42 @@ static ld2420_frame_assembler_t frame_assemblers[2];
 // rx callback functions for uart0 and uart1
 static ld2420_rx_callback_t rx_callbacks[2] = {NULL, NULL};
 
+/** UARTs set up by `ld2420_pico_init()`; their RX callback may be NULL. */
+static bool uart_ready[2] = {false, false};
+
+/**
+ * @brief Framers and callbacks of UARTs in ISR framing mode
+ *
+ * NULL framer: the UART uses the ring buffer. Set by
+ * `ld2420_pico_enable_isr_framing()` while the UART interrupt is disabled, so
+ * the ISR sees either mode completely. The framer is then fed only by the
+ * ISR and drained only by `ld2420_pico_process()`.
+ */
+static ld2420_framer_t *isr_framers[2] = {NULL, NULL};
+static ld2420_pico_isr_callback_t isr_callbacks[2] = {NULL, NULL};
+
+/**
+ * @brief Command statistics of each UART, NULL when not kept
+ *
+ * Caller-owned (see `ld2420_pico_enable_cmdstats()`). Updated by
+ * `ld2420_pico_send_safe()`, possibly on the other core, and by
+ * `ld2420_pico_process()`, so every access holds `ld2420_cmdstats_mutex`.
+ */
+static ld2420_cmdstats_t *cmd_stats[2] = {NULL, NULL};
+auto_init_mutex(ld2420_cmdstats_mutex);
+
+/**
+ * @brief Match a received frame against the waiting commands; reports are ignored.
+ *
+ * Runs for every frame, delivered to a callback or not.
+ */
+static inline void __cmdstats_ack__(uint8_t idx, const uint8_t *frame, uint16_t len)
+{
+    mutex_enter_blocking(&ld2420_cmdstats_mutex);
+    ld2420_cmdstats_frame(cmd_stats[idx], frame, len, time_us_32());
+    mutex_exit(&ld2420_cmdstats_mutex);
+}
+
 static inline void __init_uart_rx_buffer__(uint8_t idx)
 {
     uart_rx_buffers[idx].head = 0;
@@ -156,13 +165,36 @@ static inline void __init_uart_rx_buffer__(uint8_t idx)
     uart_rx_buffers[idx].overflow = 0;
 
     // Also reset the frame assembler
-    frame_assemblers[idx].len = 0;
-    frame_assemblers[idx].state = LD2420_FRAME_STATE_AWAITING_SOF;
-    frame_assemblers[idx].expected_len = 0;
+    ld2420_framer_init(&frame_assemblers[idx]);
+}
+
+/**
+ * @brief ISR framing: feed the RX FIFO to the framer and act on completed frames.
+ *
+ * Constant work per byte; the FIFO holds at most 32 bytes, so at most three
+ * frames complete per call.
+ */
+static inline void __isr_frame_bytes__(uint8_t idx, uart_inst_t *uart)
+{
+    ld2420_framer_t *fr = isr_framers[idx];
+    const ld2420_pico_isr_callback_t cb = isr_callbacks[idx];
+    while (uart_is_readable(uart))
+    {
+        uint16_t size;
+        const uint8_t *frame = ld2420_framer_push(fr, (uint8_t)uart_getc(uart), &size);
+        if (frame != NULL && (cb == NULL || cb(idx, frame, size)))
+            ld2420_framer_publish(fr);
+    }
 }
 
 static __noinline void uart0_rx_irq_handler(void)
 {
+    if (isr_framers[0] != NULL)
+    {
+        __isr_frame_bytes__(0, uart0);
+        return;
+    }
+
     ld2420_uart_rx_t *rb = &uart_rx_buffers[0];
     while (uart_is_readable(uart0))
     {
@@ -192,6 +224,12 @@ static __noinline void uart0_rx_irq_handler(void)
  */
 static __noinline void uart1_rx_irq_handler(void)
 {
+    if (isr_framers[1] != NULL)
+    {
+        __isr_frame_bytes__(1, uart1);
+        return;
+    }
+
     ld2420_uart_rx_t *rb = &uart_rx_buffers[1];
     while (uart_is_readable(uart1))
     {
@@ -217,20 +255,20 @@ extern "C"
 {
 #endif
     /**
-     * @brief Attempt to assemble a complete LD2420 frame from available bytes.
+     * @brief Frame the bytes in the ring buffer and deliver complete frames.
      *
-     * Implements a simple state machine:
-     *  1. LD2420_FRAME_STATE_AWAITING_SOF: Scan ring buffer for 0xF4 byte
-     *  2. LD2420_FRAME_STATE_ACCUMULATING: Once SOF found, byte[1] is frame length.
-     *     Continue reading until frame is complete, then deliver to callback.
+     * Every byte goes through the UART's framer (see ld2420_framer.h), which
+     * searches both frame headers, rejects implausible lengths and checks the
+     * footer of the family. A completed frame is matched against the waiting
+     * commands and handed to the callback before the next byte is framed.
      *
      * @param uart_index UART instance (0 or 1)
-     * @return Number of complete frames delivered, or -1 on error
+     * @return Number of complete frames delivered
      */
     static int16_t __assemble_and_deliver_frames(uint8_t uart_index)
     {
         ld2420_uart_rx_t *rb = &uart_rx_buffers[uart_index];
-        ld2420_frame_assembler_t *fa = &frame_assemblers[uart_index];
+        ld2420_framer_t *fr = &frame_assemblers[uart_index];
         int16_t frame_count = 0;
 
         while (rb->tail != rb->head)
@@ -239,59 +277,46 @@ extern "C"
             rb->tail = (rb->tail + 1) % LD2420_UART_RINGBUF_SIZE;
             __asm volatile("" ::: "memory");
 
-            if (fa->state == LD2420_FRAME_STATE_AWAITING_SOF)
+            uint16_t size;
+            const uint8_t *frame = ld2420_framer_push(fr, byte, &size);
+            if (frame == NULL)
+                continue;
+
+            // ACKs count even while no callback is registered
+            __cmdstats_ack__(uart_index, frame, size);
+            if (rx_callbacks[uart_index] != NULL)
             {
-                // Waiting for SOF marker
-                if (byte == LD2420_SOF)
-                {
-                    fa->buf[0] = byte;
-                    fa->len = 1;
-                    fa->state = LD2420_FRAME_STATE_ACCUMULATING;
-                    fa->expected_len = 0; // Will be set once we read byte[1]
-                }
-                // else: skip this byte, continue scanning
+                rx_callbacks[uart_index](uart_index, frame, size);
+                frame_count++;
             }
-            else if (fa->state == LD2420_FRAME_STATE_ACCUMULATING)
+        }
+
+        return frame_count;
+    }
+
+    /**
+     * @brief Deliver the frames the RX interrupt kept in ISR framing mode.
+     *
+     * @param uart_index UART instance (0 or 1)
+     * @return Number of frames delivered
+     */
+    static int16_t __deliver_isr_frames(uint8_t uart_index)
+    {
+        ld2420_framer_t *fr = isr_framers[uart_index];
+        int16_t frame_count = 0;
+        const uint8_t *frame;
+        uint16_t size;
+
+        while ((frame = ld2420_framer_peek(fr, &size)) != NULL)
+        {
+            __cmdstats_ack__(uart_index, frame, size);
+            if (rx_callbacks[uart_index] != NULL)
             {
-                // Accumulating frame bytes
-                if (fa->len < LD2420_MAX_FRAME_SIZE)
-                {
-                    fa->buf[fa->len] = byte;
-                    fa->len++;
-
-                    // Byte[1] is the frame length field
-                    if (fa->len == 2)
-                    {
-                        fa->expected_len = byte + 2; // +2 for SOF and length byte itself
-                    }
-
-                    // Check if frame is complete
-                    if (fa->len >= 2 && fa->len == fa->expected_len)
-                    {
-                        // Frame complete: deliver to callback
-                        if (rx_callbacks[uart_index] != NULL)
-                        {
-                            rx_callbacks[uart_index](uart_index, fa->buf, fa->len);
-                            frame_count++;
-                        }
-
-                        // Reset for next frame
-                        fa->len = 0;
-                        fa->state = LD2420_FRAME_STATE_AWAITING_SOF;
-                        fa->expected_len = 0;
-                    }
-                }
-                else
-                {
-                    // Frame buffer overflow: discard and resync
-                    printf("WARN: Frame buffer overflow on UART%d, resyncing\n", uart_index);
-                    fa->len = 0;
-                    fa->state = LD2420_FRAME_STATE_AWAITING_SOF;
-                    fa->expected_len = 0;
-                }
+                rx_callbacks[uart_index](uart_index, frame, size);
+                frame_count++;
             }
+            ld2420_framer_release(fr);
         }
-
         return frame_count;
     }
 
@@ -299,29 +324,63 @@ extern "C"
     {
         if (uart_index > 1)
         {
+#ifdef LD2420_PICO_DEBUG
             printf("ERROR: Invalid UART index %d\n", uart_index);
+#endif
             return -1;
         }
 
-        if (rx_callbacks[uart_index] == NULL)
+        if (!uart_ready[uart_index])
         {
-            printf("ERROR: No callback registered for UART %d\n", uart_index);
+#ifdef LD2420_PICO_DEBUG
+            printf("ERROR: UART %d is not initialized\n", uart_index);
+#endif
             return -1;
         }
 
-        ld2420_uart_rx_t *rb = &uart_rx_buffers[uart_index];
+        // Frames are assembled and ACKs matched without a callback as well; only
+        // delivery needs one. In ISR framing mode the interrupt has assembled the
+        // frames already
+        int16_t frame_count;
+        if (isr_framers[uart_index] != NULL)
+            frame_count = __deliver_isr_frames(uart_index);
+        else
+            frame_count = __assemble_and_deliver_frames(uart_index);
 
-        // Attempt to assemble and deliver complete frames
-        int16_t frame_count = __assemble_and_deliver_frames(uart_index);
+        // Commands the sensor never answered time out here, even without traffic
+        mutex_enter_blocking(&ld2420_cmdstats_mutex);
+        if (cmd_stats[uart_index] != NULL)
+            ld2420_cmdstats_advance(cmd_stats[uart_index], time_us_32());
+        mutex_exit(&ld2420_cmdstats_mutex);
 
+#ifdef LD2420_PICO_DEBUG
         if (frame_count > 0)
         {
             printf("DEBUG: Delivered %d frame(s) on UART%d\n", frame_count, uart_index);
         }
+#endif
 
         return frame_count;
     }
 
+    uint16_t ld2420_pico_rx_overflow(uint8_t uart_index)
+    {
+        if (uart_index > 1)
+            return 0;
+        return uart_rx_buffers[uart_index].overflow;
+    }
+
+    uint16_t ld2420_pico_rx_fill_permille(uint8_t uart_index)
+    {
+        if (uart_index > 1)
+            return 0;
+        const ld2420_uart_rx_t *rb = &uart_rx_buffers[uart_index];
+        const uint16_t head = rb->head, tail = rb->tail;
+        const uint16_t used = (uint16_t)((head + LD2420_UART_RINGBUF_SIZE - tail) % LD2420_UART_RINGBUF_SIZE);
+        // One slot stays free to tell a full ring from an empty one
+        return (uint16_t)(used * 1000u / (LD2420_UART_RINGBUF_SIZE - 1u));
+    }
+
     /**
      * A mutex to protect UART TX operations, ensuring thread-safe access
      * when multiple threads attempt to send data simultaneously.
@@ -344,6 +403,19 @@ extern "C"
         }
 
         uart_write_blocking(uart_instance, buffer, buffer_size);
+
+        // Stamp commands while still holding the TX mutex, so stamps follow the
+        // order in which the commands went out
+        const int8_t idx = decide_uart_instance_number(uart_instance);
+        if (idx >= 0 && buffer_size >= LD2420_PROTOCOL_COMMAND_MIN_SIZE &&
+            ld2420_protocol_read_le32(buffer) == LD2420_PROTOCOL_COMMAND_HEADER)
+        {
+            const uint16_t command = ld2420_protocol_read_le16(buffer + LD2420_COMMAND_ID_OFFSET);
+            mutex_enter_blocking(&ld2420_cmdstats_mutex);
+            if (cmd_stats[idx] != NULL)
+                ld2420_cmdstats_sent(cmd_stats[idx], command, time_us_32());
+            mutex_exit(&ld2420_cmdstats_mutex);
+        }
         mutex_exit(&ld2420_uart_tx_mutex);
         return LD2420_STATUS_OK;
     }
@@ -356,14 +428,18 @@ extern "C"
     {
         if (!validate_uart_pin_pair_instance(tx_pin, rx_pin, uart_instance))
         {
+#ifdef LD2420_PICO_DEBUG
             printf("ERROR: Invalid TX/RX pin pair (%d, %d) for the specified UART instance\n", tx_pin, rx_pin);
+#endif
             return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
         }
 
         int8_t idx = decide_uart_instance_number(uart_instance);
         if (idx < 0)
         {
+#ifdef LD2420_PICO_DEBUG
             printf("ERROR: Unable to decide UART instance number\n");
+#endif
             return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
         }
 
@@ -375,7 +451,11 @@ extern "C"
 
         // Initialize UART first with the baud rate
         uint baudrate = uart_init(uart_instance, LD2420_BAUD_RATE);
+#ifdef LD2420_PICO_DEBUG
         printf("DEBUG: UART initialized with baud rate %u\n", baudrate);
+#else
+        (void)baudrate;
+#endif
 
         // Flush UART: ensure it's idle and clear any stale data
         uart_tx_wait_blocking(uart_instance); // Wait for TX to complete
@@ -385,6 +465,12 @@ extern "C"
         // Now that hardware is clean, reset the ring buffer and set callback
         __init_uart_rx_buffer__(idx);
         rx_callbacks[idx] = rx_callback;
+        isr_framers[idx] = NULL;
+        isr_callbacks[idx] = NULL;
+        mutex_enter_blocking(&ld2420_cmdstats_mutex);
+        cmd_stats[idx] = NULL;
+        mutex_exit(&ld2420_cmdstats_mutex);
+        uart_ready[idx] = true;
 
         // We are enabling FIFO for the provided UART instance because it helps in buffering the
         // data and reduces CPU load. Additionally, it improves data integrity during communication.
@@ -414,7 +500,9 @@ extern "C"
             irq_set_enabled(UART1_IRQ, true);
             break;
         default:
+#ifdef LD2420_PICO_DEBUG
             printf("ERROR: Unknown UART instance number %d\n", idx);
+#endif
             return LD2420_STATUS_ERROR_INVALID_ARGUMENTS | LD2420_STATUS_ERROR_UNKNOWN;
         }
 
@@ -425,6 +513,56 @@ extern "C"
         return LD2420_STATUS_OK;
     }
 
+    const ld2420_status_t ld2420_pico_enable_isr_framing(
+        uart_inst_t *uart_instance,
+        ld2420_framer_t *framer,
+        const ld2420_pico_isr_callback_t isr_callback)
+    {
+        int8_t idx = decide_uart_instance_number(uart_instance);
+        if (idx < 0 || framer == NULL || !uart_ready[idx])
+            return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+        // Switch modes with the interrupt off; bytes left in the ring are dropped
+        const uint irq = idx == 0 ? UART0_IRQ : UART1_IRQ;
+        irq_set_enabled(irq, false);
+        ld2420_framer_init(framer);
+        __init_uart_rx_buffer__(idx);
+        isr_framers[idx] = framer;
+        isr_callbacks[idx] = isr_callback;
+        irq_set_enabled(irq, true);
+        return LD2420_STATUS_OK;
+    }
+
+    const ld2420_status_t ld2420_pico_enable_cmdstats(
+        uart_inst_t *uart_instance,
+        ld2420_cmdstats_t *stats)
+    {
+        int8_t idx = decide_uart_instance_number(uart_instance);
+        if (idx < 0 || !uart_ready[idx])
+            return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+        mutex_enter_blocking(&ld2420_cmdstats_mutex);
+        cmd_stats[idx] = stats;
+        mutex_exit(&ld2420_cmdstats_mutex);
+        return LD2420_STATUS_OK;
+    }
+
+    const ld2420_status_t ld2420_pico_cmdstats_snapshot(uint8_t uart_index, ld2420_cmdstats_t *out)
+    {
+        if (uart_index > 1 || out == NULL)
+            return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+        ld2420_status_t status = LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+        mutex_enter_blocking(&ld2420_cmdstats_mutex);
+        if (cmd_stats[uart_index] != NULL)
+        {
+            *out = *cmd_stats[uart_index];
+            status = LD2420_STATUS_OK;
+        }
+        mutex_exit(&ld2420_cmdstats_mutex);
+        return status;
+    }
+
     const ld2420_status_t ld2420_pico_deinit(uart_inst_t *uart_instance)
     {
         int8_t idx = decide_uart_instance_number(uart_instance);
@@ -439,7 +577,13 @@ extern "C"
         uart_deinit(uart_instance);
 
         __init_uart_rx_buffer__(idx);
+        uart_ready[idx] = false;
         rx_callbacks[idx] = NULL;
+        isr_framers[idx] = NULL;
+        isr_callbacks[idx] = NULL;
+        mutex_enter_blocking(&ld2420_cmdstats_mutex);
+        cmd_stats[idx] = NULL;
+        mutex_exit(&ld2420_cmdstats_mutex);
         return LD2420_STATUS_OK;
     }
 
@@ -0,0 +1,163 @@
+#include <ld2420/platform/pico/ld2420_pico.h>
+#include <ld2420/platform/pico/ld2420_pico_uplink.h>
+#include <ld2420/ld2420_shed.h>
+#include <pico/stdio_usb.h>
+#include <pico/time.h>
+#include <tusb.h>
+
+/**
+ * @brief Batch writer shared by all UARTs.
+ *
+ * Only touched from the main loop: the RX callbacks run from
+ * ld2420_pico_process(), not from the RX interrupts, so no locking is needed.
+ */
+static ld2420_uplink_writer_t uplink_writer;
+
+/**
+ * @brief Ring buffer overflow counts already reported, per UART.
+ */
+static uint16_t reported_overflow[2];
+
+/**
+ * @brief Overload shedding applied to frames before they enter the batch.
+ *
+ * Pressure is sampled once per flush: the larger of the main loop iteration
+ * time against LD2420_PICO_UPLINK_LOOP_BUDGET_US and the fill level of the
+ * fullest queue (either RX ring or the batch left after the write). Any byte
+ * or record lost since the previous flush counts as a full queue.
+ */
+static ld2420_shed_t shed;
+static ld2420_shed_sensor_t shed_sensors[2];
+static uint32_t last_flush_us;
+static uint32_t last_dropped_records;
+static uint16_t last_overflow[2];
+static uint32_t last_overflow_report_ms;
+
+/**
+ * @brief Write a batch to the USB CDC link.
+ *
+ * Goes through the stdio USB driver directly, which bypasses CR/LF translation
+ * and serializes with any other stdio use. The driver gives up silently on
+ * whatever the CDC FIFO cannot take in time, so only as much as the FIFO has
+ * room for is written and the rest stays in the batch. While no host has the
+ * port open, or reads too slowly, the batch fills and further records are
+ * counted as dropped instead of being lost unnoticed or blocking the main loop.
+ */
+static size_t usb_cdc_write(void *user, const uint8_t *data, size_t len)
+{
+    (void)user;
+    if (!stdio_usb_connected())
+        return 0;
+    const size_t room = (size_t)tud_cdc_write_available();
+    if (len > room)
+        len = room;
+    if (len > 0)
+        stdio_usb.out_chars((const char *)data, (int)len);
+    return len;
+}
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    const ld2420_status_t ld2420_pico_uplink_init(void)
+    {
+        reported_overflow[0] = ld2420_pico_rx_overflow(0);
+        reported_overflow[1] = ld2420_pico_rx_overflow(1);
+        last_overflow[0] = reported_overflow[0];
+        last_overflow[1] = reported_overflow[1];
+        ld2420_shed_sensor_init(&shed_sensors[0]);
+        ld2420_shed_sensor_init(&shed_sensors[1]);
+        last_flush_us = time_us_32();
+        last_dropped_records = 0;
+        last_overflow_report_ms = to_ms_since_boot(get_absolute_time());
+        const ld2420_status_t status = ld2420_shed_init(&shed, NULL, last_overflow_report_ms);
+        if (status != LD2420_STATUS_OK)
+            return status;
+        return ld2420_uplink_writer_init(&uplink_writer, usb_cdc_write, NULL);
+    }
+
+    void ld2420_pico_uplink_rx_callback(
+        uint8_t uart_index,
+        const uint8_t *packet,
+        uint16_t packet_len)
+    {
+        if (uart_index > 1)
+            return;
+
+        // Drops are counted by the writer and show up on the host as sequence gaps
+        switch (ld2420_shed_classify(&shed, &shed_sensors[uart_index], packet, packet_len,
+                                     to_ms_since_boot(get_absolute_time())))
+        {
+        case LD2420_SHED_FORWARD:
+            (void)ld2420_uplink_writer_append(&uplink_writer, uart_index, LD2420_UPLINK_KIND_FRAME,
+                                              time_us_32(), packet, packet_len);
+            break;
+        case LD2420_SHED_SUMMARY:
+            (void)ld2420_uplink_writer_append(&uplink_writer, uart_index, LD2420_UPLINK_KIND_PRESENCE,
+                                              time_us_32(), ld2420_shed_summary(packet), LD2420_SHED_SUMMARY_SIZE);
+            break;
+        case LD2420_SHED_DROP:
+            break;
+        }
+    }
+
+    const ld2420_status_t ld2420_pico_uplink_flush(void)
+    {
+        const uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+
+        // Overflow counts accumulate, so reporting them later loses nothing
+        const bool report_overflow = ld2420_shed_consumer_due(&shed, &last_overflow_report_ms, now_ms);
+        for (uint8_t idx = 0; idx < 2 && report_overflow; idx++)
+        {
+            const uint16_t overflow = ld2420_pico_rx_overflow(idx);
+            const uint16_t lost = (uint16_t)(overflow - reported_overflow[idx]);
+            if (lost == 0)
+                continue;
+
+            const uint8_t payload[4] = {(uint8_t)lost, (uint8_t)(lost >> 8), 0, 0};
+            if (ld2420_uplink_writer_append(&uplink_writer, idx, LD2420_UPLINK_KIND_OVERFLOW,
+                                            time_us_32(), payload, sizeof(payload)) == LD2420_STATUS_OK)
+                reported_overflow[idx] = overflow;
+        }
+        const ld2420_status_t status = ld2420_uplink_writer_flush(&uplink_writer);
+
+        // Pressure sample for the next iteration's frames
+        const uint32_t now_us = time_us_32();
+        const uint32_t loop_us = now_us - last_flush_us;
+        last_flush_us = now_us;
+        const uint16_t cpu_permille =
+            loop_us >= LD2420_PICO_UPLINK_LOOP_BUDGET_US ? 1000u : (uint16_t)(loop_us * 1000u / LD2420_PICO_UPLINK_LOOP_BUDGET_US);
+
+        uint16_t queue_permille = (uint16_t)(uplink_writer.used * 1000u / LD2420_UPLINK_BATCH_SIZE);
+        for (uint8_t idx = 0; idx < 2; idx++)
+        {
+            const uint16_t fill = ld2420_pico_rx_fill_permille(idx);
+            if (fill > queue_permille)
+                queue_permille = fill;
+            const uint16_t overflow = ld2420_pico_rx_overflow(idx);
+            if (overflow != last_overflow[idx])
+                queue_permille = 1000u;
+            last_overflow[idx] = overflow;
+        }
+        if (uplink_writer.dropped_records != last_dropped_records)
+            queue_permille = 1000u;
+        last_dropped_records = uplink_writer.dropped_records;
+
+        ld2420_shed_update(&shed, cpu_permille, queue_permille, now_ms);
+        return status;
+    }
+
+    uint32_t ld2420_pico_uplink_dropped_records(void)
+    {
+        return uplink_writer.dropped_records;
+    }
+
+    const ld2420_shed_t *ld2420_pico_uplink_shed(void)
+    {
+        return &shed;
+    }
+
+#ifdef __cplusplus
+}
+#endif
@@ -92,6 +92,16 @@ extern "C"
         LD2420_PARAM_MAINTAIN_BASE = (unsigned short)0x20, /** Maintain threshold base */
     } ld2420_command_parameter_t;
 
+#ifdef LD2420_WORK_COUNTERS
+    /**
+     * Running total of bytes examined by the parsers (header/footer compares,
+     * header scans and buffer moves). Only present when the core is built with
+     * LD2420_CORE_WORK_COUNTERS; used by fuzz harnesses to bound the work done
+     * per input byte. Not thread-safe.
+     */
+    extern uint64_t ld2420_work_bytes_examined;
+#endif
+
     /**
      * Parse a single complete LD2420 RX buffer (one-shot parsing).
      *
@@ -0,0 +1,118 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420.h"
+
+/** Gates (energy values) in a report frame. */
+#define LD2420_REPORT_GATES 16u
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * Batch parsing of frames that are already cut out.
+     *
+     * Motivation:
+     * - Offline tools (capture analysis, indexes over recordings) hold thousands of
+     *   complete frames and want their metadata as columns, not one call with seven
+     *   pointer arguments per frame.
+     * - Outputs are structure-of-arrays: entry i of every array belongs to frame i, so
+     *   consumers can scan one field over all frames with unit stride.
+     *
+     * Design highlights:
+     * - One pass over the frames. Header, length field and footer are compared as
+     *   whole words and folded into a single mismatch value, so a valid frame takes
+     *   one branch and no byte loops.
+     * - Rejected frames fall back to ld2420_parse_rx_buffer() to find out what is
+     *   wrong, so per-frame statuses are exactly those of the one-shot parser.
+     * - No allocation, no state; safe to call from several threads on disjoint outputs.
+     * - Report frames have a batch decoder of their own, ld2420_decode_report_batch(),
+     *   which turns gate energies into one column per gate.
+     */
+
+    /**
+     * Output columns of ld2420_parse_rx_batch(). Each non-NULL array must hold `count`
+     * entries. Fields of frames whose status is not LD2420_STATUS_OK are set to 0.
+     */
+    typedef struct
+    {
+        /** Per-frame result, as ld2420_parse_rx_buffer() returns it. Required. */
+        ld2420_status_t *status;
+        /** Intra-frame length field. Required. */
+        uint16_t *frame_size;
+        /** Command echo (low byte of the echo word). Required. */
+        uint16_t *cmd_echo;
+        /** Status field sent by the device. Required. */
+        uint16_t *device_status;
+        /** First and second little-endian word after the status field. Optional (NULL). */
+        uint16_t *param_name;
+        uint16_t *param_value;
+    } ld2420_rx_batch_t;
+
+    /**
+     * Parse `count` complete RX frames.
+     *
+     * Parameters:
+     * - frames: Pointer to each frame (starting at the header). A NULL entry yields
+     *   LD2420_STATUS_ERROR_INVALID_BUFFER for that frame.
+     * - frame_sizes: Size in bytes of each frame (header..footer).
+     * - count: Number of frames.
+     * - out: Output columns, see ld2420_rx_batch_t.
+     * - out_valid: Optional. Receives the number of frames parsed successfully.
+     *
+     * Return:
+     * - LD2420_STATUS_OK once every frame has a status (even if some are errors).
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS if count > 0 and an input or a required
+     *   output array is NULL. Nothing is written then.
+     */
+    ld2420_status_t ld2420_parse_rx_batch(
+        const uint8_t *const *frames,
+        const uint8_t *frame_sizes,
+        size_t count,
+        const ld2420_rx_batch_t *out,
+        size_t *out_valid);
+
+    /**
+     * Output columns of ld2420_decode_report_batch(). Each non-NULL array must hold
+     * `count` entries; every array is optional.
+     *
+     * energy[g] and energy_f32[g] are the columns of gate g: entry i is the energy of
+     * gate g in frame i. Raw values are the sensor's unsigned 16-bit fixed-point
+     * energies; float columns hold raw * energy_scale.
+     */
+    typedef struct
+    {
+        uint8_t *presence;
+        uint16_t *distance_cm;
+        uint16_t *energy[LD2420_REPORT_GATES];
+        float *energy_f32[LD2420_REPORT_GATES];
+        /** Factor applied to the float columns (1.0f keeps the raw scale). */
+        float energy_scale;
+    } ld2420_report_batch_t;
+
+    /**
+     * Decode `count` report frames into per-gate columns.
+     *
+     * The frames must already be validated (LD2420_REPORT_ENERGY_SIZE bytes with
+     * header, length and footer checked, e.g. by the Pico framer or
+     * ld2420_report_energy_decode()); they are not checked again. The gate energies
+     * of eight frames at a time are transposed in vector registers where the target
+     * supports it (SSE2), and converted to float in the same pass.
+     *
+     * Return:
+     * - LD2420_STATUS_OK on success.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS if count > 0 and frames, out or a
+     *   frame pointer is NULL. Nothing is written then.
+     */
+    ld2420_status_t ld2420_decode_report_batch(
+        const uint8_t *const *frames,
+        size_t count,
+        const ld2420_report_batch_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,147 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420.h"
+
+/** Commands a sensor's statistics wait for at once; an older one is given up when more are sent. */
+#define LD2420_CMDSTATS_MAX_PENDING 4u
+
+/**
+ * Round-trip histogram buckets. Bucket 0 counts round trips below 1024 us, bucket b
+ * those in [2^(b+9), 2^(b+10)) us, and the last one everything from about 16.8 s.
+ */
+#define LD2420_CMDSTATS_BUCKETS 16u
+
+/** Per-command slots: one for each LD2420_CMD_* and one for any other id. */
+#define LD2420_CMDSTATS_COMMANDS 7u
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * Round-trip time and outcome telemetry for the commands a host sends.
+     *
+     * Motivation:
+     * - ACK timeouts and the number of commands a host keeps in flight are guesses
+     *   unless someone measures how long the sensor really takes per command and how
+     *   often it does not answer. ld2420_correlator_t measures a tapped line offline;
+     *   this is the same measurement kept by the sender itself, per sensor, all the
+     *   time, small enough for a microcontroller.
+     *
+     * Design highlights:
+     * - The sender calls ld2420_cmdstats_sent() right after writing a command and
+     *   ld2420_cmdstats_ack() for every ACK frame it receives, both with its own
+     *   microsecond clock. ACKs are matched like ld2420_correlator_t does: the oldest
+     *   waiting command with the echoed id is answered and everything older is given
+     *   up, a retry gives up the attempt still waiting, and a command waiting longer
+     *   than timeout_us is given up by ld2420_cmdstats_advance() (or when the sender
+     *   says so, ld2420_cmdstats_expire()).
+     * - Per command: commands sent, answered, failed (non-zero ACK status), timed out
+     *   and superseded (given up for a retry or a later answered command), the largest
+     *   and summed round trip, and a log2 histogram of round trips.
+     *   ld2420_cmdstats_percentile_us() reads a percentile bound off the histogram,
+     *   e.g. the p99 round trip to size a timeout.
+     * - The high-water mark of waiting commands shows how deep the command pipeline
+     *   actually gets.
+     * - Fixed size (about 700 bytes per sensor), no allocation. Not thread-safe.
+     */
+
+    /** Statistics of one command. */
+    typedef struct
+    {
+        /** Commands sent. */
+        uint32_t sent;
+        /** Commands answered by an ACK, and of those the ones with a non-zero status. */
+        uint32_t answered;
+        uint32_t failed;
+        /** Commands given up after timeout_us without an ACK, or by ld2420_cmdstats_expire(). */
+        uint32_t timeouts;
+        /** Commands given up for a retry, a later answered command or a full queue. */
+        uint32_t superseded;
+        /** Round-trip times of answered commands in microseconds. */
+        uint32_t max_rtt_us;
+        uint64_t sum_rtt_us;
+        uint32_t histogram[LD2420_CMDSTATS_BUCKETS];
+    } ld2420_cmdstats_command_t;
+
+    /** Command statistics of one sensor. */
+    typedef struct
+    {
+        uint32_t timeout_us;
+        /** Waiting commands, oldest first. */
+        uint16_t pending_command[LD2420_CMDSTATS_MAX_PENDING];
+        uint32_t pending_time_us[LD2420_CMDSTATS_MAX_PENDING];
+        uint8_t pending_count;
+        /** Most commands that were waiting at once. */
+        uint8_t max_pending;
+        /** ACKs that matched no waiting command. */
+        uint32_t orphan_acks;
+        /** Indexed by ld2420_cmdstats_slot(). */
+        ld2420_cmdstats_command_t commands[LD2420_CMDSTATS_COMMANDS];
+    } ld2420_cmdstats_t;
+
+    /**
+     * Initialize the statistics of one sensor.
+     *
+     * Parameters:
+     * - s: Statistics.
+     * - timeout_us: How long a command may wait for its ACK (0 < timeout_us < 2^31).
+     *
+     * Return:
+     * - LD2420_STATUS_OK on success.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on NULL statistics or an out-of-range
+     *   timeout.
+     */
+    ld2420_status_t ld2420_cmdstats_init(ld2420_cmdstats_t *s, uint32_t timeout_us);
+
+    /** Slot of a command id in ld2420_cmdstats_t::commands; the last slot takes unknown ids. */
+    uint8_t ld2420_cmdstats_slot(uint16_t command);
+
+    /** A command was written to the sensor at now_us. */
+    void ld2420_cmdstats_sent(ld2420_cmdstats_t *s, uint16_t command, uint32_t now_us);
+
+    /** An ACK frame arrived at now_us; echo and status as in the frame. */
+    void ld2420_cmdstats_ack(ld2420_cmdstats_t *s, uint16_t echo, uint16_t status, uint32_t now_us);
+
+    /**
+     * A received frame of either family arrived at now_us. ACKs (command header, the
+     * ACK echo flag and a length the protocol allows for the echoed command) go to
+     * ld2420_cmdstats_ack(); reports and anything else are ignored. For receive
+     * paths that see every framed frame, whether or not anyone consumes them.
+     *
+     * Return: true if the frame was taken as an ACK.
+     */
+    bool ld2420_cmdstats_frame(ld2420_cmdstats_t *s, const uint8_t *frame, uint16_t size, uint32_t now_us);
+
+    /**
+     * Count commands that waited longer than the timeout at now_us as timed out.
+     * sent() and ack() do this too; call it when time passes without traffic.
+     */
+    void ld2420_cmdstats_advance(ld2420_cmdstats_t *s, uint32_t now_us);
+
+    /**
+     * Count every waiting command as timed out now. For a sender that keeps its own
+     * ACK deadline and gives up on its own schedule, so both agree on what timed out.
+     */
+    void ld2420_cmdstats_expire(ld2420_cmdstats_t *s);
+
+    /** Statistics of a command id; never NULL for non-NULL s. */
+    const ld2420_cmdstats_command_t *ld2420_cmdstats_get(const ld2420_cmdstats_t *s, uint16_t command);
+
+    /**
+     * Upper bound of the round trip within which permille / 1000 of the answered
+     * commands were answered, read off the histogram: the upper edge of the bucket
+     * the percentile falls in, or max_rtt_us for the last bucket or when that is
+     * smaller.
+     *
+     * Return: The bound in microseconds, 0 if nothing was answered.
+     */
+    uint32_t ld2420_cmdstats_percentile_us(const ld2420_cmdstats_command_t *c, uint16_t permille);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,123 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420.h"
+
+/**
+ * Frame slots of a framer: one being assembled, the others held by the
+ * consumer. A power of two, at least 2; each costs LD2420_MAX_RX_PACKET_SIZE bytes.
+ */
+#ifndef LD2420_FRAMER_SLOTS
+#define LD2420_FRAMER_SLOTS 2u
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * Frame assembly in interrupt context.
+     *
+     * Motivation:
+     * - A UART RX interrupt that only stores bytes in a ring leaves the framing to
+     *   the main loop, so a frame waits for the next loop iteration after its last
+     *   byte arrived. For a light that switches on presence, that wait is most of
+     *   the reaction time.
+     * - Framing in the interrupt is only acceptable if its cost per byte is fixed
+     *   and small, whatever the bytes are.
+     *
+     * Design highlights:
+     * - ld2420_framer_push() takes one byte and does a constant amount of work: a
+     *   header search with a sliding 32-bit window over both frame families
+     *   (command ACKs and energy reports), the length check when the length
+     *   field is complete, and the footer check on the last byte. No loops, no
+     *   copies.
+     * - Frames are assembled in place in one of LD2420_FRAMER_SLOTS slots. A
+     *   completed frame is returned to the interrupt, which can act on it right
+     *   there and then either hand the slot to the consumer with
+     *   ld2420_framer_publish() or let the next frame overwrite it.
+     * - The consumer (the main loop) takes published frames with
+     *   ld2420_framer_peek() and ld2420_framer_release(). The two sides share
+     *   only two counters, so one producer and one consumer need no lock. If the
+     *   consumer holds all other slots, publishing fails and the frame is counted
+     *   in dropped_frames; the interrupt is never held up.
+     * - No allocation; about LD2420_FRAMER_SLOTS * LD2420_MAX_RX_PACKET_SIZE bytes
+     *   of state, provided by the caller.
+     */
+
+    /** Framer state; the fields other than the counters are internal. */
+    typedef struct
+    {
+        uint8_t slots[LD2420_FRAMER_SLOTS][LD2420_MAX_RX_PACKET_SIZE];
+        uint16_t sizes[LD2420_FRAMER_SLOTS];
+        /** Last four bytes while searching for a header. */
+        uint32_t window;
+        /** Footer and largest size of the frame family being assembled. */
+        uint32_t footer;
+        uint16_t max_len;
+        /** Bytes of the frame being assembled, 0 while searching. */
+        uint16_t len;
+        /** Size of that frame once its length field is in, else 0. */
+        uint16_t expected_len;
+        /** A frame was just completed and may be published. */
+        bool complete;
+        /** Frames published and released; written by the producer and the consumer respectively. */
+        volatile uint32_t published;
+        volatile uint32_t released;
+        /** Frames completed, whether published or not. */
+        uint32_t frames;
+        /** Frames that could not be published because no slot was free. */
+        uint32_t dropped_frames;
+        /** Frames discarded for an implausible length or a wrong footer. */
+        uint32_t errors;
+    } ld2420_framer_t;
+
+    /**
+     * Initialize a framer with no frames and no partial frame.
+     *
+     * Return:
+     * - LD2420_STATUS_OK on success.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on a NULL framer.
+     */
+    ld2420_status_t ld2420_framer_init(ld2420_framer_t *framer);
+
+    /**
+     * Feed one received byte (producer side, e.g. the RX interrupt).
+     *
+     * Parameters:
+     * - framer: Initialized framer; not checked, as this runs for every byte.
+     * - byte: The byte.
+     * - out_size: Receives the frame size when a frame is returned.
+     *
+     * Return: the frame the byte completed, with its footer checked, or NULL. It
+     * stays valid until the next call; call ld2420_framer_publish() before that to
+     * keep it for the consumer.
+     */
+    const uint8_t *ld2420_framer_push(ld2420_framer_t *framer, uint8_t byte, uint16_t *out_size);
+
+    /**
+     * Hand the frame just returned by ld2420_framer_push() to the consumer
+     * (producer side).
+     *
+     * Return: true if it was queued; false if the consumer holds all other slots
+     * (the frame is counted in dropped_frames) or there is no frame to publish.
+     */
+    bool ld2420_framer_publish(ld2420_framer_t *framer);
+
+    /**
+     * Oldest published frame (consumer side).
+     *
+     * Return: the frame, valid until ld2420_framer_release(), or NULL if none is
+     * waiting.
+     */
+    const uint8_t *ld2420_framer_peek(const ld2420_framer_t *framer, uint16_t *out_size);
+
+    /** Return the slot of the frame from ld2420_framer_peek() to the producer (consumer side). */
+    void ld2420_framer_release(ld2420_framer_t *framer);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,207 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420.h"
+
+/** Marks an empty link or bucket in the liveness timing wheel. */
+#define LD2420_LIVENESS_NONE UINT32_MAX
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * Liveness monitor for many sensor streams.
+     *
+     * Motivation:
+     * - A gateway with thousands of sensors must notice a sensor that went quiet, one
+     *   whose link produces mostly garbage, and one that keeps dropping out, without
+     *   scanning every sensor on every tick.
+     *
+     * Design highlights:
+     * - Each sensor records its last frame time and expected frame interval. It is
+     *   silent once no frame arrived for config.silence_intervals intervals.
+     * - Deadlines live in a hashed timing wheel of caller-provided buckets. Recording a
+     *   frame only stores the time; a sensor is looked at when its bucket comes due and
+     *   is then moved to the bucket of its current deadline. A healthy sensor is
+     *   therefore visited about once per silence timeout, and ld2420_liveness_advance()
+     *   costs O(buckets passed + sensors visited), independent of the total count.
+     * - Degraded: resyncs and parse errors reported through ld2420_liveness_error() are
+     *   counted per window; too large an error share raises the condition at once, a
+     *   full window below the threshold clears it.
+     * - Flapping: config.flap_threshold silences, each within config.flap_window_ms of
+     *   the previous one. Cleared after a flap window without silence.
+     * - Every raise and clear is reported through one callback. Time is passed in by
+     *   the caller in milliseconds (any monotonic clock, wrapping at 2^32).
+     * - No allocation; the caller provides the sensor table and the buckets. Not
+     *   thread-safe; use one monitor per ingest thread.
+     */
+
+    /** Conditions a sensor can be in; several at once. */
+    typedef enum
+    {
+        LD2420_LIVENESS_SILENT = 0x01,   /** No frame for silence_intervals expected intervals */
+        LD2420_LIVENESS_DEGRADED = 0x02, /** Error share above degraded_permille in the current window */
+        LD2420_LIVENESS_FLAPPING = 0x04, /** Went silent flap_threshold times in quick succession */
+    } ld2420_liveness_condition_t;
+
+    /** Thresholds; ld2420_liveness_default_config() gives sensible values. */
+    typedef struct
+    {
+        /** Expected intervals without a frame before a sensor counts as silent. */
+        uint16_t silence_intervals;
+        /** Error share (errors / (frames + errors)) in per mille that marks a sensor degraded. */
+        uint16_t degraded_permille;
+        /** Errors a window needs at least before the share is looked at. */
+        uint16_t degraded_min_errors;
+        /** Silences in quick succession that mark a sensor flapping. */
+        uint8_t flap_threshold;
+        /** Length of the error counting window. */
+        uint32_t window_ms;
+        /** Largest gap between two silences that still counts as flapping. */
+        uint32_t flap_window_ms;
+    } ld2420_liveness_config_t;
+
+    /**
+     * Alert callback.
+     *
+     * Parameters:
+     * - user: Pointer given to ld2420_liveness_init().
+     * - sensor: Index of the sensor.
+     * - condition: The condition that changed.
+     * - raised: true when the sensor entered the condition, false when it left it.
+     * - now_ms: Time passed to the call that detected the change.
+     *
+     * Called from ld2420_liveness_frame(), _error() and _advance(). It must not call
+     * back into the monitor.
+     */
+    typedef void (*ld2420_liveness_alert_fn)(
+        void *user,
+        uint32_t sensor,
+        ld2420_liveness_condition_t condition,
+        bool raised,
+        uint32_t now_ms);
+
+    /** Per-sensor state. Opaque to callers except for `conditions`. */
+    typedef struct
+    {
+        /** Time of the last frame (or of ld2420_liveness_watch()). */
+        uint32_t last_frame_ms;
+        /** Expected frame interval; 0 while the sensor is not watched. */
+        uint32_t interval_ms;
+        /** Wheel links and bucket, LD2420_LIVENESS_NONE while not in the wheel. */
+        uint32_t next;
+        uint32_t prev;
+        uint32_t bucket;
+        /** Start of the current error counting window and its counts. */
+        uint32_t window_start_ms;
+        uint16_t window_frames;
+        uint16_t window_errors;
+        /** Time of the last silence and how many came in quick succession. */
+        uint32_t last_silence_ms;
+        uint8_t flap_count;
+        /** Bitwise OR of the ld2420_liveness_condition_t the sensor is in. */
+        uint8_t conditions;
+    } ld2420_liveness_sensor_t;
+
+    /** Monitor context. */
+    typedef struct
+    {
+        ld2420_liveness_sensor_t *sensors;
+        uint32_t sensor_count;
+        /** Head of each bucket's list; bucket_mask + 1 entries. */
+        uint32_t *buckets;
+        uint32_t bucket_mask;
+        /** Wheel resolution. */
+        uint32_t tick_ms;
+        /** Running number of the next bucket to process, and the time it is due. */
+        uint32_t tick;
+        uint32_t tick_due_ms;
+        ld2420_liveness_config_t config;
+        ld2420_liveness_alert_fn alert;
+        void *user;
+        /** Sensors looked at by ld2420_liveness_advance() so far. */
+        uint64_t visits;
+    } ld2420_liveness_t;
+
+    /**
+     * Fill config with defaults: silent after 5 intervals, degraded above 5 % errors
+     * with at least 5 errors per 10 s window, flapping after 3 silences less than
+     * 60 s apart.
+     */
+    void ld2420_liveness_default_config(ld2420_liveness_config_t *config);
+
+    /**
+     * Initialize a monitor.
+     *
+     * Parameters:
+     * - m: Monitor to initialize.
+     * - sensors, sensor_count: Sensor table; sensors are addressed by index.
+     * - buckets, bucket_count: Wheel buckets. bucket_count must be a power of two;
+     *   bucket_count * tick_ms should cover the longest silence timeout, otherwise
+     *   sensors with longer timeouts are visited once per wheel turn.
+     * - tick_ms: Wheel resolution, and so the latency of silence alerts (> 0).
+     * - config: Thresholds, or NULL for ld2420_liveness_default_config().
+     * - alert, user: Alert callback and its user pointer.
+     * - now_ms: Current time.
+     *
+     * Return:
+     * - LD2420_STATUS_OK on success.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on NULL pointers, zero sizes, a bucket
+     *   count that is not a power of two, or a zero silence_intervals or window_ms.
+     */
+    ld2420_status_t ld2420_liveness_init(
+        ld2420_liveness_t *m,
+        ld2420_liveness_sensor_t *sensors,
+        uint32_t sensor_count,
+        uint32_t *buckets,
+        uint32_t bucket_count,
+        uint32_t tick_ms,
+        const ld2420_liveness_config_t *config,
+        ld2420_liveness_alert_fn alert,
+        void *user,
+        uint32_t now_ms);
+
+    /**
+     * Start (or restart) watching a sensor that should send a frame every interval_ms.
+     * The first silence timeout counts from now_ms. Conditions and counters start from
+     * scratch, without alerts for conditions that are dropped. An interval of 0 stops
+     * watching the sensor.
+     *
+     * Return: LD2420_STATUS_OK, or LD2420_STATUS_ERROR_INVALID_ARGUMENTS for a NULL
+     * monitor, an out-of-range sensor, or an interval whose silence timeout does not
+     * fit in 2^31 ms.
+     */
+    ld2420_status_t ld2420_liveness_watch(ld2420_liveness_t *m, uint32_t sensor, uint32_t interval_ms, uint32_t now_ms);
+
+    /**
+     * Record a frame from a sensor. O(1); clears SILENT if it was set.
+     *
+     * Return: LD2420_STATUS_OK, or LD2420_STATUS_ERROR_INVALID_ARGUMENTS for a NULL
+     * monitor or an out-of-range sensor. Frames of unwatched sensors are ignored.
+     */
+    ld2420_status_t ld2420_liveness_frame(ld2420_liveness_t *m, uint32_t sensor, uint32_t now_ms);
+
+    /**
+     * Record a resync or parse error on a sensor's stream, e.g. each non-OK status of
+     * ld2420_stream_feed_bytes(). O(1); may raise DEGRADED.
+     *
+     * Return: as ld2420_liveness_frame().
+     */
+    ld2420_status_t ld2420_liveness_error(ld2420_liveness_t *m, uint32_t sensor, uint32_t now_ms);
+
+    /**
+     * Process the buckets that came due up to now_ms and raise SILENT (and FLAPPING)
+     * for sensors past their deadline. Call it regularly, e.g. once per poll; calling
+     * it more often than every tick_ms costs nothing.
+     *
+     * Return: LD2420_STATUS_OK, or LD2420_STATUS_ERROR_INVALID_ARGUMENTS for a NULL monitor.
+     */
+    ld2420_status_t ld2420_liveness_advance(ld2420_liveness_t *m, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
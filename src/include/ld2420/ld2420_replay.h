@@ -0,0 +1,167 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420.h"
+
+/**
+ * Frames kept per sensor. Memory is fixed: about LD2420_REPLAY_DEPTH * 176 bytes
+ * per sensor. Define it for the whole build to keep more or fewer.
+ */
+#ifndef LD2420_REPLAY_DEPTH
+#define LD2420_REPLAY_DEPTH 8u
+#endif
+
+/** Largest frame kept; larger ones are counted in ld2420_replay_t::rejected. */
+#define LD2420_REPLAY_MAX_FRAME LD2420_MAX_RX_PACKET_SIZE
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * Replay of the most recent frames per sensor for late subscribers.
+     *
+     * Motivation:
+     * - A subscriber that attaches to a gateway knows nothing until the next frames
+     *   arrive, which for a sensor that only sends ACKs can take minutes. Keeping the
+     *   last few frames per sensor lets the gateway prime it right away.
+     *
+     * Design highlights:
+     * - Per sensor, a ring of the last LD2420_REPLAY_DEPTH frames in caller-provided
+     *   memory, optionally limited to frames younger than max_age_ms when read. Adding
+     *   a frame is one copy and never allocates.
+     * - Every frame carries the caller's sequence number. A subscriber that starts
+     *   receiving live frames at sequence S asks for the frames before S, so that the
+     *   replay ends exactly where its live frames begin: no gap, no duplicate.
+     * - Reads are zero-copy: the callback gets a pointer into the ring. The sensor
+     *   array holds no pointers, so it can live in shared memory and be read by other
+     *   processes while one writer adds frames. Each entry is tagged with its frame
+     *   number, written last; a reader skips entries being rewritten and counts those
+     *   rewritten while its callback ran as torn, like the shared-memory frame ring.
+     */
+
+    /** One kept frame. */
+    typedef struct
+    {
+        /** Caller's sequence number, e.g. of the record that carried the frame. */
+        uint64_t sequence;
+        /** Caller's clock when the frame was added, in milliseconds. */
+        uint32_t time_ms;
+        uint16_t frame_size_bytes;
+        uint16_t cmd_echo;
+        uint16_t status;
+        uint8_t frame[LD2420_REPLAY_MAX_FRAME];
+    } ld2420_replay_entry_t;
+
+    /** Ring of one sensor. Position-independent; zero-filled memory is an empty ring. */
+    typedef struct
+    {
+        /** Frames added so far; frame k is in entries[k % LD2420_REPLAY_DEPTH]. */
+        volatile uint32_t written;
+        /** k + 1 for the frame in each entry, 0 while it is being written. */
+        volatile uint32_t tags[LD2420_REPLAY_DEPTH];
+        ld2420_replay_entry_t entries[LD2420_REPLAY_DEPTH];
+    } ld2420_replay_sensor_t;
+
+    /** Replay state. */
+    typedef struct
+    {
+        ld2420_replay_sensor_t *sensors;
+        uint32_t sensor_count;
+        /** Frames older than this are not replayed; 0 replays every kept frame. */
+        uint32_t max_age_ms;
+        /** Frames kept, and frames not kept: unknown sensor or larger than LD2420_REPLAY_MAX_FRAME. */
+        uint64_t frames;
+        uint64_t rejected;
+    } ld2420_replay_t;
+
+    /**
+     * Replay callback.
+     *
+     * Parameters:
+     * - user: Pointer given to ld2420_replay_read().
+     * - sensor: Sensor index.
+     * - entry: The kept frame, in place; valid during the call only.
+     *
+     * Return: true to continue, false to stop the read.
+     */
+    typedef bool (*ld2420_replay_on_frame_fn)(void *user, uint32_t sensor, const ld2420_replay_entry_t *entry);
+
+    /**
+     * Initialize a replay and empty the rings of all sensors.
+     *
+     * Parameters:
+     * - r: Replay state.
+     * - sensors, sensor_count: Caller-provided rings, one per sensor index.
+     * - max_age_ms: Oldest frame to replay, or 0 for no limit (< 2^31).
+     *
+     * Return:
+     * - LD2420_STATUS_OK on success.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on NULL pointers, no sensors or an
+     *   out-of-range max_age_ms.
+     */
+    ld2420_status_t ld2420_replay_init(
+        ld2420_replay_t *r,
+        ld2420_replay_sensor_t *sensors,
+        uint32_t sensor_count,
+        uint32_t max_age_ms);
+
+    /**
+     * Like ld2420_replay_init(), but keep the rings as they are: for a reader of rings
+     * that another process writes.
+     */
+    ld2420_status_t ld2420_replay_attach(
+        ld2420_replay_t *r,
+        ld2420_replay_sensor_t *sensors,
+        uint32_t sensor_count,
+        uint32_t max_age_ms);
+
+    /**
+     * Keep a frame, replacing the oldest one of its sensor if the ring is full.
+     * Only one writer at a time.
+     *
+     * Return:
+     * - LD2420_STATUS_OK when the frame was kept.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS for an unknown sensor, a frame larger
+     *   than LD2420_REPLAY_MAX_FRAME (both counted in rejected) or NULL pointers.
+     */
+    ld2420_status_t ld2420_replay_add(
+        ld2420_replay_t *r,
+        uint32_t sensor,
+        uint64_t sequence,
+        uint32_t now_ms,
+        const uint8_t *frame,
+        uint16_t frame_size_bytes,
+        uint16_t cmd_echo,
+        uint16_t status);
+
+    /**
+     * Deliver the kept frames of one sensor, oldest first.
+     *
+     * Parameters:
+     * - r: Replay state.
+     * - sensor: Sensor index.
+     * - now_ms: Current time on the clock given to ld2420_replay_add(), for max_age_ms.
+     * - before_sequence: Only frames with a smaller sequence number are delivered;
+     *   UINT64_MAX for all.
+     * - on_frame, user: Called for every frame.
+     * - out_torn: Optional. Incremented for every frame that was skipped because it
+     *   was being replaced, or that was replaced while its callback ran.
+     *
+     * Return: Number of frames delivered.
+     */
+    uint32_t ld2420_replay_read(
+        const ld2420_replay_t *r,
+        uint32_t sensor,
+        uint32_t now_ms,
+        uint64_t before_sequence,
+        ld2420_replay_on_frame_fn on_frame,
+        void *user,
+        uint64_t *out_torn);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,185 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420.h"
+
+/** Gates per report frame. */
+#define LD2420_ROLLUP_GATES 16u
+
+/**
+ * Buckets kept per sensor at each resolution: the last minute of 1 s buckets, the
+ * last hour of 1 min buckets and the last day of 1 h buckets. Override at compile
+ * time to keep more or less history; each bucket takes sizeof(ld2420_rollup_bucket_t).
+ */
+#ifndef LD2420_ROLLUP_SECOND_BUCKETS
+#define LD2420_ROLLUP_SECOND_BUCKETS 60u
+#endif
+#ifndef LD2420_ROLLUP_MINUTE_BUCKETS
+#define LD2420_ROLLUP_MINUTE_BUCKETS 60u
+#endif
+#ifndef LD2420_ROLLUP_HOUR_BUCKETS
+#define LD2420_ROLLUP_HOUR_BUCKETS 24u
+#endif
+
+/** Bucket index of a slot that holds no bucket. */
+#define LD2420_ROLLUP_NONE UINT32_MAX
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * Rolling per-gate aggregation of report frames.
+     *
+     * Motivation:
+     * - Dashboards show min/max/mean gate energy and presence duty cycle per sensor
+     *   over the last seconds, minutes and hours. Recomputing those from raw frames
+     *   on every refresh means keeping and scanning all of them.
+     *
+     * Design highlights:
+     * - Every sensor has one ring of buckets per resolution (1 s, 1 min, 1 h). Bucket
+     *   n of a resolution covers [n * resolution, (n + 1) * resolution) of the
+     *   caller's clock, so buckets line up with wall-clock seconds, minutes and hours
+     *   when the caller passes Unix time.
+     * - A frame only updates the sensor's open 1 s bucket. When a frame opens the next
+     *   second, the finished second is merged into its minute, and a finished minute
+     *   into its hour, so the per-frame cost is one bucket update whatever the number
+     *   of resolutions, and merges are amortized over 60 frames' worth of time.
+     * - ld2420_rollup_snapshot() returns any bucket still held in O(1): the stored
+     *   bucket plus, for the current minute and hour, the finer buckets not merged
+     *   into it yet. Nothing is scanned.
+     * - Presence duty cycle is the share of frames that report presence, which equals
+     *   the time share for a sensor reporting at a steady rate.
+     * - Frames must arrive in time order per sensor; a frame from before the open 1 s
+     *   bucket is counted in late_frames and ignored.
+     * - No allocation; the caller provides the sensor table. Not thread-safe.
+     */
+
+    /** Bucket resolutions. */
+    typedef enum
+    {
+        LD2420_ROLLUP_SECOND = 0, /** 1 s buckets */
+        LD2420_ROLLUP_MINUTE = 1, /** 1 min buckets */
+        LD2420_ROLLUP_HOUR = 2,   /** 1 h buckets */
+    } ld2420_rollup_resolution_t;
+
+#define LD2420_ROLLUP_RESOLUTIONS 3u
+
+    /** Aggregate of the frames of one sensor in one bucket. */
+    typedef struct
+    {
+        /** Bucket number (time_ms / resolution), LD2420_ROLLUP_NONE for an unused slot. */
+        uint32_t index;
+        uint32_t frames;
+        uint32_t presence_frames;
+        uint16_t min[LD2420_ROLLUP_GATES];
+        uint16_t max[LD2420_ROLLUP_GATES];
+        uint64_t sum[LD2420_ROLLUP_GATES];
+    } ld2420_rollup_bucket_t;
+
+    /** Per-sensor rings. Opaque to callers except for late_frames. */
+    typedef struct
+    {
+        ld2420_rollup_bucket_t seconds[LD2420_ROLLUP_SECOND_BUCKETS];
+        ld2420_rollup_bucket_t minutes[LD2420_ROLLUP_MINUTE_BUCKETS];
+        ld2420_rollup_bucket_t hours[LD2420_ROLLUP_HOUR_BUCKETS];
+        /** Newest bucket per resolution; it has not been merged into the next one yet. */
+        uint32_t open[LD2420_ROLLUP_RESOLUTIONS];
+        /** Frames dropped because they were older than the open 1 s bucket. */
+        uint32_t late_frames;
+    } ld2420_rollup_sensor_t;
+
+    /** Rollup engine context. */
+    typedef struct
+    {
+        ld2420_rollup_sensor_t *sensors;
+        uint32_t sensor_count;
+        /** Frames aggregated so far, over all sensors. */
+        uint64_t frames;
+    } ld2420_rollup_t;
+
+    /** Bucket statistics as returned by ld2420_rollup_snapshot(). */
+    typedef struct
+    {
+        /** Start of the bucket on the caller's clock. */
+        uint64_t start_ms;
+        /** Frames in the bucket; 0 if there were none or the bucket is no longer held. */
+        uint32_t frames;
+        /** Share of frames reporting presence, in per mille. */
+        uint16_t presence_permille;
+        uint16_t min[LD2420_ROLLUP_GATES];
+        uint16_t max[LD2420_ROLLUP_GATES];
+        /** Rounded mean per gate. */
+        uint16_t mean[LD2420_ROLLUP_GATES];
+    } ld2420_rollup_stats_t;
+
+    /**
+     * Initialize an engine over a sensor table; all buckets start empty.
+     *
+     * Return: LD2420_STATUS_OK, or LD2420_STATUS_ERROR_INVALID_ARGUMENTS on NULL
+     * pointers or a zero sensor count.
+     */
+    ld2420_status_t ld2420_rollup_init(ld2420_rollup_t *r, ld2420_rollup_sensor_t *sensors, uint32_t sensor_count);
+
+    /**
+     * Aggregate one reading.
+     *
+     * Parameters:
+     * - r: Engine.
+     * - sensor: Index of the sensor.
+     * - presence: Presence flag of the reading.
+     * - energy: LD2420_ROLLUP_GATES gate energies.
+     * - time_ms: Time of the reading on the caller's clock, e.g. Unix time in ms.
+     *
+     * Return:
+     * - LD2420_STATUS_OK, also for a late reading (counted in late_frames).
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS for NULL pointers or an out-of-range
+     *   sensor.
+     */
+    ld2420_status_t ld2420_rollup_add(
+        ld2420_rollup_t *r,
+        uint32_t sensor,
+        bool presence,
+        const uint16_t *energy,
+        uint64_t time_ms);
+
+    /**
+     * Aggregate a complete report frame (LD2420_PROTOCOL_REPORT_HEADER...FOOTER).
+     *
+     * Return: as ld2420_rollup_add(), or the decoder's status (e.g.
+     * LD2420_STATUS_ERROR_INVALID_FRAME) for a frame that is not a report frame.
+     */
+    ld2420_status_t ld2420_rollup_frame(
+        ld2420_rollup_t *r,
+        uint32_t sensor,
+        const uint8_t *frame,
+        uint16_t frame_size_bytes,
+        uint64_t time_ms);
+
+    /** Number of the bucket of a resolution that contains time_ms. */
+    uint32_t ld2420_rollup_index(ld2420_rollup_resolution_t resolution, uint64_t time_ms);
+
+    /**
+     * Statistics of one bucket of one sensor, in O(1).
+     *
+     * Parameters:
+     * - index: Bucket number, e.g. from ld2420_rollup_index(). Buckets older than the
+     *   ring length of the resolution are no longer held and come back empty.
+     * - out: Receives the statistics; out->frames is 0 for an empty bucket.
+     *
+     * Return: LD2420_STATUS_OK, or LD2420_STATUS_ERROR_INVALID_ARGUMENTS for NULL
+     * pointers, an out-of-range sensor or an unknown resolution.
+     */
+    ld2420_status_t ld2420_rollup_snapshot(
+        const ld2420_rollup_t *r,
+        uint32_t sensor,
+        ld2420_rollup_resolution_t resolution,
+        uint32_t index,
+        ld2420_rollup_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,183 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420.h"
+
+/** Size of a presence summary: the presence and distance fields of a report frame. */
+#define LD2420_SHED_SUMMARY_SIZE 3u
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * Overload shedding for a forwarding pipeline.
+     *
+     * Motivation:
+     * - When a gateway cannot keep up, bytes are lost wherever a buffer happens to be
+     *   full: a UART ring, a batch buffer, a socket. A presence change or a command
+     *   ACK is as likely to go as the hundredth identical report frame.
+     * - Most of the volume is detail: the 16 gate energies of every report frame, and
+     *   report frames that say the same as the previous one.
+     *
+     * Design highlights:
+     * - The caller measures pressure (e.g. CPU share and queue fill, in per mille) and
+     *   passes it to ld2420_shed_update(); the controller smooths it and picks a tier.
+     *   It steps up as soon as the smoothed pressure crosses a tier's threshold and
+     *   steps down one tier at a time, after config.hold_ms and config.exit_margin_permille
+     *   below the threshold, so it does not oscillate.
+     * - ld2420_shed_classify() decides per frame: forward it, forward only its presence
+     *   and distance (LD2420_SHED_SUMMARY_SIZE bytes instead of 45), or drop it.
+     * - Never shed: command ACKs and anything that is not a report frame, and report
+     *   frames whose presence differs from the sensor's previous one.
+     * - Non-critical consumers (statistics, diagnostics) ask ld2420_shed_consumer_due()
+     *   before running; in the highest tier they run at most every throttle_interval_ms.
+     * - No allocation; the caller provides one ld2420_shed_sensor_t per sensor. Not
+     *   thread-safe.
+     */
+
+    /** Shedding tiers; each includes the ones below it. */
+    typedef enum
+    {
+        LD2420_SHED_TIER_NONE = 0,     /** Everything is forwarded */
+        LD2420_SHED_TIER_DETAIL = 1,   /** Report frames are forwarded as presence summaries */
+        LD2420_SHED_TIER_DECIMATE = 2, /** Unchanged summaries are dropped, except as keepalive */
+        LD2420_SHED_TIER_THROTTLE = 3, /** Non-critical consumers run at a reduced rate */
+    } ld2420_shed_tier_t;
+
+#define LD2420_SHED_TIER_COUNT 4u
+
+    /** What to do with a frame. */
+    typedef enum
+    {
+        LD2420_SHED_FORWARD = 0, /** Forward the frame as is */
+        LD2420_SHED_SUMMARY = 1, /** Forward only presence and distance (ld2420_shed_summary()) */
+        LD2420_SHED_DROP = 2,    /** Drop the frame */
+    } ld2420_shed_action_t;
+
+    /** Thresholds; ld2420_shed_default_config() gives sensible values. */
+    typedef struct
+    {
+        /** Smoothed pressure at which tiers DETAIL, DECIMATE and THROTTLE are entered. */
+        uint16_t enter_permille[LD2420_SHED_TIER_COUNT - 1u];
+        /** How far below its threshold the pressure must fall before a tier is left. */
+        uint16_t exit_margin_permille;
+        /** Smoothing: each sample moves the pressure by 1/2^smoothing_shift of the difference. */
+        uint8_t smoothing_shift;
+        /** Least time in a tier before stepping down. */
+        uint32_t hold_ms;
+        /** Distance change that makes a report frame count as changed while decimating. */
+        uint16_t distance_tolerance_cm;
+        /** Longest gap between forwarded report frames of a sensor while decimating. */
+        uint32_t keepalive_ms;
+        /** Least time between runs of a non-critical consumer in the THROTTLE tier. */
+        uint32_t throttle_interval_ms;
+    } ld2420_shed_config_t;
+
+    /** Per-sensor state: what was last forwarded. */
+    typedef struct
+    {
+        uint32_t last_forward_ms;
+        uint16_t distance_cm;
+        uint8_t presence;
+        /** False until the sensor's first report frame. */
+        bool known;
+    } ld2420_shed_sensor_t;
+
+    /** Controller state and counters. */
+    typedef struct
+    {
+        ld2420_shed_config_t config;
+        /** Current tier (ld2420_shed_tier_t). */
+        uint8_t tier;
+        /** Smoothed pressure in per mille. */
+        uint16_t pressure_permille;
+        /** Time of the last tier change. */
+        uint32_t tier_since_ms;
+        /** Tier changes so far. */
+        uint32_t tier_changes;
+        /** Report frames forwarded as summaries and dropped, and consumer runs deferred. */
+        uint32_t summarized;
+        uint32_t decimated;
+        uint32_t deferred;
+    } ld2420_shed_t;
+
+    /**
+     * Fill config with defaults: tiers at 60 %, 75 % and 90 % pressure, left 10 % below,
+     * held for at least 1 s; decimation keeps a 10 cm tolerance and a 1 s keepalive;
+     * throttled consumers run once per second.
+     */
+    void ld2420_shed_default_config(ld2420_shed_config_t *config);
+
+    /**
+     * Initialize a controller in tier NONE.
+     *
+     * Parameters:
+     * - shed: Controller to initialize.
+     * - config: Thresholds, or NULL for ld2420_shed_default_config().
+     * - now_ms: Current time (any monotonic millisecond clock, wrapping at 2^32).
+     *
+     * Return:
+     * - LD2420_STATUS_OK on success.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on a NULL controller, thresholds that are
+     *   not increasing or above 1000, or a smoothing_shift above 8.
+     */
+    ld2420_status_t ld2420_shed_init(ld2420_shed_t *shed, const ld2420_shed_config_t *config, uint32_t now_ms);
+
+    /** Reset a sensor's state, e.g. when it is attached. */
+    void ld2420_shed_sensor_init(ld2420_shed_sensor_t *sensor);
+
+    /**
+     * Feed one pressure sample and update the tier.
+     *
+     * Parameters:
+     * - cpu_permille: Share of time spent working since the previous sample (0..1000).
+     * - queue_permille: Fill level of the fullest queue, or 1000 if anything was lost
+     *   since the previous sample.
+     * - now_ms: Current time.
+     *
+     * The larger of the two is the sample. Call it at a steady rate, e.g. once per
+     * main loop iteration or poll.
+     *
+     * Return: the tier after the update (LD2420_SHED_TIER_NONE for a NULL controller).
+     */
+    ld2420_shed_tier_t ld2420_shed_update(
+        ld2420_shed_t *shed,
+        uint16_t cpu_permille,
+        uint16_t queue_permille,
+        uint32_t now_ms);
+
+    /**
+     * Decide what to do with a frame from a sensor in the current tier.
+     *
+     * Frames that are not report frames of LD2420_REPORT_ENERGY_SIZE bytes are always
+     * forwarded, and so is a report frame whose presence differs from the sensor's
+     * previous report. On NULL arguments the frame is forwarded.
+     */
+    ld2420_shed_action_t ld2420_shed_classify(
+        ld2420_shed_t *shed,
+        ld2420_shed_sensor_t *sensor,
+        const uint8_t *frame,
+        uint16_t frame_size,
+        uint32_t now_ms);
+
+    /**
+     * The summary of a report frame: its presence byte and little-endian distance, as
+     * on the wire. Only valid for frames that ld2420_shed_classify() returned
+     * LD2420_SHED_SUMMARY for.
+     */
+    const uint8_t *ld2420_shed_summary(const uint8_t *frame);
+
+    /**
+     * Whether a non-critical consumer should run now. Below the THROTTLE tier always
+     * true; in it, true once throttle_interval_ms passed since *last_run_ms. Updates
+     * *last_run_ms when returning true.
+     */
+    bool ld2420_shed_consumer_due(ld2420_shed_t *shed, uint32_t *last_run_ms, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,199 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420.h"
+
+/** Commands a correlator waits for at once; an older one is given up when more arrive. */
+#define LD2420_SNIFF_MAX_PENDING 8u
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * Decoding both directions of a tapped sensor line.
+     *
+     * Motivation:
+     * - Field debugging taps the TX and RX lines of a sensor UART. The RX side is
+     *   covered by ld2420_stream_t, but nothing decodes what the host sends, so a
+     *   capture cannot answer "which command was that ACK for, and how long did the
+     *   sensor take?".
+     *
+     * Design highlights:
+     * - ld2420_tx_stream_t frames host-to-sensor commands, bounded by
+     *   LD2420_MIN_TX_PACKET_SIZE..LD2420_MAX_TX_PACKET_SIZE. The header search uses
+     *   a sliding 32-bit window and a frame is rejected as soon as its length field
+     *   and command id are in if the length cannot belong to that command
+     *   (ld2420_protocol.h), so noise never holds the parser for long. The bytes
+     *   after a rejected header are searched again, so a real command that starts
+     *   inside a false or damaged one is still found.
+     * - ld2420_correlator_t pairs commands with ACKs by timestamp. The sensor answers
+     *   in order, so an ACK belongs to the oldest waiting command it echoes; older
+     *   waiting commands were not answered. A command repeated while the same
+     *   command waits is a retry and gives up the first one. Commands still waiting
+     *   after timeout_us are given up as well.
+     * - Round-trip times go into per-command statistics (count, failures, min, mean,
+     *   max), indexed by the low byte of the command id, and optionally to a
+     *   callback per transaction.
+     * - Timestamps are microseconds of any clock shared by both directions (e.g. a
+     *   gateway's uplink timestamps) and may wrap at 2^32. No allocation; not
+     *   thread-safe.
+     */
+
+    /** TX-direction streaming parser state. */
+    typedef struct
+    {
+        /** Command under construction, from its header. */
+        uint8_t buffer[LD2420_MAX_TX_PACKET_SIZE];
+        /** Bytes in buffer; 0 while searching for a header. */
+        uint16_t index;
+        /** Total command size once the length field is in, else 0. */
+        uint16_t expected_total_size;
+        /** Last four bytes while searching. */
+        uint32_t window;
+        /** Bytes after the header of rejected commands, searched before new input. */
+        uint8_t replay[LD2420_MAX_TX_PACKET_SIZE - 1];
+        /** Next byte to search in replay. */
+        uint16_t replay_offset;
+        /** Bytes in replay. */
+        uint16_t replay_size;
+    } ld2420_tx_stream_t;
+
+    /**
+     * Command callback.
+     *
+     * Parameters:
+     * - user: Pointer given to ld2420_tx_stream_feed_bytes().
+     * - frame, frame_size_bytes: The complete command frame, footer checked; valid
+     *   during the call only.
+     * - command: Command id (LD2420_CMD_*).
+     *
+     * Return: true to continue, false to stop the current call.
+     */
+    typedef bool (*ld2420_tx_stream_on_command_fn)(
+        void *user,
+        const uint8_t *frame,
+        uint16_t frame_size_bytes,
+        uint16_t command);
+
+    /** Initialize/reset a TX stream parser, discarding any partial command. */
+    void ld2420_tx_stream_init(ld2420_tx_stream_t *s);
+
+    /**
+     * Feed a chunk of bytes seen on the TX line.
+     *
+     * Parameters:
+     * - s: Parser (must be initialized).
+     * - data, len: Bytes (data may be NULL if len is 0).
+     * - on_command, user: Called for every valid command, in order.
+     * - out_consumed: Optional. Bytes processed; less than len only if the callback
+     *   returned false.
+     *
+     * Return:
+     * - LD2420_STATUS_OK if every processed byte was accepted.
+     * - Otherwise the first error; the parser resynchronizes and continues:
+     *   LD2420_STATUS_ERROR_BUFFER_TOO_SMALL for a length beyond
+     *   LD2420_MAX_TX_PACKET_SIZE, LD2420_STATUS_ERROR_INVALID_FRAME_SIZE for one
+     *   below LD2420_MIN_TX_PACKET_SIZE or not fitting the command,
+     *   LD2420_STATUS_ERROR_INVALID_PACKET for an id that is not a command (e.g. an
+     *   ACK echo), LD2420_STATUS_ERROR_INVALID_FOOTER for a bad footer.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on a NULL parser or callback, or NULL
+     *   data with a non-zero length.
+     */
+    ld2420_status_t ld2420_tx_stream_feed_bytes(
+        ld2420_tx_stream_t *s,
+        const uint8_t *data,
+        size_t len,
+        ld2420_tx_stream_on_command_fn on_command,
+        void *user,
+        size_t *out_consumed);
+
+    /** Round-trip statistics of one command. */
+    typedef struct
+    {
+        /** Commands seen. */
+        uint32_t commands;
+        /** Commands answered by an ACK, and of those the ones with a non-zero status. */
+        uint32_t answered;
+        uint32_t failed;
+        /** Commands given up without an ACK (timeout, retry, or a later one answered first). */
+        uint32_t unanswered;
+        /** Round-trip times of answered commands in microseconds. */
+        uint32_t min_rtt_us;
+        uint32_t max_rtt_us;
+        uint64_t sum_rtt_us;
+    } ld2420_sniff_stats_t;
+
+    /** One finished transaction, passed to the correlator's callback. */
+    typedef struct
+    {
+        /** Command id (LD2420_CMD_*). */
+        uint16_t command;
+        /** When the command's last byte was seen. */
+        uint32_t command_time_us;
+        /** False if the command was given up; then status and rtt_us are 0. */
+        bool answered;
+        /** ACK status word (0 on success). */
+        uint16_t status;
+        /** ACK time minus command time. */
+        uint32_t rtt_us;
+    } ld2420_sniff_transaction_t;
+
+    /** Transaction callback; the transaction is valid during the call only. */
+    typedef void (*ld2420_sniff_on_transaction_fn)(void *user, const ld2420_sniff_transaction_t *transaction);
+
+    /** Command/ACK correlator state. */
+    typedef struct
+    {
+        uint32_t timeout_us;
+        ld2420_sniff_on_transaction_fn on_transaction;
+        void *user;
+        /** Waiting commands, oldest first. */
+        uint16_t pending_command[LD2420_SNIFF_MAX_PENDING];
+        uint32_t pending_time_us[LD2420_SNIFF_MAX_PENDING];
+        uint8_t pending_count;
+        /** Statistics by the low byte of the command id. */
+        ld2420_sniff_stats_t stats[256];
+        /** ACKs that matched no waiting command. */
+        uint32_t orphan_acks;
+    } ld2420_correlator_t;
+
+    /**
+     * Initialize a correlator.
+     *
+     * Parameters:
+     * - c: Correlator (about 8 KiB, mostly statistics).
+     * - timeout_us: How long a command may wait for its ACK (> 0).
+     * - on_transaction, user: Optional callback for every finished transaction.
+     *
+     * Return:
+     * - LD2420_STATUS_OK on success.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on a NULL correlator or a zero timeout.
+     */
+    ld2420_status_t ld2420_correlator_init(
+        ld2420_correlator_t *c,
+        uint32_t timeout_us,
+        ld2420_sniff_on_transaction_fn on_transaction,
+        void *user);
+
+    /** A command was seen on the TX line at time_us (its last byte). */
+    void ld2420_correlator_command(ld2420_correlator_t *c, uint16_t command, uint32_t time_us);
+
+    /** An ACK was seen on the RX line at time_us; echo and status as in the frame. */
+    void ld2420_correlator_ack(ld2420_correlator_t *c, uint16_t echo, uint16_t status, uint32_t time_us);
+
+    /**
+     * Give up commands that waited longer than the timeout at now_us. Call it when
+     * time passes without traffic, e.g. once per second of capture.
+     */
+    void ld2420_correlator_advance(ld2420_correlator_t *c, uint32_t now_us);
+
+    /** Give up every waiting command, e.g. at the end of a capture. */
+    void ld2420_correlator_flush(ld2420_correlator_t *c);
+
+#ifdef __cplusplus
+}
+#endif
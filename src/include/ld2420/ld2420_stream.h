@@ -5,6 +5,12 @@
 
 #include "ld2420.h"
 
+/**
+ * Further frame starts tracked besides the one at buffer[0]. Headers seen while all
+ * slots are taken are ignored, which bounds the work per byte.
+ */
+#define LD2420_STREAM_MAX_CANDIDATES 3u
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -21,9 +27,14 @@ extern "C"
      *
      * Design highlights:
      * - Uses a single linear buffer sized to LD2420_MAX_RX_PACKET_SIZE.
-     * - Resynchronizes on malformed data by scanning for the next header; preserves up to
-     *   3 trailing bytes to match headers split across chunks.
-     * - Can emit zero or more frames per feed() call (handles back-to-back frames).
+     * - Rejects a frame as soon as its length field and command echo are in if the length
+     *   cannot belong to an ACK of that command (per-command sizes from ld2420_protocol.h).
+     * - Remembers up to LD2420_STREAM_MAX_CANDIDATES further headers seen inside the frame
+     *   under construction. Whichever frame completes first with a valid footer is
+     *   emitted, so a corrupted length field no longer swallows the frames behind it.
+     * - When the frame at the front fails, continues with the oldest candidate; without
+     *   one, preserves up to 3 trailing bytes to match headers split across chunks.
+     * - Can emit zero or more frames per feed_bytes() call (handles back-to-back frames).
      * - Remains agnostic of the transport; thread-unsafe by design (one context per stream).
      */
     typedef struct
@@ -39,8 +50,27 @@ extern "C"
         uint16_t expected_total_size;
         /** True after a valid header was recognized at buffer[0]. */
         bool synced;
+        /** Number of valid entries in candidate_start/candidate_total_size. */
+        uint8_t candidate_count;
+        /** Buffer offsets (> 0, ascending) of further headers seen while synced. */
+        uint8_t candidate_start[LD2420_STREAM_MAX_CANDIDATES];
+        /** Expected total size of each candidate frame, 0 until its length field is in. */
+        uint16_t candidate_total_size[LD2420_STREAM_MAX_CANDIDATES];
     } ld2420_stream_t;
 
+/**
+ * Parser state snapshots (ld2420_stream_snapshot()/ld2420_stream_restore()).
+ *
+ * Layout, little-endian: magic 'L' 'S', version, flags (bit 0: synced), index (u16),
+ * expected_total_size (u16), candidate_count, LD2420_STREAM_MAX_CANDIDATES candidate
+ * offsets (unused ones 0), then the `index` buffered bytes. Candidate sizes are
+ * recomputed from the buffer. Restore rejects other versions, so a process can only
+ * resume from a snapshot in a format it understands.
+ */
+#define LD2420_STREAM_SNAPSHOT_VERSION 2u
+#define LD2420_STREAM_SNAPSHOT_HEADER_SIZE (9u + LD2420_STREAM_MAX_CANDIDATES)
+#define LD2420_STREAM_SNAPSHOT_MAX_SIZE (LD2420_STREAM_SNAPSHOT_HEADER_SIZE + LD2420_MAX_RX_PACKET_SIZE)
+
     /**
      * Signature for the streaming frame callback.
      *
@@ -82,6 +112,8 @@ extern "C"
      * - LD2420_STATUS_OK on successful byte processing (frame may or may not be complete).
      * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS if len != 0 and len != 1, or callback is NULL.
      * - LD2420_STATUS_ERROR_BUFFER_TOO_SMALL if computed frame size exceeds limits.
+     * - LD2420_STATUS_ERROR_INVALID_FRAME_SIZE if the length does not fit the echoed command,
+     *   or a frame starting inside the one under construction completed first.
      * - LD2420_STATUS_ERROR_INVALID_FOOTER if a complete frame has invalid footer.
      * - LD2420_STATUS_ERROR_INVALID_PACKET if frame parsing fails.
      *
@@ -89,7 +121,8 @@ extern "C"
      * - On each feed, the buffer is validated.
      * - If a complete valid frame is assembled, it is validated and the callback is invoked.
      * - If a frame is detected as corrupted, it is discarded and an error status is returned.
-     * - Handles resynchronization to the next valid header on corruption.
+     * - Handles resynchronization to the next valid header on corruption. Only the frame
+     *   at the front reports errors; rejected candidates are dropped silently.
      */
     ld2420_status_t ld2420_stream_feed(
         ld2420_stream_t *s,
@@ -97,6 +130,77 @@ extern "C"
         size_t len,
         ld2420_stream_on_frame_fn on_frame);
 
+    /**
+     * Feed a chunk of bytes to the streaming parser.
+     *
+     * Equivalent to calling ld2420_stream_feed() once per byte, but without the
+     * per-call overhead. Use it to hand the result of a single read() to the parser.
+     *
+     * Parameters:
+     * - s: Parser context (must be initialized).
+     * - data: Bytes to process (may be NULL if len==0).
+     * - len: Number of bytes in data.
+     * - on_frame: Callback invoked for every valid complete frame, in order.
+     * - out_consumed: Optional. Receives the number of bytes processed. Less than len
+     *   only when the callback returned false; the remaining bytes were not touched
+     *   and can be fed again later.
+     *
+     * Return:
+     * - LD2420_STATUS_OK if every processed byte was accepted.
+     * - The first error status encountered otherwise (see ld2420_stream_feed()). Errors
+     *   do not stop processing; the parser resynchronizes and continues with the chunk.
+     */
+    ld2420_status_t ld2420_stream_feed_bytes(
+        ld2420_stream_t *s,
+        const uint8_t *data,
+        size_t len,
+        ld2420_stream_on_frame_fn on_frame,
+        size_t *out_consumed);
+
+    /**
+     * Serialize the parser state, including a partially received frame.
+     *
+     * Together with the transport handle, a snapshot lets another process (or a
+     * restarted one) continue parsing exactly where this context stopped.
+     *
+     * Parameters:
+     * - s: Parser context (must be initialized).
+     * - out: Destination buffer; LD2420_STREAM_SNAPSHOT_MAX_SIZE bytes always suffice.
+     * - out_size: Size of out in bytes.
+     * - out_written: Receives the snapshot size (header plus buffered bytes).
+     *
+     * Return:
+     * - LD2420_STATUS_OK on success.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on NULL pointers.
+     * - LD2420_STATUS_ERROR_BUFFER_TOO_SMALL if out cannot hold the snapshot.
+     */
+    ld2420_status_t ld2420_stream_snapshot(
+        const ld2420_stream_t *s,
+        uint8_t *out,
+        size_t out_size,
+        size_t *out_written);
+
+    /**
+     * Restore a parser context from a snapshot.
+     *
+     * The snapshot is checked against the invariants the parser maintains between
+     * calls (header at the front and at every candidate offset while synced, at most a
+     * partial header otherwise, plausible sizes consistent with the buffered length
+     * fields, no frame already complete). The context is only
+     * modified if the snapshot is accepted.
+     *
+     * Return:
+     * - LD2420_STATUS_OK on success.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on NULL pointers.
+     * - LD2420_STATUS_ERROR_INVALID_BUFFER_SIZE if in_size does not match the snapshot.
+     * - LD2420_STATUS_ERROR_INVALID_HEADER on a bad magic or unsupported version.
+     * - LD2420_STATUS_ERROR_INVALID_PACKET if the state is not one the parser can be in.
+     */
+    ld2420_status_t ld2420_stream_restore(
+        ld2420_stream_t *s,
+        const uint8_t *in,
+        size_t in_size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,235 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420.h"
+
+/** Version byte at the start of every telemetry message. */
+#define LD2420_TELEMETRY_VERSION 1u
+
+/** Largest ACK payload (the bytes between status and footer) an event carries. */
+#define LD2420_TELEMETRY_MAX_ACK_PAYLOAD (LD2420_MAX_RX_PACKET_SIZE - LD2420_MIN_RX_PACKET_SIZE)
+
+/** Largest message header and largest encoded event. */
+#define LD2420_TELEMETRY_MAX_HEADER_SIZE 11u
+#define LD2420_TELEMETRY_MAX_EVENT_SIZE (20u + LD2420_TELEMETRY_MAX_ACK_PAYLOAD)
+
+/** Gates in a report event. */
+#define LD2420_TELEMETRY_GATES 16u
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * Compact binary telemetry for decoded frames.
+     *
+     * Motivation:
+     * - A gateway that publishes every decoded frame as its own text message spends more
+     *   CPU formatting and sending than parsing. A report frame is 45 bytes on the wire
+     *   and around 200 as JSON, and each message is one system call.
+     * - Consecutive reports of a sensor differ little: the gate energies move by a few
+     *   counts, the distance by a few centimetres.
+     *
+     * Message layout:
+     *
+     *   u8      version (LD2420_TELEMETRY_VERSION)
+     *   varint  message sequence number, counting messages of one encoder
+     *   varint  base timestamp in milliseconds
+     *   event*  until the end of the message
+     *
+     * Event layout:
+     *
+     *   u8      kind (ld2420_telemetry_kind_t)
+     *   varint  sensor id
+     *   svarint timestamp minus that of the previous event (the base for the first)
+     *   ACK:      varint cmd_echo, varint status, varint N, N payload bytes
+     *   REPORT:   u8 presence, svarint distance delta, 16 x svarint energy delta
+     *   PRESENCE: u8 presence, svarint distance delta
+     *
+     * varint is unsigned LEB128; svarint is a zigzag-encoded signed value in LEB128.
+     * Distance and energy deltas are taken against the same sensor's previous event in
+     * the same message, and against zero for its first. Every message therefore decodes
+     * on its own: a lost datagram costs its own events and nothing else.
+     *
+     * Several sensors share one message. A steady report typically takes 20-25 bytes.
+     * Encoder and decoder do not allocate; the caller provides the buffers and one
+     * ld2420_telemetry_sensor_t per sensor id. Not thread-safe.
+     */
+
+    /** Kind of a telemetry event. */
+    typedef enum
+    {
+        LD2420_TELEMETRY_ACK = 0x01,      /** Command acknowledgement */
+        LD2420_TELEMETRY_REPORT = 0x02,   /** Report frame: presence, distance and gate energies */
+        LD2420_TELEMETRY_PRESENCE = 0x03, /** Presence and distance only */
+    } ld2420_telemetry_kind_t;
+
+    /** One decoded (or to-be-encoded) event. Fields that do not apply to the kind are ignored. */
+    typedef struct
+    {
+        uint8_t kind;
+        uint16_t sensor_id;
+        uint32_t timestamp_ms;
+        /** REPORT and PRESENCE. */
+        uint8_t presence;
+        uint16_t distance_cm;
+        /** REPORT only. */
+        uint16_t energy[LD2420_TELEMETRY_GATES];
+        /** ACK only; payload is valid during the call that provides it. */
+        uint16_t cmd_echo;
+        uint16_t status;
+        const uint8_t *payload;
+        uint16_t payload_size;
+    } ld2420_telemetry_event_t;
+
+    /** Per-sensor delta state; only meaningful within the message it was stamped with. */
+    typedef struct
+    {
+        uint32_t stamp;
+        uint16_t distance_cm;
+        uint16_t energy[LD2420_TELEMETRY_GATES];
+    } ld2420_telemetry_sensor_t;
+
+    /** Encoder state and counters. */
+    typedef struct
+    {
+        ld2420_telemetry_sensor_t *sensors;
+        uint16_t sensor_count;
+        /** Message under construction; NULL between messages. */
+        uint8_t *out;
+        size_t out_size;
+        size_t used;
+        /** Events in the message under construction. */
+        uint16_t events;
+        uint32_t last_timestamp_ms;
+        /** Identifies the current message in the sensor states. */
+        uint32_t stamp;
+        /** Sequence number of the next message. */
+        uint32_t next_sequence;
+        /** Messages finished and events encoded. */
+        uint32_t messages;
+        uint32_t total_events;
+    } ld2420_telemetry_encoder_t;
+
+    /** Decoder state and counters. */
+    typedef struct
+    {
+        ld2420_telemetry_sensor_t *sensors;
+        uint16_t sensor_count;
+        uint32_t stamp;
+        /** True once a message has been decoded; enables gap counting. */
+        bool have_sequence;
+        uint32_t next_sequence;
+        /** Messages decoded, rejected as malformed, and missing according to the sequence numbers. */
+        uint32_t messages;
+        uint32_t corrupt_messages;
+        uint32_t lost_messages;
+        /** Events delivered. */
+        uint32_t events;
+    } ld2420_telemetry_decoder_t;
+
+    /**
+     * Initialize an encoder.
+     *
+     * Parameters:
+     * - enc: Encoder to initialize.
+     * - sensors: One state per sensor id, sensor_count of them; event sensor ids must be
+     *   below sensor_count.
+     *
+     * Return: LD2420_STATUS_OK, or LD2420_STATUS_ERROR_INVALID_ARGUMENTS on NULL pointers
+     * or a zero sensor_count.
+     */
+    ld2420_status_t ld2420_telemetry_encoder_init(
+        ld2420_telemetry_encoder_t *enc,
+        ld2420_telemetry_sensor_t *sensors,
+        uint16_t sensor_count);
+
+    /**
+     * Start a message in out, with timestamp_ms as the base of its first event.
+     *
+     * Return:
+     * - LD2420_STATUS_OK on success.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on NULL pointers.
+     * - LD2420_STATUS_ERROR_BUFFER_TOO_SMALL if out cannot hold the header and one
+     *   event of the largest size.
+     */
+    ld2420_status_t ld2420_telemetry_begin(
+        ld2420_telemetry_encoder_t *enc,
+        uint8_t *out,
+        size_t out_size,
+        uint32_t timestamp_ms);
+
+    /**
+     * Append an event to the current message.
+     *
+     * Return:
+     * - LD2420_STATUS_OK when the event was encoded.
+     * - LD2420_STATUS_ERROR_BUFFER_TOO_SMALL if it does not fit; nothing was written,
+     *   so finish the message and append it to the next one.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS with no message started, an unknown kind,
+     *   a sensor id out of range or an oversized ACK payload.
+     */
+    ld2420_status_t ld2420_telemetry_append(ld2420_telemetry_encoder_t *enc, const ld2420_telemetry_event_t *event);
+
+    /**
+     * Finish the current message.
+     *
+     * Return: Its size in bytes, or 0 if no message was started or it holds no event
+     * (such a message is discarded and does not use up a sequence number).
+     */
+    size_t ld2420_telemetry_end(ld2420_telemetry_encoder_t *enc);
+
+    /**
+     * Turn a complete frame into an event: report frames become REPORT events, command
+     * ACKs become ACK events with the payload pointing into frame.
+     *
+     * Return:
+     * - LD2420_STATUS_OK on success.
+     * - LD2420_STATUS_ERROR_INVALID_FRAME for frames of neither kind or with a
+     *   mismatching length field.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on NULL pointers.
+     */
+    ld2420_status_t ld2420_telemetry_event_from_frame(
+        const uint8_t *frame,
+        uint16_t frame_size,
+        uint16_t sensor_id,
+        uint32_t timestamp_ms,
+        ld2420_telemetry_event_t *event);
+
+    /** Initialize a decoder; sensors as for the encoder. */
+    ld2420_status_t ld2420_telemetry_decoder_init(
+        ld2420_telemetry_decoder_t *dec,
+        ld2420_telemetry_sensor_t *sensors,
+        uint16_t sensor_count);
+
+    /**
+     * Event callback. The event (and an ACK's payload) is only valid during the call.
+     * Return true to continue, false to stop decoding the message.
+     */
+    typedef bool (*ld2420_telemetry_on_event_fn)(void *user, const ld2420_telemetry_event_t *event);
+
+    /**
+     * Decode one message and deliver its events in order.
+     *
+     * A malformed message (bad version, truncated event, unknown kind, sensor id out of
+     * range) is counted in corrupt_messages; the events before the fault have already
+     * been delivered.
+     *
+     * Return:
+     * - LD2420_STATUS_OK on success.
+     * - LD2420_STATUS_ERROR_INVALID_PACKET for a malformed message.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on NULL pointers.
+     */
+    ld2420_status_t ld2420_telemetry_decode(
+        ld2420_telemetry_decoder_t *dec,
+        const uint8_t *message,
+        size_t size,
+        ld2420_telemetry_on_event_fn on_event,
+        void *user);
+
+#ifdef __cplusplus
+}
+#endif
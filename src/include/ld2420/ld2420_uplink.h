@@ -0,0 +1,219 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ld2420.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * Binary uplink between a microcontroller gateway and a host.
+     *
+     * Motivation:
+     * - A gateway with several sensors forwards everything it receives to a host over
+     *   one link (e.g. USB CDC). Hex text triples the bandwidth and costs a printf per byte.
+     * - The uplink wraps each piece of sensor data in a small binary record that tells
+     *   the host which sensor it came from, when, and what it is.
+     *
+     * Record layout (all multi-byte fields little-endian):
+     *
+     *   offset  size  field
+     *   0       2     sync 0xA5 0x5A
+     *   2       2     payload length N (0..LD2420_UPLINK_MAX_PAYLOAD)
+     *   4       1     sensor id (e.g. UART index)
+     *   5       1     kind (ld2420_uplink_kind_t)
+     *   6       1     sequence number, incremented per record on the link
+     *   7       4     timestamp in microseconds (free-running, wraps)
+     *   11      N     payload
+     *   11+N    2     CRC-16/CCITT-FALSE over bytes 2..10+N
+     *
+     * A 45-byte report frame travels as 58 bytes instead of 135+ bytes of hex text.
+     *
+     * The encoder, the batched writer and the decoder are transport-agnostic and do not
+     * allocate; the platform layers only provide the function that moves bytes.
+     */
+
+/** Record overhead: sync, length, sensor, kind, sequence, timestamp and CRC. */
+#define LD2420_UPLINK_HEADER_SIZE 11u
+#define LD2420_UPLINK_CRC_SIZE 2u
+#define LD2420_UPLINK_OVERHEAD (LD2420_UPLINK_HEADER_SIZE + LD2420_UPLINK_CRC_SIZE)
+
+/** Largest payload of a single record; covers every LD2420 frame. */
+#define LD2420_UPLINK_MAX_PAYLOAD 256u
+
+/** Largest encoded record. */
+#define LD2420_UPLINK_MAX_RECORD_SIZE (LD2420_UPLINK_OVERHEAD + LD2420_UPLINK_MAX_PAYLOAD)
+
+/**
+ * Size of the batch buffer in ld2420_uplink_writer_t. Records are collected here and
+ * handed to the transport in one write. Override at compile time to trade RAM for
+ * fewer, larger transfers.
+ */
+#ifndef LD2420_UPLINK_BATCH_SIZE
+#define LD2420_UPLINK_BATCH_SIZE 256u
+#endif
+
+    /** Sync bytes at the start of every record. */
+    static const uint8_t LD2420_UPLINK_SYNC[] = {0xA5, 0x5A};
+
+    /** What a record's payload contains. */
+    typedef enum
+    {
+        LD2420_UPLINK_KIND_FRAME = 0x01,    /** A complete frame as received from the sensor */
+        LD2420_UPLINK_KIND_BYTES = 0x02,    /** Raw sensor bytes, not aligned to frames */
+        LD2420_UPLINK_KIND_OVERFLOW = 0x03, /** u32 count of sensor bytes the gateway dropped */
+        LD2420_UPLINK_KIND_PRESENCE = 0x04, /** u8 presence, u16 distance_cm: a report frame without its gate energies */
+    } ld2420_uplink_kind_t;
+
+    /** One decoded (or to-be-encoded) uplink record. */
+    typedef struct
+    {
+        uint8_t sensor_id;
+        uint8_t kind;
+        uint8_t sequence;
+        uint32_t timestamp_us;
+        const uint8_t *payload;
+        uint16_t payload_size;
+    } ld2420_uplink_record_t;
+
+    /**
+     * Encode one record.
+     *
+     * Parameters:
+     * - record: Record to encode; payload may be NULL if payload_size is 0.
+     * - out: Destination buffer.
+     * - out_size: Size of out in bytes.
+     * - out_written: Receives the encoded size (LD2420_UPLINK_OVERHEAD + payload_size).
+     *
+     * Return:
+     * - LD2420_STATUS_OK on success.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on NULL pointers or an oversized payload.
+     * - LD2420_STATUS_ERROR_BUFFER_TOO_SMALL if out cannot hold the record.
+     */
+    ld2420_status_t ld2420_uplink_encode(
+        const ld2420_uplink_record_t *record,
+        uint8_t *out,
+        size_t out_size,
+        size_t *out_written);
+
+    /**
+     * Transport write used by the batched writer.
+     *
+     * Must return the number of bytes accepted (0..len). Bytes that were not accepted are
+     * kept and offered again on the next flush.
+     */
+    typedef size_t (*ld2420_uplink_write_fn)(void *user, const uint8_t *data, size_t len);
+
+    /**
+     * Batched uplink writer.
+     *
+     * Records are encoded straight into the batch buffer and written to the transport
+     * when the buffer cannot take the next record or when ld2420_uplink_writer_flush()
+     * is called, typically once per main loop iteration.
+     */
+    typedef struct
+    {
+        /** Encoded records waiting for the transport. */
+        uint8_t batch[LD2420_UPLINK_BATCH_SIZE];
+        /** Bytes used in batch. */
+        uint16_t used;
+        /** Sequence number of the next record. */
+        uint8_t next_sequence;
+        /** Records dropped because the transport did not keep up. */
+        uint32_t dropped_records;
+        ld2420_uplink_write_fn write;
+        void *user;
+    } ld2420_uplink_writer_t;
+
+    /** Initialize a writer with its transport. */
+    ld2420_status_t ld2420_uplink_writer_init(ld2420_uplink_writer_t *w, ld2420_uplink_write_fn write, void *user);
+
+    /**
+     * Append a record to the batch, flushing first if it does not fit.
+     *
+     * Return:
+     * - LD2420_STATUS_OK when the record was queued.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on NULL pointers or an oversized payload.
+     * - LD2420_STATUS_ERROR_BUFFER_TOO_SMALL when the transport did not drain enough of
+     *   the batch; the record is dropped and counted in dropped_records.
+     */
+    ld2420_status_t ld2420_uplink_writer_append(
+        ld2420_uplink_writer_t *w,
+        uint8_t sensor_id,
+        ld2420_uplink_kind_t kind,
+        uint32_t timestamp_us,
+        const uint8_t *payload,
+        uint16_t payload_size);
+
+    /**
+     * Hand the batch to the transport.
+     *
+     * Return: LD2420_STATUS_OK if the batch is empty afterwards,
+     * LD2420_STATUS_ERROR_BUFFER_TOO_SMALL if the transport left bytes behind.
+     */
+    ld2420_status_t ld2420_uplink_writer_flush(ld2420_uplink_writer_t *w);
+
+    /**
+     * Streaming uplink decoder.
+     *
+     * Accepts the link byte stream in arbitrary chunks, finds records by their sync
+     * bytes, verifies length and CRC, and reports each valid record. On a bad record it
+     * skips one byte and searches for the next sync, like the frame stream parser.
+     */
+    typedef struct
+    {
+        /** Bytes of the record under construction. */
+        uint8_t buffer[LD2420_UPLINK_MAX_RECORD_SIZE];
+        /** Number of bytes in buffer. */
+        uint16_t index;
+        /** True once a record has been decoded; enables sequence gap counting. */
+        bool have_sequence;
+        /** Sequence number of the last decoded record. */
+        uint8_t last_sequence;
+        /** Records decoded. */
+        uint32_t records;
+        /** Records rejected because of a bad CRC or length. */
+        uint32_t corrupt_records;
+        /** Records missing according to the sequence numbers. */
+        uint32_t lost_records;
+    } ld2420_uplink_decoder_t;
+
+    /**
+     * Record callback. The payload pointer is only valid during the call.
+     * Return true to continue, false to stop decoding the current chunk.
+     */
+    typedef bool (*ld2420_uplink_on_record_fn)(void *user, const ld2420_uplink_record_t *record);
+
+    /** Initialize/reset a decoder. */
+    void ld2420_uplink_decoder_init(ld2420_uplink_decoder_t *d);
+
+    /**
+     * Decode a chunk of link bytes.
+     *
+     * Parameters:
+     * - d: Decoder (must be initialized).
+     * - data, len: Link bytes.
+     * - on_record, user: Called for every valid record, in order.
+     * - out_consumed: Optional. Bytes processed; less than len only if the callback
+     *   returned false.
+     *
+     * Return:
+     * - LD2420_STATUS_OK if no corrupt record was found in this chunk.
+     * - LD2420_STATUS_ERROR_INVALID_PACKET if at least one record was rejected.
+     * - LD2420_STATUS_ERROR_INVALID_ARGUMENTS on NULL pointers.
+     */
+    ld2420_status_t ld2420_uplink_decode(
+        ld2420_uplink_decoder_t *d,
+        const uint8_t *data,
+        size_t len,
+        ld2420_uplink_on_record_fn on_record,
+        void *user,
+        size_t *out_consumed);
+
+#ifdef __cplusplus
+}
+#endif
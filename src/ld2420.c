@@ -7,33 +7,13 @@
 
 #include <stddef.h>
 #include <stdbool.h>
-#include <memory.h>
 
 #include "ld2420/ld2420.h"
+#include "ld2420/ld2420_protocol.h"
+#include "ld2420_internal.h"
 
-#define PACKET_CMD_ECHO_OFFSET (sizeof(LD2420_BEG_COMMAND_PACKET) + 2)
-#define PACKET_STATUS_OFFSET (PACKET_CMD_ECHO_OFFSET + 2)
-
-/**
- * When compiling for a big-endian platform, we need to use helper routines
- * to read/write little-endian multi-byte values.
- */
-#ifdef LD2420_PLATFORM_BE
-/**
- * Read a 16-bit little-endian value from a buffer regardless of host endianness.
- * Example: bytes [0xFF, 0x01] represent 0x01FF in little-endian.
- */
-static inline uint16_t read_le16(const uint8_t *b)
-{
-    return (uint16_t)b[0] | ((uint16_t)b[1] << 8);
-}
-
-/** Write a 16-bit value to a buffer in little-endian byte order. */
-static inline void write_le16(uint8_t *buffer, uint16_t value)
-{
-    buffer[0] = (uint8_t)(value & 0xFF);        // LSB
-    buffer[1] = (uint8_t)((value >> 8) & 0xFF); // MSB
-}
+#ifdef LD2420_WORK_COUNTERS
+uint64_t ld2420_work_bytes_examined = 0;
 #endif
 
 /**
@@ -50,13 +30,12 @@ static inline const ld2420_status_t __ld2420_rx_validate_packet_metadata__(
         return LD2420_STATUS_ERROR_INVALID_BUFFER_SIZE | LD2420_STATUS_ERROR_INVALID_BUFFER;
 
     // Making sure that the buffer actually starts with the expected header for the LD2420 module.
-    int is_same = memcmp(raw_rx_buffer, LD2420_BEG_COMMAND_PACKET, sizeof(LD2420_BEG_COMMAND_PACKET)) == 0;
+    int is_same = ld2420_word_equal(raw_rx_buffer, LD2420_BEG_COMMAND_PACKET);
     if (!is_same)
         return LD2420_STATUS_ERROR_INVALID_HEADER;
 
     // Verify that the footer matches the expected footer bytes.
-    is_same = memcmp(raw_rx_buffer, raw_rx_buffer + raw_rx_buffer_size - sizeof(LD2420_END_COMMAND_PACKET),
-                     sizeof(LD2420_END_COMMAND_PACKET)) == 0;
+    is_same = ld2420_word_equal(raw_rx_buffer, raw_rx_buffer + raw_rx_buffer_size - sizeof(LD2420_END_COMMAND_PACKET));
     if (!is_same)
         return LD2420_STATUS_ERROR_INVALID_FOOTER;
 
@@ -71,13 +50,10 @@ static inline const ld2420_status_t __get_frame_size__(
     const uint8_t *buffer,
     uint16_t *out_intra_frame_data_size)
 {
-#ifdef LD2420_PLATFORM_BE
-    // Extract frame size using little-endian byte order (LD2420 protocol standard).
-    // Frame size is located immediately after the 4-byte header.
-    *out_intra_frame_data_size = read_le16(buffer + sizeof(LD2420_BEG_COMMAND_PACKET));
-#else
-    *out_intra_frame_data_size = *(uint16_t *)(buffer + sizeof(LD2420_BEG_COMMAND_PACKET));
-#endif
+    // Frame size is located immediately after the 4-byte header, little-endian
+    // (LD2420 protocol standard). Read byte-wise: frames need not be aligned.
+    *out_intra_frame_data_size = ld2420_protocol_read_le16(buffer + LD2420_PROTOCOL_LENGTH_OFFSET);
+    LD2420_COUNT_WORK(sizeof(*out_intra_frame_data_size));
 
     // An additional check to make sure that the extracted frame size is a valid strictly
     // positive integer.
@@ -98,25 +74,28 @@ static inline const ld2420_status_t __validate_packet__(
     const uint8_t buffer_size,
     const uint16_t intra_frame_data_size)
 {
-    uint8_t expected_buffer_size = sizeof(LD2420_BEG_COMMAND_PACKET) +
-                                   sizeof(intra_frame_data_size) + // 2 bytes
-                                   intra_frame_data_size +
-                                   sizeof(LD2420_END_COMMAND_PACKET);
+    // Computed in 32 bits: a large length field must not wrap around to a
+    // value that happens to match the buffer size.
+    uint32_t expected_buffer_size = (uint32_t)sizeof(LD2420_BEG_COMMAND_PACKET) +
+                                    sizeof(intra_frame_data_size) + // 2 bytes
+                                    intra_frame_data_size +
+                                    sizeof(LD2420_END_COMMAND_PACKET);
     // Verify that the buffer size matches the expected size.
     if (buffer_size != expected_buffer_size)
         return LD2420_STATUS_ERROR_INVALID_BUFFER_SIZE;
 
+    LD2420_COUNT_WORK(sizeof(LD2420_BEG_COMMAND_PACKET) + sizeof(LD2420_END_COMMAND_PACKET));
+
     // Making sure that the header matches the expected header bytes.
-    if (memcmp(buffer, LD2420_BEG_COMMAND_PACKET, sizeof(LD2420_BEG_COMMAND_PACKET)) != 0)
+    if (!ld2420_word_equal(buffer, LD2420_BEG_COMMAND_PACKET))
         return LD2420_STATUS_ERROR_INVALID_HEADER;
 
     // Verify that the footer matches the expected footer bytes.
-    if (memcmp(buffer +
-                   sizeof(LD2420_BEG_COMMAND_PACKET) +
-                   sizeof(intra_frame_data_size) +
-                   intra_frame_data_size,
-               LD2420_END_COMMAND_PACKET,
-               sizeof(LD2420_END_COMMAND_PACKET)) != 0)
+    if (!ld2420_word_equal(buffer +
+                               sizeof(LD2420_BEG_COMMAND_PACKET) +
+                               sizeof(intra_frame_data_size) +
+                               intra_frame_data_size,
+                           LD2420_END_COMMAND_PACKET))
         return LD2420_STATUS_ERROR_INVALID_FOOTER;
 
     return LD2420_STATUS_OK;
@@ -140,6 +119,11 @@ ld2420_status_t ld2420_parse_rx_buffer(
     if (out_frame_size == NULL || out_cmd_echo == NULL || out_status == NULL)
         return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
 
+    // The length field must be inside the buffer before it is read, and the
+    // packet must fit the limits the streaming parser enforces as well.
+    if (in_raw_rx_buffer_size < LD2420_MIN_RX_PACKET_SIZE || in_raw_rx_buffer_size > LD2420_MAX_RX_PACKET_SIZE)
+        return LD2420_STATUS_ERROR_INVALID_BUFFER_SIZE;
+
     // Start populating the packet structure by verifying the header and extracting
     // the frame size.
     ld2420_status_t status = __get_frame_size__(in_raw_rx_buffer, out_frame_size);
@@ -156,28 +140,20 @@ ld2420_status_t ld2420_parse_rx_buffer(
     if (*out_frame_size < 4)
         return LD2420_STATUS_ERROR_INVALID_FRAME_SIZE;
 
-// Echoed command and the status will be extracted directly from the buffer as separate
-// values. This will ensure that the command doesn't contain the status bits.
-#ifdef LD2420_PLATFORM_BE
-    *out_cmd_echo = (uint8_t)read_le16(in_raw_rx_buffer + PACKET_CMD_ECHO_OFFSET);
-    *out_status = (uint8_t)(in_raw_rx_buffer + PACKET_STATUS_OFFSET);
-#else
-    *out_cmd_echo = *(uint8_t *)(in_raw_rx_buffer + PACKET_CMD_ECHO_OFFSET);
-    *out_status = *(uint8_t *)(in_raw_rx_buffer + PACKET_STATUS_OFFSET);
-#endif
+    LD2420_COUNT_WORK(4); // cmd_echo + status words
+
+    // Echoed command and the status will be extracted directly from the buffer as separate
+    // values. This will ensure that the command doesn't contain the status bits. The
+    // offsets come from the generated protocol header.
+    *out_cmd_echo = in_raw_rx_buffer[LD2420_ACK_CMD_ECHO_OFFSET];
+    *out_status = in_raw_rx_buffer[LD2420_ACK_STATUS_OFFSET];
 
     // If the optional parameters are provided, we can extract them as well.
     if (opt_out_param_name != NULL && opt_out_param_value != NULL)
     {
-        // The parameters are located after the status field, so we can read them directly.
-        // The parameters are 2 bytes each, so we can read them as follows:
-#ifdef LD2420_PLATFORM_BE
-        *opt_out_param_name = read_le16(in_raw_rx_buffer + PACKET_STATUS_OFFSET + 2);
-        *opt_out_param_value = read_le16(in_raw_rx_buffer + PACKET_STATUS_OFFSET + 4);
-#else
-        *opt_out_param_name = *(uint16_t *)(in_raw_rx_buffer + PACKET_STATUS_OFFSET + 2);
-        *opt_out_param_value = *(uint16_t *)(in_raw_rx_buffer + PACKET_STATUS_OFFSET + 4);
-#endif
+        // The parameters are two little-endian words directly after the status field.
+        *opt_out_param_name = ld2420_protocol_read_le16(in_raw_rx_buffer + LD2420_ACK_DATA_OFFSET);
+        *opt_out_param_value = ld2420_protocol_read_le16(in_raw_rx_buffer + LD2420_ACK_DATA_OFFSET + 2);
     }
 
     return LD2420_STATUS_OK;
@@ -0,0 +1,261 @@
+/*
+ * LD2420 batch parser implementation
+ *
+ * Design Principles
+ * -----------------
+ * 1. The fast path decides a frame with word compares only: header, footer
+ *    and "length field + overhead == size" are XORed against their expected
+ *    values and ORed together, and a single test on the result accepts it
+ * 2. Frames are at independent addresses, so the loads are gathers; the loop
+ *    prefetches a few frames ahead instead of using vector registers
+ * 3. Anything the fast path rejects goes to ld2420_parse_rx_buffer(), which
+ *    reports the exact error; that path is cold on clean captures
+ * 4. Report frames are decoded eight at a time: their gate energies form an
+ *    8x16 matrix of u16 that is transposed in SSE2 registers, so every store
+ *    writes eight consecutive entries of one gate column. Other targets, big
+ *    endian hosts and LD2420_NO_SIMD builds use the scalar loop, which gives
+ *    identical results
+ *
+ * Memory & Threading
+ * ------------------
+ * - No dynamic allocation, no state
+ * - Reentrant; outputs of concurrent calls must not overlap
+ */
+
+#include <ld2420/ld2420_batch.h>
+#include <ld2420/ld2420_protocol.h>
+#include "ld2420_internal.h"
+
+#if defined(__SSE2__) && !defined(LD2420_NO_SIMD) && !defined(LD2420_PLATFORM_BE)
+#define BATCH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+LD2420_PROTOCOL_STATIC_CHECK(report_gates, sizeof(((ld2420_report_energy_t *)0)->energy) ==
+                                               LD2420_REPORT_GATES * sizeof(uint16_t));
+
+/** How many frames ahead the loop prefetches. */
+#define BATCH_PREFETCH_DISTANCE 8u
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BATCH_PREFETCH(p) __builtin_prefetch((p), 0, 1)
+#define BATCH_LIKELY(x) __builtin_expect(!!(x), 1)
+#else
+#define BATCH_PREFETCH(p) ((void)(p))
+#define BATCH_LIKELY(x) (x)
+#endif
+
+/** Cold path: let the one-shot parser find out why the frame was rejected. */
+static ld2420_status_t diagnose_frame(
+    const uint8_t *frame,
+    uint8_t size,
+    const ld2420_rx_batch_t *out,
+    size_t i)
+{
+    uint16_t frame_size = 0, cmd_echo = 0, device_status = 0, param_name = 0, param_value = 0;
+    ld2420_status_t status = LD2420_STATUS_ERROR_INVALID_BUFFER;
+    if (frame != NULL)
+        status = ld2420_parse_rx_buffer(frame, size, &frame_size, &cmd_echo, &device_status,
+                                        &param_name, &param_value);
+    if (status != LD2420_STATUS_OK)
+        frame_size = cmd_echo = device_status = param_name = param_value = 0;
+
+    out->frame_size[i] = frame_size;
+    out->cmd_echo[i] = cmd_echo;
+    out->device_status[i] = device_status;
+    if (out->param_name != NULL)
+        out->param_name[i] = param_name;
+    if (out->param_value != NULL)
+        out->param_value[i] = param_value;
+    return status;
+}
+
+ld2420_status_t ld2420_parse_rx_batch(
+    const uint8_t *const *frames,
+    const uint8_t *frame_sizes,
+    size_t count,
+    const ld2420_rx_batch_t *out,
+    size_t *out_valid)
+{
+    if (out_valid)
+        *out_valid = 0;
+    if (count == 0)
+        return LD2420_STATUS_OK;
+    if (!frames || !frame_sizes || !out || !out->status || !out->frame_size || !out->cmd_echo ||
+        !out->device_status)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    // Column pointers in locals: the compiler cannot assume stores to one
+    // column leave the others (or *out) unchanged
+    ld2420_status_t *const status = out->status;
+    uint16_t *const frame_size = out->frame_size;
+    uint16_t *const cmd_echo = out->cmd_echo;
+    uint16_t *const device_status = out->device_status;
+    uint16_t *const param_name = out->param_name;
+    uint16_t *const param_value = out->param_value;
+
+    size_t valid = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i + BATCH_PREFETCH_DISTANCE < count)
+            BATCH_PREFETCH(frames[i + BATCH_PREFETCH_DISTANCE]);
+
+        const uint8_t *frame = frames[i];
+        const uint8_t size = frame_sizes[i];
+
+        // The range check keeps the word loads below inside the frame; a valid
+        // size implies a length of at least 4 (command echo and status)
+        if (BATCH_LIKELY(frame != NULL && size >= LD2420_MIN_RX_PACKET_SIZE && size <= LD2420_MAX_RX_PACKET_SIZE))
+        {
+            LD2420_COUNT_WORK(LD2420_ACK_DATA_OFFSET + sizeof(LD2420_END_COMMAND_PACKET));
+            const uint16_t length = ld2420_protocol_read_le16(frame + LD2420_PROTOCOL_LENGTH_OFFSET);
+            const uint32_t mismatch =
+                (ld2420_protocol_read_le32(frame) ^ LD2420_PROTOCOL_COMMAND_HEADER) |
+                (ld2420_protocol_read_le32(frame + size - 4u) ^ LD2420_PROTOCOL_COMMAND_FOOTER) |
+                (((uint32_t)length + LD2420_PROTOCOL_FRAME_OVERHEAD) ^ size);
+
+            if (BATCH_LIKELY(mismatch == 0))
+            {
+                status[i] = LD2420_STATUS_OK;
+                frame_size[i] = length;
+                cmd_echo[i] = frame[LD2420_ACK_CMD_ECHO_OFFSET];
+                device_status[i] = frame[LD2420_ACK_STATUS_OFFSET];
+                if (param_name != NULL)
+                    param_name[i] = ld2420_protocol_read_le16(frame + LD2420_ACK_DATA_OFFSET);
+                if (param_value != NULL)
+                    param_value[i] = ld2420_protocol_read_le16(frame + LD2420_ACK_DATA_OFFSET + 2u);
+                valid++;
+                continue;
+            }
+        }
+
+        status[i] = diagnose_frame(frame, size, out, i);
+        if (status[i] == LD2420_STATUS_OK)
+            valid++;
+    }
+
+    if (out_valid)
+        *out_valid = valid;
+    return LD2420_STATUS_OK;
+}
+
+/** Scalar decode of report frame i into the columns. */
+static void decode_report(const uint8_t *frame, const ld2420_report_batch_t *out, size_t i)
+{
+    if (out->presence != NULL)
+        out->presence[i] = frame[LD2420_REPORT_ENERGY_PRESENCE_OFFSET];
+    if (out->distance_cm != NULL)
+        out->distance_cm[i] = ld2420_protocol_read_le16(frame + LD2420_REPORT_ENERGY_DISTANCE_CM_OFFSET);
+    for (unsigned g = 0; g < LD2420_REPORT_GATES; g++)
+    {
+        const uint16_t energy = ld2420_protocol_read_le16(frame + LD2420_REPORT_ENERGY_ENERGY_OFFSET + 2u * g);
+        if (out->energy[g] != NULL)
+            out->energy[g][i] = energy;
+        if (out->energy_f32[g] != NULL)
+            out->energy_f32[g][i] = (float)energy * out->energy_scale;
+    }
+}
+
+#ifdef BATCH_SSE2
+/** Transpose eight rows of eight u16: afterwards r[g] holds element g of every row. */
+static inline void transpose_8x8_u16(__m128i r[8])
+{
+    const __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+    const __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+    const __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+    const __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+    const __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+    const __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+    const __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+    const __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+    const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+    const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+    const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+    const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+    const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+    const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+    const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+    const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+    r[0] = _mm_unpacklo_epi64(b0, b4);
+    r[1] = _mm_unpackhi_epi64(b0, b4);
+    r[2] = _mm_unpacklo_epi64(b1, b5);
+    r[3] = _mm_unpackhi_epi64(b1, b5);
+    r[4] = _mm_unpacklo_epi64(b2, b6);
+    r[5] = _mm_unpackhi_epi64(b2, b6);
+    r[6] = _mm_unpacklo_epi64(b3, b7);
+    r[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+/** Store one transposed gate vector (eight frames) into its columns. */
+static inline void store_gate(__m128i v, uint16_t *raw, float *f32, __m128 scale, size_t i)
+{
+    if (raw != NULL)
+        _mm_storeu_si128((__m128i *)(raw + i), v);
+    if (f32 != NULL)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        _mm_storeu_ps(f32 + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)), scale));
+        _mm_storeu_ps(f32 + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)), scale));
+    }
+}
+
+/** Decode frames [i, i + 8) into the columns. */
+static void decode_reports_x8(const uint8_t *const *frames, const ld2420_report_batch_t *out, size_t i)
+{
+    __m128i low[8], high[8];
+    for (unsigned f = 0; f < 8; f++)
+    {
+        const uint8_t *energy = frames[i + f] + LD2420_REPORT_ENERGY_ENERGY_OFFSET;
+        low[f] = _mm_loadu_si128((const __m128i *)energy);
+        high[f] = _mm_loadu_si128((const __m128i *)(energy + 16));
+        if (out->presence != NULL)
+            out->presence[i + f] = frames[i + f][LD2420_REPORT_ENERGY_PRESENCE_OFFSET];
+        if (out->distance_cm != NULL)
+            out->distance_cm[i + f] = ld2420_protocol_read_le16(frames[i + f] + LD2420_REPORT_ENERGY_DISTANCE_CM_OFFSET);
+    }
+    transpose_8x8_u16(low);
+    transpose_8x8_u16(high);
+
+    const __m128 scale = _mm_set1_ps(out->energy_scale);
+    for (unsigned g = 0; g < 8; g++)
+    {
+        store_gate(low[g], out->energy[g], out->energy_f32[g], scale, i);
+        store_gate(high[g], out->energy[g + 8], out->energy_f32[g + 8], scale, i);
+    }
+}
+#endif
+
+ld2420_status_t ld2420_decode_report_batch(
+    const uint8_t *const *frames,
+    size_t count,
+    const ld2420_report_batch_t *out)
+{
+    if (count == 0)
+        return LD2420_STATUS_OK;
+    if (!frames || !out)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (frames[i] == NULL)
+            return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    }
+
+    size_t i = 0;
+#ifdef BATCH_SSE2
+    for (; i + 8u <= count; i += 8u)
+    {
+        if (i + 8u + BATCH_PREFETCH_DISTANCE <= count)
+        {
+            for (unsigned f = 0; f < 8; f++)
+                BATCH_PREFETCH(frames[i + BATCH_PREFETCH_DISTANCE + f]);
+        }
+        decode_reports_x8(frames, out, i);
+    }
+#endif
+    for (; i < count; i++)
+        decode_report(frames[i], out, i);
+
+    return LD2420_STATUS_OK;
+}
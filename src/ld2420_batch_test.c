@@ -0,0 +1,206 @@
+#include <unity.h>
+#include <string.h>
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_batch.h>
+#include <ld2420/ld2420_protocol.h>
+
+/** OPEN CONFIG MODE ACK as sent by the sensor (protocol version 2, buffer size 0x20). */
+static const uint8_t OPEN_CONFIG_ACK[] = {
+    0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01,
+    0x00, 0x00, 0x02, 0x00, 0x20, 0x00, 0x04, 0x03, 0x02, 0x01};
+
+/** CLOSE CONFIG MODE ACK with a non-zero device status. */
+static const uint8_t CLOSE_CONFIG_ACK[] = {
+    0xFD, 0xFC, 0xFB, 0xFA, 0x04, 0x00, 0xFE, 0x01,
+    0x01, 0x00, 0x04, 0x03, 0x02, 0x01};
+
+#define BATCH_FRAMES 9u
+
+static ld2420_status_t statuses[BATCH_FRAMES];
+static uint16_t frame_sizes[BATCH_FRAMES];
+static uint16_t cmd_echoes[BATCH_FRAMES];
+static uint16_t device_statuses[BATCH_FRAMES];
+static uint16_t param_names[BATCH_FRAMES];
+static uint16_t param_values[BATCH_FRAMES];
+
+void setUp(void)
+{
+    memset(statuses, 0xAA, sizeof(statuses));
+    memset(frame_sizes, 0xAA, sizeof(frame_sizes));
+    memset(cmd_echoes, 0xAA, sizeof(cmd_echoes));
+    memset(device_statuses, 0xAA, sizeof(device_statuses));
+    memset(param_names, 0xAA, sizeof(param_names));
+    memset(param_values, 0xAA, sizeof(param_values));
+}
+
+void tearDown(void)
+{
+}
+
+void test__batch_matches_one_shot_parser_per_frame(void)
+{
+    uint8_t bad_header[sizeof(OPEN_CONFIG_ACK)], bad_footer[sizeof(OPEN_CONFIG_ACK)],
+        bad_length[sizeof(OPEN_CONFIG_ACK)], zero_length[sizeof(OPEN_CONFIG_ACK)];
+    memcpy(bad_header, OPEN_CONFIG_ACK, sizeof(OPEN_CONFIG_ACK));
+    bad_header[2] = 0x00;
+    memcpy(bad_footer, OPEN_CONFIG_ACK, sizeof(OPEN_CONFIG_ACK));
+    bad_footer[sizeof(bad_footer) - 1] = 0x00;
+    memcpy(bad_length, OPEN_CONFIG_ACK, sizeof(OPEN_CONFIG_ACK));
+    bad_length[4] = 0x09;
+    memcpy(zero_length, OPEN_CONFIG_ACK, sizeof(OPEN_CONFIG_ACK));
+    zero_length[4] = 0x00;
+
+    // Size not matching the length field
+    uint8_t trailing[sizeof(CLOSE_CONFIG_ACK) + 1] = {0};
+    memcpy(trailing, CLOSE_CONFIG_ACK, sizeof(CLOSE_CONFIG_ACK));
+
+    // Frames need no alignment
+    uint8_t shifted[sizeof(OPEN_CONFIG_ACK) + 1];
+    memcpy(shifted + 1, OPEN_CONFIG_ACK, sizeof(OPEN_CONFIG_ACK));
+
+    const uint8_t *const frames[BATCH_FRAMES] = {
+        OPEN_CONFIG_ACK, CLOSE_CONFIG_ACK, bad_header, bad_footer, bad_length,
+        zero_length, OPEN_CONFIG_ACK, shifted + 1, trailing};
+    const uint8_t sizes[BATCH_FRAMES] = {
+        sizeof(OPEN_CONFIG_ACK), sizeof(CLOSE_CONFIG_ACK), sizeof(bad_header), sizeof(bad_footer),
+        sizeof(bad_length), sizeof(zero_length), 12, sizeof(OPEN_CONFIG_ACK), sizeof(trailing)};
+
+    const ld2420_rx_batch_t out = {statuses, frame_sizes, cmd_echoes, device_statuses, param_names, param_values};
+    size_t valid = 0;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_parse_rx_batch(frames, sizes, BATCH_FRAMES, &out, &valid));
+    TEST_ASSERT_EQUAL(3, valid);
+
+    for (size_t i = 0; i < BATCH_FRAMES; i++)
+    {
+        uint16_t frame_size = 0, cmd_echo = 0, status = 0, param_name = 0, param_value = 0;
+        ld2420_status_t expected = ld2420_parse_rx_buffer(frames[i], sizes[i], &frame_size, &cmd_echo, &status,
+                                                          &param_name, &param_value);
+        TEST_ASSERT_EQUAL(expected, statuses[i]);
+        if (expected == LD2420_STATUS_OK)
+        {
+            TEST_ASSERT_EQUAL_UINT16(frame_size, frame_sizes[i]);
+            TEST_ASSERT_EQUAL_UINT16(cmd_echo, cmd_echoes[i]);
+            TEST_ASSERT_EQUAL_UINT16(status, device_statuses[i]);
+            TEST_ASSERT_EQUAL_UINT16(param_name, param_names[i]);
+            TEST_ASSERT_EQUAL_UINT16(param_value, param_values[i]);
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL_UINT16(0, frame_sizes[i]);
+            TEST_ASSERT_EQUAL_UINT16(0, cmd_echoes[i]);
+        }
+    }
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_HEADER, statuses[2]);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FOOTER, statuses[3]);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_BUFFER_SIZE, statuses[4]);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FRAME_SIZE, statuses[5]);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_BUFFER_SIZE, statuses[6]);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_BUFFER_SIZE, statuses[8]);
+    TEST_ASSERT_EQUAL_UINT16(0xFE, cmd_echoes[1]);
+    TEST_ASSERT_EQUAL_UINT16(0x01, device_statuses[1]);
+    TEST_ASSERT_EQUAL_UINT16(0x0020, param_values[7]);
+}
+
+void test__batch_optional_columns_and_arguments(void)
+{
+    const uint8_t *frames[2] = {OPEN_CONFIG_ACK, NULL};
+    const uint8_t sizes[2] = {sizeof(OPEN_CONFIG_ACK), sizeof(OPEN_CONFIG_ACK)};
+
+    // Parameter columns are optional
+    ld2420_rx_batch_t out = {statuses, frame_sizes, cmd_echoes, device_statuses, NULL, NULL};
+    size_t valid = 0;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_parse_rx_batch(frames, sizes, 2, &out, &valid));
+    TEST_ASSERT_EQUAL(1, valid);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, statuses[0]);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_BUFFER, statuses[1]);
+    TEST_ASSERT_EQUAL_UINT16(0xAAAA, param_names[0]);
+
+    // Missing required columns are rejected before anything is written
+    setUp();
+    out.cmd_echo = NULL;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_parse_rx_batch(frames, sizes, 2, &out, &valid));
+    TEST_ASSERT_EQUAL(0, valid);
+    TEST_ASSERT_EQUAL_UINT16(0xAAAA, frame_sizes[0]);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_parse_rx_batch(NULL, sizes, 2, &out, NULL));
+
+    // An empty batch needs no arrays
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_parse_rx_batch(NULL, NULL, 0, NULL, &valid));
+}
+
+#define REPORT_FRAMES 27u
+
+static uint8_t report_frames[REPORT_FRAMES][LD2420_REPORT_ENERGY_SIZE + 1];
+static uint8_t presence_column[REPORT_FRAMES];
+static uint16_t distance_column[REPORT_FRAMES];
+static uint16_t energy_columns[LD2420_REPORT_GATES][REPORT_FRAMES];
+static float energy_f32_columns[LD2420_REPORT_GATES][REPORT_FRAMES];
+
+void test__report_batch_transposes_gates_into_columns(void)
+{
+    // 27 frames: three blocks of eight and a scalar tail; odd frames are
+    // misaligned by one byte
+    const uint8_t *frames[REPORT_FRAMES];
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < REPORT_FRAMES; i++)
+    {
+        ld2420_report_energy_t report = {.presence = (uint8_t)(i & 1u), .distance_cm = (uint16_t)(100u + 7u * i)};
+        for (unsigned g = 0; g < LD2420_REPORT_GATES; g++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            report.energy[g] = (uint16_t)(seed >> 8);
+        }
+        uint8_t *frame = &report_frames[i][i & 1u];
+        TEST_ASSERT_EQUAL_UINT(LD2420_REPORT_ENERGY_SIZE, ld2420_report_energy_encode(frame, &report));
+        frames[i] = frame;
+    }
+
+    ld2420_report_batch_t out = {.presence = presence_column, .distance_cm = distance_column, .energy_scale = 0.5f};
+    for (unsigned g = 0; g < LD2420_REPORT_GATES; g++)
+    {
+        out.energy[g] = energy_columns[g];
+        out.energy_f32[g] = energy_f32_columns[g];
+    }
+    // A column nobody asked for is not written
+    out.energy[3] = NULL;
+    memset(energy_columns[3], 0xAA, sizeof(energy_columns[3]));
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_decode_report_batch(frames, REPORT_FRAMES, &out));
+
+    for (size_t i = 0; i < REPORT_FRAMES; i++)
+    {
+        ld2420_report_energy_t expected;
+        TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_report_energy_decode(frames[i], LD2420_REPORT_ENERGY_SIZE, &expected));
+        TEST_ASSERT_EQUAL_UINT8(expected.presence, presence_column[i]);
+        TEST_ASSERT_EQUAL_UINT16(expected.distance_cm, distance_column[i]);
+        for (unsigned g = 0; g < LD2420_REPORT_GATES; g++)
+        {
+            if (g != 3)
+                TEST_ASSERT_EQUAL_UINT16(expected.energy[g], energy_columns[g][i]);
+            TEST_ASSERT_EQUAL_FLOAT((float)expected.energy[g] * 0.5f, energy_f32_columns[g][i]);
+        }
+        TEST_ASSERT_EQUAL_UINT16(0xAAAA, energy_columns[3][i]);
+    }
+}
+
+void test__report_batch_rejects_missing_frames(void)
+{
+    const uint8_t *frames[2] = {report_frames[0], NULL};
+    ld2420_report_batch_t out = {.distance_cm = distance_column, .energy_scale = 1.0f};
+    distance_column[0] = 0xAAAA;
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_decode_report_batch(frames, 2, &out));
+    TEST_ASSERT_EQUAL_UINT16(0xAAAA, distance_column[0]);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_decode_report_batch(frames, 1, NULL));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_decode_report_batch(NULL, 0, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test__batch_matches_one_shot_parser_per_frame);
+    RUN_TEST(test__batch_optional_columns_and_arguments);
+    RUN_TEST(test__report_batch_transposes_gates_into_columns);
+    RUN_TEST(test__report_batch_rejects_missing_frames);
+    return UNITY_END();
+}
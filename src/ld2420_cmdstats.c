@@ -0,0 +1,197 @@
+/*
+ * LD2420 command round-trip statistics implementation
+ *
+ * Design Principles
+ * -----------------
+ * 1. Waiting commands are matched by the queue shared with the correlator
+ *    (ld2420_pending_t in ld2420_internal.h); this file only records what
+ *    became of each command
+ * 2. Constant work per command and ACK: a scan of at most
+ *    LD2420_CMDSTATS_MAX_PENDING waiting commands, a slot lookup and a
+ *    histogram bucket found by shifting
+ *
+ * Memory & Threading
+ * ------------------
+ * - No dynamic allocation; the statistics are caller-provided
+ * - Not thread-safe; a sender on several threads serializes the calls
+ */
+
+#include <ld2420/ld2420_cmdstats.h>
+#include <ld2420/ld2420_protocol.h>
+#include "ld2420_internal.h"
+
+
+/** Round trips below this fall in bucket 0; each further bucket doubles. */
+#define BUCKET0_LIMIT_SHIFT 10u
+
+LD2420_PROTOCOL_STATIC_CHECK(cmdstats_pending, LD2420_CMDSTATS_MAX_PENDING >= 1u &&
+                                                   LD2420_CMDSTATS_MAX_PENDING <= UINT8_MAX);
+LD2420_PROTOCOL_STATIC_CHECK(cmdstats_buckets, BUCKET0_LIMIT_SHIFT + LD2420_CMDSTATS_BUCKETS <= 32u);
+
+ld2420_status_t ld2420_cmdstats_init(ld2420_cmdstats_t *s, uint32_t timeout_us)
+{
+    if (s == NULL || timeout_us == 0 || timeout_us > (uint32_t)INT32_MAX)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    ld2420_set_bytes(s, 0, sizeof(*s));
+    s->timeout_us = timeout_us;
+    return LD2420_STATUS_OK;
+}
+
+uint8_t ld2420_cmdstats_slot(uint16_t command)
+{
+    switch (command)
+    {
+    case LD2420_CMD_OPEN_CONFIG_MODE:
+        return 0;
+    case LD2420_CMD_CLOSE_CONFIG_MODE:
+        return 1;
+    case LD2420_CMD_READ_VERSION_NUMBER:
+        return 2;
+    case LD2420_CMD_REBOOT:
+        return 3;
+    case LD2420_CMD_READ_CONFIG:
+        return 4;
+    case LD2420_CMD_SET_CONFIG:
+        return 5;
+    default:
+        return LD2420_CMDSTATS_COMMANDS - 1u;
+    }
+}
+
+static uint8_t bucket_of(uint32_t rtt_us)
+{
+    uint8_t b = 0;
+    rtt_us >>= BUCKET0_LIMIT_SHIFT;
+    while (rtt_us != 0 && b < LD2420_CMDSTATS_BUCKETS - 1u)
+    {
+        rtt_us >>= 1;
+        b++;
+    }
+    return b;
+}
+
+/** Record the outcome of a command that stopped waiting. */
+static void record(
+    void *owner,
+    uint16_t command,
+    uint32_t sent_us,
+    ld2420_pending_outcome_t outcome,
+    uint16_t status,
+    uint32_t now_us)
+{
+    ld2420_cmdstats_t *s = (ld2420_cmdstats_t *)owner;
+    ld2420_cmdstats_command_t *c = &s->commands[ld2420_cmdstats_slot(command)];
+    switch (outcome)
+    {
+    case LD2420_PENDING_ANSWERED:
+    {
+        const uint32_t rtt_us = now_us - sent_us;
+        c->answered++;
+        c->failed += status != 0 ? 1u : 0u;
+        c->sum_rtt_us += rtt_us;
+        if (rtt_us > c->max_rtt_us)
+            c->max_rtt_us = rtt_us;
+        c->histogram[bucket_of(rtt_us)]++;
+        break;
+    }
+    case LD2420_PENDING_TIMED_OUT:
+        c->timeouts++;
+        break;
+    case LD2420_PENDING_SUPERSEDED:
+        c->superseded++;
+        break;
+    }
+}
+
+static ld2420_pending_t pending_of(ld2420_cmdstats_t *s)
+{
+    const ld2420_pending_t p = {
+        .command = s->pending_command,
+        .time_us = s->pending_time_us,
+        .count = &s->pending_count,
+        .capacity = LD2420_CMDSTATS_MAX_PENDING,
+        .timeout_us = s->timeout_us,
+        .sink = record,
+        .owner = s,
+    };
+    return p;
+}
+
+void ld2420_cmdstats_advance(ld2420_cmdstats_t *s, uint32_t now_us)
+{
+    if (s == NULL)
+        return;
+    const ld2420_pending_t p = pending_of(s);
+    ld2420_pending_advance(&p, now_us);
+}
+
+void ld2420_cmdstats_sent(ld2420_cmdstats_t *s, uint16_t command, uint32_t now_us)
+{
+    if (s == NULL)
+        return;
+    const ld2420_pending_t p = pending_of(s);
+    ld2420_pending_sent(&p, command, now_us);
+    if (s->pending_count > s->max_pending)
+        s->max_pending = s->pending_count;
+    s->commands[ld2420_cmdstats_slot(command)].sent++;
+}
+
+void ld2420_cmdstats_ack(ld2420_cmdstats_t *s, uint16_t echo, uint16_t status, uint32_t now_us)
+{
+    if (s == NULL)
+        return;
+    const ld2420_pending_t p = pending_of(s);
+    if (!ld2420_pending_ack(&p, echo, status, now_us))
+        s->orphan_acks++;
+}
+
+bool ld2420_cmdstats_frame(ld2420_cmdstats_t *s, const uint8_t *frame, uint16_t size, uint32_t now_us)
+{
+    if (s == NULL || frame == NULL || size < LD2420_PROTOCOL_ACK_MIN_SIZE || size > LD2420_PROTOCOL_ACK_MAX_SIZE ||
+        ld2420_protocol_read_le32(frame) != LD2420_PROTOCOL_COMMAND_HEADER)
+        return false;
+    const uint16_t echo = ld2420_protocol_read_le16(frame + LD2420_ACK_CMD_ECHO_OFFSET);
+    if ((echo & 0xFF00u) != LD2420_PROTOCOL_ACK_ECHO_FLAG ||
+        !ld2420_protocol_ack_length_valid((uint8_t)echo, (uint16_t)(size - LD2420_PROTOCOL_FRAME_OVERHEAD)))
+        return false;
+    ld2420_cmdstats_ack(s, echo, ld2420_protocol_read_le16(frame + LD2420_ACK_STATUS_OFFSET), now_us);
+    return true;
+}
+
+void ld2420_cmdstats_expire(ld2420_cmdstats_t *s)
+{
+    if (s == NULL)
+        return;
+    const ld2420_pending_t p = pending_of(s);
+    ld2420_pending_expire(&p);
+}
+
+const ld2420_cmdstats_command_t *ld2420_cmdstats_get(const ld2420_cmdstats_t *s, uint16_t command)
+{
+    if (s == NULL)
+        return NULL;
+    return &s->commands[ld2420_cmdstats_slot(command)];
+}
+
+uint32_t ld2420_cmdstats_percentile_us(const ld2420_cmdstats_command_t *c, uint16_t permille)
+{
+    if (c == NULL || c->answered == 0)
+        return 0;
+    if (permille > 1000u)
+        permille = 1000u;
+
+    // First bucket by which permille of the answered commands are in; no division,
+    // so 32-bit targets need no 64-bit helper from the C runtime
+    const uint64_t target = (uint64_t)c->answered * permille;
+    uint64_t seen = 0;
+    for (uint8_t b = 0; b < LD2420_CMDSTATS_BUCKETS - 1u; b++)
+    {
+        seen += c->histogram[b];
+        if (seen > 0 && seen * 1000u >= target)
+        {
+            const uint32_t upper = (uint32_t)1u << (BUCKET0_LIMIT_SHIFT + b);
+            return c->max_rtt_us < upper ? c->max_rtt_us : upper;
+        }
+    }
+    return c->max_rtt_us;
+}
@@ -0,0 +1,165 @@
+#include <unity.h>
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/ld2420_cmdstats.h>
+
+#define TIMEOUT_US 100000u
+#define ECHO(cmd) ((uint16_t)((cmd) | LD2420_PROTOCOL_ACK_ECHO_FLAG))
+
+static ld2420_cmdstats_t stats;
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_cmdstats_init(&stats, TIMEOUT_US));
+}
+
+void tearDown(void)
+{
+}
+
+void test__cmdstats_records_round_trips_per_command_in_log2_buckets(void)
+{
+    ld2420_cmdstats_sent(&stats, LD2420_CMD_OPEN_CONFIG_MODE, 1000);
+    ld2420_cmdstats_ack(&stats, ECHO(LD2420_CMD_OPEN_CONFIG_MODE), 0, 1500);
+    ld2420_cmdstats_sent(&stats, LD2420_CMD_READ_CONFIG, 2000);
+    ld2420_cmdstats_ack(&stats, ECHO(LD2420_CMD_READ_CONFIG), 1, 2000 + 3000);
+
+    const ld2420_cmdstats_command_t *open = ld2420_cmdstats_get(&stats, LD2420_CMD_OPEN_CONFIG_MODE);
+    TEST_ASSERT_EQUAL_UINT32(1, open->sent);
+    TEST_ASSERT_EQUAL_UINT32(1, open->answered);
+    TEST_ASSERT_EQUAL_UINT32(0, open->failed);
+    TEST_ASSERT_EQUAL_UINT32(500, open->max_rtt_us);
+    TEST_ASSERT_EQUAL_UINT32(1, open->histogram[0]);
+
+    // 3000 us lies in [2048, 4096): bucket 2
+    const ld2420_cmdstats_command_t *read = ld2420_cmdstats_get(&stats, LD2420_CMD_READ_CONFIG);
+    TEST_ASSERT_EQUAL_UINT32(1, read->answered);
+    TEST_ASSERT_EQUAL_UINT32(1, read->failed);
+    TEST_ASSERT_EQUAL_UINT64(3000, read->sum_rtt_us);
+    TEST_ASSERT_EQUAL_UINT32(1, read->histogram[2]);
+    TEST_ASSERT_EQUAL_UINT8(1, stats.max_pending);
+
+    // Unknown ids share the last slot
+    TEST_ASSERT_EQUAL_UINT8(LD2420_CMDSTATS_COMMANDS - 1u, ld2420_cmdstats_slot(0x42));
+    TEST_ASSERT_TRUE(ld2420_cmdstats_get(&stats, 0x42) == &stats.commands[LD2420_CMDSTATS_COMMANDS - 1u]);
+}
+
+void test__cmdstats_gives_up_older_commands_retries_and_timeouts(void)
+{
+    // Pipelined commands; the ACK of the second one means the first got none
+    ld2420_cmdstats_sent(&stats, LD2420_CMD_READ_VERSION_NUMBER, 0);
+    ld2420_cmdstats_sent(&stats, LD2420_CMD_READ_CONFIG, 10);
+    ld2420_cmdstats_ack(&stats, ECHO(LD2420_CMD_READ_CONFIG), 0, 900);
+    TEST_ASSERT_EQUAL_UINT32(1, ld2420_cmdstats_get(&stats, LD2420_CMD_READ_VERSION_NUMBER)->superseded);
+    TEST_ASSERT_EQUAL_UINT32(1, ld2420_cmdstats_get(&stats, LD2420_CMD_READ_CONFIG)->answered);
+    TEST_ASSERT_EQUAL_UINT8(2, stats.max_pending);
+
+    // A retry replaces the first attempt; the ACK is timed from the retry
+    ld2420_cmdstats_sent(&stats, LD2420_CMD_SET_CONFIG, 1000);
+    ld2420_cmdstats_sent(&stats, LD2420_CMD_SET_CONFIG, 5000);
+    ld2420_cmdstats_ack(&stats, ECHO(LD2420_CMD_SET_CONFIG), 0, 5100);
+    const ld2420_cmdstats_command_t *set = ld2420_cmdstats_get(&stats, LD2420_CMD_SET_CONFIG);
+    TEST_ASSERT_EQUAL_UINT32(2, set->sent);
+    TEST_ASSERT_EQUAL_UINT32(1, set->superseded);
+    TEST_ASSERT_EQUAL_UINT32(100, set->max_rtt_us);
+
+    // A command unanswered past the timeout, also across a clock wrap
+    const uint32_t t0 = UINT32_MAX - 10u;
+    ld2420_cmdstats_sent(&stats, LD2420_CMD_REBOOT, t0);
+    ld2420_cmdstats_advance(&stats, t0 + TIMEOUT_US);
+    TEST_ASSERT_EQUAL_UINT8(1, stats.pending_count);
+    ld2420_cmdstats_advance(&stats, t0 + TIMEOUT_US + 1u);
+    TEST_ASSERT_EQUAL_UINT32(1, ld2420_cmdstats_get(&stats, LD2420_CMD_REBOOT)->timeouts);
+    TEST_ASSERT_EQUAL_UINT8(0, stats.pending_count);
+
+    // Its late ACK, and an ACK without the echo flag, match nothing
+    ld2420_cmdstats_ack(&stats, ECHO(LD2420_CMD_REBOOT), 0, t0 + TIMEOUT_US + 2u);
+    ld2420_cmdstats_sent(&stats, LD2420_CMD_REBOOT, 0);
+    ld2420_cmdstats_ack(&stats, LD2420_CMD_REBOOT, 0, 1);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.orphan_acks);
+}
+
+void test__cmdstats_gives_up_the_oldest_command_when_the_queue_is_full(void)
+{
+    const uint16_t ids[] = {LD2420_CMD_OPEN_CONFIG_MODE, LD2420_CMD_READ_VERSION_NUMBER, LD2420_CMD_READ_CONFIG,
+                            LD2420_CMD_SET_CONFIG, LD2420_CMD_CLOSE_CONFIG_MODE};
+    for (uint32_t i = 0; i < sizeof(ids) / sizeof(ids[0]); i++)
+        ld2420_cmdstats_sent(&stats, ids[i], i);
+    TEST_ASSERT_EQUAL_UINT8(LD2420_CMDSTATS_MAX_PENDING, stats.pending_count);
+    TEST_ASSERT_EQUAL_UINT8(LD2420_CMDSTATS_MAX_PENDING, stats.max_pending);
+    TEST_ASSERT_EQUAL_UINT32(1, ld2420_cmdstats_get(&stats, LD2420_CMD_OPEN_CONFIG_MODE)->superseded);
+
+    // A sender giving up on its own deadline times out everything still waiting
+    ld2420_cmdstats_expire(&stats);
+    TEST_ASSERT_EQUAL_UINT8(0, stats.pending_count);
+    TEST_ASSERT_EQUAL_UINT32(1, ld2420_cmdstats_get(&stats, LD2420_CMD_CLOSE_CONFIG_MODE)->timeouts);
+    TEST_ASSERT_EQUAL_UINT32(0, ld2420_cmdstats_get(&stats, LD2420_CMD_OPEN_CONFIG_MODE)->timeouts);
+}
+
+void test__cmdstats_takes_acks_from_received_frames_and_ignores_the_rest(void)
+{
+    uint8_t frame[LD2420_MAX_RX_PACKET_SIZE];
+    ld2420_cmdstats_sent(&stats, LD2420_CMD_OPEN_CONFIG_MODE, 0);
+    ld2420_cmdstats_sent(&stats, LD2420_CMD_SET_CONFIG, 100);
+
+    // A report and a command echoed back without the ACK flag leave both waiting
+    const ld2420_report_energy_t report = {.presence = 1, .distance_cm = 120};
+    TEST_ASSERT_FALSE(ld2420_cmdstats_frame(&stats, frame, ld2420_report_energy_encode(frame, &report), 200));
+    const ld2420_command_open_config_mode_t open_cmd = {.protocol_version = 1};
+    TEST_ASSERT_FALSE(
+        ld2420_cmdstats_frame(&stats, frame, ld2420_command_open_config_mode_encode(frame, &open_cmd), 200));
+    TEST_ASSERT_EQUAL_UINT8(2, stats.pending_count);
+
+    // An ACK whose frame is cut short is not one
+    const ld2420_ack_set_config_t set_ack = {.status = 1};
+    const uint16_t set_size = ld2420_ack_set_config_encode(frame, &set_ack);
+    TEST_ASSERT_FALSE(ld2420_cmdstats_frame(&stats, frame, (uint16_t)(set_size - 1u), 300));
+    TEST_ASSERT_TRUE(ld2420_cmdstats_frame(&stats, frame, set_size, 400));
+    TEST_ASSERT_EQUAL_UINT32(1, ld2420_cmdstats_get(&stats, LD2420_CMD_OPEN_CONFIG_MODE)->superseded);
+    TEST_ASSERT_EQUAL_UINT32(1, ld2420_cmdstats_get(&stats, LD2420_CMD_SET_CONFIG)->failed);
+    TEST_ASSERT_EQUAL_UINT32(300, ld2420_cmdstats_get(&stats, LD2420_CMD_SET_CONFIG)->max_rtt_us);
+    TEST_ASSERT_FALSE(ld2420_cmdstats_frame(NULL, frame, set_size, 400));
+}
+
+void test__cmdstats_percentiles_are_bucket_bounds_capped_by_the_maximum(void)
+{
+    // 98 round trips of 700 us, one of 3000 us and one of 20 s
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_cmdstats_init(&stats, (uint32_t)INT32_MAX));
+    for (uint32_t i = 0; i < 98u; i++)
+    {
+        ld2420_cmdstats_sent(&stats, LD2420_CMD_READ_CONFIG, 0);
+        ld2420_cmdstats_ack(&stats, ECHO(LD2420_CMD_READ_CONFIG), 0, 700);
+    }
+    ld2420_cmdstats_sent(&stats, LD2420_CMD_READ_CONFIG, 0);
+    ld2420_cmdstats_ack(&stats, ECHO(LD2420_CMD_READ_CONFIG), 0, 3000);
+    ld2420_cmdstats_sent(&stats, LD2420_CMD_READ_CONFIG, 0);
+    ld2420_cmdstats_ack(&stats, ECHO(LD2420_CMD_READ_CONFIG), 0, 20000000u);
+
+    const ld2420_cmdstats_command_t *c = ld2420_cmdstats_get(&stats, LD2420_CMD_READ_CONFIG);
+    TEST_ASSERT_EQUAL_UINT32(1, c->histogram[LD2420_CMDSTATS_BUCKETS - 1u]);
+    TEST_ASSERT_EQUAL_UINT32(1024, ld2420_cmdstats_percentile_us(c, 500));
+    TEST_ASSERT_EQUAL_UINT32(1024, ld2420_cmdstats_percentile_us(c, 980));
+    TEST_ASSERT_EQUAL_UINT32(4096, ld2420_cmdstats_percentile_us(c, 990));
+    TEST_ASSERT_EQUAL_UINT32(20000000u, ld2420_cmdstats_percentile_us(c, 1000));
+
+    // A bound above the largest round trip is the largest round trip
+    TEST_ASSERT_EQUAL_UINT32(0, ld2420_cmdstats_percentile_us(ld2420_cmdstats_get(&stats, LD2420_CMD_REBOOT), 990));
+    ld2420_cmdstats_sent(&stats, LD2420_CMD_REBOOT, 0);
+    ld2420_cmdstats_ack(&stats, ECHO(LD2420_CMD_REBOOT), 0, 300);
+    TEST_ASSERT_EQUAL_UINT32(300, ld2420_cmdstats_percentile_us(ld2420_cmdstats_get(&stats, LD2420_CMD_REBOOT), 990));
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_cmdstats_init(NULL, TIMEOUT_US));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_cmdstats_init(&stats, 0));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_cmdstats_init(&stats, UINT32_MAX));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test__cmdstats_records_round_trips_per_command_in_log2_buckets);
+    RUN_TEST(test__cmdstats_gives_up_older_commands_retries_and_timeouts);
+    RUN_TEST(test__cmdstats_gives_up_the_oldest_command_when_the_queue_is_full);
+    RUN_TEST(test__cmdstats_takes_acks_from_received_frames_and_ignores_the_rest);
+    RUN_TEST(test__cmdstats_percentiles_are_bucket_bounds_capped_by_the_maximum);
+    return UNITY_END();
+}
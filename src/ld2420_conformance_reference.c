@@ -0,0 +1,53 @@
+/*
+ * Reference variant of the core parsers for ld2420_conformance_test.
+ *
+ * Design Principles
+ * -----------------
+ * - The same sources as ld2420_core, included here under ld2420_reference_*
+ *   names so both variants link into one test binary
+ * - Headers and footers compared by memcmp(), bytes copied and moved by the C
+ *   library: the straightforward build the optimized core must agree with
+ *
+ * Memory & Threading
+ * ------------------
+ * - As the core; the reference has its own work counter
+ */
+
+#undef LD2420_FREESTANDING
+#define LD2420_REFERENCE_LIBC
+
+#define ld2420_work_bytes_examined ld2420_reference_work_bytes_examined
+#define ld2420_parse_rx_buffer ld2420_reference_parse_rx_buffer
+#define ld2420_stream_init ld2420_reference_stream_init
+#define ld2420_stream_feed ld2420_reference_stream_feed
+#define ld2420_stream_feed_bytes ld2420_reference_stream_feed_bytes
+#define ld2420_stream_snapshot ld2420_reference_stream_snapshot
+#define ld2420_stream_restore ld2420_reference_stream_restore
+#define ld2420_parse_rx_batch ld2420_reference_parse_rx_batch
+#define ld2420_decode_report_batch ld2420_reference_decode_report_batch
+#define ld2420_uplink_encode ld2420_reference_uplink_encode
+#define ld2420_uplink_decoder_init ld2420_reference_uplink_decoder_init
+#define ld2420_uplink_decode ld2420_reference_uplink_decode
+#define ld2420_uplink_writer_init ld2420_reference_uplink_writer_init
+#define ld2420_uplink_writer_flush ld2420_reference_uplink_writer_flush
+#define ld2420_uplink_writer_append ld2420_reference_uplink_writer_append
+
+#include "ld2420.c"
+#include "ld2420_stream.c"
+#include "ld2420_batch.c"
+#include "ld2420_uplink.c"
+
+#include "ld2420_conformance_reference.h"
+
+const ld2420_conformance_parsers_t ld2420_conformance_reference = {
+    .parse_rx_buffer = ld2420_parse_rx_buffer,
+    .stream_init = ld2420_stream_init,
+    .stream_feed = ld2420_stream_feed,
+    .stream_feed_bytes = ld2420_stream_feed_bytes,
+    .stream_snapshot = ld2420_stream_snapshot,
+    .stream_restore = ld2420_stream_restore,
+    .parse_rx_batch = ld2420_parse_rx_batch,
+    .uplink_encode = ld2420_uplink_encode,
+    .uplink_decoder_init = ld2420_uplink_decoder_init,
+    .uplink_decode = ld2420_uplink_decode,
+};
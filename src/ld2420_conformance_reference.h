@@ -0,0 +1,42 @@
+#pragma once
+/*
+ * Reference variant of the core parsers for ld2420_conformance_test.
+ *
+ * ld2420_conformance_reference.c compiles the one-shot, streaming, batch and
+ * uplink sources a second time into the test, with LD2420_REFERENCE_LIBC
+ * (headers and footers compared by memcmp()) and always with memcpy(),
+ * memmove() and memset(), whatever options ld2420_core was built with. The
+ * test runs the same capture through both and compares the results.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_batch.h>
+#include <ld2420/ld2420_stream.h>
+#include <ld2420/ld2420_uplink.h>
+
+/** The parser entry points the conformance test drives. */
+typedef struct
+{
+    ld2420_status_t (*parse_rx_buffer)(const uint8_t *buffer, const uint8_t size, uint16_t *frame_size,
+                                       uint16_t *cmd_echo, uint16_t *status, uint16_t *name, uint16_t *value);
+    void (*stream_init)(ld2420_stream_t *s);
+    ld2420_status_t (*stream_feed)(ld2420_stream_t *s, const uint8_t *data, size_t len,
+                                   ld2420_stream_on_frame_fn on_frame);
+    ld2420_status_t (*stream_feed_bytes)(ld2420_stream_t *s, const uint8_t *data, size_t len,
+                                         ld2420_stream_on_frame_fn on_frame, size_t *out_consumed);
+    ld2420_status_t (*stream_snapshot)(const ld2420_stream_t *s, uint8_t *out, size_t out_size, size_t *out_written);
+    ld2420_status_t (*stream_restore)(ld2420_stream_t *s, const uint8_t *in, size_t in_size);
+    ld2420_status_t (*parse_rx_batch)(const uint8_t *const *frames, const uint8_t *frame_sizes, size_t count,
+                                      const ld2420_rx_batch_t *out, size_t *out_valid);
+    ld2420_status_t (*uplink_encode)(const ld2420_uplink_record_t *record, uint8_t *out, size_t out_size,
+                                     size_t *out_written);
+    void (*uplink_decoder_init)(ld2420_uplink_decoder_t *d);
+    ld2420_status_t (*uplink_decode)(ld2420_uplink_decoder_t *d, const uint8_t *data, size_t len,
+                                     ld2420_uplink_on_record_fn on_record, void *user, size_t *out_consumed);
+} ld2420_conformance_parsers_t;
+
+/** The reference variant, from ld2420_conformance_reference.c. */
+extern const ld2420_conformance_parsers_t ld2420_conformance_reference;
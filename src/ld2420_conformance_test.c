@@ -0,0 +1,439 @@
+#include <unity.h>
+#include <string.h>
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/ld2420_stream.h>
+#include <ld2420/ld2420_batch.h>
+#include <ld2420/ld2420_uplink.h>
+
+#include "ld2420_internal.h"
+#include "ld2420_conformance_reference.h"
+
+/*
+ * Conformance of the core across builds.
+ *
+ * A fixed pseudo-random capture (valid, damaged and truncated frames of both
+ * families, at every alignment, between line noise) goes through each parser
+ * that compares frame headers and footers or moves buffered bytes. Every
+ * status, frame and field is folded into a digest per parser, once through
+ * ld2420_core and once through the reference variant compiled into this test
+ * (ld2420_conformance_reference.h), and the two must agree. The constants
+ * below pin the reference results as well: DIGEST_STREAM and
+ * DIGEST_STREAM_BYTEWISE were re-recorded when the stream parser started
+ * matching the ACK echo flag, the others date from the memcmp()/memmove()
+ * build of the core.
+ */
+
+#define CAPTURE_SIZE 65536u
+
+#define DIGEST_ONE_SHOT 0x5B735EFB206D28A1ull
+#define DIGEST_STREAM 0x712CD29F7843A8DCull
+#define DIGEST_STREAM_BYTEWISE 0xB7D7DD38A3146D15ull
+#define DIGEST_BATCH 0x41FD4DDD8BECDD02ull
+#define DIGEST_UPLINK 0x43997826B4DB864Bull
+
+static uint8_t capture[CAPTURE_SIZE];
+static size_t capture_size;
+static uint32_t rng_state;
+static uint32_t rng_after_capture;
+static uint64_t digest;
+static uint32_t frames;
+
+static const ld2420_conformance_parsers_t core = {
+    .parse_rx_buffer = ld2420_parse_rx_buffer,
+    .stream_init = ld2420_stream_init,
+    .stream_feed = ld2420_stream_feed,
+    .stream_feed_bytes = ld2420_stream_feed_bytes,
+    .stream_snapshot = ld2420_stream_snapshot,
+    .stream_restore = ld2420_stream_restore,
+    .parse_rx_batch = ld2420_parse_rx_batch,
+    .uplink_encode = ld2420_uplink_encode,
+    .uplink_decoder_init = ld2420_uplink_decoder_init,
+    .uplink_decode = ld2420_uplink_decode,
+};
+
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void mix(uint64_t value)
+{
+    // FNV-1a over the eight bytes of value
+    for (uint32_t k = 0; k < 8u; k++)
+    {
+        digest ^= (uint8_t)(value >> (8u * k));
+        digest *= 0x100000001B3ull;
+    }
+}
+
+static void mix_bytes(const uint8_t *data, size_t len)
+{
+    mix(len);
+    for (size_t i = 0; i < len; i++)
+        mix(data[i]);
+}
+
+/** One frame (or piece of one) at the end of the capture. */
+static void append_frame(void)
+{
+    uint8_t frame[LD2420_MAX_RX_PACKET_SIZE];
+    uint16_t size;
+    switch (rng() % 5u)
+    {
+    case 0:
+    {
+        ld2420_ack_close_config_mode_t msg = {.status = (uint16_t)(rng() % 3u)};
+        size = ld2420_ack_close_config_mode_encode(frame, &msg);
+        break;
+    }
+    case 1:
+    {
+        ld2420_ack_set_config_t msg = {.status = (uint16_t)(rng() % 3u)};
+        size = ld2420_ack_set_config_encode(frame, &msg);
+        break;
+    }
+    case 2:
+    {
+        ld2420_ack_read_config_t msg = {.status = 0, .values_count = (uint16_t)(1u + rng() % 8u)};
+        for (uint32_t i = 0; i < msg.values_count; i++)
+            msg.values[i] = rng();
+        size = ld2420_ack_read_config_encode(frame, &msg);
+        break;
+    }
+    case 3:
+    {
+        ld2420_report_energy_t msg = {.presence = (uint8_t)(rng() & 1u), .distance_cm = (uint16_t)rng()};
+        for (uint32_t g = 0; g < LD2420_REPORT_GATES; g++)
+            msg.energy[g] = (uint16_t)rng();
+        size = ld2420_report_energy_encode(frame, &msg);
+        break;
+    }
+    default:
+    {
+        // A command-family frame of any plausible length and echo
+        size = (uint16_t)(LD2420_MIN_RX_PACKET_SIZE + rng() % (LD2420_MAX_RX_PACKET_SIZE - LD2420_MIN_RX_PACKET_SIZE + 1u));
+        ld2420_protocol_write_le32(frame, LD2420_PROTOCOL_COMMAND_HEADER);
+        ld2420_protocol_write_le16(frame + LD2420_PROTOCOL_LENGTH_OFFSET, (uint16_t)(size - LD2420_PROTOCOL_FRAME_OVERHEAD));
+        for (uint16_t i = LD2420_PROTOCOL_PAYLOAD_OFFSET; i < size - 4u; i++)
+            frame[i] = (uint8_t)rng();
+        frame[LD2420_ACK_CMD_ECHO_OFFSET + 1u] = 0x01;
+        ld2420_protocol_write_le32(frame + size - 4u, LD2420_PROTOCOL_COMMAND_FOOTER);
+        break;
+    }
+    }
+
+    // Damage one in four: a header, length or footer byte, or the tail
+    switch (rng() % 16u)
+    {
+    case 0:
+        frame[rng() % 4u] ^= (uint8_t)(1u << (rng() % 8u));
+        break;
+    case 1:
+        frame[LD2420_PROTOCOL_LENGTH_OFFSET + rng() % 2u] ^= (uint8_t)(1u << (rng() % 8u));
+        break;
+    case 2:
+        frame[size - 1u - rng() % 4u] ^= (uint8_t)(1u << (rng() % 8u));
+        break;
+    case 3:
+        size = (uint16_t)(rng() % size);
+        break;
+    default:
+        break;
+    }
+
+    if (capture_size + size <= sizeof(capture))
+    {
+        memcpy(&capture[capture_size], frame, size);
+        capture_size += size;
+    }
+}
+
+static void build_capture(uint32_t seed)
+{
+    rng_state = seed;
+    capture_size = 0;
+    while (capture_size + LD2420_MAX_RX_PACKET_SIZE + 8u <= sizeof(capture))
+    {
+        // Noise, sometimes with partial headers, so frames start at every alignment
+        const uint32_t noise = rng() % 8u;
+        for (uint32_t i = 0; i < noise; i++)
+            capture[capture_size++] = (rng() % 4u) == 0 ? LD2420_BEG_COMMAND_PACKET[rng() % 4u] : (uint8_t)rng();
+        append_frame();
+    }
+}
+
+/** Start a run: fresh digest and the random sequence that follows the capture. */
+static void begin_run(void)
+{
+    rng_state = rng_after_capture;
+    digest = 0xCBF29CE484222325ull;
+    frames = 0;
+}
+
+void setUp(void)
+{
+    build_capture(0xC0FFEEu);
+    rng_after_capture = rng_state;
+}
+
+void tearDown(void)
+{
+}
+
+static uint64_t run_one_shot(const ld2420_conformance_parsers_t *p)
+{
+    // Every window that starts at a header byte and ends at a plausible frame end
+    begin_run();
+    uint16_t frame_size, cmd_echo, status, name, value;
+    for (size_t start = 0; start + LD2420_MIN_RX_PACKET_SIZE <= capture_size; start++)
+    {
+        if (capture[start] != LD2420_BEG_COMMAND_PACKET[0] && start % 61u != 0)
+            continue;
+        for (size_t size = LD2420_MIN_RX_PACKET_SIZE; size <= LD2420_MAX_RX_PACKET_SIZE && start + size <= capture_size;
+             size++)
+        {
+            frame_size = cmd_echo = status = name = value = 0;
+            const ld2420_status_t st =
+                p->parse_rx_buffer(&capture[start], (uint8_t)size, &frame_size, &cmd_echo, &status, &name, &value);
+            mix((uint64_t)st);
+            if (st == LD2420_STATUS_OK)
+            {
+                mix(frame_size);
+                mix(cmd_echo);
+                mix(status);
+                mix(name);
+                mix(value);
+            }
+        }
+    }
+    return digest;
+}
+
+void test__one_shot_parser_matches_the_reference_build(void)
+{
+    const uint64_t reference = run_one_shot(&ld2420_conformance_reference);
+    TEST_ASSERT_EQUAL_UINT64(reference, run_one_shot(&core));
+    TEST_ASSERT_EQUAL_UINT64(DIGEST_ONE_SHOT, reference);
+}
+
+static bool on_stream_frame(const uint8_t *frame, uint16_t frame_size_bytes, uint16_t cmd_echo, uint16_t status)
+{
+    mix_bytes(frame, frame_size_bytes);
+    mix(cmd_echo);
+    mix(status);
+    frames++;
+    return true;
+}
+
+static uint64_t run_stream(const ld2420_conformance_parsers_t *p)
+{
+    // Random chunks, with the state moved through a snapshot after every chunk
+    static ld2420_stream_t s;
+    static uint8_t snapshot[LD2420_STREAM_SNAPSHOT_MAX_SIZE];
+    begin_run();
+    p->stream_init(&s);
+    for (size_t offset = 0; offset < capture_size;)
+    {
+        size_t chunk = 1u + rng() % 300u;
+        if (chunk > capture_size - offset)
+            chunk = capture_size - offset;
+        size_t consumed = 0;
+        mix((uint64_t)p->stream_feed_bytes(&s, &capture[offset], chunk, on_stream_frame, &consumed));
+        TEST_ASSERT_EQUAL_size_t(chunk, consumed);
+        offset += chunk;
+
+        size_t written = 0;
+        TEST_ASSERT_EQUAL(LD2420_STATUS_OK, p->stream_snapshot(&s, snapshot, sizeof(snapshot), &written));
+        mix_bytes(snapshot, written);
+        p->stream_init(&s);
+        TEST_ASSERT_EQUAL(LD2420_STATUS_OK, p->stream_restore(&s, snapshot, written));
+    }
+    // The capture is only useful if plenty of frames survive it
+    TEST_ASSERT_GREATER_THAN(500, frames);
+    return digest;
+}
+
+static uint64_t run_stream_bytewise(const ld2420_conformance_parsers_t *p)
+{
+    static ld2420_stream_t s;
+    begin_run();
+    p->stream_init(&s);
+    for (size_t i = 0; i < capture_size; i++)
+        mix((uint64_t)p->stream_feed(&s, &capture[i], 1, on_stream_frame));
+    return digest;
+}
+
+void test__stream_parser_matches_the_reference_build(void)
+{
+    uint64_t reference = run_stream(&ld2420_conformance_reference);
+    TEST_ASSERT_EQUAL_UINT64(reference, run_stream(&core));
+    TEST_ASSERT_EQUAL_UINT64(DIGEST_STREAM, reference);
+
+    reference = run_stream_bytewise(&ld2420_conformance_reference);
+    TEST_ASSERT_EQUAL_UINT64(reference, run_stream_bytewise(&core));
+    TEST_ASSERT_EQUAL_UINT64(DIGEST_STREAM_BYTEWISE, reference);
+}
+
+static uint64_t run_batch(const ld2420_conformance_parsers_t *p)
+{
+    // Windows at every offset, sized by their length field where there is one
+    enum
+    {
+        BATCH = 512
+    };
+    static const uint8_t *frames[BATCH];
+    static uint8_t sizes[BATCH];
+    static ld2420_status_t statuses[BATCH];
+    static uint16_t frame_size[BATCH], cmd_echo[BATCH], device_status[BATCH], name[BATCH], value[BATCH];
+    const ld2420_rx_batch_t out = {statuses, frame_size, cmd_echo, device_status, name, value};
+
+    begin_run();
+    size_t count = 0;
+    for (size_t start = 0; start + LD2420_MAX_RX_PACKET_SIZE <= capture_size; start++)
+    {
+        size_t size = LD2420_PROTOCOL_FRAME_OVERHEAD +
+                      ld2420_protocol_read_le16(&capture[start + LD2420_PROTOCOL_LENGTH_OFFSET]);
+        if (size > LD2420_MAX_RX_PACKET_SIZE)
+            size = LD2420_MIN_RX_PACKET_SIZE + start % 16u;
+        frames[count] = &capture[start];
+        sizes[count] = (uint8_t)size;
+        if (++count == BATCH)
+        {
+            size_t valid = 0;
+            TEST_ASSERT_EQUAL(LD2420_STATUS_OK, p->parse_rx_batch(frames, sizes, count, &out, &valid));
+            mix(valid);
+            for (size_t i = 0; i < count; i++)
+            {
+                mix((uint64_t)statuses[i]);
+                mix(frame_size[i]);
+                mix(cmd_echo[i]);
+                mix(device_status[i]);
+                mix(name[i]);
+                mix(value[i]);
+            }
+            count = 0;
+        }
+    }
+    return digest;
+}
+
+void test__batch_parser_matches_the_reference_build(void)
+{
+    const uint64_t reference = run_batch(&ld2420_conformance_reference);
+    TEST_ASSERT_EQUAL_UINT64(reference, run_batch(&core));
+    TEST_ASSERT_EQUAL_UINT64(DIGEST_BATCH, reference);
+}
+
+static bool on_uplink_record(void *user, const ld2420_uplink_record_t *record)
+{
+    (void)user;
+    mix(record->sensor_id);
+    mix(record->kind);
+    mix(record->sequence);
+    mix(record->timestamp_us);
+    mix_bytes(record->payload, record->payload_size);
+    return true;
+}
+
+static uint64_t run_uplink(const ld2420_conformance_parsers_t *p)
+{
+    // The capture cut into records, some of them damaged, decoded in random chunks
+    static uint8_t link[2u * CAPTURE_SIZE];
+    begin_run();
+    size_t link_size = 0;
+    uint8_t sequence = 0;
+    for (size_t offset = 0; offset < capture_size;)
+    {
+        size_t payload = 1u + rng() % LD2420_UPLINK_MAX_PAYLOAD;
+        if (payload > capture_size - offset)
+            payload = capture_size - offset;
+        const ld2420_uplink_record_t record = {
+            .sensor_id = (uint8_t)(rng() % 4u),
+            .kind = LD2420_UPLINK_KIND_BYTES,
+            .sequence = sequence,
+            .timestamp_us = rng(),
+            .payload = &capture[offset],
+            .payload_size = (uint16_t)payload,
+        };
+        size_t written = 0;
+        TEST_ASSERT_EQUAL(LD2420_STATUS_OK,
+                          p->uplink_encode(&record, &link[link_size], sizeof(link) - link_size, &written));
+        if (rng() % 8u == 0)
+            link[link_size + rng() % written] ^= 0x10;
+        link_size += written;
+        offset += payload;
+        sequence = (uint8_t)(sequence + 1u + (rng() % 16u == 0));
+    }
+
+    static ld2420_uplink_decoder_t d;
+    p->uplink_decoder_init(&d);
+    for (size_t offset = 0; offset < link_size;)
+    {
+        size_t chunk = 1u + rng() % 700u;
+        if (chunk > link_size - offset)
+            chunk = link_size - offset;
+        size_t consumed = 0;
+        mix((uint64_t)p->uplink_decode(&d, &link[offset], chunk, on_uplink_record, NULL, &consumed));
+        mix(consumed);
+        offset += chunk;
+    }
+    mix(d.records);
+    mix(d.corrupt_records);
+    mix(d.lost_records);
+    return digest;
+}
+
+void test__uplink_decoder_matches_the_reference_build(void)
+{
+    const uint64_t reference = run_uplink(&ld2420_conformance_reference);
+    TEST_ASSERT_EQUAL_UINT64(reference, run_uplink(&core));
+    TEST_ASSERT_EQUAL_UINT64(DIGEST_UPLINK, reference);
+}
+
+void test__word_compare_agrees_with_memcmp_at_every_alignment(void)
+{
+    uint8_t buffer[16];
+    for (uint32_t offset = 0; offset + 4u <= sizeof(buffer); offset++)
+    {
+        for (uint32_t k = 0; k < 4u; k++)
+        {
+            for (uint32_t value = 0; value < 256u; value++)
+            {
+                memset(buffer, 0xAA, sizeof(buffer));
+                memcpy(&buffer[offset], LD2420_END_COMMAND_PACKET, 4);
+                buffer[offset + k] = (uint8_t)value;
+                TEST_ASSERT_EQUAL(memcmp(&buffer[offset], LD2420_END_COMMAND_PACKET, 4) == 0,
+                                  ld2420_word_equal(&buffer[offset], LD2420_END_COMMAND_PACKET));
+            }
+        }
+    }
+
+    // Overlapping moves in both directions
+    for (uint32_t from = 0; from < 8u; from++)
+    {
+        for (uint32_t to = 0; to < 8u; to++)
+        {
+            uint8_t expected[16], actual[16];
+            for (uint32_t i = 0; i < 16u; i++)
+                expected[i] = actual[i] = (uint8_t)i;
+            memmove(&expected[to], &expected[from], 8);
+            ld2420_move_bytes(&actual[to], &actual[from], 8);
+            TEST_ASSERT_EQUAL_MEMORY(expected, actual, sizeof(expected));
+        }
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test__one_shot_parser_matches_the_reference_build);
+    RUN_TEST(test__stream_parser_matches_the_reference_build);
+    RUN_TEST(test__batch_parser_matches_the_reference_build);
+    RUN_TEST(test__uplink_decoder_matches_the_reference_build);
+    RUN_TEST(test__word_compare_agrees_with_memcmp_at_every_alignment);
+    return UNITY_END();
+}
@@ -0,0 +1,154 @@
+/*
+ * LD2420 interrupt-context framer implementation
+ *
+ * Design Principles
+ * -----------------
+ * 1. Constant work per byte. Searching compares a 32-bit window against two
+ *    headers; assembling stores the byte, and the length and footer checks
+ *    happen once per frame, on the byte that makes them possible
+ * 2. Frames are assembled where the consumer reads them. Publishing passes a
+ *    slot index, never frame bytes
+ * 3. The producer owns slot `published & SLOT_MASK`, the consumer
+ *    owns the slots from `released` up to `published`. Each side writes only
+ *    its own counter, with a barrier between filling or reading a slot and
+ *    moving the counter
+ *
+ * Memory & Threading
+ * ------------------
+ * - No dynamic allocation; state is caller-provided
+ * - One producer (interrupt or thread) and one consumer. The producer calls
+ *   ld2420_framer_push() and ld2420_framer_publish(), the consumer
+ *   ld2420_framer_peek() and ld2420_framer_release()
+ */
+
+#include <ld2420/ld2420_framer.h>
+#include <ld2420/ld2420_protocol.h>
+#include "ld2420_internal.h"
+
+
+/**
+ * Memory barrier between a slot's contents and the counter that hands it over.
+ * Defaults to a full barrier on GCC and Clang (a DMB on Cortex-M); define it
+ * for other compilers.
+ */
+#ifndef LD2420_FRAMER_BARRIER
+#if defined(__GNUC__) || defined(__clang__)
+#define LD2420_FRAMER_BARRIER() __sync_synchronize()
+#else
+#define LD2420_FRAMER_BARRIER() ((void)0)
+#endif
+#endif
+
+/** Slot of a counter value; the counters wrap, so the slot count must divide 2^32. */
+#define SLOT_MASK (LD2420_FRAMER_SLOTS - 1u)
+
+LD2420_PROTOCOL_STATIC_CHECK(framer_slots, LD2420_FRAMER_SLOTS >= 2u);
+LD2420_PROTOCOL_STATIC_CHECK(framer_slots_power_of_two, (LD2420_FRAMER_SLOTS & SLOT_MASK) == 0u);
+LD2420_PROTOCOL_STATIC_CHECK(framer_slot_size, LD2420_PROTOCOL_ACK_MAX_SIZE <= LD2420_MAX_RX_PACKET_SIZE &&
+                                                   LD2420_PROTOCOL_REPORT_MAX_SIZE <= LD2420_MAX_RX_PACKET_SIZE);
+
+ld2420_status_t ld2420_framer_init(ld2420_framer_t *framer)
+{
+    if (framer == NULL)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    ld2420_set_bytes(framer, 0, sizeof(*framer));
+    return LD2420_STATUS_OK;
+}
+
+const uint8_t *ld2420_framer_push(ld2420_framer_t *framer, uint8_t byte, uint16_t *out_size)
+{
+    uint8_t *frame = framer->slots[framer->published & SLOT_MASK];
+    framer->complete = false;
+
+    if (framer->len == 0)
+    {
+        // The window holds the last four bytes as a little-endian word
+        framer->window = framer->window >> 8 | (uint32_t)byte << 24;
+        if (framer->window == LD2420_PROTOCOL_COMMAND_HEADER)
+        {
+            framer->footer = LD2420_PROTOCOL_COMMAND_FOOTER;
+            framer->max_len = LD2420_PROTOCOL_ACK_MAX_SIZE;
+        }
+        else if (framer->window == LD2420_PROTOCOL_REPORT_HEADER)
+        {
+            framer->footer = LD2420_PROTOCOL_REPORT_FOOTER;
+            framer->max_len = LD2420_PROTOCOL_REPORT_MAX_SIZE;
+        }
+        else
+        {
+            return NULL;
+        }
+        ld2420_protocol_write_le32(frame, framer->window);
+        framer->len = 4;
+        framer->expected_len = 0;
+        framer->window = 0;
+        return NULL;
+    }
+
+    frame[framer->len++] = byte;
+    if (framer->len == LD2420_PROTOCOL_PAYLOAD_OFFSET)
+    {
+        framer->expected_len = (uint16_t)(LD2420_PROTOCOL_FRAME_OVERHEAD +
+                                          ld2420_protocol_read_le16(frame + LD2420_PROTOCOL_LENGTH_OFFSET));
+        if (framer->expected_len > framer->max_len)
+        {
+            framer->errors++;
+            framer->len = 0;
+        }
+        return NULL;
+    }
+    if (framer->len != framer->expected_len)
+        return NULL;
+
+    const uint16_t size = framer->len;
+    framer->len = 0;
+    if (ld2420_protocol_read_le32(frame + size - 4u) != framer->footer)
+    {
+        framer->errors++;
+        return NULL;
+    }
+    framer->sizes[framer->published & SLOT_MASK] = size;
+    framer->complete = true;
+    framer->frames++;
+    *out_size = size;
+    return frame;
+}
+
+bool ld2420_framer_publish(ld2420_framer_t *framer)
+{
+    if (framer == NULL || !framer->complete)
+        return false;
+    framer->complete = false;
+
+    // One slot always stays with the producer for the next frame
+    const uint32_t published = framer->published;
+    if (published - framer->released >= LD2420_FRAMER_SLOTS - 1u)
+    {
+        framer->dropped_frames++;
+        return false;
+    }
+    LD2420_FRAMER_BARRIER();
+    framer->published = published + 1u;
+    return true;
+}
+
+const uint8_t *ld2420_framer_peek(const ld2420_framer_t *framer, uint16_t *out_size)
+{
+    if (framer == NULL || out_size == NULL)
+        return NULL;
+    const uint32_t released = framer->released;
+    if (framer->published == released)
+        return NULL;
+    LD2420_FRAMER_BARRIER();
+    const uint32_t slot = released & SLOT_MASK;
+    *out_size = framer->sizes[slot];
+    return framer->slots[slot];
+}
+
+void ld2420_framer_release(ld2420_framer_t *framer)
+{
+    if (framer == NULL || framer->published == framer->released)
+        return;
+    LD2420_FRAMER_BARRIER();
+    framer->released++;
+}
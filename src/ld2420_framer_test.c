@@ -0,0 +1,173 @@
+#include <unity.h>
+#include <string.h>
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/ld2420_framer.h>
+
+static ld2420_framer_t framer;
+
+static const uint8_t OPEN_CONFIG_ACK[] = {0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01, 0x00,
+                                          0x00, 0x02, 0x00, 0x20, 0x00, 0x04, 0x03, 0x02, 0x01};
+
+static void report(uint8_t *frame, uint16_t distance_cm)
+{
+    ld2420_report_energy_t msg = {.presence = 1, .distance_cm = distance_cm};
+    for (int g = 0; g < 16; g++)
+        msg.energy[g] = (uint16_t)(distance_cm + g);
+    ld2420_report_energy_encode(frame, &msg);
+}
+
+/** Push bytes and publish every completed frame; returns the number of frames completed. */
+static uint32_t push_all(const uint8_t *data, size_t len)
+{
+    uint32_t frames = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        uint16_t size = 0;
+        if (ld2420_framer_push(&framer, data[i], &size) != NULL)
+        {
+            ld2420_framer_publish(&framer);
+            frames++;
+        }
+    }
+    return frames;
+}
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_framer_init(&framer));
+}
+
+void tearDown(void)
+{
+}
+
+void test__framer_returns_frames_of_both_families_in_the_byte_that_completes_them(void)
+{
+    uint8_t frame[LD2420_REPORT_ENERGY_SIZE];
+    report(frame, 120);
+
+    uint16_t size = 0;
+    for (size_t i = 0; i + 1 < sizeof(frame); i++)
+        TEST_ASSERT_NULL(ld2420_framer_push(&framer, frame[i], &size));
+    const uint8_t *got = ld2420_framer_push(&framer, frame[sizeof(frame) - 1], &size);
+    TEST_ASSERT_NOT_NULL(got);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(frame), size);
+    TEST_ASSERT_EQUAL_MEMORY(frame, got, sizeof(frame));
+    TEST_ASSERT_TRUE(ld2420_framer_publish(&framer));
+
+    // Noise before an ACK is skipped
+    const uint8_t noise[] = {0x00, 0xFD, 0xFC, 0x11, 0xF4, 0xF3};
+    TEST_ASSERT_EQUAL_UINT32(0, push_all(noise, sizeof(noise)));
+    TEST_ASSERT_EQUAL_UINT32(0, framer.published - 1u - framer.released);
+    size = 0;
+    for (size_t i = 0; i < sizeof(OPEN_CONFIG_ACK); i++)
+        got = ld2420_framer_push(&framer, OPEN_CONFIG_ACK[i], &size);
+    TEST_ASSERT_NOT_NULL(got);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(OPEN_CONFIG_ACK), size);
+    TEST_ASSERT_EQUAL_MEMORY(OPEN_CONFIG_ACK, got, sizeof(OPEN_CONFIG_ACK));
+    TEST_ASSERT_EQUAL_UINT32(2, framer.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, framer.errors);
+}
+
+void test__framer_hands_published_frames_to_the_consumer_in_order(void)
+{
+    uint8_t frame[LD2420_REPORT_ENERGY_SIZE];
+    uint16_t size;
+    for (uint16_t seq = 0; seq < 100; seq++)
+    {
+        report(frame, seq);
+        TEST_ASSERT_EQUAL_UINT32(1, push_all(frame, sizeof(frame)));
+
+        const uint8_t *got = ld2420_framer_peek(&framer, &size);
+        TEST_ASSERT_NOT_NULL(got);
+        TEST_ASSERT_EQUAL_UINT16(sizeof(frame), size);
+        TEST_ASSERT_EQUAL_MEMORY(frame, got, sizeof(frame));
+        ld2420_framer_release(&framer);
+        TEST_ASSERT_NULL(ld2420_framer_peek(&framer, &size));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, framer.dropped_frames);
+}
+
+void test__framer_drops_frames_while_the_consumer_holds_every_other_slot(void)
+{
+    uint8_t first[LD2420_REPORT_ENERGY_SIZE], frame[LD2420_REPORT_ENERGY_SIZE];
+    uint16_t size;
+    report(first, 1);
+    push_all(first, sizeof(first));
+    for (uint32_t k = 2; k < LD2420_FRAMER_SLOTS; k++)
+    {
+        report(frame, (uint16_t)k);
+        push_all(frame, sizeof(frame));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, framer.dropped_frames);
+
+    // The producer keeps assembling into its own slot; held frames stay intact
+    for (uint16_t seq = 500; seq < 510; seq++)
+    {
+        report(frame, seq);
+        TEST_ASSERT_EQUAL_UINT32(1, push_all(frame, sizeof(frame)));
+    }
+    TEST_ASSERT_EQUAL_UINT32(10, framer.dropped_frames);
+    const uint8_t *got = ld2420_framer_peek(&framer, &size);
+    TEST_ASSERT_EQUAL_MEMORY(first, got, sizeof(first));
+
+    // Once a slot is free again, publishing works
+    ld2420_framer_release(&framer);
+    report(frame, 600);
+    push_all(frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_UINT32(10, framer.dropped_frames);
+    for (uint32_t k = 2; k < LD2420_FRAMER_SLOTS; k++)
+        ld2420_framer_release(&framer);
+    got = ld2420_framer_peek(&framer, &size);
+    TEST_ASSERT_EQUAL_MEMORY(frame, got, sizeof(frame));
+}
+
+void test__framer_resyncs_after_bad_length_and_footer(void)
+{
+    uint8_t frame[LD2420_REPORT_ENERGY_SIZE];
+    report(frame, 77);
+
+    // A report header with an ACK-sized length, then a report with a broken footer
+    const uint8_t too_long[] = {0xF4, 0xF3, 0xF2, 0xF1, 0x80, 0x00};
+    TEST_ASSERT_EQUAL_UINT32(0, push_all(too_long, sizeof(too_long)));
+    TEST_ASSERT_EQUAL_UINT32(1, framer.errors);
+    frame[sizeof(frame) - 1] ^= 0xFF;
+    TEST_ASSERT_EQUAL_UINT32(0, push_all(frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_UINT32(2, framer.errors);
+
+    frame[sizeof(frame) - 1] ^= 0xFF;
+    TEST_ASSERT_EQUAL_UINT32(1, push_all(frame, sizeof(frame)));
+    uint16_t size;
+    TEST_ASSERT_EQUAL_MEMORY(frame, ld2420_framer_peek(&framer, &size), sizeof(frame));
+}
+
+void test__framer_publish_needs_a_completed_frame(void)
+{
+    uint16_t size;
+    TEST_ASSERT_FALSE(ld2420_framer_publish(&framer));
+    TEST_ASSERT_NULL(ld2420_framer_peek(&framer, &size));
+    ld2420_framer_release(&framer);
+    TEST_ASSERT_EQUAL_UINT32(0, framer.released);
+
+    // A frame not published before the next byte is not kept
+    for (size_t i = 0; i < sizeof(OPEN_CONFIG_ACK); i++)
+        ld2420_framer_push(&framer, OPEN_CONFIG_ACK[i], &size);
+    ld2420_framer_push(&framer, 0x00, &size);
+    TEST_ASSERT_FALSE(ld2420_framer_publish(&framer));
+    TEST_ASSERT_NULL(ld2420_framer_peek(&framer, &size));
+    TEST_ASSERT_EQUAL_UINT32(0, framer.dropped_frames);
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_framer_init(NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test__framer_returns_frames_of_both_families_in_the_byte_that_completes_them);
+    RUN_TEST(test__framer_hands_published_frames_to_the_consumer_in_order);
+    RUN_TEST(test__framer_drops_frames_while_the_consumer_holds_every_other_slot);
+    RUN_TEST(test__framer_resyncs_after_bad_length_and_footer);
+    RUN_TEST(test__framer_publish_needs_a_completed_frame);
+    return UNITY_END();
+}
@@ -0,0 +1,219 @@
+#pragma once
+/*
+ * Private helpers shared by the core translation units. Not installed and not
+ * part of the public API.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ld2420/ld2420_protocol.h>
+
+/**
+ * Work accounting for fuzzing and performance regression checks.
+ *
+ * When LD2420_WORK_COUNTERS is defined, every header/footer compare, buffer
+ * scan and buffer move adds the number of bytes it touches to
+ * ld2420_work_bytes_examined. Otherwise the macro compiles to nothing.
+ */
+#ifdef LD2420_WORK_COUNTERS
+#define LD2420_COUNT_WORK(bytes) (ld2420_work_bytes_examined += (uint64_t)(bytes))
+#else
+#define LD2420_COUNT_WORK(bytes) ((void)0)
+#endif
+
+/**
+ * Byte copies and word compares without the C library.
+ *
+ * Headers and footers are four bytes and are compared as one 32-bit word
+ * loaded from any address: through __builtin_memcpy on GCC and Clang, which
+ * becomes a single load where the target allows unaligned ones and never a
+ * library call, byte by byte elsewhere. Both operands are loaded the same way,
+ * so the result is that of memcmp() == 0 whatever the byte order.
+ *
+ * With LD2420_FREESTANDING (CMake option LD2420_CORE_FREESTANDING) copies,
+ * moves and fills are plain loops as well and the core needs no C library;
+ * otherwise they are memcpy(), memmove() and memset().
+ *
+ * LD2420_REFERENCE_LIBC compares with memcmp() instead. Only the reference
+ * variant of the parsers built into ld2420_conformance_test defines it.
+ */
+#ifndef LD2420_FREESTANDING
+#include <string.h>
+#endif
+
+static inline uint32_t ld2420_load_word(const uint8_t *p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    uint32_t w;
+    __builtin_memcpy(&w, p, sizeof(w));
+    return w;
+#else
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+#endif
+}
+
+/** Whether the four bytes at a and b are equal. */
+static inline int ld2420_word_equal(const uint8_t *a, const uint8_t *b)
+{
+#ifdef LD2420_REFERENCE_LIBC
+    return memcmp(a, b, 4) == 0;
+#else
+    return ld2420_load_word(a) == ld2420_load_word(b);
+#endif
+}
+
+static inline void ld2420_copy_bytes(void *dst, const void *src, size_t n)
+{
+#ifdef LD2420_FREESTANDING
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+    for (size_t i = 0; i < n; i++)
+        d[i] = s[i];
+#else
+    memcpy(dst, src, n);
+#endif
+}
+
+/** Copy between overlapping ranges. */
+static inline void ld2420_move_bytes(void *dst, const void *src, size_t n)
+{
+#ifdef LD2420_FREESTANDING
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+    if (d < s)
+    {
+        for (size_t i = 0; i < n; i++)
+            d[i] = s[i];
+    }
+    else
+    {
+        for (size_t i = n; i > 0; i--)
+            d[i - 1] = s[i - 1];
+    }
+#else
+    memmove(dst, src, n);
+#endif
+}
+
+static inline void ld2420_set_bytes(void *dst, uint8_t value, size_t n)
+{
+#ifdef LD2420_FREESTANDING
+    uint8_t *d = (uint8_t *)dst;
+    for (size_t i = 0; i < n; i++)
+        d[i] = value;
+#else
+    memset(dst, value, n);
+#endif
+}
+
+/**
+ * Commands waiting for their ACK, matched the way the sensor answers: one
+ * command at a time and in order. Shared by the sniff correlator and the
+ * command statistics, which keep the queue in their public structs and differ
+ * only in what they record for a finished command.
+ *
+ * - An ACK answers the oldest waiting command with the echoed id; every older
+ *   one got no answer and is superseded. An ACK without the echo flag or with
+ *   no waiting command matches nothing.
+ * - A retry supersedes the attempt still waiting, and a full queue its oldest
+ *   command.
+ * - A command waiting longer than timeout_us times out.
+ *
+ * Every finished command is removed first and then handed to the sink.
+ */
+typedef enum
+{
+    LD2420_PENDING_ANSWERED,
+    LD2420_PENDING_TIMED_OUT,
+    LD2420_PENDING_SUPERSEDED,
+} ld2420_pending_outcome_t;
+
+/** Outcome of one waiting command; status is that of the ACK when answered. */
+typedef void (*ld2420_pending_sink_fn)(
+    void *owner,
+    uint16_t command,
+    uint32_t sent_us,
+    ld2420_pending_outcome_t outcome,
+    uint16_t status,
+    uint32_t now_us);
+
+/** View of an owner's queue, oldest command first. */
+typedef struct
+{
+    uint16_t *command;
+    uint32_t *time_us;
+    uint8_t *count;
+    uint8_t capacity;
+    uint32_t timeout_us;
+    ld2420_pending_sink_fn sink;
+    void *owner;
+} ld2420_pending_t;
+
+static inline void ld2420_pending_finish(
+    const ld2420_pending_t *p,
+    uint8_t k,
+    ld2420_pending_outcome_t outcome,
+    uint16_t status,
+    uint32_t now_us)
+{
+    const uint16_t command = p->command[k];
+    const uint32_t sent_us = p->time_us[k];
+    const uint8_t count = --*p->count;
+    ld2420_move_bytes(&p->command[k], &p->command[k + 1u], (size_t)(count - k) * sizeof(uint16_t));
+    ld2420_move_bytes(&p->time_us[k], &p->time_us[k + 1u], (size_t)(count - k) * sizeof(uint32_t));
+    p->sink(p->owner, command, sent_us, outcome, status, now_us);
+}
+
+/** Time out the commands that waited longer than timeout_us at now_us. */
+static inline void ld2420_pending_advance(const ld2420_pending_t *p, uint32_t now_us)
+{
+    while (*p->count > 0 && (int32_t)(now_us - p->time_us[0]) > (int32_t)p->timeout_us)
+        ld2420_pending_finish(p, 0, LD2420_PENDING_TIMED_OUT, 0, now_us);
+}
+
+/** Queue a command sent at now_us. */
+static inline void ld2420_pending_sent(const ld2420_pending_t *p, uint16_t command, uint32_t now_us)
+{
+    ld2420_pending_advance(p, now_us);
+    for (uint8_t k = 0; k < *p->count; k++)
+    {
+        if (p->command[k] == command)
+        {
+            ld2420_pending_finish(p, k, LD2420_PENDING_SUPERSEDED, 0, now_us);
+            break;
+        }
+    }
+    if (*p->count == p->capacity)
+        ld2420_pending_finish(p, 0, LD2420_PENDING_SUPERSEDED, 0, now_us);
+
+    p->command[*p->count] = command;
+    p->time_us[*p->count] = now_us;
+    ++*p->count;
+}
+
+/** Match an ACK received at now_us. Returns false when it matched nothing. */
+static inline bool ld2420_pending_ack(const ld2420_pending_t *p, uint16_t echo, uint16_t status, uint32_t now_us)
+{
+    ld2420_pending_advance(p, now_us);
+
+    const uint16_t command = (uint16_t)(echo & ~LD2420_PROTOCOL_ACK_ECHO_FLAG);
+    uint8_t match = 0;
+    while (match < *p->count && p->command[match] != command)
+        match++;
+    if ((echo & LD2420_PROTOCOL_ACK_ECHO_FLAG) == 0 || match == *p->count)
+        return false;
+
+    for (; match > 0; match--)
+        ld2420_pending_finish(p, 0, LD2420_PENDING_SUPERSEDED, 0, now_us);
+    ld2420_pending_finish(p, 0, LD2420_PENDING_ANSWERED, status, now_us);
+    return true;
+}
+
+/** Time out every waiting command; now_us is its own send time. */
+static inline void ld2420_pending_expire(const ld2420_pending_t *p)
+{
+    while (*p->count > 0)
+        ld2420_pending_finish(p, 0, LD2420_PENDING_TIMED_OUT, 0, p->time_us[0]);
+}
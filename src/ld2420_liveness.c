@@ -0,0 +1,296 @@
+/*
+ * LD2420 liveness monitor implementation
+ *
+ * Design Principles
+ * -----------------
+ * 1. Frames and errors touch only the sensor's own entry: a time store and
+ *    two counters. The wheel is not modified on the hot path
+ * 2. Deadlines are checked lazily. A sensor sits in the bucket of the
+ *    deadline it had when it was last scheduled; when that bucket comes due
+ *    and the sensor has sent frames since, it moves to the bucket of its
+ *    current deadline instead of raising an alert
+ * 3. Buckets are addressed by a running tick number rather than by time, so
+ *    the wheel keeps working when the millisecond clock wraps. Deadlines
+ *    further out than one turn go to the last bucket of the turn and are
+ *    rescheduled from there
+ * 4. Silent sensors leave the wheel; their next frame puts them back
+ *
+ * Memory & Threading
+ * ------------------
+ * - No dynamic allocation; sensor table and buckets belong to the caller
+ * - Not thread-safe; use one monitor per thread
+ */
+
+#include <ld2420/ld2420_liveness.h>
+
+/** True once `now` has reached `t`, across clock wraps. */
+static inline bool time_reached(uint32_t now, uint32_t t)
+{
+    return (int32_t)(now - t) >= 0;
+}
+
+static inline uint32_t silence_deadline(const ld2420_liveness_t *m, const ld2420_liveness_sensor_t *s)
+{
+    return s->last_frame_ms + s->interval_ms * m->config.silence_intervals;
+}
+
+static void unlink_sensor(ld2420_liveness_t *m, uint32_t idx)
+{
+    ld2420_liveness_sensor_t *s = &m->sensors[idx];
+    if (s->bucket == LD2420_LIVENESS_NONE)
+        return;
+
+    if (s->prev != LD2420_LIVENESS_NONE)
+        m->sensors[s->prev].next = s->next;
+    else
+        m->buckets[s->bucket] = s->next;
+    if (s->next != LD2420_LIVENESS_NONE)
+        m->sensors[s->next].prev = s->prev;
+    s->next = s->prev = s->bucket = LD2420_LIVENESS_NONE;
+}
+
+/** Put a sensor into the bucket that comes due at (or just after) due_ms. */
+static void schedule(ld2420_liveness_t *m, uint32_t idx, uint32_t due_ms)
+{
+    unlink_sensor(m, idx);
+
+    uint32_t delta = 0;
+    if (!time_reached(m->tick_due_ms, due_ms))
+    {
+        delta = (due_ms - m->tick_due_ms + m->tick_ms - 1u) / m->tick_ms;
+        if (delta > m->bucket_mask)
+            delta = m->bucket_mask;
+    }
+
+    ld2420_liveness_sensor_t *s = &m->sensors[idx];
+    const uint32_t bucket = (m->tick + delta) & m->bucket_mask;
+    s->bucket = bucket;
+    s->prev = LD2420_LIVENESS_NONE;
+    s->next = m->buckets[bucket];
+    if (s->next != LD2420_LIVENESS_NONE)
+        m->sensors[s->next].prev = idx;
+    m->buckets[bucket] = idx;
+}
+
+static void notify(ld2420_liveness_t *m, uint32_t idx, ld2420_liveness_condition_t condition, bool raised, uint32_t now_ms)
+{
+    ld2420_liveness_sensor_t *s = &m->sensors[idx];
+    if (raised)
+        s->conditions |= (uint8_t)condition;
+    else
+        s->conditions &= (uint8_t)~condition;
+    if (m->alert != NULL)
+        m->alert(m->user, idx, condition, raised, now_ms);
+}
+
+static bool window_degraded(const ld2420_liveness_t *m, const ld2420_liveness_sensor_t *s)
+{
+    const uint32_t errors = s->window_errors;
+    return errors >= m->config.degraded_min_errors &&
+           errors * 1000u >= (uint32_t)m->config.degraded_permille * (errors + s->window_frames);
+}
+
+/** Start a new error window once the current one is over; a clean window clears DEGRADED. */
+static void roll_window(ld2420_liveness_t *m, uint32_t idx, uint32_t now_ms)
+{
+    ld2420_liveness_sensor_t *s = &m->sensors[idx];
+    if (!time_reached(now_ms, s->window_start_ms + m->config.window_ms))
+        return;
+
+    if ((s->conditions & LD2420_LIVENESS_DEGRADED) && !window_degraded(m, s))
+        notify(m, idx, LD2420_LIVENESS_DEGRADED, false, now_ms);
+    s->window_start_ms = now_ms;
+    s->window_frames = 0;
+    s->window_errors = 0;
+}
+
+static void raise_silent(ld2420_liveness_t *m, uint32_t idx, uint32_t now_ms)
+{
+    ld2420_liveness_sensor_t *s = &m->sensors[idx];
+    notify(m, idx, LD2420_LIVENESS_SILENT, true, now_ms);
+
+    if (s->flap_count > 0 && !time_reached(now_ms, s->last_silence_ms + m->config.flap_window_ms))
+    {
+        if (s->flap_count < UINT8_MAX)
+            s->flap_count++;
+    }
+    else
+        s->flap_count = 1;
+    s->last_silence_ms = now_ms;
+
+    if (m->config.flap_threshold > 0 && s->flap_count >= m->config.flap_threshold &&
+        !(s->conditions & LD2420_LIVENESS_FLAPPING))
+        notify(m, idx, LD2420_LIVENESS_FLAPPING, true, now_ms);
+}
+
+/** A sensor's bucket came due. */
+static void visit(ld2420_liveness_t *m, uint32_t idx, uint32_t now_ms)
+{
+    ld2420_liveness_sensor_t *s = &m->sensors[idx];
+    roll_window(m, idx, now_ms);
+    if ((s->conditions & LD2420_LIVENESS_FLAPPING) &&
+        time_reached(now_ms, s->last_silence_ms + m->config.flap_window_ms))
+        notify(m, idx, LD2420_LIVENESS_FLAPPING, false, now_ms);
+
+    const uint32_t deadline = silence_deadline(m, s);
+    if (time_reached(now_ms, deadline))
+        raise_silent(m, idx, now_ms);
+    else
+        schedule(m, idx, deadline);
+}
+
+void ld2420_liveness_default_config(ld2420_liveness_config_t *config)
+{
+    if (config == NULL)
+        return;
+    config->silence_intervals = 5;
+    config->degraded_permille = 50;
+    config->degraded_min_errors = 5;
+    config->flap_threshold = 3;
+    config->window_ms = 10000;
+    config->flap_window_ms = 60000;
+}
+
+ld2420_status_t ld2420_liveness_init(
+    ld2420_liveness_t *m,
+    ld2420_liveness_sensor_t *sensors,
+    uint32_t sensor_count,
+    uint32_t *buckets,
+    uint32_t bucket_count,
+    uint32_t tick_ms,
+    const ld2420_liveness_config_t *config,
+    ld2420_liveness_alert_fn alert,
+    void *user,
+    uint32_t now_ms)
+{
+    if (m == NULL || sensors == NULL || buckets == NULL || sensor_count == 0 ||
+        sensor_count == LD2420_LIVENESS_NONE || bucket_count == 0 || (bucket_count & (bucket_count - 1u)) != 0 ||
+        tick_ms == 0)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    if (config != NULL)
+        m->config = *config;
+    else
+        ld2420_liveness_default_config(&m->config);
+    if (m->config.silence_intervals == 0 || m->config.window_ms == 0 || m->config.window_ms > INT32_MAX ||
+        m->config.flap_window_ms > INT32_MAX)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    m->sensors = sensors;
+    m->sensor_count = sensor_count;
+    m->buckets = buckets;
+    m->bucket_mask = bucket_count - 1u;
+    m->tick_ms = tick_ms;
+    m->tick = 0;
+    m->tick_due_ms = now_ms + tick_ms;
+    m->alert = alert;
+    m->user = user;
+    m->visits = 0;
+
+    for (uint32_t b = 0; b < bucket_count; b++)
+        buckets[b] = LD2420_LIVENESS_NONE;
+    for (uint32_t i = 0; i < sensor_count; i++)
+    {
+        ld2420_liveness_sensor_t *s = &sensors[i];
+        s->interval_ms = 0;
+        s->next = s->prev = s->bucket = LD2420_LIVENESS_NONE;
+        s->conditions = 0;
+    }
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_liveness_watch(ld2420_liveness_t *m, uint32_t sensor, uint32_t interval_ms, uint32_t now_ms)
+{
+    if (m == NULL || sensor >= m->sensor_count ||
+        (uint64_t)interval_ms * m->config.silence_intervals > (uint64_t)INT32_MAX)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    unlink_sensor(m, sensor);
+    ld2420_liveness_sensor_t *s = &m->sensors[sensor];
+    s->last_frame_ms = now_ms;
+    s->interval_ms = interval_ms;
+    s->window_start_ms = now_ms;
+    s->window_frames = 0;
+    s->window_errors = 0;
+    s->last_silence_ms = now_ms;
+    s->flap_count = 0;
+    s->conditions = 0;
+    if (interval_ms > 0)
+        schedule(m, sensor, silence_deadline(m, s));
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_liveness_frame(ld2420_liveness_t *m, uint32_t sensor, uint32_t now_ms)
+{
+    if (m == NULL || sensor >= m->sensor_count)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    ld2420_liveness_sensor_t *s = &m->sensors[sensor];
+    if (s->interval_ms == 0)
+        return LD2420_STATUS_OK;
+
+    s->last_frame_ms = now_ms;
+    roll_window(m, sensor, now_ms);
+    if (s->window_frames < UINT16_MAX)
+        s->window_frames++;
+
+    // Silent sensors are out of the wheel; everyone else is already in it
+    if (s->conditions & LD2420_LIVENESS_SILENT)
+    {
+        notify(m, sensor, LD2420_LIVENESS_SILENT, false, now_ms);
+        schedule(m, sensor, silence_deadline(m, s));
+    }
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_liveness_error(ld2420_liveness_t *m, uint32_t sensor, uint32_t now_ms)
+{
+    if (m == NULL || sensor >= m->sensor_count)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    ld2420_liveness_sensor_t *s = &m->sensors[sensor];
+    if (s->interval_ms == 0)
+        return LD2420_STATUS_OK;
+
+    roll_window(m, sensor, now_ms);
+    if (s->window_errors < UINT16_MAX)
+        s->window_errors++;
+    if (!(s->conditions & LD2420_LIVENESS_DEGRADED) && window_degraded(m, s))
+        notify(m, sensor, LD2420_LIVENESS_DEGRADED, true, now_ms);
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_liveness_advance(ld2420_liveness_t *m, uint32_t now_ms)
+{
+    if (m == NULL)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    if (!time_reached(now_ms, m->tick_due_ms))
+        return LD2420_STATUS_OK;
+
+    // After a long pause one turn of the wheel visits every scheduled sensor.
+    // Skipping the rest only makes sensors come up early, and those that are
+    // not due yet are rescheduled.
+    const uint32_t behind = (now_ms - m->tick_due_ms) / m->tick_ms;
+    if (behind > m->bucket_mask)
+        m->tick_due_ms += (behind - m->bucket_mask) * m->tick_ms;
+
+    while (time_reached(now_ms, m->tick_due_ms))
+    {
+        uint32_t idx = m->buckets[m->tick & m->bucket_mask];
+        m->buckets[m->tick & m->bucket_mask] = LD2420_LIVENESS_NONE;
+        // Advance first so that sensors rescheduled below land in later buckets
+        m->tick++;
+        m->tick_due_ms += m->tick_ms;
+
+        while (idx != LD2420_LIVENESS_NONE)
+        {
+            ld2420_liveness_sensor_t *s = &m->sensors[idx];
+            const uint32_t next = s->next;
+            s->next = s->prev = s->bucket = LD2420_LIVENESS_NONE;
+            m->visits++;
+            visit(m, idx, now_ms);
+            idx = next;
+        }
+    }
+    return LD2420_STATUS_OK;
+}
@@ -0,0 +1,230 @@
+#include <unity.h>
+#include <string.h>
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_liveness.h>
+
+#define SENSORS 50000u
+#define BUCKETS 64u
+#define TICK_MS 100u
+/** 10 Hz reports; silent after the default five intervals. */
+#define INTERVAL_MS 100u
+
+static ld2420_liveness_t monitor;
+static ld2420_liveness_sensor_t sensors[SENSORS];
+static uint32_t buckets[BUCKETS];
+
+/** Alerts seen by the callback. */
+typedef struct
+{
+    uint32_t sensor;
+    ld2420_liveness_condition_t condition;
+    bool raised;
+    uint32_t now_ms;
+} alert_t;
+
+static alert_t alerts[64];
+static int alert_count;
+
+static void on_alert(void *user, uint32_t sensor, ld2420_liveness_condition_t condition, bool raised, uint32_t now_ms)
+{
+    (void)user;
+    if (alert_count < 64)
+        alerts[alert_count] = (alert_t){sensor, condition, raised, now_ms};
+    alert_count++;
+}
+
+static void expect_alert(int i, uint32_t sensor, ld2420_liveness_condition_t condition, bool raised)
+{
+    TEST_ASSERT_TRUE(i < alert_count);
+    TEST_ASSERT_EQUAL_UINT32(sensor, alerts[i].sensor);
+    TEST_ASSERT_EQUAL_INT(condition, alerts[i].condition);
+    TEST_ASSERT_EQUAL(raised, alerts[i].raised);
+}
+
+/**
+ * Step time from `from` to `to` in TICK_MS steps (across clock wraps). At each step the
+ * sensors whose bit is set in `sending` report a frame, then the wheel advances.
+ */
+static void run(uint32_t from, uint32_t to, uint32_t sending)
+{
+    for (uint32_t d = 0; d < to - from; d += TICK_MS)
+    {
+        for (uint32_t s = 0; s < 32; s++)
+        {
+            if (sending & (1u << s))
+                ld2420_liveness_frame(&monitor, s, from + d);
+        }
+        ld2420_liveness_advance(&monitor, from + d);
+    }
+}
+
+void setUp(void)
+{
+    alert_count = 0;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_liveness_init(&monitor, sensors, 8, buckets, BUCKETS, TICK_MS,
+                                                             NULL, on_alert, NULL, 0));
+}
+
+void tearDown(void)
+{
+}
+
+void test__liveness_silent_sensor_is_flagged_and_recovers(void)
+{
+    ld2420_liveness_watch(&monitor, 3, INTERVAL_MS, 0);
+    ld2420_liveness_watch(&monitor, 4, INTERVAL_MS, 0);
+    run(0, 1000, 1u << 3 | 1u << 4);
+    TEST_ASSERT_EQUAL_INT(0, alert_count);
+
+    // Last frame at 900 ms; silent from 1400 ms, reported within a tick
+    run(1000, 1600, 1u << 4);
+    TEST_ASSERT_EQUAL_INT(1, alert_count);
+    expect_alert(0, 3, LD2420_LIVENESS_SILENT, true);
+    TEST_ASSERT_TRUE(alerts[0].now_ms >= 1400 && alerts[0].now_ms <= 1400 + TICK_MS);
+    TEST_ASSERT_EQUAL_UINT8(LD2420_LIVENESS_SILENT, sensors[3].conditions);
+    TEST_ASSERT_EQUAL_UINT8(0, sensors[4].conditions);
+
+    // Staying silent raises nothing more; the next frame clears it and re-arms the deadline
+    run(1600, 5000, 1u << 4);
+    TEST_ASSERT_EQUAL_INT(1, alert_count);
+    ld2420_liveness_frame(&monitor, 3, 5000);
+    expect_alert(1, 3, LD2420_LIVENESS_SILENT, false);
+    run(5000, 6000, 1u << 4);
+    TEST_ASSERT_EQUAL_INT(3, alert_count);
+    expect_alert(2, 3, LD2420_LIVENESS_SILENT, true);
+
+    // Unwatched sensors are neither flagged nor accept frames
+    ld2420_liveness_watch(&monitor, 3, 0, 6000);
+    TEST_ASSERT_EQUAL_UINT8(0, sensors[3].conditions);
+    run(6000, 9000, 1u << 4);
+    ld2420_liveness_frame(&monitor, 3, 9000);
+    TEST_ASSERT_EQUAL_INT(3, alert_count);
+}
+
+void test__liveness_error_share_raises_and_clears_degraded(void)
+{
+    ld2420_liveness_watch(&monitor, 0, INTERVAL_MS, 0);
+
+    // 4 errors against 50 frames: below the minimum error count
+    for (uint32_t i = 0; i < 50; i++)
+        ld2420_liveness_frame(&monitor, 0, i * 10);
+    for (uint32_t i = 0; i < 4; i++)
+        ld2420_liveness_error(&monitor, 0, 600);
+    TEST_ASSERT_EQUAL_INT(0, alert_count);
+
+    // Fifth error: 5 / 55 > 5 %
+    ld2420_liveness_error(&monitor, 0, 700);
+    TEST_ASSERT_EQUAL_INT(1, alert_count);
+    expect_alert(0, 0, LD2420_LIVENESS_DEGRADED, true);
+    ld2420_liveness_error(&monitor, 0, 800);
+    TEST_ASSERT_EQUAL_INT(1, alert_count);
+
+    // The next window is clean; it clears once it is over
+    run(10000, 20000, 1u << 0);
+    TEST_ASSERT_EQUAL_UINT8(LD2420_LIVENESS_DEGRADED, sensors[0].conditions);
+    run(20000, 20300, 1u << 0);
+    TEST_ASSERT_EQUAL_INT(2, alert_count);
+    expect_alert(1, 0, LD2420_LIVENESS_DEGRADED, false);
+    TEST_ASSERT_EQUAL_UINT8(0, sensors[0].conditions);
+}
+
+void test__liveness_repeated_silence_is_flapping(void)
+{
+    ld2420_liveness_watch(&monitor, 5, INTERVAL_MS, 0);
+
+    // Three dropouts of two seconds, ten seconds apart
+    uint32_t t = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        run(t, t + 8000, 1u << 5);
+        run(t + 8000, t + 10000, 0);
+        t += 10000;
+    }
+    TEST_ASSERT_EQUAL_UINT8(LD2420_LIVENESS_SILENT | LD2420_LIVENESS_FLAPPING, sensors[5].conditions);
+    expect_alert(4, 5, LD2420_LIVENESS_SILENT, true);
+    expect_alert(5, 5, LD2420_LIVENESS_FLAPPING, true);
+
+    // A minute of clean reports after the last silence clears it
+    run(t, t + 50000, 1u << 5);
+    TEST_ASSERT_EQUAL_UINT8(LD2420_LIVENESS_FLAPPING, sensors[5].conditions);
+    run(t + 50000, t + 60000, 1u << 5);
+    TEST_ASSERT_EQUAL_UINT8(0, sensors[5].conditions);
+    expect_alert(alert_count - 1, 5, LD2420_LIVENESS_FLAPPING, false);
+}
+
+void test__liveness_advance_cost_follows_expired_sensors(void)
+{
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_liveness_init(&monitor, sensors, SENSORS, buckets, BUCKETS, TICK_MS,
+                                                             NULL, on_alert, NULL, 0));
+    for (uint32_t s = 0; s < SENSORS; s++)
+        ld2420_liveness_watch(&monitor, s, INTERVAL_MS, 0);
+
+    // Ten seconds of healthy sensors: each is visited about once per 500 ms timeout,
+    // not once per tick
+    for (uint32_t t = 0; t < 10000; t += TICK_MS)
+    {
+        for (uint32_t s = 0; s < SENSORS; s++)
+            ld2420_liveness_frame(&monitor, s, t);
+        ld2420_liveness_advance(&monitor, t);
+    }
+    TEST_ASSERT_EQUAL_INT(0, alert_count);
+    TEST_ASSERT_TRUE(monitor.visits <= (uint64_t)SENSORS * (10000 / 500 + 1));
+
+    // Once silent, sensors are out of the wheel and cost nothing per tick
+    run(10000, 11000, 0);
+    TEST_ASSERT_EQUAL_INT(SENSORS, alert_count);
+    const uint64_t visits = monitor.visits;
+    run(11000, 60000, 0);
+    TEST_ASSERT_EQUAL_UINT64(visits, monitor.visits);
+}
+
+void test__liveness_survives_clock_wrap_and_long_pauses(void)
+{
+    const uint32_t start = UINT32_MAX - 1500u;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_liveness_init(&monitor, sensors, 8, buckets, BUCKETS, TICK_MS,
+                                                             NULL, on_alert, NULL, start));
+    ld2420_liveness_watch(&monitor, 1, INTERVAL_MS, start);
+    ld2420_liveness_watch(&monitor, 2, 60000, start);
+    run(start, start + 3000, 1u << 1); // wraps past 0
+    TEST_ASSERT_EQUAL_INT(0, alert_count);
+
+    // Advance called again only after far more than a wheel turn
+    ld2420_liveness_advance(&monitor, start + 30000);
+    TEST_ASSERT_EQUAL_INT(1, alert_count);
+    expect_alert(0, 1, LD2420_LIVENESS_SILENT, true);
+
+    // The slow sensor's 5-minute timeout spans several wheel turns
+    run(start + 30000, start + 299000, 0);
+    TEST_ASSERT_EQUAL_INT(1, alert_count);
+    run(start + 299000, start + 301000, 0);
+    TEST_ASSERT_EQUAL_INT(2, alert_count);
+    expect_alert(1, 2, LD2420_LIVENESS_SILENT, true);
+}
+
+void test__liveness_rejects_invalid_arguments(void)
+{
+    ld2420_liveness_t m;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS,
+                      ld2420_liveness_init(&m, sensors, 8, buckets, 48, TICK_MS, NULL, NULL, NULL, 0));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS,
+                      ld2420_liveness_init(&m, sensors, 8, buckets, BUCKETS, 0, NULL, NULL, NULL, 0));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS,
+                      ld2420_liveness_init(&m, NULL, 8, buckets, BUCKETS, TICK_MS, NULL, NULL, NULL, 0));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_liveness_watch(&monitor, 8, INTERVAL_MS, 0));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_liveness_watch(&monitor, 0, UINT32_MAX / 2, 0));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_liveness_frame(&monitor, 8, 0));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_liveness_error(NULL, 0, 0));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_liveness_advance(NULL, 0));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test__liveness_silent_sensor_is_flagged_and_recovers);
+    RUN_TEST(test__liveness_error_share_raises_and_clears_degraded);
+    RUN_TEST(test__liveness_repeated_silence_is_flapping);
+    RUN_TEST(test__liveness_advance_cost_follows_expired_sensors);
+    RUN_TEST(test__liveness_survives_clock_wrap_and_long_pauses);
+    RUN_TEST(test__liveness_rejects_invalid_arguments);
+    return UNITY_END();
+}
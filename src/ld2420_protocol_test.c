@@ -0,0 +1,149 @@
+#include <unity.h>
+#include <string.h>
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_protocol.h>
+
+/** OPEN CONFIG MODE ACK as sent by the sensor (protocol version 2, buffer size 0x20). */
+static const uint8_t OPEN_CONFIG_ACK[] = {
+    0xFD, 0xFC, 0xFB, 0xFA, // header
+    0x08, 0x00,             // frame size (8)
+    0xFF, 0x01,             // cmd echo
+    0x00, 0x00,             // status
+    0x02, 0x00, 0x20, 0x00, // protocol version, buffer size
+    0x04, 0x03, 0x02, 0x01  // footer
+};
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test__protocol_encodes_commands_at_fixed_offsets(void)
+{
+    static const uint8_t OPEN_CONFIG_MODE[] = {0xFD, 0xFC, 0xFB, 0xFA, 0x04, 0x00, 0xFF, 0x00, 0x01, 0x00, 0x04, 0x03, 0x02, 0x01};
+    static const uint8_t CLOSE_CONFIG_MODE[] = {0xFD, 0xFC, 0xFB, 0xFA, 0x02, 0x00, 0xFE, 0x00, 0x04, 0x03, 0x02, 0x01};
+    uint8_t out[LD2420_PROTOCOL_COMMAND_MAX_SIZE];
+
+    const ld2420_command_open_config_mode_t open = {.protocol_version = 1};
+    TEST_ASSERT_EQUAL_UINT(sizeof(OPEN_CONFIG_MODE), ld2420_command_open_config_mode_encode(out, &open));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(OPEN_CONFIG_MODE, out, sizeof(OPEN_CONFIG_MODE));
+
+    TEST_ASSERT_EQUAL_UINT(sizeof(CLOSE_CONFIG_MODE), ld2420_command_close_config_mode_encode(out));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(CLOSE_CONFIG_MODE, out, sizeof(CLOSE_CONFIG_MODE));
+}
+
+void test__protocol_decodes_ack_and_reports_what_is_wrong(void)
+{
+    ld2420_ack_open_config_mode_t ack;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_ack_open_config_mode_decode(OPEN_CONFIG_ACK, sizeof(OPEN_CONFIG_ACK), &ack));
+    TEST_ASSERT_EQUAL_UINT16(0, ack.status);
+    TEST_ASSERT_EQUAL_UINT16(2, ack.protocol_version);
+    TEST_ASSERT_EQUAL_UINT16(0x20, ack.buffer_size);
+
+    // Frames need no alignment
+    uint8_t shifted[sizeof(OPEN_CONFIG_ACK) + 1];
+    memcpy(shifted + 1, OPEN_CONFIG_ACK, sizeof(OPEN_CONFIG_ACK));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_ack_open_config_mode_decode(shifted + 1, sizeof(OPEN_CONFIG_ACK), &ack));
+
+    uint8_t frame[sizeof(OPEN_CONFIG_ACK)];
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_BUFFER_SIZE,
+                      ld2420_ack_open_config_mode_decode(OPEN_CONFIG_ACK, sizeof(OPEN_CONFIG_ACK) - 1, &ack));
+
+    memcpy(frame, OPEN_CONFIG_ACK, sizeof(frame));
+    frame[1] = 0x00;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_HEADER, ld2420_ack_open_config_mode_decode(frame, sizeof(frame), &ack));
+
+    memcpy(frame, OPEN_CONFIG_ACK, sizeof(frame));
+    frame[4] = 0x09;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FRAME_SIZE, ld2420_ack_open_config_mode_decode(frame, sizeof(frame), &ack));
+
+    memcpy(frame, OPEN_CONFIG_ACK, sizeof(frame));
+    frame[sizeof(frame) - 1] = 0x00;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FOOTER, ld2420_ack_open_config_mode_decode(frame, sizeof(frame), &ack));
+
+    // A well-formed ACK of another command
+    memcpy(frame, OPEN_CONFIG_ACK, sizeof(frame));
+    frame[6] = 0x08;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_PACKET, ld2420_ack_open_config_mode_decode(frame, sizeof(frame), &ack));
+}
+
+void test__protocol_variable_arrays_round_trip(void)
+{
+    uint8_t out[LD2420_PROTOCOL_COMMAND_MAX_SIZE];
+
+    ld2420_command_set_config_t set = {.entries_count = 2};
+    set.entries[0].parameter = LD2420_PARAM_MIN_DISTANCE;
+    set.entries[0].value = 1;
+    set.entries[1].parameter = LD2420_PARAM_DELAY_TIME;
+    set.entries[1].value = 0x00012345;
+    const uint16_t size = ld2420_command_set_config_encode(out, &set);
+    TEST_ASSERT_EQUAL_UINT(LD2420_COMMAND_SET_CONFIG_MIN_SIZE + 6, size);
+    TEST_ASSERT_TRUE(ld2420_protocol_command_length_valid(LD2420_CMD_SET_CONFIG, (uint16_t)(size - LD2420_PROTOCOL_FRAME_OVERHEAD)));
+
+    ld2420_command_set_config_t decoded;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_command_set_config_decode(out, size, &decoded));
+    TEST_ASSERT_EQUAL_UINT16(2, decoded.entries_count);
+    TEST_ASSERT_EQUAL_UINT16(LD2420_PARAM_DELAY_TIME, decoded.entries[1].parameter);
+    TEST_ASSERT_EQUAL_UINT32(0x00012345, decoded.entries[1].value);
+
+    // A length that is not a whole number of entries is rejected
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_BUFFER_SIZE, ld2420_command_set_config_decode(out, size - 1, &decoded));
+    TEST_ASSERT_FALSE(ld2420_protocol_command_length_valid(LD2420_CMD_SET_CONFIG, (uint16_t)(size - LD2420_PROTOCOL_FRAME_OVERHEAD - 1)));
+
+    // Counts outside the table's range are not encoded
+    set.entries_count = 0;
+    TEST_ASSERT_EQUAL_UINT(0, ld2420_command_set_config_encode(out, &set));
+    set.entries_count = LD2420_COMMAND_SET_CONFIG_ENTRIES_MAX_COUNT + 1;
+    TEST_ASSERT_EQUAL_UINT(0, ld2420_command_set_config_encode(out, &set));
+
+    ld2420_ack_read_config_t values = {.status = 0, .values_count = 3, .values = {0x10, 0x20, 0xAABBCCDD}};
+    const uint16_t ack_size = ld2420_ack_read_config_encode(out, &values);
+    TEST_ASSERT_EQUAL_UINT(LD2420_ACK_READ_CONFIG_MIN_SIZE + 8, ack_size);
+    uint16_t frame_size, cmd_echo, status;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_parse_rx_buffer(out, (uint8_t)ack_size, &frame_size, &cmd_echo, &status, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT16(LD2420_CMD_READ_CONFIG, cmd_echo);
+    TEST_ASSERT_TRUE(ld2420_protocol_ack_length_valid((uint8_t)cmd_echo, frame_size));
+
+    ld2420_ack_read_config_t read;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_ack_read_config_decode(out, ack_size, &read));
+    TEST_ASSERT_EQUAL_UINT16(3, read.values_count);
+    TEST_ASSERT_EQUAL_UINT32(0xAABBCCDD, read.values[2]);
+}
+
+void test__protocol_report_frames(void)
+{
+    ld2420_report_energy_t report = {.presence = 1, .distance_cm = 0x0123};
+    for (uint16_t i = 0; i < 16; i++)
+        report.energy[i] = (uint16_t)(1000u * i + 7u);
+
+    uint8_t frame[LD2420_REPORT_ENERGY_SIZE];
+    TEST_ASSERT_EQUAL_UINT(45, ld2420_report_energy_encode(frame, &report));
+    static const uint8_t PREFIX[] = {0xF4, 0xF3, 0xF2, 0xF1, 0x23, 0x00, 0x01, 0x23, 0x01, 0x07, 0x00};
+    static const uint8_t FOOTER[] = {0xF8, 0xF7, 0xF6, 0xF5};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(PREFIX, frame, sizeof(PREFIX));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(FOOTER, frame + sizeof(frame) - 4, sizeof(FOOTER));
+
+    ld2420_report_energy_t decoded;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_report_energy_decode(frame, sizeof(frame), &decoded));
+    TEST_ASSERT_EQUAL_UINT8(1, decoded.presence);
+    TEST_ASSERT_EQUAL_UINT16(0x0123, decoded.distance_cm);
+    TEST_ASSERT_EQUAL_UINT16(15007, decoded.energy[15]);
+
+    // Report frames are not command frames
+    uint16_t frame_size, cmd_echo, status;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_HEADER,
+                      ld2420_parse_rx_buffer(frame, sizeof(frame), &frame_size, &cmd_echo, &status, NULL, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test__protocol_encodes_commands_at_fixed_offsets);
+    RUN_TEST(test__protocol_decodes_ack_and_reports_what_is_wrong);
+    RUN_TEST(test__protocol_variable_arrays_round_trip);
+    RUN_TEST(test__protocol_report_frames);
+    return UNITY_END();
+}
@@ -0,0 +1,156 @@
+/*
+ * LD2420 frame replay implementation
+ *
+ * Design Principles
+ * -----------------
+ * 1. Adding a frame costs one copy into the next entry of its sensor's ring,
+ *    whatever the number of sensors or readers
+ * 2. An entry is invalidated (tag 0) before it is rewritten and tagged with its
+ *    frame number after, each behind a barrier, and the ring's frame count is
+ *    moved last. A reader that sees the tag it expects before and after using
+ *    the entry has used a consistent frame
+ * 3. No pointers inside the rings, so their memory may be mapped at different
+ *    addresses in different processes
+ *
+ * Memory & Threading
+ * ------------------
+ * - No dynamic allocation; rings are caller-provided
+ * - One writer. Any number of readers, in the same or other processes; readers
+ *   never block the writer
+ */
+
+#include <ld2420/ld2420_replay.h>
+#include <ld2420/ld2420_protocol.h>
+#include "ld2420_internal.h"
+
+
+/**
+ * Memory barrier between an entry's tag and its contents. Defaults to a full
+ * barrier on GCC and Clang; define it for other compilers.
+ */
+#ifndef LD2420_REPLAY_BARRIER
+#if defined(__GNUC__) || defined(__clang__)
+#define LD2420_REPLAY_BARRIER() __sync_synchronize()
+#else
+#define LD2420_REPLAY_BARRIER() ((void)0)
+#endif
+#endif
+
+LD2420_PROTOCOL_STATIC_CHECK(replay_depth, LD2420_REPLAY_DEPTH >= 1u);
+LD2420_PROTOCOL_STATIC_CHECK(replay_frame, LD2420_PROTOCOL_ACK_MAX_SIZE <= LD2420_REPLAY_MAX_FRAME &&
+                                               LD2420_PROTOCOL_REPORT_MAX_SIZE <= LD2420_REPLAY_MAX_FRAME);
+
+ld2420_status_t ld2420_replay_attach(
+    ld2420_replay_t *r,
+    ld2420_replay_sensor_t *sensors,
+    uint32_t sensor_count,
+    uint32_t max_age_ms)
+{
+    if (r == NULL || sensors == NULL || sensor_count == 0 || max_age_ms > (uint32_t)INT32_MAX)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    r->sensors = sensors;
+    r->sensor_count = sensor_count;
+    r->max_age_ms = max_age_ms;
+    r->frames = 0;
+    r->rejected = 0;
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_replay_init(
+    ld2420_replay_t *r,
+    ld2420_replay_sensor_t *sensors,
+    uint32_t sensor_count,
+    uint32_t max_age_ms)
+{
+    const ld2420_status_t status = ld2420_replay_attach(r, sensors, sensor_count, max_age_ms);
+    if (status == LD2420_STATUS_OK)
+        ld2420_set_bytes(sensors, 0, (size_t)sensor_count * sizeof(*sensors));
+    return status;
+}
+
+ld2420_status_t ld2420_replay_add(
+    ld2420_replay_t *r,
+    uint32_t sensor,
+    uint64_t sequence,
+    uint32_t now_ms,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    if (r == NULL || (frame == NULL && frame_size_bytes > 0))
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    if (sensor >= r->sensor_count || frame_size_bytes > LD2420_REPLAY_MAX_FRAME)
+    {
+        r->rejected++;
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    }
+
+    ld2420_replay_sensor_t *s = &r->sensors[sensor];
+    const uint32_t k = s->written;
+    const uint32_t slot = k % LD2420_REPLAY_DEPTH;
+    ld2420_replay_entry_t *e = &s->entries[slot];
+
+    s->tags[slot] = 0;
+    LD2420_REPLAY_BARRIER();
+    e->sequence = sequence;
+    e->time_ms = now_ms;
+    e->frame_size_bytes = frame_size_bytes;
+    e->cmd_echo = cmd_echo;
+    e->status = status;
+    if (frame_size_bytes > 0)
+        ld2420_copy_bytes(e->frame, frame, frame_size_bytes);
+    LD2420_REPLAY_BARRIER();
+    s->tags[slot] = k + 1u;
+    LD2420_REPLAY_BARRIER();
+    s->written = k + 1u;
+    r->frames++;
+    return LD2420_STATUS_OK;
+}
+
+uint32_t ld2420_replay_read(
+    const ld2420_replay_t *r,
+    uint32_t sensor,
+    uint32_t now_ms,
+    uint64_t before_sequence,
+    ld2420_replay_on_frame_fn on_frame,
+    void *user,
+    uint64_t *out_torn)
+{
+    if (r == NULL || on_frame == NULL || sensor >= r->sensor_count)
+        return 0;
+
+    const ld2420_replay_sensor_t *s = &r->sensors[sensor];
+    const uint32_t written = s->written;
+    LD2420_REPLAY_BARRIER();
+    const uint32_t kept = written < LD2420_REPLAY_DEPTH ? written : LD2420_REPLAY_DEPTH;
+    uint32_t delivered = 0;
+    uint64_t torn = 0;
+
+    for (uint32_t k = written - kept; k != written; k++)
+    {
+        const uint32_t slot = k % LD2420_REPLAY_DEPTH;
+        const ld2420_replay_entry_t *e = &s->entries[slot];
+        if (s->tags[slot] != k + 1u)
+        {
+            // Replaced by a newer frame since `written` was read
+            torn++;
+            continue;
+        }
+        LD2420_REPLAY_BARRIER();
+        const bool fresh = r->max_age_ms == 0 || (int32_t)(now_ms - e->time_ms) <= (int32_t)r->max_age_ms;
+        if (!fresh || e->sequence >= before_sequence)
+            continue;
+
+        const bool more = on_frame(user, sensor, e);
+        LD2420_REPLAY_BARRIER();
+        if (s->tags[slot] != k + 1u)
+            torn++;
+        delivered++;
+        if (!more)
+            break;
+    }
+    if (out_torn != NULL)
+        *out_torn += torn;
+    return delivered;
+}
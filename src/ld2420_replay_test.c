@@ -0,0 +1,156 @@
+#include <unity.h>
+#include <string.h>
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/ld2420_replay.h>
+
+#define SENSORS 4u
+
+static ld2420_replay_sensor_t rings[SENSORS];
+static ld2420_replay_t replay;
+
+static uint64_t seen_sequences[4 * LD2420_REPLAY_DEPTH];
+static const uint8_t *seen_pointers[4 * LD2420_REPLAY_DEPTH];
+static uint32_t seen_count;
+static uint32_t rewrite_during_callback;
+
+static void report(uint8_t *frame, uint16_t distance_cm)
+{
+    ld2420_report_energy_t msg = {.presence = 1, .distance_cm = distance_cm};
+    ld2420_report_energy_encode(frame, &msg);
+}
+
+static void add(uint32_t sensor, uint64_t sequence, uint32_t now_ms)
+{
+    uint8_t frame[LD2420_REPORT_ENERGY_SIZE];
+    report(frame, (uint16_t)sequence);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK,
+                      ld2420_replay_add(&replay, sensor, sequence, now_ms, frame, sizeof(frame), 0, 0));
+}
+
+static bool on_frame(void *user, uint32_t sensor, const ld2420_replay_entry_t *entry)
+{
+    (void)user;
+    (void)sensor;
+    ld2420_report_energy_t msg;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_report_energy_decode(entry->frame, entry->frame_size_bytes, &msg));
+    TEST_ASSERT_EQUAL_UINT16((uint16_t)entry->sequence, msg.distance_cm);
+    seen_sequences[seen_count] = entry->sequence;
+    seen_pointers[seen_count] = entry->frame;
+    seen_count++;
+
+    // Play a writer in another process that laps the reader
+    for (; rewrite_during_callback > 0; rewrite_during_callback--)
+        add(sensor, 1000u + rewrite_during_callback, 0);
+    return true;
+}
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_replay_init(&replay, rings, SENSORS, 0));
+    seen_count = 0;
+    rewrite_during_callback = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test__replay_delivers_the_last_frames_of_a_sensor_in_place_oldest_first(void)
+{
+    for (uint64_t seq = 0; seq < 3u * LD2420_REPLAY_DEPTH; seq++)
+        add((uint32_t)(seq % 2u), seq, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(LD2420_REPLAY_DEPTH,
+                             ld2420_replay_read(&replay, 1, 0, UINT64_MAX, on_frame, NULL, NULL));
+    const uint64_t first = 3u * LD2420_REPLAY_DEPTH - 2u * LD2420_REPLAY_DEPTH + 1u;
+    for (uint32_t i = 0; i < seen_count; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT64(first + 2u * i, seen_sequences[i]);
+        TEST_ASSERT_TRUE(seen_pointers[i] >= (const uint8_t *)&rings[1] &&
+                         seen_pointers[i] < (const uint8_t *)&rings[2]);
+    }
+
+    // Sensors without frames replay nothing
+    seen_count = 0;
+    TEST_ASSERT_EQUAL_UINT32(0, ld2420_replay_read(&replay, 3, 0, UINT64_MAX, on_frame, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT64(3u * LD2420_REPLAY_DEPTH, replay.frames);
+}
+
+void test__replay_stops_before_the_first_live_sequence(void)
+{
+    for (uint64_t seq = 100; seq < 100u + LD2420_REPLAY_DEPTH; seq++)
+        add(0, seq, 0);
+
+    // A subscriber whose live frames start at 103 gets 100..102 from the replay
+    TEST_ASSERT_EQUAL_UINT32(3, ld2420_replay_read(&replay, 0, 0, 103, on_frame, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT64(102, seen_sequences[2]);
+    seen_count = 0;
+    TEST_ASSERT_EQUAL_UINT32(0, ld2420_replay_read(&replay, 0, 0, 100, on_frame, NULL, NULL));
+}
+
+void test__replay_skips_frames_older_than_max_age_across_clock_wrap(void)
+{
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_replay_init(&replay, rings, SENSORS, 5000));
+    const uint32_t t0 = UINT32_MAX - 3000u;
+    add(2, 1, t0);
+    add(2, 2, t0 + 4000u);
+    add(2, 3, t0 + 6000u);
+
+    TEST_ASSERT_EQUAL_UINT32(2, ld2420_replay_read(&replay, 2, t0 + 9000u, UINT64_MAX, on_frame, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT64(2, seen_sequences[0]);
+    seen_count = 0;
+    TEST_ASSERT_EQUAL_UINT32(0, ld2420_replay_read(&replay, 2, t0 + 20000u, UINT64_MAX, on_frame, NULL, NULL));
+}
+
+void test__replay_counts_frames_replaced_under_a_reader_as_torn(void)
+{
+    for (uint64_t seq = 0; seq < LD2420_REPLAY_DEPTH; seq++)
+        add(0, seq, 0);
+
+    // The writer replaces every frame while the first callback runs: the first is
+    // torn, the others are skipped
+    rewrite_during_callback = LD2420_REPLAY_DEPTH;
+    uint64_t torn = 0;
+    TEST_ASSERT_EQUAL_UINT32(1, ld2420_replay_read(&replay, 0, 0, UINT64_MAX, on_frame, NULL, &torn));
+    TEST_ASSERT_EQUAL_UINT64(LD2420_REPLAY_DEPTH, torn);
+
+    // Once the writer is idle, the replaced frames read back intact
+    seen_count = 0;
+    torn = 0;
+    TEST_ASSERT_EQUAL_UINT32(LD2420_REPLAY_DEPTH, ld2420_replay_read(&replay, 0, 0, UINT64_MAX, on_frame, NULL, &torn));
+    TEST_ASSERT_EQUAL_UINT64(0, torn);
+}
+
+void test__replay_rejects_unknown_sensors_and_oversized_frames(void)
+{
+    uint8_t frame[LD2420_REPLAY_MAX_FRAME + 1u];
+    memset(frame, 0, sizeof(frame));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS,
+                      ld2420_replay_add(&replay, SENSORS, 1, 0, frame, 20, 0, 0));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS,
+                      ld2420_replay_add(&replay, 0, 1, 0, frame, sizeof(frame), 0, 0));
+    TEST_ASSERT_EQUAL_UINT64(2, replay.rejected);
+    TEST_ASSERT_EQUAL_UINT32(0, ld2420_replay_read(&replay, SENSORS, 0, UINT64_MAX, on_frame, NULL, NULL));
+
+    // Attaching keeps what another writer stored
+    add(1, 7, 0);
+    ld2420_replay_t reader;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_replay_attach(&reader, rings, SENSORS, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, ld2420_replay_read(&reader, 1, 0, UINT64_MAX, on_frame, NULL, NULL));
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_replay_init(&replay, NULL, SENSORS, 0));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_replay_init(&replay, rings, 0, 0));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_replay_init(&replay, rings, SENSORS, UINT32_MAX));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test__replay_delivers_the_last_frames_of_a_sensor_in_place_oldest_first);
+    RUN_TEST(test__replay_stops_before_the_first_live_sequence);
+    RUN_TEST(test__replay_skips_frames_older_than_max_age_across_clock_wrap);
+    RUN_TEST(test__replay_counts_frames_replaced_under_a_reader_as_torn);
+    RUN_TEST(test__replay_rejects_unknown_sensors_and_oversized_frames);
+    return UNITY_END();
+}
@@ -0,0 +1,230 @@
+/*
+ * LD2420 rolling aggregation implementation
+ *
+ * Design Principles
+ * -----------------
+ * 1. A frame touches one bucket: the sensor's open 1 s bucket. Coarser
+ *    buckets are fed by merging finished finer buckets into them, so they see
+ *    one update per second or minute instead of one per frame
+ * 2. Slots are addressed by bucket number modulo ring length and carry the
+ *    number of the bucket they hold. Looking a bucket up is one comparison,
+ *    and buckets for periods without frames are never written
+ * 3. The open bucket of a resolution is merged into the next one only when it
+ *    is finished, i.e. when a later bucket opens. Snapshots of the current
+ *    minute and hour add the unmerged finer buckets on the fly
+ *
+ * Memory & Threading
+ * ------------------
+ * - No dynamic allocation; sensor rings belong to the caller
+ * - Not thread-safe; use one engine per thread
+ */
+
+#include <ld2420/ld2420_rollup.h>
+#include <ld2420/ld2420_protocol.h>
+#include "ld2420_internal.h"
+
+
+LD2420_PROTOCOL_STATIC_CHECK(rollup_gates, sizeof(((ld2420_report_energy_t *)0)->energy) ==
+                                               LD2420_ROLLUP_GATES * sizeof(uint16_t));
+
+static const uint32_t RESOLUTION_MS[LD2420_ROLLUP_RESOLUTIONS] = {1000u, 60000u, 3600000u};
+
+/** Finer buckets per bucket of the next resolution: 60 s per minute, 60 min per hour. */
+#define ROLLUP_STEP 60u
+
+static ld2420_rollup_bucket_t *ring(ld2420_rollup_sensor_t *s, uint32_t res, uint32_t *length)
+{
+    switch (res)
+    {
+    case LD2420_ROLLUP_SECOND:
+        *length = LD2420_ROLLUP_SECOND_BUCKETS;
+        return s->seconds;
+    case LD2420_ROLLUP_MINUTE:
+        *length = LD2420_ROLLUP_MINUTE_BUCKETS;
+        return s->minutes;
+    default:
+        *length = LD2420_ROLLUP_HOUR_BUCKETS;
+        return s->hours;
+    }
+}
+
+/** The slot for a bucket number, or NULL if the slot holds a different bucket. */
+static const ld2420_rollup_bucket_t *find(const ld2420_rollup_sensor_t *s, uint32_t res, uint32_t index)
+{
+    uint32_t length;
+    const ld2420_rollup_bucket_t *slots = ring((ld2420_rollup_sensor_t *)s, res, &length);
+    const ld2420_rollup_bucket_t *b = &slots[index % length];
+    return b->index == index && index != LD2420_ROLLUP_NONE ? b : NULL;
+}
+
+static void clear_bucket(ld2420_rollup_bucket_t *b, uint32_t index)
+{
+    b->index = index;
+    b->frames = 0;
+    b->presence_frames = 0;
+    for (uint32_t g = 0; g < LD2420_ROLLUP_GATES; g++)
+    {
+        b->min[g] = UINT16_MAX;
+        b->max[g] = 0;
+        b->sum[g] = 0;
+    }
+}
+
+static void merge_bucket(ld2420_rollup_bucket_t *into, const ld2420_rollup_bucket_t *b)
+{
+    into->frames += b->frames;
+    into->presence_frames += b->presence_frames;
+    for (uint32_t g = 0; g < LD2420_ROLLUP_GATES; g++)
+    {
+        if (b->min[g] < into->min[g])
+            into->min[g] = b->min[g];
+        if (b->max[g] > into->max[g])
+            into->max[g] = b->max[g];
+        into->sum[g] += b->sum[g];
+    }
+}
+
+/**
+ * Make index the open bucket of a resolution. A different open bucket is
+ * finished first and merged into the next resolution, which may finish that
+ * one in turn.
+ */
+static ld2420_rollup_bucket_t *open_bucket(ld2420_rollup_sensor_t *s, uint32_t res, uint32_t index)
+{
+    uint32_t length;
+    ld2420_rollup_bucket_t *slots = ring(s, res, &length);
+    if (s->open[res] == index)
+        return &slots[index % length];
+
+    if (s->open[res] != LD2420_ROLLUP_NONE && res + 1u < LD2420_ROLLUP_RESOLUTIONS)
+    {
+        const ld2420_rollup_bucket_t *done = &slots[s->open[res] % length];
+        merge_bucket(open_bucket(s, res + 1u, s->open[res] / ROLLUP_STEP), done);
+    }
+    s->open[res] = index;
+    clear_bucket(&slots[index % length], index);
+    return &slots[index % length];
+}
+
+ld2420_status_t ld2420_rollup_init(ld2420_rollup_t *r, ld2420_rollup_sensor_t *sensors, uint32_t sensor_count)
+{
+    if (r == NULL || sensors == NULL || sensor_count == 0)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    r->sensors = sensors;
+    r->sensor_count = sensor_count;
+    r->frames = 0;
+    for (uint32_t i = 0; i < sensor_count; i++)
+    {
+        ld2420_rollup_sensor_t *s = &sensors[i];
+        for (uint32_t res = 0; res < LD2420_ROLLUP_RESOLUTIONS; res++)
+        {
+            uint32_t length;
+            ld2420_rollup_bucket_t *slots = ring(s, res, &length);
+            for (uint32_t k = 0; k < length; k++)
+                slots[k].index = LD2420_ROLLUP_NONE;
+            s->open[res] = LD2420_ROLLUP_NONE;
+        }
+        s->late_frames = 0;
+    }
+    return LD2420_STATUS_OK;
+}
+
+uint32_t ld2420_rollup_index(ld2420_rollup_resolution_t resolution, uint64_t time_ms)
+{
+    if ((uint32_t)resolution >= LD2420_ROLLUP_RESOLUTIONS)
+        return LD2420_ROLLUP_NONE;
+    return (uint32_t)(time_ms / RESOLUTION_MS[resolution]);
+}
+
+ld2420_status_t ld2420_rollup_add(
+    ld2420_rollup_t *r,
+    uint32_t sensor,
+    bool presence,
+    const uint16_t *energy,
+    uint64_t time_ms)
+{
+    if (r == NULL || energy == NULL || sensor >= r->sensor_count)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    ld2420_rollup_sensor_t *s = &r->sensors[sensor];
+    const uint32_t second = ld2420_rollup_index(LD2420_ROLLUP_SECOND, time_ms);
+    if (s->open[LD2420_ROLLUP_SECOND] != LD2420_ROLLUP_NONE && second < s->open[LD2420_ROLLUP_SECOND])
+    {
+        s->late_frames++;
+        return LD2420_STATUS_OK;
+    }
+
+    ld2420_rollup_bucket_t *b = open_bucket(s, LD2420_ROLLUP_SECOND, second);
+    b->frames++;
+    b->presence_frames += presence ? 1u : 0u;
+    for (uint32_t g = 0; g < LD2420_ROLLUP_GATES; g++)
+    {
+        const uint16_t e = energy[g];
+        if (e < b->min[g])
+            b->min[g] = e;
+        if (e > b->max[g])
+            b->max[g] = e;
+        b->sum[g] += e;
+    }
+    r->frames++;
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_rollup_frame(
+    ld2420_rollup_t *r,
+    uint32_t sensor,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint64_t time_ms)
+{
+    ld2420_report_energy_t report;
+    const ld2420_status_t status = ld2420_report_energy_decode(frame, frame_size_bytes, &report);
+    if (status != LD2420_STATUS_OK)
+        return status;
+    return ld2420_rollup_add(r, sensor, report.presence != 0, report.energy, time_ms);
+}
+
+ld2420_status_t ld2420_rollup_snapshot(
+    const ld2420_rollup_t *r,
+    uint32_t sensor,
+    ld2420_rollup_resolution_t resolution,
+    uint32_t index,
+    ld2420_rollup_stats_t *out)
+{
+    if (r == NULL || out == NULL || sensor >= r->sensor_count || (uint32_t)resolution >= LD2420_ROLLUP_RESOLUTIONS)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    const ld2420_rollup_sensor_t *s = &r->sensors[sensor];
+    ld2420_rollup_bucket_t acc;
+    clear_bucket(&acc, index);
+
+    const ld2420_rollup_bucket_t *b = find(s, resolution, index);
+    if (b != NULL)
+        merge_bucket(&acc, b);
+
+    // The open bucket of each finer resolution is not in its parent yet
+    uint32_t divisor = 1;
+    for (uint32_t res = resolution; res-- > 0;)
+    {
+        divisor *= ROLLUP_STEP;
+        const uint32_t open = s->open[res];
+        if (open != LD2420_ROLLUP_NONE && open / divisor == index)
+            merge_bucket(&acc, find(s, res, open));
+    }
+
+    ld2420_set_bytes(out, 0, sizeof(*out));
+    out->start_ms = (uint64_t)index * RESOLUTION_MS[resolution];
+    out->frames = acc.frames;
+    if (acc.frames == 0)
+        return LD2420_STATUS_OK;
+
+    out->presence_permille = (uint16_t)(((uint64_t)acc.presence_frames * 1000u + acc.frames / 2u) / acc.frames);
+    for (uint32_t g = 0; g < LD2420_ROLLUP_GATES; g++)
+    {
+        out->min[g] = acc.min[g];
+        out->max[g] = acc.max[g];
+        out->mean[g] = (uint16_t)((acc.sum[g] + acc.frames / 2u) / acc.frames);
+    }
+    return LD2420_STATUS_OK;
+}
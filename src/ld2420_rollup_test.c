@@ -0,0 +1,223 @@
+#include <unity.h>
+#include <string.h>
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/ld2420_rollup.h>
+
+#define SENSORS 3u
+
+static ld2420_rollup_t rollup;
+static ld2420_rollup_sensor_t sensors[SENSORS];
+
+/** Raw readings for the brute-force reference. */
+typedef struct
+{
+    uint64_t time_ms;
+    bool presence;
+    uint16_t energy[LD2420_ROLLUP_GATES];
+} reading_t;
+
+static reading_t readings[40000];
+static uint32_t reading_count;
+
+static uint32_t rng = 0x1234567u;
+
+static uint32_t next_random(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void add(uint32_t sensor, bool presence, uint16_t base, uint64_t time_ms)
+{
+    uint16_t energy[LD2420_ROLLUP_GATES];
+    for (uint32_t g = 0; g < LD2420_ROLLUP_GATES; g++)
+        energy[g] = (uint16_t)(base + g);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_add(&rollup, sensor, presence, energy, time_ms));
+}
+
+/** Statistics straight from the raw readings. */
+static void reference(ld2420_rollup_resolution_t res, uint32_t index, ld2420_rollup_stats_t *out)
+{
+    uint64_t sum[LD2420_ROLLUP_GATES] = {0};
+    uint32_t presence = 0;
+    memset(out, 0, sizeof(*out));
+    for (uint32_t i = 0; i < reading_count; i++)
+    {
+        const reading_t *r = &readings[i];
+        if (ld2420_rollup_index(res, r->time_ms) != index)
+            continue;
+        for (uint32_t g = 0; g < LD2420_ROLLUP_GATES; g++)
+        {
+            if (out->frames == 0 || r->energy[g] < out->min[g])
+                out->min[g] = r->energy[g];
+            if (r->energy[g] > out->max[g])
+                out->max[g] = r->energy[g];
+            sum[g] += r->energy[g];
+        }
+        presence += r->presence ? 1u : 0u;
+        out->frames++;
+    }
+    if (out->frames == 0)
+        return;
+    out->presence_permille = (uint16_t)(((uint64_t)presence * 1000u + out->frames / 2u) / out->frames);
+    for (uint32_t g = 0; g < LD2420_ROLLUP_GATES; g++)
+        out->mean[g] = (uint16_t)((sum[g] + out->frames / 2u) / out->frames);
+}
+
+static void assert_matches_reference(ld2420_rollup_resolution_t res, uint32_t index)
+{
+    ld2420_rollup_stats_t got, want;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_snapshot(&rollup, 1, res, index, &got));
+    reference(res, index, &want);
+    TEST_ASSERT_EQUAL_UINT32(want.frames, got.frames);
+    if (want.frames == 0)
+        return;
+    TEST_ASSERT_EQUAL_UINT16(want.presence_permille, got.presence_permille);
+    TEST_ASSERT_EQUAL_MEMORY(want.min, got.min, sizeof(want.min));
+    TEST_ASSERT_EQUAL_MEMORY(want.max, got.max, sizeof(want.max));
+    TEST_ASSERT_EQUAL_MEMORY(want.mean, got.mean, sizeof(want.mean));
+}
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_init(&rollup, sensors, SENSORS));
+    reading_count = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test__rollup_second_bucket_statistics(void)
+{
+    add(0, true, 100, 5000);
+    add(0, false, 300, 5400);
+    add(0, true, 200, 5999);
+    add(0, true, 900, 6000); // next second
+
+    ld2420_rollup_stats_t s;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_snapshot(&rollup, 0, LD2420_ROLLUP_SECOND, 5, &s));
+    TEST_ASSERT_EQUAL_UINT32(3, s.frames);
+    TEST_ASSERT_EQUAL_UINT32(5000, (uint32_t)s.start_ms);
+    TEST_ASSERT_EQUAL_UINT16(667, s.presence_permille);
+    TEST_ASSERT_EQUAL_UINT16(100, s.min[0]);
+    TEST_ASSERT_EQUAL_UINT16(315, s.max[15]);
+    TEST_ASSERT_EQUAL_UINT16(207, s.mean[7]);
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_snapshot(&rollup, 0, LD2420_ROLLUP_SECOND, 6, &s));
+    TEST_ASSERT_EQUAL_UINT32(1, s.frames);
+    TEST_ASSERT_EQUAL_UINT16(1000, s.presence_permille);
+
+    // Other sensors are untouched
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_snapshot(&rollup, 2, LD2420_ROLLUP_SECOND, 5, &s));
+    TEST_ASSERT_EQUAL_UINT32(0, s.frames);
+}
+
+void test__rollup_coarse_buckets_match_raw_frames(void)
+{
+    // Sensor 1 reports for 70 minutes at an irregular rate around 8 Hz, with a
+    // silent gap, and every bucket at every resolution is compared with the raw
+    // frames at several points: the current minute and hour are only partly merged
+    uint64_t t = 3590000u; // a little before the end of hour 0
+    while (t < 3590000u + 70u * 60000u && reading_count < sizeof(readings) / sizeof(readings[0]))
+    {
+        reading_t *r = &readings[reading_count++];
+        r->time_ms = t;
+        r->presence = next_random() % 4u != 0;
+        for (uint32_t g = 0; g < LD2420_ROLLUP_GATES; g++)
+            r->energy[g] = (uint16_t)(next_random() % 60000u);
+        TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_add(&rollup, 1, r->presence, r->energy, r->time_ms));
+
+        t += 50u + next_random() % 200u;
+        if (reading_count == 2000)
+            t += 150000u; // two and a half minutes without frames
+
+        if (reading_count % 5000 == 0 || t >= 3590000u + 70u * 60000u)
+        {
+            const uint32_t minute = ld2420_rollup_index(LD2420_ROLLUP_MINUTE, r->time_ms);
+            for (uint32_t m = minute - (minute > 59u ? 59u : minute); m <= minute; m++)
+                assert_matches_reference(LD2420_ROLLUP_MINUTE, m);
+            const uint32_t second = ld2420_rollup_index(LD2420_ROLLUP_SECOND, r->time_ms);
+            for (uint32_t s = second - 59u; s <= second; s++)
+                assert_matches_reference(LD2420_ROLLUP_SECOND, s);
+            assert_matches_reference(LD2420_ROLLUP_HOUR, 0);
+            assert_matches_reference(LD2420_ROLLUP_HOUR, 1);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, sensors[1].late_frames);
+    TEST_ASSERT_EQUAL_UINT64(reading_count, rollup.frames);
+}
+
+void test__rollup_old_buckets_leave_the_ring(void)
+{
+    add(0, true, 100, 0);
+    add(0, true, 100, 60000); // 60 s later: second 0 is no longer held
+
+    ld2420_rollup_stats_t s;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_snapshot(&rollup, 0, LD2420_ROLLUP_SECOND, 0, &s));
+    TEST_ASSERT_EQUAL_UINT32(0, s.frames);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_snapshot(&rollup, 0, LD2420_ROLLUP_MINUTE, 0, &s));
+    TEST_ASSERT_EQUAL_UINT32(1, s.frames);
+
+    // Minute 61 takes the slot of minute 1, which is then only in its hour
+    add(0, true, 100, 61u * 60000u);
+    add(0, true, 100, 61u * 60000u + 1000u);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_snapshot(&rollup, 0, LD2420_ROLLUP_MINUTE, 61, &s));
+    TEST_ASSERT_EQUAL_UINT32(2, s.frames);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_snapshot(&rollup, 0, LD2420_ROLLUP_MINUTE, 1, &s));
+    TEST_ASSERT_EQUAL_UINT32(0, s.frames);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_snapshot(&rollup, 0, LD2420_ROLLUP_HOUR, 0, &s));
+    TEST_ASSERT_EQUAL_UINT32(2, s.frames);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_snapshot(&rollup, 0, LD2420_ROLLUP_HOUR, 1, &s));
+    TEST_ASSERT_EQUAL_UINT32(2, s.frames);
+}
+
+void test__rollup_ignores_late_frames(void)
+{
+    add(0, true, 100, 10500);
+    add(0, true, 100, 11200);
+    add(0, true, 100, 10900); // before the open second
+    add(0, true, 100, 11100); // out of order within it: accepted
+
+    ld2420_rollup_stats_t s;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_snapshot(&rollup, 0, LD2420_ROLLUP_MINUTE, 0, &s));
+    TEST_ASSERT_EQUAL_UINT32(3, s.frames);
+    TEST_ASSERT_EQUAL_UINT32(1, sensors[0].late_frames);
+}
+
+void test__rollup_frames_and_invalid_arguments(void)
+{
+    uint8_t frame[LD2420_REPORT_ENERGY_SIZE];
+    ld2420_report_energy_t msg = {.presence = 1, .distance_cm = 120};
+    for (int g = 0; g < 16; g++)
+        msg.energy[g] = (uint16_t)(40u * g);
+    ld2420_report_energy_encode(frame, &msg);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_frame(&rollup, 2, frame, sizeof(frame), 1000));
+
+    ld2420_rollup_stats_t s;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_snapshot(&rollup, 2, LD2420_ROLLUP_HOUR, 0, &s));
+    TEST_ASSERT_EQUAL_UINT32(1, s.frames);
+    TEST_ASSERT_EQUAL_UINT16(600, s.max[15]);
+
+    frame[0] ^= 0xFF;
+    TEST_ASSERT_NOT_EQUAL(LD2420_STATUS_OK, ld2420_rollup_frame(&rollup, 2, frame, sizeof(frame), 1000));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS,
+                      ld2420_rollup_add(&rollup, SENSORS, true, msg.energy, 1000));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS,
+                      ld2420_rollup_snapshot(&rollup, 0, (ld2420_rollup_resolution_t)3, 0, &s));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_rollup_init(&rollup, sensors, 0));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test__rollup_second_bucket_statistics);
+    RUN_TEST(test__rollup_coarse_buckets_match_raw_frames);
+    RUN_TEST(test__rollup_old_buckets_leave_the_ring);
+    RUN_TEST(test__rollup_ignores_late_frames);
+    RUN_TEST(test__rollup_frames_and_invalid_arguments);
+    return UNITY_END();
+}
@@ -0,0 +1,187 @@
+/*
+ * LD2420 overload shedding implementation
+ *
+ * Design Principles
+ * -----------------
+ * 1. Shedding is decided per frame from the frame's bytes and the sensor's
+ *    last forwarded state; nothing is queued or reordered
+ * 2. Only report frames are ever shed. A frame that does not look like a
+ *    full report frame is forwarded, so ACKs and anything unexpected pass
+ * 3. A presence change is always forwarded, and it updates the state the next
+ *    decisions compare against, so the receiver never misses a transition
+ * 4. Tiers go up at once and come down one at a time with hysteresis: losing
+ *    detail briefly is cheap, losing queued data is not
+ *
+ * Memory & Threading
+ * ------------------
+ * - No dynamic allocation; sensor state belongs to the caller
+ * - Not thread-safe; use one controller per forwarding thread
+ */
+
+#include <ld2420/ld2420_shed.h>
+#include <ld2420/ld2420_protocol.h>
+
+// A summary is the presence byte and the distance that follows it
+LD2420_PROTOCOL_STATIC_CHECK(shed_summary_fields, LD2420_REPORT_ENERGY_DISTANCE_CM_OFFSET ==
+                                                      LD2420_REPORT_ENERGY_PRESENCE_OFFSET + 1u);
+
+/** True once `now` has reached `t`, across clock wraps. */
+static inline bool time_reached(uint32_t now, uint32_t t)
+{
+    return (int32_t)(now - t) >= 0;
+}
+
+void ld2420_shed_default_config(ld2420_shed_config_t *config)
+{
+    if (config == NULL)
+        return;
+    config->enter_permille[0] = 600;
+    config->enter_permille[1] = 750;
+    config->enter_permille[2] = 900;
+    config->exit_margin_permille = 100;
+    config->smoothing_shift = 2;
+    config->hold_ms = 1000;
+    config->distance_tolerance_cm = 10;
+    config->keepalive_ms = 1000;
+    config->throttle_interval_ms = 1000;
+}
+
+ld2420_status_t ld2420_shed_init(ld2420_shed_t *shed, const ld2420_shed_config_t *config, uint32_t now_ms)
+{
+    if (shed == NULL)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    if (config != NULL)
+        shed->config = *config;
+    else
+        ld2420_shed_default_config(&shed->config);
+
+    const ld2420_shed_config_t *c = &shed->config;
+    if (c->smoothing_shift > 8 || c->enter_permille[LD2420_SHED_TIER_COUNT - 2u] > 1000)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    for (uint8_t t = 1; t < LD2420_SHED_TIER_COUNT - 1u; t++)
+    {
+        if (c->enter_permille[t] <= c->enter_permille[t - 1u])
+            return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    }
+
+    shed->tier = LD2420_SHED_TIER_NONE;
+    shed->pressure_permille = 0;
+    shed->tier_since_ms = now_ms;
+    shed->tier_changes = 0;
+    shed->summarized = 0;
+    shed->decimated = 0;
+    shed->deferred = 0;
+    return LD2420_STATUS_OK;
+}
+
+void ld2420_shed_sensor_init(ld2420_shed_sensor_t *sensor)
+{
+    if (sensor == NULL)
+        return;
+    sensor->last_forward_ms = 0;
+    sensor->distance_cm = 0;
+    sensor->presence = 0;
+    sensor->known = false;
+}
+
+static void set_tier(ld2420_shed_t *shed, uint8_t tier, uint32_t now_ms)
+{
+    shed->tier = tier;
+    shed->tier_since_ms = now_ms;
+    shed->tier_changes++;
+}
+
+ld2420_shed_tier_t ld2420_shed_update(
+    ld2420_shed_t *shed,
+    uint16_t cpu_permille,
+    uint16_t queue_permille,
+    uint32_t now_ms)
+{
+    if (shed == NULL)
+        return LD2420_SHED_TIER_NONE;
+
+    const ld2420_shed_config_t *c = &shed->config;
+    int32_t sample = cpu_permille > queue_permille ? cpu_permille : queue_permille;
+    if (sample > 1000)
+        sample = 1000;
+    // Within 2^smoothing_shift of the sample the pressure settles on it
+    const int32_t diff = sample - (int32_t)shed->pressure_permille;
+    const int32_t step = diff / (1 << c->smoothing_shift);
+    shed->pressure_permille = (uint16_t)((int32_t)shed->pressure_permille + (step != 0 ? step : diff));
+
+    // Up: straight to the highest tier whose threshold is crossed
+    uint8_t target = shed->tier;
+    while (target < LD2420_SHED_TIER_COUNT - 1u && shed->pressure_permille >= c->enter_permille[target])
+        target++;
+    if (target > shed->tier)
+    {
+        set_tier(shed, target, now_ms);
+        return (ld2420_shed_tier_t)shed->tier;
+    }
+
+    // Down: one tier, once held long enough and clearly below its threshold
+    if (shed->tier > LD2420_SHED_TIER_NONE && time_reached(now_ms, shed->tier_since_ms + c->hold_ms) &&
+        (int32_t)shed->pressure_permille + c->exit_margin_permille < (int32_t)c->enter_permille[shed->tier - 1u])
+        set_tier(shed, (uint8_t)(shed->tier - 1u), now_ms);
+    return (ld2420_shed_tier_t)shed->tier;
+}
+
+ld2420_shed_action_t ld2420_shed_classify(
+    ld2420_shed_t *shed,
+    ld2420_shed_sensor_t *sensor,
+    const uint8_t *frame,
+    uint16_t frame_size,
+    uint32_t now_ms)
+{
+    if (shed == NULL || sensor == NULL || frame == NULL || frame_size != LD2420_REPORT_ENERGY_SIZE ||
+        ld2420_protocol_read_le32(frame) != LD2420_PROTOCOL_REPORT_HEADER)
+        return LD2420_SHED_FORWARD;
+
+    const uint8_t presence = frame[LD2420_REPORT_ENERGY_PRESENCE_OFFSET];
+    const uint16_t distance_cm = ld2420_protocol_read_le16(frame + LD2420_REPORT_ENERGY_DISTANCE_CM_OFFSET);
+    const bool transition = !sensor->known || presence != sensor->presence;
+
+    if (shed->tier >= LD2420_SHED_TIER_DECIMATE && !transition)
+    {
+        const uint16_t moved = distance_cm > sensor->distance_cm ? (uint16_t)(distance_cm - sensor->distance_cm)
+                                                                 : (uint16_t)(sensor->distance_cm - distance_cm);
+        if (moved <= shed->config.distance_tolerance_cm &&
+            !time_reached(now_ms, sensor->last_forward_ms + shed->config.keepalive_ms))
+        {
+            shed->decimated++;
+            return LD2420_SHED_DROP;
+        }
+    }
+
+    sensor->known = true;
+    sensor->presence = presence;
+    sensor->distance_cm = distance_cm;
+    sensor->last_forward_ms = now_ms;
+    if (shed->tier >= LD2420_SHED_TIER_DETAIL)
+    {
+        shed->summarized++;
+        return LD2420_SHED_SUMMARY;
+    }
+    return LD2420_SHED_FORWARD;
+}
+
+const uint8_t *ld2420_shed_summary(const uint8_t *frame)
+{
+    return frame + LD2420_REPORT_ENERGY_PRESENCE_OFFSET;
+}
+
+bool ld2420_shed_consumer_due(ld2420_shed_t *shed, uint32_t *last_run_ms, uint32_t now_ms)
+{
+    if (shed == NULL || last_run_ms == NULL)
+        return true;
+
+    if (shed->tier >= LD2420_SHED_TIER_THROTTLE &&
+        !time_reached(now_ms, *last_run_ms + shed->config.throttle_interval_ms))
+    {
+        shed->deferred++;
+        return false;
+    }
+    *last_run_ms = now_ms;
+    return true;
+}
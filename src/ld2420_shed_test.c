@@ -0,0 +1,173 @@
+#include <unity.h>
+#include <string.h>
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/ld2420_shed.h>
+
+static ld2420_shed_t shed;
+static ld2420_shed_sensor_t sensor;
+static uint8_t frame[LD2420_REPORT_ENERGY_SIZE];
+
+static const uint8_t OPEN_CONFIG_ACK[] = {0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01, 0x00,
+                                          0x00, 0x02, 0x00, 0x20, 0x00, 0x04, 0x03, 0x02, 0x01};
+
+static const uint8_t *report(uint8_t presence, uint16_t distance_cm)
+{
+    ld2420_report_energy_t msg = {.presence = presence, .distance_cm = distance_cm};
+    for (int g = 0; g < 16; g++)
+        msg.energy[g] = (uint16_t)(1000u + g);
+    ld2420_report_energy_encode(frame, &msg);
+    return frame;
+}
+
+static ld2420_shed_action_t classify(uint8_t presence, uint16_t distance_cm, uint32_t now_ms)
+{
+    return ld2420_shed_classify(&shed, &sensor, report(presence, distance_cm), LD2420_REPORT_ENERGY_SIZE, now_ms);
+}
+
+/** Feed the same pressure once per millisecond over [from, to). */
+static ld2420_shed_tier_t hold_pressure(uint16_t permille, uint32_t from, uint32_t to)
+{
+    ld2420_shed_tier_t tier = (ld2420_shed_tier_t)shed.tier;
+    for (uint32_t t = from; t != to; t++)
+        tier = ld2420_shed_update(&shed, permille, 0, t);
+    return tier;
+}
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_shed_init(&shed, NULL, 0));
+    ld2420_shed_sensor_init(&sensor);
+}
+
+void tearDown(void)
+{
+}
+
+void test__shed_tiers_rise_at_once_and_fall_one_at_a_time(void)
+{
+    TEST_ASSERT_EQUAL(LD2420_SHED_TIER_NONE, hold_pressure(500, 0, 100));
+    TEST_ASSERT_EQUAL_UINT16(500, shed.pressure_permille);
+    TEST_ASSERT_EQUAL(LD2420_SHED_TIER_THROTTLE, hold_pressure(1000, 100, 120));
+
+    // Pressure just below a threshold does not step down; clearly below it does,
+    // one tier per hold time
+    TEST_ASSERT_EQUAL(LD2420_SHED_TIER_THROTTLE, hold_pressure(850, 120, 3000));
+    TEST_ASSERT_EQUAL(LD2420_SHED_TIER_DECIMATE, hold_pressure(700, 3000, 3500));
+    const uint32_t since = shed.tier_since_ms;
+    TEST_ASSERT_EQUAL(LD2420_SHED_TIER_DECIMATE, hold_pressure(0, 3500, since + 1000));
+    TEST_ASSERT_EQUAL(LD2420_SHED_TIER_DETAIL, hold_pressure(0, since + 1000, since + 1001));
+    TEST_ASSERT_EQUAL(LD2420_SHED_TIER_NONE, hold_pressure(0, since + 1001, since + 2001));
+    TEST_ASSERT_EQUAL_UINT16(0, shed.pressure_permille);
+
+    // Without smoothing a full queue goes straight to the top tier in one change
+    ld2420_shed_config_t config;
+    ld2420_shed_default_config(&config);
+    config.smoothing_shift = 0;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_shed_init(&shed, &config, 0));
+    TEST_ASSERT_EQUAL(LD2420_SHED_TIER_THROTTLE, ld2420_shed_update(&shed, 0, 1000, 1));
+    TEST_ASSERT_EQUAL_UINT32(1, shed.tier_changes);
+}
+
+void test__shed_never_drops_acks_or_presence_transitions(void)
+{
+    hold_pressure(1000, 0, 100);
+    TEST_ASSERT_EQUAL(LD2420_SHED_TIER_THROTTLE, shed.tier);
+
+    for (uint32_t t = 100; t < 600; t += 10)
+    {
+        TEST_ASSERT_EQUAL(LD2420_SHED_FORWARD,
+                          ld2420_shed_classify(&shed, &sensor, OPEN_CONFIG_ACK, sizeof(OPEN_CONFIG_ACK), t));
+        // Presence flips every frame: every one is a transition
+        TEST_ASSERT_EQUAL(LD2420_SHED_SUMMARY, classify((uint8_t)((t / 10) & 1u), 250, t));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, shed.decimated);
+    TEST_ASSERT_EQUAL_UINT32(50, shed.summarized);
+
+    // Frames that are not well-formed reports are passed on untouched
+    report(1, 250);
+    frame[0] = 0x00;
+    TEST_ASSERT_EQUAL(LD2420_SHED_FORWARD, ld2420_shed_classify(&shed, &sensor, frame, LD2420_REPORT_ENERGY_SIZE, 600));
+    TEST_ASSERT_EQUAL(LD2420_SHED_FORWARD, ld2420_shed_classify(&shed, &sensor, report(1, 250), 44, 600));
+}
+
+void test__shed_detail_tier_summarizes_reports(void)
+{
+    TEST_ASSERT_EQUAL(LD2420_SHED_FORWARD, classify(1, 320, 0));
+    hold_pressure(650, 0, 100);
+    TEST_ASSERT_EQUAL(LD2420_SHED_TIER_DETAIL, shed.tier);
+
+    // Unchanged frames are summarized but not dropped
+    for (uint32_t t = 100; t < 200; t++)
+        TEST_ASSERT_EQUAL(LD2420_SHED_SUMMARY, classify(1, 320, t));
+    const uint8_t *summary = ld2420_shed_summary(report(1, 320));
+    TEST_ASSERT_EQUAL_UINT8(1, summary[0]);
+    TEST_ASSERT_EQUAL_UINT16(320, summary[1] | summary[2] << 8);
+}
+
+void test__shed_decimate_tier_keeps_changes_and_keepalives(void)
+{
+    TEST_ASSERT_EQUAL(LD2420_SHED_FORWARD, classify(1, 300, 0));
+    hold_pressure(800, 0, 100);
+    TEST_ASSERT_EQUAL(LD2420_SHED_TIER_DECIMATE, shed.tier);
+
+    // Same presence, within the distance tolerance: dropped until the keepalive is due
+    TEST_ASSERT_EQUAL(LD2420_SHED_DROP, classify(1, 305, 100));
+    TEST_ASSERT_EQUAL(LD2420_SHED_DROP, classify(1, 295, 999));
+    TEST_ASSERT_EQUAL(LD2420_SHED_SUMMARY, classify(1, 300, 1000));
+    TEST_ASSERT_EQUAL(LD2420_SHED_DROP, classify(1, 300, 1001));
+
+    // A target that moved, and a presence change, go through at once
+    TEST_ASSERT_EQUAL(LD2420_SHED_SUMMARY, classify(1, 340, 1002));
+    TEST_ASSERT_EQUAL(LD2420_SHED_DROP, classify(1, 345, 1003));
+    TEST_ASSERT_EQUAL(LD2420_SHED_SUMMARY, classify(0, 345, 1004));
+    TEST_ASSERT_EQUAL(LD2420_SHED_SUMMARY, classify(1, 345, 1005));
+    TEST_ASSERT_EQUAL_UINT32(4, shed.decimated);
+
+    // A sensor seen for the first time is never decimated
+    ld2420_shed_sensor_init(&sensor);
+    TEST_ASSERT_EQUAL(LD2420_SHED_SUMMARY, classify(1, 345, 1006));
+}
+
+void test__shed_throttle_tier_defers_non_critical_consumers(void)
+{
+    uint32_t last_run = 0;
+    TEST_ASSERT_TRUE(ld2420_shed_consumer_due(&shed, &last_run, 5));
+    TEST_ASSERT_TRUE(ld2420_shed_consumer_due(&shed, &last_run, 6));
+
+    hold_pressure(1000, 6, 100);
+    TEST_ASSERT_EQUAL(LD2420_SHED_TIER_THROTTLE, shed.tier);
+    int runs = 0;
+    for (uint32_t t = 100; t < 3100; t++)
+        runs += ld2420_shed_consumer_due(&shed, &last_run, t);
+    TEST_ASSERT_EQUAL_INT(3, runs);
+    TEST_ASSERT_EQUAL_UINT32(2997, shed.deferred);
+}
+
+void test__shed_rejects_invalid_configuration(void)
+{
+    ld2420_shed_config_t config;
+    ld2420_shed_default_config(&config);
+    config.enter_permille[1] = config.enter_permille[0];
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_shed_init(&shed, &config, 0));
+    ld2420_shed_default_config(&config);
+    config.enter_permille[2] = 1001;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_shed_init(&shed, &config, 0));
+    ld2420_shed_default_config(&config);
+    config.smoothing_shift = 9;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_shed_init(&shed, &config, 0));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_shed_init(NULL, NULL, 0));
+    TEST_ASSERT_EQUAL(LD2420_SHED_FORWARD, ld2420_shed_classify(NULL, &sensor, frame, sizeof(frame), 0));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test__shed_tiers_rise_at_once_and_fall_one_at_a_time);
+    RUN_TEST(test__shed_never_drops_acks_or_presence_transitions);
+    RUN_TEST(test__shed_detail_tier_summarizes_reports);
+    RUN_TEST(test__shed_decimate_tier_keeps_changes_and_keepalives);
+    RUN_TEST(test__shed_throttle_tier_defers_non_critical_consumers);
+    RUN_TEST(test__shed_rejects_invalid_configuration);
+    return UNITY_END();
+}
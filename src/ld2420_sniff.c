@@ -0,0 +1,256 @@
+/*
+ * LD2420 line sniffer implementation
+ *
+ * Design Principles
+ * -----------------
+ * 1. The TX parser does little work per byte: a window compare while
+ *    searching, a store while accumulating, and one plausibility check when the
+ *    length field and command id are complete, using the per-command sizes of
+ *    the protocol table. A rejected command hands the bytes after its header
+ *    back to the search, ahead of new input, so each rejection costs at most
+ *    LD2420_MAX_TX_PACKET_SIZE bytes of searching again
+ * 2. The correlator keeps a short FIFO of waiting commands. The sensor handles
+ *    commands one at a time and in order, which makes "oldest waiting command
+ *    with this id" the right match for an ACK and lets everything older than
+ *    the match be given up. The queue (ld2420_pending_t in ld2420_internal.h)
+ *    is shared with the command statistics
+ *
+ * Memory & Threading
+ * ------------------
+ * - No dynamic allocation; all state is caller-provided
+ * - Not thread-safe; one parser per line, one correlator per tap
+ */
+
+#include <ld2420/ld2420_sniff.h>
+#include <ld2420/ld2420_protocol.h>
+#include "ld2420_internal.h"
+
+
+/** Bytes up to and including the command id. */
+#define TX_PREFIX_SIZE (LD2420_COMMAND_ID_OFFSET + 2u)
+
+LD2420_PROTOCOL_STATIC_CHECK(sniff_pending, LD2420_SNIFF_MAX_PENDING >= 1u && LD2420_SNIFF_MAX_PENDING <= UINT8_MAX);
+LD2420_PROTOCOL_STATIC_CHECK(sniff_tx_limits, LD2420_PROTOCOL_COMMAND_MAX_SIZE <= LD2420_MAX_TX_PACKET_SIZE &&
+                                                  LD2420_PROTOCOL_COMMAND_MIN_SIZE >= LD2420_MIN_TX_PACKET_SIZE);
+
+void ld2420_tx_stream_init(ld2420_tx_stream_t *s)
+{
+    if (s == NULL)
+        return;
+    s->index = 0;
+    s->expected_total_size = 0;
+    s->window = 0;
+    s->replay_offset = 0;
+    s->replay_size = 0;
+}
+
+/**
+ * Give up the command under construction and queue the bytes after its header
+ * to be searched again, in front of those still waiting from an earlier
+ * rejection.
+ */
+static void reject_command(ld2420_tx_stream_t *s)
+{
+    const uint16_t size = s->index;
+    const uint16_t rest = (uint16_t)(s->replay_size - s->replay_offset);
+
+    // A command started while replay bytes wait came entirely from them, so
+    // size <= replay_offset whenever rest != 0 and both parts fit
+    ld2420_move_bytes(&s->replay[size - 1u], &s->replay[s->replay_offset], rest);
+    ld2420_copy_bytes(s->replay, &s->buffer[1], size - 1u);
+    s->replay_offset = 0;
+    s->replay_size = (uint16_t)(size - 1u + rest);
+    s->index = 0;
+    s->window = 0;
+}
+
+/** Check a command once its length field and id are in; LD2420_STATUS_OK to keep it. */
+static ld2420_status_t check_prefix(const ld2420_tx_stream_t *s)
+{
+    const uint16_t length = ld2420_protocol_read_le16(s->buffer + LD2420_PROTOCOL_LENGTH_OFFSET);
+    const uint16_t command = ld2420_protocol_read_le16(s->buffer + LD2420_COMMAND_ID_OFFSET);
+    const uint32_t total = (uint32_t)length + LD2420_PROTOCOL_FRAME_OVERHEAD;
+
+    if (total > LD2420_MAX_TX_PACKET_SIZE)
+        return LD2420_STATUS_ERROR_BUFFER_TOO_SMALL;
+    if (total < LD2420_MIN_TX_PACKET_SIZE)
+        return LD2420_STATUS_ERROR_INVALID_FRAME_SIZE;
+    if (command > 0xFFu)
+        return LD2420_STATUS_ERROR_INVALID_PACKET;
+    if (!ld2420_protocol_command_length_valid((uint8_t)command, length))
+        return LD2420_STATUS_ERROR_INVALID_FRAME_SIZE;
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_tx_stream_feed_bytes(
+    ld2420_tx_stream_t *s,
+    const uint8_t *data,
+    size_t len,
+    ld2420_tx_stream_on_command_fn on_command,
+    void *user,
+    size_t *out_consumed)
+{
+    if (out_consumed != NULL)
+        *out_consumed = 0;
+    if (s == NULL || on_command == NULL || (data == NULL && len != 0))
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    ld2420_status_t first_error = LD2420_STATUS_OK;
+    size_t i = 0;
+    for (;;)
+    {
+        uint8_t byte;
+        if (s->replay_offset < s->replay_size)
+            byte = s->replay[s->replay_offset++];
+        else if (i < len)
+            byte = data[i++];
+        else
+            break;
+
+        if (s->index == 0)
+        {
+            s->window = s->window >> 8 | (uint32_t)byte << 24;
+            if (s->window != LD2420_PROTOCOL_COMMAND_HEADER)
+                continue;
+            ld2420_protocol_write_le32(s->buffer, s->window);
+            s->index = 4;
+            s->expected_total_size = 0;
+            s->window = 0;
+            continue;
+        }
+
+        s->buffer[s->index++] = byte;
+        if (s->index == TX_PREFIX_SIZE)
+        {
+            const ld2420_status_t status = check_prefix(s);
+            if (status != LD2420_STATUS_OK)
+            {
+                if (first_error == LD2420_STATUS_OK)
+                    first_error = status;
+                reject_command(s);
+                continue;
+            }
+            s->expected_total_size = (uint16_t)(LD2420_PROTOCOL_FRAME_OVERHEAD +
+                                                ld2420_protocol_read_le16(s->buffer + LD2420_PROTOCOL_LENGTH_OFFSET));
+        }
+        if (s->index != s->expected_total_size)
+            continue;
+
+        const uint16_t size = s->index;
+        if (ld2420_protocol_read_le32(s->buffer + size - 4u) != LD2420_PROTOCOL_COMMAND_FOOTER)
+        {
+            if (first_error == LD2420_STATUS_OK)
+                first_error = LD2420_STATUS_ERROR_INVALID_FOOTER;
+            reject_command(s);
+            continue;
+        }
+        s->index = 0;
+        if (!on_command(user, s->buffer, size, ld2420_protocol_read_le16(s->buffer + LD2420_COMMAND_ID_OFFSET)))
+            break;
+    }
+    if (out_consumed != NULL)
+        *out_consumed = i;
+    return first_error;
+}
+
+ld2420_status_t ld2420_correlator_init(
+    ld2420_correlator_t *c,
+    uint32_t timeout_us,
+    ld2420_sniff_on_transaction_fn on_transaction,
+    void *user)
+{
+    if (c == NULL || timeout_us == 0)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    ld2420_set_bytes(c, 0, sizeof(*c));
+    c->timeout_us = timeout_us;
+    c->on_transaction = on_transaction;
+    c->user = user;
+    for (uint32_t k = 0; k < 256u; k++)
+        c->stats[k].min_rtt_us = UINT32_MAX;
+    return LD2420_STATUS_OK;
+}
+
+/** Record a transaction once its command stopped waiting, answered or not. */
+static void record(
+    void *owner,
+    uint16_t command,
+    uint32_t sent_us,
+    ld2420_pending_outcome_t outcome,
+    uint16_t status,
+    uint32_t now_us)
+{
+    ld2420_correlator_t *c = (ld2420_correlator_t *)owner;
+    ld2420_sniff_transaction_t t = {
+        .command = command,
+        .command_time_us = sent_us,
+        .answered = outcome == LD2420_PENDING_ANSWERED,
+    };
+    ld2420_sniff_stats_t *st = &c->stats[t.command & 0xFFu];
+    if (t.answered)
+    {
+        t.status = status;
+        t.rtt_us = now_us - t.command_time_us;
+        st->answered++;
+        st->failed += status != 0 ? 1u : 0u;
+        st->sum_rtt_us += t.rtt_us;
+        if (t.rtt_us < st->min_rtt_us)
+            st->min_rtt_us = t.rtt_us;
+        if (t.rtt_us > st->max_rtt_us)
+            st->max_rtt_us = t.rtt_us;
+    }
+    else
+    {
+        st->unanswered++;
+    }
+
+    if (c->on_transaction != NULL)
+        c->on_transaction(c->user, &t);
+}
+
+static ld2420_pending_t pending_of(ld2420_correlator_t *c)
+{
+    const ld2420_pending_t p = {
+        .command = c->pending_command,
+        .time_us = c->pending_time_us,
+        .count = &c->pending_count,
+        .capacity = LD2420_SNIFF_MAX_PENDING,
+        .timeout_us = c->timeout_us,
+        .sink = record,
+        .owner = c,
+    };
+    return p;
+}
+
+void ld2420_correlator_advance(ld2420_correlator_t *c, uint32_t now_us)
+{
+    if (c == NULL)
+        return;
+    const ld2420_pending_t p = pending_of(c);
+    ld2420_pending_advance(&p, now_us);
+}
+
+void ld2420_correlator_command(ld2420_correlator_t *c, uint16_t command, uint32_t time_us)
+{
+    if (c == NULL)
+        return;
+    const ld2420_pending_t p = pending_of(c);
+    ld2420_pending_sent(&p, command, time_us);
+    c->stats[command & 0xFFu].commands++;
+}
+
+void ld2420_correlator_ack(ld2420_correlator_t *c, uint16_t echo, uint16_t status, uint32_t time_us)
+{
+    if (c == NULL)
+        return;
+    const ld2420_pending_t p = pending_of(c);
+    if (!ld2420_pending_ack(&p, echo, status, time_us))
+        c->orphan_acks++;
+}
+
+void ld2420_correlator_flush(ld2420_correlator_t *c)
+{
+    if (c == NULL)
+        return;
+    const ld2420_pending_t p = pending_of(c);
+    ld2420_pending_expire(&p);
+}
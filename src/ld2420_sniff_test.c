@@ -0,0 +1,274 @@
+#include <unity.h>
+#include <string.h>
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/ld2420_sniff.h>
+
+static ld2420_tx_stream_t tx;
+static ld2420_correlator_t corr;
+
+static uint16_t seen_commands[16];
+static uint16_t seen_sizes[16];
+static uint32_t seen_count;
+static uint32_t stop_after;
+
+static ld2420_sniff_transaction_t transactions[16];
+static uint32_t transaction_count;
+
+static bool on_command(void *user, const uint8_t *frame, uint16_t size, uint16_t command)
+{
+    (void)user;
+    TEST_ASSERT_EQUAL_HEX32(LD2420_PROTOCOL_COMMAND_HEADER, ld2420_protocol_read_le32(frame));
+    seen_commands[seen_count] = command;
+    seen_sizes[seen_count] = size;
+    seen_count++;
+    return seen_count != stop_after;
+}
+
+static void on_transaction(void *user, const ld2420_sniff_transaction_t *t)
+{
+    TEST_ASSERT_TRUE(user == &corr);
+    transactions[transaction_count++] = *t;
+}
+
+static uint16_t open_config(uint8_t *out)
+{
+    const ld2420_command_open_config_mode_t msg = {.protocol_version = 1};
+    return ld2420_command_open_config_mode_encode(out, &msg);
+}
+
+static uint16_t read_config(uint8_t *out, uint16_t count)
+{
+    ld2420_command_read_config_t msg = {.parameters_count = count};
+    for (uint16_t i = 0; i < count; i++)
+        msg.parameters[i] = i;
+    return ld2420_command_read_config_encode(out, &msg);
+}
+
+void setUp(void)
+{
+    ld2420_tx_stream_init(&tx);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_correlator_init(&corr, 1000000u, on_transaction, &corr));
+    seen_count = 0;
+    stop_after = 0;
+    transaction_count = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test__tx_stream_finds_commands_in_any_chunking_and_skips_noise(void)
+{
+    uint8_t line[512];
+    size_t len = 0;
+    const uint8_t noise[] = {0x00, 0xFD, 0xFC, 0xFB, 0x11, 0xF4, 0xF3};
+    memcpy(line + len, noise, sizeof(noise));
+    len += sizeof(noise);
+    len += open_config(line + len);
+    len += read_config(line + len, 35);
+    len += ld2420_command_close_config_mode_encode(line + len);
+    len += ld2420_command_reboot_encode(line + len);
+
+    for (size_t chunk = 1; chunk <= len; chunk += 7)
+    {
+        ld2420_tx_stream_init(&tx);
+        seen_count = 0;
+        for (size_t off = 0; off < len; off += chunk)
+        {
+            const size_t n = (len - off < chunk) ? len - off : chunk;
+            TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_tx_stream_feed_bytes(&tx, line + off, n, on_command, NULL, NULL));
+        }
+        TEST_ASSERT_EQUAL_UINT32(4, seen_count);
+        TEST_ASSERT_EQUAL_HEX16(LD2420_CMD_OPEN_CONFIG_MODE, seen_commands[0]);
+        TEST_ASSERT_EQUAL_UINT16(LD2420_COMMAND_OPEN_CONFIG_MODE_SIZE, seen_sizes[0]);
+        TEST_ASSERT_EQUAL_HEX16(LD2420_CMD_READ_CONFIG, seen_commands[1]);
+        TEST_ASSERT_EQUAL_UINT16(LD2420_MAX_TX_PACKET_SIZE - 140u, seen_sizes[1]);
+        TEST_ASSERT_EQUAL_HEX16(LD2420_CMD_CLOSE_CONFIG_MODE, seen_commands[2]);
+        TEST_ASSERT_EQUAL_HEX16(LD2420_CMD_REBOOT, seen_commands[3]);
+    }
+}
+
+void test__tx_stream_rejects_implausible_commands_early_and_resyncs(void)
+{
+    uint8_t frame[LD2420_MAX_TX_PACKET_SIZE];
+    const uint16_t size = open_config(frame);
+
+    // Longer than any command
+    const uint8_t too_long[] = {0xFD, 0xFC, 0xFB, 0xFA, 0xE0, 0x00, 0xFF, 0x00};
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_BUFFER_TOO_SMALL,
+                      ld2420_tx_stream_feed_bytes(&tx, too_long, sizeof(too_long), on_command, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT16(0, tx.index);
+
+    // A length that the open command never has, rejected before its payload
+    const uint8_t wrong_length[] = {0xFD, 0xFC, 0xFB, 0xFA, 0x06, 0x00, 0xFF, 0x00};
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FRAME_SIZE,
+                      ld2420_tx_stream_feed_bytes(&tx, wrong_length, sizeof(wrong_length), on_command, NULL, NULL));
+
+    // An ACK on the TX line
+    uint8_t ack[LD2420_PROTOCOL_ACK_MAX_SIZE];
+    const ld2420_ack_open_config_mode_t ack_msg = {.protocol_version = 1, .buffer_size = 64};
+    const uint16_t ack_size = ld2420_ack_open_config_mode_encode(ack, &ack_msg);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_PACKET,
+                      ld2420_tx_stream_feed_bytes(&tx, ack, ack_size, on_command, NULL, NULL));
+
+    frame[size - 1] ^= 0xFF;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FOOTER,
+                      ld2420_tx_stream_feed_bytes(&tx, frame, size, on_command, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, seen_count);
+
+    frame[size - 1] ^= 0xFF;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_tx_stream_feed_bytes(&tx, frame, size, on_command, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1, seen_count);
+}
+
+void test__tx_stream_finds_commands_behind_a_corrupted_length(void)
+{
+    // A read command whose length now claims 64 bytes, with three commands
+    // inside that span
+    uint8_t line[256];
+    size_t len = read_config(line, 2);
+    line[LD2420_PROTOCOL_LENGTH_OFFSET] = 0x40;
+    const size_t first = len;
+    len += open_config(line + len);
+    len += read_config(line + len, 4);
+    len += ld2420_command_close_config_mode_encode(line + len);
+    TEST_ASSERT_LESS_THAN(LD2420_PROTOCOL_FRAME_OVERHEAD + 0x40u, len);
+    memset(line + len, 0x00, 48);
+    len += 48;
+
+    for (size_t chunk = 1; chunk <= len; chunk += 5)
+    {
+        ld2420_tx_stream_init(&tx);
+        seen_count = 0;
+        ld2420_status_t first_error = LD2420_STATUS_OK;
+        for (size_t off = 0; off < len; off += chunk)
+        {
+            const size_t n = (len - off < chunk) ? len - off : chunk;
+            const ld2420_status_t st = ld2420_tx_stream_feed_bytes(&tx, line + off, n, on_command, NULL, NULL);
+            if (first_error == LD2420_STATUS_OK)
+                first_error = st;
+        }
+        TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FOOTER, first_error);
+        TEST_ASSERT_EQUAL_UINT32(3, seen_count);
+        TEST_ASSERT_EQUAL_HEX16(LD2420_CMD_OPEN_CONFIG_MODE, seen_commands[0]);
+        TEST_ASSERT_EQUAL_HEX16(LD2420_CMD_READ_CONFIG, seen_commands[1]);
+        TEST_ASSERT_EQUAL_HEX16(LD2420_CMD_CLOSE_CONFIG_MODE, seen_commands[2]);
+    }
+
+    // Stopping on a command found again keeps the rest for the next call
+    ld2420_tx_stream_init(&tx);
+    seen_count = 0;
+    stop_after = 1;
+    size_t consumed = 0;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FOOTER,
+                      ld2420_tx_stream_feed_bytes(&tx, line, len, on_command, NULL, &consumed));
+    TEST_ASSERT_EQUAL_UINT32(1, seen_count);
+    TEST_ASSERT_GREATER_THAN(first, consumed);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK,
+                      ld2420_tx_stream_feed_bytes(&tx, line + consumed, len - consumed, on_command, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT32(3, seen_count);
+}
+
+void test__tx_stream_stops_when_the_callback_asks(void)
+{
+    uint8_t line[64];
+    size_t len = open_config(line);
+    len += ld2420_command_close_config_mode_encode(line + len);
+
+    stop_after = 1;
+    size_t consumed = 0;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_tx_stream_feed_bytes(&tx, line, len, on_command, NULL, &consumed));
+    TEST_ASSERT_EQUAL_size_t(LD2420_COMMAND_OPEN_CONFIG_MODE_SIZE, consumed);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK,
+                      ld2420_tx_stream_feed_bytes(&tx, line + consumed, len - consumed, on_command, NULL, &consumed));
+    TEST_ASSERT_EQUAL_UINT32(2, seen_count);
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_tx_stream_feed_bytes(NULL, line, 1, on_command, NULL, NULL));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_tx_stream_feed_bytes(&tx, NULL, 1, on_command, NULL, NULL));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_tx_stream_feed_bytes(&tx, line, 1, NULL, NULL, NULL));
+}
+
+void test__correlator_pairs_acks_with_commands_and_keeps_per_command_rtt(void)
+{
+    const uint16_t echo_flag = LD2420_PROTOCOL_ACK_ECHO_FLAG;
+    ld2420_correlator_command(&corr, LD2420_CMD_OPEN_CONFIG_MODE, 1000);
+    ld2420_correlator_ack(&corr, LD2420_CMD_OPEN_CONFIG_MODE | echo_flag, 0, 3500);
+    ld2420_correlator_command(&corr, LD2420_CMD_READ_CONFIG, 10000);
+    ld2420_correlator_ack(&corr, LD2420_CMD_READ_CONFIG | echo_flag, 0, 14000);
+    ld2420_correlator_command(&corr, LD2420_CMD_READ_CONFIG, 20000);
+    ld2420_correlator_ack(&corr, LD2420_CMD_READ_CONFIG | echo_flag, 1, 30000);
+
+    TEST_ASSERT_EQUAL_UINT32(3, transaction_count);
+    TEST_ASSERT_TRUE(transactions[0].answered);
+    TEST_ASSERT_EQUAL_HEX16(LD2420_CMD_OPEN_CONFIG_MODE, transactions[0].command);
+    TEST_ASSERT_EQUAL_UINT32(2500, transactions[0].rtt_us);
+    TEST_ASSERT_EQUAL_UINT16(1, transactions[2].status);
+
+    const ld2420_sniff_stats_t *st = &corr.stats[LD2420_CMD_READ_CONFIG];
+    TEST_ASSERT_EQUAL_UINT32(2, st->commands);
+    TEST_ASSERT_EQUAL_UINT32(2, st->answered);
+    TEST_ASSERT_EQUAL_UINT32(1, st->failed);
+    TEST_ASSERT_EQUAL_UINT32(0, st->unanswered);
+    TEST_ASSERT_EQUAL_UINT32(4000, st->min_rtt_us);
+    TEST_ASSERT_EQUAL_UINT32(10000, st->max_rtt_us);
+    TEST_ASSERT_EQUAL_UINT64(14000, st->sum_rtt_us);
+    TEST_ASSERT_EQUAL_UINT32(0, corr.orphan_acks);
+}
+
+void test__correlator_gives_up_skipped_retried_and_timed_out_commands(void)
+{
+    const uint16_t echo_flag = LD2420_PROTOCOL_ACK_ECHO_FLAG;
+
+    // Answered out of order: the older command got no ACK
+    ld2420_correlator_command(&corr, LD2420_CMD_OPEN_CONFIG_MODE, 0);
+    ld2420_correlator_command(&corr, LD2420_CMD_READ_VERSION_NUMBER, 100);
+    ld2420_correlator_ack(&corr, LD2420_CMD_READ_VERSION_NUMBER | echo_flag, 0, 600);
+    TEST_ASSERT_EQUAL_UINT32(2, transaction_count);
+    TEST_ASSERT_FALSE(transactions[0].answered);
+    TEST_ASSERT_EQUAL_UINT32(500, transactions[1].rtt_us);
+
+    // A retry gives up the first attempt, and the ACK goes to the retry
+    ld2420_correlator_command(&corr, LD2420_CMD_REBOOT, 1000);
+    ld2420_correlator_command(&corr, LD2420_CMD_REBOOT, 2000);
+    ld2420_correlator_ack(&corr, LD2420_CMD_REBOOT | echo_flag, 0, 2300);
+    TEST_ASSERT_EQUAL_UINT32(1, corr.stats[LD2420_CMD_REBOOT].unanswered);
+    TEST_ASSERT_EQUAL_UINT32(300, corr.stats[LD2420_CMD_REBOOT].max_rtt_us);
+
+    // Timed out across a clock wrap, then its late ACK is an orphan
+    const uint32_t t0 = UINT32_MAX - 1000u;
+    ld2420_correlator_command(&corr, LD2420_CMD_CLOSE_CONFIG_MODE, t0);
+    ld2420_correlator_advance(&corr, t0 + 500000u);
+    TEST_ASSERT_EQUAL_UINT8(1, corr.pending_count);
+    ld2420_correlator_advance(&corr, t0 + 1000001u);
+    TEST_ASSERT_EQUAL_UINT8(0, corr.pending_count);
+    ld2420_correlator_ack(&corr, LD2420_CMD_CLOSE_CONFIG_MODE | echo_flag, 0, t0 + 1000002u);
+    TEST_ASSERT_EQUAL_UINT32(1, corr.stats[LD2420_CMD_CLOSE_CONFIG_MODE].unanswered);
+    TEST_ASSERT_EQUAL_UINT32(1, corr.orphan_acks);
+
+    // An echo without the ACK flag never matches; full queues give up the oldest
+    ld2420_correlator_command(&corr, LD2420_CMD_READ_CONFIG, 10);
+    ld2420_correlator_ack(&corr, LD2420_CMD_READ_CONFIG, 0, 20);
+    TEST_ASSERT_EQUAL_UINT32(2, corr.orphan_acks);
+    for (uint16_t k = 0; k < LD2420_SNIFF_MAX_PENDING; k++)
+        ld2420_correlator_command(&corr, (uint16_t)(0x10u + k), 30);
+    TEST_ASSERT_EQUAL_UINT8(LD2420_SNIFF_MAX_PENDING, corr.pending_count);
+    TEST_ASSERT_EQUAL_UINT32(1, corr.stats[LD2420_CMD_READ_CONFIG].unanswered);
+    ld2420_correlator_flush(&corr);
+    TEST_ASSERT_EQUAL_UINT8(0, corr.pending_count);
+    TEST_ASSERT_EQUAL_UINT32(1, corr.stats[0x17].unanswered);
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_correlator_init(&corr, 0, NULL, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test__tx_stream_finds_commands_in_any_chunking_and_skips_noise);
+    RUN_TEST(test__tx_stream_rejects_implausible_commands_early_and_resyncs);
+    RUN_TEST(test__tx_stream_finds_commands_behind_a_corrupted_length);
+    RUN_TEST(test__tx_stream_stops_when_the_callback_asks);
+    RUN_TEST(test__correlator_pairs_acks_with_commands_and_keeps_per_command_rtt);
+    RUN_TEST(test__correlator_gives_up_skipped_retried_and_timed_out_commands);
+    return UNITY_END();
+}
@@ -3,7 +3,8 @@
  *
  * Design Principles
  * -----------------
- * 1. Feed one byte at a time via ld2420_stream_feed()
+ * 1. Feed one byte at a time via ld2420_stream_feed(), or a chunk via
+ *    ld2420_stream_feed_bytes(); both run the same per-byte step
  * 2. On each byte, validate the buffer state
  * 3. If a complete valid frame is assembled, invoke the callback
  * 4. If a frame is corrupted, discard it and return error status
@@ -14,6 +15,14 @@
  * - SYNCED: Header found, accumulating frame bytes
  * - FRAME_READY: Complete frame assembled, footer validated, ready to parse
  *
+ * While SYNCED, further headers inside the frame under construction are
+ * tracked as candidate frame starts; the first frame to complete with a
+ * valid footer wins, and a failed front frame hands over to the oldest
+ * candidate instead of rescanning the buffer.
+ *
+ * Between calls the context is always NOT_SYNCED with at most 3 bytes (a
+ * partial header) or SYNCED with incomplete frames; snapshots rely on this.
+ *
  * Memory & Threading
  * ------------------
  * - Single linear buffer sized to LD2420_MAX_RX_PACKET_SIZE
@@ -21,25 +30,13 @@
  * - No dynamic allocation
  */
 
-#include <string.h>
-
 #include <ld2420/ld2420.h>
 #include <ld2420/ld2420_stream.h>
+#include <ld2420/ld2420_protocol.h>
+#include "ld2420_internal.h"
 
-/**
- * When compiling for a big-endian platform, we need to use helper routines
- * to read/write little-endian multi-byte values.
- */
-#ifdef LD2420_PLATFORM_BE
-/**
- * Read a 16-bit little-endian value from a buffer regardless of host endianness.
- * Example: bytes [0xFF, 0x01] represent 0x01FF in little-endian.
- */
-static inline uint16_t read_le16_inline(const uint8_t *b)
-{
-    return (uint16_t)b[0] | ((uint16_t)b[1] << 8);
-}
-#endif
+// Headers and footers are compared as one word
+LD2420_PROTOCOL_STATIC_CHECK(marker_size, sizeof(LD2420_BEG_COMMAND_PACKET) == 4u && sizeof(LD2420_END_COMMAND_PACKET) == 4u);
 
 void ld2420_stream_init(ld2420_stream_t *s)
 {
@@ -48,73 +45,237 @@ void ld2420_stream_init(ld2420_stream_t *s)
     s->index = 0;
     s->expected_total_size = 0;
     s->synced = false;
+    s->candidate_count = 0;
 }
 
+/** Bytes of a frame needed before its size can be judged: header, length and command echo. */
+#define FRAME_SIZE_KNOWN (LD2420_ACK_CMD_ECHO_OFFSET + 2u)
+
 /**
- * Scan backwards through the current buffer to find the last occurrence of the
- * 4-byte header. If found, move it to the front and return true. Otherwise
- * keep at most 3 trailing bytes (potential partial header) and return false.
+ * Expected total size of the frame starting at `frame`, which holds at least
+ * FRAME_SIZE_KNOWN bytes. Lengths beyond the buffer, echoes without the ACK
+ * flag, and lengths that no ACK of the echoed command can have are rejected.
  */
-static bool resync_to_next_header(ld2420_stream_t *s)
+static ld2420_status_t frame_total_size(const uint8_t *frame, uint16_t *out_total)
 {
-    const uint16_t header_size = sizeof(LD2420_BEG_COMMAND_PACKET);
+    LD2420_COUNT_WORK(FRAME_SIZE_KNOWN - LD2420_PROTOCOL_LENGTH_OFFSET);
+    const uint16_t frame_len = ld2420_protocol_read_le16(&frame[LD2420_PROTOCOL_LENGTH_OFFSET]);
+    const uint16_t echo = ld2420_protocol_read_le16(&frame[LD2420_ACK_CMD_ECHO_OFFSET]);
+    // total = header(4) + len(2) + frame_len + footer(4)
+    const uint32_t total = LD2420_PROTOCOL_FRAME_OVERHEAD + (uint32_t)frame_len;
 
-    // Scan backwards for the last occurrence of a valid header
-    for (int16_t i = (int16_t)(s->index - header_size); i >= 0; --i)
+    if (total > LD2420_MAX_RX_PACKET_SIZE)
+        return LD2420_STATUS_ERROR_BUFFER_TOO_SMALL;
+    // Command ids are one byte; an ACK echoes them with exactly the flag above
+    if ((echo & 0xFF00u) != LD2420_PROTOCOL_ACK_ECHO_FLAG ||
+        !ld2420_protocol_ack_length_valid((uint8_t)echo, frame_len))
+        return LD2420_STATUS_ERROR_INVALID_FRAME_SIZE;
+
+    *out_total = (uint16_t)total;
+    return LD2420_STATUS_OK;
+}
+
+/** True if a complete frame of `total` bytes at `frame` ends with the footer. */
+static bool frame_footer_valid(const uint8_t *frame, uint16_t total)
+{
+    const uint16_t footer_size = sizeof(LD2420_END_COMMAND_PACKET);
+    LD2420_COUNT_WORK(footer_size);
+    return ld2420_word_equal(&frame[total - footer_size], LD2420_END_COMMAND_PACKET);
+}
+
+static void remove_candidate(ld2420_stream_t *s, uint8_t i)
+{
+    for (; i + 1u < s->candidate_count; i++)
     {
-        if (memcmp(&s->buffer[i], LD2420_BEG_COMMAND_PACKET, header_size) == 0)
-        {
-            // Found header at position i
-            uint16_t remaining = s->index - i;
-            memmove(s->buffer, &s->buffer[i], remaining);
-            s->index = remaining;
-            s->synced = true;
-            s->expected_total_size = 0;
-            return true;
-        }
+        s->candidate_start[i] = s->candidate_start[i + 1u];
+        s->candidate_total_size[i] = s->candidate_total_size[i + 1u];
+    }
+    s->candidate_count--;
+}
+
+/**
+ * Drop the frame at buffer[0]. The oldest candidate, if any, moves to the
+ * front and becomes the frame under construction. Otherwise at most 3
+ * trailing bytes (a potential partial header) are kept and the parser
+ * searches again.
+ *
+ * Every candidate is moved at most once and only by the bytes received since
+ * its header, so this costs at most LD2420_STREAM_MAX_CANDIDATES + 1 bytes of
+ * work per input byte on any input.
+ */
+static void discard_front_frame(ld2420_stream_t *s)
+{
+    if (s->candidate_count > 0)
+    {
+        const uint8_t start = s->candidate_start[0];
+        const uint16_t remaining = s->index - start;
+        ld2420_move_bytes(s->buffer, &s->buffer[start], remaining);
+        LD2420_COUNT_WORK(remaining);
+        s->index = remaining;
+        s->expected_total_size = s->candidate_total_size[0];
+        remove_candidate(s, 0);
+        for (uint8_t i = 0; i < s->candidate_count; i++)
+            s->candidate_start[i] = (uint8_t)(s->candidate_start[i] - start);
+        return;
     }
 
-    // No full header found; preserve up to 3 trailing bytes (max header overlap)
+    const uint16_t header_size = sizeof(LD2420_BEG_COMMAND_PACKET);
     uint16_t keep = (s->index < header_size - 1) ? s->index : (header_size - 1);
     if (keep > 0 && keep < s->index)
-        memmove(s->buffer, &s->buffer[s->index - keep], keep);
+    {
+        ld2420_move_bytes(s->buffer, &s->buffer[s->index - keep], keep);
+        LD2420_COUNT_WORK(keep);
+    }
     s->index = keep;
     s->synced = false;
     s->expected_total_size = 0;
-    return false;
 }
 
-ld2420_status_t ld2420_stream_feed(
+/**
+ * Parse and emit the complete frame at buffer[start], which ends at the last
+ * buffered byte, then start over with an empty buffer. `result` is the status
+ * gathered so far for this byte.
+ */
+static ld2420_status_t emit_frame(
     ld2420_stream_t *s,
-    const uint8_t *data,
-    size_t len,
-    ld2420_stream_on_frame_fn on_frame)
+    uint16_t start,
+    uint16_t total,
+    ld2420_status_t result,
+    ld2420_stream_on_frame_fn on_frame,
+    bool *stop)
 {
-    // Validate arguments
-    if (!s || !on_frame)
-        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    uint16_t out_frame_size = 0, out_cmd_echo = 0, out_status = 0,
+             opt_out_param_name = 0, opt_out_param_value = 0;
+    ld2420_status_t parse_status = ld2420_parse_rx_buffer(
+        &s->buffer[start],
+        (uint8_t)total,
+        &out_frame_size,
+        &out_cmd_echo,
+        &out_status,
+        &opt_out_param_name,
+        &opt_out_param_value);
 
-    // Allow empty feed (data==NULL && len==0) as a valid no-op
-    if (!data || len == 0)
-        return LD2420_STATUS_OK;
+    if (parse_status == LD2420_STATUS_OK)
+    {
+        // Valid frame; invoke callback
+        if (!on_frame(&s->buffer[start], total, out_cmd_echo, out_status))
+            *stop = true;
+    }
+    else if (result == LD2420_STATUS_OK)
+    {
+        // Parse failed; treat as corrupted frame
+        result = LD2420_STATUS_ERROR_INVALID_PACKET;
+    }
 
-    // For now, feed only one byte at a time per specification
-    if (len != 1)
-        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    // Frames are checked on every byte, so nothing follows the emitted one
+    s->index = 0;
+    s->expected_total_size = 0;
+    s->synced = false;
+    s->candidate_count = 0;
+    return result;
+}
 
-    uint8_t byte = data[0];
+/**
+ * Evaluate a synced buffer after a byte was appended: learn the expected
+ * sizes of the frame at the front and of the candidates once their length
+ * fields are in, and emit the first of them that completes with a valid
+ * footer. The front frame completes first when several end on this byte.
+ *
+ * Returns the first error encountered; sets *stop when the callback asks to
+ * stop consuming input.
+ */
+static ld2420_status_t evaluate_synced_buffer(
+    ld2420_stream_t *s,
+    ld2420_stream_on_frame_fn on_frame,
+    bool *stop)
+{
+    ld2420_status_t result = LD2420_STATUS_OK;
+    bool front_failed = false;
 
-    // Buffer overflow check
-    if (s->index >= sizeof(s->buffer))
+    if (s->expected_total_size == 0 && s->index >= FRAME_SIZE_KNOWN)
     {
-        // Try to resync; if still can't sync, discard and start fresh
-        if (!resync_to_next_header(s))
+        result = frame_total_size(s->buffer, &s->expected_total_size);
+        front_failed = result != LD2420_STATUS_OK;
+    }
+    else if (s->expected_total_size != 0 && s->index == s->expected_total_size)
+    {
+        if (frame_footer_valid(s->buffer, s->expected_total_size))
+            return emit_frame(s, 0, s->expected_total_size, result, on_frame, stop);
+        result = LD2420_STATUS_ERROR_INVALID_FOOTER;
+        front_failed = true;
+    }
+
+    uint8_t i = 0;
+    while (i < s->candidate_count)
+    {
+        const uint16_t start = s->candidate_start[i];
+        const uint16_t total = s->candidate_total_size[i];
+        if (total == 0)
         {
-            s->index = 0;
-            s->synced = false;
-            s->expected_total_size = 0;
-            return LD2420_STATUS_ERROR_BUFFER_TOO_SMALL;
+            if (s->index >= start + FRAME_SIZE_KNOWN &&
+                frame_total_size(&s->buffer[start], &s->candidate_total_size[i]) != LD2420_STATUS_OK)
+            {
+                remove_candidate(s, i);
+                continue;
+            }
+        }
+        else if (s->index == start + total)
+        {
+            if (frame_footer_valid(&s->buffer[start], total))
+            {
+                // The frame at the front overlapped a valid one, so its
+                // length field was wrong
+                if (result == LD2420_STATUS_OK)
+                    result = LD2420_STATUS_ERROR_INVALID_FRAME_SIZE;
+                return emit_frame(s, start, total, result, on_frame, stop);
+            }
+            remove_candidate(s, i);
+            continue;
         }
+        i++;
+    }
+
+    if (front_failed)
+        discard_front_frame(s);
+    return result;
+}
+
+/**
+ * While a frame is under construction, remember a header that ends with the
+ * byte just appended as a candidate frame start, if a slot is free.
+ */
+static void track_candidate_header(ld2420_stream_t *s, uint8_t byte)
+{
+    const uint16_t header_size = sizeof(LD2420_BEG_COMMAND_PACKET);
+    if (byte != LD2420_BEG_COMMAND_PACKET[header_size - 1] || s->index <= header_size ||
+        s->candidate_count >= LD2420_STREAM_MAX_CANDIDATES)
+        return;
+
+    LD2420_COUNT_WORK(header_size);
+    if (ld2420_word_equal(&s->buffer[s->index - header_size], LD2420_BEG_COMMAND_PACKET))
+    {
+        s->candidate_start[s->candidate_count] = (uint8_t)(s->index - header_size);
+        s->candidate_total_size[s->candidate_count] = 0;
+        s->candidate_count++;
+    }
+}
+
+/** Process a single byte. Shared by the single-byte and chunked entry points. */
+static ld2420_status_t stream_feed_byte(
+    ld2420_stream_t *s,
+    uint8_t byte,
+    ld2420_stream_on_frame_fn on_frame,
+    bool *stop)
+{
+    LD2420_COUNT_WORK(1);
+
+    // Buffer overflow check. Evaluation consumes a frame as soon as it is
+    // complete, so this only guards against a corrupted context.
+    if (s->index >= sizeof(s->buffer))
+    {
+        discard_front_frame(s);
+        if (!s->synced)
+            return LD2420_STATUS_ERROR_BUFFER_TOO_SMALL;
     }
 
     // Add the byte to the buffer
@@ -126,96 +287,193 @@ ld2420_status_t ld2420_stream_feed(
         const uint16_t header_size = sizeof(LD2420_BEG_COMMAND_PACKET);
         if (s->index >= header_size)
         {
-            if (memcmp(&s->buffer[s->index - header_size], LD2420_BEG_COMMAND_PACKET, header_size) == 0)
+            LD2420_COUNT_WORK(header_size);
+            if (ld2420_word_equal(&s->buffer[s->index - header_size], LD2420_BEG_COMMAND_PACKET))
             {
                 // Align header to front
                 uint16_t remaining = s->index - (s->index - header_size);
-                memmove(s->buffer, &s->buffer[s->index - header_size], remaining);
+                ld2420_move_bytes(s->buffer, &s->buffer[s->index - header_size], remaining);
                 s->index = remaining;
                 s->synced = true;
                 s->expected_total_size = 0;
+                s->candidate_count = 0;
             }
-            else if (s->index >= header_size)
+            else
             {
                 // Shift buffer left by 1 to continue searching for header
-                memmove(s->buffer, &s->buffer[1], s->index - 1);
+                ld2420_move_bytes(s->buffer, &s->buffer[1], s->index - 1);
+                LD2420_COUNT_WORK(s->index - 1);
                 s->index--;
             }
         }
         return LD2420_STATUS_OK;
     }
 
-    // We are synced (buffer starts with header). Check if we can determine expected size.
-    if (s->expected_total_size == 0 && s->index >= sizeof(LD2420_BEG_COMMAND_PACKET) + 2)
+    track_candidate_header(s, byte);
+    return evaluate_synced_buffer(s, on_frame, stop);
+}
+
+ld2420_status_t ld2420_stream_feed(
+    ld2420_stream_t *s,
+    const uint8_t *data,
+    size_t len,
+    ld2420_stream_on_frame_fn on_frame)
+{
+    // Validate arguments
+    if (!s || !on_frame)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    // Allow empty feed (data==NULL && len==0) as a valid no-op
+    if (!data || len == 0)
+        return LD2420_STATUS_OK;
+
+    // Feed only one byte at a time per specification; chunks go through
+    // ld2420_stream_feed_bytes()
+    if (len != 1)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    bool stop = false;
+    return stream_feed_byte(s, data[0], on_frame, &stop);
+}
+
+ld2420_status_t ld2420_stream_feed_bytes(
+    ld2420_stream_t *s,
+    const uint8_t *data,
+    size_t len,
+    ld2420_stream_on_frame_fn on_frame,
+    size_t *out_consumed)
+{
+    if (out_consumed)
+        *out_consumed = 0;
+
+    // Validate arguments
+    if (!s || !on_frame)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    // Allow empty feed (data==NULL && len==0) as a valid no-op
+    if (!data || len == 0)
+        return LD2420_STATUS_OK;
+
+    ld2420_status_t result = LD2420_STATUS_OK;
+    bool stop = false;
+    size_t i = 0;
+    while (i < len && !stop)
     {
-        // We have header + 2-byte length field; compute expected total size
-#ifdef LD2420_PLATFORM_BE
-        uint16_t frame_len = read_le16_inline(&s->buffer[sizeof(LD2420_BEG_COMMAND_PACKET)]);
-#else
-        uint16_t frame_len = *(uint16_t *)(&s->buffer[sizeof(LD2420_BEG_COMMAND_PACKET)]);
-#endif
-        // total = header(4) + len(2) + frame_len + footer(4)
-        uint32_t total = (uint32_t)sizeof(LD2420_BEG_COMMAND_PACKET) + 2u + (uint32_t)frame_len + (uint32_t)sizeof(LD2420_END_COMMAND_PACKET);
-
-        if (total > sizeof(s->buffer) || total > LD2420_MAX_RX_PACKET_SIZE)
-        {
-            // Invalid length; resync to next header or discard
-            if (!resync_to_next_header(s))
-            {
-                s->index = 0;
-                s->synced = false;
-            }
-            return LD2420_STATUS_ERROR_BUFFER_TOO_SMALL;
-        }
-        s->expected_total_size = (uint16_t)total;
+        ld2420_status_t status = stream_feed_byte(s, data[i++], on_frame, &stop);
+        if (result == LD2420_STATUS_OK)
+            result = status;
     }
 
-    // If we know the expected size and buffer is complete, validate and emit
-    if (s->expected_total_size > 0 && s->index == s->expected_total_size)
+    if (out_consumed)
+        *out_consumed = i;
+    return result;
+}
+
+/** Magic at the start of a snapshot. */
+static const uint8_t SNAPSHOT_MAGIC[] = {'L', 'S'};
+
+ld2420_status_t ld2420_stream_snapshot(
+    const ld2420_stream_t *s,
+    uint8_t *out,
+    size_t out_size,
+    size_t *out_written)
+{
+    if (!s || !out || !out_written)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    const size_t total = LD2420_STREAM_SNAPSHOT_HEADER_SIZE + (size_t)s->index;
+    if (s->index > sizeof(s->buffer) || out_size < total)
+        return LD2420_STATUS_ERROR_BUFFER_TOO_SMALL;
+
+    out[0] = SNAPSHOT_MAGIC[0];
+    out[1] = SNAPSHOT_MAGIC[1];
+    out[2] = LD2420_STREAM_SNAPSHOT_VERSION;
+    out[3] = s->synced ? 0x01 : 0x00;
+    out[4] = (uint8_t)s->index;
+    out[5] = (uint8_t)(s->index >> 8);
+    out[6] = (uint8_t)s->expected_total_size;
+    out[7] = (uint8_t)(s->expected_total_size >> 8);
+    out[8] = s->candidate_count;
+    for (uint8_t i = 0; i < LD2420_STREAM_MAX_CANDIDATES; i++)
+        out[9 + i] = (i < s->candidate_count) ? s->candidate_start[i] : 0;
+    ld2420_copy_bytes(&out[LD2420_STREAM_SNAPSHOT_HEADER_SIZE], s->buffer, s->index);
+
+    *out_written = total;
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_stream_restore(
+    ld2420_stream_t *s,
+    const uint8_t *in,
+    size_t in_size)
+{
+    if (!s || !in)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    if (in_size < LD2420_STREAM_SNAPSHOT_HEADER_SIZE)
+        return LD2420_STATUS_ERROR_INVALID_BUFFER_SIZE;
+    if (in[0] != SNAPSHOT_MAGIC[0] || in[1] != SNAPSHOT_MAGIC[1] || in[2] != LD2420_STREAM_SNAPSHOT_VERSION)
+        return LD2420_STATUS_ERROR_INVALID_HEADER;
+
+    const bool synced = (in[3] & 0x01) != 0;
+    const uint16_t index = (uint16_t)in[4] | ((uint16_t)in[5] << 8);
+    const uint16_t expected = (uint16_t)in[6] | ((uint16_t)in[7] << 8);
+    if (in_size != LD2420_STREAM_SNAPSHOT_HEADER_SIZE + (size_t)index)
+        return LD2420_STATUS_ERROR_INVALID_BUFFER_SIZE;
+    if ((in[3] & ~0x01) != 0 || index >= sizeof(s->buffer))
+        return LD2420_STATUS_ERROR_INVALID_PACKET;
+
+    const uint8_t *buffer = &in[LD2420_STREAM_SNAPSHOT_HEADER_SIZE];
+    const uint16_t header_size = sizeof(LD2420_BEG_COMMAND_PACKET);
+    const uint8_t candidate_count = in[8];
+    uint16_t candidate_total_size[LD2420_STREAM_MAX_CANDIDATES] = {0};
+    if (!synced)
     {
-        // Validate footer
-        const uint16_t footer_offset = s->expected_total_size - sizeof(LD2420_END_COMMAND_PACKET);
-        if (memcmp(&s->buffer[footer_offset], LD2420_END_COMMAND_PACKET, sizeof(LD2420_END_COMMAND_PACKET)) != 0)
-        {
-            // Footer mismatch; resync or discard
-            if (!resync_to_next_header(s))
-            {
-                s->index = 0;
-                s->synced = false;
-            }
-            return LD2420_STATUS_ERROR_INVALID_FOOTER;
-        }
+        // Only a partial header is kept while searching
+        if (index >= header_size || expected != 0 || candidate_count != 0)
+            return LD2420_STATUS_ERROR_INVALID_PACKET;
+    }
+    else
+    {
+        if (index < header_size || !ld2420_word_equal(buffer, LD2420_BEG_COMMAND_PACKET))
+            return LD2420_STATUS_ERROR_INVALID_PACKET;
 
-        // Frame is complete and footer is valid; parse metadata
-        uint16_t out_frame_size = 0, out_cmd_echo = 0, out_status = 0,
-                 opt_out_param_name = 0, opt_out_param_value = 0;
-        ld2420_status_t parse_status = ld2420_parse_rx_buffer(
-            s->buffer,
-            (uint8_t)s->expected_total_size,
-            &out_frame_size,
-            &out_cmd_echo,
-            &out_status,
-            &opt_out_param_name,
-            &opt_out_param_value);
-
-        if (parse_status == LD2420_STATUS_OK)
-        {
-            // Valid frame; invoke callback
-            on_frame(s->buffer, s->expected_total_size, out_cmd_echo, out_status);
-        }
-        else
+        // The expected size is known exactly when the length field and command
+        // echo are buffered, and a complete frame is always consumed before the
+        // call returns
+        uint16_t total = 0;
+        if (index >= FRAME_SIZE_KNOWN &&
+            (frame_total_size(buffer, &total) != LD2420_STATUS_OK || index >= total))
+            return LD2420_STATUS_ERROR_INVALID_PACKET;
+        if (expected != total)
+            return LD2420_STATUS_ERROR_INVALID_PACKET;
+
+        // Same for every candidate, which must follow the previous frame start
+        if (candidate_count > LD2420_STREAM_MAX_CANDIDATES)
+            return LD2420_STATUS_ERROR_INVALID_PACKET;
+        uint16_t previous = 0;
+        for (uint8_t i = 0; i < candidate_count; i++)
         {
-            // Parse failed; treat as corrupted frame
-            parse_status = LD2420_STATUS_ERROR_INVALID_PACKET;
+            const uint16_t start = in[9 + i];
+            if (start <= previous || start + header_size > index ||
+                !ld2420_word_equal(&buffer[start], LD2420_BEG_COMMAND_PACKET))
+                return LD2420_STATUS_ERROR_INVALID_PACKET;
+            if (index >= start + FRAME_SIZE_KNOWN &&
+                (frame_total_size(&buffer[start], &candidate_total_size[i]) != LD2420_STATUS_OK ||
+                 index >= start + candidate_total_size[i]))
+                return LD2420_STATUS_ERROR_INVALID_PACKET;
+            previous = start;
         }
-
-        // Reset for next frame
-        s->index = 0;
-        s->expected_total_size = 0;
-        s->synced = false;
-
-        return parse_status;
     }
 
+    ld2420_copy_bytes(s->buffer, buffer, index);
+    s->index = index;
+    s->expected_total_size = expected;
+    s->synced = synced;
+    s->candidate_count = candidate_count;
+    for (uint8_t i = 0; i < candidate_count; i++)
+    {
+        s->candidate_start[i] = in[9 + i];
+        s->candidate_total_size[i] = candidate_total_size[i];
+    }
     return LD2420_STATUS_OK;
 }
@@ -1,5 +1,6 @@
 #include <unity.h>
 #include <stdlib.h>
+#include <string.h>
 #include <ld2420/ld2420.h>
 #include <ld2420/ld2420_stream.h>
 
@@ -71,9 +72,220 @@ void test__streaming_parser_handles_chunking(void)
     TEST_ASSERT_EQUAL_UINT16(TOTAL, stream_packet_len);
 }
 
+void test__streaming_parser_feed_bytes_matches_bytewise(void)
+{
+    // Noise, a frame with a valid header but broken footer, then two good frames.
+    static const uint8_t INPUT[] = {
+        0x00, 0xFD, 0xFC,                               // noise incl. partial header
+        0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01, // corrupted frame...
+        0x00, 0x00, 0x02, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, // ...bad footer
+        0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01, // good frame
+        0x00, 0x00, 0x02, 0x00, 0x20, 0x00, 0x04, 0x03, 0x02, 0x01,
+        0xFD, 0xFC, 0xFB, 0xFA, 0x04, 0x00, 0xFE, 0x01, // good frame
+        0x00, 0x00, 0x04, 0x03, 0x02, 0x01};
+
+    ld2420_stream_t s;
+    ld2420_stream_init(&s);
+    for (size_t i = 0; i < sizeof(INPUT); i++)
+        ld2420_stream_feed(&s, &INPUT[i], 1, on_stream_frame);
+    const int bytewise_frames = stream_frames;
+    const uint16_t bytewise_cmd = stream_cmd;
+
+    setUp();
+    ld2420_stream_init(&s);
+    size_t consumed = 0;
+    ld2420_status_t status = ld2420_stream_feed_bytes(&s, INPUT, sizeof(INPUT), on_stream_frame, &consumed);
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FOOTER, status);
+    TEST_ASSERT_EQUAL(sizeof(INPUT), consumed);
+    TEST_ASSERT_EQUAL(2, bytewise_frames);
+    TEST_ASSERT_EQUAL(bytewise_frames, stream_frames);
+    TEST_ASSERT_EQUAL_UINT16(bytewise_cmd, stream_cmd);
+    TEST_ASSERT_EQUAL_UINT16(0xFE, stream_cmd);
+}
+
+void test__streaming_parser_recovers_after_oversized_garbage(void)
+{
+    // A header followed by a length that fits but a missing footer used to
+    // re-select the same header on resync and then overrun the buffer.
+    uint8_t input[LD2420_MAX_RX_PACKET_SIZE * 3];
+    size_t n = 0;
+    static const uint8_t HEADER_LEN[] = {0xFD, 0xFC, 0xFB, 0xFA, 0x40, 0x00};
+    static const uint8_t FRAME[] = {
+        0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01,
+        0x00, 0x00, 0x02, 0x00, 0x20, 0x00, 0x04, 0x03, 0x02, 0x01};
+    for (size_t i = 0; i < sizeof(HEADER_LEN); i++)
+        input[n++] = HEADER_LEN[i];
+    while (n < sizeof(input) - sizeof(FRAME))
+        input[n++] = 0x55;
+    for (size_t i = 0; i < sizeof(FRAME); i++)
+        input[n++] = FRAME[i];
+
+    ld2420_stream_t s;
+    ld2420_stream_init(&s);
+    ld2420_stream_feed_bytes(&s, input, n, on_stream_frame, NULL);
+
+    TEST_ASSERT_EQUAL(1, stream_frames);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(FRAME), stream_packet_len);
+    TEST_ASSERT_TRUE(s.index <= LD2420_MAX_RX_PACKET_SIZE);
+}
+
+void test__streaming_parser_corrupted_length_does_not_swallow_frames(void)
+{
+    static const uint8_t INPUT[] = {
+        0xFD, 0xFC, 0xFB, 0xFA, 0x40, 0x00, 0x55, 0x55, // length 64 that fits, unknown command
+        0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01, // good frame inside it
+        0x00, 0x00, 0x02, 0x00, 0x20, 0x00, 0x04, 0x03, 0x02, 0x01,
+        0xFD, 0xFC, 0xFB, 0xFA, 0x20, 0x00, 0xFF, 0x01, // length no OPEN CONFIG ACK can have
+        0xFD, 0xFC, 0xFB, 0xFA, 0x04, 0x00, 0xFE, 0x01, // good frame
+        0x00, 0x00, 0x04, 0x03, 0x02, 0x01};
+
+    ld2420_stream_t s;
+    ld2420_stream_init(&s);
+    size_t consumed = 0;
+    ld2420_status_t status = ld2420_stream_feed_bytes(&s, INPUT, 26, on_stream_frame, &consumed);
+
+    // Emitted as soon as it completes, long before the bogus length runs out
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FRAME_SIZE, status);
+    TEST_ASSERT_EQUAL(1, stream_frames);
+    TEST_ASSERT_EQUAL_UINT16(0xFF, stream_cmd);
+    TEST_ASSERT_EQUAL_UINT16(18, stream_packet_len);
+
+    // Rejected as soon as the command echo is in
+    status = ld2420_stream_feed_bytes(&s, &INPUT[26], 8, on_stream_frame, &consumed);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FRAME_SIZE, status);
+    TEST_ASSERT_FALSE(s.synced);
+
+    status = ld2420_stream_feed_bytes(&s, &INPUT[34], sizeof(INPUT) - 34, on_stream_frame, &consumed);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, status);
+    TEST_ASSERT_EQUAL(2, stream_frames);
+    TEST_ASSERT_EQUAL_UINT16(0xFE, stream_cmd);
+    TEST_ASSERT_EQUAL(0, s.index);
+}
+
+void test__streaming_parser_requires_the_ack_echo_flag(void)
+{
+    // An OPEN CONFIG ACK as it should be, echoed without the flag, and with a
+    // stray bit above it
+    static const uint8_t INPUT[] = {
+        0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x00,
+        0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x03,
+        0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01,
+        0x00, 0x00, 0x02, 0x00, 0x20, 0x00, 0x04, 0x03, 0x02, 0x01};
+
+    ld2420_stream_t s;
+    ld2420_stream_init(&s);
+    size_t consumed = 0;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FRAME_SIZE,
+                      ld2420_stream_feed_bytes(&s, INPUT, 8, on_stream_frame, &consumed));
+    TEST_ASSERT_FALSE(s.synced);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FRAME_SIZE,
+                      ld2420_stream_feed_bytes(&s, &INPUT[8], 8, on_stream_frame, &consumed));
+    TEST_ASSERT_EQUAL(0, stream_frames);
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK,
+                      ld2420_stream_feed_bytes(&s, &INPUT[16], sizeof(INPUT) - 16, on_stream_frame, &consumed));
+    TEST_ASSERT_EQUAL(1, stream_frames);
+    TEST_ASSERT_EQUAL_UINT16(0xFF, stream_cmd);
+}
+
+void test__streaming_parser_snapshot_resumes_at_every_split(void)
+{
+    // Noise, a partial header, then two good frames
+    static const uint8_t INPUT[] = {
+        0x55, 0xFD, 0xFC, 0xFB,
+        0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01,
+        0x00, 0x00, 0x02, 0x00, 0x20, 0x00, 0x04, 0x03, 0x02, 0x01,
+        0xFD, 0xFC, 0xFB, 0xFA, 0x04, 0x00, 0xFE, 0x01,
+        0x00, 0x00, 0x04, 0x03, 0x02, 0x01};
+
+    for (size_t split = 0; split <= sizeof(INPUT); split++)
+    {
+        setUp();
+        ld2420_stream_t before;
+        ld2420_stream_init(&before);
+        ld2420_stream_feed_bytes(&before, INPUT, split, on_stream_frame, NULL);
+
+        uint8_t snapshot[LD2420_STREAM_SNAPSHOT_MAX_SIZE];
+        size_t written = 0;
+        TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_stream_snapshot(&before, snapshot, sizeof(snapshot), &written));
+        TEST_ASSERT_EQUAL(LD2420_STREAM_SNAPSHOT_HEADER_SIZE + before.index, written);
+
+        // Restore into a context holding unrelated state
+        ld2420_stream_t after;
+        ld2420_stream_init(&after);
+        ld2420_stream_feed_bytes(&after, INPUT, 10, on_stream_frame, NULL);
+        TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_stream_restore(&after, snapshot, written));
+
+        const int frames_before = stream_frames;
+        ld2420_stream_feed_bytes(&after, &INPUT[split], sizeof(INPUT) - split, on_stream_frame, NULL);
+
+        // No frame lost or duplicated, whatever the split point
+        TEST_ASSERT_EQUAL(2, stream_frames);
+        TEST_ASSERT_TRUE(frames_before <= 2);
+        TEST_ASSERT_EQUAL_UINT16(0xFE, stream_cmd);
+    }
+}
+
+void test__streaming_parser_restore_rejects_invalid_snapshots(void)
+{
+    static const uint8_t PARTIAL[] = {0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01};
+    ld2420_stream_t s;
+    ld2420_stream_init(&s);
+    ld2420_stream_feed_bytes(&s, PARTIAL, sizeof(PARTIAL), on_stream_frame, NULL);
+
+    uint8_t good[LD2420_STREAM_SNAPSHOT_MAX_SIZE];
+    size_t size = 0;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_stream_snapshot(&s, good, sizeof(good), &size));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_BUFFER_TOO_SMALL, ld2420_stream_snapshot(&s, good, size - 1, &size));
+
+    ld2420_stream_t target;
+    ld2420_stream_init(&target);
+    uint8_t bad[LD2420_STREAM_SNAPSHOT_MAX_SIZE];
+
+    // Unsupported version
+    memcpy(bad, good, size);
+    bad[2] = LD2420_STREAM_SNAPSHOT_VERSION + 1;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_HEADER, ld2420_stream_restore(&target, bad, size));
+
+    // Truncated
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_BUFFER_SIZE, ld2420_stream_restore(&target, good, size - 1));
+
+    // Expected size not matching the buffered length field
+    memcpy(bad, good, size);
+    bad[6]++;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_PACKET, ld2420_stream_restore(&target, bad, size));
+
+    // Synced without a header at the front
+    memcpy(bad, good, size);
+    bad[LD2420_STREAM_SNAPSHOT_HEADER_SIZE] = 0x00;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_PACKET, ld2420_stream_restore(&target, bad, size));
+
+    // Not synced but holding more than a partial header
+    memcpy(bad, good, size);
+    bad[3] = 0x00;
+    bad[6] = bad[7] = 0x00;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_PACKET, ld2420_stream_restore(&target, bad, size));
+
+    // Rejected snapshots leave the context untouched
+    TEST_ASSERT_EQUAL(0, target.index);
+    TEST_ASSERT_FALSE(target.synced);
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_stream_restore(&target, good, size));
+    TEST_ASSERT_EQUAL(s.index, target.index);
+    TEST_ASSERT_EQUAL(s.expected_total_size, target.expected_total_size);
+    TEST_ASSERT_TRUE(target.synced);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
     RUN_TEST(test__streaming_parser_handles_chunking);
+    RUN_TEST(test__streaming_parser_feed_bytes_matches_bytewise);
+    RUN_TEST(test__streaming_parser_recovers_after_oversized_garbage);
+    RUN_TEST(test__streaming_parser_corrupted_length_does_not_swallow_frames);
+    RUN_TEST(test__streaming_parser_requires_the_ack_echo_flag);
+    RUN_TEST(test__streaming_parser_snapshot_resumes_at_every_split);
+    RUN_TEST(test__streaming_parser_restore_rejects_invalid_snapshots);
     return UNITY_END();
-}
\ No newline at end of file
+}
@@ -0,0 +1,349 @@
+/*
+ * LD2420 binary telemetry implementation
+ *
+ * Design Principles
+ * -----------------
+ * 1. Events are encoded into a scratch buffer first and copied into the
+ *    message only if they fit, so a full message is never left with half an
+ *    event or with sensor state that no event in it reflects
+ * 2. Delta state is stamped with the message it belongs to instead of being
+ *    cleared per message, so starting a message costs the same for 1 and for
+ *    10000 sensors
+ * 3. The decoder bounds every read by the message size and rejects sensor ids
+ *    it has no state for, so a malformed datagram cannot reach past either
+ *
+ * Memory & Threading
+ * ------------------
+ * - No dynamic allocation; sensor states belong to the caller
+ * - Not thread-safe; use one encoder/decoder per stream
+ */
+
+#include <ld2420/ld2420_telemetry.h>
+#include <ld2420/ld2420_protocol.h>
+#include "ld2420_internal.h"
+
+/** Bytes of an ACK frame before its payload: header, length, echo, status. */
+#define TELEMETRY_ACK_PAYLOAD_OFFSET (LD2420_PROTOCOL_PAYLOAD_OFFSET + 4u)
+
+static size_t put_varint(uint8_t *out, uint32_t v)
+{
+    size_t n = 0;
+    while (v >= 0x80u)
+    {
+        out[n++] = (uint8_t)(v | 0x80u);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static size_t put_svarint(uint8_t *out, int32_t v)
+{
+    return put_varint(out, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+/** Read a varint of at most 5 bytes; false if it runs past end or is too long. */
+static bool get_varint(const uint8_t **p, const uint8_t *end, uint32_t *v)
+{
+    uint32_t result = 0;
+    for (unsigned shift = 0; shift < 35u && *p < end; shift += 7u)
+    {
+        const uint8_t b = *(*p)++;
+        result |= (uint32_t)(b & 0x7Fu) << shift;
+        if ((b & 0x80u) == 0)
+        {
+            *v = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool get_svarint(const uint8_t **p, const uint8_t *end, int32_t *v)
+{
+    uint32_t u;
+    if (!get_varint(p, end, &u))
+        return false;
+    *v = (int32_t)(u >> 1) ^ -(int32_t)(u & 1u);
+    return true;
+}
+
+/** Sensor state for this message; zero for a sensor's first event in it. */
+static ld2420_telemetry_sensor_t *sensor_for(ld2420_telemetry_sensor_t *sensors, uint16_t id, uint32_t stamp)
+{
+    ld2420_telemetry_sensor_t *s = &sensors[id];
+    if (s->stamp != stamp)
+    {
+        ld2420_set_bytes(s, 0, sizeof(*s));
+        s->stamp = stamp;
+    }
+    return s;
+}
+
+/** Stamps start at 1 so that zero-initialized sensor states never match. */
+static uint32_t next_stamp(uint32_t stamp)
+{
+    return stamp + 1u != 0 ? stamp + 1u : 1u;
+}
+
+ld2420_status_t ld2420_telemetry_encoder_init(
+    ld2420_telemetry_encoder_t *enc,
+    ld2420_telemetry_sensor_t *sensors,
+    uint16_t sensor_count)
+{
+    if (enc == NULL || sensors == NULL || sensor_count == 0)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    ld2420_set_bytes(enc, 0, sizeof(*enc));
+    ld2420_set_bytes(sensors, 0, sensor_count * sizeof(*sensors));
+    enc->sensors = sensors;
+    enc->sensor_count = sensor_count;
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_telemetry_begin(
+    ld2420_telemetry_encoder_t *enc,
+    uint8_t *out,
+    size_t out_size,
+    uint32_t timestamp_ms)
+{
+    if (enc == NULL || out == NULL)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    if (out_size < LD2420_TELEMETRY_MAX_HEADER_SIZE + LD2420_TELEMETRY_MAX_EVENT_SIZE)
+        return LD2420_STATUS_ERROR_BUFFER_TOO_SMALL;
+
+    enc->out = out;
+    enc->out_size = out_size;
+    enc->events = 0;
+    enc->last_timestamp_ms = timestamp_ms;
+    enc->stamp = next_stamp(enc->stamp);
+    out[0] = LD2420_TELEMETRY_VERSION;
+    enc->used = 1;
+    enc->used += put_varint(&out[enc->used], enc->next_sequence);
+    enc->used += put_varint(&out[enc->used], timestamp_ms);
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_telemetry_append(ld2420_telemetry_encoder_t *enc, const ld2420_telemetry_event_t *event)
+{
+    if (enc == NULL || event == NULL || enc->out == NULL || event->sensor_id >= enc->sensor_count)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    uint8_t scratch[LD2420_TELEMETRY_MAX_EVENT_SIZE];
+    size_t n = 0;
+    scratch[n++] = event->kind;
+    n += put_varint(&scratch[n], event->sensor_id);
+    n += put_svarint(&scratch[n], (int32_t)(event->timestamp_ms - enc->last_timestamp_ms));
+
+    // Deltas are computed against a copy and committed only once the event fits
+    ld2420_telemetry_sensor_t *sensor = sensor_for(enc->sensors, event->sensor_id, enc->stamp);
+    ld2420_telemetry_sensor_t next = *sensor;
+    switch (event->kind)
+    {
+    case LD2420_TELEMETRY_ACK:
+        if (event->payload_size > LD2420_TELEMETRY_MAX_ACK_PAYLOAD || (event->payload == NULL && event->payload_size > 0))
+            return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+        n += put_varint(&scratch[n], event->cmd_echo);
+        n += put_varint(&scratch[n], event->status);
+        n += put_varint(&scratch[n], event->payload_size);
+        if (event->payload_size > 0)
+            ld2420_copy_bytes(&scratch[n], event->payload, event->payload_size);
+        n += event->payload_size;
+        break;
+    case LD2420_TELEMETRY_REPORT:
+    case LD2420_TELEMETRY_PRESENCE:
+        scratch[n++] = event->presence;
+        n += put_svarint(&scratch[n], (int32_t)event->distance_cm - (int32_t)sensor->distance_cm);
+        next.distance_cm = event->distance_cm;
+        if (event->kind == LD2420_TELEMETRY_REPORT)
+        {
+            for (uint8_t g = 0; g < LD2420_TELEMETRY_GATES; g++)
+            {
+                n += put_svarint(&scratch[n], (int32_t)event->energy[g] - (int32_t)sensor->energy[g]);
+                next.energy[g] = event->energy[g];
+            }
+        }
+        break;
+    default:
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    }
+
+    if (n > enc->out_size - enc->used)
+        return LD2420_STATUS_ERROR_BUFFER_TOO_SMALL;
+    ld2420_copy_bytes(&enc->out[enc->used], scratch, n);
+    enc->used += n;
+    *sensor = next;
+    enc->last_timestamp_ms = event->timestamp_ms;
+    enc->events++;
+    return LD2420_STATUS_OK;
+}
+
+size_t ld2420_telemetry_end(ld2420_telemetry_encoder_t *enc)
+{
+    if (enc == NULL || enc->out == NULL)
+        return 0;
+    const size_t size = enc->events > 0 ? enc->used : 0;
+    if (size > 0)
+    {
+        enc->next_sequence++;
+        enc->messages++;
+        enc->total_events += enc->events;
+    }
+    enc->out = NULL;
+    enc->used = 0;
+    enc->events = 0;
+    return size;
+}
+
+ld2420_status_t ld2420_telemetry_event_from_frame(
+    const uint8_t *frame,
+    uint16_t frame_size,
+    uint16_t sensor_id,
+    uint32_t timestamp_ms,
+    ld2420_telemetry_event_t *event)
+{
+    if (frame == NULL || event == NULL)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    ld2420_set_bytes(event, 0, sizeof(*event));
+    event->sensor_id = sensor_id;
+    event->timestamp_ms = timestamp_ms;
+
+    if (frame_size == LD2420_REPORT_ENERGY_SIZE && ld2420_protocol_read_le32(frame) == LD2420_PROTOCOL_REPORT_HEADER)
+    {
+        ld2420_report_energy_t report;
+        if (ld2420_report_energy_decode(frame, frame_size, &report) != LD2420_STATUS_OK)
+            return LD2420_STATUS_ERROR_INVALID_FRAME;
+        event->kind = LD2420_TELEMETRY_REPORT;
+        event->presence = report.presence;
+        event->distance_cm = report.distance_cm;
+        ld2420_copy_bytes(event->energy, report.energy, sizeof(event->energy));
+        return LD2420_STATUS_OK;
+    }
+
+    if (frame_size < LD2420_PROTOCOL_ACK_MIN_SIZE || frame_size > LD2420_PROTOCOL_ACK_MAX_SIZE ||
+        ld2420_protocol_read_le32(frame) != LD2420_PROTOCOL_COMMAND_HEADER ||
+        ld2420_protocol_read_le32(frame + frame_size - 4u) != LD2420_PROTOCOL_COMMAND_FOOTER ||
+        ld2420_protocol_read_le16(frame + LD2420_PROTOCOL_LENGTH_OFFSET) != frame_size - LD2420_PROTOCOL_FRAME_OVERHEAD)
+        return LD2420_STATUS_ERROR_INVALID_FRAME;
+    event->kind = LD2420_TELEMETRY_ACK;
+    event->cmd_echo = ld2420_protocol_read_le16(frame + LD2420_PROTOCOL_PAYLOAD_OFFSET);
+    event->status = ld2420_protocol_read_le16(frame + LD2420_PROTOCOL_PAYLOAD_OFFSET + 2u);
+    event->payload = frame + TELEMETRY_ACK_PAYLOAD_OFFSET;
+    event->payload_size = (uint16_t)(frame_size - LD2420_PROTOCOL_ACK_MIN_SIZE);
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_telemetry_decoder_init(
+    ld2420_telemetry_decoder_t *dec,
+    ld2420_telemetry_sensor_t *sensors,
+    uint16_t sensor_count)
+{
+    if (dec == NULL || sensors == NULL || sensor_count == 0)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    ld2420_set_bytes(dec, 0, sizeof(*dec));
+    ld2420_set_bytes(sensors, 0, sensor_count * sizeof(*sensors));
+    dec->sensors = sensors;
+    dec->sensor_count = sensor_count;
+    return LD2420_STATUS_OK;
+}
+
+/** Decode one event at *p; false if it is malformed. */
+static bool decode_event(
+    ld2420_telemetry_decoder_t *dec,
+    const uint8_t **p,
+    const uint8_t *end,
+    uint32_t *timestamp_ms,
+    ld2420_telemetry_event_t *event)
+{
+    uint32_t sensor_id, v;
+    int32_t dt, delta;
+    event->kind = *(*p)++;
+    if (!get_varint(p, end, &sensor_id) || sensor_id >= dec->sensor_count || !get_svarint(p, end, &dt))
+        return false;
+    *timestamp_ms += (uint32_t)dt;
+    event->sensor_id = (uint16_t)sensor_id;
+    event->timestamp_ms = *timestamp_ms;
+
+    ld2420_telemetry_sensor_t *sensor = sensor_for(dec->sensors, event->sensor_id, dec->stamp);
+    switch (event->kind)
+    {
+    case LD2420_TELEMETRY_ACK:
+        if (!get_varint(p, end, &v))
+            return false;
+        event->cmd_echo = (uint16_t)v;
+        if (!get_varint(p, end, &v))
+            return false;
+        event->status = (uint16_t)v;
+        if (!get_varint(p, end, &v) || v > LD2420_TELEMETRY_MAX_ACK_PAYLOAD || v > (size_t)(end - *p))
+            return false;
+        event->payload = *p;
+        event->payload_size = (uint16_t)v;
+        *p += v;
+        return true;
+    case LD2420_TELEMETRY_REPORT:
+    case LD2420_TELEMETRY_PRESENCE:
+        if (*p == end)
+            return false;
+        event->presence = *(*p)++;
+        if (!get_svarint(p, end, &delta))
+            return false;
+        sensor->distance_cm = (uint16_t)(sensor->distance_cm + delta);
+        event->distance_cm = sensor->distance_cm;
+        if (event->kind == LD2420_TELEMETRY_REPORT)
+        {
+            for (uint8_t g = 0; g < LD2420_TELEMETRY_GATES; g++)
+            {
+                if (!get_svarint(p, end, &delta))
+                    return false;
+                sensor->energy[g] = (uint16_t)(sensor->energy[g] + delta);
+                event->energy[g] = sensor->energy[g];
+            }
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+ld2420_status_t ld2420_telemetry_decode(
+    ld2420_telemetry_decoder_t *dec,
+    const uint8_t *message,
+    size_t size,
+    ld2420_telemetry_on_event_fn on_event,
+    void *user)
+{
+    if (dec == NULL || message == NULL || on_event == NULL)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    const uint8_t *p = message;
+    const uint8_t *end = message + size;
+    uint32_t sequence, timestamp_ms;
+    if (size == 0 || *p++ != LD2420_TELEMETRY_VERSION || !get_varint(&p, end, &sequence) ||
+        !get_varint(&p, end, &timestamp_ms))
+    {
+        dec->corrupt_messages++;
+        return LD2420_STATUS_ERROR_INVALID_PACKET;
+    }
+
+    if (dec->have_sequence && sequence != dec->next_sequence)
+        dec->lost_messages += sequence - dec->next_sequence;
+    dec->have_sequence = true;
+    dec->next_sequence = sequence + 1u;
+    dec->stamp = next_stamp(dec->stamp);
+    dec->messages++;
+
+    ld2420_telemetry_event_t event;
+    while (p < end)
+    {
+        ld2420_set_bytes(&event, 0, sizeof(event));
+        if (!decode_event(dec, &p, end, &timestamp_ms, &event))
+        {
+            dec->corrupt_messages++;
+            return LD2420_STATUS_ERROR_INVALID_PACKET;
+        }
+        dec->events++;
+        if (!on_event(user, &event))
+            break;
+    }
+    return LD2420_STATUS_OK;
+}
@@ -0,0 +1,215 @@
+#include <unity.h>
+#include <string.h>
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/ld2420_telemetry.h>
+
+#define SENSORS 8u
+
+static ld2420_telemetry_sensor_t enc_sensors[SENSORS];
+static ld2420_telemetry_sensor_t dec_sensors[SENSORS];
+static ld2420_telemetry_encoder_t enc;
+static ld2420_telemetry_decoder_t dec;
+static uint8_t message[512];
+
+/** Events seen by the decoder callback. */
+static ld2420_telemetry_event_t seen[64];
+static uint8_t seen_payloads[64][LD2420_TELEMETRY_MAX_ACK_PAYLOAD];
+static int seen_count;
+
+static const uint8_t OPEN_CONFIG_ACK[] = {0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01, 0x00,
+                                          0x00, 0x02, 0x00, 0x20, 0x00, 0x04, 0x03, 0x02, 0x01};
+
+static bool on_event(void *user, const ld2420_telemetry_event_t *event)
+{
+    (void)user;
+    if (seen_count < 64)
+    {
+        seen[seen_count] = *event;
+        if (event->payload_size > 0)
+            memcpy(seen_payloads[seen_count], event->payload, event->payload_size);
+        seen[seen_count].payload = seen_payloads[seen_count];
+    }
+    seen_count++;
+    return true;
+}
+
+static ld2420_telemetry_event_t report_event(uint16_t sensor, uint32_t t, uint16_t distance_cm, uint16_t level)
+{
+    ld2420_telemetry_event_t e = {.kind = LD2420_TELEMETRY_REPORT, .sensor_id = sensor, .timestamp_ms = t};
+    e.presence = 1;
+    e.distance_cm = distance_cm;
+    for (uint8_t g = 0; g < LD2420_TELEMETRY_GATES; g++)
+        e.energy[g] = (uint16_t)(level + g * 900u);
+    return e;
+}
+
+static void assert_report(const ld2420_telemetry_event_t *expected, const ld2420_telemetry_event_t *actual)
+{
+    TEST_ASSERT_EQUAL_UINT8(expected->kind, actual->kind);
+    TEST_ASSERT_EQUAL_UINT16(expected->sensor_id, actual->sensor_id);
+    TEST_ASSERT_EQUAL_UINT32(expected->timestamp_ms, actual->timestamp_ms);
+    TEST_ASSERT_EQUAL_UINT8(expected->presence, actual->presence);
+    TEST_ASSERT_EQUAL_UINT16(expected->distance_cm, actual->distance_cm);
+    TEST_ASSERT_EQUAL_MEMORY(expected->energy, actual->energy, LD2420_TELEMETRY_GATES * sizeof(uint16_t));
+}
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_encoder_init(&enc, enc_sensors, SENSORS));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_decoder_init(&dec, dec_sensors, SENSORS));
+    seen_count = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test__telemetry_round_trips_mixed_sensors_and_kinds(void)
+{
+    ld2420_telemetry_event_t events[6];
+    events[0] = report_event(3, 1000, 250, 5000);
+    events[1] = report_event(5, 1001, 80, 60000);
+    events[2] = report_event(3, 1050, 262, 5012);
+    events[3] = (ld2420_telemetry_event_t){.kind = LD2420_TELEMETRY_PRESENCE, .sensor_id = 5, .timestamp_ms = 1049,
+                                           .presence = 0, .distance_cm = 0};
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK,
+                      ld2420_telemetry_event_from_frame(OPEN_CONFIG_ACK, sizeof(OPEN_CONFIG_ACK), 7, 1100, &events[4]));
+    events[5] = report_event(5, 1120, 65535, 0);
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_begin(&enc, message, sizeof(message), 1000));
+    for (int i = 0; i < 6; i++)
+        TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_append(&enc, &events[i]));
+    const size_t size = ld2420_telemetry_end(&enc);
+    TEST_ASSERT_GREATER_THAN(0, size);
+    TEST_ASSERT_EQUAL_UINT32(1, enc.messages);
+    TEST_ASSERT_EQUAL_UINT32(6, enc.total_events);
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_decode(&dec, message, size, on_event, NULL));
+    TEST_ASSERT_EQUAL_INT(6, seen_count);
+    for (int i = 0; i < 6; i++)
+    {
+        if (events[i].kind != LD2420_TELEMETRY_ACK)
+            assert_report(&events[i], &seen[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, seen[3].energy[0]);
+    TEST_ASSERT_EQUAL(LD2420_TELEMETRY_ACK, seen[4].kind);
+    TEST_ASSERT_EQUAL_UINT16(0x01FF, seen[4].cmd_echo);
+    TEST_ASSERT_EQUAL_UINT16(0, seen[4].status);
+    TEST_ASSERT_EQUAL_UINT16(4, seen[4].payload_size);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&OPEN_CONFIG_ACK[10], seen[4].payload, 4);
+}
+
+void test__telemetry_steady_reports_are_small(void)
+{
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_begin(&enc, message, sizeof(message), 0));
+    ld2420_telemetry_event_t e = report_event(1, 0, 300, 4000);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_append(&enc, &e));
+    const size_t first = enc.used;
+
+    // Energies within +-63 of the previous report take one byte each
+    e = report_event(1, 50, 302, 4040);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_append(&enc, &e));
+    TEST_ASSERT_LESS_OR_EQUAL(25, enc.used - first);
+    TEST_ASSERT_LESS_THAN(LD2420_REPORT_ENERGY_SIZE, enc.used - first);
+}
+
+void test__telemetry_full_message_starts_the_next_one_cleanly(void)
+{
+    static uint8_t small[LD2420_TELEMETRY_MAX_HEADER_SIZE + LD2420_TELEMETRY_MAX_EVENT_SIZE];
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_begin(&enc, small, sizeof(small), 0));
+    uint32_t appended = 0;
+    ld2420_telemetry_event_t e = report_event(2, 0, 100, 30000);
+    while (ld2420_telemetry_append(&enc, &e) == LD2420_STATUS_OK)
+    {
+        appended++;
+        e = report_event(2, appended, (uint16_t)(100 + appended), (uint16_t)(30000 + appended));
+    }
+    const size_t used = enc.used;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_BUFFER_TOO_SMALL, ld2420_telemetry_append(&enc, &e));
+    TEST_ASSERT_EQUAL_size_t(used, enc.used);
+    const size_t size1 = ld2420_telemetry_end(&enc);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_decode(&dec, small, size1, on_event, NULL));
+    TEST_ASSERT_EQUAL_INT((int)appended, seen_count);
+
+    // The rejected event goes into the next message, which the decoder reads on its own
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_begin(&enc, message, sizeof(message), appended));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_append(&enc, &e));
+    const size_t size2 = ld2420_telemetry_end(&enc);
+    ld2420_telemetry_decoder_init(&dec, dec_sensors, SENSORS);
+    seen_count = 0;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_decode(&dec, message, size2, on_event, NULL));
+    TEST_ASSERT_EQUAL_INT(1, seen_count);
+    assert_report(&e, &seen[0]);
+}
+
+void test__telemetry_decoder_counts_lost_and_corrupt_messages(void)
+{
+    uint8_t messages[3][64];
+    size_t sizes[3];
+    for (uint32_t m = 0; m < 3; m++)
+    {
+        ld2420_telemetry_event_t e = report_event((uint16_t)m, m * 100u, 200, 1000);
+        ld2420_telemetry_begin(&enc, message, sizeof(message), m * 100u);
+        ld2420_telemetry_append(&enc, &e);
+        sizes[m] = ld2420_telemetry_end(&enc);
+        memcpy(messages[m], message, sizes[m]);
+    }
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_decode(&dec, messages[0], sizes[0], on_event, NULL));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_decode(&dec, messages[2], sizes[2], on_event, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1, dec.lost_messages);
+    TEST_ASSERT_EQUAL_INT(2, seen_count);
+
+    // Truncated, wrong version, unknown kind, sensor id without state
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_PACKET,
+                      ld2420_telemetry_decode(&dec, messages[1], sizes[1] - 1u, on_event, NULL));
+    messages[1][0] = 2;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_PACKET,
+                      ld2420_telemetry_decode(&dec, messages[1], sizes[1], on_event, NULL));
+    const uint8_t unknown_kind[] = {LD2420_TELEMETRY_VERSION, 9, 0, 0x07, 0, 0};
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_PACKET,
+                      ld2420_telemetry_decode(&dec, unknown_kind, sizeof(unknown_kind), on_event, NULL));
+    const uint8_t bad_sensor[] = {LD2420_TELEMETRY_VERSION, 10, 0, LD2420_TELEMETRY_PRESENCE, SENSORS, 0, 1, 0};
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_PACKET,
+                      ld2420_telemetry_decode(&dec, bad_sensor, sizeof(bad_sensor), on_event, NULL));
+    TEST_ASSERT_EQUAL_UINT32(4, dec.corrupt_messages);
+    TEST_ASSERT_EQUAL_INT(2, seen_count);
+}
+
+void test__telemetry_event_from_frame_classifies_frames(void)
+{
+    ld2420_telemetry_event_t e;
+    ld2420_report_energy_t report = {.presence = 1, .distance_cm = 410};
+    for (int g = 0; g < 16; g++)
+        report.energy[g] = (uint16_t)(g * 300);
+    uint8_t frame[LD2420_REPORT_ENERGY_SIZE];
+    ld2420_report_energy_encode(frame, &report);
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_event_from_frame(frame, sizeof(frame), 4, 77, &e));
+    TEST_ASSERT_EQUAL(LD2420_TELEMETRY_REPORT, e.kind);
+    TEST_ASSERT_EQUAL_UINT16(410, e.distance_cm);
+    TEST_ASSERT_EQUAL_MEMORY(report.energy, e.energy, 16 * sizeof(uint16_t));
+
+    frame[sizeof(frame) - 1] ^= 0xFF;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FRAME, ld2420_telemetry_event_from_frame(frame, sizeof(frame), 4, 77, &e));
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_FRAME,
+                      ld2420_telemetry_event_from_frame(OPEN_CONFIG_ACK, sizeof(OPEN_CONFIG_ACK) - 1u, 4, 77, &e));
+
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_telemetry_begin(&enc, message, sizeof(message), 0));
+    e.sensor_id = SENSORS;
+    e.kind = LD2420_TELEMETRY_PRESENCE;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_ARGUMENTS, ld2420_telemetry_append(&enc, &e));
+    TEST_ASSERT_EQUAL_size_t(0, ld2420_telemetry_end(&enc));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test__telemetry_round_trips_mixed_sensors_and_kinds);
+    RUN_TEST(test__telemetry_steady_reports_are_small);
+    RUN_TEST(test__telemetry_full_message_starts_the_next_one_cleanly);
+    RUN_TEST(test__telemetry_decoder_counts_lost_and_corrupt_messages);
+    RUN_TEST(test__telemetry_event_from_frame_classifies_frames);
+    return UNITY_END();
+}
@@ -33,7 +33,9 @@ void test__rx_buffer_must_parse(void)
         OPEN_COMMAND_MODE_RX_BUFFER_SIZE,
         &frame_size,
         &cmd_echo,
-        &status);
+        &status,
+        NULL,
+        NULL);
 
     TEST_ASSERT_EQUAL(LD2420_STATUS_OK, parse_status);
     TEST_ASSERT_EQUAL(8, frame_size);
@@ -58,14 +60,41 @@ void test__rx_buffer_must_fail(void)
         OPEN_COMMAND_MODE_RX_BUFFER_SIZE,
         &frame_size,
         &cmd_echo,
-        &status);
+        &status,
+        NULL,
+        NULL);
     TEST_ASSERT_NOT_EQUAL(LD2420_STATUS_OK, parse_status);
 }
 
+void test__rx_buffer_must_reject_wrapping_length(void)
+{
+    // Length 0x0108 wraps to 18 in 8 bits, the size of this buffer; the
+    // footer would then be read 256 bytes past its end.
+    static const uint8_t WRAPPING_LENGTH_RX_BUFFER[] = {
+        0xFD, 0xFC, 0xFB, 0xFA,
+        0x08, 0x01, 0xFF, 0x01,
+        0x00, 0x00, 0x02, 0x00, 0x20, 0x00, 0x04, 0x03, 0x02, 0x01};
+
+    uint16_t frame_size = -1;
+    uint16_t cmd_echo = -1;
+    uint16_t status = -1;
+
+    ld2420_status_t parse_status = ld2420_parse_rx_buffer(
+        WRAPPING_LENGTH_RX_BUFFER,
+        sizeof(WRAPPING_LENGTH_RX_BUFFER),
+        &frame_size,
+        &cmd_echo,
+        &status,
+        NULL,
+        NULL);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_BUFFER_SIZE, parse_status);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
     RUN_TEST(test__rx_buffer_must_parse);
     RUN_TEST(test__rx_buffer_must_fail);
+    RUN_TEST(test__rx_buffer_must_reject_wrapping_length);
     return UNITY_END();
 }
\ No newline at end of file
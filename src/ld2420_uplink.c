@@ -0,0 +1,316 @@
+/*
+ * LD2420 binary uplink implementation
+ *
+ * Design Principles
+ * -----------------
+ * 1. Records are self-delimiting: sync bytes, a bounded length and a CRC
+ * 2. The encoder writes straight into the caller's (or the writer's) buffer
+ * 3. The decoder accumulates one record at a time in a linear buffer and
+ *    resynchronizes one byte after the start of a rejected record, so a
+ *    corrupted length can never swallow the records that follow it
+ *
+ * Memory & Threading
+ * ------------------
+ * - No dynamic allocation
+ * - Not thread-safe; use one writer/decoder per link
+ */
+
+#include <ld2420/ld2420_uplink.h>
+#include "ld2420_internal.h"
+
+/** Offsets of the record fields, see the layout in ld2420_uplink.h. */
+#define UPLINK_OFFSET_LENGTH 2u
+#define UPLINK_OFFSET_SENSOR 4u
+#define UPLINK_OFFSET_KIND 5u
+#define UPLINK_OFFSET_SEQUENCE 6u
+#define UPLINK_OFFSET_TIMESTAMP 7u
+
+static inline void write_le16(uint8_t *b, uint16_t v)
+{
+    b[0] = (uint8_t)v;
+    b[1] = (uint8_t)(v >> 8);
+}
+
+static inline void write_le32(uint8_t *b, uint32_t v)
+{
+    b[0] = (uint8_t)v;
+    b[1] = (uint8_t)(v >> 8);
+    b[2] = (uint8_t)(v >> 16);
+    b[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint16_t read_le16(const uint8_t *b)
+{
+    return (uint16_t)b[0] | ((uint16_t)b[1] << 8);
+}
+
+static inline uint32_t read_le32(const uint8_t *b)
+{
+    return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+/**
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection, no final XOR).
+ * A 16-entry nibble table keeps the flash cost at 32 bytes.
+ */
+static uint16_t crc16_ccitt(const uint8_t *data, size_t len)
+{
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (data[i] & 0x0F)]);
+    }
+    return crc;
+}
+
+ld2420_status_t ld2420_uplink_encode(
+    const ld2420_uplink_record_t *record,
+    uint8_t *out,
+    size_t out_size,
+    size_t *out_written)
+{
+    if (!record || !out || !out_written)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    if (record->payload_size > LD2420_UPLINK_MAX_PAYLOAD || (record->payload_size > 0 && !record->payload))
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    const size_t total = LD2420_UPLINK_OVERHEAD + (size_t)record->payload_size;
+    if (out_size < total)
+        return LD2420_STATUS_ERROR_BUFFER_TOO_SMALL;
+
+    out[0] = LD2420_UPLINK_SYNC[0];
+    out[1] = LD2420_UPLINK_SYNC[1];
+    write_le16(&out[UPLINK_OFFSET_LENGTH], record->payload_size);
+    out[UPLINK_OFFSET_SENSOR] = record->sensor_id;
+    out[UPLINK_OFFSET_KIND] = record->kind;
+    out[UPLINK_OFFSET_SEQUENCE] = record->sequence;
+    write_le32(&out[UPLINK_OFFSET_TIMESTAMP], record->timestamp_us);
+    if (record->payload_size > 0)
+        ld2420_copy_bytes(&out[LD2420_UPLINK_HEADER_SIZE], record->payload, record->payload_size);
+
+    // The CRC covers everything after the sync bytes
+    const size_t crc_offset = LD2420_UPLINK_HEADER_SIZE + (size_t)record->payload_size;
+    write_le16(&out[crc_offset], crc16_ccitt(&out[UPLINK_OFFSET_LENGTH], crc_offset - UPLINK_OFFSET_LENGTH));
+
+    *out_written = total;
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_uplink_writer_init(ld2420_uplink_writer_t *w, ld2420_uplink_write_fn write, void *user)
+{
+    if (!w || !write)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    w->used = 0;
+    w->next_sequence = 0;
+    w->dropped_records = 0;
+    w->write = write;
+    w->user = user;
+    return LD2420_STATUS_OK;
+}
+
+ld2420_status_t ld2420_uplink_writer_flush(ld2420_uplink_writer_t *w)
+{
+    if (!w || !w->write)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    if (w->used == 0)
+        return LD2420_STATUS_OK;
+
+    size_t sent = w->write(w->user, w->batch, w->used);
+    if (sent > w->used)
+        sent = w->used;
+
+    // Keep what the transport did not take; records are never split on purpose,
+    // but a partial write must not lose the tail of one
+    const uint16_t remaining = (uint16_t)(w->used - sent);
+    if (remaining > 0 && sent > 0)
+        ld2420_move_bytes(w->batch, &w->batch[sent], remaining);
+    w->used = remaining;
+
+    return remaining == 0 ? LD2420_STATUS_OK : LD2420_STATUS_ERROR_BUFFER_TOO_SMALL;
+}
+
+ld2420_status_t ld2420_uplink_writer_append(
+    ld2420_uplink_writer_t *w,
+    uint8_t sensor_id,
+    ld2420_uplink_kind_t kind,
+    uint32_t timestamp_us,
+    const uint8_t *payload,
+    uint16_t payload_size)
+{
+    if (!w || !w->write)
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+    if (payload_size > LD2420_UPLINK_MAX_PAYLOAD || (payload_size > 0 && !payload))
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    // The sequence number advances for dropped records too, so the host sees the gap
+    const ld2420_uplink_record_t record = {
+        .sensor_id = sensor_id,
+        .kind = (uint8_t)kind,
+        .sequence = w->next_sequence++,
+        .timestamp_us = timestamp_us,
+        .payload = payload,
+        .payload_size = payload_size,
+    };
+
+    const size_t needed = LD2420_UPLINK_OVERHEAD + (size_t)payload_size;
+    if (needed > (size_t)(LD2420_UPLINK_BATCH_SIZE - w->used))
+        ld2420_uplink_writer_flush(w);
+
+    size_t written = 0;
+    if (ld2420_uplink_encode(&record, &w->batch[w->used], LD2420_UPLINK_BATCH_SIZE - w->used, &written) !=
+        LD2420_STATUS_OK)
+    {
+        w->dropped_records++;
+        return LD2420_STATUS_ERROR_BUFFER_TOO_SMALL;
+    }
+    w->used = (uint16_t)(w->used + written);
+    return LD2420_STATUS_OK;
+}
+
+void ld2420_uplink_decoder_init(ld2420_uplink_decoder_t *d)
+{
+    if (!d)
+        return;
+    d->index = 0;
+    d->have_sequence = false;
+    d->last_sequence = 0;
+    d->records = 0;
+    d->corrupt_records = 0;
+    d->lost_records = 0;
+}
+
+/**
+ * Drop buffer[0..from) and everything up to the next possible sync (a full
+ * sync pair, or a first sync byte at the very end of the buffer).
+ */
+static void drop_to_next_sync(ld2420_uplink_decoder_t *d, uint16_t from)
+{
+    for (uint16_t i = from; i < d->index; i++)
+    {
+        if (d->buffer[i] != LD2420_UPLINK_SYNC[0])
+            continue;
+        if (i + 1 < d->index && d->buffer[i + 1] != LD2420_UPLINK_SYNC[1])
+            continue;
+        d->index = (uint16_t)(d->index - i);
+        ld2420_move_bytes(d->buffer, &d->buffer[i], d->index);
+        return;
+    }
+    d->index = 0;
+}
+
+/**
+ * Decode whatever the buffer holds. Returns false if the callback asked to stop;
+ * sets *corrupt when a record was rejected.
+ */
+static bool evaluate_buffer(
+    ld2420_uplink_decoder_t *d,
+    ld2420_uplink_on_record_fn on_record,
+    void *user,
+    bool *corrupt)
+{
+    for (;;)
+    {
+        if (d->index == 0)
+            return true;
+        if (d->buffer[0] != LD2420_UPLINK_SYNC[0] || (d->index >= 2 && d->buffer[1] != LD2420_UPLINK_SYNC[1]))
+        {
+            // Noise between records; not counted as a corrupt record
+            drop_to_next_sync(d, 1);
+            continue;
+        }
+        if (d->index < UPLINK_OFFSET_SENSOR)
+            return true;
+
+        const uint16_t payload_size = read_le16(&d->buffer[UPLINK_OFFSET_LENGTH]);
+        if (payload_size > LD2420_UPLINK_MAX_PAYLOAD)
+        {
+            d->corrupt_records++;
+            *corrupt = true;
+            drop_to_next_sync(d, 1);
+            continue;
+        }
+
+        const uint16_t total = (uint16_t)(LD2420_UPLINK_OVERHEAD + payload_size);
+        if (d->index < total)
+            return true;
+
+        const uint16_t crc_offset = (uint16_t)(total - LD2420_UPLINK_CRC_SIZE);
+        if (crc16_ccitt(&d->buffer[UPLINK_OFFSET_LENGTH], crc_offset - UPLINK_OFFSET_LENGTH) !=
+            read_le16(&d->buffer[crc_offset]))
+        {
+            d->corrupt_records++;
+            *corrupt = true;
+            drop_to_next_sync(d, 1);
+            continue;
+        }
+
+        const ld2420_uplink_record_t record = {
+            .sensor_id = d->buffer[UPLINK_OFFSET_SENSOR],
+            .kind = d->buffer[UPLINK_OFFSET_KIND],
+            .sequence = d->buffer[UPLINK_OFFSET_SEQUENCE],
+            .timestamp_us = read_le32(&d->buffer[UPLINK_OFFSET_TIMESTAMP]),
+            .payload = &d->buffer[LD2420_UPLINK_HEADER_SIZE],
+            .payload_size = payload_size,
+        };
+        if (d->have_sequence)
+            d->lost_records += (uint8_t)(record.sequence - d->last_sequence - 1u);
+        d->have_sequence = true;
+        d->last_sequence = record.sequence;
+        d->records++;
+
+        const bool keep_going = on_record ? on_record(user, &record) : true;
+
+        // Bytes past the record only exist after a resync; keep them for the next pass
+        d->index = (uint16_t)(d->index - total);
+        if (d->index > 0)
+            ld2420_move_bytes(d->buffer, &d->buffer[total], d->index);
+
+        if (!keep_going)
+            return false;
+    }
+}
+
+ld2420_status_t ld2420_uplink_decode(
+    ld2420_uplink_decoder_t *d,
+    const uint8_t *data,
+    size_t len,
+    ld2420_uplink_on_record_fn on_record,
+    void *user,
+    size_t *out_consumed)
+{
+    if (out_consumed)
+        *out_consumed = 0;
+    if (!d || (!data && len > 0))
+        return LD2420_STATUS_ERROR_INVALID_ARGUMENTS;
+
+    bool corrupt = false;
+    size_t consumed = 0;
+
+    // Records left over from a stopped call go first
+    bool keep_going = evaluate_buffer(d, on_record, user, &corrupt);
+
+    while (keep_going && consumed < len)
+    {
+        // The buffer never holds a complete record here, so there is room for one more
+        // byte. Once the length is known, the rest of the record is copied in one go.
+        size_t take = 1;
+        if (d->index >= UPLINK_OFFSET_SENSOR)
+        {
+            take = (size_t)(LD2420_UPLINK_OVERHEAD + read_le16(&d->buffer[UPLINK_OFFSET_LENGTH]) - d->index);
+            if (take > len - consumed)
+                take = len - consumed;
+        }
+        ld2420_copy_bytes(&d->buffer[d->index], &data[consumed], take);
+        d->index = (uint16_t)(d->index + take);
+        consumed += take;
+        keep_going = evaluate_buffer(d, on_record, user, &corrupt);
+    }
+
+    if (out_consumed)
+        *out_consumed = consumed;
+    return corrupt ? LD2420_STATUS_ERROR_INVALID_PACKET : LD2420_STATUS_OK;
+}
@@ -0,0 +1,220 @@
+#include <unity.h>
+#include <string.h>
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_uplink.h>
+
+/** Transport capturing everything the writer sends; accepts at most `accept` bytes per call. */
+static uint8_t link_bytes[4096];
+static size_t link_size;
+static size_t link_accept;
+
+static size_t capture_write(void *user, const uint8_t *data, size_t len)
+{
+    (void)user;
+    size_t n = len < link_accept ? len : link_accept;
+    if (n > sizeof(link_bytes) - link_size)
+        n = sizeof(link_bytes) - link_size;
+    memcpy(&link_bytes[link_size], data, n);
+    link_size += n;
+    return n;
+}
+
+/** Records seen by the decoder callback. */
+static ld2420_uplink_record_t seen[16];
+static uint8_t seen_payloads[16][LD2420_UPLINK_MAX_PAYLOAD];
+static int seen_count;
+
+static bool on_record(void *user, const ld2420_uplink_record_t *record)
+{
+    (void)user;
+    if (seen_count < 16)
+    {
+        seen[seen_count] = *record;
+        memcpy(seen_payloads[seen_count], record->payload, record->payload_size);
+        seen[seen_count].payload = seen_payloads[seen_count];
+    }
+    seen_count++;
+    return true;
+}
+
+static const uint8_t FRAME[] = {
+    0xFD, 0xFC, 0xFB, 0xFA, // header
+    0x08, 0x00,             // frame size (8)
+    0xFF, 0x01,             // cmd echo
+    0x00, 0x00,             // status
+    0x02, 0x00, 0x20, 0x00, // payload (4 bytes)
+    0x04, 0x03, 0x02, 0x01  // footer
+};
+
+void setUp(void)
+{
+    link_size = 0;
+    link_accept = sizeof(link_bytes);
+    seen_count = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test__uplink_encode_matches_wire_format(void)
+{
+    static const uint8_t PAYLOAD[] = {0xAB, 0xCD};
+    static const uint8_t EXPECTED[] = {
+        0xA5, 0x5A,             // sync
+        0x02, 0x00,             // payload length
+        0x01,                   // sensor id
+        0x03,                   // kind (overflow)
+        0x07,                   // sequence
+        0x78, 0x56, 0x34, 0x12, // timestamp
+        0xAB, 0xCD,             // payload
+        0xB9, 0xDC              // CRC-16/CCITT-FALSE
+    };
+    const ld2420_uplink_record_t record = {
+        .sensor_id = 1,
+        .kind = LD2420_UPLINK_KIND_OVERFLOW,
+        .sequence = 7,
+        .timestamp_us = 0x12345678,
+        .payload = PAYLOAD,
+        .payload_size = sizeof(PAYLOAD),
+    };
+
+    uint8_t out[32];
+    size_t written = 0;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_uplink_encode(&record, out, sizeof(out), &written));
+    TEST_ASSERT_EQUAL_UINT(sizeof(EXPECTED), written);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(EXPECTED, out, sizeof(EXPECTED));
+
+    // One byte short must be refused rather than truncated
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_BUFFER_TOO_SMALL,
+                      ld2420_uplink_encode(&record, out, sizeof(EXPECTED) - 1, &written));
+}
+
+void test__uplink_writer_round_trips_through_decoder(void)
+{
+    ld2420_uplink_writer_t w;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_uplink_writer_init(&w, capture_write, NULL));
+
+    // Enough frames from two sensors to need several batches
+    for (int i = 0; i < 10; i++)
+    {
+        TEST_ASSERT_EQUAL(LD2420_STATUS_OK,
+                          ld2420_uplink_writer_append(&w, (uint8_t)(i & 1), LD2420_UPLINK_KIND_FRAME,
+                                                      1000u * (uint32_t)i, FRAME, sizeof(FRAME)));
+    }
+    TEST_ASSERT_TRUE(link_size > 0); // earlier batches went out on their own
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_uplink_writer_flush(&w));
+    TEST_ASSERT_EQUAL_UINT(10 * (LD2420_UPLINK_OVERHEAD + sizeof(FRAME)), link_size);
+
+    // Decode in odd-sized chunks so records straddle calls
+    ld2420_uplink_decoder_t d;
+    ld2420_uplink_decoder_init(&d);
+    for (size_t off = 0; off < link_size; off += 7)
+    {
+        size_t n = link_size - off < 7 ? link_size - off : 7;
+        size_t consumed = 0;
+        TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_uplink_decode(&d, &link_bytes[off], n, on_record, NULL, &consumed));
+        TEST_ASSERT_EQUAL_UINT(n, consumed);
+    }
+
+    TEST_ASSERT_EQUAL_INT(10, seen_count);
+    for (int i = 0; i < 10; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(i & 1, seen[i].sensor_id);
+        TEST_ASSERT_EQUAL_UINT8(LD2420_UPLINK_KIND_FRAME, seen[i].kind);
+        TEST_ASSERT_EQUAL_UINT8(i, seen[i].sequence);
+        TEST_ASSERT_EQUAL_UINT32(1000u * (uint32_t)i, seen[i].timestamp_us);
+        TEST_ASSERT_EQUAL_UINT16(sizeof(FRAME), seen[i].payload_size);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(FRAME, seen[i].payload, sizeof(FRAME));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, d.corrupt_records);
+    TEST_ASSERT_EQUAL_UINT32(0, d.lost_records);
+}
+
+void test__uplink_writer_keeps_unsent_bytes_and_counts_drops(void)
+{
+    ld2420_uplink_writer_t w;
+    ld2420_uplink_writer_init(&w, capture_write, NULL);
+
+    // A stalled transport: the batch fills, then records are dropped
+    link_accept = 0;
+    int queued = 0;
+    for (int i = 0; i < 20; i++)
+    {
+        if (ld2420_uplink_writer_append(&w, 0, LD2420_UPLINK_KIND_FRAME, 0, FRAME, sizeof(FRAME)) == LD2420_STATUS_OK)
+            queued++;
+    }
+    TEST_ASSERT_EQUAL_INT(LD2420_UPLINK_BATCH_SIZE / (LD2420_UPLINK_OVERHEAD + sizeof(FRAME)), queued);
+    TEST_ASSERT_EQUAL_UINT32(20 - queued, w.dropped_records);
+
+    // A partial write keeps the tail for the next flush
+    link_accept = 5;
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_BUFFER_TOO_SMALL, ld2420_uplink_writer_flush(&w));
+    link_accept = sizeof(link_bytes);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_uplink_writer_flush(&w));
+
+    ld2420_uplink_decoder_t d;
+    ld2420_uplink_decoder_init(&d);
+    ld2420_uplink_decode(&d, link_bytes, link_size, on_record, NULL, NULL);
+    TEST_ASSERT_EQUAL_INT(queued, seen_count);
+    TEST_ASSERT_EQUAL_UINT32(0, d.corrupt_records);
+}
+
+void test__uplink_decoder_resyncs_after_corruption(void)
+{
+    uint8_t stream[512];
+    size_t size = 0;
+
+    // Noise, three records, with the middle one damaged
+    static const uint8_t NOISE[] = {0x00, 0xA5, 0x13, 0xA5, 0xA5};
+    memcpy(stream, NOISE, sizeof(NOISE));
+    size += sizeof(NOISE);
+    size_t record_offsets[3];
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        const ld2420_uplink_record_t record = {
+            .sensor_id = i,
+            .kind = LD2420_UPLINK_KIND_FRAME,
+            .sequence = i,
+            .timestamp_us = i,
+            .payload = FRAME,
+            .payload_size = sizeof(FRAME),
+        };
+        size_t written = 0;
+        record_offsets[i] = size;
+        TEST_ASSERT_EQUAL(LD2420_STATUS_OK, ld2420_uplink_encode(&record, &stream[size], sizeof(stream) - size, &written));
+        size += written;
+    }
+
+    // A corrupted length claims far more payload than the record has
+    stream[record_offsets[1] + 3] = 0x01;
+
+    ld2420_uplink_decoder_t d;
+    ld2420_uplink_decoder_init(&d);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_PACKET, ld2420_uplink_decode(&d, stream, size, on_record, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(2, seen_count);
+    TEST_ASSERT_EQUAL_UINT8(0, seen[0].sensor_id);
+    TEST_ASSERT_EQUAL_UINT8(2, seen[1].sensor_id);
+    TEST_ASSERT_EQUAL_UINT32(1, d.corrupt_records);
+    TEST_ASSERT_EQUAL_UINT32(1, d.lost_records);
+
+    // A flipped payload bit is caught by the CRC
+    setUp();
+    stream[record_offsets[1] + 3] = 0x00;
+    stream[record_offsets[1] + LD2420_UPLINK_HEADER_SIZE + 4] ^= 0x10;
+    ld2420_uplink_decoder_init(&d);
+    TEST_ASSERT_EQUAL(LD2420_STATUS_ERROR_INVALID_PACKET, ld2420_uplink_decode(&d, stream, size, on_record, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(2, seen_count);
+    TEST_ASSERT_EQUAL_UINT8(2, seen[1].sensor_id);
+    TEST_ASSERT_EQUAL_UINT32(1, d.corrupt_records);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test__uplink_encode_matches_wire_format);
+    RUN_TEST(test__uplink_writer_round_trips_through_decoder);
+    RUN_TEST(test__uplink_writer_keeps_unsent_bytes_and_counts_drops);
+    RUN_TEST(test__uplink_decoder_resyncs_after_corruption);
+    return UNITY_END();
+}
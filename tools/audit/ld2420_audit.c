@@ -0,0 +1,82 @@
+/*
+ * LD2420 audit launcher
+ * ---------------------
+ * Runs a host program with the allocation and syscall audit preloaded. The
+ * interposer library is expected next to this executable.
+ *
+ * Usage: ld2420_audit [--warmup FRAMES] [--report-only] [--reads-per-event N]
+ *                     [--output PATH] -- PROGRAM [ARGS...]
+ *
+ * The exit status is the program's, or 1 when the audit failed.
+ */
+
+#define _GNU_SOURCE
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PRELOAD_NAME "libld2420_audit_preload.so"
+
+static int usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--warmup FRAMES] [--report-only] [--reads-per-event N]\n"
+            "          [--output PATH] -- PROGRAM [ARGS...]\n",
+            argv0);
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    int i = 1;
+    for (; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--") == 0)
+        {
+            i++;
+            break;
+        }
+        if (strcmp(arg, "--report-only") == 0)
+            setenv("LD2420_AUDIT_ON_ALLOC", "report", 1);
+        else if (strcmp(arg, "--warmup") == 0 && i + 1 < argc)
+            setenv("LD2420_AUDIT_WARMUP_FRAMES", argv[++i], 1);
+        else if (strcmp(arg, "--reads-per-event") == 0 && i + 1 < argc)
+            setenv("LD2420_AUDIT_MAX_READS_PER_EVENT", argv[++i], 1);
+        else if (strcmp(arg, "--output") == 0 && i + 1 < argc)
+            setenv("LD2420_AUDIT_REPORT", argv[++i], 1);
+        else
+            return usage(argv[0]);
+    }
+    if (i >= argc)
+        return usage(argv[0]);
+
+    // The interposer lives next to the launcher
+    char self[PATH_MAX];
+    ssize_t len = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    if (len <= 0)
+    {
+        perror("readlink /proc/self/exe");
+        return 1;
+    }
+    self[len] = '\0';
+    char *slash = strrchr(self, '/');
+    if (slash != NULL)
+        *slash = '\0';
+
+    char preload[PATH_MAX + sizeof(PRELOAD_NAME) + 1];
+    snprintf(preload, sizeof(preload), "%s/%s", self, PRELOAD_NAME);
+    if (access(preload, R_OK) != 0)
+    {
+        fprintf(stderr, "ERROR: %s not found\n", preload);
+        return 1;
+    }
+    setenv("LD_PRELOAD", preload, 1);
+
+    execvp(argv[i], &argv[i]);
+    perror(argv[i]);
+    return 127;
+}
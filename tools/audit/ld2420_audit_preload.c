@@ -0,0 +1,513 @@
+/*
+ * LD2420 allocation and syscall audit (LD_PRELOAD interposer)
+ * -----------------------------------------------------------
+ * Preloaded into any host program built on ld2420_core, usually through the
+ * ld2420_audit launcher. It interposes the heap functions and the I/O and
+ * readiness syscall wrappers and checks the steady-state ingest path:
+ *
+ * - An ingest thread is any thread that waits for readiness (epoll, poll,
+ *   select). Its ingest path runs from a wait that reported ready descriptors
+ *   to the next wait.
+ * - Frames are counted by running the bytes every ingest thread reads through
+ *   a private ld2420_stream_t per descriptor, so the program needs no hooks.
+ * - After the warm-up frames, any allocation on an ingest path is a violation.
+ *   By default it prints a stack trace and aborts.
+ * - An ingest path may issue at most LD2420_AUDIT_MAX_READS_PER_EVENT read
+ *   calls per ready descriptor.
+ *
+ * A summary with allocations, frees and syscalls per frame is printed at exit.
+ * The process exits with status 1 when any check failed.
+ *
+ * Environment:
+ *   LD2420_AUDIT_WARMUP_FRAMES       frames before the checks start (1000)
+ *   LD2420_AUDIT_ON_ALLOC            "abort" (default) or "report"
+ *   LD2420_AUDIT_MAX_READS_PER_EVENT read calls per ready descriptor (1)
+ *   LD2420_AUDIT_REPORT              write the summary to this file, not stderr
+ */
+
+#define _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_stream.h>
+
+#define AUDIT_EXPORT __attribute__((visibility("default")))
+
+/** Descriptors above this are read but not parsed. */
+#define AUDIT_MAX_FDS 4096
+
+/** glibc's own allocator entry points; using them avoids dlsym() recursion. */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+/* ------------------------------------------------------------------------- */
+/* State                                                                     */
+/* ------------------------------------------------------------------------- */
+
+static struct
+{
+    uint64_t warmup_frames;
+    bool abort_on_alloc;
+    uint64_t max_reads_per_event;
+    const char *report_path;
+} config = {1000, true, 1, NULL};
+
+static struct
+{
+    atomic_uint_fast64_t frames;
+    atomic_uint_fast64_t events;
+    atomic_uint_fast64_t waits;
+    atomic_uint_fast64_t reads;
+    atomic_uint_fast64_t syscalls;   // interposed syscalls on ingest threads
+    atomic_uint_fast64_t allocs;     // every allocation in the process
+    atomic_uint_fast64_t frees;
+    atomic_uint_fast64_t path_allocs; // allocations on an ingest path
+    atomic_uint_fast64_t path_frees;
+    atomic_uint_fast64_t alloc_violations;
+    atomic_uint_fast64_t read_violations;
+    atomic_uint_fast64_t max_reads_in_path;
+} counters;
+
+/**
+ * Per-thread ingest path state. Initial-exec TLS, because the general model
+ * may allocate on first access, from inside malloc().
+ */
+#define AUDIT_TLS __thread __attribute__((tls_model("initial-exec")))
+static AUDIT_TLS bool is_ingest_thread;
+static AUDIT_TLS bool in_ingest_path;
+static AUDIT_TLS uint64_t path_events;
+static AUDIT_TLS uint64_t path_reads;
+static AUDIT_TLS int hook_depth;
+
+static ld2420_stream_t streams[AUDIT_MAX_FDS];
+static bool stream_ready[AUDIT_MAX_FDS];
+
+static bool warmed_up(void)
+{
+    return atomic_load_explicit(&counters.frames, memory_order_relaxed) >= config.warmup_frames;
+}
+
+static void atomic_max(atomic_uint_fast64_t *target, uint64_t value)
+{
+    uint_fast64_t seen = atomic_load_explicit(target, memory_order_relaxed);
+    while (value > seen && !atomic_compare_exchange_weak(target, &seen, value))
+        ;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Ingest path tracking                                                      */
+/* ------------------------------------------------------------------------- */
+
+/** Called before every readiness wait: closes the current ingest path. */
+static void end_ingest_path(void)
+{
+    is_ingest_thread = true;
+    if (in_ingest_path)
+    {
+        atomic_max(&counters.max_reads_in_path, path_reads);
+        if (warmed_up() && path_reads > path_events * config.max_reads_per_event)
+            atomic_fetch_add(&counters.read_violations, 1);
+    }
+    in_ingest_path = false;
+    atomic_fetch_add(&counters.waits, 1);
+    atomic_fetch_add(&counters.syscalls, 1);
+}
+
+/** Called after every readiness wait with the number of ready descriptors. */
+static void begin_ingest_path(int ready)
+{
+    if (ready <= 0)
+        return;
+    atomic_fetch_add(&counters.events, (uint64_t)ready);
+    in_ingest_path = true;
+    path_events = (uint64_t)ready;
+    path_reads = 0;
+}
+
+static bool on_audit_frame(const uint8_t *frame, uint16_t frame_size_bytes, uint16_t cmd_echo, uint16_t status)
+{
+    (void)frame;
+    (void)frame_size_bytes;
+    (void)cmd_echo;
+    (void)status;
+    atomic_fetch_add(&counters.frames, 1);
+    return true;
+}
+
+/** Account for a read-type call on an ingest thread and count the frames in it. */
+static void audit_read(int fd, const struct iovec *iov, int iovcnt, ssize_t n)
+{
+    if (!is_ingest_thread)
+        return;
+    atomic_fetch_add(&counters.syscalls, 1);
+    if (in_ingest_path)
+    {
+        atomic_fetch_add(&counters.reads, 1);
+        path_reads++;
+    }
+    if (n <= 0 || fd < 0 || fd >= AUDIT_MAX_FDS)
+        return;
+
+    if (!stream_ready[fd])
+    {
+        ld2420_stream_init(&streams[fd]);
+        stream_ready[fd] = true;
+    }
+    size_t remaining = (size_t)n;
+    for (int i = 0; i < iovcnt && remaining > 0; i++)
+    {
+        size_t len = iov[i].iov_len < remaining ? iov[i].iov_len : remaining;
+        ld2420_stream_feed_bytes(&streams[fd], iov[i].iov_base, len, on_audit_frame, NULL);
+        remaining -= len;
+    }
+}
+
+static void audit_syscall(void)
+{
+    if (is_ingest_thread)
+        atomic_fetch_add(&counters.syscalls, 1);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Heap                                                                      */
+/* ------------------------------------------------------------------------- */
+
+static void report_allocation(const char *what, size_t size)
+{
+    atomic_fetch_add(&counters.alloc_violations, 1);
+    if (!config.abort_on_alloc)
+        return;
+
+    // backtrace() was primed in the constructor, so none of this allocates
+    char line[160];
+    int len = snprintf(line, sizeof(line),
+                       "ld2420 audit: %s(%zu) on the ingest path after %llu frames\n",
+                       what, size, (unsigned long long)atomic_load(&counters.frames));
+    (void)!write(STDERR_FILENO, line, (size_t)len);
+    void *frames[64];
+    int depth = backtrace(frames, 64);
+    backtrace_symbols_fd(frames, depth, STDERR_FILENO);
+    abort();
+}
+
+static void audit_alloc(const char *what, size_t size)
+{
+    atomic_fetch_add_explicit(&counters.allocs, 1, memory_order_relaxed);
+    if (!in_ingest_path || hook_depth > 0)
+        return;
+    atomic_fetch_add(&counters.path_allocs, 1);
+    if (warmed_up())
+    {
+        hook_depth++;
+        report_allocation(what, size);
+        hook_depth--;
+    }
+}
+
+static void audit_free(void *ptr)
+{
+    if (ptr == NULL)
+        return;
+    atomic_fetch_add_explicit(&counters.frees, 1, memory_order_relaxed);
+    if (in_ingest_path && hook_depth == 0)
+        atomic_fetch_add(&counters.path_frees, 1);
+}
+
+AUDIT_EXPORT void *malloc(size_t size)
+{
+    audit_alloc("malloc", size);
+    return __libc_malloc(size);
+}
+
+AUDIT_EXPORT void *calloc(size_t count, size_t size)
+{
+    audit_alloc("calloc", count * size);
+    return __libc_calloc(count, size);
+}
+
+AUDIT_EXPORT void *realloc(void *ptr, size_t size)
+{
+    audit_alloc("realloc", size);
+    return __libc_realloc(ptr, size);
+}
+
+AUDIT_EXPORT void free(void *ptr)
+{
+    audit_free(ptr);
+    __libc_free(ptr);
+}
+
+AUDIT_EXPORT int posix_memalign(void **out, size_t alignment, size_t size)
+{
+    audit_alloc("posix_memalign", size);
+    if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0)
+        return 22; // EINVAL
+    void *ptr = __libc_memalign(alignment, size);
+    if (ptr == NULL)
+        return 12; // ENOMEM
+    *out = ptr;
+    return 0;
+}
+
+AUDIT_EXPORT void *aligned_alloc(size_t alignment, size_t size)
+{
+    audit_alloc("aligned_alloc", size);
+    return __libc_memalign(alignment, size);
+}
+
+AUDIT_EXPORT void *memalign(size_t alignment, size_t size)
+{
+    audit_alloc("memalign", size);
+    return __libc_memalign(alignment, size);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Syscall wrappers                                                          */
+/* ------------------------------------------------------------------------- */
+
+#define REAL(name) real_##name
+#define DECLARE_REAL(ret, name, ...) static ret (*real_##name)(__VA_ARGS__)
+#define RESOLVE_REAL(name)                          \
+    do                                              \
+    {                                               \
+        if (real_##name == NULL)                    \
+            real_##name = dlsym(RTLD_NEXT, #name);  \
+    } while (0)
+
+DECLARE_REAL(ssize_t, read, int, void *, size_t);
+DECLARE_REAL(ssize_t, readv, int, const struct iovec *, int);
+DECLARE_REAL(ssize_t, recv, int, void *, size_t, int);
+DECLARE_REAL(ssize_t, recvfrom, int, void *, size_t, int, struct sockaddr *, socklen_t *);
+DECLARE_REAL(ssize_t, recvmsg, int, struct msghdr *, int);
+DECLARE_REAL(ssize_t, write, int, const void *, size_t);
+DECLARE_REAL(ssize_t, writev, int, const struct iovec *, int);
+DECLARE_REAL(ssize_t, send, int, const void *, size_t, int);
+DECLARE_REAL(ssize_t, sendto, int, const void *, size_t, int, const struct sockaddr *, socklen_t);
+DECLARE_REAL(ssize_t, sendmsg, int, const struct msghdr *, int);
+DECLARE_REAL(int, close, int);
+DECLARE_REAL(int, epoll_wait, int, struct epoll_event *, int, int);
+DECLARE_REAL(int, epoll_pwait, int, struct epoll_event *, int, int, const sigset_t *);
+DECLARE_REAL(int, poll, struct pollfd *, nfds_t, int);
+DECLARE_REAL(int, ppoll, struct pollfd *, nfds_t, const struct timespec *, const sigset_t *);
+DECLARE_REAL(int, select, int, fd_set *, fd_set *, fd_set *, struct timeval *);
+
+AUDIT_EXPORT ssize_t read(int fd, void *buf, size_t count)
+{
+    RESOLVE_REAL(read);
+    ssize_t n = REAL(read)(fd, buf, count);
+    struct iovec iov = {buf, count};
+    audit_read(fd, &iov, 1, n);
+    return n;
+}
+
+AUDIT_EXPORT ssize_t readv(int fd, const struct iovec *iov, int iovcnt)
+{
+    RESOLVE_REAL(readv);
+    ssize_t n = REAL(readv)(fd, iov, iovcnt);
+    audit_read(fd, iov, iovcnt, n);
+    return n;
+}
+
+AUDIT_EXPORT ssize_t recv(int fd, void *buf, size_t len, int flags)
+{
+    RESOLVE_REAL(recv);
+    ssize_t n = REAL(recv)(fd, buf, len, flags);
+    struct iovec iov = {buf, len};
+    audit_read(fd, &iov, 1, n);
+    return n;
+}
+
+AUDIT_EXPORT ssize_t recvfrom(int fd, void *buf, size_t len, int flags, struct sockaddr *addr, socklen_t *addrlen)
+{
+    RESOLVE_REAL(recvfrom);
+    ssize_t n = REAL(recvfrom)(fd, buf, len, flags, addr, addrlen);
+    struct iovec iov = {buf, len};
+    audit_read(fd, &iov, 1, n);
+    return n;
+}
+
+AUDIT_EXPORT ssize_t recvmsg(int fd, struct msghdr *msg, int flags)
+{
+    RESOLVE_REAL(recvmsg);
+    ssize_t n = REAL(recvmsg)(fd, msg, flags);
+    audit_read(fd, msg->msg_iov, (int)msg->msg_iovlen, n);
+    return n;
+}
+
+AUDIT_EXPORT ssize_t write(int fd, const void *buf, size_t count)
+{
+    RESOLVE_REAL(write);
+    audit_syscall();
+    return REAL(write)(fd, buf, count);
+}
+
+AUDIT_EXPORT ssize_t writev(int fd, const struct iovec *iov, int iovcnt)
+{
+    RESOLVE_REAL(writev);
+    audit_syscall();
+    return REAL(writev)(fd, iov, iovcnt);
+}
+
+AUDIT_EXPORT ssize_t send(int fd, const void *buf, size_t len, int flags)
+{
+    RESOLVE_REAL(send);
+    audit_syscall();
+    return REAL(send)(fd, buf, len, flags);
+}
+
+AUDIT_EXPORT ssize_t sendto(int fd, const void *buf, size_t len, int flags, const struct sockaddr *addr, socklen_t addrlen)
+{
+    RESOLVE_REAL(sendto);
+    audit_syscall();
+    return REAL(sendto)(fd, buf, len, flags, addr, addrlen);
+}
+
+AUDIT_EXPORT ssize_t sendmsg(int fd, const struct msghdr *msg, int flags)
+{
+    RESOLVE_REAL(sendmsg);
+    audit_syscall();
+    return REAL(sendmsg)(fd, msg, flags);
+}
+
+AUDIT_EXPORT int close(int fd)
+{
+    RESOLVE_REAL(close);
+    audit_syscall();
+    // A reused descriptor must not inherit a partial frame
+    if (fd >= 0 && fd < AUDIT_MAX_FDS)
+        stream_ready[fd] = false;
+    return REAL(close)(fd);
+}
+
+AUDIT_EXPORT int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+    RESOLVE_REAL(epoll_wait);
+    end_ingest_path();
+    int ready = REAL(epoll_wait)(epfd, events, maxevents, timeout);
+    begin_ingest_path(ready);
+    return ready;
+}
+
+AUDIT_EXPORT int epoll_pwait(int epfd, struct epoll_event *events, int maxevents, int timeout, const sigset_t *sigmask)
+{
+    RESOLVE_REAL(epoll_pwait);
+    end_ingest_path();
+    int ready = REAL(epoll_pwait)(epfd, events, maxevents, timeout, sigmask);
+    begin_ingest_path(ready);
+    return ready;
+}
+
+AUDIT_EXPORT int poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+    RESOLVE_REAL(poll);
+    end_ingest_path();
+    int ready = REAL(poll)(fds, nfds, timeout);
+    begin_ingest_path(ready);
+    return ready;
+}
+
+AUDIT_EXPORT int ppoll(struct pollfd *fds, nfds_t nfds, const struct timespec *timeout, const sigset_t *sigmask)
+{
+    RESOLVE_REAL(ppoll);
+    end_ingest_path();
+    int ready = REAL(ppoll)(fds, nfds, timeout, sigmask);
+    begin_ingest_path(ready);
+    return ready;
+}
+
+AUDIT_EXPORT int select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout)
+{
+    RESOLVE_REAL(select);
+    end_ingest_path();
+    int ready = REAL(select)(nfds, readfds, writefds, exceptfds, timeout);
+    begin_ingest_path(ready);
+    return ready;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Setup and report                                                          */
+/* ------------------------------------------------------------------------- */
+
+__attribute__((constructor)) static void audit_init(void)
+{
+    const char *value = getenv("LD2420_AUDIT_WARMUP_FRAMES");
+    if (value != NULL)
+        config.warmup_frames = strtoull(value, NULL, 10);
+    value = getenv("LD2420_AUDIT_ON_ALLOC");
+    if (value != NULL)
+        config.abort_on_alloc = strcmp(value, "report") != 0;
+    value = getenv("LD2420_AUDIT_MAX_READS_PER_EVENT");
+    if (value != NULL)
+        config.max_reads_per_event = strtoull(value, NULL, 10);
+    config.report_path = getenv("LD2420_AUDIT_REPORT");
+
+    // The first backtrace() loads the unwinder, which allocates
+    void *frames[4];
+    backtrace(frames, 4);
+}
+
+static double per(uint64_t value, uint64_t base)
+{
+    return base ? (double)value / (double)base : 0.0;
+}
+
+__attribute__((destructor)) static void audit_report(void)
+{
+    // Close the path of the thread that is exiting
+    in_ingest_path = false;
+
+    uint64_t frames = atomic_load(&counters.frames);
+    uint64_t events = atomic_load(&counters.events);
+    uint64_t reads = atomic_load(&counters.reads);
+    uint64_t alloc_violations = atomic_load(&counters.alloc_violations);
+    uint64_t read_violations = atomic_load(&counters.read_violations);
+    bool failed = alloc_violations > 0 || read_violations > 0;
+
+    FILE *out = config.report_path ? fopen(config.report_path, "w") : NULL;
+    if (out == NULL)
+        out = stderr;
+    fprintf(out, "ld2420 audit\n");
+    fprintf(out, "  frames                %llu (warm-up %llu)\n",
+            (unsigned long long)frames, (unsigned long long)config.warmup_frames);
+    fprintf(out, "  readiness waits       %llu, ready descriptors %llu\n",
+            (unsigned long long)atomic_load(&counters.waits), (unsigned long long)events);
+    fprintf(out, "  reads on ingest path  %llu (%.2f per ready descriptor, at most %llu in one path)\n",
+            (unsigned long long)reads, per(reads, events),
+            (unsigned long long)atomic_load(&counters.max_reads_in_path));
+    fprintf(out, "  syscalls per frame    %.2f\n", per(atomic_load(&counters.syscalls), frames));
+    fprintf(out, "  allocations           %llu in process, %llu on ingest path, %llu after warm-up\n",
+            (unsigned long long)atomic_load(&counters.allocs),
+            (unsigned long long)atomic_load(&counters.path_allocs),
+            (unsigned long long)alloc_violations);
+    fprintf(out, "  frees                 %llu in process, %llu on ingest path\n",
+            (unsigned long long)atomic_load(&counters.frees),
+            (unsigned long long)atomic_load(&counters.path_frees));
+    fprintf(out, "  read budget           %llu per ready descriptor, %llu paths over budget\n",
+            (unsigned long long)config.max_reads_per_event, (unsigned long long)read_violations);
+    if (frames <= config.warmup_frames)
+        fprintf(out, "  result                INCONCLUSIVE (no frames after warm-up)\n");
+    else
+        fprintf(out, "  result                %s\n", failed ? "FAILED" : "ok");
+    if (out != stderr)
+        fclose(out);
+
+    if (failed || frames <= config.warmup_frames)
+        _exit(1);
+}
@@ -0,0 +1,334 @@
+/*
+ * LD2420 batch parser benchmark
+ * -----------------------------
+ * Measures ld2420_parse_rx_batch() against a loop of ld2420_parse_rx_buffer()
+ * calls over the same frames, and checks that both agree on every status
+ * and field. Then does the same for ld2420_decode_report_batch() against
+ * ld2420_report_energy_decode() into one struct per frame.
+ *
+ * Frames are ACKs of the commands in the protocol table with random data,
+ * stored back to back in one arena the way an index over a capture points
+ * into it. `--corrupt` percent of them get one defect (header, footer or
+ * length byte), so the diagnosis path is exercised as well.
+ *
+ * Usage: ld2420_batch_bench [--frames N] [--rounds N] [--corrupt PERCENT]
+ *                           [--seed N] [--min-mfps RATE]
+ *
+ * Exits non-zero on any disagreement, or when the batch rate stays below
+ * --min-mfps million frames per second (0, the default, disables that check).
+ */
+
+#define _GNU_SOURCE
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_batch.h>
+#include <ld2420/ld2420_protocol.h>
+
+typedef struct
+{
+    size_t frames;
+    unsigned rounds;
+    double corrupt_percent;
+    uint32_t seed;
+    double min_mfps;
+} bench_options_t;
+
+typedef struct
+{
+    ld2420_status_t *status;
+    uint16_t *frame_size;
+    uint16_t *cmd_echo;
+    uint16_t *device_status;
+    uint16_t *param_name;
+    uint16_t *param_value;
+} columns_t;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/** Write a random ACK at out and return its size. */
+static uint8_t build_frame(uint8_t *out, uint32_t *rng)
+{
+    static const uint8_t COMMANDS[] = {
+        LD2420_CMD_OPEN_CONFIG_MODE, LD2420_CMD_CLOSE_CONFIG_MODE, LD2420_CMD_READ_VERSION_NUMBER,
+        LD2420_CMD_REBOOT, LD2420_CMD_READ_CONFIG, LD2420_CMD_SET_CONFIG};
+    const uint8_t command = COMMANDS[xorshift32(rng) % sizeof(COMMANDS)];
+
+    size_t data;
+    switch (command)
+    {
+    case LD2420_CMD_OPEN_CONFIG_MODE:
+        data = 4;
+        break;
+    case LD2420_CMD_READ_VERSION_NUMBER:
+        data = 2 + xorshift32(rng) % 16u;
+        break;
+    case LD2420_CMD_READ_CONFIG:
+        data = 4 * (1 + xorshift32(rng) % 8u);
+        break;
+    default:
+        data = 0;
+        break;
+    }
+
+    const size_t size = LD2420_ACK_DATA_OFFSET + data + sizeof(LD2420_END_COMMAND_PACKET);
+    ld2420_protocol_write_le32(out, LD2420_PROTOCOL_COMMAND_HEADER);
+    ld2420_protocol_write_le16(out + LD2420_PROTOCOL_LENGTH_OFFSET, (uint16_t)(size - LD2420_PROTOCOL_FRAME_OVERHEAD));
+    ld2420_protocol_write_le16(out + LD2420_ACK_CMD_ECHO_OFFSET, (uint16_t)(command | LD2420_PROTOCOL_ACK_ECHO_FLAG));
+    ld2420_protocol_write_le16(out + LD2420_ACK_STATUS_OFFSET, (xorshift32(rng) & 15u) == 0 ? 1 : 0);
+    for (size_t i = 0; i < data; i++)
+        out[LD2420_ACK_DATA_OFFSET + i] = (uint8_t)xorshift32(rng);
+    ld2420_protocol_write_le32(out + size - 4, LD2420_PROTOCOL_COMMAND_FOOTER);
+    return (uint8_t)size;
+}
+
+static int alloc_columns(columns_t *c, size_t n)
+{
+    c->status = malloc(n * sizeof(*c->status));
+    c->frame_size = malloc(n * sizeof(uint16_t));
+    c->cmd_echo = malloc(n * sizeof(uint16_t));
+    c->device_status = malloc(n * sizeof(uint16_t));
+    c->param_name = malloc(n * sizeof(uint16_t));
+    c->param_value = malloc(n * sizeof(uint16_t));
+    return c->status && c->frame_size && c->cmd_echo && c->device_status && c->param_name && c->param_value ? 0 : -1;
+}
+
+static void free_columns(columns_t *c)
+{
+    free(c->status);
+    free(c->frame_size);
+    free(c->cmd_echo);
+    free(c->device_status);
+    free(c->param_name);
+    free(c->param_value);
+}
+
+/**
+ * Report frames: per-gate columns (raw and float) from the batch decoder
+ * against one struct per frame. Returns the number of disagreeing frames,
+ * or SIZE_MAX if memory ran out.
+ */
+static size_t bench_reports(const bench_options_t *opt, double *out_batch_mfps, double *out_single_mfps)
+{
+    uint8_t *arena = malloc(opt->frames * LD2420_REPORT_ENERGY_SIZE);
+    const uint8_t **frames = malloc(opt->frames * sizeof(*frames));
+    ld2420_report_energy_t *decoded = malloc(opt->frames * sizeof(*decoded));
+    uint8_t *presence = malloc(opt->frames);
+    uint16_t *distance = malloc(opt->frames * sizeof(*distance));
+    uint16_t *energy = malloc(opt->frames * LD2420_REPORT_GATES * sizeof(*energy));
+    float *energy_f32 = malloc(opt->frames * LD2420_REPORT_GATES * sizeof(*energy_f32));
+    size_t mismatches = SIZE_MAX;
+    if (arena == NULL || frames == NULL || decoded == NULL || presence == NULL || distance == NULL ||
+        energy == NULL || energy_f32 == NULL)
+        goto cleanup;
+
+    uint32_t rng = opt->seed ? opt->seed : 1u;
+    for (size_t i = 0; i < opt->frames; i++)
+    {
+        ld2420_report_energy_t report = {.presence = (uint8_t)(xorshift32(&rng) & 1u),
+                                         .distance_cm = (uint16_t)(xorshift32(&rng) % 800u)};
+        for (unsigned g = 0; g < LD2420_REPORT_GATES; g++)
+            report.energy[g] = (uint16_t)xorshift32(&rng);
+        frames[i] = &arena[i * LD2420_REPORT_ENERGY_SIZE];
+        ld2420_report_energy_encode(&arena[i * LD2420_REPORT_ENERGY_SIZE], &report);
+    }
+
+    ld2420_report_batch_t out = {.presence = presence, .distance_cm = distance, .energy_scale = 1.0f / 65535.0f};
+    for (unsigned g = 0; g < LD2420_REPORT_GATES; g++)
+    {
+        out.energy[g] = &energy[g * opt->frames];
+        out.energy_f32[g] = &energy_f32[g * opt->frames];
+    }
+
+    uint64_t start = now_ns();
+    for (unsigned r = 0; r < opt->rounds; r++)
+        ld2420_decode_report_batch(frames, opt->frames, &out);
+    const uint64_t batch_ns = now_ns() - start;
+
+    start = now_ns();
+    for (unsigned r = 0; r < opt->rounds; r++)
+    {
+        for (size_t i = 0; i < opt->frames; i++)
+            ld2420_report_energy_decode(frames[i], LD2420_REPORT_ENERGY_SIZE, &decoded[i]);
+    }
+    const uint64_t single_ns = now_ns() - start;
+
+    mismatches = 0;
+    for (size_t i = 0; i < opt->frames; i++)
+    {
+        bool same = presence[i] == decoded[i].presence && distance[i] == decoded[i].distance_cm;
+        for (unsigned g = 0; g < LD2420_REPORT_GATES; g++)
+            same = same && out.energy[g][i] == decoded[i].energy[g] &&
+                   out.energy_f32[g][i] == (float)decoded[i].energy[g] * out.energy_scale;
+        if (!same && mismatches++ < 10)
+            fprintf(stderr, "MISMATCH report %zu\n", i);
+    }
+
+    const double total = (double)opt->frames * opt->rounds;
+    *out_batch_mfps = total / ((double)batch_ns / 1e3);
+    *out_single_mfps = total / ((double)single_ns / 1e3);
+
+cleanup:
+    free(arena);
+    free(frames);
+    free(decoded);
+    free(presence);
+    free(distance);
+    free(energy);
+    free(energy_f32);
+    return mismatches;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [--frames N] [--rounds N] [--corrupt PERCENT] [--seed N] [--min-mfps RATE]\n", argv0);
+}
+
+int main(int argc, char **argv)
+{
+    bench_options_t opt = {1000000, 10, 2.0, 1, 0.0};
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            opt.frames = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            opt.rounds = (unsigned)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--corrupt") == 0 && i + 1 < argc)
+            opt.corrupt_percent = strtod(argv[++i], NULL);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            opt.seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--min-mfps") == 0 && i + 1 < argc)
+            opt.min_mfps = strtod(argv[++i], NULL);
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (opt.frames == 0 || opt.rounds == 0)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    uint8_t *arena = malloc(opt.frames * LD2420_MAX_RX_PACKET_SIZE);
+    const uint8_t **frames = malloc(opt.frames * sizeof(*frames));
+    uint8_t *sizes = malloc(opt.frames);
+    columns_t batch = {0}, single = {0};
+    if (arena == NULL || frames == NULL || sizes == NULL ||
+        alloc_columns(&batch, opt.frames) != 0 || alloc_columns(&single, opt.frames) != 0)
+    {
+        fprintf(stderr, "ERROR: out of memory\n");
+        return 1;
+    }
+
+    uint32_t rng = opt.seed ? opt.seed : 1u;
+    size_t used = 0, corrupted = 0;
+    for (size_t i = 0; i < opt.frames; i++)
+    {
+        uint8_t *frame = &arena[used];
+        uint8_t size = build_frame(frame, &rng);
+        if ((double)(xorshift32(&rng) % 10000u) < opt.corrupt_percent * 100.0)
+        {
+            static const size_t DEFECT_OFFSETS[] = {0, 2, LD2420_PROTOCOL_LENGTH_OFFSET};
+            size_t at = DEFECT_OFFSETS[xorshift32(&rng) % 3u];
+            frame[at == 2 ? (size_t)size - 2u : at] ^= (uint8_t)(1u + xorshift32(&rng) % 255u);
+            corrupted++;
+        }
+        frames[i] = frame;
+        sizes[i] = size;
+        used += size;
+    }
+
+    const ld2420_rx_batch_t out = {batch.status, batch.frame_size, batch.cmd_echo, batch.device_status,
+                                   batch.param_name, batch.param_value};
+    size_t valid = 0;
+    uint64_t start = now_ns();
+    for (unsigned r = 0; r < opt.rounds; r++)
+        ld2420_parse_rx_batch(frames, sizes, opt.frames, &out, &valid);
+    const uint64_t batch_ns = now_ns() - start;
+
+    start = now_ns();
+    for (unsigned r = 0; r < opt.rounds; r++)
+    {
+        for (size_t i = 0; i < opt.frames; i++)
+        {
+            single.status[i] = ld2420_parse_rx_buffer(frames[i], sizes[i], &single.frame_size[i], &single.cmd_echo[i],
+                                                      &single.device_status[i], &single.param_name[i],
+                                                      &single.param_value[i]);
+        }
+    }
+    const uint64_t single_ns = now_ns() - start;
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < opt.frames; i++)
+    {
+        bool same = batch.status[i] == single.status[i];
+        if (same && single.status[i] == LD2420_STATUS_OK)
+            same = batch.frame_size[i] == single.frame_size[i] && batch.cmd_echo[i] == single.cmd_echo[i] &&
+                   batch.device_status[i] == single.device_status[i] &&
+                   batch.param_name[i] == single.param_name[i] && batch.param_value[i] == single.param_value[i];
+        if (!same && mismatches++ < 10)
+            fprintf(stderr, "MISMATCH frame %zu: batch status %d, one-shot status %d\n",
+                    i, (int)batch.status[i], (int)single.status[i]);
+    }
+
+    const double total = (double)opt.frames * opt.rounds;
+    const double batch_mfps = total / ((double)batch_ns / 1e3);
+    const double single_mfps = total / ((double)single_ns / 1e3);
+    printf("LD2420 batch parse (%zu frames, %zu corrupted, %u rounds)\n", opt.frames, corrupted, opt.rounds);
+    printf("%-24s %12s %10s\n", "path", "Mframes/s", "ns/frame");
+    printf("%-24s %12.1f %10.2f\n", "ld2420_parse_rx_batch", batch_mfps, 1e3 / batch_mfps);
+    printf("%-24s %12.1f %10.2f\n", "ld2420_parse_rx_buffer", single_mfps, 1e3 / single_mfps);
+    printf("valid %zu, mismatches %zu\n", valid, mismatches);
+
+    double report_batch_mfps = 0, report_single_mfps = 0;
+    const size_t report_mismatches = bench_reports(&opt, &report_batch_mfps, &report_single_mfps);
+    if (report_mismatches == SIZE_MAX)
+    {
+        fprintf(stderr, "ERROR: out of memory\n");
+        return 1;
+    }
+    printf("\nLD2420 report batch decode (%zu frames, %u rounds)\n", opt.frames, opt.rounds);
+    printf("%-30s %12s %10s\n", "path", "Mframes/s", "ns/frame");
+    printf("%-30s %12.1f %10.2f\n", "ld2420_decode_report_batch", report_batch_mfps, 1e3 / report_batch_mfps);
+    printf("%-30s %12.1f %10.2f\n", "ld2420_report_energy_decode", report_single_mfps, 1e3 / report_single_mfps);
+    printf("mismatches %zu\n", report_mismatches);
+
+    int rc = 0;
+    if (mismatches > 0 || report_mismatches > 0)
+        rc = 1;
+    if (opt.min_mfps > 0 && batch_mfps < opt.min_mfps)
+    {
+        fprintf(stderr, "ERROR: batch rate %.1f Mframes/s below --min-mfps %.1f\n", batch_mfps, opt.min_mfps);
+        rc = 1;
+    }
+
+    free(arena);
+    free(frames);
+    free(sizes);
+    free_columns(&batch);
+    free_columns(&single);
+    return rc;
+}
@@ -0,0 +1,780 @@
+/*
+ * LD2420 differential parse checker
+ * ---------------------------------
+ * Runs captures through every parse path and chunking strategy and asserts
+ * that they agree on the emitted frames and on the returned statuses:
+ *
+ * - oracle: a brute-force model that shares no code with the streaming
+ *   parser. Every capture offset is tried as a frame start and the complete
+ *   frame judged on its own, then, from the end of the previous frame on, the
+ *   valid frame that completes first is emitted
+ * - byte-wise: ld2420_stream_feed() once per byte; it records the status of
+ *   every input byte and the offset of every frame. Its frames must be oracle
+ *   frames at the same offsets, with the same contents. An oracle frame it does
+ *   not emit must have been lost while resyncing after a broken frame, which
+ *   is the only way the parser may differ from the oracle
+ * - single-shot: one ld2420_stream_feed_bytes() call for the whole capture
+ * - chunked: ld2420_stream_feed_bytes() with random chunk sizes
+ * - stop/resume: chunked, with a callback that regularly asks to stop; the
+ *   rest of the chunk is fed again from the reported consumed count
+ * - handover: chunked, moving the parser state into a fresh context through
+ *   ld2420_stream_snapshot()/ld2420_stream_restore() after every chunk
+ *
+ * The multi-byte calls must emit exactly the byte-wise frames, and each call
+ * must return the first error among the byte-wise statuses of the bytes it
+ * consumed.
+ *
+ * Captures are random blocks (a mix of valid frames, corrupted frames and line
+ * noise, generated from `--seed` and the block number) and any files given on
+ * the command line, such as recordings from a real sensor. Blocks are spread
+ * over `--jobs` threads. A failing random block is written to
+ * diffcheck-fail-<seed>-<block>.bin so it can be replayed as a file.
+ *
+ * Usage: ld2420_diffcheck [--bytes N[K|M|G]] [--block BYTES] [--seed N]
+ *                         [--jobs N] [CAPTURE...]
+ */
+
+#define _GNU_SOURCE
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/ld2420_stream.h>
+
+#define DEFAULT_BLOCK_SIZE (1u << 20)
+#define HEADER_SIZE sizeof(LD2420_BEG_COMMAND_PACKET)
+#define FOOTER_SIZE sizeof(LD2420_END_COMMAND_PACKET)
+
+typedef struct
+{
+    uint16_t size;
+    uint16_t cmd_echo;
+    uint16_t status;
+    uint32_t digest;
+    size_t end; // capture offset after the frame; byte-wise only
+} frame_record_t;
+
+typedef struct
+{
+    frame_record_t *frames;
+    size_t count;
+    size_t capacity;
+} frame_log_t;
+
+/** Everything one worker needs to check a capture; reused between captures. */
+typedef struct
+{
+    uint8_t *statuses; // byte-wise status per input byte
+    uint8_t *sizes;    // oracle frame size per capture offset, 0 if none starts there
+    size_t capacity;
+    frame_log_t bytewise;
+    frame_log_t actual;
+    size_t missed; // oracle frames lost while resyncing
+    uint32_t rng;
+} checker_t;
+
+typedef struct
+{
+    uint64_t total_bytes;
+    size_t block_size;
+    uint32_t seed;
+    unsigned jobs;
+    char **files;
+    int file_count;
+} options_t;
+
+static options_t options;
+static atomic_uint_fast64_t next_block;
+static atomic_uint_fast64_t frames_checked;
+static atomic_uint_fast64_t frames_missed;
+static atomic_int failed;
+
+static uint32_t next_random(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/** FNV-1a over the frame bytes. */
+static uint32_t digest(const uint8_t *data, size_t size)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < size; i++)
+        h = (h ^ data[i]) * 16777619u;
+    return h;
+}
+
+/** Capture offset after the byte being fed byte-wise, 0 for the other paths. */
+static __thread size_t feeding_end;
+
+static void log_frame(frame_log_t *log, const uint8_t *frame, uint16_t size, uint16_t cmd_echo, uint16_t status)
+{
+    if (log->count == log->capacity)
+    {
+        size_t capacity = log->capacity ? log->capacity * 2 : 1024;
+        frame_record_t *grown = realloc(log->frames, capacity * sizeof(*grown));
+        if (grown == NULL)
+        {
+            fprintf(stderr, "ERROR: out of memory\n");
+            exit(1);
+        }
+        log->frames = grown;
+        log->capacity = capacity;
+    }
+    frame_record_t *r = &log->frames[log->count++];
+    r->size = size;
+    r->cmd_echo = cmd_echo;
+    r->status = status;
+    r->digest = digest(frame, size);
+    r->end = feeding_end;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Oracle                                                                    */
+/* ------------------------------------------------------------------------- */
+
+static bool is_header(const uint8_t *p)
+{
+    return memcmp(p, LD2420_BEG_COMMAND_PACKET, HEADER_SIZE) == 0;
+}
+
+/**
+ * Size of the valid ACK starting at capture offset `at`, or 0. The whole
+ * frame is judged at once: header, full command echo with the ACK flag,
+ * a length the protocol table allows for that command, footer, and the
+ * one-shot parser.
+ */
+static uint8_t oracle_frame_size(const uint8_t *capture, size_t size, size_t at)
+{
+    if (size - at < LD2420_MIN_RX_PACKET_SIZE || !is_header(&capture[at]))
+        return 0;
+    const uint16_t length = ld2420_protocol_read_le16(&capture[at + LD2420_PROTOCOL_LENGTH_OFFSET]);
+    const uint16_t echo = ld2420_protocol_read_le16(&capture[at + LD2420_ACK_CMD_ECHO_OFFSET]);
+    const size_t total = LD2420_PROTOCOL_FRAME_OVERHEAD + (size_t)length;
+    if (total > LD2420_MAX_RX_PACKET_SIZE || total > size - at)
+        return 0;
+    if (echo != ((echo & 0xFFu) | LD2420_PROTOCOL_ACK_ECHO_FLAG) ||
+        !ld2420_protocol_ack_length_valid((uint8_t)echo, length))
+        return 0;
+    if (memcmp(&capture[at + total - FOOTER_SIZE], LD2420_END_COMMAND_PACKET, FOOTER_SIZE) != 0)
+        return 0;
+
+    uint16_t frame_size, cmd_echo, status, param_name, param_value;
+    if (ld2420_parse_rx_buffer(&capture[at], (uint8_t)total, &frame_size, &cmd_echo, &status,
+                               &param_name, &param_value) != LD2420_STATUS_OK)
+        return 0;
+    return (uint8_t)total;
+}
+
+/**
+ * The next frame an ideal parser emits from offset `from` on: of all valid
+ * frames starting there or later, the one that completes first, and of those
+ * the one starting first. Returns false when no valid frame is left.
+ */
+static bool oracle_next(const checker_t *c, size_t size, size_t from, size_t *start)
+{
+    size_t best_end = SIZE_MAX;
+    for (size_t at = from; at < size && at < best_end; at++)
+    {
+        if (c->sizes[at] != 0 && at + c->sizes[at] < best_end)
+        {
+            best_end = at + c->sizes[at];
+            *start = at;
+        }
+    }
+    return best_end != SIZE_MAX;
+}
+
+/**
+ * Whether the stream may have lost the valid frame at `start` while resyncing.
+ * It only loses a frame whose header arrives while an earlier, broken frame is
+ * under construction and every candidate slot is taken. That broken frame
+ * started earlier and is at most LD2420_MAX_RX_PACKET_SIZE bytes long, so it
+ * fails with an error status after the lost header is in and before that many
+ * bytes from `start`, unless the capture ends first.
+ */
+static bool missed_while_resyncing(const checker_t *c, size_t size, size_t start)
+{
+    const size_t until = start + LD2420_MAX_RX_PACKET_SIZE;
+    if (until > size)
+        return true;
+    for (size_t i = start + HEADER_SIZE - 1; i < until; i++)
+    {
+        if (c->statuses[i] != LD2420_STATUS_OK)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Check the byte-wise frames against the oracle: each one must be a valid
+ * frame with the fields the one-shot parser reads from the capture at that
+ * offset, and each oracle frame it did not emit must have been lost while
+ * resyncing.
+ */
+static bool check_oracle(checker_t *c, const uint8_t *capture, size_t size, const char *name)
+{
+    size_t cursor = 0, previous_end = 0, start;
+    for (size_t k = 0; k <= c->bytewise.count; k++)
+    {
+        const frame_record_t *f = k < c->bytewise.count ? &c->bytewise.frames[k] : NULL;
+        const size_t end = f ? f->end : SIZE_MAX;
+        const size_t at = f ? f->end - f->size : SIZE_MAX;
+
+        // Oracle frames that complete before this one, or on the same byte
+        // but start earlier, were missed
+        while (oracle_next(c, size, cursor, &start) &&
+               (start + c->sizes[start] < end || (start + c->sizes[start] == end && start < at)))
+        {
+            if (!missed_while_resyncing(c, size, start))
+            {
+                fprintf(stderr, "%s: oracle: frame at offset %zu missed without a resync\n", name, start);
+                return false;
+            }
+            c->missed++;
+            cursor = start + c->sizes[start];
+        }
+        if (f == NULL)
+            break;
+
+        frame_record_t expected = {0};
+        if (at < previous_end || c->sizes[at] != f->size)
+        {
+            fprintf(stderr, "%s: oracle: byte-wise frame %zu at offset %zu is not a valid frame\n", name, k, at);
+            return false;
+        }
+        uint16_t frame_size, param_name, param_value;
+        ld2420_parse_rx_buffer(&capture[at], (uint8_t)f->size, &frame_size, &expected.cmd_echo, &expected.status,
+                               &param_name, &param_value);
+        if (f->cmd_echo != expected.cmd_echo || f->status != expected.status ||
+            f->digest != digest(&capture[at], f->size))
+        {
+            fprintf(stderr, "%s: oracle: byte-wise frame %zu at offset %zu has other contents\n", name, k, at);
+            return false;
+        }
+        cursor = previous_end = end;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Library paths                                                             */
+/* ------------------------------------------------------------------------- */
+
+/** Callback target; the stream callback has no user pointer. */
+static __thread frame_log_t *recording;
+static __thread unsigned stop_every;
+static __thread unsigned until_stop;
+
+static bool on_frame(const uint8_t *frame, uint16_t frame_size_bytes, uint16_t cmd_echo, uint16_t status)
+{
+    log_frame(recording, frame, frame_size_bytes, cmd_echo, status);
+    if (stop_every == 0)
+        return true;
+    if (--until_stop > 0)
+        return true;
+    until_stop = stop_every;
+    return false;
+}
+
+/** First error among the byte-wise statuses of [from, to). */
+static ld2420_status_t expected_status(const checker_t *c, size_t from, size_t to)
+{
+    for (size_t i = from; i < to; i++)
+    {
+        if (c->statuses[i] != LD2420_STATUS_OK)
+            return (ld2420_status_t)c->statuses[i];
+    }
+    return LD2420_STATUS_OK;
+}
+
+static bool compare_logs(const frame_log_t *expected, const frame_log_t *actual, const char *path, const char *name)
+{
+    size_t n = expected->count < actual->count ? expected->count : actual->count;
+    for (size_t i = 0; i < n; i++)
+    {
+        const frame_record_t *e = &expected->frames[i], *a = &actual->frames[i];
+        if (e->size != a->size || e->cmd_echo != a->cmd_echo || e->status != a->status || e->digest != a->digest)
+        {
+            fprintf(stderr, "%s: %s: frame %zu differs (size %u, echo 0x%04X vs size %u, echo 0x%04X)\n",
+                    name, path, i, actual->frames[i].size, actual->frames[i].cmd_echo,
+                    expected->frames[i].size, expected->frames[i].cmd_echo);
+            return false;
+        }
+    }
+    if (expected->count != actual->count)
+    {
+        fprintf(stderr, "%s: %s: %zu frames, byte-wise %zu\n", name, path, actual->count, expected->count);
+        return false;
+    }
+    return true;
+}
+
+static size_t random_chunk(checker_t *c, size_t remaining)
+{
+    // Mostly short reads as from a UART, sometimes large ones as from a file
+    uint32_t r = next_random(&c->rng);
+    size_t chunk = (r & 7u) == 0 ? 1u + (r >> 3) % 4096u : 1u + (r >> 3) % 64u;
+    return chunk < remaining ? chunk : remaining;
+}
+
+/** Move the parser state into a scrambled context, as a process handover would. */
+static bool hand_over(ld2420_stream_t *s, const char *path, const char *name, size_t offset)
+{
+    uint8_t snapshot[LD2420_STREAM_SNAPSHOT_MAX_SIZE];
+    size_t written = 0;
+    ld2420_status_t status = ld2420_stream_snapshot(s, snapshot, sizeof(snapshot), &written);
+    if (status == LD2420_STATUS_OK)
+    {
+        memset(s, 0xA5, sizeof(*s));
+        status = ld2420_stream_restore(s, snapshot, written);
+    }
+    if (status != LD2420_STATUS_OK)
+    {
+        fprintf(stderr, "%s: %s: snapshot/restore failed with %d at offset %zu\n", name, path, status, offset);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Feed the capture in chunks (whole capture when `whole`), optionally with a
+ * callback that stops every few frames and a state handover after every chunk.
+ * Returns false on the first mismatch.
+ */
+static bool check_chunked(checker_t *c, const uint8_t *capture, size_t size, bool whole, unsigned stop, bool handover, const char *path, const char *name)
+{
+    ld2420_stream_t s;
+    ld2420_stream_init(&s);
+    c->actual.count = 0;
+    recording = &c->actual;
+    stop_every = stop;
+    until_stop = stop;
+
+    size_t offset = 0;
+    while (offset < size)
+    {
+        size_t chunk = whole ? size - offset : random_chunk(c, size - offset);
+        size_t consumed = 0;
+        ld2420_status_t status = ld2420_stream_feed_bytes(&s, &capture[offset], chunk, on_frame, &consumed);
+        if (consumed == 0 || consumed > chunk || (stop == 0 && consumed != chunk))
+        {
+            fprintf(stderr, "%s: %s: consumed %zu of %zu bytes at offset %zu\n", name, path, consumed, chunk, offset);
+            return false;
+        }
+        ld2420_status_t expected = expected_status(c, offset, offset + consumed);
+        if (status != expected)
+        {
+            fprintf(stderr, "%s: %s: status %d for bytes %zu..%zu, byte-wise %d\n",
+                    name, path, status, offset, offset + consumed, expected);
+            return false;
+        }
+        offset += consumed;
+        if (handover && !hand_over(&s, path, name, offset))
+            return false;
+    }
+    stop_every = 0;
+    return compare_logs(&c->bytewise, &c->actual, path, name);
+}
+
+/** Run one capture through every path. */
+static bool check_capture(checker_t *c, const uint8_t *capture, size_t size, const char *name)
+{
+    if (c->capacity < size)
+    {
+        free(c->statuses);
+        free(c->sizes);
+        c->statuses = malloc(size);
+        c->sizes = malloc(size);
+        c->capacity = c->statuses && c->sizes ? size : 0;
+        if (c->capacity == 0)
+        {
+            fprintf(stderr, "ERROR: out of memory\n");
+            exit(1);
+        }
+    }
+
+    // Byte-wise, recording every status and where every frame ends
+    ld2420_stream_t s;
+    ld2420_stream_init(&s);
+    c->bytewise.count = 0;
+    recording = &c->bytewise;
+    stop_every = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        feeding_end = i + 1;
+        c->statuses[i] = (uint8_t)ld2420_stream_feed(&s, &capture[i], 1, on_frame);
+    }
+    feeding_end = 0;
+
+    for (size_t at = 0; at < size; at++)
+        c->sizes[at] = oracle_frame_size(capture, size, at);
+    c->missed = 0;
+    if (!check_oracle(c, capture, size, name))
+        return false;
+
+    if (!check_chunked(c, capture, size, true, 0, false, "single-shot", name) ||
+        !check_chunked(c, capture, size, false, 0, false, "chunked", name) ||
+        !check_chunked(c, capture, size, false, 1u + next_random(&c->rng) % 4u, false, "stop/resume", name) ||
+        !check_chunked(c, capture, size, false, 1u + next_random(&c->rng) % 4u, true, "handover", name))
+        return false;
+
+    atomic_fetch_add(&frames_checked, c->bytewise.count);
+    atomic_fetch_add(&frames_missed, c->missed);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Capture generation                                                        */
+/* ------------------------------------------------------------------------- */
+
+static const uint8_t MARKER_BYTES[] = {0xFD, 0xFC, 0xFB, 0xFA, 0x04, 0x03, 0x02, 0x01};
+
+/**
+ * A valid ACK with random data. Lengths follow the per-command sizes the
+ * stream parser accepts; an unknown command stands for ACKs the table does
+ * not describe and may have any length.
+ */
+static size_t put_frame(uint8_t *out, size_t room, uint32_t *rng)
+{
+    static const uint8_t COMMANDS[] = {
+        LD2420_CMD_OPEN_CONFIG_MODE, LD2420_CMD_CLOSE_CONFIG_MODE, LD2420_CMD_READ_VERSION_NUMBER,
+        LD2420_CMD_REBOOT, LD2420_CMD_READ_CONFIG, LD2420_CMD_SET_CONFIG, 0x60};
+    const uint8_t command = COMMANDS[next_random(rng) % sizeof(COMMANDS)];
+
+    // Bytes after the status field
+    size_t payload;
+    switch (command)
+    {
+    case LD2420_CMD_OPEN_CONFIG_MODE:
+        payload = 4;
+        break;
+    case LD2420_CMD_READ_VERSION_NUMBER:
+        payload = 2 + next_random(rng) % (LD2420_ACK_READ_VERSION_NUMBER_VERSION_MAX_COUNT + 1u);
+        break;
+    case LD2420_CMD_READ_CONFIG:
+        payload = 4 * (1 + next_random(rng) % LD2420_ACK_READ_CONFIG_VALUES_MAX_COUNT);
+        break;
+    case 0x60:
+        payload = next_random(rng) % (LD2420_MAX_RX_PACKET_SIZE - LD2420_MIN_RX_PACKET_SIZE + 1u);
+        break;
+    default:
+        payload = 0;
+        break;
+    }
+    size_t total = LD2420_MIN_RX_PACKET_SIZE + payload;
+    if (total > room)
+        return 0;
+
+    memcpy(out, LD2420_BEG_COMMAND_PACKET, HEADER_SIZE);
+    out[4] = (uint8_t)(4 + payload);
+    out[5] = 0;
+    out[6] = command;
+    out[7] = 0x01;
+    out[8] = (next_random(rng) & 7u) == 0 ? 1 : 0;
+    out[9] = 0;
+    for (size_t i = 0; i < payload; i++)
+    {
+        uint32_t v = next_random(rng);
+        out[10 + i] = (v & 31u) == 0 ? MARKER_BYTES[(v >> 5) % sizeof(MARKER_BYTES)] : (uint8_t)(v >> 8);
+    }
+    memcpy(&out[total - FOOTER_SIZE], LD2420_END_COMMAND_PACKET, FOOTER_SIZE);
+    return total;
+}
+
+/** Fill a block with valid frames, corrupted frames and line noise. */
+static void generate_block(uint8_t *block, size_t size, uint32_t seed)
+{
+    uint32_t rng = seed ? seed : 1;
+    size_t used = 0;
+    while (used < size)
+    {
+        size_t room = size - used;
+        uint8_t *out = &block[used];
+        size_t n = 0;
+        uint32_t kind = next_random(&rng) % 100u;
+
+        if (kind < 50)
+        {
+            n = put_frame(out, room, &rng);
+        }
+        else if (kind < 70)
+        {
+            // Valid frame with one defect: flipped byte, truncation or bad length
+            n = put_frame(out, room, &rng);
+            if (n > 0)
+            {
+                uint32_t defect = next_random(&rng) % 3u;
+                if (defect == 0)
+                    out[next_random(&rng) % n] ^= (uint8_t)(1u << (next_random(&rng) % 8u));
+                else if (defect == 1)
+                    n = 1 + next_random(&rng) % (n - 1);
+                else
+                    out[4 + next_random(&rng) % 2u] = (uint8_t)next_random(&rng);
+            }
+        }
+        else if (kind < 85)
+        {
+            // Line noise biased towards marker bytes
+            n = 1 + next_random(&rng) % 64u;
+            if (n > room)
+                n = room;
+            for (size_t i = 0; i < n; i++)
+            {
+                uint32_t v = next_random(&rng);
+                out[i] = (v & 1u) ? MARKER_BYTES[(v >> 1) % sizeof(MARKER_BYTES)] : (uint8_t)(v >> 8);
+            }
+        }
+        else if (kind < 95)
+        {
+            // Header, random length and no frame behind it
+            if (room >= HEADER_SIZE + 2)
+            {
+                memcpy(out, LD2420_BEG_COMMAND_PACKET, HEADER_SIZE);
+                out[4] = (uint8_t)next_random(&rng);
+                out[5] = (next_random(&rng) & 3u) == 0 ? (uint8_t)next_random(&rng) : 0;
+                n = HEADER_SIZE + 2;
+            }
+        }
+        else
+        {
+            // Partial header
+            n = 1 + next_random(&rng) % (HEADER_SIZE - 1);
+            if (n > room)
+                n = room;
+            memcpy(out, LD2420_BEG_COMMAND_PACKET, n);
+        }
+
+        if (n == 0)
+        {
+            // Not enough room for the chosen segment; finish with noise
+            n = room;
+            for (size_t i = 0; i < n; i++)
+                out[i] = (uint8_t)next_random(&rng);
+        }
+        used += n;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/* Driver                                                                    */
+/* ------------------------------------------------------------------------- */
+
+static void *worker_main(void *arg)
+{
+    (void)arg;
+    checker_t c = {0};
+    uint8_t *block = malloc(options.block_size);
+    if (block == NULL)
+    {
+        atomic_store(&failed, 1);
+        return NULL;
+    }
+
+    uint64_t blocks = (options.total_bytes + options.block_size - 1) / options.block_size;
+    for (;;)
+    {
+        uint64_t index = atomic_fetch_add(&next_block, 1);
+        if (index >= blocks || atomic_load(&failed))
+            break;
+
+        uint32_t block_seed = options.seed * 2654435761u + (uint32_t)index;
+        size_t size = options.block_size;
+        if ((index + 1) * options.block_size > options.total_bytes)
+            size = (size_t)(options.total_bytes - index * options.block_size);
+        generate_block(block, size, block_seed);
+        c.rng = block_seed ^ 0x9E3779B9u;
+
+        char name[64];
+        snprintf(name, sizeof(name), "block %" PRIu64, index);
+        if (!check_capture(&c, block, size, name))
+        {
+            atomic_store(&failed, 1);
+            char path[96];
+            snprintf(path, sizeof(path), "diffcheck-fail-%" PRIu32 "-%" PRIu64 ".bin", options.seed, index);
+            FILE *f = fopen(path, "wb");
+            if (f != NULL)
+            {
+                fwrite(block, 1, size, f);
+                fclose(f);
+                fprintf(stderr, "failing capture written to %s\n", path);
+            }
+            break;
+        }
+    }
+
+    free(block);
+    free(c.statuses);
+    free(c.sizes);
+    free(c.bytewise.frames);
+    free(c.actual.frames);
+    return NULL;
+}
+
+static int check_file(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        fprintf(stderr, "ERROR: cannot open %s\n", path);
+        return 1;
+    }
+    size_t capacity = 1u << 16, size = 0;
+    uint8_t *data = malloc(capacity);
+    size_t n;
+    while (data != NULL && (n = fread(&data[size], 1, capacity - size, f)) > 0)
+    {
+        size += n;
+        if (size == capacity)
+        {
+            uint8_t *grown = realloc(data, capacity * 2);
+            if (grown == NULL)
+            {
+                free(data);
+                data = NULL;
+                break;
+            }
+            data = grown;
+            capacity *= 2;
+        }
+    }
+    fclose(f);
+    if (data == NULL)
+    {
+        fprintf(stderr, "ERROR: out of memory reading %s\n", path);
+        return 1;
+    }
+
+    checker_t c = {.rng = options.seed | 1u};
+    bool ok = check_capture(&c, data, size, path);
+    printf("%s: %zu bytes, %zu frames, %zu lost while resyncing, %s\n", path, size, c.bytewise.count, c.missed,
+           ok ? "ok" : "MISMATCH");
+    free(data);
+    free(c.statuses);
+    free(c.sizes);
+    free(c.bytewise.frames);
+    free(c.actual.frames);
+    return ok ? 0 : 1;
+}
+
+static uint64_t parse_size(const char *text)
+{
+    char *end = NULL;
+    uint64_t value = strtoull(text, &end, 10);
+    switch (end ? *end : '\0')
+    {
+    case 'G':
+    case 'g':
+        value <<= 10;
+        /* fall through */
+    case 'M':
+    case 'm':
+        value <<= 10;
+        /* fall through */
+    case 'K':
+    case 'k':
+        value <<= 10;
+        break;
+    default:
+        break;
+    }
+    return value;
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+    options.total_bytes = 64u << 20;
+    options.block_size = DEFAULT_BLOCK_SIZE;
+    options.seed = 1;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    options.jobs = cpus > 0 ? (unsigned)cpus : 1;
+    options.files = calloc((size_t)argc, sizeof(char *));
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--bytes") == 0 && i + 1 < argc)
+            options.total_bytes = parse_size(argv[++i]);
+        else if (strcmp(argv[i], "--block") == 0 && i + 1 < argc)
+            options.block_size = (size_t)parse_size(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            options.seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc)
+            options.jobs = (unsigned)strtoul(argv[++i], NULL, 10);
+        else if (argv[i][0] != '-' && options.files != NULL)
+            options.files[options.file_count++] = argv[i];
+        else
+        {
+            fprintf(stderr, "usage: %s [--bytes N[K|M|G]] [--block BYTES] [--seed N] [--jobs N] [CAPTURE...]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (options.block_size == 0 || options.jobs == 0)
+    {
+        fprintf(stderr, "ERROR: --block and --jobs must be positive\n");
+        return 2;
+    }
+
+    int failures = 0;
+    for (int i = 0; i < options.file_count; i++)
+        failures += check_file(options.files[i]);
+
+    if (options.total_bytes > 0)
+    {
+        atomic_store(&frames_checked, 0);
+        atomic_store(&frames_missed, 0);
+        double start = now_s();
+        pthread_t *threads = malloc(options.jobs * sizeof(*threads));
+        unsigned started = 0;
+        for (; threads != NULL && started < options.jobs; started++)
+        {
+            if (pthread_create(&threads[started], NULL, worker_main, NULL) != 0)
+                break;
+        }
+        for (unsigned i = 0; i < started; i++)
+            pthread_join(threads[i], NULL);
+        free(threads);
+        double elapsed = now_s() - start;
+
+        if (started == 0)
+        {
+            fprintf(stderr, "ERROR: no worker thread could be started\n");
+            failures++;
+        }
+        else if (atomic_load(&failed))
+        {
+            failures++;
+        }
+        else
+        {
+            double mib = (double)options.total_bytes / (1024.0 * 1024.0);
+            printf("random: %.0f MiB, %" PRIuFAST64 " frames, %" PRIuFAST64 " lost while resyncing, seed %" PRIu32
+                   ", %u jobs, %.2f s (%.1f MiB/s), ok\n",
+                   mib, (uint_fast64_t)atomic_load(&frames_checked), (uint_fast64_t)atomic_load(&frames_missed),
+                   options.seed, started,
+                   elapsed, elapsed > 0.0 ? mib / elapsed : 0.0);
+        }
+    }
+
+    free(options.files);
+    return failures == 0 ? 0 : 1;
+}
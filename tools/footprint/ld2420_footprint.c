@@ -0,0 +1,220 @@
+/*
+ * LD2420 host per-sensor memory footprint
+ * ---------------------------------------
+ * Measures how much memory each additional sensor costs on the host side:
+ * the static size of the per-sensor state and the resident memory actually
+ * touched once N sensors have been initialized and have parsed a frame.
+ *
+ * Exits with a non-zero status when either number exceeds the per-sensor
+ * budget, so the check can run as a CTest.
+ *
+ * Usage: ld2420_footprint [--sensors N] [--budget BYTES]
+ */
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_stream.h>
+#include <ld2420/platform/linux/ld2420_linux.h>
+
+/** OPEN_CONFIG_MODE acknowledgement used to exercise every context. */
+static const uint8_t SAMPLE_FRAME[] = {
+    0xFD, 0xFC, 0xFB, 0xFA,
+    0x08, 0x00, 0xFF, 0x01,
+    0x00, 0x00, 0x02, 0x00, 0x20, 0x00,
+    0x04, 0x03, 0x02, 0x01};
+
+static size_t frames_seen;
+
+static bool on_frame(
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    (void)frame;
+    (void)frame_size_bytes;
+    (void)cmd_echo;
+    (void)status;
+    frames_seen++;
+    return true;
+}
+
+/**
+ * Anonymous resident memory of the current process in bytes, read from
+ * /proc/self/statm (resident minus file-backed pages). File-backed pages are
+ * left out because the first call into a libc function faults in its code,
+ * which has nothing to do with per-sensor state. Returns 0 when the value
+ * cannot be determined.
+ */
+static size_t resident_bytes(void)
+{
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (f == NULL)
+        return 0;
+
+    unsigned long size_pages = 0, resident_pages = 0, shared_pages = 0;
+    int fields = fscanf(f, "%lu %lu %lu", &size_pages, &resident_pages, &shared_pages);
+    fclose(f);
+    if (fields != 3 || shared_pages > resident_pages)
+        return 0;
+
+    return (size_t)(resident_pages - shared_pages) * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * Multi-sensor stream path: one ld2420_stream_t per sensor, every context
+ * initialized and fed a complete frame byte by byte.
+ */
+static double measure_stream_contexts(size_t sensors)
+{
+    size_t before = resident_bytes();
+    ld2420_stream_t *streams = malloc(sensors * sizeof(*streams));
+    if (streams == NULL)
+        return -1.0;
+
+    for (size_t i = 0; i < sensors; i++)
+    {
+        ld2420_stream_init(&streams[i]);
+        for (size_t b = 0; b < sizeof(SAMPLE_FRAME); b++)
+            ld2420_stream_feed(&streams[i], &SAMPLE_FRAME[b], 1, on_frame);
+    }
+
+    size_t after = resident_bytes();
+    free(streams);
+    if (before == 0 || after < before)
+        return -1.0;
+    return (double)(after - before) / (double)sensors;
+}
+
+static void on_ingest_frame(
+    void *user,
+    uint16_t port_index,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    (void)user;
+    (void)port_index;
+    on_frame(frame, frame_size_bytes, cmd_echo, status);
+}
+
+/**
+ * Linux ingest path: one ingest context with up to LD2420_LINUX_MAX_PORTS
+ * ports backed by pipes, every port fed a frame through the real poll loop.
+ * The context embeds its whole port table, so the per-sensor cost is the
+ * context size divided by the ports actually used.
+ */
+static double measure_linux_ingest(size_t sensors, size_t *out_ports)
+{
+    size_t ports = sensors < LD2420_LINUX_MAX_PORTS ? sensors : LD2420_LINUX_MAX_PORTS;
+    *out_ports = ports;
+
+    size_t before = resident_bytes();
+    ld2420_linux_ingest_t *ingest = malloc(sizeof(*ingest));
+    int *writers = malloc(ports * sizeof(*writers));
+    if (ingest == NULL || writers == NULL ||
+        ld2420_linux_ingest_init(ingest, on_ingest_frame, NULL) != LD2420_STATUS_OK)
+    {
+        free(ingest);
+        free(writers);
+        return -1.0;
+    }
+
+    size_t attached = 0;
+    while (attached < ports)
+    {
+        int fds[2];
+        if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0)
+            break;
+        if (ld2420_linux_ingest_add(ingest, fds[0], NULL) != LD2420_STATUS_OK)
+        {
+            close(fds[0]);
+            close(fds[1]);
+            break;
+        }
+        writers[attached++] = fds[1];
+        if (write(fds[1], SAMPLE_FRAME, sizeof(SAMPLE_FRAME)) != (ssize_t)sizeof(SAMPLE_FRAME))
+            break;
+    }
+
+    size_t before_frames = frames_seen;
+    while (frames_seen - before_frames < attached && ld2420_linux_ingest_poll(ingest, 100) > 0)
+        ;
+    size_t after = resident_bytes();
+
+    ld2420_linux_ingest_deinit(ingest);
+    for (size_t i = 0; i < attached; i++)
+        close(writers[i]);
+    free(writers);
+    free(ingest);
+
+    if (attached != ports || frames_seen - before_frames != attached || before == 0 || after < before)
+        return -1.0;
+    return (double)(after - before) / (double)ports;
+}
+
+static int check(const char *path, size_t static_bytes, double runtime_bytes, size_t budget)
+{
+    if (runtime_bytes < 0.0)
+    {
+        printf("%-24s %8zu %12s %8zu  %s\n", path, static_bytes, "n/a", budget, "MEASUREMENT FAILED");
+        return 1;
+    }
+
+    int over = (budget > 0 && (static_bytes > budget || runtime_bytes > (double)budget));
+    printf("%-24s %8zu %12.1f %8zu  %s\n",
+           path, static_bytes, runtime_bytes, budget, over ? "OVER BUDGET" : "ok");
+    return over;
+}
+
+int main(int argc, char **argv)
+{
+    size_t sensors = 10000;
+    size_t budget = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--sensors") == 0 && i + 1 < argc)
+            sensors = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc)
+            budget = strtoul(argv[++i], NULL, 10);
+        else
+        {
+            fprintf(stderr, "usage: %s [--sensors N] [--budget BYTES]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (sensors == 0)
+    {
+        fprintf(stderr, "ERROR: --sensors must be positive\n");
+        return 2;
+    }
+
+    printf("LD2420 host per-sensor memory (%zu sensors, bytes per sensor)\n", sensors);
+    printf("%-24s %8s %12s %8s\n", "path", "static", "resident", "budget");
+
+    int failures = 0;
+    failures += check("stream", sizeof(ld2420_stream_t),
+                      measure_stream_contexts(sensors), budget);
+
+    size_t ports = 0;
+    double ingest_bytes = measure_linux_ingest(sensors, &ports);
+    failures += check("linux_ingest", sizeof(ld2420_linux_port_t), ingest_bytes, budget);
+    if (ports < sensors)
+        printf("  (linux_ingest measured with %zu ports, LD2420_LINUX_MAX_PORTS)\n", ports);
+
+    if (frames_seen == 0)
+    {
+        fprintf(stderr, "ERROR: no frames were parsed, measurement is meaningless\n");
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
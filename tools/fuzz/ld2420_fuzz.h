@@ -0,0 +1,55 @@
+#pragma once
+/*
+ * Shared definitions for the LD2420 fuzz harnesses.
+ *
+ * Every harness implements the libFuzzer entry point. With Clang it is linked
+ * against libFuzzer; with other compilers it is linked against the standalone
+ * driver in ld2420_fuzz_driver.c, which accepts the same command line.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <ld2420/ld2420.h>
+
+#ifndef LD2420_WORK_COUNTERS
+#error "The fuzz harnesses need the core built with LD2420_CORE_WORK_COUNTERS=ON"
+#endif
+
+/**
+ * Work budget: bytes examined per input byte, plus a constant allowance per
+ * input. The worst case found while fuzzing is about 9-12 bytes per input byte
+ * (header search in noise, resynchronization after a bad footer), so this
+ * leaves a 2-3x margin. A change that makes resynchronization quadratic blows
+ * through it immediately. Both can be overridden on the compiler command line.
+ */
+#ifndef LD2420_FUZZ_WORK_PER_BYTE
+#define LD2420_FUZZ_WORK_PER_BYTE 32u
+#endif
+#ifndef LD2420_FUZZ_WORK_SLACK
+#define LD2420_FUZZ_WORK_SLACK 1024u
+#endif
+
+/** Abort with a message so that both libFuzzer and the driver record a crash. */
+#define LD2420_FUZZ_ASSERT(cond, ...)                                  \
+    do                                                                 \
+    {                                                                  \
+        if (!(cond))                                                   \
+        {                                                              \
+            fprintf(stderr, "%s:%d: assertion failed: %s: ", __FILE__, \
+                    __LINE__, #cond);                                  \
+            fprintf(stderr, __VA_ARGS__);                              \
+            fputc('\n', stderr);                                       \
+            abort();                                                   \
+        }                                                              \
+    } while (0)
+
+/** Upper bound on the work allowed for an input of `size` bytes. */
+static inline uint64_t ld2420_fuzz_work_budget(size_t size)
+{
+    return (uint64_t)size * LD2420_FUZZ_WORK_PER_BYTE + LD2420_FUZZ_WORK_SLACK;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
@@ -0,0 +1,320 @@
+/*
+ * Standalone fuzz driver
+ * ----------------------
+ * Runs a libFuzzer-style harness without libFuzzer, for compilers that do not
+ * ship it. It accepts a subset of the libFuzzer command line, so CTest and
+ * scripts do not care which one a harness was linked with:
+ *
+ *   <harness> [-runs=N] [-seed=S] [-max_len=N] FILE_OR_DIR...
+ *
+ * Every file given (directly or inside a directory) is run once. With -runs,
+ * N further inputs are generated by mutating the corpus: bit flips, random
+ * bytes, insertions, deletions, block copies, splices and protocol markers.
+ * The input being run when a harness crashes is written to crash-<pid>.
+ */
+
+#define _GNU_SOURCE
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ld2420_fuzz.h"
+
+#define DEFAULT_MAX_LEN 4096u
+
+typedef struct
+{
+    uint8_t *data;
+    size_t size;
+} input_t;
+
+static input_t *corpus;
+static size_t corpus_count;
+static size_t corpus_capacity;
+
+/** The input currently inside the harness, dumped by the crash handler. */
+static const uint8_t *current_data;
+static size_t current_size;
+
+static void dump_current_input(void)
+{
+    char path[32];
+    snprintf(path, sizeof(path), "crash-%ld", (long)getpid());
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return;
+    size_t done = 0;
+    while (done < current_size)
+    {
+        ssize_t n = write(fd, current_data + done, current_size - done);
+        if (n <= 0)
+            break;
+        done += (size_t)n;
+    }
+    close(fd);
+    static const char msg[] = "fuzz: crashing input written to crash-<pid>\n";
+    (void)!write(STDERR_FILENO, msg, sizeof(msg) - 1);
+}
+
+static void on_fatal_signal(int sig)
+{
+    dump_current_input();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+/** Present when the harness runs under a sanitizer runtime. */
+extern void __sanitizer_set_death_callback(void (*callback)(void)) __attribute__((weak));
+
+static void add_input(const uint8_t *data, size_t size)
+{
+    if (corpus_count == corpus_capacity)
+    {
+        size_t capacity = corpus_capacity ? corpus_capacity * 2 : 64;
+        input_t *grown = realloc(corpus, capacity * sizeof(*grown));
+        if (grown == NULL)
+            return;
+        corpus = grown;
+        corpus_capacity = capacity;
+    }
+    uint8_t *copy = malloc(size ? size : 1);
+    if (copy == NULL)
+        return;
+    if (size > 0)
+        memcpy(copy, data, size);
+    corpus[corpus_count].data = copy;
+    corpus[corpus_count].size = size;
+    corpus_count++;
+}
+
+static int load_file(const char *path, size_t max_len)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        fprintf(stderr, "fuzz: cannot open %s\n", path);
+        return -1;
+    }
+    uint8_t *buffer = malloc(max_len ? max_len : 1);
+    size_t size = buffer ? fread(buffer, 1, max_len, f) : 0;
+    fclose(f);
+    if (buffer == NULL)
+        return -1;
+    add_input(buffer, size);
+    free(buffer);
+    return 0;
+}
+
+static int load_path(const char *path, size_t max_len)
+{
+    struct stat st;
+    if (stat(path, &st) != 0)
+    {
+        fprintf(stderr, "fuzz: cannot stat %s\n", path);
+        return -1;
+    }
+    if (!S_ISDIR(st.st_mode))
+        return load_file(path, max_len);
+
+    DIR *dir = opendir(path);
+    if (dir == NULL)
+        return -1;
+    int result = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] == '.')
+            continue;
+        char child[4096];
+        snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+        if (stat(child, &st) == 0 && S_ISREG(st.st_mode) && load_file(child, max_len) != 0)
+            result = -1;
+    }
+    closedir(dir);
+    return result;
+}
+
+static uint64_t rng_state;
+
+static uint32_t next_random(void)
+{
+    // xorshift64*
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (uint32_t)((rng_state * 2685821657736338717ull) >> 32);
+}
+
+static size_t random_below(size_t bound)
+{
+    return bound ? (size_t)next_random() % bound : 0;
+}
+
+/** Protocol markers inserted by the mutator so it reaches past the header checks. */
+static const uint8_t *const TOKENS[] = {
+    LD2420_BEG_COMMAND_PACKET,
+    LD2420_END_COMMAND_PACKET,
+};
+
+/** Apply 1 to 8 random mutations to buffer[0..size) in place; returns the new size. */
+static size_t mutate(uint8_t *buffer, size_t size, size_t max_len)
+{
+    size_t rounds = 1 + random_below(8);
+    for (size_t r = 0; r < rounds; r++)
+    {
+        switch (random_below(7))
+        {
+        case 0: // flip a bit
+            if (size > 0)
+                buffer[random_below(size)] ^= (uint8_t)(1u << random_below(8));
+            break;
+        case 1: // random byte
+            if (size > 0)
+                buffer[random_below(size)] = (uint8_t)next_random();
+            break;
+        case 2: // insert a random byte
+            if (size < max_len)
+            {
+                size_t at = random_below(size + 1);
+                memmove(&buffer[at + 1], &buffer[at], size - at);
+                buffer[at] = (uint8_t)next_random();
+                size++;
+            }
+            break;
+        case 3: // delete a block
+            if (size > 0)
+            {
+                size_t at = random_below(size);
+                size_t len = 1 + random_below(size - at);
+                memmove(&buffer[at], &buffer[at + len], size - at - len);
+                size -= len;
+            }
+            break;
+        case 4: // copy a block within the input
+            if (size > 0 && size < max_len)
+            {
+                size_t from = random_below(size);
+                size_t len = 1 + random_below(size - from);
+                if (len > max_len - size)
+                    len = max_len - size;
+                size_t at = random_below(size + 1);
+                uint8_t block[DEFAULT_MAX_LEN];
+                if (len > sizeof(block))
+                    len = sizeof(block);
+                memcpy(block, &buffer[from], len);
+                memmove(&buffer[at + len], &buffer[at], size - at);
+                memcpy(&buffer[at], block, len);
+                size += len;
+            }
+            break;
+        case 5: // splice with another corpus entry
+            if (corpus_count > 0)
+            {
+                const input_t *other = &corpus[random_below(corpus_count)];
+                size_t at = random_below(size + 1);
+                size_t len = other->size;
+                if (len > max_len - at)
+                    len = max_len - at;
+                memcpy(&buffer[at], other->data, len);
+                if (at + len > size)
+                    size = at + len;
+            }
+            break;
+        default: // insert a protocol marker
+            if (size + 4 <= max_len)
+            {
+                size_t at = random_below(size + 1);
+                memmove(&buffer[at + 4], &buffer[at], size - at);
+                memcpy(&buffer[at], TOKENS[random_below(2)], 4);
+                size += 4;
+            }
+            break;
+        }
+    }
+    return size;
+}
+
+static void run_one(const uint8_t *data, size_t size)
+{
+    current_data = data;
+    current_size = size;
+    LLVMFuzzerTestOneInput(data, size);
+    current_data = NULL;
+    current_size = 0;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long long runs = 0;
+    unsigned long long seed = 1;
+    size_t max_len = DEFAULT_MAX_LEN;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "-runs=", 6) == 0)
+            runs = strtoull(argv[i] + 6, NULL, 10);
+        else if (strncmp(argv[i], "-seed=", 6) == 0)
+            seed = strtoull(argv[i] + 6, NULL, 10);
+        else if (strncmp(argv[i], "-max_len=", 9) == 0)
+            max_len = strtoul(argv[i] + 9, NULL, 10);
+        else if (argv[i][0] == '-')
+            fprintf(stderr, "fuzz: ignoring unsupported flag %s\n", argv[i]);
+    }
+    if (max_len == 0 || max_len > DEFAULT_MAX_LEN)
+        max_len = DEFAULT_MAX_LEN;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (argv[i][0] != '-' && load_path(argv[i], max_len) != 0)
+            return 1;
+    }
+
+    signal(SIGABRT, on_fatal_signal);
+    signal(SIGSEGV, on_fatal_signal);
+    signal(SIGBUS, on_fatal_signal);
+    if (__sanitizer_set_death_callback)
+        __sanitizer_set_death_callback(dump_current_input);
+
+    for (size_t i = 0; i < corpus_count; i++)
+        run_one(corpus[i].data, corpus[i].size);
+    printf("fuzz: replayed %zu inputs\n", corpus_count);
+
+    rng_state = seed ? seed : 1;
+    uint8_t *buffer = malloc(max_len);
+    if (buffer == NULL)
+        return 1;
+    for (unsigned long long r = 0; r < runs; r++)
+    {
+        size_t size = 0;
+        if (corpus_count > 0)
+        {
+            const input_t *base = &corpus[random_below(corpus_count)];
+            size = base->size < max_len ? base->size : max_len;
+            memcpy(buffer, base->data, size);
+        }
+        size = mutate(buffer, size, max_len);
+
+        // Mutated inputs run from an exact-size copy so overreads are visible.
+        uint8_t *exact = malloc(size ? size : 1);
+        if (exact == NULL)
+            break;
+        memcpy(exact, buffer, size);
+        run_one(exact, size);
+        free(exact);
+    }
+    if (runs > 0)
+        printf("fuzz: ran %llu mutated inputs (seed %llu)\n", runs, seed);
+
+    free(buffer);
+    for (size_t i = 0; i < corpus_count; i++)
+        free(corpus[i].data);
+    free(corpus);
+    return 0;
+}
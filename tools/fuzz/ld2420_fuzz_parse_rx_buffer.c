@@ -0,0 +1,91 @@
+/*
+ * Fuzz target for ld2420_parse_rx_buffer()
+ * ----------------------------------------
+ * - The input is copied into a buffer of exactly its size, so any read past
+ *   the end is caught by AddressSanitizer
+ * - The work done for one call must stay within the per-byte budget
+ * - Every buffer the one-shot parser accepts must also come out of the
+ *   streaming parser as exactly one frame with the same metadata, unless the
+ *   streaming parser rejects its length for the echoed command (then it emits
+ *   nothing) or a header inside it starts a candidate frame that may win
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/ld2420_stream.h>
+
+#include "ld2420_fuzz.h"
+
+static int stream_frames;
+static uint16_t stream_size;
+static uint16_t stream_cmd_echo;
+static uint16_t stream_status;
+
+static bool on_frame(
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    (void)frame;
+    stream_frames++;
+    stream_size = frame_size_bytes;
+    stream_cmd_echo = cmd_echo;
+    stream_status = status;
+    return true;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    // The one-shot API takes an 8-bit size; longer inputs cannot be expressed.
+    if (size > UINT8_MAX)
+        size = UINT8_MAX;
+
+    uint8_t *buffer = malloc(size ? size : 1);
+    if (buffer == NULL)
+        return 0;
+    if (size > 0)
+        memcpy(buffer, data, size);
+
+    uint16_t frame_size = 0, cmd_echo = 0, status = 0, param_name = 0, param_value = 0;
+    ld2420_work_bytes_examined = 0;
+    ld2420_status_t result = ld2420_parse_rx_buffer(
+        buffer, (uint8_t)size, &frame_size, &cmd_echo, &status, &param_name, &param_value);
+    uint64_t work = ld2420_work_bytes_examined;
+    LD2420_FUZZ_ASSERT(work <= ld2420_fuzz_work_budget(size),
+                       "%llu bytes examined for a %zu byte input",
+                       (unsigned long long)work, size);
+
+    bool inner_header = false;
+    for (size_t i = 1; i + sizeof(LD2420_BEG_COMMAND_PACKET) <= size && !inner_header; i++)
+        inner_header = memcmp(&buffer[i], LD2420_BEG_COMMAND_PACKET, sizeof(LD2420_BEG_COMMAND_PACKET)) == 0;
+
+    if (result == LD2420_STATUS_OK && !inner_header)
+    {
+        stream_frames = 0;
+        ld2420_stream_t s;
+        ld2420_stream_init(&s);
+        ld2420_stream_feed_bytes(&s, buffer, size, on_frame, NULL);
+
+        // The one-shot parser reports only the low byte of the echo
+        const uint16_t echo = ld2420_protocol_read_le16(&buffer[LD2420_ACK_CMD_ECHO_OFFSET]);
+        if ((echo & 0xFF00u) != LD2420_PROTOCOL_ACK_ECHO_FLAG ||
+            !ld2420_protocol_ack_length_valid((uint8_t)echo, frame_size))
+        {
+            LD2420_FUZZ_ASSERT(stream_frames == 0, "stream emitted %d frames of implausible size or echo", stream_frames);
+            free(buffer);
+            return 0;
+        }
+        LD2420_FUZZ_ASSERT(stream_frames == 1, "stream emitted %d frames", stream_frames);
+        LD2420_FUZZ_ASSERT(stream_size == size, "stream frame is %u bytes, not %zu",
+                           stream_size, size);
+        LD2420_FUZZ_ASSERT(stream_cmd_echo == cmd_echo && stream_status == status,
+                           "stream echo/status 0x%04X/0x%04X, one-shot 0x%04X/0x%04X",
+                           stream_cmd_echo, stream_status, cmd_echo, status);
+    }
+
+    free(buffer);
+    return 0;
+}
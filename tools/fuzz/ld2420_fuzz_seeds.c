@@ -0,0 +1,196 @@
+/*
+ * Seed corpus generator for the LD2420 fuzz harnesses
+ * ---------------------------------------------------
+ * Writes one file per seed into the given directory. The seeds are built from
+ * the protocol description in the root README: an acknowledgement for every
+ * command, plus the framing situations a serial line produces (noise, split
+ * and repeated headers, truncation, corrupted footers, bad length fields).
+ *
+ * Usage: ld2420_fuzz_seeds OUTPUT_DIR
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <ld2420/ld2420.h>
+
+#define MAX_SEED_SIZE 1024u
+
+typedef struct
+{
+    uint8_t data[MAX_SEED_SIZE];
+    size_t size;
+} seed_t;
+
+static const char *output_dir;
+static int written;
+
+static void append(seed_t *s, const uint8_t *data, size_t size)
+{
+    if (s->size + size > sizeof(s->data))
+        size = sizeof(s->data) - s->size;
+    if (size == 0)
+        return;
+    memcpy(&s->data[s->size], data, size);
+    s->size += size;
+}
+
+static void append_le16(seed_t *s, uint16_t value)
+{
+    const uint8_t bytes[2] = {(uint8_t)(value & 0xFF), (uint8_t)(value >> 8)};
+    append(s, bytes, sizeof(bytes));
+}
+
+/**
+ * Append an acknowledgement frame: header, length, command echo (command with
+ * the 0x0100 ACK bit), status, payload and footer.
+ */
+static void append_ack(seed_t *s, uint8_t command, uint16_t status, const uint8_t *payload, size_t payload_size)
+{
+    append(s, LD2420_BEG_COMMAND_PACKET, sizeof(LD2420_BEG_COMMAND_PACKET));
+    append_le16(s, (uint16_t)(4 + payload_size));
+    append_le16(s, (uint16_t)(0x0100 | command));
+    append_le16(s, status);
+    append(s, payload, payload_size);
+    append(s, LD2420_END_COMMAND_PACKET, sizeof(LD2420_END_COMMAND_PACKET));
+}
+
+static int write_seed(const char *name, const seed_t *s)
+{
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%s", output_dir, name);
+    FILE *f = fopen(path, "wb");
+    if (f == NULL || fwrite(s->data, 1, s->size, f) != s->size)
+    {
+        fprintf(stderr, "ERROR: cannot write %s\n", path);
+        if (f)
+            fclose(f);
+        return 1;
+    }
+    fclose(f);
+    written++;
+    return 0;
+}
+
+/** Acknowledgement payloads for every command in ld2420_command_t. */
+static const uint8_t OPEN_CONFIG_PAYLOAD[] = {0x02, 0x00, 0x20, 0x00};
+static const uint8_t READ_VERSION_PAYLOAD[] = {0x06, 0x00, 'v', '1', '.', '5', '.', '3'};
+static const uint8_t READ_CONFIG_PAYLOAD[] = {0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x00, 0x00};
+
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s OUTPUT_DIR\n", argv[0]);
+        return 2;
+    }
+    output_dir = argv[1];
+    if (mkdir(output_dir, 0755) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr, "ERROR: cannot create %s\n", output_dir);
+        return 1;
+    }
+
+    int failures = 0;
+    seed_t s;
+
+    // One acknowledgement per command
+    struct
+    {
+        const char *name;
+        uint8_t command;
+        const uint8_t *payload;
+        size_t payload_size;
+    } acks[] = {
+        {"ack_open_config", LD2420_CMD_OPEN_CONFIG_MODE, OPEN_CONFIG_PAYLOAD, sizeof(OPEN_CONFIG_PAYLOAD)},
+        {"ack_close_config", LD2420_CMD_CLOSE_CONFIG_MODE, NULL, 0},
+        {"ack_read_version", LD2420_CMD_READ_VERSION_NUMBER, READ_VERSION_PAYLOAD, sizeof(READ_VERSION_PAYLOAD)},
+        {"ack_reboot", LD2420_CMD_REBOOT, NULL, 0},
+        {"ack_read_config", LD2420_CMD_READ_CONFIG, READ_CONFIG_PAYLOAD, sizeof(READ_CONFIG_PAYLOAD)},
+        {"ack_set_config", LD2420_CMD_SET_CONFIG, NULL, 0},
+    };
+    for (size_t i = 0; i < sizeof(acks) / sizeof(acks[0]); i++)
+    {
+        s.size = 0;
+        append_ack(&s, acks[i].command, 0, acks[i].payload, acks[i].payload_size);
+        failures += write_seed(acks[i].name, &s);
+    }
+
+    // Failed command (non-zero status)
+    s.size = 0;
+    append_ack(&s, LD2420_CMD_SET_CONFIG, 1, NULL, 0);
+    failures += write_seed("ack_set_config_failed", &s);
+
+    // Largest frame the parsers accept
+    static uint8_t large_payload[LD2420_MAX_RX_PACKET_SIZE - LD2420_MIN_RX_PACKET_SIZE];
+    for (size_t i = 0; i < sizeof(large_payload); i++)
+        large_payload[i] = (uint8_t)i;
+    s.size = 0;
+    append_ack(&s, LD2420_CMD_READ_CONFIG, 0, large_payload, sizeof(large_payload));
+    failures += write_seed("ack_max_size", &s);
+
+    // Back-to-back frames, as in a configuration session
+    s.size = 0;
+    append_ack(&s, LD2420_CMD_OPEN_CONFIG_MODE, 0, OPEN_CONFIG_PAYLOAD, sizeof(OPEN_CONFIG_PAYLOAD));
+    append_ack(&s, LD2420_CMD_READ_CONFIG, 0, READ_CONFIG_PAYLOAD, sizeof(READ_CONFIG_PAYLOAD));
+    append_ack(&s, LD2420_CMD_CLOSE_CONFIG_MODE, 0, NULL, 0);
+    failures += write_seed("session", &s);
+
+    // Line noise and a partial header before a frame
+    static const uint8_t NOISE[] = {0x00, 0xFF, 0x55, 0xAA, 0xFD, 0xFC, 0xFB, 0x13, 0xFD};
+    s.size = 0;
+    append(&s, NOISE, sizeof(NOISE));
+    append_ack(&s, LD2420_CMD_OPEN_CONFIG_MODE, 0, OPEN_CONFIG_PAYLOAD, sizeof(OPEN_CONFIG_PAYLOAD));
+    failures += write_seed("noise_then_frame", &s);
+
+    // Truncated frame followed by a complete one
+    s.size = 0;
+    append_ack(&s, LD2420_CMD_READ_CONFIG, 0, READ_CONFIG_PAYLOAD, sizeof(READ_CONFIG_PAYLOAD));
+    s.size -= 7;
+    append_ack(&s, LD2420_CMD_CLOSE_CONFIG_MODE, 0, NULL, 0);
+    failures += write_seed("truncated_then_frame", &s);
+
+    // Corrupted footer followed by a complete frame
+    s.size = 0;
+    append_ack(&s, LD2420_CMD_OPEN_CONFIG_MODE, 0, OPEN_CONFIG_PAYLOAD, sizeof(OPEN_CONFIG_PAYLOAD));
+    s.data[s.size - 1] ^= 0xFF;
+    append_ack(&s, LD2420_CMD_CLOSE_CONFIG_MODE, 0, NULL, 0);
+    failures += write_seed("bad_footer_then_frame", &s);
+
+    // Length fields: zero, too small for echo+status, beyond the buffer, 16-bit maximum
+    static const uint16_t LENGTHS[] = {0x0000, 0x0002, 0x0100, 0xFFFF};
+    static const char *const LENGTH_NAMES[] = {"len_zero", "len_short", "len_wraps_8bit", "len_max"};
+    for (size_t i = 0; i < sizeof(LENGTHS) / sizeof(LENGTHS[0]); i++)
+    {
+        s.size = 0;
+        append(&s, LD2420_BEG_COMMAND_PACKET, sizeof(LD2420_BEG_COMMAND_PACKET));
+        append_le16(&s, LENGTHS[i]);
+        append(&s, OPEN_CONFIG_PAYLOAD, sizeof(OPEN_CONFIG_PAYLOAD));
+        append(&s, LD2420_END_COMMAND_PACKET, sizeof(LD2420_END_COMMAND_PACKET));
+        append_ack(&s, LD2420_CMD_CLOSE_CONFIG_MODE, 0, NULL, 0);
+        failures += write_seed(LENGTH_NAMES[i], &s);
+    }
+
+    // Headers repeated inside a frame that never completes
+    s.size = 0;
+    append(&s, LD2420_BEG_COMMAND_PACKET, sizeof(LD2420_BEG_COMMAND_PACKET));
+    append_le16(&s, LD2420_MAX_RX_PACKET_SIZE - 10);
+    while (s.size + sizeof(LD2420_BEG_COMMAND_PACKET) <= LD2420_MAX_RX_PACKET_SIZE * 2)
+        append(&s, LD2420_BEG_COMMAND_PACKET, sizeof(LD2420_BEG_COMMAND_PACKET));
+    failures += write_seed("repeated_headers", &s);
+
+    // Header split by the end of a frame's payload
+    s.size = 0;
+    static const uint8_t SPLIT_PAYLOAD[] = {0x00, 0x00, 0xFD, 0xFC, 0xFB, 0xFA};
+    append_ack(&s, LD2420_CMD_READ_CONFIG, 0, SPLIT_PAYLOAD, sizeof(SPLIT_PAYLOAD));
+    append_ack(&s, LD2420_CMD_CLOSE_CONFIG_MODE, 0, NULL, 0);
+    failures += write_seed("header_in_payload", &s);
+
+    s.size = 0;
+    failures += write_seed("empty", &s);
+
+    printf("wrote %d seeds to %s\n", written, output_dir);
+    return failures == 0 ? 0 : 1;
+}
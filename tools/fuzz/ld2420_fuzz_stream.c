@@ -0,0 +1,130 @@
+/*
+ * Fuzz target for the streaming parser
+ * ------------------------------------
+ * The input is fed three ways:
+ * - single-shot: one ld2420_stream_feed_bytes() call with the whole input
+ * - byte-wise: one ld2420_stream_feed() call per byte
+ * - chunked: ld2420_stream_feed_bytes() with chunk sizes derived from the input
+ *
+ * All three must emit identical frame sequences, and the single-shot feed must
+ * stay within the per-byte work budget.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <ld2420/ld2420_stream.h>
+
+#include "ld2420_fuzz.h"
+
+/** Frames recorded per feeding strategy; inputs cannot hold more than size / 10. */
+#define MAX_RECORDED_FRAMES 4096u
+
+typedef struct
+{
+    uint16_t size;
+    uint16_t cmd_echo;
+    uint16_t status;
+    uint32_t digest;
+} frame_record_t;
+
+typedef struct
+{
+    frame_record_t frames[MAX_RECORDED_FRAMES];
+    size_t count;
+} frame_log_t;
+
+static frame_log_t logs[3];
+static frame_log_t *recording;
+
+/** FNV-1a over the frame bytes. */
+static uint32_t digest(const uint8_t *data, size_t size)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < size; i++)
+        h = (h ^ data[i]) * 16777619u;
+    return h;
+}
+
+static bool on_frame(
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    if (recording->count < MAX_RECORDED_FRAMES)
+    {
+        frame_record_t *r = &recording->frames[recording->count];
+        r->size = frame_size_bytes;
+        r->cmd_echo = cmd_echo;
+        r->status = status;
+        r->digest = digest(frame, frame_size_bytes);
+    }
+    recording->count++;
+    return true;
+}
+
+static void compare_logs(const frame_log_t *expected, const frame_log_t *actual, const char *strategy)
+{
+    LD2420_FUZZ_ASSERT(expected->count == actual->count,
+                       "%s feeding emitted %zu frames, single-shot %zu",
+                       strategy, actual->count, expected->count);
+
+    size_t recorded = expected->count < MAX_RECORDED_FRAMES ? expected->count : MAX_RECORDED_FRAMES;
+    for (size_t i = 0; i < recorded; i++)
+    {
+        const frame_record_t *e = &expected->frames[i];
+        const frame_record_t *a = &actual->frames[i];
+        LD2420_FUZZ_ASSERT(memcmp(e, a, sizeof(*e)) == 0,
+                           "%s feeding differs at frame %zu (%u bytes vs %u)",
+                           strategy, i, a->size, e->size);
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    ld2420_stream_t s;
+
+    // Single-shot
+    recording = &logs[0];
+    recording->count = 0;
+    ld2420_stream_init(&s);
+    ld2420_work_bytes_examined = 0;
+    ld2420_stream_feed_bytes(&s, data, size, on_frame, NULL);
+    uint64_t work = ld2420_work_bytes_examined;
+    LD2420_FUZZ_ASSERT(work <= ld2420_fuzz_work_budget(size),
+                       "%llu bytes examined for a %zu byte input (%.1f per byte)",
+                       (unsigned long long)work, size, size ? (double)work / (double)size : 0.0);
+
+    // Byte-wise
+    recording = &logs[1];
+    recording->count = 0;
+    ld2420_stream_init(&s);
+    for (size_t i = 0; i < size; i++)
+        ld2420_stream_feed(&s, &data[i], 1, on_frame);
+    compare_logs(&logs[0], &logs[1], "byte-wise");
+
+    // Chunked, with chunk sizes 1..64 from a generator seeded by the input
+    recording = &logs[2];
+    recording->count = 0;
+    ld2420_stream_init(&s);
+    uint32_t rng = digest(data, size) | 1u;
+    size_t offset = 0;
+    while (offset < size)
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        size_t chunk = 1u + (rng % 64u);
+        if (chunk > size - offset)
+            chunk = size - offset;
+
+        size_t consumed = 0;
+        ld2420_stream_feed_bytes(&s, &data[offset], chunk, on_frame, &consumed);
+        LD2420_FUZZ_ASSERT(consumed == chunk, "consumed %zu of %zu bytes", consumed, chunk);
+        offset += chunk;
+    }
+    compare_logs(&logs[0], &logs[2], "chunked");
+
+    return 0;
+}
@@ -0,0 +1,664 @@
+/*
+ * LD2420 handover check
+ * ---------------------
+ * Verifies that ingest ports move between processes without losing,
+ * duplicating or reordering a frame, and measures how long no process is
+ * reading them.
+ *
+ * - A writer process plays `--ports` sensors on pipes. Every frame carries a
+ *   per-port sequence number and is written in random pieces, so most ports
+ *   hold a partial frame at any moment.
+ * - Generation 0 (this process) ingests the pipes. After its share of the
+ *   frames it hands every port to generation 1 with
+ *   ld2420_linux_ingest_handover_send(); generation 1 is a fresh exec of this
+ *   binary that was started beforehand and waits in
+ *   ld2420_linux_ingest_handover_receive(). This repeats `--handovers` times;
+ *   the last generation reads until the writer closes the pipes.
+ * - Each generation reports the first and last sequence number it saw per
+ *   port. The ranges must chain without gaps or overlaps and cover every
+ *   frame written.
+ *
+ * Downtime is measured from the moment the old generation stops reading to
+ * the moment the new one has attached the ports.
+ *
+ * Before the chain, a declined handover is checked: a relay drops the
+ * descriptor of the second port on its way, so the receiver fails there. The
+ * sender must still own both ports and finish the frames they were holding.
+ *
+ * Usage: ld2420_handover_check [--ports N] [--frames N] [--handovers N]
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include <ld2420/ld2420.h>
+#include <ld2420/platform/linux/ld2420_linux.h>
+
+/** Ports are bounded so that one generation's result fits in an atomic pipe write. */
+#define CHECK_MAX_PORTS 256u
+
+/** OPEN_CONFIG acknowledgement; the protocol version word carries the sequence number. */
+#define CHECK_FRAME_SIZE 18u
+#define CHECK_SEQ_OFFSET 10u
+
+#define NO_SEQUENCE UINT32_MAX
+
+typedef struct
+{
+    uint32_t ports;
+    uint32_t frames;
+    uint32_t handovers;
+} check_options_t;
+
+/** Result of one generation, written to the result pipe in one piece. */
+typedef struct
+{
+    uint32_t generation;
+    uint32_t out_of_order;
+    uint32_t partial_at_handover;
+    uint32_t reserved;
+    uint64_t frames;
+    int64_t downtime_ns;
+    uint32_t first_seq[CHECK_MAX_PORTS];
+    uint32_t last_seq[CHECK_MAX_PORTS];
+} generation_result_t;
+
+static generation_result_t result;
+static ld2420_linux_ingest_t ingest;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void on_frame(
+    void *user,
+    uint16_t port_index,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    (void)user;
+    (void)cmd_echo;
+    (void)status;
+    if (frame_size_bytes != CHECK_FRAME_SIZE || port_index >= CHECK_MAX_PORTS)
+    {
+        result.out_of_order++;
+        return;
+    }
+
+    const uint32_t seq = (uint32_t)frame[CHECK_SEQ_OFFSET] | ((uint32_t)frame[CHECK_SEQ_OFFSET + 1] << 8);
+    if (result.first_seq[port_index] == NO_SEQUENCE)
+        result.first_seq[port_index] = seq;
+    else if (seq != ((result.last_seq[port_index] + 1) & 0xFFFFu))
+        result.out_of_order++;
+    result.last_seq[port_index] = seq;
+    result.frames++;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Writer                                                                    */
+/* ------------------------------------------------------------------------- */
+
+static uint32_t next_random(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static void write_all(int fd, const uint8_t *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t n = write(fd, data, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            _exit(1);
+        data += n;
+        size -= (size_t)n;
+    }
+}
+
+/** Write every frame to every port, round-robin, in random pieces. */
+static void run_writer(const check_options_t *o, const int *write_fds)
+{
+    uint8_t frame[CHECK_FRAME_SIZE] = {
+        0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01,
+        0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x04, 0x03, 0x02, 0x01};
+    uint32_t rng = 0x2420u;
+
+    // Where each port is inside its current frame
+    static uint8_t offset[CHECK_MAX_PORTS];
+    static uint32_t seq[CHECK_MAX_PORTS];
+    uint32_t done = 0;
+    while (done < o->ports)
+    {
+        done = 0;
+        for (uint32_t p = 0; p < o->ports; p++)
+        {
+            if (seq[p] >= o->frames)
+            {
+                done++;
+                continue;
+            }
+            frame[CHECK_SEQ_OFFSET] = (uint8_t)seq[p];
+            frame[CHECK_SEQ_OFFSET + 1] = (uint8_t)(seq[p] >> 8);
+            size_t piece = 1u + next_random(&rng) % 12u;
+            if (piece > CHECK_FRAME_SIZE - offset[p])
+                piece = CHECK_FRAME_SIZE - offset[p];
+            write_all(write_fds[p], &frame[offset[p]], piece);
+            offset[p] = (uint8_t)(offset[p] + piece);
+            if (offset[p] == CHECK_FRAME_SIZE)
+            {
+                offset[p] = 0;
+                seq[p]++;
+            }
+        }
+    }
+    for (uint32_t p = 0; p < o->ports; p++)
+        close(write_fds[p]);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Generations                                                               */
+/* ------------------------------------------------------------------------- */
+
+/** Start the next generation, connected through the returned socket. */
+static pid_t spawn_generation(const check_options_t *o, uint32_t generation, int result_fd, int *out_sock)
+{
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) != 0)
+    {
+        perror("socketpair");
+        exit(1);
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        exit(1);
+    }
+    if (pid == 0)
+    {
+        fcntl(sv[1], F_SETFD, 0);
+        char args[6][16];
+        snprintf(args[0], sizeof(args[0]), "%" PRIu32, o->ports);
+        snprintf(args[1], sizeof(args[1]), "%" PRIu32, o->frames);
+        snprintf(args[2], sizeof(args[2]), "%" PRIu32, o->handovers);
+        snprintf(args[3], sizeof(args[3]), "%" PRIu32, generation);
+        snprintf(args[4], sizeof(args[4]), "%d", sv[1]);
+        snprintf(args[5], sizeof(args[5]), "%d", result_fd);
+        execl("/proc/self/exe", "ld2420_handover_check", "--ports", args[0], "--frames", args[1],
+              "--handovers", args[2], "--generation", args[3], "--sock", args[4], "--result", args[5],
+              (char *)NULL);
+        perror("exec");
+        _exit(127);
+    }
+
+    close(sv[1]);
+    *out_sock = sv[0];
+    return pid;
+}
+
+/**
+ * Ingest until this generation's share is done, then hand over (or, for the
+ * last generation, until every port hung up). Returns the exit status.
+ */
+static int run_generation(const check_options_t *o, uint32_t generation, int result_fd)
+{
+    const uint64_t share = (uint64_t)o->ports * o->frames / (o->handovers + 1u);
+    int sock = -1;
+    pid_t child = -1;
+    bool child_ready = false;
+    if (generation < o->handovers)
+        child = spawn_generation(o, generation + 1u, result_fd, &sock);
+
+    for (;;)
+    {
+        if (generation == o->handovers)
+        {
+            if (ingest.port_count == 0)
+                break;
+        }
+        else if (result.frames >= share && child_ready)
+        {
+            break;
+        }
+
+        if (ld2420_linux_ingest_poll(&ingest, 10) < 0)
+        {
+            perror("epoll_wait");
+            return 1;
+        }
+        if (!child_ready && sock >= 0)
+        {
+            uint8_t ready;
+            child_ready = recv(sock, &ready, 1, MSG_DONTWAIT) == 1;
+        }
+    }
+
+    int status = 0;
+    if (child >= 0)
+    {
+        for (uint16_t p = 0; p < ingest.port_count; p++)
+            if (ingest.ports[p].fd >= 0 && ingest.ports[p].stream.index > 0)
+                result.partial_at_handover++;
+
+        // Stop reading; the new generation's clock starts here
+        const uint64_t stopped = now_ns();
+        if (ld2420_linux_ingest_handover_send(&ingest, sock) != LD2420_STATUS_OK ||
+            send(sock, &stopped, sizeof(stopped), MSG_NOSIGNAL) != (ssize_t)sizeof(stopped))
+        {
+            perror("handover send");
+            status = 1;
+        }
+        close(sock);
+    }
+
+    if (write(result_fd, &result, sizeof(result)) != (ssize_t)sizeof(result))
+        status = 1;
+    close(result_fd);
+
+    if (child >= 0)
+    {
+        int child_status = 0;
+        if (waitpid(child, &child_status, 0) < 0 || !WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0)
+            status = 1;
+    }
+    return status;
+}
+
+/** Entry point of generations 1..N: receive the ports, then ingest. */
+static int resume_generation(const check_options_t *o, uint32_t generation, int sock, int result_fd)
+{
+    const uint8_t ready = 1;
+    if (send(sock, &ready, 1, MSG_NOSIGNAL) != 1 ||
+        ld2420_linux_ingest_handover_receive(&ingest, sock) != LD2420_STATUS_OK)
+    {
+        perror("handover receive");
+        return 1;
+    }
+    const uint64_t resumed = now_ns();
+
+    uint64_t stopped = 0;
+    if (recv(sock, &stopped, sizeof(stopped), 0) != (ssize_t)sizeof(stopped))
+    {
+        perror("handover timestamp");
+        return 1;
+    }
+    close(sock);
+    result.downtime_ns = (int64_t)(resumed - stopped);
+    return run_generation(o, generation, result_fd);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Declined handover                                                         */
+/* ------------------------------------------------------------------------- */
+
+static void count_frame(
+    void *user,
+    uint16_t port_index,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    (void)frame;
+    (void)cmd_echo;
+    (void)status;
+    uint32_t *counts = user;
+    if (port_index < 2 && frame_size_bytes == CHECK_FRAME_SIZE)
+        counts[port_index]++;
+}
+
+/** Pass one message from one socket to another, dropping its descriptor if asked. */
+static ssize_t relay_message(int from, int to, bool drop_fd)
+{
+    uint8_t buf[4096];
+    struct iovec iov = {.iov_base = buf, .iov_len = sizeof(buf)};
+    union
+    {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    struct msghdr mh = {0};
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+    mh.msg_control = control.buf;
+    mh.msg_controllen = sizeof(control.buf);
+    ssize_t n = recvmsg(from, &mh, MSG_CMSG_CLOEXEC);
+    if (n <= 0)
+        return n;
+
+    int fd = -1;
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&mh);
+    if (cmsg != NULL && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+        memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+    if (fd < 0 || drop_fd)
+    {
+        mh.msg_control = NULL;
+        mh.msg_controllen = 0;
+    }
+    iov.iov_len = (size_t)n;
+    sendmsg(to, &mh, MSG_NOSIGNAL);
+    if (fd >= 0)
+        close(fd);
+    return n;
+}
+
+/**
+ * Hand two ports, each holding half a frame, to a receiver that fails on the
+ * second one. Returns the number of failures.
+ */
+static int check_declined_handover(void)
+{
+    static ld2420_linux_ingest_t sender;
+    uint32_t counts[2] = {0, 0};
+    const uint8_t frame[CHECK_FRAME_SIZE] = {
+        0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01,
+        0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x04, 0x03, 0x02, 0x01};
+    int write_fds[2];
+    int to_relay[2], to_receiver[2];
+    if (ld2420_linux_ingest_init(&sender, count_frame, counts) != LD2420_STATUS_OK ||
+        socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, to_relay) != 0 ||
+        socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, to_receiver) != 0)
+    {
+        perror("declined handover setup");
+        return 1;
+    }
+    for (int p = 0; p < 2; p++)
+    {
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC | O_NONBLOCK) != 0 || ld2420_linux_ingest_add(&sender, fds[0], NULL) != LD2420_STATUS_OK)
+        {
+            perror("declined handover setup");
+            return 1;
+        }
+        write_fds[p] = fds[1];
+        write_all(write_fds[p], frame, CHECK_FRAME_SIZE / 2);
+    }
+    while (sender.ports[0].stream.index == 0 || sender.ports[1].stream.index == 0)
+        ld2420_linux_ingest_poll(&sender, 10);
+
+    pid_t receiver = fork();
+    if (receiver == 0)
+    {
+        close(to_relay[0]);
+        close(to_relay[1]);
+        close(to_receiver[0]);
+        // The sender's epoll instance is shared with this process; leave it alone
+        static ld2420_linux_ingest_t taker;
+        if (ld2420_linux_ingest_init(&taker, count_frame, NULL) != LD2420_STATUS_OK)
+            _exit(1);
+        const bool declined = ld2420_linux_ingest_handover_receive(&taker, to_receiver[1]) != LD2420_STATUS_OK;
+        _exit(declined && taker.port_count == 0 ? 0 : 1);
+    }
+    pid_t relay = fork();
+    if (relay == 0)
+    {
+        close(to_relay[0]);
+        close(to_receiver[1]);
+        // Two ports and the end marker forward, then the replies back
+        for (int m = 0; m < 3; m++)
+            if (relay_message(to_relay[1], to_receiver[0], m == 1) <= 0)
+                _exit(1);
+        while (relay_message(to_receiver[0], to_relay[1], false) > 0)
+            ;
+        _exit(0);
+    }
+    close(to_relay[1]);
+    close(to_receiver[0]);
+    close(to_receiver[1]);
+    if (receiver < 0 || relay < 0)
+    {
+        perror("fork");
+        return 1;
+    }
+
+    int failures = 0;
+    if (ld2420_linux_ingest_handover_send(&sender, to_relay[0]) == LD2420_STATUS_OK)
+    {
+        fprintf(stderr, "FAIL: declined handover: sender released its ports\n");
+        failures++;
+    }
+    close(to_relay[0]);
+    if (sender.port_count != 2 || sender.ports[0].fd < 0 || sender.ports[1].fd < 0)
+    {
+        fprintf(stderr, "FAIL: declined handover: sender lost its ports\n");
+        failures++;
+    }
+
+    // Both ports must still be polled and finish the frames they were holding
+    for (int p = 0; p < 2; p++)
+        write_all(write_fds[p], &frame[CHECK_FRAME_SIZE / 2], CHECK_FRAME_SIZE - CHECK_FRAME_SIZE / 2);
+    const uint64_t deadline = now_ns() + 1000000000ull;
+    while (failures == 0 && (counts[0] == 0 || counts[1] == 0) && now_ns() < deadline)
+        ld2420_linux_ingest_poll(&sender, 10);
+    if (failures == 0 && (counts[0] != 1 || counts[1] != 1))
+    {
+        fprintf(stderr, "FAIL: declined handover: %" PRIu32 " and %" PRIu32 " frames after it, expected 1 each\n",
+                counts[0], counts[1]);
+        failures++;
+    }
+
+    for (int p = 0; p < 2; p++)
+        close(write_fds[p]);
+    ld2420_linux_ingest_deinit(&sender);
+    const pid_t children[2] = {receiver, relay};
+    for (int c = 0; c < 2; c++)
+    {
+        int child_status = 0;
+        if (waitpid(children[c], &child_status, 0) < 0 || !WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0)
+        {
+            fprintf(stderr, "FAIL: declined handover: %s exited abnormally\n", c == 0 ? "receiver" : "relay");
+            failures++;
+        }
+    }
+    if (failures == 0)
+        printf("declined handover: sender kept both ports\n");
+    return failures;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Verification                                                              */
+/* ------------------------------------------------------------------------- */
+
+static int verify(const check_options_t *o, int result_read_fd)
+{
+    static generation_result_t results[64];
+    uint32_t count = 0;
+    generation_result_t r;
+    while (read(result_read_fd, &r, sizeof(r)) == (ssize_t)sizeof(r))
+    {
+        if (r.generation <= o->handovers)
+            results[r.generation] = r;
+        count++;
+    }
+    if (count != o->handovers + 1u)
+    {
+        fprintf(stderr, "FAIL: %" PRIu32 " of %" PRIu32 " generations reported\n", count, o->handovers + 1u);
+        return 1;
+    }
+
+    int failures = 0;
+    uint64_t total = 0;
+    int64_t max_downtime = 0;
+    for (uint32_t g = 0; g <= o->handovers; g++)
+    {
+        total += results[g].frames;
+        if (results[g].out_of_order != 0)
+        {
+            fprintf(stderr, "FAIL: generation %" PRIu32 ": %" PRIu32 " frames out of order\n", g, results[g].out_of_order);
+            failures++;
+        }
+        if (g > 0 && results[g].downtime_ns > max_downtime)
+            max_downtime = results[g].downtime_ns;
+        printf("generation %" PRIu32 ": %" PRIu64 " frames", g, results[g].frames);
+        if (g > 0)
+            printf(", resumed after %.1f us", (double)results[g].downtime_ns / 1000.0);
+        if (g < o->handovers)
+            printf(", %" PRIu32 " partial frames handed over", results[g].partial_at_handover);
+        putchar('\n');
+    }
+
+    // The per-port sequence ranges must chain across generations
+    for (uint32_t p = 0; p < o->ports; p++)
+    {
+        uint32_t expected = 0;
+        for (uint32_t g = 0; g <= o->handovers; g++)
+        {
+            if (results[g].first_seq[p] == NO_SEQUENCE)
+                continue;
+            if (results[g].first_seq[p] != (expected & 0xFFFFu))
+            {
+                fprintf(stderr, "FAIL: port %" PRIu32 ": generation %" PRIu32 " starts at %" PRIu32 ", expected %" PRIu32 "\n",
+                        p, g, results[g].first_seq[p], expected & 0xFFFFu);
+                failures++;
+            }
+            expected += ((results[g].last_seq[p] - results[g].first_seq[p]) & 0xFFFFu) + 1u;
+        }
+        if (expected != o->frames)
+        {
+            fprintf(stderr, "FAIL: port %" PRIu32 ": %" PRIu32 " of %" PRIu32 " frames\n", p, expected, o->frames);
+            failures++;
+        }
+    }
+
+    const uint64_t written = (uint64_t)o->ports * o->frames;
+    printf("%" PRIu64 " of %" PRIu64 " frames over %" PRIu32 " handovers, max downtime %.1f us\n",
+           total, written, o->handovers, (double)max_downtime / 1000.0);
+    if (failures != 0 || total != written)
+    {
+        fprintf(stderr, "FAIL\n");
+        return 1;
+    }
+    return 0;
+}
+
+static int usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [--ports N] [--frames N] [--handovers N]\n", argv0);
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    check_options_t o = {.ports = 16, .frames = 20000, .handovers = 3};
+    long generation = 0, sock = -1, result_fd = -1;
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 >= argc)
+            return usage(argv[0]);
+        const char *arg = argv[i];
+        long value = strtol(argv[++i], NULL, 0);
+        if (strcmp(arg, "--ports") == 0)
+            o.ports = (uint32_t)value;
+        else if (strcmp(arg, "--frames") == 0)
+            o.frames = (uint32_t)value;
+        else if (strcmp(arg, "--handovers") == 0)
+            o.handovers = (uint32_t)value;
+        else if (strcmp(arg, "--generation") == 0)
+            generation = value;
+        else if (strcmp(arg, "--sock") == 0)
+            sock = value;
+        else if (strcmp(arg, "--result") == 0)
+            result_fd = value;
+        else
+            return usage(argv[0]);
+    }
+    // The sequence number is 16 bits wide; 65536 frames would alias the first one
+    if (o.ports == 0 || o.ports > CHECK_MAX_PORTS || o.frames == 0 || o.frames > 0xFFFFu || o.handovers >= 64)
+        return usage(argv[0]);
+
+    result.generation = (uint32_t)generation;
+    for (uint32_t p = 0; p < CHECK_MAX_PORTS; p++)
+        result.first_seq[p] = NO_SEQUENCE;
+    if (ld2420_linux_ingest_init(&ingest, on_frame, NULL) != LD2420_STATUS_OK)
+    {
+        perror("ld2420_linux_ingest_init");
+        return 1;
+    }
+    if (generation > 0)
+        return resume_generation(&o, (uint32_t)generation, (int)sock, (int)result_fd);
+
+    // Generation 0: check a declined handover, then set up the pipes, the
+    // writer and the result channel
+    if (check_declined_handover() != 0)
+        return 1;
+
+    int results[2];
+    if (pipe(results) != 0)
+    {
+        perror("pipe");
+        return 1;
+    }
+    fcntl(results[0], F_SETFD, FD_CLOEXEC);
+
+    static int read_fds[CHECK_MAX_PORTS], write_fds[CHECK_MAX_PORTS];
+    for (uint32_t p = 0; p < o.ports; p++)
+    {
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC) != 0)
+        {
+            perror("pipe2");
+            return 1;
+        }
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        read_fds[p] = fds[0];
+        write_fds[p] = fds[1];
+    }
+
+    pid_t writer = fork();
+    if (writer < 0)
+    {
+        perror("fork");
+        return 1;
+    }
+    if (writer == 0)
+    {
+        close(results[0]);
+        close(results[1]);
+        for (uint32_t p = 0; p < o.ports; p++)
+            close(read_fds[p]);
+        run_writer(&o, write_fds);
+        _exit(0);
+    }
+    for (uint32_t p = 0; p < o.ports; p++)
+    {
+        close(write_fds[p]);
+        if (ld2420_linux_ingest_add(&ingest, read_fds[p], NULL) != LD2420_STATUS_OK)
+        {
+            perror("ld2420_linux_ingest_add");
+            return 1;
+        }
+    }
+
+    int status = run_generation(&o, 0, results[1]);
+    int writer_status = 0;
+    if (waitpid(writer, &writer_status, 0) < 0 || !WIFEXITED(writer_status) || WEXITSTATUS(writer_status) != 0)
+    {
+        fprintf(stderr, "FAIL: writer exited abnormally\n");
+        status = 1;
+    }
+    if (verify(&o, results[0]) != 0)
+        status = 1;
+    return status;
+}
@@ -0,0 +1,339 @@
+/*
+ * LD2420 hot plug check
+ * ---------------------
+ * Verifies that ports come and go in a running ingest loop without
+ * disturbing the other sensors.
+ *
+ * - Emulated sensors are pty pairs. Each appears as a symlink "ttyLD<n>" to
+ *   its pty slave in a scratch directory that the ingest watches with
+ *   ld2420_linux_ingest_watch_devices(). Half of the `--ports` sensors exist
+ *   before the watch starts, the rest are plugged in afterwards.
+ * - Every round, each attached sensor writes one frame carrying a per-sensor
+ *   sequence number, and the loop polls until all of them arrived.
+ * - Every `--churn` rounds one sensor is unplugged and a new one is plugged
+ *   in. Unplugging alternates between closing the pty master, so the slave
+ *   hangs up as a USB adapter would, and ld2420_linux_ingest_remove().
+ *
+ * Every frame must arrive exactly once and in order, every plugged sensor
+ * must be attached, and every unplugged one released. The slowest round is
+ * reported as the longest time a frame waited.
+ *
+ * Usage: ld2420_hotplug_check [--ports N] [--rounds N] [--churn N]
+ */
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <ld2420/ld2420.h>
+#include <ld2420/platform/linux/ld2420_linux.h>
+
+/** OPEN_CONFIG acknowledgement; the protocol version word carries the sequence number. */
+#define CHECK_FRAME_SIZE 18u
+#define CHECK_SEQ_OFFSET 10u
+
+/** How long a round may take before the check gives up. */
+#define CHECK_ROUND_TIMEOUT_NS 5000000000ull
+
+#define NO_PORT UINT16_MAX
+#define NO_SENSOR UINT32_MAX
+
+typedef struct
+{
+    uint32_t ports;
+    uint32_t rounds;
+    uint32_t churn;
+} check_options_t;
+
+typedef struct
+{
+    int master_fd;        // -1 once unplugged
+    uint16_t port;        // Ingest port while attached, else NO_PORT
+    bool plugged;         // Symlink exists and the sensor writes frames once attached
+    bool released;        // Seen leaving the ingest after being unplugged
+    uint16_t next_write;  // Sequence number of the next frame written
+    uint16_t next_expect; // Sequence number of the next frame expected
+} sensor_t;
+
+static ld2420_linux_ingest_t ingest;
+static sensor_t *sensors;
+static uint32_t sensor_count;
+static uint32_t port_sensor[LD2420_LINUX_MAX_PORTS];
+static char scratch_dir[64];
+static uint64_t received, out_of_order, attaches, releases, removals;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void on_frame(
+    void *user,
+    uint16_t port_index,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    (void)user;
+    (void)cmd_echo;
+    (void)status;
+    const uint32_t s = port_sensor[port_index];
+    if (frame_size_bytes != CHECK_FRAME_SIZE || s == NO_SENSOR)
+    {
+        out_of_order++;
+        return;
+    }
+
+    const uint16_t seq = (uint16_t)(frame[CHECK_SEQ_OFFSET] | frame[CHECK_SEQ_OFFSET + 1] << 8);
+    if (seq != sensors[s].next_expect)
+        out_of_order++;
+    sensors[s].next_expect = (uint16_t)(seq + 1u);
+    received++;
+}
+
+static void on_port(void *user, uint16_t port_index, const char *path, bool attached)
+{
+    (void)user;
+    if (attached)
+    {
+        // The device path ends in "ttyLD<sensor>"
+        const char *name = strrchr(path, '/');
+        const uint32_t s = (uint32_t)strtoul(name + 1 + strlen("ttyLD"), NULL, 10);
+        if (s >= sensor_count || sensors[s].port != NO_PORT)
+        {
+            out_of_order++;
+            return;
+        }
+        sensors[s].port = port_index;
+        port_sensor[port_index] = s;
+        attaches++;
+        return;
+    }
+
+    const uint32_t s = port_sensor[port_index];
+    if (s != NO_SENSOR)
+    {
+        sensors[s].port = NO_PORT;
+        sensors[s].released = true;
+        port_sensor[port_index] = NO_SENSOR;
+    }
+    releases++;
+}
+
+static void link_path(uint32_t s, char *path, size_t size)
+{
+    snprintf(path, size, "%s/ttyLD%u", scratch_dir, s);
+}
+
+/** Create a pty pair for sensor s and make it appear in the scratch directory. */
+static int plug(uint32_t s)
+{
+    char slave[64], path[128];
+    int master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (master < 0)
+        return -1;
+    if (grantpt(master) != 0 || unlockpt(master) != 0 || ptsname_r(master, slave, sizeof(slave)) != 0)
+    {
+        close(master);
+        return -1;
+    }
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+    link_path(s, path, sizeof(path));
+    if (symlink(slave, path) != 0)
+    {
+        close(master);
+        return -1;
+    }
+    sensors[s].master_fd = master;
+    sensors[s].plugged = true;
+    return 0;
+}
+
+/** Take sensor s away: by hangup, or by removing its port first. */
+static void unplug(uint32_t s, bool by_remove)
+{
+    char path[128];
+    link_path(s, path, sizeof(path));
+    unlink(path);
+    sensors[s].plugged = false;
+
+    if (by_remove)
+    {
+        const uint16_t port = sensors[s].port;
+        if (ld2420_linux_ingest_remove(&ingest, port) != LD2420_STATUS_OK)
+            out_of_order++;
+        removals++;
+        sensors[s].port = NO_PORT;
+        sensors[s].released = true;
+        port_sensor[port] = NO_SENSOR;
+    }
+    close(sensors[s].master_fd);
+    sensors[s].master_fd = -1;
+}
+
+/** One round: every attached sensor writes a frame; poll until all arrived. */
+static int run_round(uint64_t *out_ns)
+{
+    uint8_t frame[CHECK_FRAME_SIZE] = {
+        0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01,
+        0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x04, 0x03, 0x02, 0x01};
+
+    uint64_t expected = received;
+    const uint64_t start = now_ns();
+    for (uint32_t s = 0; s < sensor_count; s++)
+    {
+        if (!sensors[s].plugged || sensors[s].port == NO_PORT)
+            continue;
+        frame[CHECK_SEQ_OFFSET] = (uint8_t)sensors[s].next_write;
+        frame[CHECK_SEQ_OFFSET + 1] = (uint8_t)(sensors[s].next_write >> 8);
+        if (write(sensors[s].master_fd, frame, sizeof(frame)) != (ssize_t)sizeof(frame))
+            return -1;
+        sensors[s].next_write++;
+        expected++;
+    }
+
+    // Keep polling until the frames are in and every plugged sensor is attached
+    for (;;)
+    {
+        bool pending = received < expected;
+        for (uint32_t s = 0; s < sensor_count && !pending; s++)
+            pending = sensors[s].plugged && sensors[s].port == NO_PORT;
+        if (!pending)
+            break;
+        if (now_ns() - start > CHECK_ROUND_TIMEOUT_NS || ld2420_linux_ingest_poll(&ingest, 100) < 0)
+            return -1;
+    }
+    *out_ns = now_ns() - start;
+    return 0;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [--ports N] [--rounds N] [--churn N]\n", argv0);
+}
+
+int main(int argc, char **argv)
+{
+    check_options_t opt = {32, 400, 10};
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--ports") == 0 && i + 1 < argc)
+            opt.ports = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            opt.rounds = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--churn") == 0 && i + 1 < argc)
+            opt.churn = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (opt.ports < 2 || opt.ports > LD2420_LINUX_MAX_PORTS || opt.rounds == 0 || opt.churn == 0)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    sensor_count = opt.ports + opt.rounds / opt.churn;
+    sensors = calloc(sensor_count, sizeof(*sensors));
+    strcpy(scratch_dir, "/tmp/ld2420_hotplug.XXXXXX");
+    if (sensors == NULL || mkdtemp(scratch_dir) == NULL)
+    {
+        perror("setup");
+        return 1;
+    }
+    for (uint32_t s = 0; s < sensor_count; s++)
+    {
+        sensors[s].master_fd = -1;
+        sensors[s].port = NO_PORT;
+    }
+    for (uint32_t p = 0; p < LD2420_LINUX_MAX_PORTS; p++)
+        port_sensor[p] = NO_SENSOR;
+
+    int rc = 1;
+    uint32_t next_sensor = 0, unplugged = 0;
+    uint64_t worst_ns = 0, total_ns = 0;
+    if (ld2420_linux_ingest_init(&ingest, on_frame, NULL) != LD2420_STATUS_OK)
+        goto cleanup;
+
+    // Half before the watch (found by its initial scan), half through inotify
+    for (; next_sensor < opt.ports / 2; next_sensor++)
+        if (plug(next_sensor) != 0)
+            goto cleanup;
+    if (ld2420_linux_ingest_watch_devices(&ingest, scratch_dir, "ttyLD", on_port) != LD2420_STATUS_OK)
+    {
+        perror("ld2420_linux_ingest_watch_devices");
+        goto cleanup;
+    }
+    for (; next_sensor < opt.ports; next_sensor++)
+        if (plug(next_sensor) != 0)
+            goto cleanup;
+
+    for (uint32_t round = 0; round < opt.rounds; round++)
+    {
+        if (round > 0 && round % opt.churn == 0)
+        {
+            // Replace the longest-running sensor
+            while (!sensors[unplugged].plugged)
+                unplugged++;
+            unplug(unplugged, (round / opt.churn) % 2 == 0);
+            if (plug(next_sensor++) != 0)
+                goto cleanup;
+        }
+
+        uint64_t ns = 0;
+        if (run_round(&ns) != 0)
+        {
+            fprintf(stderr, "ERROR: round %u did not complete\n", round);
+            goto cleanup;
+        }
+        total_ns += ns;
+        if (ns > worst_ns)
+            worst_ns = ns;
+    }
+
+    // Hangups of the last unplugged sensors may still be queued
+    for (int i = 0; i < 10; i++)
+        ld2420_linux_ingest_poll(&ingest, 10);
+
+    uint32_t unreleased = 0;
+    for (uint32_t s = 0; s < next_sensor; s++)
+        unreleased += !sensors[s].plugged && !sensors[s].released;
+
+    printf("LD2420 hot plug check (%u ports, %u rounds, one replaced every %u)\n", opt.ports, opt.rounds, opt.churn);
+    printf("attached %llu, released by hangup %llu, removed %llu\n", (unsigned long long)attaches,
+           (unsigned long long)releases, (unsigned long long)removals);
+    printf("frames %llu, out of order %llu, unreleased %u\n", (unsigned long long)received,
+           (unsigned long long)out_of_order, unreleased);
+    printf("round latency mean %.1f us, worst %.1f us\n", (double)total_ns / opt.rounds / 1e3, (double)worst_ns / 1e3);
+
+    rc = out_of_order == 0 && unreleased == 0 && attaches == next_sensor ? 0 : 1;
+    printf("%s\n", rc == 0 ? "OK" : "FAILED");
+
+cleanup:
+    ld2420_linux_ingest_deinit(&ingest);
+    for (uint32_t s = 0; s < sensor_count; s++)
+    {
+        if (sensors[s].master_fd >= 0)
+        {
+            char path[128];
+            link_path(s, path, sizeof(path));
+            unlink(path);
+            close(sensors[s].master_fd);
+        }
+    }
+    rmdir(scratch_dir);
+    free(sensors);
+    return rc;
+}
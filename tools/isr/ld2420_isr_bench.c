@@ -0,0 +1,402 @@
+/*
+ * LD2420 ISR framing benchmark
+ * ----------------------------
+ * Measures the delay between the interrupt that receives the last byte of a
+ * frame and the code that acts on the frame, for the two RX paths of the Pico
+ * platform:
+ *
+ * - ring: the interrupt stores bytes in a ring buffer and the main loop
+ *   frames them when it gets to it, as ld2420_pico_process() does.
+ * - isr:  the interrupt feeds every byte to ld2420_framer_t and the frame is
+ *   handled on the byte that completes it; kept frames reach the main loop
+ *   through the framer's slots.
+ *
+ * A timer signal plays the UART interrupt: it preempts the main loop once per
+ * character time of `--burst` bytes (a FIFO's worth) at `--baud` and receives
+ * that burst of report frames, with a few bytes of line noise every 16th
+ * frame. The main loop does `--loop-us` of other work, spinning, and then
+ * processes received data. Like on a microcontroller, both share one core.
+ *
+ * For each mode it prints the frame latency (interrupt entry to frame
+ * handled) and the duration of one interrupt, both as mean, p99 and maximum,
+ * and the framer's cost per byte measured on its own. The latency of the ring
+ * path is dominated by the main loop period; that of the isr path by the
+ * framing of one burst.
+ *
+ * Usage: ld2420_isr_bench [--frames N] [--baud N] [--burst N] [--loop-us N] [--check]
+ *
+ * With --check the exit status is 1 unless both modes delivered every frame
+ * in order, the isr mode kept every frame for the main loop that it did not
+ * count as dropped, and its median latency is below that of the ring mode.
+ */
+
+#define _GNU_SOURCE
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_framer.h>
+#include <ld2420/ld2420_protocol.h>
+
+/** Ring between the emulated interrupt and the main loop in ring mode. */
+#define BENCH_RING_SIZE 4096u
+
+/** Noise bytes inserted before every 16th frame. */
+static const uint8_t NOISE[] = {0xF4, 0xF3, 0x00, 0xFD, 0xFC, 0x55};
+
+typedef struct
+{
+    uint32_t frames;
+    uint32_t baud;
+    uint32_t burst;
+    uint32_t loop_us;
+    bool check;
+} bench_options_t;
+
+typedef struct
+{
+    bool isr_mode;
+    const bench_options_t *opt;
+    const uint8_t *stream;
+    size_t stream_len;
+    const size_t *frame_end; // Offset one past each frame's last byte
+
+    uint64_t *arrival_ns;    // Per frame: entry of the interrupt that received its last byte
+    uint64_t *latency_ns;    // Per frame: arrival to handled, in the path under test
+    uint64_t *irq_ns;        // Per interrupt: duration
+    uint32_t irqs;
+    size_t offset;           // Next stream byte the interrupt receives
+    uint32_t next_frame;     // Next frame whose last byte has not arrived
+
+    // Ring mode
+    uint8_t ring[BENCH_RING_SIZE];
+    uint32_t head, tail;
+    uint32_t ring_overflow;
+
+    // Both modes: the framer runs in the interrupt (isr) or in the main loop (ring)
+    ld2420_framer_t framer;
+    uint32_t isr_frames;
+    uint32_t loop_frames;
+    uint32_t out_of_order;
+    uint16_t next_isr_seq;
+    uint16_t next_loop_seq;
+    volatile bool done;
+} bench_run_t;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void spin_until(uint64_t t)
+{
+    while (now_ns() < t)
+        ;
+}
+
+static uint16_t frame_sequence(const uint8_t *frame, uint16_t size)
+{
+    ld2420_report_energy_t msg;
+    if (ld2420_report_energy_decode(frame, size, &msg) != LD2420_STATUS_OK)
+        return UINT16_MAX;
+    return msg.distance_cm;
+}
+
+/** The isr path's callback: runs on the byte that completes the frame. */
+static bool on_isr_frame(bench_run_t *run, const uint8_t *frame, uint16_t size)
+{
+    const uint16_t seq = frame_sequence(frame, size);
+    if (seq != run->next_isr_seq)
+        run->out_of_order++;
+    else
+        run->latency_ns[seq] = now_ns() - run->arrival_ns[seq];
+    run->next_isr_seq = (uint16_t)(seq + 1u);
+    run->isr_frames++;
+    return true;
+}
+
+static void on_loop_frame(bench_run_t *run, const uint8_t *frame, uint16_t size)
+{
+    const uint16_t seq = frame_sequence(frame, size);
+    if (seq != run->next_loop_seq && !run->isr_mode)
+        run->out_of_order++;
+    if (!run->isr_mode && seq < run->opt->frames)
+        run->latency_ns[seq] = now_ns() - run->arrival_ns[seq];
+    run->next_loop_seq = (uint16_t)(seq + 1u);
+    run->loop_frames++;
+}
+
+/** Run being measured; the signal handler finds it here. */
+static bench_run_t *current;
+
+/**
+ * The emulated UART interrupt: a timer signal every character time of a
+ * burst, which preempts the main loop as an interrupt would.
+ */
+static void irq_handler(int sig)
+{
+    (void)sig;
+    bench_run_t *run = current;
+    if (run == NULL || run->done)
+        return;
+
+    const uint64_t entry = now_ns();
+    const size_t offset = run->offset;
+    const size_t end = offset + run->opt->burst < run->stream_len ? offset + run->opt->burst : run->stream_len;
+    while (run->next_frame < run->opt->frames && run->frame_end[run->next_frame] <= end)
+        run->arrival_ns[run->next_frame++] = entry;
+
+    if (run->isr_mode)
+    {
+        for (size_t i = offset; i < end; i++)
+        {
+            uint16_t size;
+            const uint8_t *f = ld2420_framer_push(&run->framer, run->stream[i], &size);
+            if (f != NULL && on_isr_frame(run, f, size))
+                ld2420_framer_publish(&run->framer);
+        }
+    }
+    else
+    {
+        uint32_t head = run->head;
+        const uint32_t tail = __atomic_load_n(&run->tail, __ATOMIC_ACQUIRE);
+        for (size_t i = offset; i < end; i++)
+        {
+            const uint32_t n = (head + 1u) % BENCH_RING_SIZE;
+            if (n == tail)
+            {
+                run->ring_overflow++;
+                continue;
+            }
+            run->ring[head] = run->stream[i];
+            head = n;
+        }
+        __atomic_store_n(&run->head, head, __ATOMIC_RELEASE);
+    }
+    run->offset = end;
+    run->irq_ns[run->irqs++] = now_ns() - entry;
+    if (end == run->stream_len)
+        __atomic_store_n(&run->done, true, __ATOMIC_RELEASE);
+}
+
+/** One pass of the main loop's receive processing. */
+static void loop_process(bench_run_t *run)
+{
+    uint16_t size;
+    if (run->isr_mode)
+    {
+        const uint8_t *frame;
+        while ((frame = ld2420_framer_peek(&run->framer, &size)) != NULL)
+        {
+            on_loop_frame(run, frame, size);
+            ld2420_framer_release(&run->framer);
+        }
+        return;
+    }
+
+    uint32_t tail = run->tail;
+    const uint32_t head = __atomic_load_n(&run->head, __ATOMIC_ACQUIRE);
+    while (tail != head)
+    {
+        const uint8_t *frame = ld2420_framer_push(&run->framer, run->ring[tail], &size);
+        tail = (tail + 1u) % BENCH_RING_SIZE;
+        if (frame != NULL)
+            on_loop_frame(run, frame, size);
+    }
+    __atomic_store_n(&run->tail, tail, __ATOMIC_RELEASE);
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    const uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+typedef struct
+{
+    double mean_us, p50_us, p99_us, max_us;
+} summary_t;
+
+static summary_t summarize(uint64_t *v, uint32_t n)
+{
+    summary_t s = {0};
+    if (n == 0)
+        return s;
+    qsort(v, n, sizeof(*v), compare_u64);
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < n; i++)
+        sum += v[i];
+    s.mean_us = (double)sum / n / 1000.0;
+    s.p50_us = (double)v[n / 2] / 1000.0;
+    s.p99_us = (double)v[(uint64_t)n * 99u / 100u] / 1000.0;
+    s.max_us = (double)v[n - 1] / 1000.0;
+    return s;
+}
+
+static int run_mode(bench_run_t *run, summary_t *latency)
+{
+    ld2420_framer_init(&run->framer);
+    current = run;
+
+    const uint64_t burst_ns = (uint64_t)run->opt->burst * 10u * 1000000000ull / run->opt->baud;
+    const struct timespec period = {.tv_sec = (time_t)(burst_ns / 1000000000u), .tv_nsec = (long)(burst_ns % 1000000000u)};
+    const struct itimerspec arm = {.it_interval = period, .it_value = period};
+    struct sigevent sev = {.sigev_notify = SIGEV_SIGNAL, .sigev_signo = SIGALRM};
+    timer_t timer;
+    if (timer_create(CLOCK_MONOTONIC, &sev, &timer) != 0 || timer_settime(timer, 0, &arm, NULL) != 0)
+        return -1;
+
+    // The main loop: other work, then receive processing, until the stream is done
+    while (!__atomic_load_n(&run->done, __ATOMIC_ACQUIRE))
+    {
+        spin_until(now_ns() + (uint64_t)run->opt->loop_us * 1000u);
+        loop_process(run);
+    }
+    timer_delete(timer);
+    current = NULL;
+    loop_process(run);
+
+    const uint32_t delivered = run->isr_mode ? run->isr_frames : run->loop_frames;
+    *latency = summarize(run->latency_ns, delivered < run->opt->frames ? delivered : run->opt->frames);
+    const summary_t irq_time = summarize(run->irq_ns, run->irqs);
+    printf("%-5s latency  mean %8.2f us  p50 %8.2f us  p99 %8.2f us  max %8.2f us\n",
+           run->isr_mode ? "isr" : "ring", latency->mean_us, latency->p50_us, latency->p99_us, latency->max_us);
+    printf("      irq      mean %8.2f us  p50 %8.2f us  p99 %8.2f us  max %8.2f us  (%u interrupts)\n",
+           irq_time.mean_us, irq_time.p50_us, irq_time.p99_us, irq_time.max_us, run->irqs);
+    if (run->isr_mode)
+        printf("      frames   %u handled in the interrupt, %u in the main loop, %u dropped, %u framing errors\n",
+               run->isr_frames, run->loop_frames, run->framer.dropped_frames, run->framer.errors);
+    else
+        printf("      frames   %u handled in the main loop, %u bytes overflowed, %u framing errors\n",
+               run->loop_frames, run->ring_overflow, run->framer.errors);
+    return 0;
+}
+
+/** Per-byte framer cost, single-threaded, over the whole stream. */
+static double framer_ns_per_byte(const uint8_t *stream, size_t len)
+{
+    static ld2420_framer_t framer;
+    uint32_t frames = 0;
+    const uint64_t start = now_ns();
+    for (int pass = 0; pass < 20; pass++)
+    {
+        ld2420_framer_init(&framer);
+        for (size_t i = 0; i < len; i++)
+        {
+            uint16_t size;
+            frames += ld2420_framer_push(&framer, stream[i], &size) != NULL;
+        }
+    }
+    const double ns = (double)(now_ns() - start);
+    return frames > 0 ? ns / (20.0 * (double)len) : 0.0;
+}
+
+static int usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [--frames N] [--baud N] [--burst N] [--loop-us N] [--check]\n", argv0);
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    bench_options_t opt = {.frames = 1000, .baud = LD2420_BAUD_RATE, .burst = 32, .loop_us = 1000};
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--frames") == 0)
+            opt.frames = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (i + 1 < argc && strcmp(argv[i], "--baud") == 0)
+            opt.baud = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (i + 1 < argc && strcmp(argv[i], "--burst") == 0)
+            opt.burst = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (i + 1 < argc && strcmp(argv[i], "--loop-us") == 0)
+            opt.loop_us = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--check") == 0)
+            opt.check = true;
+        else
+            return usage(argv[0]);
+    }
+    // Sequence numbers are the u16 distance field
+    if (opt.frames == 0 || opt.frames > UINT16_MAX || opt.baud == 0 || opt.burst == 0)
+        return usage(argv[0]);
+
+    const size_t capacity = (size_t)opt.frames * (LD2420_REPORT_ENERGY_SIZE + sizeof(NOISE));
+    uint8_t *stream = malloc(capacity);
+    size_t *frame_end = calloc(opt.frames, sizeof(*frame_end));
+    if (stream == NULL || frame_end == NULL)
+        return 1;
+    size_t len = 0;
+    uint32_t rng = 0x2545F491u;
+    for (uint32_t f = 0; f < opt.frames; f++)
+    {
+        if (f % 16u == 15u)
+        {
+            memcpy(stream + len, NOISE, sizeof(NOISE));
+            len += sizeof(NOISE);
+        }
+        ld2420_report_energy_t msg = {.presence = 1, .distance_cm = (uint16_t)f};
+        for (int g = 0; g < 16; g++)
+        {
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            msg.energy[g] = (uint16_t)rng;
+        }
+        len += ld2420_report_energy_encode(stream + len, &msg);
+        frame_end[f] = len;
+    }
+
+    struct sigaction sa = {.sa_handler = irq_handler};
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGALRM, &sa, NULL);
+
+    printf("%u frames, %zu bytes at %u baud, %u-byte bursts, %u us main loop\n", opt.frames, len, opt.baud,
+           opt.burst, opt.loop_us);
+    printf("framer   %.2f ns/byte\n", framer_ns_per_byte(stream, len));
+
+    bool failed = false;
+    summary_t latency[2];
+    for (int mode = 0; mode < 2; mode++)
+    {
+        bench_run_t *run = calloc(1, sizeof(*run));
+        if (run == NULL)
+            return 1;
+        run->isr_mode = mode == 1;
+        run->opt = &opt;
+        run->stream = stream;
+        run->stream_len = len;
+        run->frame_end = frame_end;
+        run->arrival_ns = calloc(opt.frames, sizeof(uint64_t));
+        run->latency_ns = calloc(opt.frames, sizeof(uint64_t));
+        run->irq_ns = calloc(len / opt.burst + 1u, sizeof(uint64_t));
+        if (run->arrival_ns == NULL || run->latency_ns == NULL || run->irq_ns == NULL ||
+            run_mode(run, &latency[mode]) != 0)
+            return 1;
+
+        if (run->out_of_order != 0 || (run->isr_mode ? run->isr_frames : run->loop_frames) != opt.frames ||
+            (run->isr_mode && run->loop_frames + run->framer.dropped_frames != opt.frames))
+            failed = true;
+        free(run->arrival_ns);
+        free(run->latency_ns);
+        free(run->irq_ns);
+        free(run);
+    }
+    if (latency[1].p50_us >= latency[0].p50_us)
+        failed = true;
+
+    free(stream);
+    free(frame_end);
+    if (opt.check && failed)
+    {
+        fprintf(stderr, "FAIL\n");
+        return 1;
+    }
+    return 0;
+}
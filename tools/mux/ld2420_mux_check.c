@@ -0,0 +1,434 @@
+/*
+ * LD2420 session multiplexer check
+ * --------------------------------
+ * Runs ld2420_linux_mux_t between an emulated sensor and several clients and
+ * verifies that they can share the sensor without stepping on each other.
+ *
+ * - The sensor is the master side of a pty, served by a thread. It ACKs
+ *   every command with status 0, answers READ_CONFIG with the last value set,
+ *   and writes a report frame every millisecond with a sequence number in the
+ *   distance field.
+ * - Each client thread runs `--sessions` config sessions: OPEN_CONFIG_MODE
+ *   with its own id as protocol version, SET_CONFIG of its id, READ_CONFIG,
+ *   CLOSE_CONFIG_MODE. Between the ACKs it receives report frames.
+ * - One more client opens a session and disconnects without closing it.
+ *
+ * The sensor fails the check if a session opens while another is open, or a
+ * config command arrives outside a session or with another client's id. A
+ * client fails it if an ACK is not the one for its command, the value read
+ * back is not its own, or report frames arrive out of order. The multiplexer
+ * must have closed the abandoned session and granted every other one.
+ *
+ * Usage: ld2420_mux_check [--clients N] [--sessions N]
+ */
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/platform/linux/ld2420_linux.h>
+#include <ld2420/platform/linux/ld2420_linux_mux.h>
+
+/** Parameter the clients write and read back. */
+#define CHECK_PARAMETER 0x0001u
+
+/** No session open on the emulated sensor. */
+#define NO_SESSION 0xFFFFu
+
+/** How long a client waits for one message before it gives up. */
+#define CHECK_RECV_TIMEOUT_S 5
+
+typedef struct
+{
+    int master_fd;
+    volatile bool stop;
+    uint16_t session;  // Protocol version of the open session, or NO_SESSION
+    uint32_t value;    // Last value set
+    uint16_t sequence; // Sequence number of the next report frame
+    uint32_t commands;
+    uint32_t closes;
+    uint32_t violations;
+} sensor_t;
+
+typedef struct
+{
+    pthread_t thread;
+    uint16_t id;
+    uint32_t sessions;
+    bool abandon;       // Open one session and disconnect
+    const char *path;
+    uint32_t reports;
+    bool have_sequence;
+    uint16_t last_sequence;
+    uint32_t errors;
+} client_t;
+
+static sensor_t sensor;
+static ld2420_linux_mux_t mux;
+static uint32_t clients_done;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* ---- Emulated sensor ---- */
+
+static void sensor_write(const uint8_t *frame, uint16_t size)
+{
+    uint16_t sent = 0;
+    while (sent < size)
+    {
+        const ssize_t n = write(sensor.master_fd, frame + sent, size - sent);
+        if (n > 0)
+            sent = (uint16_t)(sent + n);
+        else
+            poll(&(struct pollfd){.fd = sensor.master_fd, .events = POLLOUT}, 1, 10);
+    }
+}
+
+static void sensor_command(const uint8_t *frame, uint16_t size)
+{
+    uint8_t ack[LD2420_PROTOCOL_ACK_MAX_SIZE];
+    uint16_t ack_size = 0;
+    const uint16_t id = ld2420_protocol_read_le16(frame + LD2420_COMMAND_ID_OFFSET);
+    sensor.commands++;
+
+    switch (id)
+    {
+    case LD2420_COMMAND_OPEN_CONFIG_MODE_ID:
+    {
+        ld2420_command_open_config_mode_t cmd;
+        if (ld2420_command_open_config_mode_decode(frame, size, &cmd) != LD2420_STATUS_OK ||
+            sensor.session != NO_SESSION)
+            sensor.violations++;
+        sensor.session = cmd.protocol_version;
+        ack_size = ld2420_ack_open_config_mode_encode(
+            ack, &(ld2420_ack_open_config_mode_t){.protocol_version = cmd.protocol_version, .buffer_size = 64});
+        break;
+    }
+    case LD2420_COMMAND_SET_CONFIG_ID:
+    {
+        ld2420_command_set_config_t cmd;
+        if (ld2420_command_set_config_decode(frame, size, &cmd) != LD2420_STATUS_OK || cmd.entries_count != 1 ||
+            sensor.session == NO_SESSION || cmd.entries[0].value != sensor.session)
+            sensor.violations++;
+        sensor.value = cmd.entries[0].value;
+        ack_size = ld2420_ack_set_config_encode(ack, &(ld2420_ack_set_config_t){0});
+        break;
+    }
+    case LD2420_COMMAND_READ_CONFIG_ID:
+    {
+        if (sensor.session == NO_SESSION)
+            sensor.violations++;
+        ld2420_ack_read_config_t msg = {.values = {sensor.value}, .values_count = 1};
+        ack_size = ld2420_ack_read_config_encode(ack, &msg);
+        break;
+    }
+    case LD2420_COMMAND_CLOSE_CONFIG_MODE_ID:
+        if (sensor.session == NO_SESSION)
+            sensor.violations++;
+        sensor.session = NO_SESSION;
+        sensor.closes++;
+        ack_size = ld2420_ack_close_config_mode_encode(ack, &(ld2420_ack_close_config_mode_t){0});
+        break;
+    default:
+        sensor.violations++;
+        return;
+    }
+    sensor_write(ack, ack_size);
+}
+
+static void *sensor_main(void *arg)
+{
+    (void)arg;
+    uint8_t buf[2 * LD2420_MAX_TX_PACKET_SIZE];
+    size_t len = 0;
+    uint64_t next_report = now_ns();
+
+    while (!sensor.stop)
+    {
+        struct pollfd pfd = {.fd = sensor.master_fd, .events = POLLIN};
+        if (poll(&pfd, 1, 1) > 0)
+        {
+            const ssize_t n = read(sensor.master_fd, buf + len, sizeof(buf) - len);
+            if (n > 0)
+                len += (size_t)n;
+        }
+
+        // Commands arrive whole but possibly split across reads
+        for (;;)
+        {
+            size_t start = 0;
+            while (start + 4 <= len && ld2420_protocol_read_le32(buf + start) != LD2420_PROTOCOL_COMMAND_HEADER)
+                start++;
+            memmove(buf, buf + start, len - start);
+            len -= start;
+            if (len < LD2420_PROTOCOL_PAYLOAD_OFFSET)
+                break;
+            const size_t size = LD2420_PROTOCOL_FRAME_OVERHEAD + ld2420_protocol_read_le16(buf + 4);
+            if (size > LD2420_PROTOCOL_COMMAND_MAX_SIZE)
+            {
+                sensor.violations++;
+                len = 0;
+                break;
+            }
+            if (len < size)
+                break;
+            sensor_command(buf, (uint16_t)size);
+            memmove(buf, buf + size, len - size);
+            len -= size;
+        }
+
+        if (now_ns() >= next_report)
+        {
+            uint8_t report[LD2420_REPORT_ENERGY_SIZE];
+            ld2420_report_energy_t msg = {.presence = 1, .distance_cm = sensor.sequence++};
+            ld2420_report_energy_encode(report, &msg);
+            sensor_write(report, sizeof(report));
+            next_report += 1000000u;
+        }
+    }
+    return NULL;
+}
+
+/* ---- Clients ---- */
+
+/** Send one command and receive until its ACK; report frames in between are checked. */
+static bool transact(client_t *c, int fd, const uint8_t *cmd, uint16_t size, uint8_t *ack, ssize_t *ack_size)
+{
+    if (send(fd, cmd, size, MSG_NOSIGNAL) != (ssize_t)size)
+        return false;
+    const uint16_t echo = (uint16_t)(ld2420_protocol_read_le16(cmd + LD2420_COMMAND_ID_OFFSET) |
+                                     LD2420_PROTOCOL_ACK_ECHO_FLAG);
+    for (;;)
+    {
+        const ssize_t n = recv(fd, ack, LD2420_MAX_RX_PACKET_SIZE, 0);
+        if (n < (ssize_t)LD2420_PROTOCOL_PAYLOAD_OFFSET)
+            return false;
+        if (ld2420_protocol_read_le32(ack) == LD2420_PROTOCOL_REPORT_HEADER)
+        {
+            ld2420_report_energy_t msg;
+            if (ld2420_report_energy_decode(ack, (uint16_t)n, &msg) != LD2420_STATUS_OK)
+                return false;
+            const uint16_t seq = msg.distance_cm;
+            if (c->have_sequence && (uint16_t)(seq - c->last_sequence - 1u) >= 0x8000u)
+                c->errors++;
+            c->have_sequence = true;
+            c->last_sequence = seq;
+            c->reports++;
+            continue;
+        }
+        if (ld2420_protocol_read_le16(ack + LD2420_ACK_CMD_ECHO_OFFSET) != echo ||
+            ld2420_protocol_read_le16(ack + LD2420_ACK_STATUS_OFFSET) != 0)
+            return false;
+        *ack_size = n;
+        return true;
+    }
+}
+
+static bool run_session(client_t *c, int fd)
+{
+    uint8_t cmd[LD2420_MAX_TX_PACKET_SIZE], ack[LD2420_MAX_RX_PACKET_SIZE];
+    ssize_t n;
+
+    uint16_t size = ld2420_command_open_config_mode_encode(cmd, &(ld2420_command_open_config_mode_t){c->id});
+    if (!transact(c, fd, cmd, size, ack, &n))
+        return false;
+    if (c->abandon)
+        return true;
+
+    ld2420_command_set_config_t set = {.entries = {{CHECK_PARAMETER, c->id}}, .entries_count = 1};
+    size = ld2420_command_set_config_encode(cmd, &set);
+    if (!transact(c, fd, cmd, size, ack, &n))
+        return false;
+
+    ld2420_command_read_config_t read = {.parameters = {CHECK_PARAMETER}, .parameters_count = 1};
+    size = ld2420_command_read_config_encode(cmd, &read);
+    ld2420_ack_read_config_t values;
+    if (!transact(c, fd, cmd, size, ack, &n) ||
+        ld2420_ack_read_config_decode(ack, (uint16_t)n, &values) != LD2420_STATUS_OK || values.values_count != 1 ||
+        values.values[0] != c->id)
+        return false;
+
+    size = ld2420_command_close_config_mode_encode(cmd);
+    return transact(c, fd, cmd, size, ack, &n);
+}
+
+static void *client_main(void *arg)
+{
+    client_t *c = arg;
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    strcpy(addr.sun_path, c->path);
+
+    const int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    const struct timeval timeout = {.tv_sec = CHECK_RECV_TIMEOUT_S};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (fd < 0 || connect(fd, (const struct sockaddr *)&addr, sizeof(addr)) != 0)
+        c->errors++;
+    else
+        for (uint32_t s = 0; s < c->sessions; s++)
+            if (!run_session(c, fd))
+            {
+                c->errors++;
+                break;
+            }
+    if (fd >= 0)
+        close(fd);
+    __atomic_add_fetch(&clients_done, 1u, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+/* ---- Driver ---- */
+
+static int open_sensor(int *serial_fd)
+{
+    char slave[64];
+    sensor.master_fd = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (sensor.master_fd < 0)
+        return -1;
+    if (grantpt(sensor.master_fd) != 0 || unlockpt(sensor.master_fd) != 0 ||
+        ptsname_r(sensor.master_fd, slave, sizeof(slave)) != 0 ||
+        ld2420_linux_open_serial(slave, serial_fd) != LD2420_STATUS_OK)
+    {
+        close(sensor.master_fd);
+        return -1;
+    }
+    fcntl(sensor.master_fd, F_SETFL, fcntl(sensor.master_fd, F_GETFL) | O_NONBLOCK);
+    sensor.session = NO_SESSION;
+    return 0;
+}
+
+static int usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [--clients N] [--sessions N]\n", argv0);
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t client_count = 6, sessions = 50;
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--clients") == 0)
+            client_count = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (i + 1 < argc && strcmp(argv[i], "--sessions") == 0)
+            sessions = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else
+            return usage(argv[0]);
+    }
+    // One slot stays free for the client that abandons its session
+    if (client_count == 0 || client_count >= LD2420_LINUX_MUX_MAX_CLIENTS || sessions == 0)
+        return usage(argv[0]);
+
+    char dir[] = "/tmp/ld2420_mux_XXXXXX", path[64];
+    int serial_fd, listen_fd;
+    if (mkdtemp(dir) == NULL)
+        return 1;
+    snprintf(path, sizeof(path), "%s/mux.sock", dir);
+    if (open_sensor(&serial_fd) != 0 || ld2420_linux_mux_listen(path, &listen_fd) != LD2420_STATUS_OK ||
+        ld2420_linux_mux_init(&mux, serial_fd, listen_fd) != LD2420_STATUS_OK)
+    {
+        perror("setup");
+        return 1;
+    }
+
+    pthread_t sensor_thread;
+    pthread_create(&sensor_thread, NULL, sensor_main, NULL);
+
+    static client_t clients[LD2420_LINUX_MUX_MAX_CLIENTS];
+    const uint32_t total = client_count + 1u;
+    const uint64_t start = now_ns();
+    for (uint32_t i = 0; i < total; i++)
+    {
+        clients[i].id = (uint16_t)(i + 1u);
+        clients[i].path = path;
+        clients[i].abandon = i == client_count;
+        clients[i].sessions = clients[i].abandon ? 1u : sessions;
+        pthread_create(&clients[i].thread, NULL, client_main, &clients[i]);
+    }
+
+    bool failed = false;
+    while (__atomic_load_n(&clients_done, __ATOMIC_ACQUIRE) < total)
+        if (ld2420_linux_mux_poll(&mux, 10) < 0)
+        {
+            fprintf(stderr, "poll failed\n");
+            failed = true;
+            break;
+        }
+    // Let the forced close of the abandoned session go through
+    const uint64_t settle = now_ns() + 200000000ull;
+    while (!failed && (mux.owner != LD2420_LINUX_MUX_NONE || now_ns() < settle))
+        ld2420_linux_mux_poll(&mux, 10);
+    const double seconds = (double)(now_ns() - start) / 1e9;
+
+    for (uint32_t i = 0; i < total; i++)
+        pthread_join(clients[i].thread, NULL);
+    sensor.stop = true;
+    pthread_join(sensor_thread, NULL);
+
+    uint32_t client_errors = 0;
+    uint64_t reports = 0;
+    for (uint32_t i = 0; i < total; i++)
+    {
+        client_errors += clients[i].errors;
+        reports += clients[i].reports;
+    }
+    const uint32_t expected_sessions = client_count * sessions + 1u;
+
+    printf("clients:        %u (+1 abandoning)\n", client_count);
+    printf("sessions:       %u granted, %u forced closes\n", mux.sessions, mux.forced_closes);
+    printf("transactions:   %u in %.2f s (%.0f/s)\n", mux.transactions, seconds, mux.transactions / seconds);
+    printf("reports:        %llu sent by the sensor, %llu read by clients\n", (unsigned long long)mux.frames,
+           (unsigned long long)reports);
+    printf("sensor:         %u commands, %u violations\n", sensor.commands, sensor.violations);
+    printf("mux:            %u ack timeouts, %u stray acks, %u serial errors\n", mux.ack_timeouts, mux.stray_acks,
+           mux.serial_errors);
+    printf("client errors:  %u\n", client_errors);
+
+    // Every command the multiplexer completed was timed, none gave up
+    uint32_t timed = 0, given_up = 0;
+    const uint16_t ids[] = {LD2420_CMD_OPEN_CONFIG_MODE, LD2420_CMD_SET_CONFIG, LD2420_CMD_READ_CONFIG,
+                            LD2420_CMD_CLOSE_CONFIG_MODE};
+    for (uint32_t k = 0; k < sizeof(ids) / sizeof(ids[0]); k++)
+    {
+        const ld2420_cmdstats_command_t *c = ld2420_cmdstats_get(&mux.cmdstats, ids[k]);
+        printf("rtt 0x%02X:       %u answered, p50 <= %.3f ms, p99 <= %.3f ms, max %.3f ms\n", ids[k], c->answered,
+               ld2420_cmdstats_percentile_us(c, 500) / 1000.0, ld2420_cmdstats_percentile_us(c, 990) / 1000.0,
+               c->max_rtt_us / 1000.0);
+    }
+    for (uint32_t k = 0; k < LD2420_CMDSTATS_COMMANDS; k++)
+    {
+        timed += mux.cmdstats.commands[k].answered;
+        given_up += mux.cmdstats.commands[k].timeouts + mux.cmdstats.commands[k].superseded;
+    }
+
+    if (failed || client_errors != 0 || sensor.violations != 0 || mux.sessions != expected_sessions ||
+        mux.forced_closes != 1 || sensor.closes != expected_sessions || mux.ack_timeouts != 0 || mux.stray_acks != 0 ||
+        mux.serial_errors != 0 || reports == 0 || timed != mux.transactions || given_up != 0 ||
+        mux.cmdstats.orphan_acks != 0)
+    {
+        fprintf(stderr, "FAIL\n");
+        failed = true;
+    }
+
+    ld2420_linux_mux_deinit(&mux);
+    close(sensor.master_fd);
+    unlink(path);
+    rmdir(dir);
+    return failed ? 1 : 0;
+}
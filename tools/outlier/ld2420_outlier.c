@@ -0,0 +1,790 @@
+/*
+ * LD2420 fleet outlier ranking
+ * ----------------------------
+ * Finds sensors whose gate energy profile differs from the other sensors in
+ * the same group (usually: the same room). A mis-mounted sensor sees the room
+ * from a different angle and its clutter moves to other gates; a faulty one
+ * loses gates or gain. Both stand out against neighbours that see the same
+ * walls, while a fleet-wide threshold would drown in the differences between
+ * rooms.
+ *
+ * Input is what the gateways already produce: uplink captures, one file per
+ * gateway (a recording of the link, or ld2420_scene --format uplink), and a
+ * mapping file with one line per sensor:
+ *
+ *     # gateway  sensor_id  group
+ *     hall-gw    3          room-12
+ *
+ * The gateway name is the capture's file name without directory and
+ * extension. Report frames are decoded with ld2420_decode_report_batch() in
+ * chunks and summed per sensor and gate; other records are skipped.
+ *
+ * Scoring, per group of at least three sensors with --min-frames frames:
+ *
+ * 1. Profile: log2(1 + mean energy) per gate. With --metric cosine the profile
+ *    is also centred and scaled to unit length, so only its shape counts.
+ * 2. Group centre: the per-gate median of the members' profiles, so a few
+ *    outliers do not pull it towards themselves.
+ * 3. Distance to the centre: Euclidean (l2), or 1 - cosine similarity. The
+ *    kernels work on 16 floats at once in SSE2 registers where available.
+ * 4. Score: distance divided by the group's median distance (at least
+ *    --min-spread), i.e. how many times further out than a typical member.
+ *
+ * Sensors are ranked by score; the top --top are printed with the gate that
+ * differs most from the group centre.
+ *
+ * --synthetic N builds a fleet of N sensors in groups of --group-size in
+ * memory instead: each group gets a room profile, every sensor a gain error
+ * and per-frame noise, and one sensor in every 50 groups is mis-mounted
+ * (profile shifted by three gates) or faulty (far gates dead). With --check
+ * the exit status is 1 unless exactly those sensors rank on top.
+ *
+ * Usage: ld2420_outlier --groups FILE CAPTURE...
+ *        ld2420_outlier --synthetic N [--group-size N] [--frames N] [--seed N] [--check]
+ *        common: [--metric l2|cosine] [--top N] [--min-frames N] [--min-spread X]
+ *                [--threshold X]
+ */
+
+#define _GNU_SOURCE
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_batch.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/ld2420_uplink.h>
+
+#if defined(__SSE2__) && !defined(LD2420_NO_SIMD)
+#include <emmintrin.h>
+#define OUTLIER_SSE2 1
+#endif
+
+#define GATES LD2420_REPORT_GATES
+/** Report frames decoded per ld2420_decode_report_batch() call. */
+#define CHUNK 4096u
+/** Smallest group that has neighbours to compare against. */
+#define MIN_GROUP 3u
+#define NO_SENSOR UINT32_MAX
+
+typedef enum
+{
+    METRIC_L2,
+    METRIC_COSINE,
+} metric_t;
+
+typedef struct
+{
+    const char *groups_path;
+    uint32_t synthetic;
+    uint32_t group_size;
+    uint32_t frames;
+    uint32_t seed;
+    metric_t metric;
+    uint32_t top;
+    uint32_t min_frames;
+    float min_spread;
+    float threshold;
+    bool check;
+} outlier_options_t;
+
+/** Sensors in structure-of-arrays form; profiles are 16-byte aligned rows of 16 floats. */
+typedef struct
+{
+    uint32_t count;
+    uint32_t capacity;
+    uint16_t *gateway;
+    uint8_t *sensor_id;
+    uint32_t *group;
+    uint32_t *frames;
+    uint64_t *sums;    // [count][GATES]
+    float *profile;    // [count][GATES]
+    float *distance;
+    float *score;
+    bool *injected;    // synthetic fleets only
+} fleet_t;
+
+/** Interned names (gateways, groups) with an open-addressing index. */
+typedef struct
+{
+    char **names;
+    uint32_t count;
+    uint32_t *slots;
+    uint32_t slot_mask;
+} names_t;
+
+/** Report frames waiting for the batch decoder. */
+typedef struct
+{
+    uint8_t frames[CHUNK][LD2420_REPORT_ENERGY_SIZE];
+    const uint8_t *ptrs[CHUNK];
+    uint32_t sensor[CHUNK];
+    uint16_t energy[GATES][CHUNK];
+    uint32_t count;
+    uint64_t total;
+} chunk_t;
+
+static chunk_t chunk;
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static uint32_t hash_name(const char *s)
+{
+    uint32_t h = 2166136261u;
+    while (*s != '\0')
+        h = (h ^ (uint8_t)*s++) * 16777619u;
+    return h;
+}
+
+/** Index of name, added if new; NO_SENSOR when out of memory. */
+static uint32_t intern(names_t *t, const char *name)
+{
+    if ((t->count + 1u) * 2u > t->slot_mask + 1u)
+    {
+        const uint32_t slots = t->slot_mask == 0 ? 1024u : (t->slot_mask + 1u) * 2u;
+        uint32_t *s = malloc(slots * sizeof(*s));
+        char **n = realloc(t->names, slots / 2u * sizeof(*n));
+        if (s == NULL || n == NULL)
+        {
+            free(s);
+            return NO_SENSOR;
+        }
+        memset(s, 0xFF, slots * sizeof(*s));
+        for (uint32_t i = 0; i < t->count; i++)
+        {
+            uint32_t k = hash_name(n[i]) & (slots - 1u);
+            while (s[k] != NO_SENSOR)
+                k = (k + 1u) & (slots - 1u);
+            s[k] = i;
+        }
+        free(t->slots);
+        t->slots = s;
+        t->names = n;
+        t->slot_mask = slots - 1u;
+    }
+
+    uint32_t k = hash_name(name) & t->slot_mask;
+    for (; t->slots[k] != NO_SENSOR; k = (k + 1u) & t->slot_mask)
+        if (strcmp(t->names[t->slots[k]], name) == 0)
+            return t->slots[k];
+    t->names[t->count] = strdup(name);
+    t->slots[k] = t->count;
+    return t->count++;
+}
+
+static uint32_t lookup(const names_t *t, const char *name)
+{
+    if (t->slot_mask == 0)
+        return NO_SENSOR;
+    for (uint32_t k = hash_name(name) & t->slot_mask; t->slots[k] != NO_SENSOR; k = (k + 1u) & t->slot_mask)
+        if (strcmp(t->names[t->slots[k]], name) == 0)
+            return t->slots[k];
+    return NO_SENSOR;
+}
+
+static int fleet_reserve(fleet_t *f, uint32_t count)
+{
+    if (count <= f->capacity)
+        return 0;
+    uint32_t cap = f->capacity == 0 ? 1024u : f->capacity;
+    while (cap < count)
+        cap *= 2u;
+
+#define GROW(field)                                                        \
+    do                                                                     \
+    {                                                                      \
+        void *p = realloc(f->field, (size_t)cap * sizeof(*f->field));      \
+        if (p == NULL)                                                     \
+            return -1;                                                     \
+        f->field = p;                                                      \
+    } while (0)
+    GROW(gateway);
+    GROW(sensor_id);
+    GROW(group);
+    GROW(frames);
+    GROW(distance);
+    GROW(score);
+    GROW(injected);
+#undef GROW
+    uint64_t *sums = realloc(f->sums, (size_t)cap * GATES * sizeof(*sums));
+    if (sums == NULL)
+        return -1;
+    f->sums = sums;
+    f->capacity = cap;
+    return 0;
+}
+
+static uint32_t fleet_add(fleet_t *f, uint16_t gateway, uint8_t sensor_id, uint32_t group)
+{
+    if (fleet_reserve(f, f->count + 1u) != 0)
+        return NO_SENSOR;
+    const uint32_t i = f->count++;
+    f->gateway[i] = gateway;
+    f->sensor_id[i] = sensor_id;
+    f->group[i] = group;
+    f->frames[i] = 0;
+    f->injected[i] = false;
+    memset(&f->sums[(size_t)i * GATES], 0, GATES * sizeof(*f->sums));
+    return i;
+}
+
+/** Decode the queued frames and add their energies to the sensors' sums. */
+static void chunk_flush(fleet_t *f)
+{
+    if (chunk.count == 0)
+        return;
+    ld2420_report_batch_t out = {.energy_scale = 1.0f};
+    for (uint32_t g = 0; g < GATES; g++)
+        out.energy[g] = chunk.energy[g];
+    ld2420_decode_report_batch(chunk.ptrs, chunk.count, &out);
+
+    for (uint32_t i = 0; i < chunk.count; i++)
+    {
+        const uint32_t s = chunk.sensor[i];
+        uint64_t *sums = &f->sums[(size_t)s * GATES];
+        for (uint32_t g = 0; g < GATES; g++)
+            sums[g] += chunk.energy[g][i];
+        f->frames[s]++;
+    }
+    chunk.total += chunk.count;
+    chunk.count = 0;
+}
+
+/** Slot for the next report frame of a sensor; copy or encode the frame into it. */
+static uint8_t *chunk_slot(fleet_t *f, uint32_t sensor)
+{
+    if (chunk.count == CHUNK)
+        chunk_flush(f);
+    chunk.ptrs[chunk.count] = chunk.frames[chunk.count];
+    chunk.sensor[chunk.count] = sensor;
+    return chunk.frames[chunk.count++];
+}
+
+/* ---- Capture input ---- */
+
+typedef struct
+{
+    fleet_t *fleet;
+    const uint32_t *map; // sensor index per uplink sensor id of this gateway
+    uint64_t unmapped;
+    uint64_t other;
+} capture_t;
+
+static bool on_record(void *user, const ld2420_uplink_record_t *r)
+{
+    capture_t *c = (capture_t *)user;
+    ld2420_report_energy_t report;
+    if (r->kind != LD2420_UPLINK_KIND_FRAME ||
+        ld2420_report_energy_decode(r->payload, r->payload_size, &report) != LD2420_STATUS_OK)
+    {
+        c->other++;
+        return true;
+    }
+    const uint32_t s = c->map[r->sensor_id];
+    if (s == NO_SENSOR)
+    {
+        c->unmapped++;
+        return true;
+    }
+    memcpy(chunk_slot(c->fleet, s), r->payload, LD2420_REPORT_ENERGY_SIZE);
+    return true;
+}
+
+/** Gateway name of a capture path: file name without directory and extension. */
+static void gateway_name(const char *path, char *out, size_t size)
+{
+    const char *base = strrchr(path, '/');
+    base = base != NULL ? base + 1 : path;
+    snprintf(out, size, "%s", base);
+    char *dot = strrchr(out, '.');
+    if (dot != NULL && dot != out)
+        *dot = '\0';
+}
+
+static int load_groups(const char *path, fleet_t *f, names_t *gateways, names_t *groups, uint32_t **maps)
+{
+    FILE *in = fopen(path, "r");
+    if (in == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    char line[512];
+    unsigned lineno = 0;
+    while (fgets(line, sizeof(line), in) != NULL)
+    {
+        lineno++;
+        char gw[128], group[128];
+        unsigned id;
+        char *hash = strchr(line, '#');
+        if (hash != NULL)
+            *hash = '\0';
+        const int n = sscanf(line, "%127s %u %127s", gw, &id, group);
+        if (n <= 0)
+            continue;
+        if (n != 3 || id > 255u)
+        {
+            fprintf(stderr, "%s:%u: expected \"gateway sensor_id group\"\n", path, lineno);
+            fclose(in);
+            return -1;
+        }
+        const uint32_t g = intern(gateways, gw);
+        const uint32_t grp = intern(groups, group);
+        if (g == NO_SENSOR || grp == NO_SENSOR || g > UINT16_MAX)
+            goto oom;
+        if (maps[g] == NULL)
+        {
+            maps[g] = malloc(256u * sizeof(uint32_t));
+            if (maps[g] == NULL)
+                goto oom;
+            memset(maps[g], 0xFF, 256u * sizeof(uint32_t));
+        }
+        if (maps[g][id] != NO_SENSOR)
+        {
+            fprintf(stderr, "%s:%u: %s/%u is mapped twice\n", path, lineno, gw, id);
+            fclose(in);
+            return -1;
+        }
+        maps[g][id] = fleet_add(f, (uint16_t)g, (uint8_t)id, grp);
+        if (maps[g][id] == NO_SENSOR)
+            goto oom;
+    }
+    fclose(in);
+    return 0;
+
+oom:
+    fprintf(stderr, "out of memory\n");
+    fclose(in);
+    return -1;
+}
+
+static int read_capture(const char *path, fleet_t *f, const names_t *gateways, uint32_t *const *maps)
+{
+    char gw[128];
+    gateway_name(path, gw, sizeof(gw));
+    const uint32_t g = lookup(gateways, gw);
+    if (g == NO_SENSOR)
+    {
+        fprintf(stderr, "%s: no sensor of gateway \"%s\" in the mapping file\n", path, gw);
+        return -1;
+    }
+    FILE *in = fopen(path, "rb");
+    if (in == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+
+    static uint8_t buf[1u << 16];
+    ld2420_uplink_decoder_t dec;
+    ld2420_uplink_decoder_init(&dec);
+    capture_t c = {.fleet = f, .map = maps[g]};
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0)
+        ld2420_uplink_decode(&dec, buf, n, on_record, &c, NULL);
+    fclose(in);
+    fprintf(stderr, "%s: %u records, %u corrupt, %llu from unmapped sensors, %llu not report frames\n", path,
+            (unsigned)dec.records, (unsigned)dec.corrupt_records, (unsigned long long)c.unmapped,
+            (unsigned long long)c.other);
+    return 0;
+}
+
+/* ---- Synthetic fleet ---- */
+
+static void synthesize(const outlier_options_t *opt, fleet_t *f)
+{
+    uint32_t rng = opt->seed * 2654435761u + 1u;
+    const uint32_t groups = (opt->synthetic + opt->group_size - 1u) / opt->group_size;
+    for (uint32_t grp = 0; grp < groups; grp++)
+    {
+        // The room: a strong near field, a floor, a far wall and some furniture
+        uint32_t room[GATES + 3u];
+        const uint32_t wall = 8u + xorshift32(&rng) % 7u;
+        for (uint32_t g = 0; g < GATES + 3u; g++)
+            room[g] = 150u + xorshift32(&rng) % 300u;
+        room[0] = 20000u + xorshift32(&rng) % 20000u;
+        room[1] = 4000u + xorshift32(&rng) % 4000u;
+        room[wall] = 4000u + xorshift32(&rng) % 6000u;
+        room[3u + xorshift32(&rng) % 5u] += 1500u + xorshift32(&rng) % 2500u;
+
+        for (uint32_t m = 0; m < opt->group_size && f->count < opt->synthetic; m++)
+        {
+            const uint32_t s = fleet_add(f, (uint16_t)(f->count / 256u), (uint8_t)(f->count % 256u), grp);
+            if (s == NO_SENSOR)
+                return;
+            // One sensor in every 50 groups is broken, alternately in two ways
+            const bool broken = m == 0 && grp % 50u == 7u && opt->group_size >= MIN_GROUP;
+            const bool shifted = broken && (grp / 50u) % 2u == 0;
+            const bool dead = broken && !shifted;
+            f->injected[s] = broken;
+
+            const uint32_t gain = 90u + xorshift32(&rng) % 21u; // percent
+            uint32_t profile[GATES];
+            for (uint32_t g = 0; g < GATES; g++)
+            {
+                profile[g] = room[shifted ? g + 3u : g] * gain / 100u;
+                if (dead && g >= 10u)
+                    profile[g] = 5u;
+            }
+
+            ld2420_report_energy_t r = {.presence = 0, .distance_cm = 0};
+            for (uint32_t k = 0; k < opt->frames; k++)
+            {
+                for (uint32_t g = 0; g < GATES; g++)
+                {
+                    const uint32_t e = profile[g] * (80u + xorshift32(&rng) % 41u) / 100u;
+                    r.energy[g] = (uint16_t)(e > UINT16_MAX ? UINT16_MAX : e);
+                }
+                ld2420_report_energy_encode(chunk_slot(f, s), &r);
+            }
+        }
+    }
+}
+
+/* ---- Scoring ---- */
+
+/** Distance between a profile and a group centre. */
+static float distance(const float *p, const float *c, metric_t metric)
+{
+#ifdef OUTLIER_SSE2
+    __m128 acc = _mm_setzero_ps();
+    for (uint32_t k = 0; k < GATES; k += 4u)
+    {
+        const __m128 a = _mm_load_ps(p + k);
+        const __m128 b = _mm_load_ps(c + k);
+        if (metric == METRIC_L2)
+        {
+            const __m128 d = _mm_sub_ps(a, b);
+            acc = _mm_add_ps(acc, _mm_mul_ps(d, d));
+        }
+        else
+            acc = _mm_add_ps(acc, _mm_mul_ps(a, b));
+    }
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    const float sum = _mm_cvtss_f32(acc);
+#else
+    float sum = 0.0f;
+    for (uint32_t g = 0; g < GATES; g++)
+        sum += metric == METRIC_L2 ? (p[g] - c[g]) * (p[g] - c[g]) : p[g] * c[g];
+#endif
+    return metric == METRIC_L2 ? sqrtf(sum) : 1.0f - sum;
+}
+
+/** Centre and scale a profile to unit length; a flat profile becomes all zero. */
+static void normalize(float *p)
+{
+    float mean = 0.0f, norm = 0.0f;
+    for (uint32_t g = 0; g < GATES; g++)
+        mean += p[g];
+    mean /= (float)GATES;
+    for (uint32_t g = 0; g < GATES; g++)
+    {
+        p[g] -= mean;
+        norm += p[g] * p[g];
+    }
+    const float scale = norm > 0.0f ? 1.0f / sqrtf(norm) : 0.0f;
+    for (uint32_t g = 0; g < GATES; g++)
+        p[g] *= scale;
+}
+
+static int cmp_float(const void *a, const void *b)
+{
+    const float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+static float median(float *v, uint32_t n)
+{
+    qsort(v, n, sizeof(*v), cmp_float);
+    return n % 2u ? v[n / 2u] : 0.5f * (v[n / 2u - 1u] + v[n / 2u]);
+}
+
+static const fleet_t *sort_fleet;
+
+static int cmp_group(const void *a, const void *b)
+{
+    const uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    const uint32_t gx = sort_fleet->group[x], gy = sort_fleet->group[y];
+    return gx != gy ? (gx > gy) - (gx < gy) : (x > y) - (x < y);
+}
+
+static int cmp_score(const void *a, const void *b)
+{
+    const float x = sort_fleet->score[*(const uint32_t *)a], y = sort_fleet->score[*(const uint32_t *)b];
+    return (x < y) - (x > y);
+}
+
+/**
+ * Score every sensor against its group. Returns the ranked sensor indices
+ * (highest score first) in *ranked and their number, or -1.
+ */
+static int64_t score_fleet(const outlier_options_t *opt, fleet_t *f, float *centres, uint32_t **ranked,
+                           uint32_t *out_groups, uint32_t *out_small)
+{
+    uint32_t *order = malloc((size_t)f->count * sizeof(*order));
+    uint32_t *result = malloc((size_t)f->count * sizeof(*result));
+    float *column = malloc((size_t)f->count * sizeof(*column));
+    if (order == NULL || result == NULL || column == NULL)
+    {
+        free(order);
+        free(result);
+        free(column);
+        return -1;
+    }
+
+    // Profiles of the sensors with enough frames, grouped together
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < f->count; i++)
+    {
+        f->score[i] = 0.0f;
+        f->distance[i] = 0.0f;
+        if (f->frames[i] < opt->min_frames || f->frames[i] == 0)
+            continue;
+        float *p = &f->profile[(size_t)i * GATES];
+        for (uint32_t g = 0; g < GATES; g++)
+            p[g] = log2f(1.0f + (float)f->sums[(size_t)i * GATES + g] / (float)f->frames[i]);
+        if (opt->metric == METRIC_COSINE)
+            normalize(p);
+        order[used++] = i;
+    }
+    sort_fleet = f;
+    qsort(order, used, sizeof(*order), cmp_group);
+
+    uint32_t ranked_count = 0, groups = 0, small = 0;
+    for (uint32_t start = 0; start < used;)
+    {
+        uint32_t end = start;
+        while (end < used && f->group[order[end]] == f->group[order[start]])
+            end++;
+        const uint32_t n = end - start;
+        const uint32_t *members = &order[start];
+        start = end;
+        if (n < MIN_GROUP)
+        {
+            small++;
+            continue;
+        }
+        groups++;
+
+        float *centre = &centres[(size_t)f->group[members[0]] * GATES];
+        for (uint32_t g = 0; g < GATES; g++)
+        {
+            for (uint32_t k = 0; k < n; k++)
+                column[k] = f->profile[(size_t)members[k] * GATES + g];
+            centre[g] = median(column, n);
+        }
+        if (opt->metric == METRIC_COSINE)
+            normalize(centre);
+
+        for (uint32_t k = 0; k < n; k++)
+        {
+            column[k] = distance(&f->profile[(size_t)members[k] * GATES], centre, opt->metric);
+            f->distance[members[k]] = column[k];
+        }
+        float spread = median(column, n);
+        if (spread < opt->min_spread)
+            spread = opt->min_spread;
+        for (uint32_t k = 0; k < n; k++)
+        {
+            f->score[members[k]] = f->distance[members[k]] / spread;
+            result[ranked_count++] = members[k];
+        }
+    }
+    qsort(result, ranked_count, sizeof(*result), cmp_score);
+
+    free(order);
+    free(column);
+    *ranked = result;
+    *out_groups = groups;
+    *out_small = small;
+    return ranked_count;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s --groups FILE CAPTURE...\n"
+            "       %s --synthetic N [--group-size N] [--frames N] [--seed N] [--check]\n"
+            "       common: [--metric l2|cosine] [--top N] [--min-frames N] [--min-spread X] [--threshold X]\n",
+            argv0, argv0);
+}
+
+int main(int argc, char **argv)
+{
+    outlier_options_t opt = {
+        .group_size = 8,
+        .frames = 20,
+        .seed = 1,
+        .metric = METRIC_L2,
+        .top = 20,
+        .min_frames = 10,
+        .min_spread = 0.25f,
+        .threshold = 4.0f,
+    };
+    const char **captures = calloc((size_t)argc, sizeof(*captures));
+    int capture_count = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--check") == 0)
+            opt.check = true;
+        else if (i + 1 < argc && strcmp(argv[i], "--groups") == 0)
+            opt.groups_path = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--synthetic") == 0)
+            opt.synthetic = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--group-size") == 0)
+            opt.group_size = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--frames") == 0)
+            opt.frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--seed") == 0)
+            opt.seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--top") == 0)
+            opt.top = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--min-frames") == 0)
+            opt.min_frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--min-spread") == 0)
+            opt.min_spread = strtof(argv[++i], NULL);
+        else if (i + 1 < argc && strcmp(argv[i], "--threshold") == 0)
+            opt.threshold = strtof(argv[++i], NULL);
+        else if (i + 1 < argc && strcmp(argv[i], "--metric") == 0)
+        {
+            const char *m = argv[++i];
+            if (strcmp(m, "l2") == 0)
+                opt.metric = METRIC_L2;
+            else if (strcmp(m, "cosine") == 0)
+                opt.metric = METRIC_COSINE;
+            else
+            {
+                usage(argv[0]);
+                return 2;
+            }
+        }
+        else if (argv[i][0] != '-')
+            captures[capture_count++] = argv[i];
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    const bool from_files = opt.groups_path != NULL;
+    if (from_files == (opt.synthetic != 0) || from_files != (capture_count > 0) || opt.group_size == 0 || opt.frames == 0 ||
+        (opt.check && from_files) || !(opt.min_spread > 0.0f))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    static fleet_t fleet;
+    names_t gateways = {0}, groups = {0};
+    static uint32_t *maps[UINT16_MAX + 1u];
+
+    const double t0 = now_s();
+    if (from_files)
+    {
+        if (load_groups(opt.groups_path, &fleet, &gateways, &groups, maps) != 0)
+            return 1;
+        for (int i = 0; i < capture_count; i++)
+            if (read_capture(captures[i], &fleet, &gateways, maps) != 0)
+                return 1;
+    }
+    else
+        synthesize(&opt, &fleet);
+    chunk_flush(&fleet);
+    const double t1 = now_s();
+
+    const uint32_t group_count = from_files ? groups.count : (opt.synthetic + opt.group_size - 1u) / opt.group_size;
+    float *centres = aligned_alloc(16, ((size_t)group_count * GATES * sizeof(float) + 15u) & ~(size_t)15u);
+    fleet.profile = aligned_alloc(16, ((size_t)fleet.count * GATES * sizeof(float) + 15u) & ~(size_t)15u);
+    if (fleet.count == 0 || centres == NULL || fleet.profile == NULL)
+    {
+        fprintf(stderr, fleet.count == 0 ? "no sensors\n" : "out of memory\n");
+        return 1;
+    }
+    uint32_t *ranked = NULL, scored_groups = 0, small_groups = 0;
+    const int64_t scored = score_fleet(&opt, &fleet, centres, &ranked, &scored_groups, &small_groups);
+    if (scored < 0)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    const double t2 = now_s();
+
+    printf("%-5s %-16s %-6s %-16s %8s %8s %8s %5s\n", "rank", "gateway", "sensor", "group", "score", "distance",
+           "frames", "gate");
+    for (uint32_t r = 0; r < opt.top && r < (uint32_t)scored; r++)
+    {
+        const uint32_t s = ranked[r];
+        const float *p = &fleet.profile[(size_t)s * GATES];
+        const float *c = &centres[(size_t)fleet.group[s] * GATES];
+        uint32_t worst = 0;
+        for (uint32_t g = 1; g < GATES; g++)
+            if (fabsf(p[g] - c[g]) > fabsf(p[worst] - c[worst]))
+                worst = g;
+        char gw[32];
+        if (from_files)
+            snprintf(gw, sizeof(gw), "%s", gateways.names[fleet.gateway[s]]);
+        else
+            snprintf(gw, sizeof(gw), "sim%05u", fleet.gateway[s]);
+        char grp[32];
+        if (from_files)
+            snprintf(grp, sizeof(grp), "%s", groups.names[fleet.group[s]]);
+        else
+            snprintf(grp, sizeof(grp), "room%06u", fleet.group[s]);
+        printf("%-5u %-16s %-6u %-16s %8.2f %8.3f %8u %5u\n", r + 1u, gw, fleet.sensor_id[s], grp,
+               (double)fleet.score[s], (double)fleet.distance[s], fleet.frames[s], worst);
+    }
+
+    uint32_t above = 0;
+    for (int64_t r = 0; r < scored && fleet.score[ranked[r]] >= opt.threshold; r++)
+        above++;
+    fprintf(stderr,
+            "%u sensors, %llu report frames; %lld scored in %u groups (%u groups too small or silent)\n"
+            "%u sensors score %.1f or more; decode %.3f s (%.1f Mframes/s), scoring %.3f s\n",
+            fleet.count, (unsigned long long)chunk.total, (long long)scored, scored_groups, small_groups, above,
+            (double)opt.threshold, t1 - t0, (double)chunk.total / (t1 - t0) / 1e6, t2 - t1);
+
+    int rc = 0;
+    if (opt.check)
+    {
+        // Every injected sensor must rank above every healthy one
+        uint32_t injected = 0;
+        for (uint32_t i = 0; i < fleet.count; i++)
+            injected += fleet.injected[i] ? 1u : 0u;
+        uint32_t found = 0;
+        while (found < injected && found < (uint32_t)scored && fleet.injected[ranked[found]])
+            found++;
+        if (injected == 0 || found != injected)
+        {
+            fprintf(stderr, "FAIL: %u of %u injected outliers ranked on top\n", found, injected);
+            rc = 1;
+        }
+        else
+            fprintf(stderr, "OK: all %u injected outliers ranked on top\n", injected);
+    }
+
+    free(ranked);
+    free(centres);
+    free(captures);
+    return rc;
+}
@@ -0,0 +1,557 @@
+/*
+ * LD2420 scene simulator
+ * ----------------------
+ * Generates report frames whose gate energies look like a room seen by the
+ * sensor, for benchmarking presence and calibration pipelines without
+ * hardware. Every sensor has its own room:
+ *
+ * - Noise floor: per gate, triangular around --noise-floor, raised on the
+ *   first two gates where the antenna near field leaks in.
+ * - Static clutter: --clutter reflectors (furniture, walls) at fixed gates
+ *   with a constant energy and a little jitter.
+ * - Targets: up to --targets people walk in from the far end, walk to random
+ *   spots, stand there breathing for a while, and leave again. Energy falls
+ *   off with the square of the range and is spread over the two gates around
+ *   the target, with weak side lobes on the gates next to those.
+ * - Multipath: each target has a ghost from the bounce off a side wall. Its
+ *   path is longer than the direct one, so it shows up a little further out,
+ *   with --multipath percent of the energy.
+ *
+ * Presence and distance in the frames are the ground truth: whether anyone is
+ * in the room, and the range of the nearest target. Pipelines that detect
+ * presence from the energies can be scored against them.
+ *
+ * The model uses integer arithmetic only and one PRNG per sensor seeded from
+ * --seed, so a run produces the same bytes on every compiler and host. The
+ * FNV-1a digest printed at the end covers every frame and can be compared
+ * across commits.
+ *
+ * Usage: ld2420_scene [--sensors N] [--seconds S] [--rate HZ] [--targets N]
+ *                     [--noise-floor E] [--clutter N] [--multipath PERCENT]
+ *                     [--seed N] [--format none|frames|uplink|ascii]
+ *                     [--output PATH] [--verify]
+ *
+ * Output formats (written to --output, default stdout):
+ * - frames: report frames back to back; per tick, one frame per sensor in
+ *   sensor order.
+ * - uplink: every frame in an uplink record whose sensor id is the sensor
+ *   index (mod 256) and whose timestamp is the simulated time.
+ * - ascii:  the sensor's simple text output, "ON" plus "Range <cm>" or
+ *   "OFF". With several sensors, each line starts with the sensor index.
+ *
+ * --verify decodes every frame again and reruns the whole simulation to check
+ * that it is deterministic. The summary goes to stderr.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_batch.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/ld2420_uplink.h>
+
+#define SCENE_MAX_TARGETS 4u
+#define SCENE_MAX_CLUTTER 8u
+
+/** Width of one range gate. */
+#define SCENE_GATE_MM 700
+/** Closest range the sensor resolves. */
+#define SCENE_MIN_RANGE_MM 200
+/** Energy of an adult walking at 1 m. */
+#define SCENE_TARGET_ENERGY 40000u
+/** Share of the walking energy left while standing (percent), plus breathing. */
+#define SCENE_STILL_PERCENT 12u
+#define SCENE_BREATH_PERCENT 8u
+/** Breathing period in ticks is rate * this / 10 (about four seconds). */
+#define SCENE_BREATH_PERIOD_DS 40u
+
+typedef enum
+{
+    FORMAT_NONE,
+    FORMAT_FRAMES,
+    FORMAT_UPLINK,
+    FORMAT_ASCII,
+} scene_format_t;
+
+typedef struct
+{
+    uint32_t sensors;
+    uint32_t seconds;
+    uint32_t rate_hz;
+    uint32_t targets;
+    uint32_t noise_floor;
+    uint32_t clutter;
+    uint32_t multipath_percent;
+    uint32_t seed;
+    scene_format_t format;
+    const char *output;
+    bool verify;
+} scene_options_t;
+
+typedef struct
+{
+    /** Range from the sensor; only meaningful while present. */
+    int32_t range_mm;
+    /** Where the target walks to; beyond the room means it is leaving. */
+    int32_t goal_mm;
+    /** Walking speed. */
+    int32_t speed_mm_s;
+    /** Ticks left standing still; 0 while walking. */
+    uint32_t dwell_ticks;
+    /** Reflectivity relative to an adult, in percent. */
+    uint32_t rcs_percent;
+    bool present;
+} scene_target_t;
+
+typedef struct
+{
+    uint32_t rng;
+    /** Distance to the far wall. */
+    int32_t room_mm;
+    /** Distance from the sensor axis to the side wall that makes the ghosts. */
+    int32_t side_wall_mm;
+    uint32_t clutter_count;
+    uint8_t clutter_gate[SCENE_MAX_CLUTTER];
+    uint16_t clutter_energy[SCENE_MAX_CLUTTER];
+    scene_target_t targets[SCENE_MAX_TARGETS];
+} scene_sensor_t;
+
+typedef struct
+{
+    uint64_t frames;
+    uint64_t present_frames;
+    uint64_t digest;
+    uint64_t decode_errors;
+} scene_result_t;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/** Uniform in [lo, hi]. */
+static uint32_t uniform(uint32_t *rng, uint32_t lo, uint32_t hi)
+{
+    return lo + xorshift32(rng) % (hi - lo + 1u);
+}
+
+static uint32_t isqrt64(uint64_t x)
+{
+    uint64_t r = 0, bit = 1ull << 62;
+    while (bit > x)
+        bit >>= 2;
+    while (bit != 0)
+    {
+        if (x >= r + bit)
+        {
+            x -= r + bit;
+            r = (r >> 1) + bit;
+        }
+        else
+            r >>= 1;
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+static uint64_t fnv1a(uint64_t h, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        h ^= data[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+static void add_energy(uint32_t energy[LD2420_REPORT_GATES], int32_t gate, uint32_t amount)
+{
+    if (gate >= 0 && gate < (int32_t)LD2420_REPORT_GATES)
+        energy[gate] += amount;
+}
+
+/** Spread an echo of `amplitude` (energy at 1 m) from `range_mm` over the gates. */
+static void add_echo(uint32_t energy[LD2420_REPORT_GATES], int32_t range_mm, uint32_t amplitude)
+{
+    const uint64_t r = (uint64_t)(range_mm < 500 ? 500 : range_mm);
+    const uint32_t e = (uint32_t)((uint64_t)amplitude * 1000000ull / (r * r));
+
+    // Position in gates, 8 fractional bits
+    const int32_t pos = (int32_t)(((int64_t)range_mm << 8) / SCENE_GATE_MM);
+    const int32_t gate = pos >> 8;
+    const uint32_t frac = (uint32_t)pos & 0xFFu;
+    const uint32_t main_lobe = e - e / 4u;
+    const uint32_t near = (uint32_t)((uint64_t)main_lobe * (256u - frac) >> 8);
+
+    add_energy(energy, gate, near);
+    add_energy(energy, gate + 1, main_lobe - near);
+    add_energy(energy, gate - 1, e / 8u);
+    add_energy(energy, gate + 2, e / 8u);
+}
+
+static void scene_sensor_init(scene_sensor_t *s, const scene_options_t *opt, uint32_t index)
+{
+    memset(s, 0, sizeof(*s));
+    // Different seeds per sensor; xorshift32 must not start at 0
+    s->rng = (opt->seed ^ (index * 0x9E3779B9u)) | 1u;
+    for (int i = 0; i < 4; i++)
+        xorshift32(&s->rng);
+
+    s->room_mm = (int32_t)uniform(&s->rng, 3000, 8000);
+    s->side_wall_mm = (int32_t)uniform(&s->rng, 800, 2500);
+    s->clutter_count = opt->clutter;
+    for (uint32_t c = 0; c < s->clutter_count; c++)
+    {
+        // Reflectors sit inside the room; the far wall is always one of them
+        const int32_t range = c == 0 ? s->room_mm : (int32_t)uniform(&s->rng, SCENE_MIN_RANGE_MM, (uint32_t)s->room_mm);
+        const uint64_t r = (uint64_t)(range < 500 ? 500 : range);
+        s->clutter_gate[c] = (uint8_t)(range / SCENE_GATE_MM);
+        const uint64_t energy = uniform(&s->rng, 5000, 30000) * 1000000ull / (r * r) + opt->noise_floor;
+        s->clutter_energy[c] = (uint16_t)(energy > UINT16_MAX ? UINT16_MAX : energy);
+    }
+    for (uint32_t t = 0; t < opt->targets; t++)
+        s->targets[t].rcs_percent = uniform(&s->rng, 50, 140);
+}
+
+/** Move the targets of one sensor by one tick. */
+static void scene_move_targets(scene_sensor_t *s, const scene_options_t *opt)
+{
+    for (uint32_t t = 0; t < opt->targets; t++)
+    {
+        scene_target_t *tg = &s->targets[t];
+        if (!tg->present)
+        {
+            // Someone comes in about every 20 seconds per slot
+            if (xorshift32(&s->rng) % (opt->rate_hz * 20u) == 0)
+            {
+                tg->present = true;
+                tg->range_mm = s->room_mm;
+                tg->goal_mm = (int32_t)uniform(&s->rng, SCENE_MIN_RANGE_MM + 300u, (uint32_t)s->room_mm);
+                tg->speed_mm_s = (int32_t)uniform(&s->rng, 400, 1400);
+                tg->dwell_ticks = 0;
+            }
+            continue;
+        }
+
+        if (tg->dwell_ticks > 0)
+        {
+            if (--tg->dwell_ticks == 0)
+            {
+                // One in four leaves, the others walk somewhere else
+                if (xorshift32(&s->rng) % 4u == 0)
+                    tg->goal_mm = s->room_mm + 500;
+                else
+                    tg->goal_mm = (int32_t)uniform(&s->rng, SCENE_MIN_RANGE_MM + 300u, (uint32_t)s->room_mm);
+                tg->speed_mm_s = (int32_t)uniform(&s->rng, 400, 1400);
+            }
+            continue;
+        }
+
+        const int32_t step = tg->speed_mm_s / (int32_t)opt->rate_hz;
+        const int32_t delta = tg->goal_mm - tg->range_mm;
+        if (delta > step)
+            tg->range_mm += step;
+        else if (delta < -step)
+            tg->range_mm -= step;
+        else
+        {
+            tg->range_mm = tg->goal_mm;
+            if (tg->goal_mm > s->room_mm)
+                tg->present = false;
+            else
+                tg->dwell_ticks = uniform(&s->rng, 2u * opt->rate_hz, 30u * opt->rate_hz);
+        }
+    }
+}
+
+/** Produce the report of one sensor for tick `tick`. */
+static void scene_report(scene_sensor_t *s, const scene_options_t *opt, uint64_t tick, ld2420_report_energy_t *report)
+{
+    uint32_t energy[LD2420_REPORT_GATES];
+    for (uint32_t g = 0; g < LD2420_REPORT_GATES; g++)
+    {
+        const uint32_t floor = opt->noise_floor * (g == 0 ? 4u : g == 1 ? 2u : 1u);
+        // Sum of two uniforms: triangular between 0.5 and 1.5 times the floor
+        const uint32_t shape = 64u + (xorshift32(&s->rng) & 63u) + (xorshift32(&s->rng) & 63u);
+        energy[g] = floor * shape / 128u;
+    }
+    for (uint32_t c = 0; c < s->clutter_count; c++)
+        add_energy(energy, s->clutter_gate[c], s->clutter_energy[c] * uniform(&s->rng, 240, 271) / 256u);
+
+    const uint32_t breath_period = opt->rate_hz * SCENE_BREATH_PERIOD_DS / 10u;
+    int32_t nearest = INT32_MAX;
+    for (uint32_t t = 0; t < opt->targets; t++)
+    {
+        const scene_target_t *tg = &s->targets[t];
+        if (!tg->present)
+            continue;
+
+        uint32_t motion = 100u;
+        if (tg->dwell_ticks > 0)
+        {
+            // Chest movement: triangle wave over the breathing period
+            const uint32_t phase = (uint32_t)((tick + t * 7u) % breath_period);
+            const uint32_t tri = phase < breath_period / 2u ? phase : breath_period - phase;
+            motion = SCENE_STILL_PERCENT + SCENE_BREATH_PERCENT * 2u * tri / breath_period;
+        }
+        const uint32_t amplitude = SCENE_TARGET_ENERGY / 100u * tg->rcs_percent * motion / 100u;
+        add_echo(energy, tg->range_mm, amplitude);
+        if (tg->range_mm < nearest)
+            nearest = tg->range_mm;
+
+        if (opt->multipath_percent > 0)
+        {
+            // Out via the target, back via the side wall: the apparent range is
+            // half the total path
+            const uint64_t r = (uint64_t)tg->range_mm, w = (uint64_t)s->side_wall_mm;
+            const int32_t ghost = (int32_t)((r + isqrt64(r * r + 4u * w * w)) / 2u);
+            add_echo(energy, ghost, amplitude / 100u * opt->multipath_percent);
+        }
+    }
+
+    for (uint32_t g = 0; g < LD2420_REPORT_GATES; g++)
+        report->energy[g] = (uint16_t)(energy[g] > UINT16_MAX ? UINT16_MAX : energy[g]);
+    report->presence = nearest != INT32_MAX;
+    report->distance_cm = report->presence ? (uint16_t)(nearest / 10) : 0;
+}
+
+static bool write_all(FILE *out, const void *data, size_t len)
+{
+    return fwrite(data, 1, len, out) == len;
+}
+
+/** Write one report in the selected format. */
+static bool emit(FILE *out, const scene_options_t *opt, uint32_t sensor, uint64_t tick,
+                 const uint8_t *frame, const ld2420_report_energy_t *report, uint8_t *sequence)
+{
+    switch (opt->format)
+    {
+    case FORMAT_FRAMES:
+        return write_all(out, frame, LD2420_REPORT_ENERGY_SIZE);
+    case FORMAT_UPLINK:
+    {
+        uint8_t record[LD2420_UPLINK_OVERHEAD + LD2420_REPORT_ENERGY_SIZE];
+        const ld2420_uplink_record_t rec = {
+            .sensor_id = (uint8_t)sensor,
+            .kind = LD2420_UPLINK_KIND_FRAME,
+            .sequence = (*sequence)++,
+            .timestamp_us = (uint32_t)(tick * 1000000u / opt->rate_hz),
+            .payload = frame,
+            .payload_size = LD2420_REPORT_ENERGY_SIZE,
+        };
+        size_t written = 0;
+        return ld2420_uplink_encode(&rec, record, sizeof(record), &written) == LD2420_STATUS_OK &&
+               write_all(out, record, written);
+    }
+    case FORMAT_ASCII:
+    {
+        char line[48];
+        int n = 0;
+        const char *prefix_fmt = opt->sensors > 1 ? "%u\t" : "";
+        if (report->presence)
+        {
+            n = snprintf(line, sizeof(line), prefix_fmt, sensor);
+            n += snprintf(line + n, sizeof(line) - (size_t)n, "ON\r\n");
+            n += snprintf(line + n, sizeof(line) - (size_t)n, prefix_fmt, sensor);
+            n += snprintf(line + n, sizeof(line) - (size_t)n, "Range %u\r\n", report->distance_cm);
+        }
+        else
+        {
+            n = snprintf(line, sizeof(line), prefix_fmt, sensor);
+            n += snprintf(line + n, sizeof(line) - (size_t)n, "OFF\r\n");
+        }
+        return write_all(out, line, (size_t)n);
+    }
+    case FORMAT_NONE:
+    default:
+        return true;
+    }
+}
+
+/** Run the whole simulation; out may be NULL to only compute the result. */
+static int scene_run(const scene_options_t *opt, FILE *out, scene_result_t *result)
+{
+    scene_sensor_t *sensors = malloc(opt->sensors * sizeof(*sensors));
+    if (sensors == NULL)
+    {
+        fprintf(stderr, "ERROR: out of memory\n");
+        return -1;
+    }
+    for (uint32_t i = 0; i < opt->sensors; i++)
+        scene_sensor_init(&sensors[i], opt, i);
+
+    memset(result, 0, sizeof(*result));
+    result->digest = 0xcbf29ce484222325ull;
+    uint8_t sequence = 0;
+    const uint64_t ticks = (uint64_t)opt->seconds * opt->rate_hz;
+    for (uint64_t tick = 0; tick < ticks; tick++)
+    {
+        for (uint32_t i = 0; i < opt->sensors; i++)
+        {
+            ld2420_report_energy_t report;
+            uint8_t frame[LD2420_REPORT_ENERGY_SIZE];
+            scene_move_targets(&sensors[i], opt);
+            scene_report(&sensors[i], opt, tick, &report);
+            ld2420_report_energy_encode(frame, &report);
+
+            result->frames++;
+            result->present_frames += report.presence;
+            result->digest = fnv1a(result->digest, frame, sizeof(frame));
+            if (opt->verify)
+            {
+                ld2420_report_energy_t decoded;
+                if (ld2420_report_energy_decode(frame, sizeof(frame), &decoded) != LD2420_STATUS_OK ||
+                    memcmp(&decoded.energy, &report.energy, sizeof(report.energy)) != 0 ||
+                    decoded.presence != report.presence || decoded.distance_cm != report.distance_cm)
+                    result->decode_errors++;
+            }
+            if (out != NULL && !emit(out, opt, i, tick, frame, &report, &sequence))
+            {
+                fprintf(stderr, "ERROR: write to %s failed\n", opt->output);
+                free(sensors);
+                return -1;
+            }
+        }
+    }
+    free(sensors);
+    return 0;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--sensors N] [--seconds S] [--rate HZ] [--targets N] [--noise-floor E]\n"
+            "          [--clutter N] [--multipath PERCENT] [--seed N]\n"
+            "          [--format none|frames|uplink|ascii] [--output PATH] [--verify]\n",
+            argv0);
+}
+
+int main(int argc, char **argv)
+{
+    scene_options_t opt = {
+        .sensors = 1,
+        .seconds = 60,
+        .rate_hz = 10,
+        .targets = 2,
+        .noise_floor = 150,
+        .clutter = 3,
+        .multipath_percent = 20,
+        .seed = 1,
+        .format = FORMAT_NONE,
+        .output = "-",
+        .verify = false,
+    };
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--sensors") == 0 && i + 1 < argc)
+            opt.sensors = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            opt.seconds = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+            opt.rate_hz = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--targets") == 0 && i + 1 < argc)
+            opt.targets = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--noise-floor") == 0 && i + 1 < argc)
+            opt.noise_floor = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--clutter") == 0 && i + 1 < argc)
+            opt.clutter = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--multipath") == 0 && i + 1 < argc)
+            opt.multipath_percent = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            opt.seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            opt.output = argv[++i];
+        else if (strcmp(argv[i], "--verify") == 0)
+            opt.verify = true;
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+        {
+            const char *f = argv[++i];
+            if (strcmp(f, "none") == 0)
+                opt.format = FORMAT_NONE;
+            else if (strcmp(f, "frames") == 0)
+                opt.format = FORMAT_FRAMES;
+            else if (strcmp(f, "uplink") == 0)
+                opt.format = FORMAT_UPLINK;
+            else if (strcmp(f, "ascii") == 0)
+                opt.format = FORMAT_ASCII;
+            else
+            {
+                usage(argv[0]);
+                return 2;
+            }
+        }
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (opt.sensors == 0 || opt.rate_hz == 0 || opt.rate_hz > 1000 || opt.targets > SCENE_MAX_TARGETS ||
+        opt.clutter > SCENE_MAX_CLUTTER || opt.noise_floor == 0 || opt.noise_floor > 4000 ||
+        opt.multipath_percent > 100)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE *out = NULL;
+    if (opt.format != FORMAT_NONE)
+    {
+        out = strcmp(opt.output, "-") == 0 ? stdout : fopen(opt.output, "wb");
+        if (out == NULL)
+        {
+            perror(opt.output);
+            return 1;
+        }
+        setvbuf(out, NULL, _IOFBF, 1u << 20);
+    }
+
+    scene_result_t result;
+    const uint64_t start = now_ns();
+    if (scene_run(&opt, out, &result) != 0)
+        return 1;
+    if (out != NULL && (fflush(out) != 0 || (out != stdout && fclose(out) != 0)))
+    {
+        fprintf(stderr, "ERROR: write to %s failed\n", opt.output);
+        return 1;
+    }
+    const double wall_s = (double)(now_ns() - start) / 1e9;
+    const double simulated_s = (double)opt.seconds * opt.sensors;
+
+    fprintf(stderr, "LD2420 scene (%u sensors, %u s at %u Hz, seed %u)\n", opt.sensors, opt.seconds, opt.rate_hz, opt.seed);
+    fprintf(stderr, "frames %llu, presence %.1f%%\n", (unsigned long long)result.frames,
+            result.frames ? 100.0 * (double)result.present_frames / (double)result.frames : 0.0);
+    fprintf(stderr, "%.0f sensor-seconds in %.3f s (%.0fx real time)\n", simulated_s, wall_s,
+            wall_s > 0 ? simulated_s / wall_s : 0.0);
+    fprintf(stderr, "digest %016llx\n", (unsigned long long)result.digest);
+
+    if (!opt.verify)
+        return 0;
+
+    scene_result_t again;
+    if (scene_run(&opt, NULL, &again) != 0)
+        return 1;
+    const bool ok = result.decode_errors == 0 && again.digest == result.digest && again.frames == result.frames;
+    fprintf(stderr, "verify: %llu decode errors, rerun digest %016llx: %s\n", (unsigned long long)result.decode_errors,
+            (unsigned long long)again.digest, ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
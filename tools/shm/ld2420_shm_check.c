@@ -0,0 +1,439 @@
+/*
+ * LD2420 shared-memory ring check
+ * -------------------------------
+ * Publishes frames into a shared-memory frame ring and reads them back in
+ * several consumer processes, one of which is deliberately slow.
+ *
+ * - Every frame carries its index, the time it was published and a pattern
+ *   derived from the index; frame sizes vary so that records wrap the ring at
+ *   every possible offset.
+ * - The producer publishes in bursts of `--burst` frames with a short pause in
+ *   between, so fast consumers go idle and must be woken.
+ * - Each consumer checks that records arrive in order and intact, and that
+ *   delivered + lost records account for everything published after its
+ *   first record. A record may only be damaged if the ring reported it torn.
+ * - The slow consumer must fall behind and see overruns.
+ * - One more consumer joins halfway through. It replays the frames kept per
+ *   port before it reads live: per port, the replay must end with the last
+ *   frame published before its first live record and hold as many frames as
+ *   were kept, and its first live record must be the next one (unless the
+ *   replay was torn or the consumer was overrun).
+ *
+ * It prints the publish rate, the wake-ups the producer issued and, per
+ * consumer, the records delivered and lost and the mean and worst latency from
+ * publish to callback.
+ *
+ * Usage: ld2420_shm_check [--consumers N] [--frames N] [--capacity BYTES]
+ *                         [--burst N]
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <ld2420/ld2420.h>
+#include <ld2420/platform/linux/ld2420_linux_shm.h>
+
+#define CHECK_MAX_CONSUMERS 16u
+#define CHECK_PORTS 64u
+
+/** Frame layout: header, index, publish time, pattern, footer. */
+#define CHECK_INDEX_OFFSET 8u
+#define CHECK_TIME_OFFSET 12u
+#define CHECK_PATTERN_OFFSET 20u
+#define CHECK_MIN_FRAME 24u
+#define CHECK_SIZE_SPREAD 40u
+
+/** A consumer that sees nothing for this long has failed. */
+#define CHECK_TIMEOUT_NS 10000000000ull
+
+typedef struct
+{
+    uint32_t consumers;
+    uint32_t frames;
+    uint32_t capacity;
+    uint32_t burst;
+} check_options_t;
+
+/** Result of one consumer, written to the result pipe in one piece. */
+typedef struct
+{
+    uint32_t consumer;
+    uint32_t timed_out;
+    uint64_t records;
+    uint64_t lost;
+    uint64_t overruns;
+    uint64_t torn;
+    uint64_t damaged;
+    uint64_t out_of_order;
+    uint64_t first_index;
+    uint64_t trailing_lost;
+    uint64_t latency_sum_ns;
+    uint64_t latency_max_ns;
+    uint32_t late;
+    uint64_t start_sequence;
+    uint64_t replayed;
+    uint64_t replay_torn;
+    uint64_t replay_bad;
+} consumer_result_t;
+
+typedef struct
+{
+    ld2420_linux_shm_consumer_t shm;
+    consumer_result_t result;
+    bool have_first;
+    bool have_last;
+    uint32_t last_index;
+    uint32_t replayed[CHECK_PORTS];
+    uint32_t replay_last[CHECK_PORTS];
+} consumer_state_t;
+
+static char ring_name[64];
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint16_t frame_size(uint32_t index)
+{
+    return (uint16_t)(CHECK_MIN_FRAME + (index * 7u) % CHECK_SIZE_SPREAD);
+}
+
+static uint8_t pattern(uint32_t index, uint32_t k)
+{
+    return (uint8_t)(index * 31u + k * 7u);
+}
+
+static void build_frame(uint8_t *frame, uint32_t index, uint64_t t)
+{
+    const uint16_t size = frame_size(index);
+    static const uint8_t HEADER[] = {0xFD, 0xFC, 0xFB, 0xFA};
+    static const uint8_t FOOTER[] = {0x04, 0x03, 0x02, 0x01};
+    memcpy(frame, HEADER, sizeof(HEADER));
+    frame[4] = (uint8_t)(size - 10u);
+    frame[5] = 0;
+    frame[6] = 0xFF;
+    frame[7] = 0x01;
+    memcpy(&frame[CHECK_INDEX_OFFSET], &index, 4);
+    memcpy(&frame[CHECK_TIME_OFFSET], &t, 8);
+    for (uint32_t k = CHECK_PATTERN_OFFSET; k < size - 4u; k++)
+        frame[k] = pattern(index, k);
+    memcpy(&frame[size - 4u], FOOTER, sizeof(FOOTER));
+}
+
+static bool frame_intact(uint32_t index, uint16_t port_index, const uint8_t *frame, uint16_t frame_size_bytes,
+                         uint16_t cmd_echo, uint16_t status)
+{
+    bool intact = frame_size_bytes == frame_size(index) && port_index == index % CHECK_PORTS &&
+                  cmd_echo == 0x01FF && status == frame_size_bytes;
+    for (uint32_t k = CHECK_PATTERN_OFFSET; intact && k < frame_size_bytes - 4u; k++)
+        intact = frame[k] == pattern(index, k);
+    return intact;
+}
+
+static void on_record(
+    void *user,
+    uint16_t port_index,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    consumer_state_t *state = (consumer_state_t *)user;
+    consumer_result_t *r = &state->result;
+    const uint64_t now = now_ns();
+
+    uint32_t index;
+    uint64_t t;
+    memcpy(&index, &frame[CHECK_INDEX_OFFSET], 4);
+    memcpy(&t, &frame[CHECK_TIME_OFFSET], 8);
+
+    // The ring numbers records in publish order, as the producer does indices
+    if (!state->have_first)
+        r->first_index = state->shm.next_sequence - 1u;
+    state->have_first = true;
+
+    if (index != state->shm.next_sequence - 1u ||
+        !frame_intact(index, port_index, frame, frame_size_bytes, cmd_echo, status))
+    {
+        r->damaged++;
+        return;
+    }
+
+    if (state->have_last && index <= state->last_index)
+        r->out_of_order++;
+    state->have_last = true;
+    state->last_index = index;
+
+    const uint64_t latency = now > t ? now - t : 0;
+    r->latency_sum_ns += latency;
+    if (latency > r->latency_max_ns)
+        r->latency_max_ns = latency;
+}
+
+static void on_replayed(
+    void *user,
+    uint16_t port_index,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    consumer_state_t *state = (consumer_state_t *)user;
+    uint32_t index;
+    memcpy(&index, &frame[CHECK_INDEX_OFFSET], 4);
+
+    // History only, oldest first, once
+    if (port_index >= CHECK_PORTS || !frame_intact(index, port_index, frame, frame_size_bytes, cmd_echo, status) ||
+        index >= state->shm.start_sequence ||
+        (state->replayed[port_index] > 0 && index <= state->replay_last[port_index]))
+    {
+        state->result.replay_bad++;
+        return;
+    }
+    state->replayed[port_index]++;
+    state->replay_last[port_index] = index;
+}
+
+/** Compare the replay with what the producer published before the seam. */
+static void check_replay(consumer_state_t *state)
+{
+    const uint64_t seam = state->shm.start_sequence;
+    for (uint32_t port = 0; port < CHECK_PORTS; port++)
+    {
+        const uint64_t before = seam > port ? (seam - 1u - port) / CHECK_PORTS + 1u : 0;
+        const uint64_t kept = before < LD2420_REPLAY_DEPTH ? before : LD2420_REPLAY_DEPTH;
+        if (state->replayed[port] != kept ||
+            (kept > 0 && state->replay_last[port] != port + (before - 1u) * CHECK_PORTS))
+            state->result.replay_bad++;
+    }
+}
+
+/** Read records until the producer is done and the ring is drained. */
+static int run_consumer(uint32_t id, bool slow, int late_fd, int ready_fd, int done_fd, int result_fd)
+{
+    static consumer_state_t state;
+    memset(&state, 0, sizeof(state));
+    state.result.consumer = id;
+    const char ready = 'r';
+    char go;
+    if (late_fd >= 0 && (write(ready_fd, &ready, 1) != 1 || read(late_fd, &go, 1) != 1))
+        return 1;
+    if (ld2420_linux_shm_consumer_open(&state.shm, ring_name) != LD2420_STATUS_OK)
+    {
+        perror("ld2420_linux_shm_consumer_open");
+        return 1;
+    }
+    if (late_fd < 0 && write(ready_fd, &ready, 1) != 1)
+        return 1;
+    if (late_fd >= 0)
+    {
+        state.result.late = 1;
+        state.result.start_sequence = state.shm.start_sequence;
+        ld2420_linux_shm_replay(&state.shm, on_replayed, &state);
+        if (state.shm.replay_torn == 0)
+            check_replay(&state);
+    }
+
+    bool done = false;
+    uint64_t published = 0;
+    uint64_t deadline = now_ns() + CHECK_TIMEOUT_NS;
+    for (;;)
+    {
+        const int n = ld2420_linux_shm_consume(&state.shm, on_record, &state, slow ? 16u : 256u);
+        if (n > 0)
+        {
+            deadline = now_ns() + CHECK_TIMEOUT_NS;
+            if (slow)
+                nanosleep(&(struct timespec){0, 1000000L}, NULL);
+            continue;
+        }
+
+        if (!done && read(done_fd, &published, sizeof(published)) == (ssize_t)sizeof(published))
+            done = true;
+        if (done && __atomic_load_n(&state.shm.ring->head, __ATOMIC_ACQUIRE) == state.shm.cursor)
+            break;
+        if (now_ns() > deadline)
+        {
+            state.result.timed_out = 1;
+            break;
+        }
+        ld2420_linux_shm_wait(&state.shm, 20);
+    }
+
+    state.result.records = state.shm.records;
+    state.result.lost = state.shm.lost_records;
+    state.result.overruns = state.shm.overruns;
+    state.result.torn = state.shm.torn;
+    state.result.replayed = state.shm.replayed;
+    state.result.replay_torn = state.shm.replay_torn;
+    // Records skipped by an overrun are only counted as lost when a later record
+    // is read; after the last overrun there is none
+    state.result.trailing_lost = published - state.shm.next_sequence;
+    ld2420_linux_shm_consumer_close(&state.shm);
+    return write(result_fd, &state.result, sizeof(state.result)) == (ssize_t)sizeof(state.result) ? 0 : 1;
+}
+
+static int usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--consumers N] [--frames N] [--capacity BYTES] [--burst N]\n",
+            argv0);
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    check_options_t opt = {.consumers = 3, .frames = 1000000, .capacity = 65536, .burst = 256};
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--consumers") == 0)
+            opt.consumers = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--frames") == 0)
+            opt.frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--capacity") == 0)
+            opt.capacity = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--burst") == 0)
+            opt.burst = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else
+            return usage(argv[0]);
+    }
+    if (opt.consumers < 2 || opt.consumers > CHECK_MAX_CONSUMERS || opt.frames == 0 || opt.burst == 0)
+        return usage(argv[0]);
+
+    snprintf(ring_name, sizeof(ring_name), "/ld2420-shm-check-%ld", (long)getpid());
+    static ld2420_linux_shm_publisher_t pub;
+    if (ld2420_linux_shm_publisher_open_replay(&pub, ring_name, opt.capacity, CHECK_PORTS, 0) != LD2420_STATUS_OK)
+    {
+        fprintf(stderr, "cannot create ring %s with %" PRIu32 " bytes: %s\n", ring_name, opt.capacity,
+                strerror(errno));
+        return 1;
+    }
+
+    int ready[2], done[2], results[2], late[2];
+    if (pipe(ready) != 0 || pipe(done) != 0 || pipe(results) != 0 || pipe(late) != 0)
+    {
+        perror("pipe");
+        ld2420_linux_shm_publisher_close(&pub, ring_name);
+        return 1;
+    }
+    fcntl(done[0], F_SETFL, fcntl(done[0], F_GETFL) | O_NONBLOCK);
+
+    // The last consumer is the slow one; one more opens halfway through
+    const uint32_t total = opt.consumers + 1u;
+    pid_t pids[CHECK_MAX_CONSUMERS + 1u];
+    for (uint32_t i = 0; i < total; i++)
+    {
+        pids[i] = fork();
+        if (pids[i] == 0)
+            _exit(run_consumer(i, i == opt.consumers - 1u, i == opt.consumers ? late[0] : -1, ready[1], done[0],
+                               results[1]));
+        if (pids[i] < 0)
+        {
+            perror("fork");
+            return 1;
+        }
+    }
+    for (uint32_t i = 0; i < total; i++)
+    {
+        char c;
+        if (read(ready[0], &c, 1) != 1)
+        {
+            fprintf(stderr, "FAIL: consumer %" PRIu32 " did not start\n", i);
+            return 1;
+        }
+    }
+
+    uint8_t frame[CHECK_MIN_FRAME + CHECK_SIZE_SPREAD];
+    const uint64_t start = now_ns();
+    for (uint32_t i = 0; i < opt.frames; i++)
+    {
+        build_frame(frame, i, now_ns());
+        ld2420_linux_shm_publish(&pub, (uint16_t)(i % CHECK_PORTS), frame, frame_size(i), 0x01FF, frame_size(i));
+        if ((i + 1u) % opt.burst == 0)
+            nanosleep(&(struct timespec){0, 100000L}, NULL);
+        if (i == opt.frames / 2u && write(late[1], "g", 1) != 1)
+            perror("write");
+    }
+    const uint64_t elapsed = now_ns() - start;
+
+    const uint64_t published = opt.frames;
+    for (uint32_t i = 0; i < total; i++)
+    {
+        if (write(done[1], &published, sizeof(published)) != (ssize_t)sizeof(published))
+            perror("write");
+    }
+
+    printf("published %" PRIu64 " frames in %.1f ms (%.2f Mframes/s including pauses), %" PRIu64 " wake-ups\n",
+           published, (double)elapsed / 1e6, (double)published * 1e3 / (double)elapsed, pub.wakeups);
+
+    bool ok = true;
+    bool slow_overrun = false;
+    for (uint32_t i = 0; i < total; i++)
+    {
+        consumer_result_t r;
+        if (read(results[0], &r, sizeof(r)) != (ssize_t)sizeof(r))
+        {
+            fprintf(stderr, "FAIL: missing consumer result\n");
+            ok = false;
+            break;
+        }
+        const uint64_t delivered = r.records - r.damaged;
+        printf("consumer %" PRIu32 "%s: records=%" PRIu64 " lost=%" PRIu64 " overruns=%" PRIu64 " torn=%" PRIu64
+               " latency mean=%.1f us max=%.1f us\n",
+               r.consumer, r.late ? " (late)" : r.consumer == opt.consumers - 1u ? " (slow)" : "", r.records,
+               r.lost + r.trailing_lost, r.overruns, r.torn,
+               delivered > 0 ? (double)r.latency_sum_ns / (double)delivered / 1e3 : 0.0,
+               (double)r.latency_max_ns / 1e3);
+
+        if (r.timed_out || r.records == 0 || r.out_of_order != 0 || r.damaged > r.torn ||
+            r.first_index + r.records + r.lost + r.trailing_lost != published ||
+            (r.trailing_lost > 0 && r.overruns == 0))
+        {
+            fprintf(stderr,
+                    "FAIL: consumer %" PRIu32 ": timed_out=%" PRIu32 " out_of_order=%" PRIu64 " damaged=%" PRIu64
+                    " first=%" PRIu64 " records+lost=%" PRIu64 "+%" PRIu64 " of %" PRIu64 "\n",
+                    r.consumer, r.timed_out, r.out_of_order, r.damaged, r.first_index, r.records + r.lost,
+                    r.trailing_lost, published);
+            ok = false;
+        }
+        if (r.late)
+        {
+            printf("consumer %" PRIu32 " (late): replayed=%" PRIu64 " torn=%" PRIu64 " before sequence %" PRIu64 "\n",
+                   r.consumer, r.replayed, r.replay_torn, r.start_sequence);
+            if (r.replay_bad > r.replay_torn || (r.replayed == 0 && r.replay_torn == 0) ||
+                (r.overruns == 0 && r.first_index != r.start_sequence))
+            {
+                fprintf(stderr,
+                        "FAIL: late consumer: %" PRIu64 " replay mismatches, first live %" PRIu64 " after replay before %" PRIu64
+                        "\n",
+                        r.replay_bad, r.first_index, r.start_sequence);
+                ok = false;
+            }
+        }
+        if (r.consumer == opt.consumers - 1u)
+            slow_overrun = r.overruns > 0 && r.lost > 0;
+    }
+    for (uint32_t i = 0; i < total; i++)
+        waitpid(pids[i], NULL, 0);
+    ld2420_linux_shm_publisher_close(&pub, ring_name);
+
+    if (ok && !slow_overrun)
+    {
+        fprintf(stderr, "FAIL: the slow consumer was never overrun\n");
+        ok = false;
+    }
+    fprintf(stderr, ok ? "OK\n" : "FAIL\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,772 @@
+/*
+ * LD2420 line sniffer
+ * -------------------
+ * Decodes both directions of tapped sensor lines: host commands on TX with
+ * ld2420_tx_stream_t, ACKs on RX with ld2420_stream_t, and pairs them with
+ * ld2420_correlator_t. Every transaction is printed as it completes, followed
+ * by per-command round-trip statistics.
+ *
+ * Input is uplink records (see ld2420_uplink.h) from a tap gateway whose UARTs
+ * listen on the TX and RX lines; their timestamps are the one clock both
+ * directions share. FRAME and BYTES records are fed to the parsers, OVERFLOW
+ * records reset the parser of that line.
+ *
+ * - Capture pairs: one file per direction, one pair per tap. Records of both
+ *   files are merged by timestamp.
+ * - --link: one live uplink (FIFO, configured tty or file) carrying many taps;
+ *   sensor id 2k is the TX line of tap k and 2k+1 its RX line. Records are
+ *   processed as they arrive.
+ * - --synthetic TAPS: generates capture pairs in memory with known commands,
+ *   round-trip times, failures and unanswered commands, interleaved reports
+ *   and noise, cut into records at random points and at idle gaps as a
+ *   gateway would. Prints the throughput and how many taps at 115200 baud
+ *   that is per core.
+ *
+ * Usage: ld2420_sniff [--quiet] [--timeout-ms N] TX RX [TX RX ...]
+ *        ld2420_sniff [--quiet] [--timeout-ms N] --link DEVICE|FILE
+ *        ld2420_sniff --synthetic TAPS [--transactions N] [--quiet] [--check]
+ *
+ * With --check the exit status is 1 unless the statistics of every tap match
+ * the generated traffic exactly and no ACK or byte went unexplained.
+ */
+
+#define _GNU_SOURCE
+
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/ld2420_sniff.h>
+#include <ld2420/ld2420_stream.h>
+#include <ld2420/ld2420_uplink.h>
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/** Taps on one --link: sensor ids 0..255 in pairs. */
+#define MAX_LINK_TAPS 128u
+
+/** Microseconds per byte at LD2420_BAUD_RATE (10 bits per character). */
+#define BYTE_TIME_US 87u
+
+/** A gateway sends what it has after this much line idle time. */
+#define IDLE_FLUSH_US 1000u
+
+typedef struct
+{
+    ld2420_tx_stream_t tx;
+    ld2420_stream_t rx;
+    ld2420_correlator_t corr;
+    unsigned index;
+    bool active;
+    /** Timestamp of the record being fed. */
+    uint32_t now_us;
+    /** Records with framing errors, per direction. */
+    uint32_t tx_errors;
+    uint32_t rx_errors;
+    uint32_t overflows;
+    uint64_t line_bytes;
+} tap_t;
+
+/** One decoded record of a capture; the payload lives in the capture's arena. */
+typedef struct
+{
+    uint32_t timestamp_us;
+    uint8_t kind;
+    uint32_t offset;
+    uint16_t size;
+} capture_record_t;
+
+typedef struct
+{
+    capture_record_t *records;
+    size_t count, cap;
+    uint8_t *arena;
+    size_t used, arena_cap;
+} capture_t;
+
+static bool quiet;
+
+/** The RX frame callback has no user pointer; the tap being fed. */
+static tap_t *rx_tap;
+
+static int usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--quiet] [--timeout-ms N] TX RX [TX RX ...]\n"
+            "       %s [--quiet] [--timeout-ms N] --link DEVICE|FILE\n"
+            "       %s --synthetic TAPS [--transactions N] [--quiet] [--check]\n",
+            argv0, argv0, argv0);
+    return 2;
+}
+
+static const char *command_name(uint16_t command)
+{
+    switch (command)
+    {
+    case LD2420_CMD_OPEN_CONFIG_MODE:
+        return "OPEN_CONFIG_MODE";
+    case LD2420_CMD_CLOSE_CONFIG_MODE:
+        return "CLOSE_CONFIG_MODE";
+    case LD2420_CMD_READ_VERSION_NUMBER:
+        return "READ_VERSION_NUMBER";
+    case LD2420_CMD_REBOOT:
+        return "REBOOT";
+    case LD2420_CMD_READ_CONFIG:
+        return "READ_CONFIG";
+    case LD2420_CMD_SET_CONFIG:
+        return "SET_CONFIG";
+    default:
+        return NULL;
+    }
+}
+
+static void print_transaction(void *user, const ld2420_sniff_transaction_t *t)
+{
+    const tap_t *tap = (const tap_t *)user;
+    if (quiet)
+        return;
+    const char *name = command_name(t->command);
+    char fallback[8];
+    if (name == NULL)
+    {
+        snprintf(fallback, sizeof(fallback), "0x%04X", t->command);
+        name = fallback;
+    }
+    if (t->answered)
+        printf("tap %u %10" PRIu32 " %-20s rtt %9.3f ms status 0x%04X\n", tap->index, t->command_time_us, name,
+               t->rtt_us / 1000.0, t->status);
+    else
+        printf("tap %u %10" PRIu32 " %-20s no ACK\n", tap->index, t->command_time_us, name);
+}
+
+static bool on_tx_command(void *user, const uint8_t *frame, uint16_t size, uint16_t command)
+{
+    (void)frame;
+    (void)size;
+    tap_t *tap = (tap_t *)user;
+    ld2420_correlator_command(&tap->corr, command, tap->now_us);
+    return true;
+}
+
+static bool on_rx_frame(const uint8_t *frame, uint16_t size, uint16_t cmd_echo, uint16_t status)
+{
+    (void)size;
+    (void)cmd_echo;
+    (void)status;
+    // The callback's echo and status are the low bytes; the correlator wants the words
+    ld2420_correlator_ack(&rx_tap->corr, ld2420_protocol_read_le16(frame + LD2420_ACK_CMD_ECHO_OFFSET),
+                          ld2420_protocol_read_le16(frame + LD2420_ACK_STATUS_OFFSET), rx_tap->now_us);
+    return true;
+}
+
+static void tap_init(tap_t *tap, unsigned index, uint32_t timeout_us)
+{
+    memset(tap, 0, sizeof(*tap));
+    tap->index = index;
+    tap->active = true;
+    ld2420_tx_stream_init(&tap->tx);
+    ld2420_stream_init(&tap->rx);
+    ld2420_correlator_init(&tap->corr, timeout_us, print_transaction, tap);
+}
+
+static void tap_feed(tap_t *tap, bool is_rx, uint8_t kind, uint32_t timestamp_us, const uint8_t *payload,
+                     uint16_t size)
+{
+    tap->now_us = timestamp_us;
+    if (kind == LD2420_UPLINK_KIND_OVERFLOW)
+    {
+        // Bytes of this line are missing: whatever was being assembled is lost
+        if (is_rx)
+            ld2420_stream_init(&tap->rx);
+        else
+            ld2420_tx_stream_init(&tap->tx);
+        tap->overflows++;
+        return;
+    }
+    if (kind != LD2420_UPLINK_KIND_FRAME && kind != LD2420_UPLINK_KIND_BYTES)
+        return;
+
+    tap->line_bytes += size;
+    if (is_rx)
+    {
+        rx_tap = tap;
+        if (ld2420_stream_feed_bytes(&tap->rx, payload, size, on_rx_frame, NULL) != LD2420_STATUS_OK)
+            tap->rx_errors++;
+    }
+    else if (ld2420_tx_stream_feed_bytes(&tap->tx, payload, size, on_tx_command, tap, NULL) != LD2420_STATUS_OK)
+    {
+        tap->tx_errors++;
+    }
+    ld2420_correlator_advance(&tap->corr, timestamp_us);
+}
+
+static void *grow(void *p, size_t *cap, size_t need, size_t elem)
+{
+    if (need <= *cap)
+        return p;
+    size_t n = *cap ? *cap : 1024;
+    while (n < need)
+        n *= 2;
+    void *q = realloc(p, n * elem);
+    if (q == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    *cap = n;
+    return q;
+}
+
+static bool capture_add(void *user, const ld2420_uplink_record_t *record)
+{
+    capture_t *c = (capture_t *)user;
+    c->records = grow(c->records, &c->cap, c->count + 1, sizeof(*c->records));
+    c->arena = grow(c->arena, &c->arena_cap, c->used + record->payload_size, 1);
+    if (record->payload_size > 0)
+        memcpy(c->arena + c->used, record->payload, record->payload_size);
+    c->records[c->count++] = (capture_record_t){
+        .timestamp_us = record->timestamp_us,
+        .kind = record->kind,
+        .offset = (uint32_t)c->used,
+        .size = record->payload_size,
+    };
+    c->used += record->payload_size;
+    return true;
+}
+
+static void capture_free(capture_t *c)
+{
+    free(c->records);
+    free(c->arena);
+    memset(c, 0, sizeof(*c));
+}
+
+/** Decode a whole uplink byte stream into c; the number of corrupt records. */
+static uint32_t capture_decode(capture_t *c, const uint8_t *data, size_t len)
+{
+    ld2420_uplink_decoder_t d;
+    ld2420_uplink_decoder_init(&d);
+    ld2420_uplink_decode(&d, data, len, capture_add, c, NULL);
+    return d.corrupt_records;
+}
+
+static bool capture_load(capture_t *c, const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        perror(path);
+        return false;
+    }
+    ld2420_uplink_decoder_t d;
+    ld2420_uplink_decoder_init(&d);
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+        ld2420_uplink_decode(&d, chunk, n, capture_add, c, NULL);
+    fclose(f);
+    if (d.corrupt_records > 0 || d.lost_records > 0)
+        fprintf(stderr, "%s: %" PRIu32 " corrupt and %" PRIu32 " lost uplink records\n", path, d.corrupt_records,
+                d.lost_records);
+    return true;
+}
+
+/** Feed the records of both captures of a tap in timestamp order; TX first on ties. */
+static void tap_replay(tap_t *tap, const capture_t *tx, const capture_t *rx)
+{
+    size_t i = 0, j = 0;
+    while (i < tx->count || j < rx->count)
+    {
+        const bool take_tx =
+            j == rx->count ||
+            (i < tx->count && (int32_t)(tx->records[i].timestamp_us - rx->records[j].timestamp_us) <= 0);
+        const capture_t *c = take_tx ? tx : rx;
+        const capture_record_t *r = &c->records[take_tx ? i++ : j++];
+        tap_feed(tap, !take_tx, r->kind, r->timestamp_us, c->arena + r->offset, r->size);
+    }
+    ld2420_correlator_flush(&tap->corr);
+}
+
+static void print_summary(const tap_t *taps, size_t count)
+{
+    ld2420_sniff_stats_t total[256];
+    memset(total, 0, sizeof(total));
+    uint32_t orphans = 0, tx_errors = 0, rx_errors = 0, overflows = 0;
+    for (size_t t = 0; t < count; t++)
+    {
+        if (!taps[t].active)
+            continue;
+        for (unsigned k = 0; k < 256u; k++)
+        {
+            const ld2420_sniff_stats_t *s = &taps[t].corr.stats[k];
+            ld2420_sniff_stats_t *d = &total[k];
+            if (s->commands == 0)
+                continue;
+            if (d->commands == 0 || s->min_rtt_us < d->min_rtt_us)
+                d->min_rtt_us = s->min_rtt_us;
+            if (s->max_rtt_us > d->max_rtt_us)
+                d->max_rtt_us = s->max_rtt_us;
+            d->commands += s->commands;
+            d->answered += s->answered;
+            d->failed += s->failed;
+            d->unanswered += s->unanswered;
+            d->sum_rtt_us += s->sum_rtt_us;
+        }
+        orphans += taps[t].corr.orphan_acks;
+        tx_errors += taps[t].tx_errors;
+        rx_errors += taps[t].rx_errors;
+        overflows += taps[t].overflows;
+    }
+
+    printf("%-20s %8s %8s %8s %8s %9s %9s %9s\n", "command", "count", "answered", "failed", "no ACK", "min ms",
+           "mean ms", "max ms");
+    for (unsigned k = 0; k < 256u; k++)
+    {
+        const ld2420_sniff_stats_t *s = &total[k];
+        if (s->commands == 0)
+            continue;
+        const char *name = command_name((uint16_t)k);
+        char fallback[8];
+        if (name == NULL)
+        {
+            snprintf(fallback, sizeof(fallback), "0x%04X", k);
+            name = fallback;
+        }
+        if (s->answered > 0)
+            printf("%-20s %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %9.3f %9.3f %9.3f\n", name, s->commands,
+                   s->answered, s->failed, s->unanswered, s->min_rtt_us / 1000.0,
+                   (double)s->sum_rtt_us / s->answered / 1000.0, s->max_rtt_us / 1000.0);
+        else
+            printf("%-20s %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %9s %9s %9s\n", name, s->commands,
+                   s->answered, s->failed, s->unanswered, "-", "-", "-");
+    }
+    printf("orphan ACKs %" PRIu32 ", records with TX errors %" PRIu32 ", RX errors %" PRIu32 ", overflows %" PRIu32
+           "\n",
+           orphans, tx_errors, rx_errors, overflows);
+}
+
+static int run_captures(char **paths, size_t pairs, uint32_t timeout_us)
+{
+    tap_t *taps = calloc(pairs, sizeof(*taps));
+    if (taps == NULL)
+        return 1;
+    int result = 0;
+    for (size_t t = 0; t < pairs && result == 0; t++)
+    {
+        capture_t tx = {0}, rx = {0};
+        if (capture_load(&tx, paths[2 * t]) && capture_load(&rx, paths[2 * t + 1]))
+        {
+            tap_init(&taps[t], (unsigned)t, timeout_us);
+            tap_replay(&taps[t], &tx, &rx);
+        }
+        else
+        {
+            result = 1;
+        }
+        capture_free(&tx);
+        capture_free(&rx);
+    }
+    if (result == 0)
+        print_summary(taps, pairs);
+    free(taps);
+    return result;
+}
+
+typedef struct
+{
+    tap_t *taps;
+    uint32_t timeout_us;
+} link_t;
+
+static bool on_link_record(void *user, const ld2420_uplink_record_t *record)
+{
+    link_t *link = (link_t *)user;
+    tap_t *tap = &link->taps[record->sensor_id / 2u];
+    if (!tap->active)
+        tap_init(tap, record->sensor_id / 2u, link->timeout_us);
+    tap_feed(tap, (record->sensor_id & 1u) != 0, record->kind, record->timestamp_us, record->payload,
+             record->payload_size);
+    return true;
+}
+
+static int run_link(const char *path, uint32_t timeout_us)
+{
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        perror(path);
+        return 1;
+    }
+    link_t link = {.taps = calloc(MAX_LINK_TAPS, sizeof(tap_t)), .timeout_us = timeout_us};
+    if (link.taps == NULL)
+    {
+        close(fd);
+        return 1;
+    }
+    ld2420_uplink_decoder_t d;
+    ld2420_uplink_decoder_init(&d);
+    uint8_t chunk[4096];
+    ssize_t n;
+    while ((n = read(fd, chunk, sizeof(chunk))) > 0)
+    {
+        ld2420_uplink_decode(&d, chunk, (size_t)n, on_link_record, &link, NULL);
+        fflush(stdout);
+    }
+    close(fd);
+    for (unsigned t = 0; t < MAX_LINK_TAPS; t++)
+        if (link.taps[t].active)
+            ld2420_correlator_flush(&link.taps[t].corr);
+    print_summary(link.taps, MAX_LINK_TAPS);
+    if (d.corrupt_records > 0 || d.lost_records > 0)
+        fprintf(stderr, "%s: %" PRIu32 " corrupt and %" PRIu32 " lost uplink records\n", path, d.corrupt_records,
+                d.lost_records);
+    free(link.taps);
+    return 0;
+}
+
+/* Synthetic traffic ------------------------------------------------------ */
+
+static uint32_t rng_state = 0x2420u;
+
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/** Bytes of one line with the time each one finished arriving. */
+typedef struct
+{
+    uint8_t *bytes;
+    uint32_t *time_us;
+    size_t len, cap, time_cap;
+} line_t;
+
+/** Append a frame whose first byte starts at start_us; the time of its last byte. */
+static uint32_t line_append(line_t *line, const uint8_t *data, size_t len, uint32_t start_us)
+{
+    line->bytes = grow(line->bytes, &line->cap, line->len + len, 1);
+    line->time_us = grow(line->time_us, &line->time_cap, line->len + len, sizeof(uint32_t));
+    for (size_t k = 0; k < len; k++)
+    {
+        line->bytes[line->len] = data[k];
+        line->time_us[line->len] = start_us + (uint32_t)(k + 1) * BYTE_TIME_US;
+        line->len++;
+    }
+    return line->time_us[line->len - 1];
+}
+
+/**
+ * Cut a line into uplink BYTES records of 1..64 bytes, also at idle gaps, and
+ * replace every byte's time with that of the record it ends up in.
+ */
+static uint8_t *line_encode(line_t *line, size_t *out_len)
+{
+    uint8_t *out = NULL;
+    size_t used = 0, cap = 0;
+    uint8_t sequence = 0;
+    size_t start = 0;
+    while (start < line->len)
+    {
+        size_t end = start + 1 + rng() % 64u;
+        if (end > line->len)
+            end = line->len;
+        for (size_t k = start + 1; k < end; k++)
+            if (line->time_us[k] - line->time_us[k - 1] > IDLE_FLUSH_US)
+            {
+                end = k;
+                break;
+            }
+        const ld2420_uplink_record_t record = {
+            .kind = LD2420_UPLINK_KIND_BYTES,
+            .sequence = sequence++,
+            .timestamp_us = line->time_us[end - 1],
+            .payload = line->bytes + start,
+            .payload_size = (uint16_t)(end - start),
+        };
+        out = grow(out, &cap, used + LD2420_UPLINK_MAX_RECORD_SIZE, 1);
+        size_t written = 0;
+        ld2420_uplink_encode(&record, out + used, cap - used, &written);
+        used += written;
+        for (size_t k = start; k < end; k++)
+            line->time_us[k] = record.timestamp_us;
+        start = end;
+    }
+    *out_len = used;
+    return out;
+}
+
+/** One generated transaction, located by the index of its last byte on each line. */
+typedef struct
+{
+    uint16_t command;
+    bool answered;
+    uint16_t status;
+    size_t tx_end;
+    size_t rx_end;
+} expected_t;
+
+/** Encode a random command; its id through command. */
+static uint16_t random_command(uint8_t *out, uint16_t *command)
+{
+    switch (rng() % 6u)
+    {
+    case 0: {
+        const ld2420_command_open_config_mode_t msg = {.protocol_version = 1};
+        *command = LD2420_CMD_OPEN_CONFIG_MODE;
+        return ld2420_command_open_config_mode_encode(out, &msg);
+    }
+    case 1:
+        *command = LD2420_CMD_CLOSE_CONFIG_MODE;
+        return ld2420_command_close_config_mode_encode(out);
+    case 2:
+        *command = LD2420_CMD_READ_VERSION_NUMBER;
+        return ld2420_command_read_version_number_encode(out);
+    case 3:
+        *command = LD2420_CMD_REBOOT;
+        return ld2420_command_reboot_encode(out);
+    case 4: {
+        ld2420_command_read_config_t msg = {.parameters_count = (uint16_t)(1u + rng() % 35u)};
+        for (uint16_t i = 0; i < msg.parameters_count; i++)
+            msg.parameters[i] = i;
+        *command = LD2420_CMD_READ_CONFIG;
+        return ld2420_command_read_config_encode(out, &msg);
+    }
+    default: {
+        ld2420_command_set_config_t msg = {.entries_count = (uint16_t)(1u + rng() % 35u)};
+        for (uint16_t i = 0; i < msg.entries_count; i++)
+            msg.entries[i] = (ld2420_protocol_param_t){.parameter = i, .value = rng() % 100u};
+        *command = LD2420_CMD_SET_CONFIG;
+        return ld2420_command_set_config_encode(out, &msg);
+    }
+    }
+}
+
+static uint16_t ack_for(uint8_t *out, uint16_t command, uint16_t status)
+{
+    switch (command)
+    {
+    case LD2420_CMD_OPEN_CONFIG_MODE: {
+        const ld2420_ack_open_config_mode_t msg = {.status = status, .protocol_version = 1, .buffer_size = 64};
+        return ld2420_ack_open_config_mode_encode(out, &msg);
+    }
+    case LD2420_CMD_CLOSE_CONFIG_MODE: {
+        const ld2420_ack_close_config_mode_t msg = {.status = status};
+        return ld2420_ack_close_config_mode_encode(out, &msg);
+    }
+    case LD2420_CMD_READ_VERSION_NUMBER: {
+        static const uint8_t version[] = {'v', '1', '.', '5', '.', '3'};
+        const ld2420_ack_read_version_number_t msg = {
+            .status = status, .version_size = sizeof(version), .version = version, .version_count = sizeof(version)};
+        return ld2420_ack_read_version_number_encode(out, &msg);
+    }
+    case LD2420_CMD_REBOOT: {
+        const ld2420_ack_reboot_t msg = {.status = status};
+        return ld2420_ack_reboot_encode(out, &msg);
+    }
+    case LD2420_CMD_READ_CONFIG: {
+        ld2420_ack_read_config_t msg = {.status = status, .values_count = (uint16_t)(1u + rng() % 35u)};
+        for (uint16_t i = 0; i < msg.values_count; i++)
+            msg.values[i] = rng() % 1000u;
+        return ld2420_ack_read_config_encode(out, &msg);
+    }
+    default: {
+        const ld2420_ack_set_config_t msg = {.status = status};
+        return ld2420_ack_set_config_encode(out, &msg);
+    }
+    }
+}
+
+/** Generate one tap's traffic into tx and rx; the expected transactions in *out. */
+static size_t generate(line_t *tx, line_t *rx, size_t transactions, uint32_t start_us, expected_t *out)
+{
+    static const uint8_t noise[] = {0xFD, 0xFC, 0x00};
+    uint8_t frame[LD2420_MAX_TX_PACKET_SIZE];
+    uint32_t t = start_us;
+    for (size_t i = 0; i < transactions; i++)
+    {
+        if (i % 10u == 3u)
+            t = line_append(tx, noise, sizeof(noise), t) + 2000u;
+
+        expected_t *e = &out[i];
+        const uint16_t size = random_command(frame, &e->command);
+        const uint32_t command_end = line_append(tx, frame, size, t);
+        e->tx_end = tx->len - 1;
+        e->answered = i % 50u != 49u;
+        e->status = (uint16_t)(i % 20u == 7u ? 1u : 0u);
+
+        uint32_t rx_free = command_end;
+        if (e->answered)
+        {
+            const uint16_t ack_size = ack_for(frame, e->command, e->status);
+            rx_free = line_append(rx, frame, ack_size, command_end + 2000u + rng() % 48000u);
+            e->rx_end = rx->len - 1;
+        }
+
+        // A report while the host thinks about the next command
+        ld2420_report_energy_t report = {.presence = 1, .distance_cm = (uint16_t)(rng() % 800u)};
+        for (int g = 0; g < 16; g++)
+            report.energy[g] = (uint16_t)(rng() % 5000u);
+        const uint16_t report_size = ld2420_report_energy_encode(frame, &report);
+        rx_free = line_append(rx, frame, report_size, rx_free + 500u);
+
+        t = rx_free + 20000u + rng() % 180000u;
+    }
+    return transactions;
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int run_synthetic(size_t tap_count, size_t transactions, uint32_t timeout_us, bool check)
+{
+    tap_t *taps = calloc(tap_count, sizeof(*taps));
+    uint8_t **encoded = calloc(2 * tap_count, sizeof(*encoded));
+    size_t *encoded_len = calloc(2 * tap_count, sizeof(*encoded_len));
+    ld2420_sniff_stats_t *expected = calloc(tap_count * 256u, sizeof(*expected));
+    expected_t *trace = calloc(transactions, sizeof(*trace));
+    if (taps == NULL || encoded == NULL || encoded_len == NULL || expected == NULL || trace == NULL)
+        return 1;
+
+    // Generate every tap up front so that only decoding is timed. Clocks start
+    // shortly before they wrap.
+    uint64_t line_bytes = 0;
+    for (size_t t = 0; t < tap_count; t++)
+    {
+        line_t tx = {0}, rx = {0};
+        generate(&tx, &rx, transactions, UINT32_MAX - 5000000u + (uint32_t)t * 37u, trace);
+        encoded[2 * t] = line_encode(&tx, &encoded_len[2 * t]);
+        encoded[2 * t + 1] = line_encode(&rx, &encoded_len[2 * t + 1]);
+        line_bytes += tx.len + rx.len;
+
+        ld2420_sniff_stats_t *exp = &expected[t * 256u];
+        for (unsigned k = 0; k < 256u; k++)
+            exp[k].min_rtt_us = UINT32_MAX;
+        for (size_t i = 0; i < transactions; i++)
+        {
+            ld2420_sniff_stats_t *s = &exp[trace[i].command];
+            s->commands++;
+            if (!trace[i].answered)
+            {
+                s->unanswered++;
+                continue;
+            }
+            const uint32_t rtt = rx.time_us[trace[i].rx_end] - tx.time_us[trace[i].tx_end];
+            s->answered++;
+            s->failed += trace[i].status != 0 ? 1u : 0u;
+            s->sum_rtt_us += rtt;
+            if (rtt < s->min_rtt_us)
+                s->min_rtt_us = rtt;
+            if (rtt > s->max_rtt_us)
+                s->max_rtt_us = rtt;
+        }
+        free(tx.bytes);
+        free(tx.time_us);
+        free(rx.bytes);
+        free(rx.time_us);
+    }
+
+    const double start = now_s();
+    uint32_t corrupt = 0;
+    for (size_t t = 0; t < tap_count; t++)
+    {
+        capture_t tx = {0}, rx = {0};
+        corrupt += capture_decode(&tx, encoded[2 * t], encoded_len[2 * t]);
+        corrupt += capture_decode(&rx, encoded[2 * t + 1], encoded_len[2 * t + 1]);
+        tap_init(&taps[t], (unsigned)t, timeout_us);
+        tap_replay(&taps[t], &tx, &rx);
+        capture_free(&tx);
+        capture_free(&rx);
+    }
+    const double elapsed = now_s() - start;
+
+    print_summary(taps, tap_count);
+    const double rate = line_bytes / elapsed;
+    printf("%zu taps, %zu transactions each: %.1f MB/s of line traffic, %.0f taps at %u baud per core\n", tap_count,
+           transactions, rate / 1e6, rate / (2.0 * LD2420_BAUD_RATE / 10.0), LD2420_BAUD_RATE);
+
+    int result = 0;
+    if (check)
+    {
+        for (size_t t = 0; t < tap_count; t++)
+        {
+            const tap_t *tap = &taps[t];
+            bool ok = tap->corr.orphan_acks == 0 && tap->tx_errors == 0 && tap->rx_errors == 0 &&
+                      tap->line_bytes > 0;
+            for (unsigned k = 0; k < 256u && ok; k++)
+                ok = memcmp(&tap->corr.stats[k], &expected[t * 256u + k], sizeof(ld2420_sniff_stats_t)) == 0;
+            if (!ok)
+            {
+                fprintf(stderr, "FAIL: tap %zu does not match the generated traffic\n", t);
+                result = 1;
+            }
+        }
+        if (corrupt > 0)
+        {
+            fprintf(stderr, "FAIL: %" PRIu32 " corrupt uplink records\n", corrupt);
+            result = 1;
+        }
+        if (result == 0)
+            printf("OK\n");
+    }
+
+    for (size_t k = 0; k < 2 * tap_count; k++)
+        free(encoded[k]);
+    free(encoded);
+    free(encoded_len);
+    free(expected);
+    free(trace);
+    free(taps);
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t timeout_us = 1000000u;
+    size_t synthetic = 0, transactions = 2000;
+    const char *link = NULL;
+    bool check = false;
+    int i = 1;
+    for (; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--quiet") == 0)
+            quiet = true;
+        else if (strcmp(argv[i], "--check") == 0)
+            check = true;
+        else if (strcmp(argv[i], "--timeout-ms") == 0 && i + 1 < argc)
+            timeout_us = (uint32_t)strtoul(argv[++i], NULL, 10) * 1000u;
+        else if (strcmp(argv[i], "--link") == 0 && i + 1 < argc)
+            link = argv[++i];
+        else if (strcmp(argv[i], "--synthetic") == 0 && i + 1 < argc)
+            synthetic = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--transactions") == 0 && i + 1 < argc)
+            transactions = strtoul(argv[++i], NULL, 10);
+        else if (argv[i][0] == '-')
+            return usage(argv[0]);
+        else
+            break;
+    }
+    const int rest = argc - i;
+    if (timeout_us == 0)
+        return usage(argv[0]);
+
+    if (synthetic > 0)
+        return rest == 0 && transactions > 0 ? run_synthetic(synthetic, transactions, timeout_us, check)
+                                             : usage(argv[0]);
+    if (link != NULL)
+        return rest == 0 ? run_link(link, timeout_us) : usage(argv[0]);
+    if (rest == 0 || rest % 2 != 0)
+        return usage(argv[0]);
+    return run_captures(argv + i, (size_t)rest / 2u, timeout_us);
+}
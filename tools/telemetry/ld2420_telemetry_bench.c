@@ -0,0 +1,470 @@
+/*
+ * LD2420 telemetry benchmark
+ * --------------------------
+ * Publishes the same decoded frames twice over a local socket and compares
+ * the cost on the sending side:
+ *
+ * - json:   every frame as its own JSON message, one send() each, which is
+ *   what a simple gateway does.
+ * - binary: ld2420_linux_telemetry_t, with events packed into datagrams and
+ *   one sendmmsg() per round of frames.
+ *
+ * The frames are generated up front: every sensor reports at 10 Hz, gate
+ * energies and distance drift by small random steps, and every 50th frame is
+ * a command ACK. A receiver thread reads the other end of the socket; for the
+ * binary run it decodes every event and compares a digest of all of them with
+ * the one the sender computed.
+ *
+ * `--transport udp` goes over 127.0.0.1, where the kernel may drop datagrams
+ * the receiver cannot take; `--transport unix` uses an AF_UNIX datagram socket,
+ * which applies back pressure instead, so every event must arrive.
+ *
+ * Usage: ld2420_telemetry_bench [--sensors N] [--frames N] [--transport udp|unix]
+ *                               [--mode json|binary|both] [--check]
+ *
+ * With --check the exit status is 1 unless the binary run delivered every
+ * event intact.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <ld2420/ld2420.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/ld2420_telemetry.h>
+#include <ld2420/platform/linux/ld2420_linux_telemetry.h>
+
+#define BENCH_ACK_EVERY 50u
+#define BENCH_RATE_MS 100u
+#define BENCH_END_MARKER 0xFFu
+#define BENCH_RECEIVE_IDLE_MS 1000
+
+typedef struct
+{
+    uint32_t sensors;
+    uint32_t frames;
+    bool unix_transport;
+    bool json;
+    bool binary;
+    bool check;
+} bench_options_t;
+
+/** Pre-generated input: frame i comes from sensor i % sensors. */
+typedef struct
+{
+    uint8_t (*frames)[LD2420_REPORT_ENERGY_SIZE];
+    uint16_t *sizes;
+    uint32_t count;
+    uint32_t sensors;
+} bench_input_t;
+
+typedef struct
+{
+    int fd;
+    bool binary;
+    uint64_t datagrams;
+    uint64_t bytes;
+    uint64_t events;
+    uint64_t corrupt;
+    uint64_t lost;
+    uint64_t digest;
+    ld2420_telemetry_sensor_t sensors[LD2420_LINUX_MAX_PORTS];
+    ld2420_telemetry_decoder_t decoder;
+} receiver_t;
+
+typedef struct
+{
+    double wall_ns;
+    double cpu_ns;
+    uint64_t bytes;
+    uint64_t syscalls;
+    uint64_t events;
+    uint64_t dropped;
+    uint64_t digest;
+} sender_result_t;
+
+static const uint8_t OPEN_CONFIG_ACK[] = {0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01, 0x00,
+                                          0x00, 0x02, 0x00, 0x20, 0x00, 0x04, 0x03, 0x02, 0x01};
+
+static uint64_t clock_ns(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static uint64_t fnv1a(uint64_t h, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++)
+        h = (h ^ p[i]) * 0x100000001B3ull;
+    return h;
+}
+
+/** Digest of the fields an event carries for its kind. */
+static uint64_t digest_event(uint64_t h, const ld2420_telemetry_event_t *e)
+{
+    h = fnv1a(h, &e->kind, sizeof(e->kind));
+    h = fnv1a(h, &e->sensor_id, sizeof(e->sensor_id));
+    h = fnv1a(h, &e->timestamp_ms, sizeof(e->timestamp_ms));
+    if (e->kind == LD2420_TELEMETRY_ACK)
+    {
+        h = fnv1a(h, &e->cmd_echo, sizeof(e->cmd_echo));
+        h = fnv1a(h, &e->status, sizeof(e->status));
+        return fnv1a(h, e->payload, e->payload_size);
+    }
+    h = fnv1a(h, &e->presence, sizeof(e->presence));
+    h = fnv1a(h, &e->distance_cm, sizeof(e->distance_cm));
+    return fnv1a(h, e->energy, sizeof(e->energy));
+}
+
+static int generate(bench_input_t *in, uint32_t sensors, uint32_t frames)
+{
+    in->frames = malloc((size_t)frames * sizeof(*in->frames));
+    in->sizes = malloc((size_t)frames * sizeof(*in->sizes));
+    ld2420_report_energy_t *state = calloc(sensors, sizeof(*state));
+    if (in->frames == NULL || in->sizes == NULL || state == NULL)
+    {
+        free(state);
+        return -1;
+    }
+    in->count = frames;
+    in->sensors = sensors;
+
+    uint32_t rng = 0x2420u;
+    for (uint32_t s = 0; s < sensors; s++)
+    {
+        state[s].distance_cm = (uint16_t)(100u + xorshift32(&rng) % 400u);
+        for (int g = 0; g < 16; g++)
+            state[s].energy[g] = (uint16_t)(200u + xorshift32(&rng) % 3000u);
+    }
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        if (i % BENCH_ACK_EVERY == BENCH_ACK_EVERY - 1u)
+        {
+            memcpy(in->frames[i], OPEN_CONFIG_ACK, sizeof(OPEN_CONFIG_ACK));
+            in->sizes[i] = sizeof(OPEN_CONFIG_ACK);
+            continue;
+        }
+        ld2420_report_energy_t *r = &state[i % sensors];
+        if (xorshift32(&rng) % 64u == 0)
+            r->presence ^= 1u;
+        r->distance_cm = (uint16_t)(r->distance_cm + xorshift32(&rng) % 9u - 4u);
+        for (int g = 0; g < 16; g++)
+            r->energy[g] = (uint16_t)(r->energy[g] + xorshift32(&rng) % 41u - 20u);
+        ld2420_report_energy_encode(in->frames[i], r);
+        in->sizes[i] = LD2420_REPORT_ENERGY_SIZE;
+    }
+    free(state);
+    return 0;
+}
+
+static bool on_event(void *user, const ld2420_telemetry_event_t *event)
+{
+    receiver_t *rx = (receiver_t *)user;
+    rx->digest = digest_event(rx->digest, event);
+    rx->events++;
+    return true;
+}
+
+static void *receive_thread(void *arg)
+{
+    receiver_t *rx = (receiver_t *)arg;
+    static uint8_t buf[65536];
+    ld2420_telemetry_decoder_init(&rx->decoder, rx->sensors, LD2420_LINUX_MAX_PORTS);
+    rx->digest = 0xCBF29CE484222325ull;
+
+    struct pollfd pfd = {.fd = rx->fd, .events = POLLIN};
+    while (poll(&pfd, 1, BENCH_RECEIVE_IDLE_MS) > 0)
+    {
+        const ssize_t n = recv(rx->fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n < 0)
+        {
+            if (errno == EAGAIN || errno == EINTR)
+                continue;
+            break;
+        }
+        if (n == 1 && buf[0] == BENCH_END_MARKER)
+            break;
+        rx->datagrams++;
+        rx->bytes += (uint64_t)n;
+        if (rx->binary)
+            ld2420_telemetry_decode(&rx->decoder, buf, (size_t)n, on_event, rx);
+        else
+            rx->events++;
+    }
+    rx->corrupt = rx->decoder.corrupt_messages;
+    rx->lost = rx->decoder.lost_messages;
+    return NULL;
+}
+
+/** Send one datagram, waiting while the socket is full. */
+static ssize_t send_blocking(int fd, const void *data, size_t len)
+{
+    for (;;)
+    {
+        const ssize_t n = send(fd, data, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n >= 0 || (errno != EAGAIN && errno != EINTR))
+            return n;
+        struct pollfd pfd = {.fd = fd, .events = POLLOUT};
+        poll(&pfd, 1, 100);
+    }
+}
+
+static int format_json(char *out, size_t size, uint32_t sensor, uint32_t t, const uint8_t *frame, uint16_t frame_size)
+{
+    ld2420_report_energy_t r;
+    if (ld2420_report_energy_decode(frame, frame_size, &r) == LD2420_STATUS_OK)
+    {
+        int n = snprintf(out, size, "{\"sensor\":%" PRIu32 ",\"t\":%" PRIu32 ",\"type\":\"report\",\"presence\":%u,"
+                                    "\"distance\":%u,\"energy\":[",
+                         sensor, t, r.presence, r.distance_cm);
+        for (int g = 0; g < 16; g++)
+            n += snprintf(out + n, size - (size_t)n, g == 0 ? "%u" : ",%u", r.energy[g]);
+        n += snprintf(out + n, size - (size_t)n, "]}");
+        return n;
+    }
+    int n = snprintf(out, size, "{\"sensor\":%" PRIu32 ",\"t\":%" PRIu32 ",\"type\":\"ack\",\"cmd\":%u,\"status\":%u,"
+                                "\"payload\":\"",
+                     sensor, t, ld2420_protocol_read_le16(frame + 6), ld2420_protocol_read_le16(frame + 8));
+    for (uint16_t i = 10; i + 4u < frame_size; i++)
+        n += snprintf(out + n, size - (size_t)n, "%02X", frame[i]);
+    n += snprintf(out + n, size - (size_t)n, "\"}");
+    return n;
+}
+
+static int run_json(const bench_input_t *in, int fd, sender_result_t *res)
+{
+    char msg[512];
+    const uint64_t wall = clock_ns(CLOCK_MONOTONIC);
+    const uint64_t cpu = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+    for (uint32_t i = 0; i < in->count; i++)
+    {
+        const uint32_t t = (i / in->sensors) * BENCH_RATE_MS;
+        const int n = format_json(msg, sizeof(msg), i % in->sensors, t, in->frames[i], in->sizes[i]);
+        if (send_blocking(fd, msg, (size_t)n) < 0)
+            return -1;
+        res->bytes += (uint64_t)n;
+        res->syscalls++;
+        res->events++;
+    }
+    res->cpu_ns = (double)(clock_ns(CLOCK_THREAD_CPUTIME_ID) - cpu);
+    res->wall_ns = (double)(clock_ns(CLOCK_MONOTONIC) - wall);
+    return 0;
+}
+
+static int run_binary(const bench_input_t *in, int fd, sender_result_t *res)
+{
+    static ld2420_linux_telemetry_t pub;
+    if (ld2420_linux_telemetry_init(&pub, fd) != LD2420_STATUS_OK)
+        return -1;
+
+    // The digest is computed outside the timed loop
+    res->digest = 0xCBF29CE484222325ull;
+    for (uint32_t i = 0; i < in->count; i++)
+    {
+        ld2420_telemetry_event_t e;
+        ld2420_telemetry_event_from_frame(in->frames[i], in->sizes[i], (uint16_t)(i % in->sensors),
+                                          (i / in->sensors) * BENCH_RATE_MS, &e);
+        res->digest = digest_event(res->digest, &e);
+    }
+
+    const uint64_t wall = clock_ns(CLOCK_MONOTONIC);
+    const uint64_t cpu = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+    for (uint32_t i = 0; i < in->count; i++)
+    {
+        const uint32_t t = (i / in->sensors) * BENCH_RATE_MS;
+        ld2420_linux_telemetry_publish_frame(&pub, (uint16_t)(i % in->sensors), in->frames[i], in->sizes[i], t);
+
+        // One flush per round of all sensors, as after one ingest poll; wait out
+        // a full socket so that the comparison is not won by dropping events
+        if ((i + 1u) % in->sensors == 0 || i + 1u == in->count)
+        {
+            while (ld2420_linux_telemetry_flush(&pub) >= 0 && ld2420_linux_telemetry_pending(&pub) > 0)
+            {
+                struct pollfd pfd = {.fd = fd, .events = POLLOUT};
+                poll(&pfd, 1, 100);
+            }
+        }
+    }
+    res->cpu_ns = (double)(clock_ns(CLOCK_THREAD_CPUTIME_ID) - cpu);
+    res->wall_ns = (double)(clock_ns(CLOCK_MONOTONIC) - wall);
+    res->bytes = pub.bytes_sent;
+    res->syscalls = pub.send_calls;
+    res->events = pub.events;
+    res->dropped = pub.dropped_events;
+    return pub.last_errno != 0 ? -1 : 0;
+}
+
+/** Create a receiving socket and a connected sending socket. */
+static int open_pair(bool unix_transport, const char *dir, int *rx_fd, int *tx_fd)
+{
+    if (unix_transport)
+    {
+        struct sockaddr_un addr = {.sun_family = AF_UNIX};
+        snprintf(addr.sun_path, sizeof(addr.sun_path), "%s/telemetry.sock", dir);
+        unlink(addr.sun_path);
+        *rx_fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (*rx_fd < 0 || bind(*rx_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+            return -1;
+        return ld2420_linux_telemetry_connect_unix(addr.sun_path, tx_fd) == LD2420_STATUS_OK ? 0 : -1;
+    }
+
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    socklen_t len = sizeof(addr);
+    const int rcvbuf = 8 << 20;
+    *rx_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (*rx_fd < 0 || bind(*rx_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        getsockname(*rx_fd, (struct sockaddr *)&addr, &len) != 0)
+        return -1;
+    setsockopt(*rx_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    return ld2420_linux_telemetry_connect_udp("127.0.0.1", ntohs(addr.sin_port), tx_fd) == LD2420_STATUS_OK ? 0 : -1;
+}
+
+static int run(const bench_options_t *opt, const bench_input_t *in, const char *dir, bool binary, bool *intact)
+{
+    int rx_fd = -1, tx_fd = -1;
+    if (open_pair(opt->unix_transport, dir, &rx_fd, &tx_fd) != 0)
+    {
+        perror("socket");
+        return -1;
+    }
+
+    static receiver_t rx;
+    memset(&rx, 0, sizeof(rx));
+    rx.fd = rx_fd;
+    rx.binary = binary;
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, receive_thread, &rx) != 0)
+        return -1;
+
+    sender_result_t res = {0};
+    const int rc = binary ? run_binary(in, tx_fd, &res) : run_json(in, tx_fd, &res);
+    const uint8_t end = BENCH_END_MARKER;
+    send_blocking(tx_fd, &end, 1);
+    pthread_join(thread, NULL);
+    close(tx_fd);
+    close(rx_fd);
+    if (rc != 0)
+    {
+        perror("send");
+        return -1;
+    }
+
+    printf("%-6s: %8.1f ns CPU/event %8.2f Mevents/s %6.1f bytes/event %9" PRIu64 " send calls"
+           "  received %" PRIu64 "/%" PRIu64 " events in %" PRIu64 " datagrams",
+           binary ? "binary" : "json", res.cpu_ns / (double)res.events, (double)res.events * 1e3 / res.wall_ns,
+           (double)res.bytes / (double)res.events, res.syscalls, rx.events, (uint64_t)in->count, rx.datagrams);
+    if (binary)
+        printf(", %" PRIu64 " dropped, %" PRIu64 " lost datagrams", res.dropped, rx.lost);
+    printf("\n");
+
+    if (binary)
+        *intact = rx.events == in->count && rx.corrupt == 0 && rx.lost == 0 && res.dropped == 0 && rx.digest == res.digest;
+    return 0;
+}
+
+static int usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--sensors N] [--frames N] [--transport udp|unix] [--mode json|binary|both] [--check]\n",
+            argv0);
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    bench_options_t opt = {.sensors = 64, .frames = 500000, .json = true, .binary = true};
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--check") == 0)
+            opt.check = true;
+        else if (i + 1 < argc && strcmp(argv[i], "--sensors") == 0)
+            opt.sensors = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--frames") == 0)
+            opt.frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--transport") == 0)
+        {
+            const char *t = argv[++i];
+            if (strcmp(t, "unix") != 0 && strcmp(t, "udp") != 0)
+                return usage(argv[0]);
+            opt.unix_transport = strcmp(t, "unix") == 0;
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--mode") == 0)
+        {
+            const char *m = argv[++i];
+            opt.json = strcmp(m, "json") == 0 || strcmp(m, "both") == 0;
+            opt.binary = strcmp(m, "binary") == 0 || strcmp(m, "both") == 0;
+            if (!opt.json && !opt.binary)
+                return usage(argv[0]);
+        }
+        else
+            return usage(argv[0]);
+    }
+    if (opt.sensors == 0 || opt.sensors > LD2420_LINUX_MAX_PORTS || opt.frames == 0 || (opt.check && !opt.binary))
+        return usage(argv[0]);
+
+    static bench_input_t in;
+    if (generate(&in, opt.sensors, opt.frames) != 0)
+    {
+        perror("malloc");
+        return 1;
+    }
+    char dir[] = "/tmp/ld2420-telemetry-XXXXXX";
+    if (opt.unix_transport && mkdtemp(dir) == NULL)
+    {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    printf("%" PRIu32 " frames from %" PRIu32 " sensors over %s\n", opt.frames, opt.sensors,
+           opt.unix_transport ? "AF_UNIX datagrams" : "UDP loopback");
+    bool intact = false;
+    int rc = 0;
+    if (opt.json && run(&opt, &in, dir, false, &intact) != 0)
+        rc = 1;
+    if (opt.binary && run(&opt, &in, dir, true, &intact) != 0)
+        rc = 1;
+
+    if (opt.unix_transport)
+    {
+        char path[sizeof(dir) + 32];
+        snprintf(path, sizeof(path), "%s/telemetry.sock", dir);
+        unlink(path);
+        rmdir(dir);
+    }
+    free(in.frames);
+    free(in.sizes);
+
+    if (opt.check && (rc != 0 || !intact))
+    {
+        fprintf(stderr, "FAIL: binary telemetry did not deliver every event intact\n");
+        return 1;
+    }
+    if (opt.check)
+        fprintf(stderr, "OK\n");
+    return rc;
+}
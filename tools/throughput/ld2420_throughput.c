@@ -0,0 +1,495 @@
+/*
+ * LD2420 end-to-end ingest throughput benchmark
+ * ---------------------------------------------
+ * Emulates N sensors on pseudo-terminals and drives the complete host ingest
+ * path (serial setup, epoll, read, streaming parser, callback) with them.
+ *
+ * - A writer thread plays every sensor: frames are scheduled round-robin so
+ *   that each sensor emits `--rate` frames per second, and each frame is
+ *   written to the pty master in random chunks of 1..`--chunk-max` bytes, the
+ *   way USB-serial adapters hand data to the kernel.
+ * - The main thread runs ld2420_linux_ingest_poll() on the pty slaves.
+ * - The sensor count is ramped (doubling from `--start`) until frames are lost
+ *   or `--max` is reached. A frame is lost when the pty would block or when it
+ *   never arrives at the ingest callback.
+ *
+ * Each frame is a READ_CONFIG acknowledgement whose parameter words carry the
+ * sensor id and a sequence number, so the receiver can match it against the
+ * writer's timestamp and compute end-to-end latency.
+ *
+ * Usage: ld2420_throughput [--start N] [--max N] [--rate HZ] [--duration S]
+ *                          [--chunk-max BYTES] [--loss PERCENT] [--seed N]
+ *                          [--label TEXT] [--json PATH]
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include <ld2420/ld2420.h>
+#include <ld2420/platform/linux/ld2420_linux.h>
+
+/** Parameter words per emulated frame: sensor id, sequence, padding. */
+#define BENCH_VALUE_COUNT 8u
+
+/** READ_CONFIG ACK: header(4) + len(2) + echo(2) + status(2) + values(8 x 4) + footer(4). */
+#define BENCH_FRAME_SIZE (4u + 2u + 2u + 2u + BENCH_VALUE_COUNT * 4u + 4u)
+
+/** Outstanding frames per sensor whose send time is remembered. */
+#define BENCH_SEQ_WINDOW 64u
+
+typedef struct
+{
+    size_t start;
+    size_t max;
+    double rate_hz;
+    double duration_s;
+    size_t chunk_max;
+    double loss_percent;
+    uint32_t seed;
+    const char *label;
+    const char *json_path;
+} bench_options_t;
+
+typedef struct
+{
+    int master_fd;
+    uint32_t next_seq;
+    uint64_t send_ns[BENCH_SEQ_WINDOW];
+} emulated_sensor_t;
+
+typedef struct
+{
+    size_t sensors;
+    uint64_t sent;
+    uint64_t write_drops;
+    uint64_t received;
+    double loss_percent;
+    double cpu_us_per_sensor_s;
+    uint64_t p50_ns, p90_ns, p99_ns, p999_ns, max_ns;
+} step_result_t;
+
+typedef struct
+{
+    const bench_options_t *opt;
+    emulated_sensor_t *sensors;
+    size_t count;
+    uint64_t sent;
+    uint64_t write_drops;
+} writer_ctx_t;
+
+typedef struct
+{
+    emulated_sensor_t *sensors;
+    size_t count;
+    uint64_t *latencies;
+    size_t latency_cap;
+    size_t latency_len;
+    uint64_t received;
+} reader_ctx_t;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t thread_cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void put_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void build_frame(uint8_t *frame, uint32_t sensor, uint32_t seq)
+{
+    memcpy(frame, LD2420_BEG_COMMAND_PACKET, sizeof(LD2420_BEG_COMMAND_PACKET));
+    put_le16(frame + 4, (uint16_t)(BENCH_FRAME_SIZE - 10u));
+    put_le16(frame + 6, 0x0100u | LD2420_CMD_READ_CONFIG);
+    put_le16(frame + 8, 0);
+    put_le32(frame + 10, sensor);
+    put_le32(frame + 14, seq);
+    for (uint32_t v = 2; v < BENCH_VALUE_COUNT; v++)
+        put_le32(frame + 10 + v * 4, v);
+    memcpy(frame + BENCH_FRAME_SIZE - 4, LD2420_END_COMMAND_PACKET, sizeof(LD2420_END_COMMAND_PACKET));
+}
+
+/**
+ * Write one frame in random chunks. The send time is published to `stamp`
+ * right before the last chunk, so the receiver never sees the frame first.
+ * Returns false if the pty would block; the rest of the frame is then dropped,
+ * like bytes lost to a UART overrun.
+ */
+static bool write_chunked(int fd, const uint8_t *frame, size_t len, size_t chunk_max,
+                          uint32_t *rng, uint64_t *stamp)
+{
+    size_t off = 0;
+    while (off < len)
+    {
+        size_t chunk = 1 + xorshift32(rng) % chunk_max;
+        if (chunk > len - off)
+            chunk = len - off;
+        if (off + chunk == len)
+            __atomic_store_n(stamp, now_ns(), __ATOMIC_RELEASE);
+
+        ssize_t w = write(fd, frame + off, chunk);
+        if (w < 0 && errno == EINTR)
+            continue;
+        if (w <= 0)
+            return false;
+        off += (size_t)w;
+    }
+    return true;
+}
+
+static void *writer_main(void *arg)
+{
+    writer_ctx_t *ctx = arg;
+    const bench_options_t *opt = ctx->opt;
+    uint32_t rng = opt->seed ? opt->seed : 1u;
+    uint8_t frame[BENCH_FRAME_SIZE];
+
+    // Round-robin schedule: event j goes to sensor j % count at t0 + j / (count * rate).
+    const double interval_ns = 1e9 / (opt->rate_hz * (double)ctx->count);
+    const uint64_t t0 = now_ns();
+    const uint64_t end = t0 + (uint64_t)(opt->duration_s * 1e9);
+
+    for (uint64_t j = 0;; j++)
+    {
+        uint64_t due = t0 + (uint64_t)((double)j * interval_ns);
+        if (due >= end)
+            break;
+
+        uint64_t now = now_ns();
+        if (due > now + 50000u)
+        {
+            struct timespec ts = {0, (long)(due - now)};
+            nanosleep(&ts, NULL);
+        }
+
+        emulated_sensor_t *s = &ctx->sensors[j % ctx->count];
+        uint32_t seq = s->next_seq++;
+        build_frame(frame, (uint32_t)(j % ctx->count), seq);
+
+        if (write_chunked(s->master_fd, frame, sizeof(frame), opt->chunk_max, &rng,
+                          &s->send_ns[seq % BENCH_SEQ_WINDOW]))
+            ctx->sent++;
+        else
+            ctx->write_drops++;
+    }
+    return NULL;
+}
+
+static void on_frame(
+    void *user,
+    uint16_t port_index,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    reader_ctx_t *ctx = user;
+    uint64_t now = now_ns();
+    (void)port_index;
+    (void)cmd_echo;
+    (void)status;
+
+    if (frame_size_bytes != BENCH_FRAME_SIZE)
+        return;
+    uint32_t sensor = get_le32(frame + 10);
+    uint32_t seq = get_le32(frame + 14);
+    if (sensor >= ctx->count)
+        return;
+
+    ctx->received++;
+    uint64_t sent = __atomic_load_n(&ctx->sensors[sensor].send_ns[seq % BENCH_SEQ_WINDOW], __ATOMIC_ACQUIRE);
+    if (sent != 0 && now >= sent && ctx->latency_len < ctx->latency_cap)
+        ctx->latencies[ctx->latency_len++] = now - sent;
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t percentile(const uint64_t *sorted, size_t len, double p)
+{
+    if (len == 0)
+        return 0;
+    size_t idx = (size_t)(p * (double)(len - 1) + 0.5);
+    return sorted[idx];
+}
+
+static int open_pty_pair(int *out_master, char *slave_path, size_t slave_path_len)
+{
+    int master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (master < 0)
+        return -1;
+    if (grantpt(master) != 0 || unlockpt(master) != 0 ||
+        ptsname_r(master, slave_path, slave_path_len) != 0)
+    {
+        close(master);
+        return -1;
+    }
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+    *out_master = master;
+    return 0;
+}
+
+static ld2420_linux_ingest_t ingest;
+
+static int run_step(const bench_options_t *opt, size_t count, step_result_t *res)
+{
+    memset(res, 0, sizeof(*res));
+    res->sensors = count;
+
+    emulated_sensor_t *sensors = calloc(count, sizeof(*sensors));
+    size_t latency_cap = (size_t)((double)count * opt->rate_hz * opt->duration_s * 1.1) + 16;
+    uint64_t *latencies = malloc(latency_cap * sizeof(*latencies));
+    if (sensors == NULL || latencies == NULL)
+    {
+        free(sensors);
+        free(latencies);
+        return -1;
+    }
+
+    reader_ctx_t reader = {sensors, count, latencies, latency_cap, 0, 0};
+    if (ld2420_linux_ingest_init(&ingest, on_frame, &reader) != LD2420_STATUS_OK)
+    {
+        free(sensors);
+        free(latencies);
+        return -1;
+    }
+
+    int rc = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        char slave_path[64];
+        int slave_fd = -1;
+        sensors[i].master_fd = -1;
+        if (open_pty_pair(&sensors[i].master_fd, slave_path, sizeof(slave_path)) != 0 ||
+            ld2420_linux_open_serial(slave_path, &slave_fd) != LD2420_STATUS_OK ||
+            ld2420_linux_ingest_add(&ingest, slave_fd, NULL) != LD2420_STATUS_OK)
+        {
+            fprintf(stderr, "ERROR: unable to set up emulated sensor %zu: %s\n", i, strerror(errno));
+            if (slave_fd >= 0)
+                close(slave_fd);
+            count = i + (sensors[i].master_fd >= 0);
+            rc = -1;
+            goto cleanup;
+        }
+    }
+
+    writer_ctx_t writer = {opt, sensors, count, 0, 0};
+    pthread_t writer_thread;
+    uint64_t cpu_start = thread_cpu_ns();
+    uint64_t wall_start = now_ns();
+    if (pthread_create(&writer_thread, NULL, writer_main, &writer) != 0)
+    {
+        rc = -1;
+        goto cleanup;
+    }
+
+    // Ingest until the writer is done, then drain until nothing arrives for 200 ms.
+    const uint64_t writer_end = wall_start + (uint64_t)(opt->duration_s * 1e9);
+    uint64_t last_progress = now_ns();
+    for (;;)
+    {
+        int frames = ld2420_linux_ingest_poll(&ingest, 10);
+        uint64_t now = now_ns();
+        if (frames > 0)
+            last_progress = now;
+        if (now > writer_end && now - last_progress > 200000000ull)
+            break;
+    }
+    uint64_t cpu_ns = thread_cpu_ns() - cpu_start;
+    uint64_t wall_ns = now_ns() - wall_start;
+    pthread_join(writer_thread, NULL);
+
+    res->sent = writer.sent;
+    res->write_drops = writer.write_drops;
+    res->received = reader.received;
+    uint64_t attempted = writer.sent + writer.write_drops;
+    uint64_t lost = attempted > reader.received ? attempted - reader.received : 0;
+    res->loss_percent = attempted ? 100.0 * (double)lost / (double)attempted : 0.0;
+    res->cpu_us_per_sensor_s = (double)cpu_ns / 1e3 / (double)count / ((double)wall_ns / 1e9);
+
+    qsort(latencies, reader.latency_len, sizeof(*latencies), compare_u64);
+    res->p50_ns = percentile(latencies, reader.latency_len, 0.50);
+    res->p90_ns = percentile(latencies, reader.latency_len, 0.90);
+    res->p99_ns = percentile(latencies, reader.latency_len, 0.99);
+    res->p999_ns = percentile(latencies, reader.latency_len, 0.999);
+    res->max_ns = reader.latency_len ? latencies[reader.latency_len - 1] : 0;
+
+cleanup:
+    ld2420_linux_ingest_deinit(&ingest);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (sensors[i].master_fd >= 0)
+            close(sensors[i].master_fd);
+    }
+    free(sensors);
+    free(latencies);
+    return rc;
+}
+
+static void write_json(const bench_options_t *opt, const step_result_t *steps, size_t nsteps, size_t sustained)
+{
+    FILE *f = fopen(opt->json_path, "w");
+    if (f == NULL)
+    {
+        fprintf(stderr, "ERROR: cannot write %s: %s\n", opt->json_path, strerror(errno));
+        return;
+    }
+
+    fprintf(f, "{\n  \"benchmark\": \"ld2420_throughput\",\n");
+    fprintf(f, "  \"label\": \"%s\",\n", opt->label ? opt->label : "");
+    fprintf(f, "  \"rate_hz\": %.3f,\n  \"duration_s\": %.3f,\n  \"chunk_max\": %zu,\n",
+            opt->rate_hz, opt->duration_s, opt->chunk_max);
+    fprintf(f, "  \"frame_size\": %u,\n  \"loss_threshold_percent\": %.4f,\n",
+            BENCH_FRAME_SIZE, opt->loss_percent);
+    fprintf(f, "  \"sustained_sensors\": %zu,\n  \"steps\": [\n", sustained);
+    for (size_t i = 0; i < nsteps; i++)
+    {
+        const step_result_t *r = &steps[i];
+        fprintf(f,
+                "    {\"sensors\": %zu, \"sent\": %llu, \"write_drops\": %llu, \"received\": %llu, "
+                "\"loss_percent\": %.4f, \"cpu_us_per_sensor_s\": %.3f, "
+                "\"latency_us\": {\"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"p999\": %.1f, \"max\": %.1f}}%s\n",
+                r->sensors, (unsigned long long)r->sent, (unsigned long long)r->write_drops,
+                (unsigned long long)r->received, r->loss_percent, r->cpu_us_per_sensor_s,
+                r->p50_ns / 1e3, r->p90_ns / 1e3, r->p99_ns / 1e3, r->p999_ns / 1e3, r->max_ns / 1e3,
+                i + 1 < nsteps ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+}
+
+static void raise_fd_limit(void)
+{
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max)
+    {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bench_options_t opt = {1, LD2420_LINUX_MAX_PORTS, 20.0, 2.0, 16, 0.0, 1, NULL, NULL};
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (val == NULL)
+            goto usage;
+        if (strcmp(arg, "--start") == 0)
+            opt.start = strtoul(val, NULL, 10);
+        else if (strcmp(arg, "--max") == 0)
+            opt.max = strtoul(val, NULL, 10);
+        else if (strcmp(arg, "--rate") == 0)
+            opt.rate_hz = strtod(val, NULL);
+        else if (strcmp(arg, "--duration") == 0)
+            opt.duration_s = strtod(val, NULL);
+        else if (strcmp(arg, "--chunk-max") == 0)
+            opt.chunk_max = strtoul(val, NULL, 10);
+        else if (strcmp(arg, "--loss") == 0)
+            opt.loss_percent = strtod(val, NULL);
+        else if (strcmp(arg, "--seed") == 0)
+            opt.seed = (uint32_t)strtoul(val, NULL, 10);
+        else if (strcmp(arg, "--label") == 0)
+            opt.label = val;
+        else if (strcmp(arg, "--json") == 0)
+            opt.json_path = val;
+        else
+            goto usage;
+        i++;
+    }
+
+    if (opt.start == 0 || opt.max < opt.start || opt.rate_hz <= 0.0 || opt.duration_s <= 0.0 || opt.chunk_max == 0)
+        goto usage;
+    if (opt.max > LD2420_LINUX_MAX_PORTS)
+    {
+        fprintf(stderr, "WARN: --max capped at LD2420_LINUX_MAX_PORTS (%d)\n", LD2420_LINUX_MAX_PORTS);
+        opt.max = LD2420_LINUX_MAX_PORTS;
+    }
+    raise_fd_limit();
+
+    step_result_t steps[32];
+    size_t nsteps = 0, sustained = 0;
+
+    printf("%8s %10s %8s %8s %10s %10s %10s %10s %10s\n",
+           "sensors", "sent", "lost%", "cpu/s", "p50(us)", "p90(us)", "p99(us)", "p99.9(us)", "max(us)");
+    for (size_t n = opt.start; nsteps < sizeof(steps) / sizeof(steps[0]);)
+    {
+        step_result_t *r = &steps[nsteps];
+        if (run_step(&opt, n, r) != 0)
+            break;
+        nsteps++;
+        printf("%8zu %10llu %8.3f %8.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+               r->sensors, (unsigned long long)(r->sent + r->write_drops), r->loss_percent,
+               r->cpu_us_per_sensor_s, r->p50_ns / 1e3, r->p90_ns / 1e3, r->p99_ns / 1e3,
+               r->p999_ns / 1e3, r->max_ns / 1e3);
+        fflush(stdout);
+
+        if (r->loss_percent > opt.loss_percent)
+            break;
+        sustained = n;
+        if (n == opt.max)
+            break;
+        n = (n * 2 > opt.max) ? opt.max : n * 2; // the last step lands exactly on --max
+    }
+
+    printf("sustained sensors at %.1f Hz: %zu\n", opt.rate_hz, sustained);
+    if (opt.json_path != NULL)
+        write_json(&opt, steps, nsteps, sustained);
+    return nsteps > 0 ? 0 : 1;
+
+usage:
+    fprintf(stderr,
+            "usage: %s [--start N] [--max N] [--rate HZ] [--duration S] [--chunk-max BYTES]\n"
+            "          [--loss PERCENT] [--seed N] [--label TEXT] [--json PATH]\n",
+            argv[0]);
+    return 2;
+}
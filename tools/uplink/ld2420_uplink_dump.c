@@ -0,0 +1,278 @@
+/*
+ * LD2420 uplink dump
+ * ------------------
+ * Decodes the binary uplink of a gateway (e.g. the Pico example over USB CDC)
+ * and prints every frame with the sensor it came from and the gateway
+ * timestamp. With --loopback it instead encodes a synthetic multi-sensor
+ * stream of ACKs and report frames (in FRAME records and in a BYTES record),
+ * damages one record, decodes it in uneven chunks and checks that exactly the
+ * damaged frame is missing and every report arrives intact and in order.
+ *
+ * Usage: ld2420_uplink_dump [--quiet] DEVICE|FILE
+ *        ld2420_uplink_dump --loopback FRAMES
+ *
+ * The exit status is 0 on success, 1 on a failed check or read error.
+ */
+
+#include <ld2420/ld2420_uplink.h>
+#include <ld2420/ld2420_protocol.h>
+#include <ld2420/platform/linux/ld2420_linux.h>
+#include <ld2420/platform/linux/ld2420_linux_uplink.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static int usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--quiet] DEVICE|FILE\n"
+            "       %s --loopback FRAMES\n",
+            argv0, argv0);
+    return 2;
+}
+
+static void print_frame(
+    void *user,
+    uint16_t port_index,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    const ld2420_linux_uplink_t *uplink = (const ld2420_linux_uplink_t *)user;
+    printf("%10" PRIu32 " sensor=%u cmd=0x%04X status=0x%04X len=%u:",
+           uplink->timestamp_us, port_index, cmd_echo, status, frame_size_bytes);
+    for (uint16_t i = 0; i < frame_size_bytes; i++)
+        printf(" %02X", frame[i]);
+    putchar('\n');
+}
+
+static void print_summary(void *user, uint16_t sensor_id, uint8_t presence, uint16_t distance_cm)
+{
+    const ld2420_linux_uplink_t *uplink = (const ld2420_linux_uplink_t *)user;
+    printf("%10" PRIu32 " sensor=%u presence=%u distance=%u cm\n", uplink->timestamp_us, sensor_id, presence,
+           distance_cm);
+}
+
+static void count_frame(
+    void *user,
+    uint16_t port_index,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    (void)user;
+    (void)port_index;
+    (void)frame;
+    (void)frame_size_bytes;
+    (void)cmd_echo;
+    (void)status;
+}
+
+static void print_stats(const ld2420_linux_uplink_t *uplink)
+{
+    fprintf(stderr, "records=%" PRIu32 " corrupt=%" PRIu32 " lost=%" PRIu32 "\n",
+            uplink->decoder.records, uplink->decoder.corrupt_records, uplink->decoder.lost_records);
+    for (uint16_t i = 0; i < LD2420_LINUX_UPLINK_MAX_SENSORS; i++)
+    {
+        const ld2420_linux_uplink_sensor_t *sensor = &uplink->sensors[i];
+        if (sensor->frames == 0 && sensor->errors == 0 && sensor->overflow_bytes == 0 && sensor->summaries == 0)
+            continue;
+        fprintf(stderr, "sensor %u: frames=%" PRIu32 " summaries=%" PRIu32 " errors=%" PRIu32 " overflow_bytes=%" PRIu32 "\n",
+                i, sensor->frames, sensor->summaries, sensor->errors, sensor->overflow_bytes);
+    }
+}
+
+static int dump(const char *path, bool quiet)
+{
+    static ld2420_linux_uplink_t uplink;
+    ld2420_linux_uplink_init(&uplink, quiet ? count_frame : print_frame, &uplink);
+    if (!quiet)
+        uplink.summary_callback = print_summary;
+
+    // Character devices need raw mode, or the line discipline mangles the records
+    struct stat st;
+    int fd = -1;
+    if (stat(path, &st) == 0 && S_ISCHR(st.st_mode))
+    {
+        if (ld2420_linux_open_serial(path, &fd) != LD2420_STATUS_OK)
+            fd = -1;
+        else
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    }
+    else
+    {
+        fd = open(path, O_RDONLY);
+    }
+    if (fd < 0)
+    {
+        perror(path);
+        return 1;
+    }
+
+    int result = 0;
+    while (ld2420_linux_uplink_read(&uplink, fd) >= 0)
+        fflush(stdout);
+    if (errno != 0)
+    {
+        perror("read");
+        result = 1;
+    }
+    close(fd);
+    print_stats(&uplink);
+    return result;
+}
+
+/** Report frames seen by the loopback: distance_cm carries their number. */
+typedef struct
+{
+    uint32_t reports;
+    uint32_t bad_reports;
+} loopback_reports_t;
+
+static void check_report(
+    void *user,
+    uint16_t port_index,
+    const uint8_t *frame,
+    uint16_t frame_size_bytes,
+    uint16_t cmd_echo,
+    uint16_t status)
+{
+    (void)port_index;
+    loopback_reports_t *seen = (loopback_reports_t *)user;
+    ld2420_report_energy_t report;
+    if (frame_size_bytes < 4 || ld2420_protocol_read_le32(frame) != LD2420_PROTOCOL_REPORT_HEADER)
+        return;
+    if (ld2420_report_energy_decode(frame, frame_size_bytes, &report) != LD2420_STATUS_OK || cmd_echo != 0 ||
+        status != 0 || report.distance_cm != (uint16_t)seen->reports)
+        seen->bad_reports++;
+    seen->reports++;
+}
+
+/** Records of one sensor when count records go round-robin over sensors. */
+static uint32_t per_sensor(uint32_t count, uint8_t sensors, uint8_t sensor)
+{
+    return (count + sensors - 1u - sensor) / sensors;
+}
+
+/** Memory transport for the loopback writer. */
+typedef struct
+{
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+} loopback_link_t;
+
+static size_t loopback_write(void *user, const uint8_t *data, size_t len)
+{
+    loopback_link_t *link = (loopback_link_t *)user;
+    if (len > link->capacity - link->size)
+        len = link->capacity - link->size;
+    memcpy(&link->data[link->size], data, len);
+    link->size += len;
+    return len;
+}
+
+static int loopback(uint32_t frames)
+{
+    static const uint8_t FRAME[] = {
+        0xFD, 0xFC, 0xFB, 0xFA, // header
+        0x08, 0x00,             // frame size (8)
+        0xFF, 0x01,             // cmd echo
+        0x00, 0x00,             // status
+        0x02, 0x00, 0x20, 0x00, // payload (4 bytes)
+        0x04, 0x03, 0x02, 0x01  // footer
+    };
+    const uint8_t sensors = 3;
+    const uint32_t reports = frames / 10u + 1u;
+
+    loopback_link_t link = {0};
+    static const uint8_t SUMMARY[] = {0x01, 0x2C, 0x01}; // presence, 300 cm
+    // Raw sensor bytes: noise, a report frame and an ACK, not aligned to records
+    uint8_t raw[3 + LD2420_REPORT_ENERGY_SIZE + sizeof(FRAME)] = {0x00, 0xF4, 0xF3};
+    link.capacity = (size_t)frames * (LD2420_UPLINK_OVERHEAD + sizeof(FRAME)) +
+                    (size_t)reports * (LD2420_UPLINK_OVERHEAD + LD2420_REPORT_ENERGY_SIZE) +
+                    LD2420_UPLINK_OVERHEAD + sizeof(raw) + LD2420_UPLINK_OVERHEAD + sizeof(SUMMARY);
+    link.data = malloc(link.capacity);
+    if (link.data == NULL)
+    {
+        perror("malloc");
+        return 1;
+    }
+
+    static ld2420_uplink_writer_t writer;
+    ld2420_uplink_writer_init(&writer, loopback_write, &link);
+    for (uint32_t i = 0; i < frames; i++)
+        ld2420_uplink_writer_append(&writer, (uint8_t)(i % sensors), LD2420_UPLINK_KIND_FRAME, i * 1000u, FRAME,
+                                    sizeof(FRAME));
+    // Report frames in FRAME records, numbered in their distance field
+    for (uint32_t i = 0; i < reports; i++)
+    {
+        uint8_t report[LD2420_REPORT_ENERGY_SIZE];
+        const ld2420_report_energy_t msg = {.presence = 1, .distance_cm = (uint16_t)i, .energy = {(uint16_t)i}};
+        ld2420_report_energy_encode(report, &msg);
+        ld2420_uplink_writer_append(&writer, (uint8_t)(i % sensors), LD2420_UPLINK_KIND_FRAME, (frames + i) * 1000u,
+                                    report, sizeof(report));
+    }
+    const ld2420_report_energy_t last = {.presence = 0, .distance_cm = (uint16_t)reports};
+    ld2420_report_energy_encode(&raw[3], &last);
+    memcpy(&raw[3 + LD2420_REPORT_ENERGY_SIZE], FRAME, sizeof(FRAME));
+    ld2420_uplink_writer_append(&writer, 0, LD2420_UPLINK_KIND_BYTES, (frames + reports) * 1000u, raw, sizeof(raw));
+    // A shedding gateway's presence summary, from a sensor that sent no frames
+    ld2420_uplink_writer_append(&writer, sensors, LD2420_UPLINK_KIND_PRESENCE, frames * 1000u, SUMMARY,
+                                sizeof(SUMMARY));
+    ld2420_uplink_writer_flush(&writer);
+
+    // Damage the payload of the middle record
+    const size_t damaged = frames / 2;
+    link.data[damaged * (LD2420_UPLINK_OVERHEAD + sizeof(FRAME)) + LD2420_UPLINK_HEADER_SIZE + 7] ^= 0x40;
+
+    static ld2420_linux_uplink_t uplink;
+    loopback_reports_t seen = {0};
+    ld2420_linux_uplink_init(&uplink, check_report, &seen);
+    uint64_t delivered = 0;
+    size_t chunk = 1;
+    for (size_t off = 0; off < link.size; off += chunk, chunk = chunk % 61 + 1)
+    {
+        size_t n = link.size - off < chunk ? link.size - off : chunk;
+        delivered += (uint64_t)ld2420_linux_uplink_feed(&uplink, &link.data[off], n);
+    }
+    free(link.data);
+    print_stats(&uplink);
+
+    // Records of a sensor: ACKs and reports round-robin, plus sensor 0's BYTES record
+    const uint8_t hit = (uint8_t)(damaged % sensors);
+    // Every ACK but the damaged one, every report, and the report and ACK of the BYTES record
+    const bool ok = frames > 0 && writer.dropped_records == 0 && delivered == frames - 1u + reports + 2u &&
+                    seen.reports == reports + 1u && seen.bad_reports == 0 &&
+                    uplink.decoder.corrupt_records == 1 && uplink.decoder.lost_records == 1 &&
+                    uplink.sensors[hit].frames == per_sensor(frames, sensors, hit) + per_sensor(reports, sensors, hit) + (hit == 0 ? 2u : 0u) - 1u &&
+                    uplink.sensors[sensors].summaries == 1 && uplink.sensors[sensors].presence == 1 &&
+                    uplink.sensors[sensors].distance_cm == 300;
+    if (!ok)
+    {
+        fprintf(stderr, "FAIL: delivered %" PRIu64 " frames, %" PRIu32 " of %" PRIu32 " reports (%" PRIu32 " bad)\n",
+                delivered, seen.reports, reports + 1u, seen.bad_reports);
+        return 1;
+    }
+    fprintf(stderr, "OK: delivered %" PRIu64 " frames, %" PRIu32 " of them reports\n", delivered, seen.reports);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 3 && strcmp(argv[1], "--loopback") == 0)
+        return loopback((uint32_t)strtoul(argv[2], NULL, 0));
+    if (argc == 3 && strcmp(argv[1], "--quiet") == 0)
+        return dump(argv[2], true);
+    if (argc == 2 && argv[1][0] != '-')
+        return dump(argv[1], false);
+    return usage(argv[0]);
+}